@@ -5,12 +5,24 @@
 #ifndef _LINXBASE_ALIGNEDBUFFER_H
 #define _LINXBASE_ALIGNEDBUFFER_H
 
+#include "Linx/Base/AllocationStats.h"
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Holders.h" // Uninitialized
+#include "Linx/Base/Threads.h"
 #include "Linx/Base/TypeUtils.h"
 
 #include <algorithm> // copy_n
 #include <cstdint> // uintptr_t
+#include <cstring> // memset
+#include <fstream>
 #include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h> // madvise
+#include <sys/syscall.h> // SYS_mbind
+#include <unistd.h> // syscall
+#endif
 
 namespace Linx {
 
@@ -79,6 +91,51 @@ struct AlignmentError : Exception {
   }
 };
 
+/**
+ * @ingroup data_classes
+ * @brief Memory allocation options of `AlignedBuffer`, e.g. for multi-GB rasters.
+ * 
+ * Huge pages reduce TLB misses, and NUMA placement avoids that all the pages are allocated on the node of the
+ * thread which first touches them (generally the main thread), which would make other nodes access remote memory:
+ * 
+ * \code
+ * MemoryOptions options;
+ * options.page_size = MemoryOptions::huge_page;
+ * options.first_touch = Threads(32); // Matches the subsequent statically scheduled OpenMP loops
+ * AlignedRaster<float, 3> cube(shape, options);
+ * \endcode
+ * 
+ * All the options are hints on Linux, and they are ignored on other systems.
+ */
+struct MemoryOptions {
+  /**
+   * @brief The usual transparent huge page size, in bytes.
+   */
+  static constexpr std::size_t huge_page = std::size_t(2) << 20;
+
+  /**
+   * @brief The page size, in bytes, or 0 for the default page size.
+   * 
+   * If greater than the default page size, the memory is aligned to it, and `madvise(MADV_HUGEPAGE)` is called.
+   */
+  std::size_t page_size = 0;
+
+  /**
+   * @brief Interleave the pages across the NUMA nodes.
+   * 
+   * This is relevant for data which is accessed evenly by all the threads, with no predictable pattern.
+   */
+  bool interleave = false;
+
+  /**
+   * @brief The threads which touch the memory first, or `Threads(1)` to let the pages be touched lazily.
+   * 
+   * If more than one thread is used, the memory is zero-initialized in parallel with a static schedule,
+   * such that each page is allocated on the node of the thread which later processes it in static loops.
+   */
+  Threads first_touch = Threads(1);
+};
+
 /**
  * @ingroup data_classes
  * @brief Data holder with aligned memory.
@@ -127,6 +184,29 @@ public:
     }
   }
 
+  /**
+   * @brief Owning buffer constructor, without initialization.
+   * 
+   * This is equivalent to `AlignedBuffer(size)`, since owned values are never initialized,
+   * but makes the intent explicit, e.g. in `AlignedRaster<T>(shape, uninitialized)`.
+   */
+  AlignedBuffer(std::size_t size, Uninitialized) : AlignedBuffer(size) {}
+
+  /**
+   * @brief Owning buffer constructor with allocation options.
+   * @param size The number of elements
+   * @param options The allocation options
+   * 
+   * Memory is aligned to the page size if given, or made compatible with SIMD instructions otherwise.
+   * Copies of the buffer are aligned the same, but the other options are not propagated.
+   */
+  AlignedBuffer(std::size_t size, const MemoryOptions& options) :
+      m_container(nullptr), m_begin(nullptr), m_end(nullptr), m_as(std::max(options.page_size, align_as(nullptr, 0)))
+  {
+    allocate(size);
+    advise(options);
+  }
+
   /**
    * @brief Copy constructor.
    */
@@ -136,6 +216,7 @@ public:
     if (other.owns()) {
       std::copy(other.m_begin, other.m_end, const_cast<std::remove_cv_t<T>*>(m_begin));
       // Safe because if T is const, other is not owning (or should we throw?)
+      Internal::track_copy(sizeof(T) * (m_end - m_begin));
     }
   }
 
@@ -158,6 +239,7 @@ public:
       if (other.owns()) {
         allocate(other.m_end - other.m_begin);
         std::copy(other.m_begin, other.m_end, m_begin);
+        Internal::track_copy(sizeof(T) * (m_end - m_begin));
       } else {
         m_container = other.m_container;
         m_begin = other.m_begin;
@@ -261,6 +343,7 @@ public:
     if (m_container) {
       std::free(m_container);
       m_container = nullptr;
+      Internal::track_deallocation(sizeof(T) * (m_end - m_begin));
     }
     m_as = 1;
     m_begin = nullptr;
@@ -271,10 +354,71 @@ private:
 
   void allocate(std::size_t size)
   {
-    const auto valid_size = ((size + m_as - 1) / m_as) * m_as; // Smallest multiple of m_as >= size
-    m_container = std::aligned_alloc(m_as, sizeof(T) * valid_size);
+    const auto bytes = ((sizeof(T) * size + m_as - 1) / m_as) * m_as; // Smallest multiple of m_as >= size
+    m_container = std::aligned_alloc(m_as, bytes);
     m_begin = reinterpret_cast<T*>(m_container);
     m_end = m_begin + size;
+    Internal::track_allocation(sizeof(T) * size);
+  }
+
+  /**
+   * @brief Apply the allocation options to the allocated memory.
+   */
+  void advise(const MemoryOptions& options)
+  {
+    auto* bytes = static_cast<char*>(m_container);
+    const std::size_t length = ((sizeof(T) * (m_end - m_begin) + m_as - 1) / m_as) * m_as;
+    if (not bytes || length == 0) {
+      return;
+    }
+#ifdef __linux__
+    if (options.page_size > std::size_t(sysconf(_SC_PAGESIZE))) {
+      madvise(bytes, length, MADV_HUGEPAGE);
+    }
+    if (options.interleave) {
+      const auto nodes = numa_nodes();
+      if (not nodes.empty()) {
+        constexpr int mpol_interleave = 3; // From numaif.h, which requires libnuma
+        syscall(SYS_mbind, bytes, length, mpol_interleave, nodes.data(), nodes.size() * 64 + 1, 0);
+      }
+    }
+#endif
+    const Index count = options.first_touch.count();
+    if (count > 1) {
+      const std::size_t chunk = (length + count - 1) / count;
+#pragma omp parallel for num_threads(count) schedule(static)
+      for (Index i = 0; i < count; ++i) {
+        const auto front = std::min(i * chunk, length);
+        std::memset(bytes + front, 0, std::min(chunk, length - front));
+      }
+    }
+  }
+
+  /**
+   * @brief Get the mask of the online NUMA nodes, as 64-bit words, or an empty mask if unknown.
+   */
+  static std::vector<unsigned long> numa_nodes()
+  {
+    std::vector<unsigned long> out;
+    std::ifstream file("/sys/devices/system/node/online"); // E.g. "0-1,4"
+    std::string ranges;
+    if (not std::getline(file, ranges)) {
+      return out;
+    }
+    std::stringstream ss(ranges);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+      const auto dash = range.find('-');
+      const auto front = std::stoul(range.substr(0, dash));
+      const auto back = dash == std::string::npos ? front : std::stoul(range.substr(dash + 1));
+      for (auto n = front; n <= back; ++n) {
+        if (out.size() <= n / 64) {
+          out.resize(n / 64 + 1, 0);
+        }
+        out[n / 64] |= 1UL << (n % 64);
+      }
+    }
+    return out;
   }
 
   static std::size_t align_as(const void* data, Index align)
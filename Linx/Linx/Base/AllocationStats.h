@@ -0,0 +1,405 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_ALLOCATIONSTATS_H
+#define _LINXBASE_ALLOCATIONSTATS_H
+
+#include <algorithm> // find, max
+#include <cstddef> // size_t
+#include <map>
+#include <string>
+#include <utility> // swap
+
+#ifdef LINX_TRACK_ALLOCATIONS
+#include <mutex>
+#include <vector>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Allocation statistics of the data holders.
+ *
+ * Statistics are recorded only if `LINX_TRACK_ALLOCATIONS` is defined (consistently in all the translation units),
+ * and they are all zero otherwise.
+ * @see `AllocationScope`
+ */
+struct AllocationStats {
+  /**
+   * @brief Check whether allocations are tracked in this build.
+   */
+  static constexpr bool enabled()
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief The number of allocations.
+   */
+  std::size_t allocations = 0;
+
+  /**
+   * @brief The number of deallocations.
+   */
+  std::size_t deallocations = 0;
+
+  /**
+   * @brief The number of allocated bytes.
+   */
+  std::size_t allocated_bytes = 0;
+
+  /**
+   * @brief The number of freed bytes.
+   */
+  std::size_t freed_bytes = 0;
+
+  /**
+   * @brief The maximum number of live bytes, i.e. allocated and not freed yet.
+   */
+  std::size_t peak_bytes = 0;
+
+  /**
+   * @brief The number of holder copies.
+   */
+  std::size_t copies = 0;
+
+  /**
+   * @brief The number of copied bytes.
+   */
+  std::size_t copied_bytes = 0;
+
+  /**
+   * @brief Get the number of live bytes.
+   *
+   * In a scope, this is the number of bytes allocated and not freed in the scope,
+   * which may be negative if memory allocated outside the scope was freed.
+   */
+  long long live_bytes() const
+  {
+    return static_cast<long long>(allocated_bytes) - static_cast<long long>(freed_bytes);
+  }
+};
+
+/// @cond
+namespace Internal {
+
+#ifdef LINX_TRACK_ALLOCATIONS
+
+/**
+ * @brief The global registry of the allocation statistics.
+ */
+class AllocationRegistry {
+public:
+
+  static AllocationRegistry& instance()
+  {
+    static AllocationRegistry registry;
+    return registry;
+  }
+
+  /**
+   * @brief The stack of the scopes of the calling thread, where repeated scopes are null.
+   */
+  static std::vector<AllocationStats*>& stack()
+  {
+    static thread_local std::vector<AllocationStats*> scopes;
+    return scopes;
+  }
+
+  void push(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto* stats = &m_scopes[name];
+    auto& scopes = stack();
+    scopes.push_back(std::find(scopes.begin(), scopes.end(), stats) == scopes.end() ? stats : nullptr);
+  }
+
+  void pop()
+  {
+    stack().pop_back();
+  }
+
+  template <typename TFunc>
+  void record(TFunc&& func)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    func(m_total);
+    for (auto* stats : stack()) {
+      if (stats) {
+        func(*stats);
+      }
+    }
+  }
+
+  AllocationStats total()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_total;
+  }
+
+  std::map<std::string, AllocationStats> scopes()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_scopes;
+  }
+
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto live = static_cast<std::size_t>(std::max<long long>(0, m_total.live_bytes()));
+    m_total = AllocationStats();
+    m_total.allocated_bytes = live; // Keep the live bytes such that subsequent deallocations are balanced
+    m_total.peak_bytes = live;
+    for (auto& s : m_scopes) {
+      s.second = AllocationStats();
+    }
+  }
+
+private:
+
+  std::mutex m_mutex;
+  AllocationStats m_total;
+  std::map<std::string, AllocationStats> m_scopes;
+};
+
+inline void track_allocation(std::size_t bytes)
+{
+  AllocationRegistry::instance().record([&](AllocationStats& s) {
+    ++s.allocations;
+    s.allocated_bytes += bytes;
+    s.peak_bytes = std::max<long long>(s.peak_bytes, s.live_bytes());
+  });
+}
+
+inline void track_deallocation(std::size_t bytes)
+{
+  AllocationRegistry::instance().record([&](AllocationStats& s) {
+    ++s.deallocations;
+    s.freed_bytes += bytes;
+  });
+}
+
+inline void track_copy(std::size_t bytes)
+{
+  AllocationRegistry::instance().record([&](AllocationStats& s) {
+    ++s.copies;
+    s.copied_bytes += bytes;
+  });
+}
+
+#else
+
+inline void track_allocation(std::size_t) {}
+
+inline void track_deallocation(std::size_t) {}
+
+inline void track_copy(std::size_t) {}
+
+#endif
+
+/**
+ * @brief Allocation tracker to be inherited by owning holders.
+ *
+ * Allocations are recorded at construction, and deallocations at destruction; copies record both;
+ * moves transfer the ownership without recording.
+ * It is an empty class if tracking is disabled, such that it costs nothing as a base class.
+ */
+class TrackedAllocation {
+public:
+
+#ifdef LINX_TRACK_ALLOCATIONS
+
+  explicit TrackedAllocation(std::size_t bytes = 0) : m_bytes(bytes)
+  {
+    if (m_bytes) {
+      track_allocation(m_bytes);
+    }
+  }
+
+  TrackedAllocation(const TrackedAllocation& other) : TrackedAllocation(other.m_bytes)
+  {
+    if (m_bytes) {
+      track_copy(m_bytes);
+    }
+  }
+
+  TrackedAllocation(TrackedAllocation&& other) noexcept : m_bytes(other.m_bytes)
+  {
+    other.m_bytes = 0;
+  }
+
+  TrackedAllocation& operator=(const TrackedAllocation& other)
+  {
+    if (this != &other) {
+      untrack();
+      m_bytes = other.m_bytes;
+      if (m_bytes) {
+        track_allocation(m_bytes);
+        track_copy(m_bytes);
+      }
+    }
+    return *this;
+  }
+
+  TrackedAllocation& operator=(TrackedAllocation&& other) noexcept
+  {
+    if (this != &other) {
+      untrack();
+      std::swap(m_bytes, other.m_bytes);
+    }
+    return *this;
+  }
+
+  ~TrackedAllocation()
+  {
+    untrack();
+  }
+
+  /**
+   * @brief Record the deallocation, e.g. when the memory is moved out of the holder.
+   */
+  void untrack()
+  {
+    if (m_bytes) {
+      track_deallocation(m_bytes);
+      m_bytes = 0;
+    }
+  }
+
+  /**
+   * @brief Exchange the tracked allocations, e.g. when swapping holders.
+   */
+  void swap_tracking(TrackedAllocation& other)
+  {
+    std::swap(m_bytes, other.m_bytes);
+  }
+
+private:
+
+  std::size_t m_bytes;
+
+#else
+
+  explicit TrackedAllocation(std::size_t = 0) {}
+
+  void untrack() {}
+
+  void swap_tracking(TrackedAllocation&) {}
+
+#endif
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Named scope of allocation statistics.
+ *
+ * The allocations of the owning holders (`StdHolder`, `AlignedBuffer`) are recorded globally,
+ * and in each named scope which is open in the allocating thread,
+ * such that the steps of a pipeline can be profiled separately:
+ *
+ * \code
+ * {
+ *   AllocationScope scope("calibration");
+ *   ... // Allocations are recorded in "calibration"
+ *   {
+ *     AllocationScope inner("flat");
+ *     ... // Allocations are recorded in "calibration" and "flat"
+ *   }
+ * }
+ * for (const auto& s : AllocationScope::report()) {
+ *   std::cout << s.first << ": " << s.second.allocated_bytes << " B, peak " << s.second.peak_bytes << " B\n";
+ * }
+ * \endcode
+ *
+ * Scopes are thread-local, i.e. allocations made by worker threads are only recorded globally,
+ * unless the workers open their own scopes.
+ * Statistics of a scope accumulate over all the times it is open.
+ * If `LINX_TRACK_ALLOCATIONS` is not defined, scopes are no-ops and statistics are zero.
+ *
+ * Tracking serializes the allocations with a mutex: it is meant for profiling builds, not for production.
+ */
+class AllocationScope {
+public:
+
+  /**
+   * @brief Open a scope.
+   */
+  explicit AllocationScope(const std::string& name)
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    Internal::AllocationRegistry::instance().push(name);
+#else
+    (void)name;
+#endif
+  }
+
+  /**
+   * @brief Close the scope.
+   */
+  ~AllocationScope()
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    Internal::AllocationRegistry::instance().pop();
+#endif
+  }
+
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+  /**
+   * @brief Get the global statistics.
+   */
+  static AllocationStats total()
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    return Internal::AllocationRegistry::instance().total();
+#else
+    return {};
+#endif
+  }
+
+  /**
+   * @brief Get the statistics of a scope, which are zero if the scope was never open.
+   */
+  static AllocationStats stats(const std::string& name)
+  {
+    const auto scopes = report();
+    const auto it = scopes.find(name);
+    return it == scopes.end() ? AllocationStats() : it->second;
+  }
+
+  /**
+   * @brief Get the statistics of all the scopes.
+   */
+  static std::map<std::string, AllocationStats> report()
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    return Internal::AllocationRegistry::instance().scopes();
+#else
+    return {};
+#endif
+  }
+
+  /**
+   * @brief Reset the statistics, except for the global live bytes.
+   */
+  static void reset()
+  {
+#ifdef LINX_TRACK_ALLOCATIONS
+    Internal::AllocationRegistry::instance().reset();
+#endif
+  }
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,155 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_CONVERSION_H
+#define _LINXBASE_CONVERSION_H
+
+#include "Linx/Base/FastMath.h" // select
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <cmath> // nextafter
+#include <limits>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup pixelwise
+ * @brief Parameters of a value type conversion, as `out = in * scale + offset`.
+ * 
+ * The scale and offset are those of the FITS convention, where `physical = BSCALE * raw + BZERO`,
+ * e.g. `{1, 32768}` to read unsigned 16-bit values stored as signed integers.
+ * 
+ * If the conversion is the identity and is not saturating, values are merely cast with `static_cast`,
+ * which vectorizes widenings and narrowings.
+ * Otherwise, values are computed in floating point (single precision for values of at most 16 bits,
+ * double precision otherwise), rounded to the nearest integer if the output type is integral,
+ * and optionally clamped to the output type range (saturation), which also vectorizes.
+ * Without saturation, the behavior is undefined if some output value is out of range;
+ * with saturation, NaNs are converted to 0 if the output type is integral.
+ */
+struct Conversion {
+  /**
+   * @brief The scaling factor.
+   */
+  double scale = 1;
+
+  /**
+   * @brief The offset, applied after scaling.
+   */
+  double offset = 0;
+
+  /**
+   * @brief Clamp the values to the output type range.
+   */
+  bool saturate = false;
+
+  /**
+   * @brief Check whether the conversion is a mere cast.
+   */
+  bool is_cast() const
+  {
+    return scale == 1 && offset == 0 && not saturate;
+  }
+
+  /**
+   * @brief Get the inverse conversion, e.g. to write values which were read with this conversion.
+   * 
+   * The inverse conversion is saturating if this conversion is.
+   */
+  Conversion inverse() const
+  {
+    return {1. / scale, -offset / scale, saturate};
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The floating point type in which a scaled conversion is computed.
+ */
+template <typename T, typename U>
+using ConversionFloat =
+    std::conditional_t<(sizeof(T) <= 2 || std::is_same_v<T, float>)&&(sizeof(U) <= 2 || std::is_same_v<U, float>),
+                       float,
+                       double>;
+
+/**
+ * @brief Get the largest value of type `W` which can be converted to type `U` without overflow.
+ */
+template <typename W, typename U>
+W conversion_max()
+{
+  const auto max = static_cast<W>(std::numeric_limits<U>::max());
+  if constexpr (std::is_integral_v<U>) {
+    return static_cast<long double>(max) > static_cast<long double>(std::numeric_limits<U>::max()) ?
+        std::nextafter(max, W(0)) :
+        max;
+  } else {
+    return max;
+  }
+}
+
+/**
+ * @brief Convert contiguous arithmetic values with scaling, rounding and optional saturation.
+ */
+template <typename T, typename U>
+void convert_scaled(const T* in, Index size, U* out, const Conversion& conversion)
+{
+  using W = ConversionFloat<T, U>;
+  const auto scale = static_cast<W>(conversion.scale);
+  const auto offset = static_cast<W>(conversion.offset);
+  constexpr bool rounds = std::is_integral_v<U>;
+  if (conversion.saturate) {
+    const auto min = static_cast<W>(std::numeric_limits<U>::lowest());
+    const auto max = conversion_max<W, U>();
+    for (Index i = 0; i < size; ++i) {
+      auto w = static_cast<W>(in[i]) * scale + offset;
+      if constexpr (rounds) {
+        w += select(w < 0, W(-0.5), W(0.5));
+        w = select(w != w, W(0), w);
+      }
+      out[i] = static_cast<U>(select(w < min, min, select(w > max, max, w)));
+    }
+  } else {
+    for (Index i = 0; i < size; ++i) {
+      auto w = static_cast<W>(in[i]) * scale + offset;
+      if constexpr (rounds) {
+        w += select(w < 0, W(-0.5), W(0.5));
+      }
+      out[i] = static_cast<U>(w);
+    }
+  }
+}
+
+/**
+ * @brief Convert contiguous values.
+ * @param in The input data
+ * @param size The number of values
+ * @param out The output data, which may not overlap the input data
+ * @param conversion The conversion parameters
+ * 
+ * Non-arithmetic values (e.g. complex numbers) are only cast.
+ */
+template <typename T, typename U>
+void convert(const T* in, Index size, U* out, const Conversion& conversion)
+{
+  if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<U>) {
+    if (not conversion.is_cast()) {
+      convert_scaled(in, size, out, conversion);
+      return;
+    }
+  }
+  for (Index i = 0; i < size; ++i) {
+    out[i] = static_cast<U>(in[i]);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -8,6 +8,7 @@
 #include "Linx/Base/TypeUtils.h"
 
 #include <algorithm>
+#include <cmath> // abs, sqrt
 #include <vector>
 
 namespace Linx {
@@ -26,6 +27,10 @@ namespace Linx {
  * Sequentially calling several methods results in a more and more sorted values.
  * If a lot of different parameters have to be estimated,
  * then it might be faster to completely sort the values by calling `sort()` beforehand.
+ * Several quantiles are best computed at once, with `quantiles()`.
+ * 
+ * Alternatively, the class can work in place on a caller buffer, without copying the values,
+ * which are then reordered, e.g. for repeated estimations on a temporary buffer.
  * 
  * Methods are not `const` because they involve sorting or caching.
  */
@@ -45,13 +50,22 @@ public:
    * @brief Vector-move constructor.
    */
   explicit DataDistribution(std::vector<T>&& values) :
-      m_values(std::move(values)), m_sorted(std::is_sorted(m_values.begin(), m_values.end())), m_sum(Limits<T>::zero()),
-      m_sum2(m_sum)
+      m_values(std::move(values)), m_begin(m_values.data()), m_end(m_begin + m_values.size()), m_sorted(false),
+      m_sum(Limits<T>::zero()), m_sum2(m_sum), m_deviations()
   {
-    for (const auto& v : m_values) {
-      m_sum += v;
-      m_sum2 += v * v;
-    }
+    init();
+  }
+
+  /**
+   * @brief In-place constructor.
+   * 
+   * The values are not copied, and are reordered by the estimators.
+   * The buffer must outlive the distribution.
+   */
+  DataDistribution(T* begin, T* end) :
+      m_values(), m_begin(begin), m_end(end), m_sorted(false), m_sum(Limits<T>::zero()), m_sum2(m_sum), m_deviations()
+  {
+    init();
   }
 
   /**
@@ -61,6 +75,42 @@ public:
   explicit DataDistribution(const TRange& values) : DataDistribution(std::vector<T>(values.begin(), values.end()))
   {}
 
+  /**
+   * @brief Copy constructor.
+   * 
+   * If the input works in place, the copy works on the same buffer.
+   */
+  DataDistribution(const DataDistribution& other) :
+      m_values(other.m_values), m_begin(other.m_begin), m_end(other.m_end), m_sorted(other.m_sorted),
+      m_sum(other.m_sum), m_sum2(other.m_sum2), m_deviations()
+  {
+    if (not other.m_values.empty()) {
+      m_begin = m_values.data();
+      m_end = m_begin + m_values.size();
+    }
+  }
+
+  /**
+   * @brief Move constructor.
+   */
+  DataDistribution(DataDistribution&&) = default;
+
+  /**
+   * @brief Copy assignment.
+   */
+  DataDistribution& operator=(const DataDistribution& other)
+  {
+    if (this != &other) {
+      *this = DataDistribution(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment.
+   */
+  DataDistribution& operator=(DataDistribution&&) = default;
+
   /// @group_properties
 
   /**
@@ -68,7 +118,7 @@ public:
    */
   std::size_t size()
   {
-    return m_values.size();
+    return m_end - m_begin;
   }
 
   /**
@@ -100,11 +150,10 @@ public:
    */
   const T& nth(std::size_t n)
   {
-    if (m_sorted) {
-      return m_values[n];
+    auto it = m_begin + n;
+    if (not m_sorted) {
+      std::nth_element(m_begin, it, m_end);
     }
-    auto it = m_values.begin() + n;
-    std::nth_element(m_values.begin(), it, m_values.end());
     return *it;
   }
 
@@ -148,15 +197,18 @@ public:
 
   /**
    * @brief Compute the median absolute deviation.
+   * 
+   * The absolute deviations are computed in a buffer which is kept across calls,
+   * and their median is selected in place.
    */
   Floating mad()
   {
-    std::vector<T> absdev(size());
     const auto m = median();
-    std::transform(m_values.begin(), m_values.end(), absdev.begin(), [=](auto e) {
+    m_deviations.resize(size());
+    std::transform(m_begin, m_end, m_deviations.begin(), [=](auto e) {
       return std::abs(e - m);
     });
-    return DataDistribution<T>(std::move(absdev)).median();
+    return DataDistribution<Floating>(m_deviations.data(), m_deviations.data() + m_deviations.size()).median();
   }
 
   /**
@@ -171,11 +223,52 @@ public:
   {
     const auto n = q * (size() - 1);
     const std::size_t f = n;
+    const auto& low = nth(f);
     if (n == f) {
-      return nth(f);
+      return low;
     }
     const auto d = n - f;
-    return nth(f) * d + nth(f + 1) * (1. - d); // FIXME linear(&nth(f), d);
+    const auto& high = m_sorted ? m_begin[f + 1] : *std::min_element(m_begin + f + 1, m_end);
+    return low * (1. - d) + high * d;
+  }
+
+  /**
+   * @brief Compute several quantiles at once.
+   * @param qs The quantile orders, in any order
+   * 
+   * The result is the same as calling `quantile()` for each order,
+   * but the ranks are selected in a single recursive pass:
+   * the middle rank is selected in the whole range,
+   * then the lower and upper ranks are recursively selected in the lower and upper parts, respectively.
+   * Each selection therefore works on a smaller range.
+   */
+  std::vector<Floating> quantiles(const std::vector<double>& qs)
+  {
+    const auto count = size();
+    std::vector<std::size_t> ranks;
+    ranks.reserve(2 * qs.size());
+    for (auto q : qs) {
+      const auto n = q * (count - 1);
+      const std::size_t f = n;
+      ranks.push_back(f);
+      if (n != f) {
+        ranks.push_back(f + 1);
+      }
+    }
+    if (not m_sorted) {
+      std::sort(ranks.begin(), ranks.end());
+      ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+      select(m_begin, m_end, ranks.data(), ranks.data() + ranks.size());
+    }
+    std::vector<Floating> out;
+    out.reserve(qs.size());
+    for (auto q : qs) {
+      const auto n = q * (count - 1);
+      const std::size_t f = n;
+      const auto d = n - f;
+      out.push_back(n == f ? Floating(m_begin[f]) : m_begin[f] * (1. - d) + m_begin[f + 1] * d);
+    }
+    return out;
   }
 
   /**
@@ -189,20 +282,20 @@ public:
   { // FIXME bounds options
     sort();
     std::vector<std::size_t> out(std::distance(bins.begin(), bins.end()) - 1);
-    auto it = m_values.begin();
+    auto it = m_begin;
     auto sup_it = bins.begin();
     auto count_it = out.begin();
-    while (it != m_values.end() && *it < *sup_it) {
+    while (it != m_end && *it < *sup_it) {
       ++it;
     }
     for (++sup_it; sup_it != bins.end() && count_it != out.end(); ++sup_it) {
-      while (it != m_values.end() && *it < *sup_it) {
+      while (it != m_end && *it < *sup_it) {
         ++(*count_it);
         ++it;
       }
       ++count_it;
     }
-    if (it != m_values.end() && *it == bins.back()) {
+    if (it != m_end && *it == bins.back()) {
       ++(*count_it);
     }
     return out;
@@ -214,7 +307,7 @@ public:
   void sort()
   {
     if (not m_sorted) {
-      std::sort(m_values.begin(), m_values.end());
+      std::sort(m_begin, m_end);
       m_sorted = true;
     }
   }
@@ -224,10 +317,47 @@ public:
 private:
 
   /**
-   * @brief The partially sorted values.
+   * @brief Check whether the values are sorted and compute the sums.
+   */
+  void init()
+  {
+    m_sorted = std::is_sorted(m_begin, m_end);
+    for (auto it = m_begin; it != m_end; ++it) {
+      m_sum += *it;
+      m_sum2 += *it * *it;
+    }
+  }
+
+  /**
+   * @brief Select the given sorted ranks in a range, recursively.
+   */
+  void select(T* begin, T* end, const std::size_t* first, const std::size_t* last)
+  {
+    if (first == last) {
+      return;
+    }
+    const auto* middle = first + (last - first) / 2;
+    auto* it = m_begin + *middle;
+    std::nth_element(begin, it, end);
+    select(begin, it, first, middle);
+    select(it + 1, end, middle + 1, last);
+  }
+
+  /**
+   * @brief The owned values, if any.
    */
   std::vector<T> m_values;
 
+  /**
+   * @brief The beginning of the partially sorted values.
+   */
+  T* m_begin;
+
+  /**
+   * @brief The end of the partially sorted values.
+   */
+  T* m_end;
+
   /**
    * @brief Check if values are totally sorted.
    */
@@ -242,6 +372,11 @@ private:
    * @brief The cached sum of squares.
    */
   T m_sum2;
+
+  /**
+   * @brief The absolute deviation buffer.
+   */
+  std::vector<Floating> m_deviations;
 };
 
 } // namespace Linx
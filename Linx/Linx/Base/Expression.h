@@ -0,0 +1,464 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_EXPRESSION_H
+#define _LINXBASE_EXPRESSION_H
+
+#include "Linx/Base/Holders.h" // SizeError
+#include "Linx/Base/SeqUtils.h" // IsRange
+#include "Linx/Base/TypeUtils.h" // LINX_FORWARD
+
+#include <algorithm> // copy, min
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility> // index_sequence
+
+namespace Linx {
+
+/**
+ * @ingroup pixelwise
+ * @brief Lazy element-wise expression over containers.
+ * @tparam TFunc The element-wise function
+ * @tparam TArgs The operand types, which are expressions, container references or scalars
+ * 
+ * Expressions are built from containers wrapped with `lazy()`, with arithmetic operators and mathematical functions.
+ * No computation is performed and no memory is allocated until the expression is evaluated,
+ * in which case the whole expression is computed element by element, in a single loop.
+ * For example, the following calibration only allocates the output raster, and makes a single pass over the data:
+ * 
+ * \code
+ * Raster<float> calibrated = raw; // Or any raster of the same size
+ * calibrated = (lazy(raw) - bias - lazy(dark) * t) / flat;
+ * \endcode
+ * 
+ * An expression is an input range, such that it can also be evaluated with a range-copy constructor,
+ * e.g. `Raster<float> calibrated(raw.shape(), expression)`, or with `evaluate()`,
+ * e.g. to evaluate an expression into a patch.
+ * 
+ * Expressions only store references to the containers, and scalars by value,
+ * such that they are cheap to copy, but must not outlive the containers.
+ * Scalars are converted to the value type of the other operand, as do eager operators.
+ */
+template <typename TFunc, typename... TArgs>
+class Expression;
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a type is an expression.
+ */
+template <typename T>
+struct IsExpression : std::false_type {};
+
+template <typename TFunc, typename... TArgs>
+struct IsExpression<Expression<TFunc, TArgs...>> : std::true_type {};
+
+/**
+ * @brief Range reference, as an expression leaf.
+ */
+template <typename TRange>
+class RangeOperand {
+public:
+
+  explicit RangeOperand(const TRange& range) : m_range(&range) {}
+
+  auto begin() const
+  {
+    return m_range->begin();
+  }
+
+  auto end() const
+  {
+    return m_range->end();
+  }
+
+  std::size_t size() const
+  {
+    return m_range->size();
+  }
+
+private:
+
+  const TRange* m_range;
+};
+
+/**
+ * @brief Scalar, as an expression leaf.
+ * 
+ * The iterator never reaches the end, such that the end of an expression is driven by its ranges.
+ */
+template <typename T>
+class ScalarOperand {
+public:
+
+  struct Iterator : std::iterator<std::input_iterator_tag, T> {
+    const T& operator*() const
+    {
+      return value;
+    }
+    Iterator& operator++()
+    {
+      return *this;
+    }
+    bool operator==(const Iterator&) const
+    {
+      return false;
+    }
+    T value;
+  };
+
+  explicit ScalarOperand(T value) : m_value(value) {}
+
+  Iterator begin() const
+  {
+    return {{}, m_value};
+  }
+
+  Iterator end() const
+  {
+    return {{}, m_value};
+  }
+
+  std::size_t size() const
+  {
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+private:
+
+  T m_value;
+};
+
+/**
+ * @brief Get the value type of an expression or range.
+ */
+template <typename T>
+using OperandValue = std::decay_t<decltype(*std::declval<const T&>().begin())>;
+
+/**
+ * @brief Wrap an argument as an expression operand.
+ * @tparam TValue The value type to which scalars are converted
+ */
+template <typename TValue, typename T>
+auto make_operand(const T& arg)
+{
+  if constexpr (IsExpression<T>::value) {
+    return arg;
+  } else if constexpr (IsRange<T>::value) {
+    return RangeOperand<T>(arg);
+  } else {
+    return ScalarOperand<TValue>(arg);
+  }
+}
+
+/**
+ * @brief Make a binary expression, where at least one of the arguments is an expression.
+ */
+template <typename TFunc, typename TLhs, typename TRhs>
+auto make_binary_expression(TFunc&& func, const TLhs& lhs, const TRhs& rhs)
+{
+  if constexpr (IsExpression<TLhs>::value) {
+    using TValue = OperandValue<TLhs>;
+    return Expression(LINX_FORWARD(func), lhs, make_operand<TValue>(rhs));
+  } else {
+    using TValue = OperandValue<TRhs>;
+    return Expression(LINX_FORWARD(func), make_operand<TValue>(lhs), rhs);
+  }
+}
+
+/**
+ * @brief Enable a function if one of the arguments is an expression.
+ */
+template <typename TLhs, typename TRhs>
+using EnableIfExpression =
+    std::enable_if_t<IsExpression<std::decay_t<TLhs>>::value || IsExpression<std::decay_t<TRhs>>::value>;
+
+} // namespace Internal
+/// @endcond
+
+template <typename TFunc, typename... TArgs>
+class Expression {
+public:
+
+  /**
+   * @brief Iterator which computes the expression element by element.
+   */
+  class Iterator :
+      public std::iterator<
+          std::input_iterator_tag,
+          std::decay_t<std::invoke_result_t<const TFunc&, Internal::OperandValue<TArgs>...>>> {
+  public:
+
+    /**
+     * @brief The operand iterators.
+     */
+    using Iterators = std::tuple<decltype(std::declval<const TArgs&>().begin())...>;
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const TFunc& func, Iterators its) : m_func(&func), m_its(LINX_MOVE(its)) {}
+
+    /**
+     * @brief Compute the current element.
+     */
+    auto operator*() const
+    {
+      return std::apply(
+          [&](const auto&... its) {
+            return (*m_func)(*its...);
+          },
+          m_its);
+    }
+
+    /**
+     * @brief Increment the operand iterators.
+     */
+    Iterator& operator++()
+    {
+      std::apply(
+          [](auto&... its) {
+            (++its, ...);
+          },
+          m_its);
+      return *this;
+    }
+
+    /**
+     * @brief Check whether any of the operand iterators is equal to that of another iterator.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return is_equal(rhs, std::index_sequence_for<TArgs...>());
+    }
+
+    /**
+     * @brief Check whether none of the operand iterators is equal to that of another iterator.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return not(*this == rhs);
+    }
+
+  private:
+
+    template <std::size_t... Is>
+    bool is_equal(const Iterator& rhs, std::index_sequence<Is...>) const
+    {
+      return ((std::get<Is>(m_its) == std::get<Is>(rhs.m_its)) || ...);
+    }
+
+    const TFunc* m_func;
+    Iterators m_its;
+  };
+
+  /**
+   * @brief The element type.
+   */
+  using Value = typename Iterator::value_type;
+
+  /**
+   * @brief Constructor.
+   */
+  Expression(TFunc func, TArgs... args) : m_func(LINX_MOVE(func)), m_args(LINX_MOVE(args)...) {}
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  Iterator begin() const
+  {
+    return Iterator(
+        m_func,
+        std::apply(
+            [](const auto&... args) {
+              return typename Iterator::Iterators(args.begin()...);
+            },
+            m_args));
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  Iterator end() const
+  {
+    return Iterator(
+        m_func,
+        std::apply(
+            [](const auto&... args) {
+              return typename Iterator::Iterators(args.end()...);
+            },
+            m_args));
+  }
+
+  /**
+   * @brief Get the number of elements, i.e. the size of the smallest range operand.
+   */
+  std::size_t size() const
+  {
+    return std::apply(
+        [](const auto&... args) {
+          return std::min({args.size()...});
+        },
+        m_args);
+  }
+
+  /**
+   * @brief Evaluate the expression into a given container, in a single loop.
+   * @param out The output container, which must be at least as large as the expression
+   * 
+   * A `SizeError` is thrown if the container is smaller than the expression.
+   */
+  template <typename TOut>
+  TOut& evaluate(TOut& out) const
+  {
+    const std::size_t size = this->size();
+    if (out.size() < size) {
+      throw SizeError(out.size(), size);
+    }
+    std::copy(begin(), end(), out.begin());
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief The element-wise function.
+   */
+  TFunc m_func;
+
+  /**
+   * @brief The operands.
+   */
+  std::tuple<TArgs...> m_args;
+};
+
+/**
+ * @relatesalso Expression
+ * @brief Wrap a container as a lazy expression.
+ * 
+ * The container must outlive the expression.
+ */
+template <typename TRange>
+auto lazy(const TRange& in)
+{
+  return Expression(
+      [](const auto& e) {
+        return e;
+      },
+      Internal::RangeOperand<TRange>(in));
+}
+
+#define LINX_EXPRESSION_OPERATOR(op) \
+  /** @relatesalso Expression @brief Lazy element-wise operator. */ \
+  template <typename TLhs, typename TRhs, typename = Internal::EnableIfExpression<TLhs, TRhs>> \
+  auto operator op(const TLhs& lhs, const TRhs& rhs) \
+  { \
+    return Internal::make_binary_expression( \
+        [](const auto& e, const auto& f) { \
+          return e op f; \
+        }, \
+        lhs, \
+        rhs); \
+  }
+
+LINX_EXPRESSION_OPERATOR(+)
+LINX_EXPRESSION_OPERATOR(-)
+LINX_EXPRESSION_OPERATOR(*)
+LINX_EXPRESSION_OPERATOR(/)
+LINX_EXPRESSION_OPERATOR(%)
+
+#undef LINX_EXPRESSION_OPERATOR
+
+/**
+ * @relatesalso Expression
+ * @brief Lazy opposite.
+ */
+template <typename TFunc, typename... TArgs>
+auto operator-(const Expression<TFunc, TArgs...>& in)
+{
+  return Expression(
+      [](const auto& e) {
+        return -e;
+      },
+      in);
+}
+
+#define LINX_EXPRESSION_UNARY(function) \
+  /** @relatesalso Expression @brief Lazy std::##function##(). */ \
+  template <typename TFunc, typename... TArgs> \
+  auto function(const Expression<TFunc, TArgs...>& in) \
+  { \
+    return Expression( \
+        [](const auto& e) { \
+          return std::function(e); \
+        }, \
+        in); \
+  }
+
+#define LINX_EXPRESSION_BINARY(function) \
+  /** @relatesalso Expression @brief Lazy std::##function##(). */ \
+  template <typename TFunc, typename... TArgs, typename TOther> \
+  auto function(const Expression<TFunc, TArgs...>& in, const TOther& other) \
+  { \
+    return Internal::make_binary_expression( \
+        [](const auto& e, const auto& f) { \
+          return std::function(e, f); \
+        }, \
+        in, \
+        other); \
+  }
+
+LINX_EXPRESSION_UNARY(abs)
+LINX_EXPRESSION_BINARY(max)
+LINX_EXPRESSION_BINARY(min)
+LINX_EXPRESSION_BINARY(fdim)
+LINX_EXPRESSION_UNARY(ceil)
+LINX_EXPRESSION_UNARY(floor)
+LINX_EXPRESSION_BINARY(fmod)
+LINX_EXPRESSION_UNARY(trunc)
+LINX_EXPRESSION_UNARY(round)
+
+LINX_EXPRESSION_UNARY(cos)
+LINX_EXPRESSION_UNARY(sin)
+LINX_EXPRESSION_UNARY(tan)
+LINX_EXPRESSION_UNARY(acos)
+LINX_EXPRESSION_UNARY(asin)
+LINX_EXPRESSION_UNARY(atan)
+LINX_EXPRESSION_BINARY(atan2)
+LINX_EXPRESSION_UNARY(cosh)
+LINX_EXPRESSION_UNARY(sinh)
+LINX_EXPRESSION_UNARY(tanh)
+LINX_EXPRESSION_UNARY(acosh)
+LINX_EXPRESSION_UNARY(asinh)
+LINX_EXPRESSION_UNARY(atanh)
+
+LINX_EXPRESSION_UNARY(exp)
+LINX_EXPRESSION_UNARY(exp2)
+LINX_EXPRESSION_UNARY(expm1)
+LINX_EXPRESSION_UNARY(log)
+LINX_EXPRESSION_UNARY(log2)
+LINX_EXPRESSION_UNARY(log10)
+LINX_EXPRESSION_UNARY(logb)
+LINX_EXPRESSION_UNARY(ilogb)
+LINX_EXPRESSION_UNARY(log1p)
+LINX_EXPRESSION_BINARY(pow)
+LINX_EXPRESSION_UNARY(sqrt)
+LINX_EXPRESSION_UNARY(cbrt)
+LINX_EXPRESSION_BINARY(hypot)
+
+LINX_EXPRESSION_UNARY(erf)
+LINX_EXPRESSION_UNARY(erfc)
+LINX_EXPRESSION_UNARY(tgamma)
+LINX_EXPRESSION_UNARY(lgamma)
+
+#undef LINX_EXPRESSION_UNARY
+#undef LINX_EXPRESSION_BINARY
+
+} // namespace Linx
+
+#endif
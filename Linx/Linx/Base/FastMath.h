@@ -0,0 +1,227 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_FASTMATH_H
+#define _LINXBASE_FASTMATH_H
+
+#include <cstdint>
+#include <cstring> // memcpy
+#include <limits>
+#include <type_traits>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The unsigned integer type of the same size as some floating point type.
+ */
+template <typename T>
+using FloatBits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+/**
+ * @brief Reinterpret the bits of a value (vectorizable equivalent of C++20 `std::bit_cast`).
+ */
+template <typename TTo, typename TFrom>
+inline TTo bit_cast(TFrom in)
+{
+  TTo out;
+  std::memcpy(&out, &in, sizeof(TTo));
+  return out;
+}
+
+/**
+ * @brief Floating point format constants.
+ */
+template <typename T>
+struct FloatFormat {
+  static constexpr int mantissa = std::numeric_limits<T>::digits - 1;
+  static constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+};
+
+/**
+ * @brief Compute `2^n` for `n` in the normal exponent range.
+ */
+template <typename T, typename TInt>
+inline T exp2i(TInt n)
+{
+  using U = FloatBits<T>;
+  return bit_cast<T>(U(n + FloatFormat<T>::bias) << FloatFormat<T>::mantissa);
+}
+
+/**
+ * @brief Convert a small integer, in `[0, 2^mantissa)`, to floating point, without conversion instruction.
+ */
+template <typename T, typename TInt>
+inline T small_to_float(TInt k)
+{
+  using U = FloatBits<T>;
+  constexpr T magic = T(U(1) << FloatFormat<T>::mantissa);
+  return bit_cast<T>(bit_cast<U>(magic) + U(k)) - magic;
+}
+
+/**
+ * @brief Select `a` if `condition` is true, or `b` otherwise, with bit masks.
+ * 
+ * As opposed to the ternary operator, both values are computed beforehand,
+ * such that the compiler does not emit branches (floating point operations may trap).
+ */
+template <typename T>
+inline T select(bool condition, T a, T b)
+{
+  using U = FloatBits<T>;
+  const U mask = -U(condition);
+  return bit_cast<T>((bit_cast<U>(a) & mask) | (bit_cast<U>(b) & ~mask));
+}
+
+/**
+ * @brief Evaluate a polynomial with Horner's method, from the highest degree coefficient.
+ */
+template <typename T, std::size_t N>
+inline T horner(T x, const T (&coefficients)[N])
+{
+  T out = coefficients[0];
+  for (std::size_t i = 1; i < N; ++i) {
+    out = out * x + coefficients[i];
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free exponential, which vectorizes.
+ * 
+ * The argument is reduced as `x = n ln(2) + r`, with `|r| <= ln(2) / 2`,
+ * and `exp(r)` is approximated by its Taylor polynomial (of degree 12 in double precision, 7 in single precision).
+ * Over the whole range, the relative error is below `4 * epsilon` (a few ULPs), and the result is
+ * correctly infinite, zero or NaN out of range. Subnormal results are less accurate.
+ * 
+ * As opposed to `std::exp()`, `errno` is not set, and the function contains no branch,
+ * such that loops over contiguous data are vectorized by the compiler (e.g. with `-O3`).
+ * In double precision, a speedup is only obtained with 64-bit integer vector instructions (e.g. `-mavx2`).
+ */
+template <typename T>
+inline std::enable_if_t<std::is_floating_point_v<T>, T> fast_exp(T x)
+{
+  using U = Internal::FloatBits<T>;
+  using Int = std::make_signed_t<U>;
+  constexpr bool is_double = sizeof(T) == 8;
+  constexpr T log2e = 1.4426950408889634074;
+  constexpr T ln2_hi = is_double ? 6.93147180369123816490e-01 : 0.693359375f;
+  constexpr T ln2_lo = is_double ? 1.90821492927058770002e-10 : -2.12194440e-4f;
+  constexpr T max = is_double ? 710 : 89;
+  constexpr T min = is_double ? -746 : -104;
+
+  const T y = Internal::select(x < min, min, Internal::select(x > max, max, x));
+
+  // Round y / ln(2) to the nearest integer with the shift trick, such that no conversion instruction is needed
+  constexpr T shift = T(U(3) << (Internal::FloatFormat<T>::mantissa - 1));
+  const T t = y * log2e + shift;
+  const T n = t - shift;
+  const auto i = static_cast<Int>(Internal::bit_cast<U>(t) - Internal::bit_cast<U>(shift));
+  const T r = (y - n * ln2_hi) - n * ln2_lo;
+  T p;
+  if constexpr (is_double) {
+    constexpr double c[] = {
+        1. / 479001600,
+        1. / 39916800,
+        1. / 3628800,
+        1. / 362880,
+        1. / 40320,
+        1. / 5040,
+        1. / 720,
+        1. / 120,
+        1. / 24,
+        1. / 6,
+        1. / 2,
+        1.,
+        1.};
+    p = Internal::horner(r, c);
+  } else {
+    constexpr float c[] = {1.f / 5040, 1.f / 720, 1.f / 120, 1.f / 24, 1.f / 6, 1.f / 2, 1.f, 1.f};
+    p = Internal::horner(r, c);
+  }
+
+  // Scale by 2^n in two steps, such that overflows and subnormals are handled
+  const Int i1 = static_cast<Int>(U(i + 2048) >> 1) - 1024;
+  const T out = p * Internal::exp2i<T>(i1) * Internal::exp2i<T>(i - i1);
+  return Internal::select(x != x, x, out);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free natural logarithm, which vectorizes.
+ * 
+ * The argument is decomposed as `x = m 2^e`, with `sqrt(1/2) <= m < sqrt(2)`,
+ * and `log(m) = 2 atanh((m - 1) / (m + 1))` is approximated by the odd Taylor series of `atanh`
+ * (up to degree 19 in double precision, 9 in single precision).
+ * The absolute error is below `2 * epsilon` for `x` close to 1, and the relative error below `2 * epsilon` elsewhere.
+ * Special values are handled like `std::log()`: `log(0) = -inf`, `log(inf) = inf` and `log(x < 0) = NaN`.
+ * 
+ * As opposed to `std::log()`, `errno` is not set, and the function contains no branch,
+ * such that loops over contiguous data are vectorized by the compiler (e.g. with `-O3`).
+ */
+template <typename T>
+inline std::enable_if_t<std::is_floating_point_v<T>, T> fast_log(T x)
+{
+  using U = Internal::FloatBits<T>;
+  using Int = std::make_signed_t<U>;
+  constexpr bool is_double = sizeof(T) == 8;
+  constexpr int digits = Internal::FloatFormat<T>::mantissa;
+  constexpr int bias = Internal::FloatFormat<T>::bias;
+  constexpr T ln2_hi = is_double ? 6.93147180369123816490e-01 : 0.693359375f;
+  constexpr T ln2_lo = is_double ? 1.90821492927058770002e-10 : -2.12194440e-4f;
+  constexpr T sqrt2 = 1.41421356237309504880;
+
+  // Normalize subnormals
+  const bool is_subnormal = x < std::numeric_limits<T>::min();
+  const T normal = Internal::select(is_subnormal, x * Internal::exp2i<T>(digits + 1), x);
+  const auto bits = Internal::bit_cast<U>(normal);
+  Int e = static_cast<Int>(bits >> digits) - bias - (is_subnormal ? digits + 1 : 0);
+  T m = Internal::bit_cast<T>((bits & ((U(1) << digits) - 1)) | (U(bias) << digits));
+  const bool is_large = m > sqrt2;
+  m = Internal::select(is_large, m * T(0.5), m);
+  e = is_large ? e + 1 : e;
+
+  const T f = m - 1;
+  const T s = f / (2 + f);
+  const T s2 = s * s;
+  T q;
+  if constexpr (is_double) {
+    constexpr double c[] = {1. / 19, 1. / 17, 1. / 15, 1. / 13, 1. / 11, 1. / 9, 1. / 7, 1. / 5, 1. / 3};
+    q = Internal::horner(s2, c);
+  } else {
+    constexpr float c[] = {1.f / 9, 1.f / 7, 1.f / 5, 1.f / 3};
+    q = Internal::horner(s2, c);
+  }
+  const T fe = Internal::small_to_float<T>(e + 2048) - 2048;
+  const T out = fe * ln2_hi + (2 * s + (2 * s * s2 * q + fe * ln2_lo));
+
+  // Special values
+  constexpr T inf = std::numeric_limits<T>::infinity();
+  constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+  const T special = Internal::select(x == 0, -inf, Internal::select((x < 0) | (x != x), nan, x));
+  return Internal::select((x > 0) & (x < inf), out, special);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free power, computed as `fast_exp(y * fast_log(x))`.
+ * 
+ * The relative error grows with the magnitude of the result exponent,
+ * as about `(4 + 2 |y log(x)|) * epsilon`.
+ */
+template <typename T>
+inline std::enable_if_t<std::is_floating_point_v<T>, T> fast_pow(T x, T y)
+{
+  return fast_exp(y * fast_log(x));
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,166 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_HISTOGRAM_H
+#define _LINXBASE_HISTOGRAM_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // min
+#include <cstddef> // size_t
+#include <iterator> // distance, next
+#include <limits>
+#include <type_traits> // decay_t, is_integral_v
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Count the values per bin, with per-thread private histograms merged at the end.
+ * @param values The values
+ * @param count The number of bins
+ * @param index The function which returns the bin index of a value, or `count` if the value should be ignored
+ * @param threads The threads
+ *
+ * The histograms have an extra slot for ignored values, such that counting is branch-free.
+ */
+template <typename TRange, typename TIndex>
+std::vector<std::size_t> count_bins(const TRange& values, Index count, TIndex&& index, const Threads& threads)
+{
+  const Index size = std::distance(values.begin(), values.end());
+  constexpr Index min_chunk = 4096;
+  const auto chunk_count = std::max<Index>(1, std::min<Index>(threads.count(), size / min_chunk));
+  const auto chunk = (size + chunk_count - 1) / chunk_count;
+  std::vector<std::vector<std::size_t>> partials(chunk_count, std::vector<std::size_t>(count + 1, 0));
+#pragma omp parallel for num_threads(chunk_count) schedule(static)
+  for (Index c = 0; c < chunk_count; ++c) {
+    auto* bins = partials[c].data();
+    const auto front = std::min(c * chunk, size);
+    const auto back = std::min(front + chunk, size);
+    auto it = std::next(values.begin(), front);
+    for (auto i = front; i < back; ++i, ++it) {
+      ++bins[index(*it)];
+    }
+  }
+  auto& out = partials[0];
+  for (Index c = 1; c < chunk_count; ++c) {
+    for (Index b = 0; b < count; ++b) {
+      out[b] += partials[c][b];
+    }
+  }
+  out.resize(count);
+  return std::move(out);
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Compute the histogram of some values with uniform bins.
+ * @param values The values
+ * @param min The lower bound of the first bin
+ * @param max The upper bound of the last bin
+ * @param count The number of bins
+ * @param threads The threads
+ *
+ * The bin index of each value is computed directly from its distance to `min`.
+ * As for `DataDistribution::histogram()`, bins are closed-open intervals,
+ * except for the last bin, which includes `max`, and values out of `[min, max]` are ignored.
+ *
+ * The values are split into chunks, which are counted in private histograms by each thread,
+ * such that no synchronization is needed, and the private histograms are summed at the end.
+ */
+template <typename TRange>
+std::vector<std::size_t>
+uniform_histogram(const TRange& values, double min, double max, Index count, const Threads& threads = Threads(1))
+{
+  const auto scale = count / (max - min);
+  return Internal::count_bins(
+      values,
+      count,
+      [=](const auto& v) {
+        const double x = (v - min) * scale;
+        if (not(x >= 0 && x < count)) { // Including NaNs and infinities, which cannot be cast
+          return v == max ? count - 1 : count;
+        }
+        return static_cast<Index>(x);
+      },
+      threads);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Compute the histogram of some values with sorted, non-uniform bins.
+ * @param values The values
+ * @param bins The sorted bin bounds, whose size is the number of bins plus one
+ * @param threads The threads
+ *
+ * The bin index of each value is found by a branch-free binary search,
+ * whose number of steps only depends on the number of bins,
+ * such that it is not slowed down by branch mispredictions.
+ * Bins and threads are handled as in `uniform_histogram()`.
+ */
+template <typename TRange, typename TBins>
+std::vector<std::size_t> histogram(const TRange& values, const TBins& bins, const Threads& threads = Threads(1))
+{
+  const std::vector<double> bounds(bins.begin(), bins.end());
+  const Index count = static_cast<Index>(bounds.size()) - 1;
+  if (count <= 0) {
+    return {};
+  }
+  const auto* data = bounds.data();
+  const auto back = bounds.back();
+  return Internal::count_bins(
+      values,
+      count,
+      [=](const auto& v) {
+        const double x = v;
+        const auto* base = data;
+        Index n = count + 1;
+        while (n > 1) {
+          const auto half = n / 2;
+          base = base[half] <= x ? base + half : base;
+          n -= half;
+        }
+        const auto i = (base - data) + (*base <= x) - 1; // Number of bounds lower or equal to x, minus one
+        const bool inside = i >= 0 && i < count;
+        return inside ? i : (x == back ? count - 1 : count);
+      },
+      threads);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Compute the histogram of some integral values of at most 16 bits, with one bin per representable value.
+ * @param values The values
+ * @param threads The threads
+ *
+ * The bin of value `v` is at index `v - std::numeric_limits<T>::min()`,
+ * such that the output size is `2^b` for `b`-bit values, e.g. 65536 for raw 16-bit frames.
+ * There is no bound check.
+ */
+template <typename TRange>
+std::vector<std::size_t> full_histogram(const TRange& values, const Threads& threads = Threads(1))
+{
+  using T = std::decay_t<decltype(*values.begin())>;
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 2, "Full histograms require integral values of at most 16 bits.");
+  constexpr Index offset = std::numeric_limits<T>::min();
+  constexpr Index count = Index(std::numeric_limits<T>::max()) - offset + 1;
+  return Internal::count_bins(
+      values,
+      count,
+      [](const auto& v) {
+        return Index(v) - offset;
+      },
+      threads);
+}
+
+} // namespace Linx
+
+#endif
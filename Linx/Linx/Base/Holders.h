@@ -5,12 +5,15 @@
 #ifndef _LINXBASE_HOLDER_H
 #define _LINXBASE_HOLDER_H
 
+#include "Linx/Base/AllocationStats.h"
 #include "Linx/Base/Exceptions.h"
 
 #include <algorithm> // copy_n
 #include <array>
 #include <memory> // unique_ptr
 #include <stdexcept> // runtime_error // FIXME to Exceptions
+#include <type_traits>
+#include <utility> // swap
 #include <valarray>
 #include <vector>
 
@@ -56,6 +59,87 @@ inline const T* data(const T (&c)[N]) noexcept
   return c;
 }
 
+/**
+ * @ingroup data_classes
+ * @brief Tag type of `uninitialized`.
+ */
+struct Uninitialized {};
+
+/**
+ * @ingroup data_classes
+ * @brief Tag to construct a container without initializing its values.
+ * 
+ * This is meant for containers which are immediately overwritten, e.g. by a file reader or a filter,
+ * in which case initializing the values costs a full pass over the data,
+ * and makes the pages be touched by the constructing thread instead of the producing threads:
+ * 
+ * \code
+ * AlignedRaster<float, 3> cube(shape, uninitialized); // O(1), no page is touched
+ * cube.generate(Threads(8), [&]() { ... }); // First touch is parallel
+ * \endcode
+ * 
+ * The tag is supported by all the holders, but values are actually left uninitialized only by
+ * `AlignedBuffer`, `PoolHolder`, `ArenaHolder`, `StdHolder<std::unique_ptr<T[]>>`,
+ * and `StdHolder<std::vector<T, DefaultInitAllocator<T>>>` (e.g. `VecRaster<T, N, DefaultInitAllocator<T>>`).
+ * Other holders, including the default holder of `Raster`, value-initialize the elements,
+ * because their containers do not allow otherwise.
+ */
+constexpr Uninitialized uninitialized {};
+
+/**
+ * @ingroup data_classes
+ * @brief Allocator adaptor which default-initializes instead of value-initializing.
+ * 
+ * With this allocator, `std::vector<T, DefaultInitAllocator<T>>(size)` leaves trivial values uninitialized.
+ * `StdHolder` nevertheless value-initializes them, unless constructed with the `uninitialized` tag.
+ */
+template <typename T, typename TAllocator = std::allocator<T>>
+class DefaultInitAllocator : public TAllocator {
+  using Traits = std::allocator_traits<TAllocator>;
+
+public:
+
+  template <typename U>
+  struct rebind {
+    using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+  };
+
+  using TAllocator::TAllocator;
+
+  /**
+   * @brief Default-initialize an element.
+   */
+  template <typename U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+  {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+
+  /**
+   * @brief Construct an element from arguments.
+   */
+  template <typename U, typename... TArgs>
+  void construct(U* ptr, TArgs&&... args)
+  {
+    Traits::construct(static_cast<TAllocator&>(*this), ptr, std::forward<TArgs>(args)...);
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a container default-initializes its elements.
+ */
+template <typename TContainer>
+struct IsDefaultInit : std::false_type {};
+
+template <typename T, typename TAllocator>
+struct IsDefaultInit<std::vector<T, DefaultInitAllocator<T, TAllocator>>> : std::true_type {};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup data_classes
  * @brief A default holder of any contiguous container specified by a range.
@@ -65,7 +149,7 @@ inline const T* data(const T (&c)[N]) noexcept
  * @satisfies{ContiguousRange}
  */
 template <typename TContainer>
-class StdHolder {
+class StdHolder : private Internal::TrackedAllocation {
 public:
 
   /**
@@ -80,17 +164,31 @@ public:
    * @brief Default or size-based constructor.
    */
   template <typename U = typename TContainer::value_type>
-  explicit StdHolder(std::size_t size, U* data = nullptr) : m_container(size)
+  explicit StdHolder(std::size_t size, U* data = nullptr) :
+      Internal::TrackedAllocation(size * sizeof(typename TContainer::value_type)), m_container(size)
   {
     if (data) {
       std::copy_n(data, size, const_cast<typename TContainer::value_type*>(this->begin()));
+    } else if constexpr (Internal::IsDefaultInit<TContainer>::value) {
+      std::fill(m_container.begin(), m_container.end(), typename TContainer::value_type());
     }
   }
 
+  /**
+   * @brief Uninitialized constructor.
+   * 
+   * Values are left uninitialized if the container default-initializes them
+   * (e.g. with `DefaultInitAllocator`), and value-initialized otherwise.
+   */
+  explicit StdHolder(std::size_t size, Uninitialized) :
+      Internal::TrackedAllocation(size * sizeof(typename TContainer::value_type)), m_container(size)
+  {}
+
   /**
    * @brief Container-move constructor.
    */
-  explicit StdHolder(std::size_t size, Container&& container) : m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Container&& container) :
+      Internal::TrackedAllocation(size * sizeof(typename TContainer::value_type)), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
@@ -143,6 +241,7 @@ public:
   Container& move_to(Container& destination)
   {
     destination = std::move(this->m_container);
+    untrack();
     return destination;
   }
 
@@ -178,6 +277,8 @@ public:
     }
   }
 
+  explicit StdHolder(std::size_t size, Uninitialized) : StdHolder(size) {}
+
   explicit StdHolder(std::size_t size, Container&& container) : m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
@@ -214,24 +315,33 @@ private:
  * @brief `std::unique_ptr` specialization.
  */
 template <typename T>
-class StdHolder<std::unique_ptr<T[]>> {
+class StdHolder<std::unique_ptr<T[]>> : private Internal::TrackedAllocation {
 public:
 
   using Container = std::unique_ptr<T[]>;
 
-  explicit StdHolder(std::size_t size, const T* data = nullptr) : m_size(size), m_container {new T[m_size]}
+  explicit StdHolder(std::size_t size, const T* data = nullptr) :
+      Internal::TrackedAllocation(size * sizeof(T)), m_size(size), m_container {new T[m_size]}
   {
     if (data) {
       std::copy_n(data, m_size, m_container.get());
     }
   }
 
-  explicit StdHolder(std::size_t size, Container&& container) : m_size(size), m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Uninitialized) :
+      Internal::TrackedAllocation(size * sizeof(T)), m_size(size), m_container {new T[m_size]}
+  {}
+
+  explicit StdHolder(std::size_t size, Container&& container) :
+      Internal::TrackedAllocation(size * sizeof(T)), m_size(size), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
 
-  StdHolder(const StdHolder& other) : StdHolder(other.end() - other.begin(), other.begin()) {}
+  StdHolder(const StdHolder& other) : StdHolder(other.end() - other.begin(), other.begin())
+  {
+    Internal::track_copy(m_size * sizeof(T));
+  }
 
   StdHolder& operator=(StdHolder other)
   {
@@ -241,6 +351,7 @@ public:
 
   friend void swap(StdHolder& lhs, StdHolder& rhs)
   {
+    lhs.swap_tracking(rhs);
     std::swap(lhs.m_size, rhs.m_size);
     std::swap(lhs.m_container, rhs.m_container);
   }
@@ -263,6 +374,7 @@ public:
   Container& move_to(Container& destination)
   {
     destination = std::move(this->m_container);
+    untrack();
     return destination;
   }
 
@@ -303,6 +415,201 @@ private:
   T* m_end;
 };
 
+/**
+ * @ingroup data_classes
+ * @brief Reference-counted copy-on-write holder.
+ * 
+ * Copies share the data until one of them is accessed for writing,
+ * i.e. through any non-constant element accessor, iterator or view,
+ * at which point the data is copied, unless it is not shared anymore.
+ * This makes copies cheap, e.g. to pass rasters by value or return them from getters:
+ * 
+ * \code
+ * CowRaster<float> a(shape);
+ * auto b = a; // No copy
+ * b[0] = 1; // a is copied into b
+ * \endcode
+ * 
+ * Reference counting is thread-safe, but, as with any container,
+ * a holder must not be written while it is copied in another thread.
+ * Checking the reference count costs a little at each non-constant access,
+ * such that `data()` or `begin()` should be called out of inner loops.
+ * 
+ * @warning
+ * Pointers, references and views obtained for writing are not tracked:
+ * if the holder is copied after they were obtained, writing through them modifies all the copies.
+ */
+template <typename T>
+class CowHolder {
+public:
+
+  explicit CowHolder(std::size_t size, const T* data = nullptr) :
+      m_size(size), m_data(size ? new std::remove_const_t<T>[size]() : nullptr)
+  {
+    if (data) {
+      std::copy_n(data, size, m_data.get());
+    }
+  }
+
+  explicit CowHolder(std::size_t size, Uninitialized) :
+      m_size(size), m_data(size ? new std::remove_const_t<T>[size] : nullptr)
+  {}
+
+  CowHolder(const CowHolder&) = default;
+
+  CowHolder(CowHolder&& other) : m_size(other.m_size), m_data(std::move(other.m_data))
+  {
+    other.m_size = 0;
+  }
+
+  CowHolder& operator=(CowHolder other)
+  {
+    std::swap(m_size, other.m_size);
+    std::swap(m_data, other.m_data);
+    return *this;
+  }
+
+  inline const T* begin() const
+  {
+    return m_data.get();
+  }
+
+  inline const T* end() const
+  {
+    return m_data.get() + m_size;
+  }
+
+  /**
+   * @brief Check whether the data is shared with another holder.
+   */
+  bool is_shared() const
+  {
+    return m_data.use_count() > 1;
+  }
+
+  /**
+   * @brief Copy the data if it is shared, such that it can be modified.
+   */
+  void detach()
+  {
+    if (is_shared()) {
+      std::shared_ptr<std::remove_const_t<T>[]> copy(new std::remove_const_t<T>[m_size]);
+      std::copy_n(m_data.get(), m_size, copy.get());
+      m_data = std::move(copy);
+    }
+  }
+
+private:
+
+  std::size_t m_size;
+  std::shared_ptr<std::remove_const_t<T>[]> m_data;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Holder with small-buffer optimization.
+ * @tparam T The value type
+ * @tparam Capacity The number of values which are stored inline
+ * 
+ * Up to `Capacity` values are stored in the holder itself, i.e. on the stack for local rasters,
+ * such that no allocation is made; larger data falls back to the heap.
+ * This is well suited to many tiny rasters whose sizes are bounded but not known at compile time,
+ * e.g. per-source stamps or kernels, while `StdHolder<std::array>` requires the exact size.
+ * 
+ * As opposed to heap-allocated holders, inline data is copied when the holder is moved.
+ * Values are zero-initialized unless constructed with the `uninitialized` tag.
+ */
+template <typename T, std::size_t Capacity>
+class SmallHolder {
+public:
+
+  explicit SmallHolder(std::size_t size, const T* data = nullptr) : SmallHolder(size, uninitialized)
+  {
+    if (data) {
+      std::copy_n(data, size, m_data);
+    } else {
+      std::fill_n(m_data, size, std::remove_const_t<T>());
+    }
+  }
+
+  explicit SmallHolder(std::size_t size, Uninitialized) :
+      m_size(size), m_heap(size > Capacity ? new std::remove_const_t<T>[size] : nullptr),
+      m_data(m_heap ? m_heap.get() : m_buffer.data())
+  {}
+
+  SmallHolder(const SmallHolder& other) : SmallHolder(other.m_size, other.m_data) {}
+
+  SmallHolder(SmallHolder&& other) : m_size(0), m_heap()
+  {
+    m_data = m_buffer.data();
+    *this = std::move(other);
+  }
+
+  ~SmallHolder() = default;
+
+  SmallHolder& operator=(const SmallHolder& other)
+  {
+    if (this != &other) {
+      if (m_size == other.m_size) {
+        std::copy_n(other.m_data, m_size, m_data);
+      } else {
+        *this = SmallHolder(other);
+      }
+    }
+    return *this;
+  }
+
+  SmallHolder& operator=(SmallHolder&& other)
+  {
+    if (this != &other) {
+      m_size = other.m_size;
+      m_heap = std::move(other.m_heap);
+      if (m_heap) {
+        m_data = m_heap.get();
+      } else {
+        m_data = m_buffer.data();
+        std::move(other.m_buffer.begin(), other.m_buffer.begin() + m_size, m_buffer.begin());
+      }
+      other.m_size = 0;
+      other.m_data = other.m_buffer.data();
+    }
+    return *this;
+  }
+
+  inline const T* begin() const
+  {
+    return m_data;
+  }
+
+  inline const T* end() const
+  {
+    return m_data + m_size;
+  }
+
+  /**
+   * @brief Get the number of values which can be stored inline.
+   */
+  static constexpr std::size_t capacity()
+  {
+    return Capacity;
+  }
+
+  /**
+   * @brief Check whether the values are stored inline, i.e. without allocation.
+   */
+  bool is_inline() const
+  {
+    return not m_heap;
+  }
+
+private:
+
+  std::size_t m_size;
+  std::unique_ptr<std::remove_const_t<T>[]> m_heap;
+  std::remove_const_t<T>* m_data;
+  std::array<std::remove_const_t<T>, Capacity> m_buffer;
+};
+
 /**
  * @brief The default data holder.
  * @warning
@@ -314,6 +621,27 @@ using DefaultHolder = std::conditional_t<
     StdHolder<std::unique_ptr<bool[]>>,
     StdHolder<std::vector<T>>>;
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The holder of an output of value type `U` which is computed from a holder `THolder`.
+ * 
+ * Small-buffer holders are propagated, such that small inputs yield small outputs; other holders yield default ones.
+ */
+template <typename THolder, typename U>
+struct SimilarHolder {
+  using Type = DefaultHolder<U>;
+};
+
+template <typename T, std::size_t Capacity, typename U>
+struct SimilarHolder<SmallHolder<T, Capacity>, U> {
+  using Type = SmallHolder<U, Capacity>;
+};
+
+} // namespace Internal
+/// @endcond
+
 } // namespace Linx
 
 #endif
@@ -0,0 +1,116 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_MEMORYBUDGET_H
+#define _LINXBASE_MEMORYBUDGET_H
+
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // clamp
+#include <atomic>
+
+namespace Linx {
+
+/**
+ * @brief Process-wide memory budget for streaming, e.g. to size the chunks of an image which does not fit in memory.
+ *
+ * The budget is advisory: it is not enforced by the allocators,
+ * but streaming algorithms and programs query it to bound their buffers.
+ *
+ * \code
+ * MemoryBudget::limit(std::size_t(1) << 30); // 1 GiB, process-wide, until changed
+ * const auto thickness = MemoryBudget::thickness(width * height * sizeof(float), depth, 2); // With prefetch
+ * for (const auto& chunk : Fits("cube.fits").chunks<Raster<float, 3>>(thickness, 0, true)) {
+ *   process(chunk);
+ * }
+ * \endcode
+ *
+ * @see `Threads::limit()`
+ */
+class MemoryBudget {
+public:
+
+  /**
+   * @brief Scoped process-wide budget.
+   *
+   * The previous budget is restored at destruction.
+   */
+  class Limit {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    explicit Limit(Index bytes) : m_previous(MemoryBudget::limit())
+    {
+      MemoryBudget::limit(bytes);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~Limit()
+    {
+      MemoryBudget::limit(m_previous);
+    }
+
+    Limit(const Limit&) = delete;
+    Limit& operator=(const Limit&) = delete;
+
+  private:
+
+    /**
+     * @brief The budget to be restored.
+     */
+    Index m_previous;
+  };
+
+  /**
+   * @brief Get the process-wide budget in bytes, or 0 if unlimited.
+   */
+  static Index limit()
+  {
+    return limit_storage().load();
+  }
+
+  /**
+   * @brief Set the process-wide budget in bytes, or 0 to remove the limit.
+   */
+  static void limit(Index bytes)
+  {
+    limit_storage().store(bytes > 0 ? bytes : 0);
+  }
+
+  /**
+   * @brief Get the number of sections which fit in the budget.
+   * @param section_bytes The size of a section, e.g. an image plane, in bytes
+   * @param count The total number of sections, which is returned if the budget is unlimited
+   * @param buffers The number of buffers which are simultaneously allocated, e.g. 2 with prefetching
+   *
+   * The result is at least 1, even if a single section exceeds the budget.
+   */
+  static Index thickness(Index section_bytes, Index count, Index buffers = 1)
+  {
+    const auto bytes = limit();
+    if (bytes == 0 || section_bytes <= 0) {
+      return count;
+    }
+    return std::clamp<Index>(bytes / (section_bytes * std::max<Index>(buffers, 1)), 1, std::max<Index>(count, 1));
+  }
+
+private:
+
+  /**
+   * @brief The process-wide budget.
+   */
+  static std::atomic<Index>& limit_storage()
+  {
+    static std::atomic<Index> bytes(0);
+    return bytes;
+  }
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,390 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_ONLINEDISTRIBUTION_H
+#define _LINXBASE_ONLINEDISTRIBUTION_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // max, min, sort
+#include <cmath> // asin, ceil, isnan, sin, sqrt
+#include <iterator> // distance, next
+#include <limits>
+#include <type_traits> // decay_t
+#include <utility> // declval, pair
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Estimate data distribution parameters in a single pass, without storing the values.
+ * @tparam T The element type, which must be real
+ *
+ * As opposed to `DataDistribution`, values are not copied:
+ * they are fed one by one or chunk by chunk with `push()`, and the estimators are updated on the fly.
+ * NaNs are ignored, i.e. they are not counted in `size()`.
+ * Distributions built from separate chunks, e.g. by different threads, can then be combined with `merge()`.
+ *
+ * The size, extrema, sum, mean and variance are exact (up to rounding errors).
+ * The mean and variance are accumulated with Welford's algorithm, which is numerically stable,
+ * and merged with Chan's formula.
+ *
+ * Quantiles are approximated with a merging t-digest (Dunning, 2019),
+ * i.e. a sorted list of weighted centroids, whose weights are small near the tails and larger near the median,
+ * such that the rank error is of order `q (1 - q) / compression`.
+ * The memory footprint is of order `compression`, independently of the number of values.
+ *
+ * \code
+ * auto stats = online_distribution(frame, Threads(8));
+ * const auto noise = stats.stdev();
+ * const auto background = stats.median();
+ * \endcode
+ *
+ * @see `online_distribution()`
+ */
+template <typename T>
+class OnlineDistribution {
+public:
+
+  /**
+   * @copybrief TypeTraits::Floating
+   */
+  using Floating = typename TypeTraits<T>::Floating;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param compression The t-digest compression parameter, i.e. approximately the maximum number of centroids
+   */
+  explicit OnlineDistribution(double compression = 100) :
+      m_compression(compression), m_size(0), m_min(std::numeric_limits<double>::infinity()),
+      m_max(-std::numeric_limits<double>::infinity()), m_sum(0), m_mean(0), m_m2(0), m_centroids(), m_buffer()
+  {
+    m_buffer.reserve(buffer_capacity());
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of values.
+   */
+  std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the min value.
+   */
+  Floating min() const
+  {
+    return m_min;
+  }
+
+  /**
+   * @brief Get the max value.
+   */
+  Floating max() const
+  {
+    return m_max;
+  }
+
+  /**
+   * @brief Get the sum of all values.
+   */
+  Floating sum() const
+  {
+    return m_sum;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Feed a value, unless it is NaN.
+   */
+  OnlineDistribution& push(T value)
+  {
+    const double v = value;
+    if (std::isnan(v)) {
+      return *this;
+    }
+    ++m_size;
+    m_min = std::min(m_min, v);
+    m_max = std::max(m_max, v);
+    m_sum += v;
+    const auto delta = v - m_mean;
+    m_mean += delta / m_size;
+    m_m2 += delta * (v - m_mean);
+    m_buffer.emplace_back(v, 1.);
+    if (m_buffer.size() >= buffer_capacity()) {
+      compress();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Feed a range of values.
+   */
+  template <typename TRange, typename = decltype(std::declval<const TRange&>().begin())>
+  OnlineDistribution& push(const TRange& values)
+  {
+    for (const auto& v : values) {
+      push(v);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Merge another distribution into this one.
+   *
+   * The result is the distribution of the union of the values.
+   */
+  OnlineDistribution& merge(const OnlineDistribution& other)
+  {
+    if (other.m_size == 0) {
+      return *this;
+    }
+    const double na = m_size;
+    const double nb = other.m_size;
+    const auto delta = other.m_mean - m_mean;
+    m_size += other.m_size;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+    m_mean += delta * nb / m_size;
+    m_m2 += other.m_m2 + delta * delta * na * nb / m_size;
+    m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+    m_buffer.insert(m_buffer.end(), other.m_buffer.begin(), other.m_buffer.end());
+    compress();
+    return *this;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the mean.
+   */
+  Floating mean() const
+  {
+    return m_mean;
+  }
+
+  /**
+   * @brief Compute the variance.
+   * @param unbiased Divide by `size() - 1` instead of `size()`
+   * 
+   * The variance is NaN if there is no value, or a single value and `unbiased` is true.
+   */
+  Floating variance(bool unbiased = true) const
+  {
+    if (m_size <= std::size_t(unbiased)) {
+      return std::numeric_limits<Floating>::quiet_NaN();
+    }
+    return m_m2 / (m_size - unbiased);
+  }
+
+  /**
+   * @brief Compute the standard deviation.
+   */
+  Floating stdev(bool unbiased = true) const
+  {
+    return std::sqrt(variance(unbiased));
+  }
+
+  /**
+   * @brief Estimate the median.
+   */
+  Floating median()
+  {
+    return quantile(.5);
+  }
+
+  /**
+   * @brief Estimate the q-th quantile.
+   *
+   * Centroids are interpolated linearly, and the extrema are exact.
+   * This is not `const` because pending values are merged into the digest.
+   */
+  Floating quantile(double q)
+  {
+    compress();
+    if (m_centroids.empty()) {
+      return std::numeric_limits<Floating>::quiet_NaN();
+    }
+    if (q <= 0) {
+      return m_min;
+    }
+    if (q >= 1) {
+      return m_max;
+    }
+    const auto target = q * m_size;
+    const auto count = m_centroids.size();
+    const auto& first = m_centroids.front();
+    if (target < first.second / 2) {
+      return m_min + (first.first - m_min) * target / (first.second / 2);
+    }
+    double cumulated = first.second / 2; // Rank of the current centroid center
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+      const auto& c = m_centroids[i];
+      const auto& d = m_centroids[i + 1];
+      const auto next = cumulated + (c.second + d.second) / 2;
+      if (target < next) {
+        return c.first + (d.first - c.first) * (target - cumulated) / (next - cumulated);
+      }
+      cumulated = next;
+    }
+    const auto& last = m_centroids.back();
+    const auto rest = m_size - cumulated;
+    return rest > 0 ? last.first + (m_max - last.first) * std::min(1., (target - cumulated) / rest) : last.first;
+  }
+
+  /**
+   * @brief Get the number of t-digest centroids, after having merged pending values.
+   */
+  std::size_t centroid_count()
+  {
+    compress();
+    return m_centroids.size();
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the number of pending values which triggers compression.
+   */
+  std::size_t buffer_capacity() const
+  {
+    return static_cast<std::size_t>(std::ceil(5 * m_compression)) + 1;
+  }
+
+  /**
+   * @brief Get the quantile limit of a centroid which starts at quantile `q`, with the k1 scale function.
+   */
+  double limit(double q) const
+  {
+    constexpr double pi = 3.14159265358979323846;
+    const auto k = m_compression / (2 * pi) * std::asin(2 * q - 1) + 1;
+    return k >= m_compression / 4 ? 1. : (std::sin(2 * pi * k / m_compression) + 1) / 2;
+  }
+
+  /**
+   * @brief Merge the pending values and centroids into a new list of centroids.
+   */
+  void compress()
+  {
+    if (m_buffer.empty()) {
+      return;
+    }
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end());
+    m_centroids.clear();
+    const double total = m_size;
+    double merged = 0;
+    auto current = m_buffer.front();
+    auto q_limit = limit(0);
+    for (std::size_t i = 1; i < m_buffer.size(); ++i) {
+      const auto& c = m_buffer[i];
+      if ((merged + current.second + c.second) / total <= q_limit) {
+        current.second += c.second;
+        current.first += (c.first - current.first) * c.second / current.second;
+      } else {
+        merged += current.second;
+        m_centroids.push_back(current);
+        q_limit = limit(merged / total);
+        current = c;
+      }
+    }
+    m_centroids.push_back(current);
+    m_buffer.clear();
+  }
+
+  /**
+   * @brief The compression parameter.
+   */
+  double m_compression;
+
+  /**
+   * @brief The number of values.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The min value.
+   */
+  double m_min;
+
+  /**
+   * @brief The max value.
+   */
+  double m_max;
+
+  /**
+   * @brief The sum.
+   */
+  double m_sum;
+
+  /**
+   * @brief The running mean.
+   */
+  double m_mean;
+
+  /**
+   * @brief The running sum of squared deviations to the mean.
+   */
+  double m_m2;
+
+  /**
+   * @brief The sorted centroids, as (mean, weight) pairs.
+   */
+  std::vector<std::pair<double, double>> m_centroids;
+
+  /**
+   * @brief The pending values or centroids, to be merged into the digest.
+   */
+  std::vector<std::pair<double, double>> m_buffer;
+};
+
+/**
+ * @relatesalso OnlineDistribution
+ * @brief Compute the online distribution of a range, using several threads.
+ * @param values The values
+ * @param threads The threads
+ * @param compression The t-digest compression parameter
+ *
+ * The range is split into as many chunks as threads, whose distributions are merged in order,
+ * such that the result does not depend on the scheduling.
+ */
+template <typename TRange>
+OnlineDistribution<std::decay_t<decltype(*std::declval<const TRange&>().begin())>>
+online_distribution(const TRange& values, const Threads& threads = Threads(1), double compression = 100)
+{
+  using Distribution = OnlineDistribution<std::decay_t<decltype(*values.begin())>>;
+  const Index size = std::distance(values.begin(), values.end());
+  const Index count = std::max<Index>(1, std::min<Index>(threads.count(), size));
+  const Index chunk = (size + count - 1) / count;
+  std::vector<Distribution> partials(count, Distribution(compression));
+#pragma omp parallel for num_threads(count) schedule(static)
+  for (Index c = 0; c < count; ++c) {
+    const auto front = std::min(c * chunk, size);
+    const auto back = std::min(front + chunk, size);
+    auto it = std::next(values.begin(), front);
+    for (auto i = front; i < back; ++i, ++it) {
+      partials[c].push(*it);
+    }
+  }
+  for (Index c = 1; c < count; ++c) {
+    partials[0].merge(partials[c]);
+  }
+  return partials[0];
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,416 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_POOL_H
+#define _LINXBASE_POOL_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Holders.h" // Uninitialized
+
+#include <algorithm> // copy_n
+#include <cstddef> // size_t
+#include <cstdlib> // aligned_alloc, free
+#include <new> // bad_alloc
+#include <type_traits>
+#include <unordered_map>
+#include <utility> // swap
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Thread-local cache of memory blocks, recycled by size.
+ * 
+ * Freed blocks are kept in a free list per block size, such that allocating a block of the same size
+ * (e.g. a raster of the same shape) is a mere pop, without system call nor page fault.
+ * The total size of the cached blocks is bounded by a capacity, above which blocks are actually freed.
+ * 
+ * There is one pool per thread, such that no synchronization is needed.
+ * Blocks can be released in another thread than that which acquired them,
+ * in which case they join the pool of the releasing thread.
+ * Blocks are aligned to `alignment` bytes.
+ */
+class BlockPool {
+public:
+
+  /**
+   * @brief The block alignment, in bytes.
+   */
+  static constexpr std::size_t alignment = 64;
+
+  /**
+   * @brief Get the pool of the calling thread.
+   */
+  static BlockPool& local()
+  {
+    static thread_local BlockPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Destructor, which frees the cached blocks.
+   */
+  ~BlockPool()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Get the capacity, in bytes.
+   */
+  std::size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Set the capacity, in bytes, and free the blocks in excess, if any.
+   */
+  void capacity(std::size_t bytes)
+  {
+    m_capacity = bytes;
+    if (m_cached > m_capacity) {
+      clear();
+    }
+  }
+
+  /**
+   * @brief Get the total size of the cached blocks, in bytes.
+   */
+  std::size_t cached() const
+  {
+    return m_cached;
+  }
+
+  /**
+   * @brief Get a block of given size, from the free list if possible.
+   */
+  void* acquire(std::size_t bytes)
+  {
+    const auto size = padded(bytes);
+    auto it = m_blocks.find(size);
+    if (it != m_blocks.end() && not it->second.empty()) {
+      void* out = it->second.back();
+      it->second.pop_back();
+      m_cached -= size;
+      return out;
+    }
+    void* out = std::aligned_alloc(alignment, size);
+    if (not out) {
+      throw std::bad_alloc();
+    }
+    return out;
+  }
+
+  /**
+   * @brief Give back a block, which is cached unless the capacity would be exceeded.
+   */
+  void release(void* block, std::size_t bytes)
+  {
+    if (not block) {
+      return;
+    }
+    const auto size = padded(bytes);
+    if (m_cached + size > m_capacity) {
+      std::free(block);
+      return;
+    }
+    m_blocks[size].push_back(block);
+    m_cached += size;
+  }
+
+  /**
+   * @brief Free all the cached blocks.
+   */
+  void clear()
+  {
+    for (auto& b : m_blocks) {
+      for (auto* block : b.second) {
+        std::free(block);
+      }
+    }
+    m_blocks.clear();
+    m_cached = 0;
+  }
+
+private:
+
+  BlockPool() : m_capacity(std::size_t(1) << 30), m_cached(0), m_blocks() {}
+
+  /**
+   * @brief Round a size up to the alignment, as required by `aligned_alloc()`.
+   */
+  static std::size_t padded(std::size_t bytes)
+  {
+    return (std::max<std::size_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * @brief The capacity, in bytes.
+   */
+  std::size_t m_capacity;
+
+  /**
+   * @brief The total size of the cached blocks, in bytes.
+   */
+  std::size_t m_cached;
+
+  /**
+   * @brief The free lists, by padded block size.
+   */
+  std::unordered_map<std::size_t, std::vector<void*>> m_blocks;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Monotonic memory arena for short-lived temporaries.
+ * 
+ * A single buffer is allocated at construction, and blocks are allocated by bumping an offset,
+ * such that allocation costs a few instructions and deallocation is free.
+ * Memory is reclaimed all at once when the enclosing `Arena::Scope` is destroyed.
+ * 
+ * The arena is used by `ArenaHolder` through a scope, which makes it the current arena of the thread:
+ * 
+ * \code
+ * Arena arena(256 << 20);
+ * for (const auto& frame : frames) {
+ *   Arena::Scope scope(arena);
+ *   ArenaRaster<float> background(frame.shape()); // Allocated in the arena
+ *   ...
+ * } // Arena memory is reclaimed
+ * \endcode
+ * 
+ * @warning
+ * Arena-held data must not outlive the scope in which it was allocated.
+ */
+class Arena {
+public:
+
+  /**
+   * @brief Scope in which an arena is the current arena of the thread.
+   * 
+   * Scopes can be nested; at destruction, the memory allocated in the scope is reclaimed,
+   * and the previous arena, if any, becomes current again.
+   */
+  class Scope {
+  public:
+
+    /**
+     * @brief Make an arena current.
+     */
+    explicit Scope(Arena& arena) : m_arena(arena), m_previous(current()), m_offset(arena.m_used)
+    {
+      current() = &m_arena;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /**
+     * @brief Reclaim the memory and restore the previous arena.
+     */
+    ~Scope()
+    {
+      m_arena.m_used = m_offset;
+      current() = m_previous;
+    }
+
+  private:
+
+    Arena& m_arena;
+    Arena* m_previous;
+    std::size_t m_offset;
+  };
+
+  /**
+   * @brief Constructor.
+   * @param capacity The capacity, in bytes
+   */
+  explicit Arena(std::size_t capacity) :
+      m_capacity((capacity + BlockPool::alignment - 1) / BlockPool::alignment * BlockPool::alignment), m_used(0),
+      m_data(static_cast<char*>(std::aligned_alloc(BlockPool::alignment, std::max(m_capacity, BlockPool::alignment))))
+  {
+    if (not m_data) {
+      throw std::bad_alloc();
+    }
+  }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief Destructor.
+   */
+  ~Arena()
+  {
+    std::free(m_data);
+  }
+
+  /**
+   * @brief Get the capacity, in bytes.
+   */
+  std::size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Get the number of allocated bytes.
+   */
+  std::size_t used() const
+  {
+    return m_used;
+  }
+
+  /**
+   * @brief Allocate a block, or return `nullptr` if there is not enough room.
+   */
+  void* allocate(std::size_t bytes)
+  {
+    const auto size = (bytes + BlockPool::alignment - 1) / BlockPool::alignment * BlockPool::alignment;
+    if (m_used + size > m_capacity) {
+      return nullptr;
+    }
+    void* out = m_data + m_used;
+    m_used += size;
+    return out;
+  }
+
+  /**
+   * @brief Get the current arena of the thread, or `nullptr` if no scope is active.
+   */
+  static Arena*& current()
+  {
+    static thread_local Arena* arena = nullptr;
+    return arena;
+  }
+
+private:
+
+  std::size_t m_capacity;
+  std::size_t m_used;
+  char* m_data;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Base class of the pool- and arena-backed holders.
+ * @tparam IsArena Allocate from the current arena if possible
+ */
+template <typename T, bool IsArena>
+class RecyclingHolder {
+public:
+
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are supported.");
+
+  explicit RecyclingHolder(std::size_t size, const T* data = nullptr) :
+      m_begin(nullptr), m_end(nullptr), m_pooled(false)
+  {
+    allocate(size);
+    if (data) {
+      std::copy_n(data, size, m_begin);
+    }
+  }
+
+  RecyclingHolder(std::size_t size, Uninitialized) : RecyclingHolder(size) {}
+
+  RecyclingHolder(const RecyclingHolder& other) : RecyclingHolder(other.m_end - other.m_begin, other.m_begin) {}
+
+  RecyclingHolder(RecyclingHolder&& other) : m_begin(other.m_begin), m_end(other.m_end), m_pooled(other.m_pooled)
+  {
+    other.m_begin = nullptr;
+    other.m_end = nullptr;
+    other.m_pooled = false;
+  }
+
+  RecyclingHolder& operator=(RecyclingHolder other)
+  {
+    std::swap(m_begin, other.m_begin);
+    std::swap(m_end, other.m_end);
+    std::swap(m_pooled, other.m_pooled);
+    return *this;
+  }
+
+  ~RecyclingHolder()
+  {
+    if (m_pooled) {
+      BlockPool::local().release(m_begin, (m_end - m_begin) * sizeof(T));
+    }
+  }
+
+  inline const T* begin() const
+  {
+    return m_begin;
+  }
+
+  inline const T* end() const
+  {
+    return m_end;
+  }
+
+private:
+
+  void allocate(std::size_t size)
+  {
+    if (size == 0) {
+      return;
+    }
+    void* block = nullptr;
+    if constexpr (IsArena) {
+      if (auto* arena = Arena::current()) {
+        block = arena->allocate(size * sizeof(T));
+      }
+    }
+    if (not block) {
+      block = BlockPool::local().acquire(size * sizeof(T));
+      m_pooled = true;
+    }
+    m_begin = static_cast<T*>(block);
+    m_end = m_begin + size;
+  }
+
+  T* m_begin;
+  T* m_end;
+  bool m_pooled;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Owning holder whose memory is recycled through the thread-local `BlockPool`.
+ * 
+ * As opposed to `StdHolder`, values are not initialized, unless some data is copied at construction,
+ * like with `AlignedBuffer`.
+ * Memory is 64-byte aligned.
+ */
+template <typename T>
+class PoolHolder : public Internal::RecyclingHolder<T, false> {
+public:
+
+  using Internal::RecyclingHolder<T, false>::RecyclingHolder;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Owning holder whose memory is taken from the current `Arena` if any, or from the `BlockPool` otherwise.
+ * 
+ * Values are not initialized, unless some data is copied at construction.
+ * @warning
+ * When allocated in an arena, the data must not outlive the `Arena::Scope`.
+ */
+template <typename T>
+class ArenaHolder : public Internal::RecyclingHolder<T, true> {
+public:
+
+  using Internal::RecyclingHolder<T, true>::RecyclingHolder;
+};
+
+} // namespace Linx
+
+#endif
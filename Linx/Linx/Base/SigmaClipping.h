@@ -0,0 +1,309 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_SIGMACLIPPING_H
+#define _LINXBASE_SIGMACLIPPING_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // min, min_element, move, nth_element, partition
+#include <cmath> // sqrt
+#include <iterator> // distance
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Iterative k-sigma clipping estimator of the mean, median and standard deviation.
+ * @tparam T The element type, which must be real
+ *
+ * At each iteration, the center (median or mean) and standard deviation of the surviving values are estimated,
+ * and the values farther than `k` standard deviations from the center are rejected.
+ * Iterations stop when no value is rejected, or when the maximum number of iterations is reached.
+ *
+ * The values are copied once in an internal buffer, which is kept across calls, e.g. when estimating
+ * the background of successive tiles, or the caller buffer is clipped in place.
+ * Between iterations, the survivors are partitioned to the front of the buffer,
+ * such that each iteration only touches the survivors.
+ * The moments are accumulated and the survivors are partitioned chunk by chunk, in parallel.
+ *
+ * \code
+ * SigmaClipping<float> clipping(3, 10);
+ * for (const auto& tile : tiles) {
+ *   clipping.clip(tile);
+ *   background.push_back(clipping.median());
+ *   noise.push_back(clipping.stdev());
+ * }
+ * \endcode
+ */
+template <typename T>
+class SigmaClipping {
+public:
+
+  /**
+   * @copybrief TypeTraits::Floating
+   */
+  using Floating = typename TypeTraits<T>::Floating;
+
+  /**
+   * @brief The center estimators.
+   */
+  enum class Center {
+    Median, ///< The median, which is robust
+    Mean ///< The mean, which is faster
+  };
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param k The rejection threshold, in number of standard deviations
+   * @param max_iterations The maximum number of iterations
+   * @param center The center estimator
+   */
+  explicit SigmaClipping(double k = 3, Index max_iterations = 5, Center center = Center::Median) :
+      m_k(k), m_max_iterations(max_iterations), m_center(center), m_buffer(), m_size(0), m_iterations(0), m_mean(0),
+      m_median(0), m_stdev(0)
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of surviving values.
+   */
+  std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the number of iterations performed.
+   */
+  Index iterations() const
+  {
+    return m_iterations;
+  }
+
+  /**
+   * @brief Get the mean of the surviving values.
+   */
+  Floating mean() const
+  {
+    return m_mean;
+  }
+
+  /**
+   * @brief Get the median of the surviving values.
+   */
+  Floating median() const
+  {
+    return m_median;
+  }
+
+  /**
+   * @brief Get the (unbiased) standard deviation of the surviving values.
+   */
+  Floating stdev() const
+  {
+    return m_stdev;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Clip a range of values.
+   */
+  template <typename TRange>
+  SigmaClipping& clip(const TRange& values, const Threads& threads = Threads(1))
+  {
+    m_buffer.assign(values.begin(), values.end());
+    return clip_inplace(m_buffer.data(), m_buffer.data() + m_buffer.size(), threads);
+  }
+
+  /**
+   * @brief Clip the values of a range where a mask is true (or non-zero).
+   */
+  template <typename TRange, typename TMask>
+  SigmaClipping& clip_masked(const TRange& values, const TMask& mask, const Threads& threads = Threads(1))
+  {
+    m_buffer.clear();
+    auto mit = mask.begin();
+    for (auto it = values.begin(); it != values.end(); ++it, ++mit) {
+      if (*mit) {
+        m_buffer.push_back(*it);
+      }
+    }
+    return clip_inplace(m_buffer.data(), m_buffer.data() + m_buffer.size(), threads);
+  }
+
+  /**
+   * @brief Clip a caller buffer in place.
+   *
+   * The survivors are moved to the front of the buffer, in an unspecified order.
+   */
+  SigmaClipping& clip_inplace(T* begin, T* end, const Threads& threads = Threads(1))
+  {
+    m_iterations = 0;
+    while (m_iterations < m_max_iterations && end - begin > 1) {
+      estimate(begin, end, threads);
+      const auto center = m_center == Center::Median ? m_median : m_mean;
+      const auto lower = center - m_k * m_stdev;
+      const auto upper = center + m_k * m_stdev;
+      auto* survivors = partition(begin, end, lower, upper, threads);
+      ++m_iterations;
+      if (survivors == end) {
+        m_size = end - begin;
+        return *this;
+      }
+      end = survivors;
+    }
+    estimate(begin, end, threads);
+    return *this;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Split a range into as many chunks as threads, with at least some elements per chunk.
+   */
+  static Index chunk_count(Index size, const Threads& threads)
+  {
+    constexpr Index min_chunk = 4096;
+    return std::max<Index>(1, std::min<Index>(threads.count(), size / min_chunk));
+  }
+
+  /**
+   * @brief Estimate the statistics of a range.
+   */
+  void estimate(T* begin, T* end, const Threads& threads)
+  {
+    const Index size = end - begin;
+    m_size = size;
+    if (size == 0) {
+      m_mean = m_median = m_stdev = std::numeric_limits<Floating>::quiet_NaN();
+      return;
+    }
+    const auto count = chunk_count(size, threads);
+    const auto chunk = (size + count - 1) / count;
+    std::vector<double> sums(count, 0.);
+#pragma omp parallel for num_threads(count) schedule(static)
+    for (Index c = 0; c < count; ++c) {
+      const auto* it = begin + c * chunk;
+      const auto* back = begin + std::min(size, (c + 1) * chunk);
+      double sum = 0;
+      for (; it < back; ++it) {
+        sum += *it;
+      }
+      sums[c] = sum;
+    }
+    double mean = 0;
+    for (auto s : sums) {
+      mean += s;
+    }
+    mean /= size;
+#pragma omp parallel for num_threads(count) schedule(static)
+    for (Index c = 0; c < count; ++c) {
+      const auto* it = begin + c * chunk;
+      const auto* back = begin + std::min(size, (c + 1) * chunk);
+      double sum2 = 0;
+      for (; it < back; ++it) {
+        const auto d = *it - mean;
+        sum2 += d * d;
+      }
+      sums[c] = sum2;
+    }
+    double sum2 = 0;
+    for (auto s : sums) {
+      sum2 += s;
+    }
+    m_mean = mean;
+    m_stdev = size > 1 ? std::sqrt(sum2 / (size - 1)) : 0;
+    auto* middle = begin + (size - 1) / 2;
+    std::nth_element(begin, middle, end);
+    m_median = size % 2 ? Floating(*middle) : Floating(.5 * (*middle + *std::min_element(middle + 1, end)));
+  }
+
+  /**
+   * @brief Move the values in `[lower, upper]` to the front of a range.
+   * @return The end of the survivors
+   */
+  static T* partition(T* begin, T* end, double lower, double upper, const Threads& threads)
+  {
+    const auto inside = [=](const T& e) {
+      return e >= lower && e <= upper;
+    };
+    const Index size = end - begin;
+    const auto count = chunk_count(size, threads);
+    if (count == 1) {
+      return std::partition(begin, end, inside);
+    }
+    const auto chunk = (size + count - 1) / count;
+    std::vector<T*> ends(count);
+#pragma omp parallel for num_threads(count) schedule(static)
+    for (Index c = 0; c < count; ++c) {
+      ends[c] = std::partition(begin + c * chunk, begin + std::min(size, (c + 1) * chunk), inside);
+    }
+    auto* out = ends[0];
+    for (Index c = 1; c < count; ++c) {
+      auto* front = begin + c * chunk;
+      out = std::move(front, ends[c], out);
+    }
+    return out;
+  }
+
+  /**
+   * @brief The rejection threshold.
+   */
+  double m_k;
+
+  /**
+   * @brief The maximum number of iterations.
+   */
+  Index m_max_iterations;
+
+  /**
+   * @brief The center estimator.
+   */
+  Center m_center;
+
+  /**
+   * @brief The internal buffer.
+   */
+  std::vector<T> m_buffer;
+
+  /**
+   * @brief The number of survivors.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The number of iterations performed.
+   */
+  Index m_iterations;
+
+  /**
+   * @brief The mean of the survivors.
+   */
+  Floating m_mean;
+
+  /**
+   * @brief The median of the survivors.
+   */
+  Floating m_median;
+
+  /**
+   * @brief The standard deviation of the survivors.
+   */
+  Floating m_stdev;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,209 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_THREADS_H
+#define _LINXBASE_THREADS_H
+
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // min
+#include <atomic>
+#include <thread> // hardware_concurrency
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h> // sched_setaffinity
+#endif
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Pin the calling thread to some CPU.
+ * @return True if the thread was pinned
+ */
+inline bool pin_thread(Index cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief Multi-threading execution policy.
+ * 
+ * Algorithms which accept a `Threads` argument split their workload and process the parts concurrently.
+ * Parallelization relies on OpenMP: if the library is built without OpenMP support,
+ * then the policy is accepted but the algorithms run on a single thread.
+ * 
+ * \code
+ * auto filter = median_filter<float>(Box<2>::from_center(4));
+ * Raster<float> out(in.shape());
+ * filter.transform(extrapolation<Nearest>(in), out, Threads(8));
+ * \endcode
+ * 
+ * All the algorithms share the OpenMP thread pool, and the number of threads they use can be bounded globally,
+ * e.g. by a service which runs several pipelines concurrently:
+ * 
+ * \code
+ * Threads::limit(4); // Process-wide, until changed
+ * {
+ *   Threads::Limit guard(2); // On the calling thread, until the end of the scope
+ *   filter.transform(in, out, Threads(8)); // Runs on 2 threads
+ * }
+ * \endcode
+ * 
+ * In order to prevent oversubscription, algorithms which are called from a parallel region
+ * (e.g. in a parallel loop over the frames of a stack) run on a single thread.
+ */
+class Threads {
+public:
+
+  /**
+   * @brief Scoped limit of the calling thread.
+   * 
+   * Within the scope, the limit overrides the process-wide limit for the calling thread only,
+   * such that guards of different threads, e.g. of concurrent requests, do not interfere.
+   * Guards of a given thread can be nested, and the previous limit is restored at destruction.
+   */
+  class Limit {
+  public:
+
+    /**
+     * @brief Constructor.
+     * @param count The maximum number of threads, or 0 to remove the limit within the scope
+     */
+    explicit Limit(Index count) : m_previous(scoped_limit())
+    {
+      scoped_limit() = count > 0 ? count : 0;
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~Limit()
+    {
+      scoped_limit() = m_previous;
+    }
+
+    Limit(const Limit&) = delete;
+    Limit& operator=(const Limit&) = delete;
+
+  private:
+
+    /**
+     * @brief The scoped limit to be restored, or -1 if none.
+     */
+    Index m_previous;
+  };
+
+  /**
+   * @brief Constructor.
+   * @param count The number of threads, or 0 to use the OpenMP default
+   */
+  explicit Threads(Index count = 0) : m_count(count) {}
+
+  /**
+   * @brief Get the maximum number of threads, or 0 if unlimited.
+   * 
+   * This is the limit of the innermost `Limit` guard of the calling thread, if any, or the process-wide limit.
+   */
+  static Index limit()
+  {
+    const auto scoped = scoped_limit();
+    return scoped >= 0 ? scoped : limit_storage().load();
+  }
+
+  /**
+   * @brief Set the process-wide maximum number of threads, or 0 to remove the limit.
+   */
+  static void limit(Index count)
+  {
+    limit_storage().store(count > 0 ? count : 0);
+  }
+
+  /**
+   * @brief Pin the threads of the OpenMP pool to successive CPUs, e.g. to stabilize timings.
+   * @param first The CPU of the first thread
+   * @return True if all the threads were pinned
+   *
+   * Pinning is supported on Linux only.
+   */
+  static bool pin(Index first = 0)
+  {
+    const Index cpus = std::max(1U, std::thread::hardware_concurrency());
+    bool out = true;
+#ifdef _OPENMP
+#pragma omp parallel reduction(&& : out)
+    out = Internal::pin_thread((first + omp_get_thread_num()) % cpus);
+#else
+    out = Internal::pin_thread(first % cpus);
+#endif
+    return out;
+  }
+
+  /**
+   * @brief Get the effective number of threads.
+   * 
+   * If the requested count is not positive, the OpenMP default is returned.
+   * The result is bounded by the process-wide limit, if any.
+   * If OpenMP is not enabled, or if called from a parallel region, 1 is returned.
+   */
+  int count() const
+  {
+#ifdef _OPENMP
+    if (omp_in_parallel()) {
+      return 1;
+    }
+    const Index requested = m_count > 0 ? m_count : omp_get_max_threads();
+    const auto max = limit();
+    return static_cast<int>(max > 0 ? std::min(requested, max) : requested);
+#else
+    return 1;
+#endif
+  }
+
+private:
+
+  /**
+   * @brief The process-wide limit.
+   */
+  static std::atomic<Index>& limit_storage()
+  {
+    static std::atomic<Index> max(0);
+    return max;
+  }
+
+  /**
+   * @brief The scoped limit of the calling thread, or -1 if none.
+   */
+  static Index& scoped_limit()
+  {
+    thread_local Index max = -1;
+    return max;
+  }
+
+  /**
+   * @brief The requested number of threads.
+   */
+  Index m_count;
+};
+
+} // namespace Linx
+
+#endif
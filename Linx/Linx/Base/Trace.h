@@ -0,0 +1,319 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_TRACE_H
+#define _LINXBASE_TRACE_H
+
+#include <cstddef> // size_t
+#include <cstdint>
+#include <cstdlib> // atexit
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef LINX_TRACE
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#endif
+
+/// @cond
+#define LINX_TRACE_CONCAT_IMPL(a, b) a##b
+#define LINX_TRACE_CONCAT(a, b) LINX_TRACE_CONCAT_IMPL(a, b)
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Trace the current scope under a given name, which must be a string literal.
+ *
+ * This is a no-op unless `LINX_TRACE` is defined.
+ * @see `Trace`
+ */
+#ifdef LINX_TRACE
+#define LINX_TRACE_SCOPE(name) const Linx::Internal::TraceScope LINX_TRACE_CONCAT(linx_trace_scope_, __LINE__)(name)
+#else
+#define LINX_TRACE_SCOPE(name) (void)0
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief A traced scope.
+ */
+struct TraceEvent {
+  /**
+   * @brief The scope name.
+   */
+  const char* name;
+
+  /**
+   * @brief The index of the thread, in order of first event.
+   */
+  std::size_t thread;
+
+  /**
+   * @brief The start time, in nanoseconds since an arbitrary origin.
+   */
+  std::uint64_t start_ns;
+
+  /**
+   * @brief The end time, in nanoseconds since the same origin.
+   */
+  std::uint64_t stop_ns;
+};
+
+/// @cond
+namespace Internal {
+
+#ifdef LINX_TRACE
+
+/**
+ * @brief A single-producer ring buffer of the events of a thread.
+ *
+ * The owning thread writes the events without locking, and publishes them by incrementing the atomic head.
+ * When the buffer is full, the oldest events are overwritten.
+ */
+class TraceBuffer {
+public:
+
+  static constexpr std::size_t Capacity = 1 << 14;
+
+  explicit TraceBuffer(std::size_t thread) : m_thread(thread), m_events(Capacity), m_head(0) {}
+
+  void push(const char* name, std::uint64_t start, std::uint64_t stop)
+  {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    m_events[head % Capacity] = {name, m_thread, start, stop};
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  void collect(std::vector<TraceEvent>& out) const
+  {
+    const auto head = m_head.load(std::memory_order_acquire);
+    const auto front = head > Capacity ? head - Capacity : 0;
+    for (auto i = front; i < head; ++i) {
+      out.push_back(m_events[i % Capacity]);
+    }
+  }
+
+  void clear()
+  {
+    m_head.store(0, std::memory_order_release);
+  }
+
+private:
+
+  std::size_t m_thread;
+  std::vector<TraceEvent> m_events;
+  std::atomic<std::size_t> m_head;
+};
+
+/**
+ * @brief The global registry of the trace buffers.
+ *
+ * Buffers are owned by the registry, such that they survive their threads.
+ */
+class TraceRegistry {
+public:
+
+  static TraceRegistry& instance()
+  {
+    static TraceRegistry registry;
+    return registry;
+  }
+
+  /**
+   * @brief Get the buffer of the calling thread, which is created at the first call.
+   */
+  static TraceBuffer& buffer()
+  {
+    static thread_local TraceBuffer* local = instance().create();
+    return *local;
+  }
+
+  static std::uint64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  std::vector<TraceEvent> events()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<TraceEvent> out;
+    for (const auto& b : m_buffers) {
+      b->collect(out);
+    }
+    return out;
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& b : m_buffers) {
+      b->clear();
+    }
+  }
+
+private:
+
+  TraceBuffer* create()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers.push_back(std::make_unique<TraceBuffer>(m_buffers.size()));
+    return m_buffers.back().get();
+  }
+
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<TraceBuffer>> m_buffers;
+};
+
+/**
+ * @brief Record the lifetime of a scope.
+ */
+class TraceScope {
+public:
+
+  explicit TraceScope(const char* name) : m_name(name), m_start(TraceRegistry::now()) {}
+
+  ~TraceScope()
+  {
+    TraceRegistry::buffer().push(m_name, m_start, TraceRegistry::now());
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+
+  const char* m_name;
+  std::uint64_t m_start;
+};
+
+#endif
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Low-overhead tracing of named scopes, e.g. to profile production runs.
+ *
+ * Scopes are traced with `LINX_TRACE_SCOPE()`, which records the start and end times with `std::chrono::steady_clock`
+ * into a ring buffer of the calling thread, without locking.
+ * Each thread keeps the latest 16384 events.
+ * Filters and I/O are instrumented internally.
+ *
+ * \code
+ * void calibrate(...)
+ * {
+ *   LINX_TRACE_SCOPE("calibrate");
+ *   ...
+ * }
+ *
+ * std::ofstream file("trace.json");
+ * Trace::write(file); // To be loaded in chrome://tracing or Perfetto
+ * \endcode
+ *
+ * Tracing is compiled only if `LINX_TRACE` is defined (consistently in all the translation units),
+ * and it costs nothing otherwise.
+ * Events should be collected while no traced scope is being closed, e.g. after the parallel regions.
+ */
+class Trace {
+public:
+
+  /**
+   * @brief Check whether tracing is compiled.
+   */
+  static constexpr bool enabled()
+  {
+#ifdef LINX_TRACE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Get the recorded events, thread by thread.
+   */
+  static std::vector<TraceEvent> events()
+  {
+#ifdef LINX_TRACE
+    return Internal::TraceRegistry::instance().events();
+#else
+    return {};
+#endif
+  }
+
+  /**
+   * @brief Discard the recorded events.
+   */
+  static void clear()
+  {
+#ifdef LINX_TRACE
+    Internal::TraceRegistry::instance().clear();
+#endif
+  }
+
+  /**
+   * @brief Write the recorded events in the Chrome trace event format, with microsecond times.
+   */
+  static void write(std::ostream& out)
+  {
+    const auto records = events();
+    std::uint64_t origin = records.empty() ? 0 : records.front().start_ns;
+    for (const auto& e : records) {
+      origin = e.start_ns < origin ? e.start_ns : origin;
+    }
+    out << "{\"traceEvents\": [";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+      const auto& e = records[i];
+      out << (i ? ",\n " : "\n ") << "{\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << e.thread
+          << ", \"ts\": " << (e.start_ns - origin) / 1000. << ", \"dur\": " << (e.stop_ns - e.start_ns) / 1000. << '}';
+    }
+    out << "\n]}\n";
+  }
+
+  /**
+   * @brief Write the recorded events to a file at program exit, or cancel writing if the path is empty.
+   * @see `ProgramOptions::performance()`
+   */
+  static void write_at_exit(const std::string& path)
+  {
+    static bool registered = false;
+    exit_path() = path;
+    if (not registered && not path.empty()) {
+      registered = true;
+#ifdef LINX_TRACE
+      Internal::TraceRegistry::instance(); // Constructed before registration, such that destroyed after writing
+#endif
+      std::atexit([]() {
+        if (not exit_path().empty()) {
+          std::ofstream file(exit_path());
+          write(file);
+        }
+      });
+    }
+  }
+
+private:
+
+  /**
+   * @brief The path of the file written at exit.
+   */
+  static std::string& exit_path()
+  {
+    static std::string path;
+    return path;
+  }
+};
+
+} // namespace Linx
+
+#endif
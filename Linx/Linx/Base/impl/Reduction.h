@@ -0,0 +1,189 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_IMPL_REDUCTION_H
+#define _LINXBASE_IMPL_REDUCTION_H
+
+#include "Linx/Base/Threads.h"
+
+#include <algorithm> // min
+#include <iterator> // distance, iterator_traits
+#include <numeric> // accumulate, inner_product
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether an iterator is random-access, i.e. whether its range can be split into blocks.
+ */
+template <typename TIt>
+constexpr bool is_random_access()
+{
+  return std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<TIt>::iterator_category>;
+}
+
+/**
+ * @brief The number of terms of a reduction block.
+ * 
+ * The block length does not depend on the number of threads, such that the result does not either.
+ */
+constexpr Index reduction_block = 4096;
+
+/**
+ * @brief Sum some terms with pairwise summation.
+ * @param front The index of the first term
+ * @param size The number of terms
+ * @param term The function which computes a term from its index
+ * 
+ * Short sequences are summed with 8 interleaved accumulators, which vectorizes;
+ * longer sequences are split in halves recursively.
+ * The rounding error grows with the logarithm of the size instead of the size,
+ * and the association order is fixed, such that the result is reproducible.
+ */
+template <typename TAcc, typename TTerm>
+TAcc pairwise_sum(Index front, Index size, const TTerm& term)
+{
+  if (size > 128) {
+    const auto half = size / 16 * 8;
+    return pairwise_sum<TAcc>(front, half, term) + pairwise_sum<TAcc>(front + half, size - half, term);
+  }
+  TAcc acc[8] = {};
+  const auto back = front + size / 8 * 8;
+  for (Index i = front; i < back; i += 8) {
+    for (Index j = 0; j < 8; ++j) {
+      acc[j] += term(i + j);
+    }
+  }
+  for (Index i = back; i < front + size; ++i) {
+    acc[i - back] += term(i);
+  }
+  return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+/**
+ * @brief Sum some terms block-wise, in parallel.
+ * @param size The number of terms
+ * @param term The function which computes a term from its index, which must be thread-safe
+ * @param threads The threads
+ * 
+ * Blocks of `reduction_block` terms are summed concurrently, and then the block sums are summed sequentially,
+ * both with `pairwise_sum()`, such that the result is the same whatever the number of threads.
+ */
+template <typename TAcc, typename TTerm>
+TAcc parallel_sum(Index size, const TTerm& term, Threads threads)
+{
+  const Index block_count = (size + reduction_block - 1) / reduction_block;
+  if (block_count <= 1) {
+    return pairwise_sum<TAcc>(0, size, term);
+  }
+  std::vector<TAcc> sums(block_count);
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index b = 0; b < block_count; ++b) {
+    const auto front = b * reduction_block;
+    sums[b] = pairwise_sum<TAcc>(front, std::min(reduction_block, size - front), term);
+  }
+  return pairwise_sum<TAcc>(0, block_count, [&](Index b) {
+    return sums[b];
+  });
+}
+
+/**
+ * @brief Find the index of an element block-wise, in parallel.
+ * @param size The number of elements
+ * @param replaces The predicate which tells whether element `i` replaces element `j` as `replaces(i, j)`
+ * @param threads The threads
+ * 
+ * The predicate is applied in order within blocks, and then to the block results, in order,
+ * such that the result is that of a sequential scan, e.g. the first min if `replaces` is `in[i] < in[j]`.
+ */
+template <typename TReplaces>
+Index parallel_find(Index size, const TReplaces& replaces, Threads threads)
+{
+  const Index block_count = (size + reduction_block - 1) / reduction_block;
+  std::vector<Index> founds(block_count);
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index b = 0; b < block_count; ++b) {
+    const auto front = b * reduction_block;
+    const auto end = std::min(front + reduction_block, size);
+    Index found = front;
+    for (Index i = front + 1; i < end; ++i) {
+      found = replaces(i, found) ? i : found;
+    }
+    founds[b] = found;
+  }
+  Index out = 0;
+  for (auto i : founds) {
+    out = replaces(i, out) ? i : out;
+  }
+  return out;
+}
+
+/**
+ * @brief Sum some function of the elements of one or two ranges, in parallel if they are random-access.
+ * @param term The function of the elements, which must be thread-safe
+ * @param threads The threads
+ * @param begin The beginning of the first range
+ * @param end The end of the first range
+ * @param others The beginning of the second range, if any
+ * 
+ * Other ranges are summed sequentially, with `std::accumulate()` or `std::inner_product()`.
+ */
+template <typename TAcc, typename TTerm, typename TIt, typename... TIts>
+TAcc range_sum(const TTerm& term, Threads threads, TIt begin, TIt end, TIts... others)
+{
+  static_assert(sizeof...(TIts) <= 1, "At most two ranges are supported.");
+  if constexpr (is_random_access<TIt>() && (is_random_access<TIts>() && ...)) {
+    return parallel_sum<TAcc>(
+        end - begin,
+        [&](Index i) {
+          return TAcc(term(begin[i], others[i]...));
+        },
+        threads);
+  } else if constexpr (sizeof...(TIts) == 0) {
+    return std::accumulate(begin, end, TAcc(), [&](TAcc acc, const auto& e) {
+      return acc + term(e);
+    });
+  } else {
+    return std::inner_product(begin, end, others..., TAcc(), std::plus<TAcc> {}, term);
+  }
+}
+
+/**
+ * @brief Find the first element for which no other element is preferred, in parallel if the range is random-access.
+ * @param begin The beginning of the range
+ * @param end The end of the range
+ * @param replaces The predicate which tells whether element `a` replaces element `b` as `replaces(a, b)`
+ * @param threads The threads
+ * @return `end` if the range is empty
+ */
+template <typename TIt, typename TReplaces>
+TIt range_find(TIt begin, TIt end, const TReplaces& replaces, Threads threads)
+{
+  if constexpr (is_random_access<TIt>()) {
+    const auto index = parallel_find(
+        end - begin,
+        [&](Index i, Index j) {
+          return replaces(begin[i], begin[j]);
+        },
+        threads);
+    return begin + index;
+  } else {
+    auto out = begin;
+    for (auto it = begin; it != end; ++it) {
+      out = replaces(*it, *out) ? it : out;
+    }
+    return out;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -8,30 +8,98 @@
 #include "Linx/Base/TypeUtils.h" // LINX_FORWARD
 
 #include <algorithm>
+#include <array>
 #include <boost/operators.hpp>
 #include <functional>
 #include <type_traits>
+#include <utility> // index_sequence
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The size of an `std::array` if it is small enough to be unrolled, or -1 otherwise.
+ */
+template <typename TContainer>
+struct UnrolledArraySize : std::integral_constant<Index, -1> {};
+
+template <typename T, std::size_t S>
+struct UnrolledArraySize<std::array<T, S>> : std::integral_constant<Index, (S <= 4 ? Index(S) : -1)> {};
+
+/**
+ * @brief The size of a container if it is held in a small `std::array`, or -1 otherwise.
+ * 
+ * Element-wise operations on such containers (e.g. `Position<N>` for `N &le; 4`) are unrolled at compile-time.
+ */
+template <typename TDerived, typename = void>
+struct UnrolledSize : std::integral_constant<Index, -1> {};
+
+template <typename TDerived>
+struct UnrolledSize<TDerived, std::void_t<typename TDerived::Holder::Container>> :
+    UnrolledArraySize<std::decay_t<typename TDerived::Holder::Container>> {};
+
+/**
+ * @brief Call `func(i)` for each `i` of an index sequence.
+ */
+template <typename TFunc, std::size_t... Is>
+inline void unroll(std::index_sequence<Is...>, TFunc&& func)
+{
+  (func(Is), ...);
+}
+
+/**
+ * @brief Apply a unary function to each element in place, unrolled if possible.
+ */
+template <typename TDerived, typename TFunc>
+inline void transform_inplace(TDerived& out, TFunc&& func)
+{
+  constexpr auto S = UnrolledSize<TDerived>::value;
+  if constexpr (S >= 0) {
+    auto it = out.begin();
+    unroll(std::make_index_sequence<S>(), [&](std::size_t i) {
+      it[i] = func(it[i]);
+    });
+  } else {
+    std::transform(out.begin(), out.end(), out.begin(), LINX_FORWARD(func));
+  }
+}
+
+/**
+ * @brief Apply a binary function to each pair of elements in place, unrolled if possible.
+ */
+template <typename TDerived, typename TFunc>
+inline void transform_inplace(TDerived& out, const TDerived& in, TFunc&& func)
+{
+  constexpr auto S = UnrolledSize<TDerived>::value;
+  if constexpr (S >= 0) {
+    auto it = out.begin();
+    auto jt = in.begin();
+    unroll(std::make_index_sequence<S>(), [&](std::size_t i) {
+      it[i] = func(it[i], jt[i]);
+    });
+  } else {
+    std::transform(out.begin(), out.end(), in.begin(), out.begin(), LINX_FORWARD(func));
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 #define LINX_VECTOR_OPERATOR_INPLACE(op) \
   TDerived& operator op##=(const TDerived & rhs) \
   { \
-    std::transform( \
-        LINX_CRTP_DERIVED.begin(), \
-        LINX_CRTP_DERIVED.end(), \
-        rhs.begin(), \
-        LINX_CRTP_DERIVED.begin(), \
-        [](auto e, auto f) { \
-          return e op f; \
-        }); \
+    Internal::transform_inplace(LINX_CRTP_DERIVED, rhs, [](auto e, auto f) { \
+      return e op f; \
+    }); \
     return LINX_CRTP_DERIVED; \
   }
 
 #define LINX_SCALAR_OPERATOR_INPLACE(op) \
   TDerived& operator op##=(const T & rhs) \
   { \
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [&](auto e) { \
+    Internal::transform_inplace(LINX_CRTP_DERIVED, [&](auto e) { \
       return e op rhs; \
     }); \
     return LINX_CRTP_DERIVED; \
@@ -114,7 +182,7 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
    */
   TDerived& operator++()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_inplace(LINX_CRTP_DERIVED, [](auto rhs) {
       return ++rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -125,7 +193,7 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
    */
   TDerived& operator--()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_inplace(LINX_CRTP_DERIVED, [](auto rhs) {
       return --rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -147,7 +215,7 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
   TDerived operator-() const
   {
     TDerived res = LINX_CRTP_CONST_DERIVED;
-    std::transform(res.begin(), res.end(), res.begin(), [&](auto r) {
+    Internal::transform_inplace(res, [](auto r) {
       return -r;
     });
     return res;
@@ -195,7 +263,7 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
    */
   TDerived& operator++()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_inplace(LINX_CRTP_DERIVED, [](auto rhs) {
       return ++rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -206,7 +274,7 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
    */
   TDerived& operator--()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_inplace(LINX_CRTP_DERIVED, [](auto rhs) {
       return --rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -228,7 +296,7 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
   TDerived operator-() const
   {
     TDerived res = static_cast<const TDerived&>(*this);
-    std::transform(res.begin(), res.end(), res.begin(), [&](auto r) {
+    Internal::transform_inplace(res, [](auto r) {
       return -r;
     });
     return res;
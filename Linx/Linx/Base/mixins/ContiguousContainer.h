@@ -9,6 +9,8 @@
 
 #include <algorithm> // equal
 #include <ostream>
+#include <type_traits> // void_t
+#include <utility> // declval
 
 namespace Linx {
 
@@ -32,11 +34,40 @@ namespace Linx {
  * - `inline const T* begin() const`;
  * - `inline const T* end() const`.
  * 
+ * Optionally, a holder which shares its data, like `CowHolder`, implements `void detach()`,
+ * which is called before any non-constant access to the elements, in order to take exclusive ownership of them.
+ * 
  * @par_example
  * Here is a minimal `ContiguousRange`-compliant class:
  * \snippet LinxDemoBasics_test.cpp MallocRaster
  */
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a holder implements `detach()`.
+ */
+template <typename T, typename = void>
+struct HasDetach : std::false_type {};
+
+template <typename T>
+struct HasDetach<T, std::void_t<decltype(std::declval<T&>().detach())>> : std::true_type {};
+
+/**
+ * @brief Call `detach()` if it is implemented, i.e. prepare a holder for writing.
+ */
+template <typename T>
+inline void detach(T& holder)
+{
+  if constexpr (HasDetach<T>::value) {
+    holder.detach();
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup mixins
  * @brief Base class for a contiguous container.
@@ -144,6 +175,7 @@ struct ContiguousContainerMixin {
    */
   inline T* data()
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<T*>(const_cast<const ContiguousContainerMixin&>(*this).data());
   }
 
@@ -160,6 +192,7 @@ struct ContiguousContainerMixin {
    */
   inline T& operator[](size_type index)
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this)[index]);
   }
 
@@ -176,6 +209,7 @@ struct ContiguousContainerMixin {
    */
   inline T& front()
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this).front());
   }
 
@@ -192,6 +226,7 @@ struct ContiguousContainerMixin {
    */
   inline T& back()
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this).back());
   }
 
@@ -202,6 +237,7 @@ struct ContiguousContainerMixin {
    */
   iterator begin()
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<iterator>(const_cast<const TDerived&>(static_cast<TDerived&>(*this)).begin()); // TODO cleaner?
   }
 
@@ -218,6 +254,7 @@ struct ContiguousContainerMixin {
    */
   iterator end()
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<iterator>(const_cast<const TDerived&>(static_cast<TDerived&>(*this)).end()); // TODO cleaner?
   }
 
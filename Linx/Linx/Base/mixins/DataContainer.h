@@ -98,6 +98,7 @@ public:
    */
   T& at(Index i)
   {
+    Internal::detach(static_cast<TDerived&>(*this));
     return const_cast<T&>(const_cast<const DataContainer&>(*this).at(i));
   }
 
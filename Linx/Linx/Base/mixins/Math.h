@@ -5,7 +5,10 @@
 #ifndef _LINXBASE_MIXINS_MATH_H
 #define _LINXBASE_MIXINS_MATH_H
 
+#include "Linx/Base/FastMath.h"
 #include "Linx/Base/SeqUtils.h" // IsRange
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/impl/Reduction.h"
 
 #include <algorithm>
 #include <cmath>
@@ -140,6 +143,49 @@ struct MathFunctionsMixin {
   LINX_MATH_UNARY_INPLACE(tgamma)
   LINX_MATH_UNARY_INPLACE(lgamma)
 
+  /**
+   * @brief Apply `Linx::fast_exp()`, which vectorizes over contiguous data.
+   */
+  TDerived& fast_exp()
+  {
+    auto* derived = static_cast<TDerived*>(this);
+    std::transform(derived->begin(), derived->end(), derived->begin(), [](auto e) {
+      return Linx::fast_exp(e);
+    });
+    return *derived;
+  }
+
+  /**
+   * @brief Apply `Linx::fast_log()`, which vectorizes over contiguous data.
+   */
+  TDerived& fast_log()
+  {
+    auto* derived = static_cast<TDerived*>(this);
+    std::transform(derived->begin(), derived->end(), derived->begin(), [](auto e) {
+      return Linx::fast_log(e);
+    });
+    return *derived;
+  }
+
+  /**
+   * @brief Apply `Linx::fast_pow()`, which vectorizes over contiguous data.
+   */
+  template <typename U>
+  TDerived& fast_pow(const U& other)
+  {
+    auto* derived = static_cast<TDerived*>(this);
+    if constexpr (IsRange<U>::value) {
+      std::transform(derived->begin(), derived->end(), other.begin(), derived->begin(), [](auto e, auto f) {
+        return Linx::fast_pow(e, decltype(e)(f));
+      });
+    } else {
+      std::transform(derived->begin(), derived->end(), derived->begin(), [=](auto e) {
+        return Linx::fast_pow(e, decltype(e)(other));
+      });
+    }
+    return *derived;
+  }
+
 #undef LINX_MATH_UNARY_INPLACE
 #undef LINX_MATH_BINARY_INPLACE
 };
@@ -210,6 +256,64 @@ LINX_MATH_UNARY_NEWINSTANCE(lgamma)
 #undef LINX_MATH_UNARY_NEWINSTANCE
 #undef LINX_MATH_BINARY_NEWINSTANCE
 
+/**
+ * @relatesalso MathFunctionsMixin
+ * @brief Apply `fast_exp()` (new instance).
+ */
+template <typename T, typename TDerived>
+TDerived fast_exp(const MathFunctionsMixin<T, TDerived>& in)
+{
+  TDerived out(static_cast<const TDerived&>(in));
+  out.fast_exp();
+  return out;
+}
+
+/**
+ * @relatesalso MathFunctionsMixin
+ * @brief Apply `fast_log()` (new instance).
+ */
+template <typename T, typename TDerived>
+TDerived fast_log(const MathFunctionsMixin<T, TDerived>& in)
+{
+  TDerived out(static_cast<const TDerived&>(in));
+  out.fast_log();
+  return out;
+}
+
+/**
+ * @relatesalso MathFunctionsMixin
+ * @brief Apply `fast_pow()` (new instance).
+ */
+template <typename T, typename TDerived, typename TOther>
+TDerived fast_pow(const MathFunctionsMixin<T, TDerived>& in, const TOther& other)
+{
+  TDerived out(static_cast<const TDerived&>(in));
+  out.fast_pow(other);
+  return out;
+}
+
+/**
+ * @brief Compute the Lp-norm of a vector raised to the power p, in parallel.
+ * @tparam P The power
+ * @param threads The threads
+ * 
+ * Contiguous containers are reduced with pairwise summation, block-wise,
+ * where the block length does not depend on the number of threads,
+ * such that the result is reproducible, and the same as that of `norm<P>(in)`.
+ */
+template <Index P, typename T, typename TDerived>
+T norm(const MathFunctionsMixin<T, TDerived>& in, Threads threads)
+{
+  const auto& derived = static_cast<const TDerived&>(in);
+  return Internal::range_sum<T>(
+      [](const T& e) {
+        return abspow<P>(e);
+      },
+      threads,
+      derived.begin(),
+      derived.end());
+}
+
 /**
  * @brief Compute the Lp-norm of a vector raised to the power p.
  * @tparam P The power
@@ -217,11 +321,27 @@ LINX_MATH_UNARY_NEWINSTANCE(lgamma)
 template <Index P, typename T, typename TDerived>
 T norm(const MathFunctionsMixin<T, TDerived>& in)
 {
-  T out(0);
-  for (const auto& e : static_cast<const TDerived&>(in)) {
-    out += abspow<P>(e);
-  }
-  return out;
+  return norm<P>(in, Threads(1));
+}
+
+/**
+ * @brief Compute the absolute Lp-distance between two vectors raised to the power p, in parallel.
+ * @tparam P The power
+ * @param threads The threads
+ * @see `norm(const MathFunctionsMixin<T, TDerived>&, Threads)`
+ */
+template <Index P, typename T, typename TDerived, typename U, typename UDerived>
+T distance(const MathFunctionsMixin<T, TDerived>& lhs, const MathFunctionsMixin<U, UDerived>& rhs, Threads threads)
+{
+  const auto& derived = static_cast<const TDerived&>(lhs);
+  return Internal::range_sum<T>(
+      [](T a, T b) {
+        return abspow<P>(b - a);
+      },
+      threads,
+      derived.begin(),
+      derived.end(),
+      static_cast<const UDerived&>(rhs).begin());
 }
 
 /**
@@ -231,15 +351,35 @@ T norm(const MathFunctionsMixin<T, TDerived>& in)
 template <Index P, typename T, typename TDerived, typename U, typename UDerived>
 T distance(const MathFunctionsMixin<T, TDerived>& lhs, const MathFunctionsMixin<U, UDerived>& rhs)
 {
-  return std::inner_product(
-      static_cast<const TDerived&>(lhs).begin(),
-      static_cast<const TDerived&>(lhs).end(),
-      static_cast<const UDerived&>(rhs).begin(),
-      0.,
-      std::plus<T> {},
+  return distance<P>(lhs, rhs, Threads(1));
+}
+
+/**
+ * @brief Compute the dot product of two vectors, in parallel.
+ * @param threads The threads
+ * @see `norm(const MathFunctionsMixin<T, TDerived>&, Threads)`
+ */
+template <typename T, typename TDerived, typename U, typename UDerived>
+T dot(const MathFunctionsMixin<T, TDerived>& lhs, const MathFunctionsMixin<U, UDerived>& rhs, Threads threads)
+{
+  const auto& derived = static_cast<const TDerived&>(lhs);
+  return Internal::range_sum<T>(
       [](T a, T b) {
-        return abspow<P>(b - a);
-      });
+        return a * b;
+      },
+      threads,
+      derived.begin(),
+      derived.end(),
+      static_cast<const UDerived&>(rhs).begin());
+}
+
+/**
+ * @brief Compute the dot product of two vectors.
+ */
+template <typename T, typename TDerived, typename U, typename UDerived>
+T dot(const MathFunctionsMixin<T, TDerived>& lhs, const MathFunctionsMixin<U, UDerived>& rhs)
+{
+  return dot(lhs, rhs, Threads(1));
 }
 
 } // namespace Linx
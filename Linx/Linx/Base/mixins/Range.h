@@ -6,12 +6,59 @@
 #define _LINXBASE_MIXINS_RANGE_H
 
 #include "Linx/Base/DataDistribution.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/impl/Reduction.h"
 
 #include <algorithm>
+#include <cstddef> // size_t
+#include <iterator> // next
 #include <numeric> // accumulate
+#include <tuple>
+#include <type_traits> // decay_t, false_type, is_const_v, remove_reference_t, true_type, void_t
+#include <utility> // as_const, declval
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether a function provides an indexed overload `at(std::size_t, TArgs...)`.
+ */
+template <typename TFunc, typename TArgs, typename = void>
+struct HasIndexedAt : std::false_type {};
+
+template <typename TFunc, typename... TArgs>
+struct HasIndexedAt<
+    TFunc,
+    std::tuple<TArgs...>,
+    std::void_t<decltype(std::declval<const TFunc&>().at(std::size_t(), std::declval<TArgs>()...))>> :
+    std::true_type {};
+
+/**
+ * @brief Check whether a function provides a method `skip(std::size_t)` to advance its counter.
+ */
+template <typename TFunc, typename = void>
+struct HasSkip : std::false_type {};
+
+template <typename TFunc>
+struct HasSkip<TFunc, std::void_t<decltype(std::declval<TFunc&>().skip(std::size_t()))>> : std::true_type {};
+
+/**
+ * @brief Advance the counter of a non-const counter-based function after an indexed fill, if possible.
+ */
+template <typename TFunc>
+void skip_indexed(TFunc&& func, std::size_t count)
+{
+  using Func = std::remove_reference_t<TFunc>;
+  if constexpr (not std::is_const_v<Func> && HasSkip<Func>::value) {
+    func.skip(count);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup mixins
  * @brief Base class to provide range operations.
@@ -87,14 +134,85 @@ struct RangeMixin { // FIXME merge with DataContainer
    * res.generate([](auto v) { return std::sqrt(v); }, a); // res = sqrt(a)
    * res.generate([](auto v, auto w) { return v * w; }, a, b); // res = a * b
    * \endcode
+   *
+   * If `func` provides a const method `at(std::size_t i, ...)`, it is called instead of `func(...)`
+   * with the index `i` of the element in the container.
+   * This is the case of counter-based random noise generators,
+   * whose values are then a function of the seed, counter offset and index only, and not of the call order.
+   * If `func` is non-const and provides `skip()`, its counter is then advanced by the container size,
+   * such that successive calls with the same generator produce different values, as with stateful generators.
    */
   template <typename TFunc, typename... TContainers>
   TDerived& generate(TFunc&& func, const TContainers&... args)
   {
     auto its = std::make_tuple(args.begin()...);
     auto& t = static_cast<TDerived&>(*this);
-    for (auto& v : t) {
-      v = iterator_tuple_apply(its, func);
+    if constexpr (Internal::HasIndexedAt<std::decay_t<TFunc>, std::tuple<decltype(*args.begin())...>>::value) {
+      std::size_t i = 0;
+      const auto indexed = [&](auto&&... es) {
+        return std::as_const(func).at(i, es...);
+      };
+      for (auto& v : t) {
+        v = iterator_tuple_apply(its, indexed);
+        ++i;
+      }
+      Internal::skip_indexed(std::forward<TFunc>(func), i);
+    } else {
+      for (auto& v : t) {
+        v = iterator_tuple_apply(its, func);
+      }
+    }
+    return t;
+  }
+
+  /**
+   * @brief Generate values in parallel.
+   * @param threads The number of threads
+   * @param func The generator function, which takes as many inputs as there are arguments
+   * @param args The arguments in the form of containers of compatible sizes
+   * 
+   * The container is split into as many chunks as threads, whose lengths are multiples of a cache line,
+   * such that threads do not write to the same cache lines (false sharing).
+   * As opposed to the sequential version, `func` is called concurrently, and must therefore be thread-safe,
+   * which is not the case of stateful functors like random noise generators.
+   * Counter-based noise generators, which provide indexed method `at()`, are thread-safe,
+   * and produce the same values as with the sequential version, whatever the number of threads;
+   * their counter is advanced the same way, too.
+   * \code
+   * res.generate(Threads(8), [](auto v, auto w) { return v * w; }, a, b); // res = a * b
+   * res.generate(Threads(8), GaussianNoise<float>(0, 1, seed)); // Reproducible
+   * \endcode
+   */
+  template <typename TFunc, typename... TContainers>
+  TDerived& generate(Threads threads, TFunc&& func, const TContainers&... args)
+  {
+    auto& t = static_cast<TDerived&>(*this);
+    const Index size = std::distance(t.begin(), t.end());
+    constexpr Index line = std::max<Index>(1, 64 / sizeof(T));
+    const Index count = threads.count();
+    const Index chunk = ((size + count - 1) / count + line - 1) / line * line;
+    const Index chunk_count = chunk > 0 ? (size + chunk - 1) / chunk : 0;
+#pragma omp parallel for num_threads(count) schedule(static)
+    for (Index c = 0; c < chunk_count; ++c) {
+      const auto front = c * chunk;
+      auto its = std::make_tuple(std::next(args.begin(), front)...);
+      const auto end = std::next(t.begin(), std::min(front + chunk, size));
+      if constexpr (Internal::HasIndexedAt<std::decay_t<TFunc>, std::tuple<decltype(*args.begin())...>>::value) {
+        std::size_t i = front;
+        const auto indexed = [&](auto&&... es) {
+          return std::as_const(func).at(i, es...);
+        };
+        for (auto it = std::next(t.begin(), front); it != end; ++it, ++i) {
+          *it = iterator_tuple_apply(its, indexed);
+        }
+      } else {
+        for (auto it = std::next(t.begin(), front); it != end; ++it) {
+          *it = iterator_tuple_apply(its, func);
+        }
+      }
+    }
+    if constexpr (Internal::HasIndexedAt<std::decay_t<TFunc>, std::tuple<decltype(*args.begin())...>>::value) {
+      Internal::skip_indexed(std::forward<TFunc>(func), size);
     }
     return t;
   }
@@ -120,6 +238,19 @@ struct RangeMixin { // FIXME merge with DataContainer
     return generate(std::forward<TFunc>(func), static_cast<TDerived&>(*this), args...);
   }
 
+  /**
+   * @brief Apply a function in parallel.
+   * @param threads The number of threads
+   * @param func The function, which must be thread-safe
+   * @param args The arguments in the form of containers of compatible sizes
+   * @see `generate(Threads, TFunc&&, const TContainers&...)`
+   */
+  template <typename TFunc, typename... TContainers>
+  TDerived& apply(Threads threads, TFunc&& func, const TContainers&... args)
+  {
+    return generate(threads, std::forward<TFunc>(func), static_cast<TDerived&>(*this), args...);
+  }
+
   /**
    * @brief Reverse the order of the elements.
    */
@@ -236,15 +367,95 @@ std::pair<const typename TRange::value_type&, const typename TRange::value_type&
   return {*its.first, *its.second};
 }
 
+/**
+ * @relatesalo RangeMixin
+ * @brief Get a reference to the (first) min element, in parallel.
+ * 
+ * The range is split into blocks whose length does not depend on the number of threads,
+ * such that the result is that of `min(in)`.
+ */
+template <typename TRange>
+const typename TRange::value_type& min(const TRange& in, Threads threads)
+{
+  return *Internal::range_find(
+      in.begin(),
+      in.end(),
+      [](const auto& a, const auto& b) {
+        return a < b;
+      },
+      threads);
+}
+
+/**
+ * @relatesalo RangeMixin
+ * @brief Get a reference to the (first) max element, in parallel.
+ */
+template <typename TRange>
+const typename TRange::value_type& max(const TRange& in, Threads threads)
+{
+  return *Internal::range_find(
+      in.begin(),
+      in.end(),
+      [](const auto& a, const auto& b) {
+        return b < a;
+      },
+      threads);
+}
+
+/**
+ * @relatesalo RangeMixin
+ * @brief Get a pair of references to the (first) min and (last) max elements, in parallel.
+ * 
+ * Like `minmax()`, this follows the convention of `std::minmax_element()`, which returns the last max element.
+ */
+template <typename TRange>
+std::pair<const typename TRange::value_type&, const typename TRange::value_type&>
+minmax(const TRange& in, Threads threads)
+{
+  return {min(in, threads), *Internal::range_find(
+                                in.begin(),
+                                in.end(),
+                                [](const auto& a, const auto& b) {
+                                  return not(a < b);
+                                },
+                                threads)};
+}
+
+/**
+ * @relatesalo RangeMixin
+ * @brief Compute the sum of a range, in parallel.
+ * @param threads The threads
+ * @param offset An offset
+ * 
+ * Contiguous ranges are summed with pairwise summation, block-wise,
+ * where the block length does not depend on the number of threads,
+ * such that the result is reproducible, and the same as that of `sum(in, offset)`.
+ */
+template <typename TRange>
+double sum(const TRange& in, Threads threads, double offset = 0)
+{
+  return offset +
+      Internal::range_sum<double>(
+             [](const auto& e) {
+               return e;
+             },
+             threads,
+             in.begin(),
+             in.end());
+}
+
 /**
  * @relatesalo RangeMixin
  * @brief Compute the sum of a range.
  * @param offset An offset
+ * 
+ * Contiguous ranges are summed with pairwise summation.
+ * @see `sum(const TRange&, Threads, double)`
  */
 template <typename TRange>
 double sum(const TRange& in, double offset = 0)
 {
-  return std::accumulate(in.begin(), in.end(), offset);
+  return sum(in, Threads(1), offset);
 }
 
 /**
@@ -269,6 +480,16 @@ double mean(const TRange& in)
   return sum(in) / in.size();
 }
 
+/**
+ * @relatesalo RangeMixin
+ * @brief Compute the mean of a range, in parallel.
+ */
+template <typename TRange>
+double mean(const TRange& in, Threads threads)
+{
+  return sum(in, threads) / in.size();
+}
+
 /**
  * @relatesalo RangeMixin
  * @brief Create a `DataDistribution` from the container.
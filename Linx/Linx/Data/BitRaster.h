@@ -0,0 +1,475 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BITRASTER_H
+#define _LINXDATA_BITRASTER_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <bitset> // count
+#include <cstdint>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Bit-packed boolean raster, e.g. for masks.
+ * @tparam N The dimension
+ *
+ * Each pixel is stored as a single bit, such that masks are 8 times lighter than `Raster<char>` or `Raster<bool>`.
+ * Rows (along axis 0) are packed into 64-bit words, bit `x % 64` of word `x / 64` holding pixel `x`,
+ * and each row starts with a new word.
+ * Padding bits are always zero.
+ *
+ * Logical operators (`&`, `|`, `^`, `~`) and counting work word-wise, i.e. on 64 pixels at once.
+ * Dilation and erosion by a box of given radius (the Chebyshev ball) are computed separably,
+ * with bit shifts along axis 0 and word-wise operations on neighboring rows along the other axes.
+ *
+ * \code
+ * BitRaster<2> bad(frame.shape());
+ * ... // Flag pixels with set()
+ * BitRaster<2> mask(cosmics); // From a Raster<char>
+ * mask |= bad;
+ * mask.dilate(1);
+ * const auto count = mask.count();
+ * \endcode
+ */
+template <Index N = 2>
+class BitRaster {
+public:
+
+  static_assert(N > 0, "BitRaster does not support variable dimension.");
+
+  /**
+   * @brief The storage word type.
+   */
+  using Word = std::uint64_t;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The number of pixels per word.
+   */
+  static constexpr Index WordLength = 64;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param value The initial value of the pixels
+   */
+  explicit BitRaster(Position<N> shape = Position<N>::zero(), bool value = false) :
+      m_shape(LINX_MOVE(shape)), m_row_words((m_shape[0] + WordLength - 1) / WordLength),
+      m_rows(m_shape[0] ? shape_size(m_shape) / m_shape[0] : 0), m_data(m_row_words * m_rows)
+  {
+    fill(value);
+  }
+
+  /**
+   * @brief Conversion constructor from a raster, where non-zero values are true.
+   */
+  template <typename T, typename THolder>
+  explicit BitRaster(const Raster<T, N, THolder>& raster) : BitRaster(raster.shape())
+  {
+    auto it = raster.begin();
+    for (Index r = 0; r < m_rows; ++r) {
+      auto* row = m_data.data() + r * m_row_words;
+      for (Index x = 0; x < m_shape[0]; ++x, ++it) {
+        row[x / WordLength] |= Word(*it != T()) << (x % WordLength);
+      }
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(m_shape);
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index size() const
+  {
+    return m_shape[0] * m_rows;
+  }
+
+  /**
+   * @brief Get the number of words per row.
+   */
+  Index row_words() const
+  {
+    return m_row_words;
+  }
+
+  /**
+   * @brief Get a pointer to the packed data.
+   */
+  const Word* data() const
+  {
+    return m_data.data();
+  }
+
+  /**
+   * @brief Check whether two rasters have the same shape and values.
+   */
+  bool operator==(const BitRaster& other) const
+  {
+    return m_shape == other.m_shape && m_data == other.m_data;
+  }
+
+  /**
+   * @brief Check whether two rasters have different shapes or values.
+   */
+  bool operator!=(const BitRaster& other) const
+  {
+    return not(*this == other);
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the value at given position.
+   */
+  inline bool operator[](const Position<N>& pos) const
+  {
+    return (m_data[word_index(pos)] >> (pos[0] % WordLength)) & 1;
+  }
+
+  /**
+   * @brief Set the value at given position.
+   */
+  inline void set(const Position<N>& pos, bool value = true)
+  {
+    const auto bit = Word(1) << (pos[0] % WordLength);
+    auto& word = m_data[word_index(pos)];
+    word = value ? word | bit : word & ~bit;
+  }
+
+  /**
+   * @brief Count the true pixels.
+   */
+  Index count() const
+  {
+    Index out = 0;
+    for (auto w : m_data) {
+      out += std::bitset<WordLength>(w).count();
+    }
+    return out;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Set all the pixels to a given value.
+   */
+  BitRaster& fill(bool value)
+  {
+    std::fill(m_data.begin(), m_data.end(), value ? ~Word(0) : Word(0));
+    return value ? clear_padding() : *this;
+  }
+
+  /**
+   * @brief Negate the pixels in place.
+   */
+  BitRaster& flip()
+  {
+    for (auto& w : m_data) {
+      w = ~w;
+    }
+    return clear_padding();
+  }
+
+  /**
+   * @brief Logical and.
+   */
+  BitRaster& operator&=(const BitRaster& rhs)
+  {
+    return apply(rhs, [](Word a, Word b) {
+      return a & b;
+    });
+  }
+
+  /**
+   * @brief Logical or.
+   */
+  BitRaster& operator|=(const BitRaster& rhs)
+  {
+    return apply(rhs, [](Word a, Word b) {
+      return a | b;
+    });
+  }
+
+  /**
+   * @brief Logical exclusive or.
+   */
+  BitRaster& operator^=(const BitRaster& rhs)
+  {
+    return apply(rhs, [](Word a, Word b) {
+      return a ^ b;
+    });
+  }
+
+  /**
+   * @brief Dilate in place by a box of given radius.
+   *
+   * Out-of-domain pixels are considered false.
+   */
+  BitRaster& dilate(Index radius = 1)
+  {
+    if (radius <= 0 || size() == 0) {
+      return *this;
+    }
+    dilate_rows(radius);
+    Index stride = 1;
+    for (Index i = 1; i < N; ++i) {
+      dilate_axis(i, stride, radius);
+      stride *= m_shape[i];
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Erode in place by a box of given radius.
+   *
+   * Out-of-domain pixels are considered true, such that borders are not eroded by the domain boundary.
+   */
+  BitRaster& erode(Index radius = 1)
+  {
+    return flip().dilate(radius).flip();
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Copy the values into a raster of the same shape, as zeros and ones.
+   */
+  template <typename T, typename THolder>
+  Raster<T, N, THolder>& copy_to(Raster<T, N, THolder>& raster) const
+  {
+    if (raster.shape() != m_shape) {
+      throw SizeError(shape_size(raster.shape()), shape_size(m_shape));
+    }
+    auto it = raster.begin();
+    for (Index r = 0; r < m_rows; ++r) {
+      const auto* row = m_data.data() + r * m_row_words;
+      for (Index x = 0; x < m_shape[0]; ++x, ++it) {
+        *it = T((row[x / WordLength] >> (x % WordLength)) & 1);
+      }
+    }
+    return raster;
+  }
+
+  /**
+   * @brief Copy the values into a new raster, as zeros and ones.
+   */
+  template <typename T = char>
+  Raster<T, N> raster() const
+  {
+    Raster<T, N> out(m_shape);
+    copy_to(out);
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Compute the index of the word which contains a given position.
+   */
+  inline Index word_index(const Position<N>& pos) const
+  {
+    Index row = 0;
+    for (Index i = N - 1; i > 0; --i) {
+      row = row * m_shape[i] + pos[i];
+    }
+    return row * m_row_words + pos[0] / WordLength;
+  }
+
+  /**
+   * @brief Reset the padding bits of each row.
+   */
+  BitRaster& clear_padding()
+  {
+    const auto tail = m_shape[0] % WordLength;
+    if (tail == 0) {
+      return *this;
+    }
+    const auto mask = (Word(1) << tail) - 1;
+    for (Index r = 0; r < m_rows; ++r) {
+      m_data[(r + 1) * m_row_words - 1] &= mask;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Apply a word-wise binary operator.
+   */
+  template <typename TFunc>
+  BitRaster& apply(const BitRaster& rhs, TFunc&& func)
+  {
+    if (rhs.m_shape != m_shape) {
+      throw SizeError(shape_size(rhs.m_shape), shape_size(m_shape));
+    }
+    const auto* in = rhs.m_data.data();
+    for (auto& w : m_data) {
+      w = func(w, *in);
+      ++in;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Dilate along axis 0 by shifting the rows.
+   */
+  void dilate_rows(Index radius)
+  {
+    const auto n = m_row_words;
+    std::vector<Word> in(n);
+    for (Index r = 0; r < m_rows; ++r) {
+      auto* row = m_data.data() + r * n;
+      std::copy_n(row, n, in.data());
+      for (Index k = 1; k <= radius && k < m_shape[0]; ++k) {
+        const auto q = k / WordLength;
+        const auto b = k % WordLength;
+        for (Index w = 0; w < n; ++w) {
+          // Pixel x - k to x, and x + k to x
+          const auto up = w - q;
+          const auto down = w + q;
+          Word out = 0;
+          if (up >= 0) {
+            out |= in[up] << b;
+            if (b && up > 0) {
+              out |= in[up - 1] >> (WordLength - b);
+            }
+          }
+          if (down < n) {
+            out |= in[down] >> b;
+            if (b && down + 1 < n) {
+              out |= in[down + 1] << (WordLength - b);
+            }
+          }
+          row[w] |= out;
+        }
+      }
+    }
+    clear_padding();
+  }
+
+  /**
+   * @brief Dilate along an axis other than 0 by or-ing neighboring rows.
+   * @param axis The axis index
+   * @param stride The distance between two neighboring rows along the axis, in rows
+   * @param radius The radius
+   */
+  void dilate_axis(Index axis, Index stride, Index radius)
+  {
+    const auto n = m_row_words;
+    const auto length = m_shape[axis];
+    const auto in = m_data;
+    for (Index r = 0; r < m_rows; ++r) {
+      const auto c = (r / stride) % length;
+      const auto front = std::max<Index>(0, c - radius) - c;
+      const auto back = std::min(length - 1, c + radius) - c;
+      auto* out = m_data.data() + r * n;
+      for (Index k = front; k <= back; ++k) {
+        if (k == 0) {
+          continue;
+        }
+        const auto* neighbor = in.data() + (r + k * stride) * n;
+        for (Index w = 0; w < n; ++w) {
+          out[w] |= neighbor[w];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The number of words per row.
+   */
+  Index m_row_words;
+
+  /**
+   * @brief The number of rows.
+   */
+  Index m_rows;
+
+  /**
+   * @brief The packed data.
+   */
+  std::vector<Word> m_data;
+};
+
+/**
+ * @relatesalso BitRaster
+ * @brief Logical and.
+ */
+template <Index N>
+BitRaster<N> operator&(BitRaster<N> lhs, const BitRaster<N>& rhs)
+{
+  lhs &= rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso BitRaster
+ * @brief Logical or.
+ */
+template <Index N>
+BitRaster<N> operator|(BitRaster<N> lhs, const BitRaster<N>& rhs)
+{
+  lhs |= rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso BitRaster
+ * @brief Logical exclusive or.
+ */
+template <Index N>
+BitRaster<N> operator^(BitRaster<N> lhs, const BitRaster<N>& rhs)
+{
+  lhs ^= rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso BitRaster
+ * @brief Logical not.
+ */
+template <Index N>
+BitRaster<N> operator~(BitRaster<N> in)
+{
+  in.flip();
+  return in;
+}
+
+} // namespace Linx
+
+#endif
@@ -8,6 +8,7 @@
 #include "Linx/Data/mixins/Region.h"
 
 #include <boost/operators.hpp>
+#include <vector>
 
 namespace Linx {
 
@@ -15,7 +16,43 @@ namespace Linx {
 namespace Internal {
 template <Index N>
 class BorderedBox; // for friendness // FIXME rm?
+
+/**
+ * @brief Compute the bounds of at most `n` balanced, non-empty parts of a range of given length.
+ * @return The `parts + 1` bounds, from 0 to `length`
+ */
+inline std::vector<Index> balanced_bounds(Index length, Index n)
+{
+  const auto parts = std::max(Index(0), std::min(length, n));
+  std::vector<Index> out(parts + 1, length);
+  for (Index k = 0; k < parts; ++k) {
+    out[k] = k * length / parts;
+  }
+  return out;
 }
+
+/**
+ * @brief Select the axis along which a region should be split into `n` parts.
+ * 
+ * The last axis which is long enough is preferred, such that parts are contiguous in memory as much as possible;
+ * otherwise the longest axis is selected.
+ */
+template <typename TRegion>
+Index split_axis(const TRegion& region, Index n)
+{
+  Index longest = 0;
+  for (Index i = region.dimension() - 1; i >= 0; --i) {
+    if (region.length(i) >= n) {
+      return i;
+    }
+    if (region.length(i) > region.length(longest)) {
+      longest = i;
+    }
+  }
+  return longest;
+}
+
+} // namespace Internal
 /// @endcond
 
 /**
@@ -202,6 +239,34 @@ public:
     return true;
   }
 
+  /**
+   * @brief Apply a function to each row, i.e. each run of consecutive positions along axis 0.
+   * @param func The function, called as `func(front, length)`
+   * 
+   * This is faster than iterating over the positions when the inner loop can work on indices:
+   * 
+   * \code
+   * box.for_each_row([&](const auto& front, Index length) {
+   *   auto* data = &raster[front];
+   *   for (Index i = 0; i < length; ++i) {
+   *     data[i] *= 2;
+   *   }
+   * });
+   * \endcode
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func) const
+  {
+    if (size() <= 0) {
+      return;
+    }
+    const auto length = this->length(0);
+    auto plane = *this;
+    for (const auto& front : plane.project()) {
+      func(front, length);
+    }
+  }
+
   /// @group_modifiers
 
   /**
@@ -473,6 +538,65 @@ Box<Dimensional<N>::OneMoreDimension> insert(const Box<N>& in, Index front, Inde
   return {insert<I>(in.front(), front), insert<I>(in.back(), back)};
 }
 
+/**
+ * @relatesalso Box
+ * @brief Split a box into balanced slabs along a given axis.
+ * @param in The input box
+ * @param axis The index of the axis
+ * @param n The maximum number of slabs
+ * 
+ * The slab lengths along the axis differ by at most one, and no slab is empty,
+ * such that fewer than `n` slabs are returned if the box is too short.
+ */
+template <Index N>
+std::vector<Box<N>> split_along(const Box<N>& in, Index axis, Index n)
+{
+  const auto bounds = Internal::balanced_bounds(in.length(axis), n);
+  std::vector<Box<N>> out;
+  out.reserve(bounds.size() - 1);
+  auto front = in.front();
+  auto back = in.back();
+  for (std::size_t k = 0; k + 1 < bounds.size(); ++k) {
+    front[axis] = in.front()[axis] + bounds[k];
+    back[axis] = in.front()[axis] + bounds[k + 1] - 1;
+    out.emplace_back(front, back);
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Box
+ * @brief Split a box into balanced slabs along the `I`-th axis.
+ */
+template <Index I, Index N>
+std::vector<Box<N>> split_along(const Box<N>& in, Index n)
+{
+  return split_along(in, I, n);
+}
+
+/**
+ * @relatesalso Box
+ * @brief Split a box into balanced parts, e.g. to distribute work among threads.
+ * 
+ * The box is split along the last axis if it is long enough, such that each part is cache-friendly;
+ * otherwise along its longest axis.
+ * 
+ * \code
+ * const auto parts = split(in.domain(), threads.count());
+ * #pragma omp parallel for
+ * for (std::size_t k = 0; k < parts.size(); ++k) {
+ *   ... // Process parts[k]
+ * }
+ * \endcode
+ * 
+ * @see `split_along()`
+ */
+template <Index N>
+std::vector<Box<N>> split(const Box<N>& in, Index n)
+{
+  return split_along(in, Internal::split_axis(in, n), n);
+}
+
 /**
  * @relatesalso Box
  * @brief Clamp a position inside a box.
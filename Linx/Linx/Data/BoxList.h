@@ -0,0 +1,444 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BOXLIST_H
+#define _LINXDATA_BOXLIST_H
+
+#include "Linx/Base/SeqUtils.h" // IsRange
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, equal, max, min, remove_if, sort
+#include <functional> // less_equal
+#include <numeric> // iota
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief A list of boxes, stored as contiguous arrays of coordinates, for batched box operations.
+ * @tparam N The dimension
+ *
+ * The fronts and backs of the boxes are stored in two flat arrays, instead of one `Box` object per box,
+ * such that operations which are applied to all the boxes, like intersection with a domain or translation,
+ * are simple loops over contiguous integers.
+ * This is typically useful to plan cutouts: stamps are first placed as boxes, then clamped inside the domain,
+ * and overlapping stamps may be merged or the number of stamps covering each pixel may be computed.
+ *
+ * \code
+ * BoxList<2> stamps;
+ * for (const auto& p : catalog) {
+ *   stamps.push_back(Box<2>::from_center(radius, p));
+ * }
+ * stamps &= image.domain();
+ * stamps.erase_empty();
+ * const auto cutouts = stamps.merge();
+ * \endcode
+ */
+template <Index N = 2>
+class BoxList {
+public:
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Create an empty list of boxes of given dimension.
+   */
+  explicit BoxList(Index dimension = std::abs(N)) : m_dimension(dimension), m_fronts(), m_backs() {}
+
+  /**
+   * @brief Create a list from a range of boxes.
+   */
+  template <typename TRange, typename std::enable_if_t<IsRange<TRange>::value>* = nullptr>
+  explicit BoxList(const TRange& boxes) : BoxList()
+  {
+    for (const auto& b : boxes) {
+      push_back(b);
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of boxes.
+   */
+  Index size() const
+  {
+    return m_dimension == 0 ? 0 : Index(m_fronts.size()) / m_dimension;
+  }
+
+  /**
+   * @brief Get the dimension of the boxes.
+   */
+  Index dimension() const
+  {
+    return m_dimension;
+  }
+
+  /**
+   * @brief Get the `i`-th box.
+   */
+  Box<N> operator[](Index i) const
+  {
+    const auto* f = &m_fronts[i * m_dimension];
+    const auto* b = &m_backs[i * m_dimension];
+    Position<N> front(m_dimension);
+    Position<N> back(m_dimension);
+    std::copy(f, f + m_dimension, front.begin());
+    std::copy(b, b + m_dimension, back.begin());
+    return {LINX_MOVE(front), LINX_MOVE(back)};
+  }
+
+  /**
+   * @brief Check whether the `i`-th box is empty, i.e. has a negative length along some axis.
+   */
+  bool is_empty(Index i) const
+  {
+    const auto* f = &m_fronts[i * m_dimension];
+    const auto* b = &m_backs[i * m_dimension];
+    for (Index a = 0; a < m_dimension; ++a) {
+      if (b[a] < f[a]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Get the number of pixels of each box, where empty boxes have size 0.
+   */
+  std::vector<Index> sizes() const
+  {
+    std::vector<Index> out(size());
+    for (Index i = 0; i < size(); ++i) {
+      const auto* f = &m_fronts[i * m_dimension];
+      const auto* b = &m_backs[i * m_dimension];
+      Index s = 1;
+      for (Index a = 0; a < m_dimension; ++a) {
+        s *= std::max(Index(0), b[a] - f[a] + 1);
+      }
+      out[i] = s;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Copy the boxes into a vector of `Box`.
+   */
+  std::vector<Box<N>> boxes() const
+  {
+    std::vector<Box<N>> out;
+    out.reserve(size());
+    for (Index i = 0; i < size(); ++i) {
+      out.push_back((*this)[i]);
+    }
+    return out;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Append a box.
+   */
+  void push_back(const Box<N>& box)
+  {
+    if (size() == 0) {
+      m_dimension = box.dimension();
+    }
+    m_fronts.insert(m_fronts.end(), box.front().begin(), box.front().end());
+    m_backs.insert(m_backs.end(), box.back().begin(), box.back().end());
+  }
+
+  /**
+   * @brief Remove the empty boxes, preserving the order of the others.
+   */
+  BoxList& erase_empty()
+  {
+    Index j = 0;
+    for (Index i = 0; i < size(); ++i) {
+      if (is_empty(i)) {
+        continue;
+      }
+      if (i != j) {
+        std::copy_n(&m_fronts[i * m_dimension], m_dimension, &m_fronts[j * m_dimension]);
+        std::copy_n(&m_backs[i * m_dimension], m_dimension, &m_backs[j * m_dimension]);
+      }
+      ++j;
+    }
+    m_fronts.resize(j * m_dimension);
+    m_backs.resize(j * m_dimension);
+    return *this;
+  }
+
+  /**
+   * @brief Intersect each box with a given box, e.g. clamp the boxes inside a raster domain.
+   *
+   * Boxes which do not intersect the given box become empty.
+   */
+  BoxList& operator&=(const Box<N>& bounds)
+  {
+    return apply(bounds.front(), bounds.back(), [](auto& f, auto& b, auto bf, auto bb) {
+      f = std::max(f, bf);
+      b = std::min(b, bb);
+    });
+  }
+
+  /**
+   * @brief Grow each box by a given margin.
+   */
+  template <Index M>
+  BoxList& operator+=(const Box<M>& margin)
+  {
+    return apply(extend<N>(margin.front()), extend<N>(margin.back()), [](auto& f, auto& b, auto mf, auto mb) {
+      f += mf;
+      b += mb;
+    });
+  }
+
+  /**
+   * @brief Shrink each box by a given margin.
+   */
+  template <Index M>
+  BoxList& operator-=(const Box<M>& margin)
+  {
+    return apply(extend<N>(margin.front()), extend<N>(margin.back()), [](auto& f, auto& b, auto mf, auto mb) {
+      f -= mf;
+      b -= mb;
+    });
+  }
+
+  /**
+   * @brief Translate each box by a given vector.
+   */
+  template <Index M>
+  BoxList& operator+=(const Position<M>& vector)
+  {
+    const auto v = extend<N>(vector);
+    return apply(v, v, [](auto& f, auto& b, auto vf, auto vb) {
+      f += vf;
+      b += vb;
+    });
+  }
+
+  /**
+   * @brief Translate each box by the opposite of a given vector.
+   */
+  template <Index M>
+  BoxList& operator-=(const Position<M>& vector)
+  {
+    const auto v = extend<N>(vector);
+    return apply(v, v, [](auto& f, auto& b, auto vf, auto vb) {
+      f -= vf;
+      b -= vb;
+    });
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Merge the overlapping boxes.
+   *
+   * Each group of (transitively) overlapping boxes is replaced with its bounding box,
+   * until no two boxes overlap, such that the output boxes are disjoint.
+   * Empty boxes are ignored.
+   *
+   * Overlaps are searched with a sweep along axis 0, such that only the boxes whose extents along axis 0 overlap
+   * are compared, instead of all the pairs.
+   */
+  BoxList merge() const
+  {
+    auto out = *this;
+    out.erase_empty();
+    while (true) {
+      const auto count = out.size();
+      auto merged = out.merge_once();
+      if (merged.size() == count) {
+        return merged;
+      }
+      out = LINX_MOVE(merged);
+    }
+  }
+
+  /**
+   * @brief Count the boxes which cover each pixel of a domain.
+   * @param domain The domain
+   * @return The coverage map, indexed relative to the domain front
+   *
+   * The coverage is computed in a single pass over the pixels, whatever the number and size of the boxes:
+   * each box only increments or decrements the `2^N` corners of a difference map,
+   * which is finally integrated along each axis.
+   * Positions covered by no box have coverage 0.
+   */
+  Raster<Index, N> coverage(const Box<N>& domain) const
+  {
+    const auto shape = domain.shape();
+    Raster<Index, N> out(shape);
+    out.fill(0);
+    const auto& origin = domain.front();
+    Position<N> q(m_dimension);
+    for (Index i = 0; i < size(); ++i) {
+      const auto box = (*this)[i] & domain;
+      const auto front = box.front() - origin;
+      const auto back = box.back() - origin;
+      if (not std::equal(front.begin(), front.end(), back.begin(), std::less_equal<Index>())) {
+        continue;
+      }
+      for (Index corner = 0; corner < (Index(1) << m_dimension); ++corner) {
+        bool outside = false;
+        Index sign = 1;
+        for (Index a = 0; a < m_dimension; ++a) {
+          if ((corner >> a) & 1) {
+            q[a] = back[a] + 1;
+            sign = -sign;
+            outside |= q[a] >= shape[a];
+          } else {
+            q[a] = front[a];
+          }
+        }
+        if (not outside) {
+          out[q] += sign;
+        }
+      }
+    }
+    auto* data = out.data();
+    const Index total = out.size();
+    for (Index a = 0; a < m_dimension; ++a) {
+      const auto stride = out.strides()[a];
+      const auto length = shape[a];
+      for (Index k = 0; k < total; ++k) {
+        if ((k / stride) % length != 0) {
+          data[k] += data[k - stride];
+        }
+      }
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Apply a function to the fronts and backs of each box, coordinate by coordinate.
+   */
+  template <typename TFunc>
+  BoxList& apply(const Position<N>& front, const Position<N>& back, TFunc&& func)
+  {
+    auto* f = m_fronts.data();
+    auto* b = m_backs.data();
+    const auto count = size();
+    for (Index i = 0; i < count; ++i, f += m_dimension, b += m_dimension) {
+      for (Index a = 0; a < m_dimension; ++a) {
+        func(f[a], b[a], front[a], back[a]);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Check whether two boxes overlap.
+   */
+  bool overlap(Index i, Index j) const
+  {
+    const auto* fi = &m_fronts[i * m_dimension];
+    const auto* bi = &m_backs[i * m_dimension];
+    const auto* fj = &m_fronts[j * m_dimension];
+    const auto* bj = &m_backs[j * m_dimension];
+    for (Index a = 0; a < m_dimension; ++a) {
+      if (bi[a] < fj[a] || bj[a] < fi[a]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Replace each group of overlapping boxes with its bounding box, once.
+   */
+  BoxList merge_once() const
+  {
+    const auto count = size();
+    std::vector<Index> order(count);
+    std::iota(order.begin(), order.end(), Index(0));
+    std::sort(order.begin(), order.end(), [&](auto i, auto j) {
+      return m_fronts[i * m_dimension] < m_fronts[j * m_dimension];
+    });
+
+    // Union-find with a sweep along axis 0
+    std::vector<Index> parents(count);
+    std::iota(parents.begin(), parents.end(), Index(0));
+    const auto find = [&](Index i) {
+      while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+      }
+      return i;
+    };
+    std::vector<Index> active;
+    for (auto i : order) {
+      const auto front = m_fronts[i * m_dimension];
+      active.erase(
+          std::remove_if(
+              active.begin(),
+              active.end(),
+              [&](auto j) {
+                return m_backs[j * m_dimension] < front;
+              }),
+          active.end());
+      for (auto j : active) {
+        if (overlap(i, j)) {
+          const auto ri = find(i);
+          const auto rj = find(j);
+          parents[std::max(ri, rj)] = std::min(ri, rj);
+        }
+      }
+      active.push_back(i);
+    }
+
+    // Bounding boxes of the groups, in order of their first box
+    BoxList out(m_dimension);
+    std::vector<Index> groups(count, -1);
+    for (Index i = 0; i < count; ++i) {
+      const auto root = find(i);
+      if (groups[root] < 0) {
+        groups[root] = out.size();
+        out.push_back((*this)[i]);
+        continue;
+      }
+      auto* f = &out.m_fronts[groups[root] * m_dimension];
+      auto* b = &out.m_backs[groups[root] * m_dimension];
+      for (Index a = 0; a < m_dimension; ++a) {
+        f[a] = std::min(f[a], m_fronts[i * m_dimension + a]);
+        b[a] = std::max(b[a], m_backs[i * m_dimension + a]);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief The dimension.
+   */
+  Index m_dimension;
+
+  /**
+   * @brief The front coordinates, box by box.
+   */
+  std::vector<Index> m_fronts;
+
+  /**
+   * @brief The back coordinates, box by box.
+   */
+  std::vector<Index> m_backs;
+};
+
+} // namespace Linx
+
+#endif
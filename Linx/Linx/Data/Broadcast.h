@@ -0,0 +1,356 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BROADCAST_H
+#define _LINXDATA_BROADCAST_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup pixelwise
+ * @brief Virtual extension of a raster to a larger shape, without copy.
+ * @tparam TRaster The raster type
+ * @tparam N The broadcast dimension
+ * 
+ * The rules are those of NumPy, with Linx axis ordering (axis 0 is the fastest-varying):
+ * the axes of the raster are aligned with the first axes of the broadcast shape,
+ * and each of them must either have the same length or be a singleton;
+ * singleton axes and missing trailing axes are virtually repeated.
+ * For example, a `Raster<float, 1>` of length `width` is broadcast to all the rows of a `{width, height}` frame,
+ * while a `Raster<float>` of shape `{1, height}` is broadcast to all the columns.
+ * 
+ * Broadcasts are constant random-access views, and input ranges, such that they can be used in lazy expressions.
+ * Like containers, they must outlive the expressions which use them.
+ * They are mostly meant as right-hand sides of in-place arithmetic operators:
+ * 
+ * \code
+ * Raster<float> frame(...);
+ * Raster<float> bias({1, frame.length(1)}); // Per-row overscan level
+ * ...
+ * frame -= broadcast(bias, frame.shape()); // No full-frame temporary
+ * \endcode
+ * 
+ * @see `broadcast()`
+ */
+template <typename TRaster, Index N>
+class Broadcast {
+public:
+
+  static_assert(N >= 0 && TRaster::Dimension >= 0, "Broadcast does not support variable dimension.");
+  static_assert(TRaster::Dimension <= N, "Broadcast cannot decrease the dimension.");
+
+  /**
+   * @brief The value type.
+   */
+  using Value = std::remove_const_t<typename TRaster::Value>;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief Iterator over the broadcast values, in the order of a raster of the broadcast shape.
+   */
+  class Iterator : public std::iterator<std::input_iterator_tag, Value> {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const Broadcast& broadcast, Index index) :
+        m_broadcast(&broadcast), m_index(index), m_position(Position<N>::zero()), m_offset(0)
+    {}
+
+    /**
+     * @brief Get the current value.
+     */
+    const Value& operator*() const
+    {
+      return m_broadcast->m_data[m_offset];
+    }
+
+    /**
+     * @brief Move to the next value.
+     */
+    Iterator& operator++()
+    {
+      ++m_index;
+      for (Index i = 0; i < N; ++i) {
+        ++m_position[i];
+        m_offset += m_broadcast->m_strides[i];
+        if (m_position[i] < m_broadcast->m_shape[i]) {
+          return *this;
+        }
+        m_offset -= m_position[i] * m_broadcast->m_strides[i];
+        m_position[i] = 0;
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same value.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_index == rhs.m_index;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different values.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_index != rhs.m_index;
+    }
+
+  private:
+
+    const Broadcast* m_broadcast;
+    Index m_index;
+    Position<N> m_position;
+    Index m_offset;
+  };
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param raster The raster
+   * @param shape The broadcast shape
+   */
+  Broadcast(const TRaster& raster, Position<N> shape) :
+      m_data(raster.data()), m_shape(LINX_MOVE(shape)), m_strides(Position<N>::zero())
+  {
+    Index stride = 1;
+    for (Index i = 0; i < TRaster::Dimension; ++i) {
+      const auto length = raster.length(i);
+      if (length != m_shape[i] && length != 1) {
+        throw Exception(
+            "Broadcast error",
+            "Cannot broadcast length " + std::to_string(length) + " to " + std::to_string(m_shape[i]) + " along axis " +
+                std::to_string(i));
+      }
+      m_strides[i] = length == 1 ? 0 : stride;
+      stride *= length;
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the broadcast shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the number of broadcast values.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the stride of each axis in the raster data, which is 0 for broadcast axes.
+   */
+  const Position<N>& strides() const
+  {
+    return m_strides;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the value at given position.
+   */
+  const Value& operator[](const Position<N>& position) const
+  {
+    Index offset = 0;
+    for (Index i = 0; i < N; ++i) {
+      offset += position[i] * m_strides[i];
+    }
+    return m_data[offset];
+  }
+
+  /**
+   * @brief Get a pointer to the raster data.
+   */
+  const Value* data() const
+  {
+    return m_data;
+  }
+
+  /// @group_iterators
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  Iterator begin() const
+  {
+    return Iterator(*this, 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  Iterator end() const
+  {
+    return Iterator(*this, size());
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The raster data.
+   */
+  const Value* m_data;
+
+  /**
+   * @brief The broadcast shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The raster strides.
+   */
+  Position<N> m_strides;
+};
+
+/**
+ * @relatesalso Broadcast
+ * @brief Broadcast a raster to a given shape.
+ */
+template <typename T, Index M, typename THolder, Index N>
+Broadcast<Raster<T, M, THolder>, N> broadcast(const Raster<T, M, THolder>& in, Position<N> shape)
+{
+  return Broadcast<Raster<T, M, THolder>, N>(in, LINX_MOVE(shape));
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Apply a binary function to each element of a raster and of a broadcast, in place.
+ * 
+ * The raster is processed row by row, such that broadcasting costs nothing in the inner loop,
+ * which vectorizes.
+ */
+template <typename T, Index N, typename THolder, typename TBroadcast, typename TFunc>
+Raster<T, N, THolder>& broadcast_apply(Raster<T, N, THolder>& lhs, const TBroadcast& rhs, TFunc&& func)
+{
+  if (lhs.shape() != rhs.shape()) {
+    throw Exception("Broadcast error", "Shape mismatch");
+  }
+  const Index width = lhs.length(0);
+  if (width == 0) {
+    return lhs;
+  }
+  const auto& strides = rhs.strides();
+  const auto* in = rhs.data();
+  auto* out = lhs.data();
+  const auto end = out + lhs.size();
+  auto position = Position<N>::zero();
+  Index offset = 0;
+  for (; out != end; out += width) {
+    if (strides[0] == 0) {
+      const auto value = in[offset];
+      for (Index i = 0; i < width; ++i) {
+        out[i] = func(out[i], value);
+      }
+    } else {
+      const auto* row = in + offset;
+      for (Index i = 0; i < width; ++i) {
+        out[i] = func(out[i], row[i]);
+      }
+    }
+    for (Index i = 1; i < N; ++i) {
+      ++position[i];
+      offset += strides[i];
+      if (position[i] < lhs.length(i)) {
+        break;
+      }
+      offset -= position[i] * strides[i];
+      position[i] = 0;
+    }
+  }
+  return lhs;
+}
+
+/**
+ * @brief Enable a function for rasters of lower fixed dimension.
+ */
+template <Index M, Index N>
+using EnableIfLowerDimension = std::enable_if_t<(M >= 0 && M < N)>;
+
+} // namespace Internal
+/// @endcond
+
+#define LINX_BROADCAST_OPERATOR(op) \
+  /** @relatesalso Broadcast @brief Broadcast in-place operator. */ \
+  template <typename T, Index N, typename THolder, typename TRaster> \
+  Raster<T, N, THolder>& operator op##=(Raster<T, N, THolder>& lhs, const Broadcast<TRaster, N>& rhs) \
+  { \
+    return Internal::broadcast_apply(lhs, rhs, [](const auto& e, const auto& f) { \
+      return e op f; \
+    }); \
+  } \
+  /** @relatesalso Broadcast @brief Broadcast in-place operator with a raster of lower dimension. */ \
+  template < \
+      typename T, \
+      Index N, \
+      typename THolder, \
+      typename U, \
+      Index M, \
+      typename UHolder, \
+      typename = Internal::EnableIfLowerDimension<M, N>> \
+  Raster<T, N, THolder>& operator op##=(Raster<T, N, THolder>& lhs, const Raster<U, M, UHolder>& rhs) \
+  { \
+    return lhs op##= broadcast(rhs, lhs.shape()); \
+  } \
+  /** @relatesalso Broadcast @brief Broadcast operator. */ \
+  template <typename T, Index N, typename THolder, typename TRaster> \
+  Raster<std::remove_const_t<T>, N> operator op(const Raster<T, N, THolder>& lhs, const Broadcast<TRaster, N>& rhs) \
+  { \
+    Raster<std::remove_const_t<T>, N> out(lhs.shape(), lhs.data()); \
+    out op##= rhs; \
+    return out; \
+  } \
+  /** @relatesalso Broadcast @brief Broadcast operator with a raster of lower dimension. */ \
+  template < \
+      typename T, \
+      Index N, \
+      typename THolder, \
+      typename U, \
+      Index M, \
+      typename UHolder, \
+      typename = Internal::EnableIfLowerDimension<M, N>> \
+  Raster<std::remove_const_t<T>, N> operator op(const Raster<T, N, THolder>& lhs, const Raster<U, M, UHolder>& rhs) \
+  { \
+    return lhs op broadcast(rhs, lhs.shape()); \
+  }
+
+LINX_BROADCAST_OPERATOR(+)
+LINX_BROADCAST_OPERATOR(-)
+LINX_BROADCAST_OPERATOR(*)
+LINX_BROADCAST_OPERATOR(/)
+
+#undef LINX_BROADCAST_OPERATOR
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,277 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_CHANNELS_H
+#define _LINXDATA_CHANNELS_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // min
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief The memory layout of a multi-channel raster.
+ */
+enum class ChannelLayout {
+  Planar, ///< Structure of arrays: each channel is a contiguous plane (channel index is the last axis)
+  Interleaved ///< Array of structures: the channels of each pixel are contiguous (channel index is axis 0)
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Multi-channel raster, e.g. of colors or spectral bands, with planar or interleaved layout.
+ * @tparam T The value type
+ * @tparam N The pixel dimension
+ * @tparam Layout The memory layout
+ * @tparam THolder The data holder
+ * 
+ * The data is stored in a `Raster<T, N + 1>`, whose channel axis is the last axis for planar layout,
+ * and axis 0 for interleaved layout.
+ * Channels and pixels are accessed as views, without copy:
+ * - `channel()` is a contiguous `PtrRaster` in planar layout, and a strided patch in interleaved layout;
+ * - `pixel()` is a strided profile in planar layout, and a contiguous profile in interleaved layout.
+ * 
+ * Per-channel processing (e.g. filtering) is best performed in planar layout,
+ * and per-pixel channel mixing (e.g. color conversion) in interleaved layout.
+ * Layouts are converted with `transpose()`, which is cache-blocked:
+ * 
+ * \code
+ * ChannelRaster<float, 2, ChannelLayout::Interleaved> rgb({640, 480}, 3);
+ * ... // Color conversion
+ * auto planes = rgb.transpose(); // Planar
+ * for (Index c = 0; c < planes.channel_count(); ++c) {
+ *   auto plane = planes.channel(c);
+ *   ... // Contiguous filtering
+ * }
+ * \endcode
+ */
+template <typename T, Index N = 2, ChannelLayout Layout = ChannelLayout::Planar, typename THolder = DefaultHolder<T>>
+class ChannelRaster {
+public:
+
+  static_assert(N > 0, "ChannelRaster does not support variable dimension.");
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The pixel dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The memory layout.
+   */
+  static constexpr ChannelLayout MemoryLayout = Layout;
+
+  /**
+   * @brief The underlying raster type.
+   */
+  using Image = Raster<T, N + 1, THolder>;
+
+  /**
+   * @brief The index of the channel axis in the underlying raster.
+   */
+  static constexpr Index ChannelAxis = Layout == ChannelLayout::Planar ? N : 0;
+
+  /**
+   * @brief The same multi-channel raster type with the other layout.
+   */
+  using Transposed = ChannelRaster<
+      T,
+      N,
+      Layout == ChannelLayout::Planar ? ChannelLayout::Interleaved : ChannelLayout::Planar,
+      DefaultHolder<T>>;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The pixel shape
+   * @param channels The number of channels
+   * @param args The arguments to be forwarded to the data holder
+   */
+  template <typename... TArgs>
+  explicit ChannelRaster(const Position<N>& shape, Index channels, TArgs&&... args) :
+      m_raster(raster_shape(shape, channels), LINX_FORWARD(args)...)
+  {}
+
+  /**
+   * @brief Constructor from an existing raster, with the channel axis at `ChannelAxis`.
+   */
+  explicit ChannelRaster(Image raster) : m_raster(LINX_MOVE(raster)) {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the pixel shape.
+   */
+  Position<N> shape() const
+  {
+    Position<N> out;
+    for (Index i = 0; i < N; ++i) {
+      out[i] = m_raster.length(i + (ChannelAxis == 0));
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index pixel_count() const
+  {
+    return m_raster.size() / channel_count();
+  }
+
+  /**
+   * @brief Get the number of channels.
+   */
+  Index channel_count() const
+  {
+    return m_raster.length(ChannelAxis);
+  }
+
+  /// @group_views
+
+  /**
+   * @brief Access the underlying raster.
+   */
+  const Image& raster() const
+  {
+    return m_raster;
+  }
+
+  /**
+   * @copybrief raster()const
+   */
+  Image& raster()
+  {
+    return m_raster;
+  }
+
+  /**
+   * @brief Get a view of a channel, which is contiguous in planar layout.
+   */
+  auto channel(Index c) const
+  {
+    if constexpr (Layout == ChannelLayout::Planar) {
+      return m_raster.section(c);
+    } else {
+      return m_raster(channel_box(c));
+    }
+  }
+
+  /**
+   * @copybrief channel()const
+   */
+  auto channel(Index c)
+  {
+    if constexpr (Layout == ChannelLayout::Planar) {
+      return m_raster.section(c);
+    } else {
+      return m_raster(channel_box(c));
+    }
+  }
+
+  /**
+   * @brief Get a view of the channels of a pixel, which is contiguous in interleaved layout.
+   */
+  auto pixel(const Position<N>& position) const
+  {
+    return m_raster.template profile<ChannelAxis>(position);
+  }
+
+  /**
+   * @copybrief pixel()const
+   */
+  auto pixel(const Position<N>& position)
+  {
+    return m_raster.template profile<ChannelAxis>(position);
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Copy the data into a new multi-channel raster with the other layout.
+   */
+  Transposed transpose() const
+  {
+    Transposed out(shape(), channel_count());
+    transpose_into(out);
+    return out;
+  }
+
+  /**
+   * @brief Copy the data into an existing multi-channel raster with the other layout, e.g. to reuse its memory.
+   */
+  template <typename UHolder>
+  void transpose_into(ChannelRaster<T, N, Transposed::MemoryLayout, UHolder>& out) const
+  {
+    SizeError::may_throw(out.raster().size(), m_raster.size());
+    const Index channels = channel_count();
+    const Index pixels = pixel_count();
+    const auto* in = m_raster.data();
+    auto* data = out.raster().data();
+    constexpr Index block = 256; // Pixels per block, such that the input and output blocks fit in the L1 cache
+    for (Index front = 0; front < pixels; front += block) {
+      const auto back = std::min(front + block, pixels);
+      for (Index c = 0; c < channels; ++c) {
+        if constexpr (Layout == ChannelLayout::Planar) {
+          const auto* plane = in + c * pixels;
+          for (Index i = front; i < back; ++i) {
+            data[i * channels + c] = plane[i];
+          }
+        } else {
+          auto* plane = data + c * pixels;
+          for (Index i = front; i < back; ++i) {
+            plane[i] = in[i * channels + c];
+          }
+        }
+      }
+    }
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Compute the shape of the underlying raster.
+   */
+  static Position<N + 1> raster_shape(const Position<N>& shape, Index channels)
+  {
+    Position<N + 1> out;
+    out[ChannelAxis] = channels;
+    for (Index i = 0; i < N; ++i) {
+      out[i + (ChannelAxis == 0)] = shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the region of a channel in interleaved layout.
+   */
+  Box<N + 1> channel_box(Index c) const
+  {
+    auto front = Position<N + 1>::zero();
+    auto back = m_raster.shape() - 1;
+    front[0] = c;
+    back[0] = c;
+    return {front, back};
+  }
+
+  /**
+   * @brief The underlying raster.
+   */
+  Image m_raster;
+};
+
+} // namespace Linx
+
+#endif
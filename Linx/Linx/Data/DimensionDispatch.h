@@ -0,0 +1,188 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_DIMENSIONDISPATCH_H
+#define _LINXDATA_DIMENSIONDISPATCH_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n
+#include <string> // to_string
+#include <type_traits> // false_type, integral_constant, true_type
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Call `func` with the first dimension of `[N, Max]` which equals `dimension`, or with -1.
+ */
+template <Index N, Index Max, typename TFunc>
+decltype(auto) dispatch_dimension_from(Index dimension, TFunc&& func)
+{
+  if constexpr (N > Max) {
+    return func(std::integral_constant<Index, -1>());
+  } else {
+    if (dimension == N) {
+      return func(std::integral_constant<Index, N>());
+    }
+    return dispatch_dimension_from<N + 1, Max>(dimension, LINX_FORWARD(func));
+  }
+}
+
+/**
+ * @brief Make a view of fixed dimension to a raster of variable dimension.
+ */
+template <Index N, typename T, typename THolder>
+PtrRaster<T, N> static_view(Raster<T, -1, THolder>& in)
+{
+  Position<N> shape;
+  std::copy_n(in.shape().begin(), N, shape.begin());
+  return PtrRaster<T, N>(shape, in.data());
+}
+
+/**
+ * @copydoc static_view()
+ */
+template <Index N, typename T, typename THolder>
+PtrRaster<const T, N> static_view(const Raster<T, -1, THolder>& in)
+{
+  Position<N> shape;
+  std::copy_n(in.shape().begin(), N, shape.begin());
+  return PtrRaster<const T, N>(shape, in.data());
+}
+
+/**
+ * @brief Check whether a type is a raster of variable dimension.
+ */
+template <typename T>
+struct IsVariableRaster : std::false_type {};
+
+template <typename T, typename THolder>
+struct IsVariableRaster<Raster<T, -1, THolder>> : std::true_type {};
+
+/**
+ * @brief Call `func` with an input of fixed dimension `N`, e.g. to match an output dispatched beforehand.
+ *
+ * Inputs which are not rasters of variable dimension are forwarded as is.
+ */
+template <Index N, typename TIn, typename TFunc>
+decltype(auto) with_dimension(const TIn& in, TFunc&& func)
+{
+  return func(in);
+}
+
+/**
+ * @copydoc with_dimension()
+ */
+template <Index N, typename T, typename THolder, typename TFunc>
+decltype(auto) with_dimension(const Raster<T, -1, THolder>& in, TFunc&& func)
+{
+  if (in.dimension() != N) {
+    throw Exception("Dimension mismatch: " + std::to_string(in.dimension()) + " != " + std::to_string(N));
+  }
+  const auto view = static_view<N>(in);
+  return func(view);
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Call a function template with a runtime dimension as a compile-time constant.
+ * @tparam Min The lowest dimension to be instantiated
+ * @tparam Max The highest dimension to be instantiated
+ * @param dimension The runtime dimension
+ * @param func The function, called as `func(std::integral_constant<Index, N>())`
+ *
+ * The function is instantiated for each `N` in `[Min, Max]`, and for `N = -1`,
+ * which is selected if the dimension lies outside of the range.
+ * All the instantiations must return the same type.
+ *
+ * \code
+ * dispatch_dimension(shape.size(), [&](auto n) {
+ *   constexpr Index N = decltype(n)::value;
+ *   process<N>(...);
+ * });
+ * \endcode
+ */
+template <Index Min = 1, Index Max = 4, typename TFunc>
+decltype(auto) dispatch_dimension(Index dimension, TFunc&& func)
+{
+  return Internal::dispatch_dimension_from<Min, Max>(dimension, LINX_FORWARD(func));
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Call a function template with a view of fixed dimension to a raster of variable dimension.
+ * @tparam Min The lowest dimension to be instantiated
+ * @tparam Max The highest dimension to be instantiated
+ * @param raster The raster
+ * @param func The function, called as `func(view)`
+ *
+ * Positions, boxes and index computations are much cheaper in fixed dimension,
+ * because coordinates are stored in `std::array`s and loops over the axes are unrolled.
+ * If the raster dimension lies in `[Min, Max]`, the function is called with a `PtrRaster` of same dimension
+ * which points to the raster data, such that the algorithm runs in fixed dimension without copy.
+ * Otherwise, the function is called with the raster itself.
+ *
+ * Rasters of fixed dimension are forwarded as is, such that this function can be used unconditionally:
+ *
+ * \code
+ * template <typename TRaster>
+ * void process(TRaster& raster)
+ * {
+ *   dispatch_dimension(raster, [&](auto& r) {
+ *     for (const auto& p : r.domain()) {
+ *       r[p] = ...; // Position<N> instead of Position<-1>
+ *     }
+ *   });
+ * }
+ * \endcode
+ */
+template <Index Min = 1, Index Max = 4, typename T, Index N, typename THolder, typename TFunc>
+decltype(auto) dispatch_dimension(Raster<T, N, THolder>& raster, TFunc&& func)
+{
+  if constexpr (N == -1) {
+    return dispatch_dimension<Min, Max>(raster.dimension(), [&](auto n) -> decltype(auto) {
+      constexpr Index M = decltype(n)::value;
+      if constexpr (M == -1) {
+        return func(raster);
+      } else {
+        auto view = Internal::static_view<M>(raster);
+        return func(view);
+      }
+    });
+  } else {
+    return func(raster);
+  }
+}
+
+/**
+ * @copydoc dispatch_dimension()
+ */
+template <Index Min = 1, Index Max = 4, typename T, Index N, typename THolder, typename TFunc>
+decltype(auto) dispatch_dimension(const Raster<T, N, THolder>& raster, TFunc&& func)
+{
+  if constexpr (N == -1) {
+    return dispatch_dimension<Min, Max>(raster.dimension(), [&](auto n) -> decltype(auto) {
+      constexpr Index M = decltype(n)::value;
+      if constexpr (M == -1) {
+        return func(raster);
+      } else {
+        const auto view = Internal::static_view<M>(raster);
+        return func(view);
+      }
+    });
+  } else {
+    return func(raster);
+  }
+}
+
+} // namespace Linx
+
+#endif
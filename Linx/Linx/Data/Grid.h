@@ -210,6 +210,26 @@ public:
     return true;
   }
 
+  /**
+   * @brief Apply a function to each row, i.e. each run of positions along axis 0.
+   * @param func The function, called as `func(front, length)`
+   * 
+   * The positions of a row are spaced by `step()[0]`.
+   * @see `Box::for_each_row()`
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func) const
+  {
+    if (size() <= 0) {
+      return;
+    }
+    const auto length = this->length(0);
+    auto plane = *this;
+    for (const auto& front : plane.project()) {
+      func(front, length);
+    }
+  }
+
   /// @group_modifiers
 
   /**
@@ -336,6 +356,53 @@ Grid<N> project(const Grid<N>& in, Index axis = 0)
   return out.project(axis);
 }
 
+/**
+ * @relatesalso Grid
+ * @brief Split a grid into balanced subgrids along a given axis.
+ * 
+ * The subgrids have the same step as the input grid,
+ * and their numbers of nodes along the axis differ by at most one.
+ * 
+ * @see `split_along(const Box<N>&, Index, Index)`
+ */
+template <Index N>
+std::vector<Grid<N>> split_along(const Grid<N>& in, Index axis, Index n)
+{
+  const auto bounds = Internal::balanced_bounds(in.length(axis), n);
+  const auto step = in.step()[axis];
+  std::vector<Grid<N>> out;
+  out.reserve(bounds.size() - 1);
+  auto front = in.front();
+  auto back = in.back();
+  for (std::size_t k = 0; k + 1 < bounds.size(); ++k) {
+    front[axis] = in.front()[axis] + bounds[k] * step;
+    back[axis] = in.front()[axis] + (bounds[k + 1] - 1) * step;
+    out.emplace_back(Box<N>(front, back), in.step());
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Grid
+ * @brief Split a grid into balanced subgrids along the `I`-th axis.
+ */
+template <Index I, Index N>
+std::vector<Grid<N>> split_along(const Grid<N>& in, Index n)
+{
+  return split_along(in, I, n);
+}
+
+/**
+ * @relatesalso Grid
+ * @brief Split a grid into balanced subgrids.
+ * @see `split(const Box<N>&, Index)`
+ */
+template <Index N>
+std::vector<Grid<N>> split(const Grid<N>& in, Index n)
+{
+  return split_along(in, Internal::split_axis(in, n), n);
+}
+
 /**
  * @relatesalso Grid
  * @brief Clamp a grid inside a bounding box.
@@ -0,0 +1,342 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_KDTREE_H
+#define _LINXDATA_KDTREE_H
+
+#include "Linx/Base/Holders.h" // SizeError
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Vector.h"
+
+#include <algorithm> // minmax_element, nth_element
+#include <numeric> // iota
+#include <queue> // priority_queue
+#include <utility> // pair
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief A k-d tree over a set of points, for radius, box and nearest-neighbor queries.
+ * @tparam T The coordinate type, e.g. `Index` for positions or `double` for subpixel coordinates
+ * @tparam N The dimension
+ *
+ * The tree is built once from a range of `Vector<T, N>`, e.g. a `Sequence<Position<N>>`.
+ * It is balanced and implicit: points are reordered such that each node is the median of its subrange
+ * along the axis of largest spread, and the coordinates are stored contiguously in this order,
+ * such that queries only walk a flat array.
+ * Subranges of at most `LeafSize` points are scanned linearly.
+ *
+ * Queries return the indices of the points in the input range.
+ * Distances are Euclidean.
+ *
+ * \code
+ * const KdTree<double, 2> tree(reference_detections);
+ * for (const auto& d : detections) {
+ *   const auto matches = tree.within(d, tolerance);
+ *   ...
+ * }
+ * \endcode
+ */
+template <typename T = double, Index N = 2>
+class KdTree {
+public:
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The maximum number of points of a leaf.
+   */
+  static constexpr Index LeafSize = 8;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param points The points, as a range of `Vector<T, N>`, all of the same dimension
+   */
+  template <typename TRange>
+  explicit KdTree(const TRange& points) : m_dimension(std::abs(N)), m_coordinates(), m_indices(), m_axes()
+  {
+    std::vector<Vector<T, N>> copies(points.begin(), points.end());
+    const auto size = static_cast<Index>(copies.size());
+    if (size > 0) {
+      m_dimension = copies[0].size();
+    }
+    for (const auto& p : copies) {
+      if (static_cast<Index>(p.size()) != m_dimension) {
+        throw SizeError(p.size(), m_dimension);
+      }
+    }
+    m_indices.resize(size);
+    std::iota(m_indices.begin(), m_indices.end(), Index(0));
+    m_axes.resize(size, 0);
+    build(copies, 0, size);
+    m_coordinates.reserve(size * m_dimension);
+    for (auto i : m_indices) {
+      m_coordinates.insert(m_coordinates.end(), copies[i].begin(), copies[i].end());
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of points.
+   */
+  Index size() const
+  {
+    return m_indices.size();
+  }
+
+  /**
+   * @brief Get the dimension of the points.
+   */
+  Index dimension() const
+  {
+    return m_dimension;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Get the indices of the points within a given distance to a center.
+   * @param center The center
+   * @param radius The maximum distance, inclusive
+   *
+   * The indices are returned in unspecified order.
+   */
+  template <typename U>
+  std::vector<Index> within(const Vector<U, N>& center, double radius) const
+  {
+    std::vector<Index> out;
+    const auto r2 = radius * radius;
+    visit(
+        0,
+        size(),
+        [&](Index axis, Index i) {
+          return double(center[axis]) - coordinate(i, axis);
+        },
+        [&](double d) {
+          return d * d <= r2;
+        },
+        [&](Index i) {
+          if (distance2(center, i) <= r2) {
+            out.push_back(m_indices[i]);
+          }
+        });
+    return out;
+  }
+
+  /**
+   * @brief Get the indices of the points inside a box.
+   *
+   * The indices are returned in unspecified order.
+   */
+  std::vector<Index> within(const Box<N>& box) const
+  {
+    std::vector<Index> out;
+    const auto& front = box.front();
+    const auto& back = box.back();
+    const auto contains = [&](Index i) {
+      for (Index a = 0; a < m_dimension; ++a) {
+        const auto c = coordinate(i, a);
+        if (c < front[a] || c > back[a]) {
+          return false;
+        }
+      }
+      return true;
+    };
+    visit(
+        0,
+        size(),
+        [&](Index axis, Index i) {
+          // Signed distance to the box, along the axis, or 0 if the splitting plane crosses the box
+          const auto c = coordinate(i, axis);
+          return c < front[axis] ? double(front[axis] - c) : c > back[axis] ? double(back[axis] - c) : 0.;
+        },
+        [&](double d) {
+          return d == 0;
+        },
+        [&](Index i) {
+          if (contains(i)) {
+            out.push_back(m_indices[i]);
+          }
+        });
+    return out;
+  }
+
+  /**
+   * @brief Get the indices of the `k` nearest points to a given point, from the nearest to the farthest.
+   *
+   * If there are less than `k` points, all of them are returned.
+   * Ties are broken arbitrarily.
+   */
+  template <typename U>
+  std::vector<Index> nearest(const Vector<U, N>& point, Index k) const
+  {
+    std::priority_queue<std::pair<double, Index>> heap; // Max-heap of the current k nearest
+    if (k > 0) {
+      visit(
+          0,
+          size(),
+          [&](Index axis, Index i) {
+            return double(point[axis]) - coordinate(i, axis);
+          },
+          [&](double d) {
+            return Index(heap.size()) < k || d * d <= heap.top().first;
+          },
+          [&](Index i) {
+            const auto d2 = distance2(point, i);
+            if (Index(heap.size()) < k) {
+              heap.emplace(d2, i);
+            } else if (d2 < heap.top().first) {
+              heap.pop();
+              heap.emplace(d2, i);
+            }
+          });
+    }
+    std::vector<Index> out(heap.size());
+    for (auto it = out.rbegin(); it != out.rend(); ++it) {
+      *it = m_indices[heap.top().second];
+      heap.pop();
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the index of the nearest point to a given point, or -1 if the tree is empty.
+   */
+  template <typename U>
+  Index nearest(const Vector<U, N>& point) const
+  {
+    const auto out = nearest(point, 1);
+    return out.empty() ? -1 : out[0];
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get a coordinate of the `i`-th point in tree order.
+   */
+  const T& coordinate(Index i, Index axis) const
+  {
+    return m_coordinates[i * m_dimension + axis];
+  }
+
+  /**
+   * @brief Compute the squared distance between a point and the `i`-th point in tree order.
+   */
+  template <typename U>
+  double distance2(const Vector<U, N>& point, Index i) const
+  {
+    const auto* c = &m_coordinates[i * m_dimension];
+    double out = 0;
+    for (Index a = 0; a < m_dimension; ++a) {
+      const auto d = double(point[a]) - double(c[a]);
+      out += d * d;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Build the subtree of a given subrange of the indices.
+   */
+  void build(const std::vector<Vector<T, N>>& points, Index begin, Index end)
+  {
+    if (end - begin <= LeafSize) {
+      return;
+    }
+
+    // Split along the axis of largest spread
+    Index axis = 0;
+    T spread = 0;
+    for (Index a = 0; a < m_dimension; ++a) {
+      const auto minmax = std::minmax_element(m_indices.begin() + begin, m_indices.begin() + end, [&](auto i, auto j) {
+        return points[i][a] < points[j][a];
+      });
+      const auto s = points[*minmax.second][a] - points[*minmax.first][a];
+      if (s > spread) {
+        axis = a;
+        spread = s;
+      }
+    }
+
+    const auto middle = begin + (end - begin) / 2;
+    std::nth_element(
+        m_indices.begin() + begin,
+        m_indices.begin() + middle,
+        m_indices.begin() + end,
+        [&](auto i, auto j) {
+          return points[i][axis] < points[j][axis];
+        });
+    m_axes[middle] = axis;
+    build(points, begin, middle);
+    build(points, middle + 1, end);
+  }
+
+  /**
+   * @brief Visit the points of a subtree which may satisfy a query.
+   * @param offset The signed distance from the query to a node along an axis
+   * @param is_near Whether a signed distance is close enough for the other side to be visited
+   * @param func The function applied to the visited points
+   *
+   * The side which contains the query is visited first, such that nearest-neighbor pruning is effective.
+   */
+  template <typename TOffset, typename TNear, typename TFunc>
+  void visit(Index begin, Index end, TOffset&& offset, TNear&& is_near, TFunc&& func) const
+  {
+    if (end - begin <= LeafSize) {
+      for (Index i = begin; i < end; ++i) {
+        func(i);
+      }
+      return;
+    }
+    const auto middle = begin + (end - begin) / 2;
+    const auto d = offset(m_axes[middle], middle);
+    if (d < 0) {
+      visit(begin, middle, offset, is_near, func);
+      if (is_near(d)) {
+        func(middle);
+        visit(middle + 1, end, offset, is_near, func);
+      }
+    } else {
+      visit(middle + 1, end, offset, is_near, func);
+      if (is_near(d)) {
+        func(middle);
+        visit(begin, middle, offset, is_near, func);
+      }
+    }
+  }
+
+  /**
+   * @brief The dimension of the points.
+   */
+  Index m_dimension;
+
+  /**
+   * @brief The coordinates of the points, in tree order.
+   */
+  std::vector<T> m_coordinates;
+
+  /**
+   * @brief The input index of the points, in tree order.
+   */
+  std::vector<Index> m_indices;
+
+  /**
+   * @brief The splitting axis of each internal node.
+   */
+  std::vector<Index> m_axes;
+};
+
+} // namespace Linx
+
+#endif
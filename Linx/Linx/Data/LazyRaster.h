@@ -0,0 +1,375 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_LAZYRASTER_H
+#define _LINXDATA_LAZYRASTER_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <iterator>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Read-only raster whose values are computed on access from their position.
+ * @tparam TFunc The generator function, which takes a `Position<N>` and returns a value
+ * @tparam N The dimension
+ * 
+ * No memory is allocated for the values, such that analytic models or coordinate grids
+ * can be used as inputs of other operations without occupying a full raster:
+ * 
+ * \code
+ * const auto background = lazy_raster<2>(shape, [&](const auto& p) {
+ *   return a + b * p[0] + c * p[1];
+ * });
+ * Raster<float> residuals(shape);
+ * residuals = lazy(image) - background; // Single pass, no allocation
+ * auto smooth = filter * background; // Generated by bands
+ * auto resampled = interpolation<Linear>(background); // Interpolated from generated values
+ * \endcode
+ * 
+ * A lazy raster is a random-access range in the order of a raster of the same shape,
+ * such that it can be used in lazy expressions, as an argument of `generate()` or `apply()`,
+ * or to initialize a raster with `Raster(shape, range)`.
+ * It satisfies the requirements of a read-only parent of `Interpolation`.
+ * Since `operator[]()` accepts any position for which the function is defined,
+ * no extrapolation is needed in general.
+ * 
+ * Values are returned by value, such that rasters which are accessed many times at the same position
+ * (e.g. by large kernels) could be faster to materialize with `copy()`.
+ * The function must be thread-safe for the lazy raster to be used in parallel algorithms.
+ */
+template <typename TFunc, Index N = 2>
+class LazyRaster {
+public:
+
+  static_assert(N >= 0, "LazyRaster does not support variable dimension.");
+
+  /**
+   * @brief The value type.
+   */
+  using Value = std::decay_t<std::invoke_result_t<const TFunc&, const Position<N>&>>;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief Iterator which computes the values in raster order.
+   */
+  class Iterator : public std::iterator<std::random_access_iterator_tag, Value, Index, const Value*, Value> {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const LazyRaster& raster, Index index) : m_raster(&raster), m_index(index), m_position()
+    {
+      update();
+    }
+
+    /**
+     * @brief Compute the current value.
+     */
+    Value operator*() const
+    {
+      return m_raster->m_func(m_position);
+    }
+
+    /**
+     * @brief Compute the value at a given offset.
+     */
+    Value operator[](Index n) const
+    {
+      return *(*this + n);
+    }
+
+    /**
+     * @brief Move to the next value.
+     */
+    Iterator& operator++()
+    {
+      ++m_index;
+      for (Index i = 0; i < N; ++i) {
+        ++m_position[i];
+        if (m_position[i] < m_raster->m_shape[i]) {
+          return *this;
+        }
+        m_position[i] = 0;
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Move to the next value.
+     */
+    Iterator operator++(int)
+    {
+      auto out = *this;
+      ++*this;
+      return out;
+    }
+
+    /**
+     * @brief Move to the previous value.
+     */
+    Iterator& operator--()
+    {
+      return *this -= 1;
+    }
+
+    /**
+     * @brief Move forward by some values.
+     */
+    Iterator& operator+=(Index n)
+    {
+      m_index += n;
+      update();
+      return *this;
+    }
+
+    /**
+     * @brief Move backward by some values.
+     */
+    Iterator& operator-=(Index n)
+    {
+      return *this += -n;
+    }
+
+    /**
+     * @brief Get an iterator moved forward.
+     */
+    Iterator operator+(Index n) const
+    {
+      auto out = *this;
+      return out += n;
+    }
+
+    /**
+     * @brief Get an iterator moved backward.
+     */
+    Iterator operator-(Index n) const
+    {
+      auto out = *this;
+      return out -= n;
+    }
+
+    /**
+     * @brief Get the distance between two iterators.
+     */
+    Index operator-(const Iterator& rhs) const
+    {
+      return m_index - rhs.m_index;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same value.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_index == rhs.m_index;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different values.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_index != rhs.m_index;
+    }
+
+    /**
+     * @brief Compare the positions of two iterators.
+     */
+    bool operator<(const Iterator& rhs) const
+    {
+      return m_index < rhs.m_index;
+    }
+
+  private:
+
+    /**
+     * @brief Compute the position from the index.
+     */
+    void update()
+    {
+      auto index = m_index;
+      for (Index i = 0; i < N; ++i) {
+        const auto length = m_raster->m_shape[i];
+        m_position[i] = length > 0 ? index % length : 0;
+        index = length > 0 ? index / length : 0;
+      }
+    }
+
+    const LazyRaster* m_raster;
+    Index m_index;
+    Position<N> m_position;
+  };
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param func The generator function
+   */
+  LazyRaster(Position<N> shape, TFunc func) : m_shape(LINX_MOVE(shape)), m_func(LINX_MOVE(func)) {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the length along given axis.
+   */
+  Index length(Index i) const
+  {
+    return m_shape[i];
+  }
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(m_shape);
+  }
+
+  /**
+   * @brief Check whether the domain contains a given position.
+   */
+  bool contains(const Position<N>& position) const
+  {
+    for (Index i = 0; i < N; ++i) {
+      if (position[i] < 0 || position[i] >= m_shape[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the generator function.
+   */
+  const TFunc& function() const
+  {
+    return m_func;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Compute the value at given position, which may lie outside the domain.
+   */
+  inline Value operator[](const Position<N>& position) const
+  {
+    return m_func(position);
+  }
+
+  /// @group_iterators
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  Iterator begin() const
+  {
+    return Iterator(*this, 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  Iterator end() const
+  {
+    return Iterator(*this, size());
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the values in a given box, which may lie outside the domain, into a new raster.
+   */
+  Raster<Value, N> copy(const Box<N>& box) const
+  {
+    Raster<Value, N> out(box.shape());
+    auto it = out.begin();
+    for (const auto& p : box) {
+      *it = m_func(p);
+      ++it;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute all the values into a new raster.
+   */
+  Raster<Value, N> raster() const
+  {
+    return copy(domain());
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The generator function.
+   */
+  TFunc m_func;
+};
+
+/**
+ * @relatesalso LazyRaster
+ * @brief Make a lazy raster from a shape and a generator function.
+ */
+template <Index N, typename TFunc>
+LazyRaster<std::decay_t<TFunc>, N> lazy_raster(Position<N> shape, TFunc&& func)
+{
+  return LazyRaster<std::decay_t<TFunc>, N>(LINX_MOVE(shape), LINX_FORWARD(func));
+}
+
+/**
+ * @relatesalso LazyRaster
+ * @brief Make a lazy raster whose values are the coordinates along some axis, e.g. to build coordinate grids.
+ * @tparam T The value type
+ * @param shape The raster shape
+ * @param axis The axis index
+ * @param front The value at coordinate 0
+ * @param step The value increment per pixel
+ */
+template <typename T = double, Index N>
+auto lazy_coordinates(Position<N> shape, Index axis, T front = 0, T step = 1)
+{
+  return lazy_raster(LINX_MOVE(shape), [=](const Position<N>& p) {
+    return static_cast<T>(front + step * p[axis]);
+  });
+}
+
+} // namespace Linx
+
+#endif
@@ -8,6 +8,10 @@
 #include "Linx/Data/Box.h"
 #include "Linx/Data/Raster.h"
 
+#include <memory> // shared_ptr, atomic_load, atomic_store, atomic_compare_exchange_strong
+#include <numeric> // accumulate
+#include <vector>
+
 namespace Linx {
 
 /**
@@ -15,6 +19,12 @@ namespace Linx {
  * @brief A masked ND bounding box.
  * 
  * This class is similar to `Box`, yet with a boolean value (the flag) associated to each position.
+ * 
+ * Flags are stored densely over the bounding box, and the set positions are additionally run-length encoded
+ * as runs of consecutive positions along axis 0 (see `runs()`).
+ * Iteration, patch indexing and filtering rely on the runs,
+ * such that sparse or ball-shaped masks are iterated without testing the unset flags.
+ * The runs are computed lazily, shared by the copies of the mask, and invalidated by the non-constant `operator[]()`.
  */
 template <Index N = 2>
 class Mask : boost::additive<Mask<N>, Position<N>>, boost::additive<Mask<N>, Index> {
@@ -31,6 +41,21 @@ public:
    */
   class Iterator;
 
+  /**
+   * @brief A run of consecutive set positions along axis 0.
+   */
+  struct Run {
+    /**
+     * @brief The first position of the run, relative to the bounding box front.
+     */
+    Position<N> front;
+
+    /**
+     * @brief The number of positions.
+     */
+    Index length;
+  };
+
   /// @{
   /// @group_construction
 
@@ -105,7 +130,28 @@ public:
    */
   Index size() const
   {
-    return std::count(m_flags.begin(), m_flags.end(), true);
+    Index out = 0;
+    for (const auto& r : runs()) {
+      out += r.length;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the runs of set positions, in iteration order.
+   */
+  const std::vector<Run>& runs() const
+  {
+    auto runs = std::atomic_load(&m_runs);
+    if (not runs) {
+      // Concurrent calls may compute the same runs, but only the first ones are published,
+      // such that the returned reference is never released by another call
+      auto computed = std::make_shared<const std::vector<Run>>(encode());
+      if (std::atomic_compare_exchange_strong(&m_runs, &runs, computed)) {
+        return *computed;
+      }
+    }
+    return *runs;
   }
 
   /**
@@ -128,10 +174,13 @@ public:
 
   /**
    * @brief Set or unset a position in the mask.
+   * 
+   * The runs are invalidated, and computed again when needed.
    */
   bool& operator[](const Position<N>& position)
   {
     // FIXME check bounds here or do not in const overload
+    invalidate();
     return m_flags[position - m_box.front()];
   }
 
@@ -177,6 +226,7 @@ public:
     m_box &= box;
     const auto patch = m_flags(m_box - front);
     m_flags = patch.copy();
+    invalidate();
     return *this;
     // FIXME test
   }
@@ -249,6 +299,7 @@ public:
     auto out = *this;
     out.m_box = -m_box;
     std::reverse(out.m_flags.begin(), out.m_flags.end());
+    out.invalidate();
     return out; // FIXME optimize
   }
 
@@ -256,6 +307,44 @@ public:
 
 private:
 
+  /**
+   * @brief Reset the runs.
+   */
+  void invalidate()
+  {
+    std::atomic_store(&m_runs, std::shared_ptr<const std::vector<Run>>());
+  }
+
+  /**
+   * @brief Compute the runs from the flags.
+   */
+  std::vector<Run> encode() const
+  {
+    std::vector<Run> out;
+    const auto width = m_flags.length(0);
+    const auto* flag = m_flags.data();
+    auto plane = Box<N>::from_shape(m_flags.shape());
+    if (plane.size() <= 0) {
+      return out;
+    }
+    for (const auto& front : plane.project()) {
+      for (Index x = 0; x < width; ++x) {
+        if (not flag[x]) {
+          continue;
+        }
+        auto start = front;
+        start[0] = x;
+        const auto begin = x;
+        while (x < width && flag[x]) {
+          ++x;
+        }
+        out.push_back({LINX_MOVE(start), x - begin});
+      }
+      flag += width;
+    }
+    return out;
+  }
+
   /**
    * @brief The bounding box.
    */
@@ -265,6 +354,11 @@ private:
    * @brief The flag map.
    */
   Raster<bool, N> m_flags;
+
+  /**
+   * @brief The runs, or null if they must be computed.
+   */
+  mutable std::shared_ptr<const std::vector<Run>> m_runs;
 };
 
 /**
@@ -277,6 +371,105 @@ inline const Box<N>& box(const Mask<N>& region)
   return region.box();
 }
 
+/**
+ * @relatesalso Mask
+ * @brief Extend a mask to a higher dimension, with unit lengths along the new axes.
+ */
+template <Index M, Index N>
+Mask<M> extend(const Mask<N>& region)
+{
+  Mask<M> out(extend<M>(region.box()), false);
+  for (const auto& p : region) {
+    out[extend<M>(p)] = true;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Mask
+ * @brief Split a mask into submasks of balanced sizes along a given axis.
+ * @param in The input mask
+ * @param axis The index of the axis
+ * @param n The maximum number of submasks
+ * 
+ * The bounding box is cut into slabs along the axis such that the numbers of positions of the slabs are balanced.
+ * No submask is empty, such that fewer than `n` submasks are returned if the mask is too small.
+ * 
+ * @see `split_along(const Box<N>&, Index, Index)`
+ */
+template <Index N>
+std::vector<Mask<N>> split_along(const Mask<N>& in, Index axis, Index n)
+{
+  const auto& bounding = in.box();
+  const auto origin = bounding.front()[axis];
+  const auto length = bounding.length(axis);
+  std::vector<Index> counts(std::max(length, Index(0)), 0);
+  for (const auto& p : in) {
+    ++counts[p[axis] - origin];
+  }
+  const auto total = std::accumulate(counts.begin(), counts.end(), Index(0));
+  const auto parts = std::max(Index(0), std::min(total, n));
+  std::vector<Mask<N>> out;
+  if (parts == 0) {
+    return out;
+  }
+
+  // Cut after the slices where the cumulated count reaches a multiple of total / parts
+  std::vector<Index> bounds {0};
+  Index sum = 0;
+  Index cut = 0;
+  for (Index j = 0, k = 1; j < length && k < parts; ++j) {
+    sum += counts[j];
+    if (sum > cut && sum * parts >= k * total) {
+      bounds.push_back(j + 1);
+      cut = sum;
+      while (k < parts && sum * parts >= k * total) {
+        ++k;
+      }
+    }
+  }
+  if (cut == total) {
+    bounds.back() = length;
+  } else {
+    bounds.push_back(length);
+  }
+
+  out.reserve(bounds.size() - 1);
+  auto front = bounding.front();
+  auto back = bounding.back();
+  for (std::size_t k = 0; k + 1 < bounds.size(); ++k) {
+    front[axis] = origin + bounds[k];
+    back[axis] = origin + bounds[k + 1] - 1;
+    out.emplace_back(front, back, false);
+  }
+  for (const auto& p : in) {
+    const auto k = std::upper_bound(bounds.begin(), bounds.end(), p[axis] - origin) - bounds.begin() - 1;
+    out[k][p] = true;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Mask
+ * @brief Split a mask into submasks of balanced sizes along the `I`-th axis.
+ */
+template <Index I, Index N>
+std::vector<Mask<N>> split_along(const Mask<N>& in, Index n)
+{
+  return split_along(in, I, n);
+}
+
+/**
+ * @relatesalso Mask
+ * @brief Split a mask into submasks of balanced sizes.
+ * @see `split(const Box<N>&, Index)`
+ */
+template <Index N>
+std::vector<Mask<N>> split(const Mask<N>& in, Index n)
+{
+  return split_along(in, Internal::split_axis(in, n), n);
+}
+
 /**
  * @relatesalso Mask
  * @brief Clamp a mask inside a box.
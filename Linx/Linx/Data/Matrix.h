@@ -6,31 +6,42 @@
 #define _LINXDATA_MATRIX_H
 
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/mixins/Arithmetic.h" // unroll
 #include "Linx/Base/mixins/DataContainer.h"
 #include "Linx/Data/Vector.h"
 
-#include <eigen3/Eigen/Core>
+#include <cmath> // abs
+#include <utility> // index_sequence, swap
+#include <vector>
 
 namespace Linx {
 
 /**
  * @ingroup data_classes
- * @brief Euclidean matrix.
- * 
+ * @brief Fixed-size, row-major matrix, mainly intended for small linear maps.
+ *
  * @tparam T The value type
  * @tparam N The number of rows
  * @tparam M The number of columns
- * 
- * 
- * TODO
+ *
+ * The values are stored in an `std::array` in row-major order.
+ * Arithmetic operators are element-wise, except for the matrix-matrix and matrix-vector products,
+ * which are free functions, as well as `determinant()` and `inverse()`.
+ * These are unrolled at compile-time, and closed forms are used up to size 3,
+ * such that small matrices are as fast as hand-written code.
+ *
+ * \code
+ * const Matrix<double, 2> rotation {0, -1, 1, 0};
+ * const auto rotated = rotation * Vector<double, 2> {1, 0}; // {0, 1}
+ * const auto back = inverse(rotation) * rotated; // {1, 0}
+ * \endcode
+ *
+ * @see `batch_multiply()`, `batch_determinant()`, `batch_inverse()`
  */
 template <typename T, Index N = 2, Index M = N>
-class Matrix :
-    public DataContainer<
-        T,
-        StdHolder<Coordinates<T, N * M>>,
-        EuclidArithmetic,
-        Matrix<T, N, M>> { // FIXME MatrixArithmetic
+class Matrix : public DataContainer<T, StdHolder<Coordinates<T, N * M>>, VectorArithmetic, Matrix<T, N, M>> {
+  static_assert(N > 0 && M > 0, "Matrix dimensions must be fixed and positive.");
 
 public:
 
@@ -42,10 +53,21 @@ public:
   /**
    * @brief The container type.
    */
-  using Container = DataContainer<T, StdHolder<Coordinates<T, N * M>>, EuclidArithmetic, Matrix<T, N, M>>;
+  using Container = DataContainer<T, StdHolder<Coordinates<T, N * M>>, VectorArithmetic, Matrix<T, N, M>>;
 
+  /**
+   * @brief The number of rows.
+   */
   static constexpr Index Rows = N;
+
+  /**
+   * @brief The number of columns.
+   */
   static constexpr Index Columns = M;
+
+  /**
+   * @brief The maximum rank.
+   */
   static constexpr Index Rank = std::min(N, M);
 
   /// @{
@@ -56,9 +78,14 @@ public:
   LINX_DEFAULT_MOVABLE(Matrix)
 
   /**
-   * @brief Constructor.
+   * @brief Create a zero matrix.
    */
-  explicit Matrix() : Container(N * M), m_eigen(this->data()) {}
+  Matrix() : Container(N * M) {}
+
+  /**
+   * @brief Create a matrix from a brace-enclosed list of values in row-major order.
+   */
+  Matrix(std::initializer_list<T> values) : Container(values.begin(), values.end()) {}
 
   /**
    * @brief Create the identity matrix.
@@ -66,10 +93,9 @@ public:
   static Matrix identity()
   {
     Matrix out;
-    auto d = out.data();
-    for (Index i = 0; i < Rank; ++i, d += Columns + 1) {
-      *d = T(1);
-    }
+    Internal::unroll(std::make_index_sequence<Rank>(), [&](std::size_t i) {
+      out.data()[i * (Columns + 1)] = T(1);
+    });
     return out;
   }
 
@@ -90,11 +116,11 @@ public:
   /// @group_properties
 
   /**
-   * @brief Get the matrix shape.
+   * @brief Get the matrix shape, i.e. the number of columns and rows, as for a raster.
    */
-  const Position<2>& shape() const
+  static Position<2> shape()
   {
-    return {N, M};
+    return {M, N};
   }
 
   /// @group_elements
@@ -104,7 +130,7 @@ public:
    */
   inline const T& operator()(Index row, Index column) const
   {
-    return column + Columns * row;
+    return this->data()[column + Columns * row];
   }
 
   /**
@@ -112,7 +138,7 @@ public:
    */
   inline T& operator()(Index row, Index column)
   {
-    return const_cast<T&>(const_cast<const Matrix&>(*this)->at(row, column));
+    return this->data()[column + Columns * row];
   }
 
   /**
@@ -121,21 +147,123 @@ public:
   template <Index R, Index C>
   const T& at() const
   {
-    return C + Columns * R;
+    static_assert(R >= 0 && R < N && C >= 0 && C < M);
+    return this->data()[C + Columns * R];
+  }
+
+  /**
+   * @copybrief operator()()
+   */
+  template <Index R, Index C>
+  T& at()
+  {
+    static_assert(R >= 0 && R < N && C >= 0 && C < M);
+    return this->data()[C + Columns * R];
   }
 
   /// @group_operations
 
+  /**
+   * @brief Compute the determinant.
+   */
   T determinant() const
   {
-    return m_eigen.determinant();
+    static_assert(N == M, "Determinant requires a square matrix.");
+    const auto& a = *this;
+    if constexpr (N == 1) {
+      return a(0, 0);
+    } else if constexpr (N == 2) {
+      return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    } else if constexpr (N == 3) {
+      return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+          a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+    } else {
+      auto lu = *this;
+      T out = 1;
+      for (Index k = 0; k < N; ++k) {
+        const auto pivot = lu.pivot(k);
+        if (pivot != k) {
+          lu.swap_rows(k, pivot);
+          out = -out;
+        }
+        const auto d = lu(k, k);
+        if (d == T()) {
+          return T();
+        }
+        out *= d;
+        for (Index i = k + 1; i < N; ++i) {
+          const auto f = lu(i, k) / d;
+          for (Index j = k + 1; j < N; ++j) {
+            lu(i, j) -= f * lu(k, j);
+          }
+        }
+      }
+      return out;
+    }
   }
 
   /// @group_modifiers
 
+  /**
+   * @brief Inverse the matrix in place.
+   *
+   * A singular matrix results in infinite or NaN values.
+   */
   Matrix& inverse()
   {
-    m_eigen.inverse();
+    static_assert(N == M, "Inverse requires a square matrix.");
+    auto& m = *this;
+    if constexpr (N == 1) {
+      m(0, 0) = T(1) / m(0, 0);
+    } else if constexpr (N == 2) {
+      const auto inv = T(1) / determinant();
+      const auto a = m(0, 0);
+      m(0, 0) = m(1, 1) * inv;
+      m(1, 1) = a * inv;
+      m(0, 1) *= -inv;
+      m(1, 0) *= -inv;
+    } else if constexpr (N == 3) {
+      const auto inv = T(1) / determinant();
+      const auto& a = m;
+      Matrix out;
+      Internal::unroll(std::make_index_sequence<3>(), [&](std::size_t i) {
+        Internal::unroll(std::make_index_sequence<3>(), [&](std::size_t j) {
+          // Cofactor of (j, i), with cyclic indices
+          const auto r0 = (j + 1) % 3;
+          const auto r1 = (j + 2) % 3;
+          const auto c0 = (i + 1) % 3;
+          const auto c1 = (i + 2) % 3;
+          out(i, j) = (a(r0, c0) * a(r1, c1) - a(r0, c1) * a(r1, c0)) * inv;
+        });
+      });
+      m = out;
+    } else {
+      // Gauss-Jordan elimination with partial pivoting
+      auto out = identity();
+      for (Index k = 0; k < N; ++k) {
+        const auto pivot = m.pivot(k);
+        if (pivot != k) {
+          m.swap_rows(k, pivot);
+          out.swap_rows(k, pivot);
+        }
+        const auto inv = T(1) / m(k, k);
+        for (Index j = 0; j < N; ++j) {
+          m(k, j) *= inv;
+          out(k, j) *= inv;
+        }
+        for (Index i = 0; i < N; ++i) {
+          if (i == k) {
+            continue;
+          }
+          const auto f = m(i, k);
+          for (Index j = 0; j < N; ++j) {
+            m(i, j) -= f * m(k, j);
+            out(i, j) -= f * out(k, j);
+          }
+        }
+      }
+      m = out;
+    }
     return *this;
   }
 
@@ -143,9 +271,167 @@ public:
 
 private:
 
-  Eigen::Map<Eigen::Matrix<T, N, M, Eigen::RowMajor>> m_eigen;
+  /**
+   * @brief Get the row of the maximum absolute value of a column from its diagonal element.
+   */
+  Index pivot(Index k) const
+  {
+    auto out = k;
+    for (Index i = k + 1; i < N; ++i) {
+      if (std::abs((*this)(i, k)) > std::abs((*this)(out, k))) {
+        out = i;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Swap two rows.
+   */
+  void swap_rows(Index i, Index j)
+  {
+    for (Index k = 0; k < M; ++k) {
+      std::swap((*this)(i, k), (*this)(j, k));
+    }
+  }
 };
 
+/**
+ * @relatesalso Matrix
+ * @brief Compute the matrix-matrix product.
+ */
+template <typename T, Index N, Index K, Index M>
+Matrix<T, N, M> operator*(const Matrix<T, N, K>& lhs, const Matrix<T, K, M>& rhs)
+{
+  Matrix<T, N, M> out;
+  Internal::unroll(std::make_index_sequence<N>(), [&](std::size_t i) {
+    Internal::unroll(std::make_index_sequence<M>(), [&](std::size_t j) {
+      T sum = 0;
+      Internal::unroll(std::make_index_sequence<K>(), [&](std::size_t k) {
+        sum += lhs(i, k) * rhs(k, j);
+      });
+      out(i, j) = sum;
+    });
+  });
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the matrix-vector product.
+ *
+ * The vector values are cast to the matrix value type, e.g. to transform a `Position` with a `Matrix<double>`.
+ */
+template <typename T, Index N, Index M, typename U>
+Vector<T, N> operator*(const Matrix<T, N, M>& lhs, const Vector<U, M>& rhs)
+{
+  Vector<T, N> out;
+  Internal::unroll(std::make_index_sequence<N>(), [&](std::size_t i) {
+    T sum = 0;
+    Internal::unroll(std::make_index_sequence<M>(), [&](std::size_t k) {
+      sum += lhs(i, k) * static_cast<T>(rhs[k]);
+    });
+    out[i] = sum;
+  });
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the transpose of a matrix.
+ */
+template <typename T, Index N, Index M>
+Matrix<T, M, N> transpose(const Matrix<T, N, M>& in)
+{
+  Matrix<T, M, N> out;
+  Internal::unroll(std::make_index_sequence<N>(), [&](std::size_t i) {
+    Internal::unroll(std::make_index_sequence<M>(), [&](std::size_t j) {
+      out(j, i) = in(i, j);
+    });
+  });
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the determinant of a matrix.
+ */
+template <typename T, Index N>
+T determinant(const Matrix<T, N, N>& in)
+{
+  return in.determinant();
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the inverse of a matrix.
+ */
+template <typename T, Index N>
+Matrix<T, N, N> inverse(const Matrix<T, N, N>& in)
+{
+  auto out = in;
+  return out.inverse();
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the products of a sequence of matrices with a sequence of vectors or matrices.
+ * @param lhs The matrices
+ * @param rhs The vectors or matrices, of same size as `lhs`
+ * @param out The output, of same size as `lhs`
+ * @param threads The threads
+ *
+ * If `rhs` has a single element, it is multiplied with each matrix of `lhs`.
+ */
+template <typename TLhs, typename TRhs, typename TOut>
+TOut& batch_multiply(const TLhs& lhs, const TRhs& rhs, TOut& out, const Threads& threads = Threads(1))
+{
+  const Index size = std::distance(lhs.begin(), lhs.end());
+  const auto l = lhs.begin();
+  const auto r = rhs.begin();
+  const auto o = out.begin();
+  const bool broadcast = std::distance(rhs.begin(), rhs.end()) == 1;
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index i = 0; i < size; ++i) {
+    o[i] = l[i] * r[broadcast ? 0 : i];
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Compute the determinants of a sequence of matrices.
+ */
+template <typename TRange>
+std::vector<typename std::decay_t<decltype(*std::declval<TRange>().begin())>::Value>
+batch_determinant(const TRange& matrices, const Threads& threads = Threads(1))
+{
+  const Index size = std::distance(matrices.begin(), matrices.end());
+  const auto m = matrices.begin();
+  std::vector<typename std::decay_t<decltype(*m)>::Value> out(size);
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index i = 0; i < size; ++i) {
+    out[i] = m[i].determinant();
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Inverse a sequence of matrices in place.
+ */
+template <typename TRange>
+TRange& batch_inverse(TRange& matrices, const Threads& threads = Threads(1))
+{
+  const Index size = std::distance(matrices.begin(), matrices.end());
+  const auto m = matrices.begin();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index i = 0; i < size; ++i) {
+    m[i].inverse();
+  }
+  return matrices;
+}
+
 } // namespace Linx
 
 #endif
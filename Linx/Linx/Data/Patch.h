@@ -17,6 +17,138 @@
 
 namespace Linx {
 
+/**
+ * @ingroup data_classes
+ * @brief A patch in base-index form, i.e. which is translated by adding an index offset.
+ * @tparam T The value type
+ * @tparam TIndexing The indexing strategy of the patch
+ * 
+ * A stencil shares the translation-invariant offset tables of the patch it is made from,
+ * and represents the patch position as the raw index of its front pixel in the parent raster.
+ * Translating the stencil is therefore a single integer addition,
+ * instead of the translation of the region and the computation of the front index,
+ * which makes it ideal for sliding windows in hot loops:
+ * 
+ * \code
+ * auto patch = raster(Box<2>::from_center(1));
+ * auto stencil = patch.stencil();
+ * const auto origin = stencil.index();
+ * for (const auto& p : inner) {
+ *   stencil.move_to(origin + raster.index(p)); // Centered on p
+ *   ... // Use stencil.begin() and stencil.end()
+ * }
+ * \endcode
+ * 
+ * The stencil must not outlive the patch, and it can only be iterated while its pixels are inside the raster.
+ * @see `Patch::stencil()`
+ */
+template <typename T, typename TIndexing>
+class Stencil {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The iterator type.
+   */
+  using Iterator = typename TIndexing::template Iterator<T>;
+
+  /**
+   * @brief Constructor.
+   * @param data The parent raster data
+   * @param index The index of the front pixel in the parent raster
+   * @param size The number of pixels
+   * @param indexing The patch indexing
+   */
+  Stencil(T* data, Index index, std::size_t size, const TIndexing& indexing) :
+      m_data(data), m_index(index), m_size(size), m_indexing(&indexing)
+  {}
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the index of the front pixel in the parent raster.
+   */
+  Index index() const
+  {
+    return m_index;
+  }
+
+  /**
+   * @brief Move the front pixel to a given index.
+   */
+  Stencil& move_to(Index index)
+  {
+    m_index = index;
+    return *this;
+  }
+
+  /**
+   * @brief Translate the stencil by a given index offset.
+   */
+  Stencil& operator+=(Index offset)
+  {
+    m_index += offset;
+    return *this;
+  }
+
+  /**
+   * @brief Translate the stencil by the opposite of a given index offset.
+   */
+  Stencil& operator-=(Index offset)
+  {
+    m_index -= offset;
+    return *this;
+  }
+
+  /**
+   * @brief Iterator to the front pixel.
+   */
+  Iterator begin() const
+  {
+    return m_indexing->template begin_at<T>(m_data + m_index, m_size);
+  }
+
+  /**
+   * @brief End iterator.
+   */
+  Iterator end() const
+  {
+    return m_indexing->template end_at<T>(m_data + m_index, m_size);
+  }
+
+private:
+
+  /**
+   * @brief The parent raster data.
+   */
+  T* m_data;
+
+  /**
+   * @brief The index of the front pixel.
+   */
+  Index m_index;
+
+  /**
+   * @brief The number of pixels.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The patch indexing.
+   */
+  const TIndexing* m_indexing;
+};
+
 /**
  * @ingroup data_classes
  * @ingroup regions
@@ -205,6 +337,60 @@ public:
     return m_indexing.template end<Value>(*m_parent, m_region);
   }
 
+  /**
+   * @brief Apply a function to each span, i.e. each run of pixels which are equally spaced in memory.
+   * @param func The function, called as `func(data, size, stride)`
+   * 
+   * Spans are visited in iteration order, and the pixels of a span are `data[0]`, `data[stride]`, ...,
+   * `data[(size - 1) * stride]`.
+   * Box- and grid-based patches of rasters yield one span per row,
+   * and contiguous patches a single span, such that the inner loop is tight and vectorizable:
+   * 
+   * \code
+   * patch.for_each_span([&](auto* data, Index size, Index stride) {
+   *   for (Index i = 0; i < size; ++i) {
+   *     data[i * stride] *= 2;
+   *   }
+   * });
+   * \endcode
+   * 
+   * Other patches yield spans of size 1.
+   */
+  template <typename TFunc>
+  void for_each_span(TFunc&& func) const
+  {
+    m_indexing.template for_each_span<const Value>(*m_parent, m_region, LINX_FORWARD(func));
+  }
+
+  /**
+   * @copydoc for_each_span()const
+   */
+  template <typename TFunc>
+  void for_each_span(TFunc&& func)
+  {
+    m_indexing.template for_each_span<Value>(*m_parent, m_region, LINX_FORWARD(func));
+  }
+
+  /**
+   * @brief Get the patch in base-index form, for fast translation.
+   * @warning This method is only valid for patches of rasters, and the stencil must not outlive the patch.
+   * @see `Stencil`
+   */
+  Stencil<const Value, Indexing> stencil() const
+  {
+    const auto& raster = *m_parent;
+    return Stencil<const Value, Indexing>(raster.data(), raster.index(Linx::box(m_region).front()), size(), m_indexing);
+  }
+
+  /**
+   * @copydoc stencil()const
+   */
+  Stencil<Value, Indexing> stencil()
+  {
+    auto& raster = *m_parent;
+    return Stencil<Value, Indexing>(raster.data(), raster.index(Linx::box(m_region).front()), size(), m_indexing);
+  }
+
   /**
    * @brief Get a pointer to the underlying array.
    * @warning This method is only valid for contiguous patches.
@@ -0,0 +1,283 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_POSITIONOFFSETS_H
+#define _LINXDATA_POSITIONOFFSETS_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+
+#include <algorithm> // sort
+#include <numeric> // iota
+#include <string> // to_string
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief Precomputed linear offsets of a list of positions, for bulk gather and scatter.
+ * @tparam N The dimension
+ *
+ * The offsets of the positions in the rasters of a given shape are computed once,
+ * such that values can then be read (gathered) or written (scattered) in bulk,
+ * between any raster of this shape and a contiguous sequence, with a single pointer addition per value.
+ * This is typically useful when working repeatedly at the same positions, e.g. of a catalog or of a list of bad pixels,
+ * in frames of the same shape.
+ *
+ * Optionally, the offsets are sorted, such that the rasters are accessed in memory order,
+ * which is much more cache-friendly for large, scattered position lists.
+ * The values of the sequences remain in the order of the input positions.
+ *
+ * \code
+ * const PositionOffsets<2> offsets(frame.shape(), catalog, true);
+ * for (const auto& frame : frames) {
+ *   auto fluxes = offsets.gather(frame, Threads());
+ *   ...
+ * }
+ * \endcode
+ *
+ * @see `gather()`
+ * @see `scatter()`
+ */
+template <Index N = 2>
+class PositionOffsets {
+public:
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param positions The positions, which must lie inside the raster domain
+   * @param sorted Whether to sort the offsets in memory order
+   * 
+   * An `OutOfBoundsError` is thrown if some position lies outside the raster domain.
+   */
+  template <typename TRange>
+  PositionOffsets(Position<N> shape, const TRange& positions, bool sorted = false) :
+      m_shape(LINX_MOVE(shape)), m_offsets(), m_order()
+  {
+    const auto strides = shape_strides(m_shape);
+    for (const auto& p : positions) {
+      Index offset = 0;
+      for (std::size_t i = 0; i < strides.size(); ++i) {
+        OutOfBoundsError::may_throw("Position coordinate " + std::to_string(i) + ": ", p[i], {Index(0), m_shape[i] - 1});
+        offset += p[i] * strides[i];
+      }
+      m_offsets.push_back(offset);
+    }
+    if (sorted) {
+      m_order.resize(m_offsets.size());
+      std::iota(m_order.begin(), m_order.end(), Index(0));
+      std::sort(m_order.begin(), m_order.end(), [&](auto lhs, auto rhs) {
+        return m_offsets[lhs] < m_offsets[rhs];
+      });
+      std::vector<Index> offsets(m_offsets.size());
+      for (std::size_t k = 0; k < offsets.size(); ++k) {
+        offsets[k] = m_offsets[m_order[k]];
+      }
+      std::swap(offsets, m_offsets);
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the number of positions.
+   */
+  Index size() const
+  {
+    return m_offsets.size();
+  }
+
+  /**
+   * @brief Check whether the offsets are sorted.
+   */
+  bool is_sorted() const
+  {
+    return not m_order.empty() || m_offsets.empty();
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Read the values of a raster at the positions into a sequence.
+   * @param in The raster
+   * @param out The sequence, of size `size()`
+   * @param threads The threads
+   */
+  template <typename T, typename THolder, typename TOut>
+  TOut& gather_into(const Raster<T, N, THolder>& in, TOut& out, const Threads& threads = Threads(1)) const
+  {
+    check(in.shape(), out.size());
+    const auto* data = in.data();
+    auto* values = out.data();
+    const Index size = m_offsets.size();
+    const auto* offsets = m_offsets.data();
+    if (m_order.empty()) {
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index k = 0; k < size; ++k) {
+        values[k] = data[offsets[k]];
+      }
+    } else {
+      const auto* order = m_order.data();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index k = 0; k < size; ++k) {
+        values[order[k]] = data[offsets[k]];
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Read the values of a raster at the positions into a new sequence.
+   */
+  template <typename T, typename THolder>
+  Sequence<std::remove_const_t<T>> gather(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1)) const
+  {
+    Sequence<std::remove_const_t<T>> out(m_offsets.size());
+    gather_into(in, out, threads);
+    return out;
+  }
+
+  /**
+   * @brief Write the values of a sequence into a raster at the positions.
+   * @param in The sequence, of size `size()`
+   * @param out The raster
+   * @param threads The threads
+   *
+   * If several positions are equal, one of the values is written, unspecified if the operation is parallel.
+   */
+  template <typename TIn, typename T, typename THolder>
+  Raster<T, N, THolder>& scatter(const TIn& in, Raster<T, N, THolder>& out, const Threads& threads = Threads(1)) const
+  {
+    return scatter(
+        in,
+        out,
+        [](const auto&, const auto& e) {
+          return e;
+        },
+        threads);
+  }
+
+  /**
+   * @brief Combine the values of a sequence with those of a raster at the positions.
+   * @param in The sequence, of size `size()`
+   * @param out The raster
+   * @param func The combination function, e.g. `std::plus<T>()`, called as `func(raster_value, sequence_value)`
+   * @param threads The threads
+   *
+   * If several positions are equal, the operation must not be parallel.
+   */
+  template <
+      typename TIn,
+      typename T,
+      typename THolder,
+      typename TFunc,
+      typename = std::enable_if_t<not std::is_same_v<std::decay_t<TFunc>, Threads>>>
+  Raster<T, N, THolder>&
+  scatter(const TIn& in, Raster<T, N, THolder>& out, TFunc&& func, const Threads& threads = Threads(1)) const
+  {
+    check(out.shape(), in.size());
+    auto* data = out.data();
+    const auto* values = in.data();
+    const Index size = m_offsets.size();
+    const auto* offsets = m_offsets.data();
+    if (m_order.empty()) {
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index k = 0; k < size; ++k) {
+        auto& e = data[offsets[k]];
+        e = func(e, values[k]);
+      }
+    } else {
+      const auto* order = m_order.data();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index k = 0; k < size; ++k) {
+        auto& e = data[offsets[k]];
+        e = func(e, values[order[k]]);
+      }
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Check the raster shape and sequence size.
+   */
+  void check(const Position<N>& shape, Index size) const
+  {
+    if (shape != m_shape) {
+      throw SizeError(shape_size(shape), shape_size(m_shape));
+    }
+    if (size != Index(m_offsets.size())) {
+      throw SizeError(size, m_offsets.size());
+    }
+  }
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The offsets, possibly sorted.
+   */
+  std::vector<Index> m_offsets;
+
+  /**
+   * @brief The index of each offset in the input positions if sorted, or empty.
+   */
+  std::vector<Index> m_order;
+};
+
+/**
+ * @relatesalso PositionOffsets
+ * @brief Read the values of a raster at given positions into a new sequence.
+ *
+ * If the same positions are used several times, `PositionOffsets` should be instantiated once instead.
+ */
+template <typename T, Index N, typename THolder, typename TRange>
+Sequence<std::remove_const_t<T>>
+gather(const Raster<T, N, THolder>& in, const TRange& positions, const Threads& threads = Threads(1))
+{
+  return PositionOffsets<N>(in.shape(), positions).gather(in, threads);
+}
+
+/**
+ * @relatesalso PositionOffsets
+ * @brief Write the values of a sequence into a raster at given positions.
+ *
+ * If the same positions are used several times, `PositionOffsets` should be instantiated once instead.
+ */
+template <typename TIn, typename T, Index N, typename THolder, typename TRange>
+Raster<T, N, THolder>&
+scatter(const TIn& in, Raster<T, N, THolder>& out, const TRange& positions, const Threads& threads = Threads(1))
+{
+  return PositionOffsets<N>(out.shape(), positions).scatter(in, out, threads);
+}
+
+} // namespace Linx
+
+#endif
@@ -6,7 +6,10 @@
 #define _LINXDATA_RASTER_H
 
 #include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Base/Conversion.h"
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Expression.h"
+#include "Linx/Base/Pool.h"
 #include "Linx/Base/Random.h"
 #include "Linx/Base/mixins/DataContainer.h"
 #include "Linx/Data/Box.h"
@@ -17,6 +20,8 @@
 #include <complex>
 #include <cstdint>
 #include <string>
+#include <type_traits>
+#include <utility> // declval
 #include <valarray>
 #include <vector>
 
@@ -97,6 +102,78 @@ using ArrRaster = Raster<T, N, StdHolder<std::array<T, Capacity>>>;
 template <typename T, Index N = 2>
 using AlignedRaster = Raster<T, N, AlignedBuffer<T>>;
 
+/**
+ * @ingroup data_classes
+ * @brief `Raster` whose memory is recycled through a thread-local pool.
+ * 
+ * Constructing a raster of the same size as a previously destroyed one reuses its memory,
+ * which avoids allocation churn and page faults in long-running loops.
+ * As opposed to most owning rasters, values are not zero-initialized.
+ * @see `BlockPool`
+ */
+template <typename T, Index N = 2>
+using PoolRaster = Raster<T, N, PoolHolder<T>>;
+
+/**
+ * @ingroup data_classes
+ * @brief `Raster` whose memory is allocated in the current arena, if any.
+ * 
+ * This is meant for per-iteration temporaries, which must not outlive the `Arena::Scope`.
+ * @see `Arena`
+ */
+template <typename T, Index N = 2>
+using ArenaRaster = Raster<T, N, ArenaHolder<T>>;
+
+/**
+ * @ingroup data_classes
+ * @brief `Raster` whose copies share the data until they are modified.
+ * @see `CowHolder`
+ */
+template <typename T, Index N = 2>
+using CowRaster = Raster<T, N, CowHolder<T>>;
+
+/**
+ * @ingroup data_classes
+ * @brief `Raster` with small-buffer optimization, which allocates nothing up to `Capacity` pixels.
+ * 
+ * Filtering or warping a `SmallRaster` returns a `SmallRaster` of the same capacity,
+ * such that chains of small-raster operations stay on the stack.
+ * @see `SmallHolder`
+ */
+template <typename T, Index N = 2, std::size_t Capacity = 256>
+using SmallRaster = Raster<T, N, SmallHolder<T, Capacity>>;
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the holder of the raster from which some input is computed, if any, or `void`.
+ */
+template <typename TIn, typename = void>
+struct RasterHolderOf {
+  using Type = void;
+};
+
+template <typename TIn>
+struct RasterHolderOf<TIn, std::void_t<typename TIn::Holder>> {
+  using Type = typename TIn::Holder;
+};
+
+template <typename TIn>
+struct RasterHolderOf<TIn, std::void_t<decltype(std::declval<const TIn&>().raster())>> {
+  using Type = typename RasterHolderOf<std::decay_t<decltype(std::declval<const TIn&>().raster())>>::Type;
+};
+
+/**
+ * @brief The type of a raster which is computed from some input, e.g. a raster, extrapolator or interpolator.
+ * @see `SimilarHolder`
+ */
+template <typename TIn, typename U = std::remove_const_t<typename TIn::Value>, Index N = TIn::Dimension>
+using SimilarRaster = Raster<U, N, typename SimilarHolder<typename RasterHolderOf<TIn>::Type, U>::Type>;
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup data_classes
  * @brief Data of a N-dimensional image (2D by default).
@@ -276,7 +353,8 @@ public:
    */
   template <typename... TArgs>
   explicit Raster(Position<N> shape = Position<N>::zero(), TArgs&&... args) :
-      Container(shape_size(shape), std::forward<TArgs>(args)...), m_shape(std::move(shape))
+      Container(shape_size(shape), std::forward<TArgs>(args)...), m_shape(std::move(shape)),
+      m_strides(shape_strides(m_shape))
   {}
 
   /**
@@ -293,7 +371,8 @@ public:
    */
   template <typename... TArgs>
   explicit Raster(Position<N> shape, std::initializer_list<T> list, TArgs&&... args) :
-      Container(list.begin(), list.end(), std::forward<TArgs>(args)...), m_shape(std::move(shape))
+      Container(list.begin(), list.end(), std::forward<TArgs>(args)...), m_shape(std::move(shape)),
+      m_strides(shape_strides(m_shape))
   {
     SizeError::may_throw(this->size(), shape_size(shape));
   }
@@ -312,7 +391,8 @@ public:
    */
   template <typename TRange, typename std::enable_if_t<IsRange<TRange>::value>* = nullptr, typename... TArgs>
   explicit Raster(Position<N> shape, TRange& range, TArgs&&... args) :
-      Container(range.begin(), range.end(), std::forward<TArgs>(args)...), m_shape(std::move(shape))
+      Container(range.begin(), range.end(), std::forward<TArgs>(args)...), m_shape(std::move(shape)),
+      m_strides(shape_strides(m_shape))
   {
     SizeError::may_throw(this->size(), shape_size(shape));
   }
@@ -322,8 +402,69 @@ public:
    * @param patch The box- or grid-based patch to be copied (can be an extrapolator).
    */
   template <typename U, typename TRaster, typename TRegion>
-  explicit Raster(const Patch<U, TRaster, TRegion>& patch) : Raster(patch.domain().shape(), patch)
-  {}
+  explicit Raster(const Patch<U, TRaster, TRegion>& patch) : Raster(patch.domain().shape())
+  {
+    SizeError::may_throw(patch.size(), this->size());
+    auto* out = this->data();
+    patch.for_each_span([&](const auto* in, Index size, Index stride) {
+      if (stride == 1) {
+        out = std::copy_n(in, size, out);
+        return;
+      }
+      for (Index i = 0; i < size; ++i, ++out) {
+        *out = in[i * stride];
+      }
+    });
+  }
+
+  /**
+   * @brief Evaluate a lazy expression in place, in a single loop.
+   * 
+   * The shape is unchanged, and the expression must be of the same size as the raster,
+   * or a `SizeError` is thrown.
+   * @see `Expression`
+   */
+  template <typename TFunc, typename... TArgs>
+  Raster& operator=(const Expression<TFunc, TArgs...>& expression)
+  {
+    SizeError::may_throw(expression.size(), this->size());
+    expression.evaluate(*this);
+    return *this;
+  }
+
+  /**
+   * @brief Convert the values into a raster of another value type.
+   * @param conversion The optional scaling and saturation
+   * 
+   * \code
+   * const auto raw = Fits("frame.fits").read<Raster<std::int16_t>>();
+   * auto physical = raw.cast<float>({1, 32768}); // BSCALE = 1, BZERO = 32768
+   * ...
+   * physical.convert_into(raw, Conversion {1, -32768, true}); // Reuse raw memory, with saturation
+   * \endcode
+   * @see `Conversion`
+   */
+  template <typename U>
+  Raster<U, N> cast(const Conversion& conversion = {}) const
+  {
+    Raster<U, N> out(m_shape, uninitialized);
+    convert_into(out, conversion);
+    return out;
+  }
+
+  /**
+   * @brief Convert the values into an existing raster, e.g. to reuse its memory.
+   * @param out The output raster, of the same size
+   * @param conversion The optional scaling and saturation
+   * @see `cast()`
+   */
+  template <typename U, Index M, typename UHolder>
+  Raster<U, M, UHolder>& convert_into(Raster<U, M, UHolder>& out, const Conversion& conversion = {}) const
+  {
+    SizeError::may_throw(out.size(), this->size());
+    Internal::convert(this->data(), this->size(), out.data(), conversion);
+    return out;
+  }
 
   /// @group_properties
 
@@ -383,6 +524,17 @@ public:
     return m_shape[i];
   }
 
+  /**
+   * @brief Get the index offsets of unit steps along each axis.
+   * 
+   * The index of a position is the dot product of the position and strides,
+   * such that moving along axis `i` by `k` pixels moves the index by `k * strides()[i]`.
+   */
+  const Position<N>& strides() const
+  {
+    return m_strides;
+  }
+
   /// @group_elements
 
   using Container::operator[];
@@ -596,6 +748,11 @@ private:
    * @brief Raster shape, i.e. length along each axis.
    */
   Position<N> m_shape;
+
+  /**
+   * @brief Raster strides, i.e. index offset of a unit step along each axis.
+   */
+  Position<N> m_strides;
 };
 
 /// @cond
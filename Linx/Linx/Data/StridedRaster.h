@@ -0,0 +1,492 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_STRIDEDRASTER_H
+#define _LINXDATA_STRIDEDRASTER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Grid.h"
+#include "Linx/Data/Raster.h"
+
+#include <iterator>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Zero-copy view of a raster region with arbitrary strides, e.g. a non-contiguous box or a grid.
+ * @tparam T The value type, which is constant for read-only views
+ * @tparam N The dimension
+ *
+ * As opposed to a `Patch`, a strided raster is indexed like a raster, i.e. from position 0 to `shape() - 1`,
+ * whatever the region it views.
+ * It supports in-place arithmetic with scalars and ranges, and is accepted as the right-hand side
+ * of the in-place arithmetic operators of rasters, such that sub-boxes need not be copied.
+ * Like `PtrRaster`, it does not own the data, and must not outlive the viewed raster.
+ *
+ * As opposed to `Raster::slice()`, which is restricted to contiguous regions,
+ * any box or grid can be viewed, with a stride per axis:
+ *
+ * \code
+ * Raster<float> frame(...);
+ * auto odd = strided(frame, Grid<2>(frame.domain() + 1, 2)); // Every second pixel along both axes
+ * odd *= 2;
+ * auto dense = odd.copy(); // Contiguous copy
+ * \endcode
+ *
+ * Rows (along axis 0) are processed by pointer increments, which is the fast path of all the methods.
+ *
+ * @see `strided()`
+ */
+template <typename T, Index N = 2>
+class StridedRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief Iterator over the values, in the order of a raster of the same shape.
+   */
+  class Iterator : public std::iterator<std::forward_iterator_tag, T> {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const StridedRaster& raster, Index index) :
+        m_raster(&raster), m_index(index), m_position(Position<N>::zero(raster.m_shape.size())),
+        m_current(raster.m_data)
+    {}
+
+    /**
+     * @brief Get the current value.
+     */
+    T& operator*() const
+    {
+      return *m_current;
+    }
+
+    /**
+     * @brief Get a pointer to the current value.
+     */
+    T* operator->() const
+    {
+      return m_current;
+    }
+
+    /**
+     * @brief Move to the next value.
+     */
+    Iterator& operator++()
+    {
+      ++m_index;
+      const auto& shape = m_raster->m_shape;
+      const auto& strides = m_raster->m_strides;
+      for (std::size_t i = 0; i < shape.size(); ++i) {
+        ++m_position[i];
+        m_current += strides[i];
+        if (m_position[i] < shape[i]) {
+          return *this;
+        }
+        m_current -= m_position[i] * strides[i];
+        m_position[i] = 0;
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Move to the next value.
+     */
+    Iterator operator++(int)
+    {
+      auto out = *this;
+      ++(*this);
+      return out;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same value.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_index == rhs.m_index;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different values.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_index != rhs.m_index;
+    }
+
+  private:
+
+    const StridedRaster* m_raster;
+    Index m_index;
+    Position<N> m_position;
+    T* m_current;
+  };
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param data The pointer to the front value
+   * @param shape The shape
+   * @param strides The distance in memory between two consecutive values along each axis
+   */
+  StridedRaster(T* data, Position<N> shape, Position<N> strides) :
+      m_data(data), m_shape(LINX_MOVE(shape)), m_strides(LINX_MOVE(strides))
+  {}
+
+  /**
+   * @brief Conversion to a read-only view.
+   */
+  operator StridedRaster<const T, N>() const
+  {
+    return StridedRaster<const T, N>(m_data, m_shape, m_strides);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of dimensions.
+   */
+  Index dimension() const
+  {
+    return m_shape.size();
+  }
+
+  /**
+   * @brief Get the shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the length along a given axis.
+   */
+  Index length(Index i) const
+  {
+    return m_shape[i];
+  }
+
+  /**
+   * @brief Get the domain, i.e. the box from position 0 to `shape() - 1`.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(Position<N>::zero(m_shape.size()), m_shape);
+  }
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the strides, in number of values.
+   */
+  const Position<N>& strides() const
+  {
+    return m_strides;
+  }
+
+  /**
+   * @brief Check whether the values are contiguous in memory, in which case they could be viewed as a `PtrRaster`.
+   */
+  bool is_contiguous() const
+  {
+    return m_strides == shape_strides(m_shape);
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get a pointer to the front value.
+   */
+  T* data() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Get the value at given position.
+   */
+  T& operator[](const Position<N>& position) const
+  {
+    Index offset = 0;
+    for (std::size_t i = 0; i < m_shape.size(); ++i) {
+      offset += position[i] * m_strides[i];
+    }
+    return m_data[offset];
+  }
+
+  /**
+   * @brief Apply a function to each row, i.e. to each segment along axis 0.
+   * @param func The function, with signature `func(T* front, Index length, Index stride)`
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func) const
+  {
+    if (size() <= 0) {
+      return;
+    }
+    const auto width = m_shape[0];
+    const auto step = m_strides[0];
+    auto position = Position<N>::zero(m_shape.size());
+    auto* front = m_data;
+    const auto rows = size() / width;
+    for (Index r = 0; r < rows; ++r) {
+      func(front, width, step);
+      for (std::size_t i = 1; i < m_shape.size(); ++i) {
+        ++position[i];
+        front += m_strides[i];
+        if (position[i] < m_shape[i]) {
+          break;
+        }
+        front -= position[i] * m_strides[i];
+        position[i] = 0;
+      }
+    }
+  }
+
+  /// @group_iterators
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  Iterator begin() const
+  {
+    return Iterator(*this, 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  Iterator end() const
+  {
+    return Iterator(*this, size());
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Assign a value to each element.
+   */
+  const StridedRaster& fill(const std::remove_const_t<T>& value) const
+  {
+    return apply([&](auto&) {
+      return value;
+    });
+  }
+
+  /**
+   * @brief Assign the values of a range of same size, e.g. a raster or a patch.
+   */
+  template <typename TRange>
+  const StridedRaster& assign(const TRange& range) const
+  {
+    auto it = range.begin();
+    return apply([&](auto&) {
+      return *it++;
+    });
+  }
+
+  /**
+   * @brief Apply a function to each element, in place.
+   * @param func The function, which takes the current value as argument and returns the new value
+   */
+  template <typename TFunc>
+  const StridedRaster& apply(TFunc&& func) const
+  {
+    for_each_row([&](T* front, Index length, Index step) {
+      for (Index i = 0; i < length; ++i, front += step) {
+        *front = func(*front);
+      }
+    });
+    return *this;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Copy the values into a new contiguous raster.
+   */
+  Raster<std::remove_const_t<T>, N> copy() const
+  {
+    Raster<std::remove_const_t<T>, N> out(m_shape);
+    auto* it = out.data();
+    for_each_row([&](const T* front, Index length, Index step) {
+      for (Index i = 0; i < length; ++i, front += step, ++it) {
+        *it = *front;
+      }
+    });
+    return out;
+  }
+
+  /**
+   * @brief Check whether two views have the same shape and values.
+   */
+  template <typename U>
+  bool operator==(const StridedRaster<U, N>& rhs) const
+  {
+    return m_shape == rhs.shape() && std::equal(begin(), end(), rhs.begin());
+  }
+
+  /**
+   * @brief Check whether two views have different shapes or values.
+   */
+  template <typename U>
+  bool operator!=(const StridedRaster<U, N>& rhs) const
+  {
+    return not(*this == rhs);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The front value.
+   */
+  T* m_data;
+
+  /**
+   * @brief The shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The strides.
+   */
+  Position<N> m_strides;
+};
+
+/**
+ * @relatesalso StridedRaster
+ * @brief View a box of a raster without copy.
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<const T, N> strided(const Raster<T, N, THolder>& in, const Box<N>& region)
+{
+  return StridedRaster<const T, N>(&in[region.front()], region.shape(), shape_strides(in.shape()));
+}
+
+/**
+ * @relatesalso StridedRaster
+ * @copybrief strided(const Raster<T, N, THolder>&,const Box<N>&)
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<T, N> strided(Raster<T, N, THolder>& in, const Box<N>& region)
+{
+  return StridedRaster<T, N>(&in[region.front()], region.shape(), shape_strides(in.shape()));
+}
+
+/**
+ * @relatesalso StridedRaster
+ * @brief View a grid of a raster without copy.
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<const T, N> strided(const Raster<T, N, THolder>& in, const Grid<N>& region)
+{
+  auto strides = shape_strides(in.shape());
+  for (std::size_t i = 0; i < strides.size(); ++i) {
+    strides[i] *= region.step()[i];
+  }
+  return StridedRaster<const T, N>(&in[region.front()], region.shape(), LINX_MOVE(strides));
+}
+
+/**
+ * @relatesalso StridedRaster
+ * @copybrief strided(const Raster<T, N, THolder>&,const Grid<N>&)
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<T, N> strided(Raster<T, N, THolder>& in, const Grid<N>& region)
+{
+  auto strides = shape_strides(in.shape());
+  for (std::size_t i = 0; i < strides.size(); ++i) {
+    strides[i] *= region.step()[i];
+  }
+  return StridedRaster<T, N>(&in[region.front()], region.shape(), LINX_MOVE(strides));
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Apply a binary function to each element of a strided raster and of a range or scalar, in place.
+ */
+template <typename T, Index N, typename TRhs, typename TFunc>
+const StridedRaster<T, N>& strided_apply(const StridedRaster<T, N>& lhs, const TRhs& rhs, TFunc&& func)
+{
+  if constexpr (IsRange<TRhs>::value) {
+    if (Index(std::distance(rhs.begin(), rhs.end())) != lhs.size()) {
+      throw SizeError(std::distance(rhs.begin(), rhs.end()), lhs.size());
+    }
+    auto it = rhs.begin();
+    return lhs.apply([&](const auto& e) {
+      return func(e, *it++);
+    });
+  } else {
+    return lhs.apply([&](const auto& e) {
+      return func(e, rhs);
+    });
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+#define LINX_STRIDED_OPERATOR(op) \
+  /** @relatesalso StridedRaster @brief In-place operator with a scalar or a range of same size. */ \
+  template <typename T, Index N, typename TRhs> \
+  const StridedRaster<T, N>& operator op##=(const StridedRaster<T, N>& lhs, const TRhs& rhs) \
+  { \
+    return Internal::strided_apply(lhs, rhs, [](const auto& e, const auto& f) { \
+      return e op f; \
+    }); \
+  } \
+  /** @relatesalso StridedRaster @brief Raster in-place operator with a strided raster of same shape. */ \
+  template <typename T, Index N, typename THolder, typename U> \
+  Raster<T, N, THolder>& operator op##=(Raster<T, N, THolder>& lhs, const StridedRaster<U, N>& rhs) \
+  { \
+    if (lhs.shape() != rhs.shape()) { \
+      throw SizeError(rhs.size(), lhs.size()); \
+    } \
+    auto* out = lhs.data(); \
+    rhs.for_each_row([&](const U* front, Index length, Index step) { \
+      for (Index i = 0; i < length; ++i, front += step, ++out) { \
+        *out op##= *front; \
+      } \
+    }); \
+    return lhs; \
+  }
+
+LINX_STRIDED_OPERATOR(+)
+LINX_STRIDED_OPERATOR(-)
+LINX_STRIDED_OPERATOR(*)
+LINX_STRIDED_OPERATOR(/)
+
+#undef LINX_STRIDED_OPERATOR
+
+} // namespace Linx
+
+#endif
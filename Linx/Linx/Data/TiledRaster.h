@@ -0,0 +1,298 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_TILEDRASTER_H
+#define _LINXDATA_TILEDRASTER_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, min
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Raster stored as a sequence of hypercubic tiles, for cache-friendly access along any axis.
+ * @tparam T The value type
+ * @tparam N The dimension
+ * @tparam L The tile length along each axis, which must be a power of two
+ * 
+ * As opposed to `Raster`, which is row-major, the data is split into tiles of `L^N` values,
+ * which are contiguous in memory and row-major internally; tiles are themselves ordered row-major.
+ * Neighbors along any axis are therefore close in memory, such that column profiles,
+ * vertical filter passes and transpositions do not thrash the cache.
+ * The default tile length is such that a tile of 4-byte values fits in the L1 cache.
+ * 
+ * Indexing is `Raster`-compatible, i.e. values are accessed by position with `operator[]()`,
+ * which only costs shifts and masks more than `Raster::operator[]()`.
+ * Tiles are accessed as contiguous `PtrRaster`s with `tile()`.
+ * The raster is padded to a whole number of tiles, and the padding values are zero.
+ * 
+ * Conversions from and to row-major rasters are performed row by row, with bulk copies:
+ * 
+ * \code
+ * TiledRaster<float> tiled(raster); // From a row-major raster
+ * ... // Access along axis 1
+ * tiled.copy_to(raster); // Back to row-major
+ * \endcode
+ */
+template <typename T, Index N = 2, Index L = (N == 2 ? 32 : 8)>
+class TiledRaster {
+public:
+
+  static_assert(N > 0, "TiledRaster does not support variable dimension.");
+  static_assert(L > 0 && (L & (L - 1)) == 0, "Tile length must be a power of two.");
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The tile length along each axis.
+   */
+  static constexpr Index TileLength = L;
+
+  /**
+   * @brief The number of values per tile.
+   */
+  static constexpr Index TileSize = [] {
+    Index out = 1;
+    for (Index i = 0; i < N; ++i) {
+      out *= L;
+    }
+    return out;
+  }();
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit TiledRaster(Position<N> shape = Position<N>::zero()) :
+      m_shape(LINX_MOVE(shape)), m_tiles(tile_grid(m_shape)), m_data(shape_size(m_tiles) * TileSize)
+  {}
+
+  /**
+   * @brief Conversion constructor from a contiguous row-major raster.
+   */
+  template <typename U, typename THolder>
+  explicit TiledRaster(const Raster<U, N, THolder>& raster) : TiledRaster(raster.shape())
+  {
+    const auto* in = raster.data();
+    for_each_row(raster, [&](Index tiled, Index row, Index length) {
+      std::copy_n(in + row, length, m_data.data() + tiled);
+    });
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(m_shape);
+  }
+
+  /**
+   * @brief Get the number of tiles along each axis.
+   */
+  const Position<N>& tile_counts() const
+  {
+    return m_tiles;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Compute the raw index of a given position.
+   */
+  inline Index index(const Position<N>& pos) const
+  {
+    Index tile = 0;
+    Index local = 0;
+    for (Index i = N - 1; i >= 0; --i) {
+      tile = tile * m_tiles[i] + (pos[i] >> log2_length);
+      local = local * L + (pos[i] & (L - 1));
+    }
+    return tile * TileSize + local;
+  }
+
+  /**
+   * @brief Access the value at given position.
+   */
+  inline const T& operator[](const Position<N>& pos) const
+  {
+    return m_data[index(pos)];
+  }
+
+  /**
+   * @copybrief operator[]()
+   */
+  inline T& operator[](const Position<N>& pos)
+  {
+    return m_data[index(pos)];
+  }
+
+  /**
+   * @brief Get a pointer to the tiled data.
+   */
+  const T* data() const
+  {
+    return m_data.data();
+  }
+
+  /**
+   * @copybrief data()const
+   */
+  T* data()
+  {
+    return m_data.data();
+  }
+
+  /// @group_views
+
+  /**
+   * @brief Get a tile, including padding, as a contiguous raster.
+   * @param position The tile position, in tiles
+   */
+  PtrRaster<const T, N> tile(const Position<N>& position) const
+  {
+    return PtrRaster<const T, N>(Position<N>().fill(L), m_data.data() + tile_index(position) * TileSize);
+  }
+
+  /**
+   * @copybrief tile()const
+   */
+  PtrRaster<T, N> tile(const Position<N>& position)
+  {
+    return PtrRaster<T, N>(Position<N>().fill(L), m_data.data() + tile_index(position) * TileSize);
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Copy the values into a contiguous row-major raster of the same shape.
+   */
+  template <typename U, typename THolder>
+  Raster<U, N, THolder>& copy_to(Raster<U, N, THolder>& raster) const
+  {
+    if (raster.shape() != m_shape) {
+      throw SizeError(shape_size(raster.shape()), shape_size(m_shape));
+    }
+    auto* out = raster.data();
+    for_each_row(raster, [&](Index tiled, Index row, Index length) {
+      std::copy_n(m_data.data() + tiled, length, out + row);
+    });
+    return raster;
+  }
+
+  /**
+   * @brief Copy the values into a new row-major raster.
+   */
+  Raster<T, N> raster() const
+  {
+    Raster<T, N> out(m_shape);
+    copy_to(out);
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The base-2 logarithm of the tile length.
+   */
+  static constexpr Index log2_length = [] {
+    Index out = 0;
+    while ((Index(1) << out) < L) {
+      ++out;
+    }
+    return out;
+  }();
+
+  /**
+   * @brief Compute the number of tiles along each axis.
+   */
+  static Position<N> tile_grid(const Position<N>& shape)
+  {
+    Position<N> out;
+    for (Index i = 0; i < N; ++i) {
+      out[i] = (shape[i] + L - 1) / L;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the index of a tile.
+   */
+  Index tile_index(const Position<N>& position) const
+  {
+    Index out = 0;
+    for (Index i = N - 1; i >= 0; --i) {
+      out = out * m_tiles[i] + position[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Apply a function to each pair of tile row and raster row.
+   * @param raster The row-major raster
+   * @param func The function, called as `func(tiled_index, raster_index, length)`
+   */
+  template <typename TRaster, typename TFunc>
+  void for_each_row(const TRaster& raster, TFunc&& func) const
+  {
+    for (const auto& tile : Box<N>::from_shape(m_tiles)) {
+      auto front = tile;
+      auto back = tile;
+      for (Index i = 0; i < N; ++i) {
+        front[i] *= L;
+        back[i] = std::min(front[i] + L, m_shape[i]) - 1;
+      }
+      const auto length = back[0] - front[0] + 1;
+      back[0] = front[0];
+      for (const auto& pos : Box<N>(front, back)) {
+        func(index(pos), raster.index(pos), length);
+      }
+    }
+  }
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The number of tiles along each axis.
+   */
+  Position<N> m_tiles;
+
+  /**
+   * @brief The tiled data.
+   */
+  std::vector<T> m_data;
+};
+
+} // namespace Linx
+
+#endif
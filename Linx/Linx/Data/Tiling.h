@@ -5,9 +5,14 @@
 #ifndef _LINXDATA_TILING_H
 #define _LINXDATA_TILING_H
 
+#include "Linx/Base/Threads.h"
 #include "Linx/Data/Grid.h"
 #include "Linx/Data/Raster.h"
 
+#include <algorithm> // max, min
+#include <type_traits>
+#include <vector>
+
 namespace Linx {
 
 /// @cond
@@ -164,6 +169,261 @@ auto rasterize(const Internal::RowGenerator<TParent>& generator)
   return generator.raster();
 }
 
+/**
+ * @ingroup regions
+ * @brief A tile with a halo, for block processing with a sliding window.
+ * @see `halo_tiles()`
+ */
+template <Index N>
+struct HaloTile {
+  /**
+   * @brief The tile box, i.e. the region to be processed.
+   */
+  Box<N> inner;
+
+  /**
+   * @brief The tile box extended by the halo, i.e. the region to be read.
+   */
+  Box<N> outer;
+
+  /**
+   * @brief Whether the outer box crosses the domain border, i.e. requires extrapolation.
+   */
+  bool is_border;
+};
+
+/**
+ * @ingroup regions
+ * @brief Partition a domain into tiles with a halo.
+ * @param domain The domain
+ * @param shape The tile shape
+ * @param halo The halo, e.g. the bounding box of a filter window, relative to its center
+ * 
+ * The inner boxes partition the domain as `tiles()` does, i.e. they are clamped at the upper domain limits.
+ * The outer boxes are the inner boxes extended by the halo, without clamping,
+ * such that a tile is a border tile if its outer box is not included in the domain.
+ * Tiles are ordered row-major.
+ * 
+ * Inner tiles can be processed with some fast kernel which reads the raster directly,
+ * and only border tiles need an extrapolator:
+ * 
+ * \code
+ * const auto window = Box<2>::from_center(radius);
+ * for_each_tile(halo_tiles(in.domain(), {256, 256}, window), [&](const auto& tile) {
+ *   if (tile.is_border) {
+ *     ... // Filter extrapolation(in)(tile.inner)
+ *   } else {
+ *     ... // Filter in(tile.inner)
+ *   }
+ * }, Threads());
+ * \endcode
+ */
+template <Index N, Index M>
+std::vector<HaloTile<N>> halo_tiles(const Box<N>& domain, const Position<N>& shape, const Box<M>& halo)
+{
+  std::vector<HaloTile<N>> out;
+  if (domain.size() <= 0) {
+    return out;
+  }
+  const Grid<N> fronts(domain, shape);
+  out.reserve(fronts.size());
+  for (const auto& front : fronts) {
+    auto inner = Box<N>::from_shape(front, shape) & domain;
+    auto outer = inner + halo;
+    const auto is_border = not(outer <= domain);
+    out.push_back({LINX_MOVE(inner), LINX_MOVE(outer), is_border});
+  }
+  return out;
+}
+
+/**
+ * @ingroup regions
+ * @brief Apply a function to each tile of a list, concurrently.
+ * @param tiles The tiles
+ * @param func The function, which takes a tile as argument
+ * @param threads The threads
+ * 
+ * Tiles are distributed dynamically, such that the slower border tiles do not unbalance the threads.
+ * The function must be thread-safe, e.g. write to disjoint regions of a raster.
+ */
+template <typename TTile, typename TFunc>
+void for_each_tile(const std::vector<TTile>& tiles, TFunc&& func, const Threads& threads = Threads())
+{
+  const auto count = static_cast<Index>(tiles.size());
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+  for (Index i = 0; i < count; ++i) {
+    func(tiles[i]);
+  }
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the axis along which adjacent profiles of a panel are taken.
+ */
+template <Index I>
+constexpr Index panel_axis()
+{
+  return I == 0 ? 1 : 0;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup regions
+ * @brief Copy adjacent `I`-th profiles of a raster into a panel.
+ * @tparam I The index of the profile axis
+ * @param in The raster
+ * @param front The front of the first profile, whose `I`-th coordinate is ignored
+ * @param panel The panel, of shape `{length, count}`, where `length` is the `I`-th raster length
+ *
+ * The `k`-th row of the panel is the profile at `front` shifted by `k` along the panel axis,
+ * i.e. axis 0 if `I > 0`, and axis 1 otherwise.
+ * The panel is therefore a transposed copy, in which profiles are contiguous.
+ *
+ * @see `for_each_panel()`
+ */
+template <Index I, typename T, Index N, typename THolder, typename TPanel>
+TPanel& read_panel(const Raster<T, N, THolder>& in, const Position<N>& front, TPanel& panel)
+{
+  constexpr auto J = Internal::panel_axis<I>();
+  const auto length = panel.length(0);
+  const auto count = panel.length(1);
+  const auto stride = in.strides()[I];
+  const auto jump = count > 1 ? in.strides()[J] : 0;
+  auto f = front;
+  f[I] = 0;
+  const auto* src = &in[f];
+  auto* dst = panel.data();
+  for (Index q = 0; q < length; ++q, src += stride) { // Read contiguous values if I > 0
+    for (Index k = 0; k < count; ++k) {
+      dst[k * length + q] = src[k * jump];
+    }
+  }
+  return panel;
+}
+
+/**
+ * @ingroup regions
+ * @brief Copy a panel back into the adjacent `I`-th profiles of a raster.
+ * @see `read_panel()`
+ */
+template <Index I, typename TPanel, typename T, Index N, typename THolder>
+Raster<T, N, THolder>& write_panel(const TPanel& panel, const Position<N>& front, Raster<T, N, THolder>& out)
+{
+  constexpr auto J = Internal::panel_axis<I>();
+  const auto length = panel.length(0);
+  const auto count = panel.length(1);
+  const auto stride = out.strides()[I];
+  const auto jump = count > 1 ? out.strides()[J] : 0;
+  auto f = front;
+  f[I] = 0;
+  auto* dst = &out[f];
+  const auto* src = panel.data();
+  for (Index q = 0; q < length; ++q, dst += stride) { // Write contiguous values if I > 0
+    for (Index k = 0; k < count; ++k) {
+      dst[k * jump] = src[k * length + q];
+    }
+  }
+  return out;
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Apply a function to the panels of a raster, and optionally write them back.
+ */
+template <Index I, bool Write, typename TRaster, typename TFunc>
+void for_each_panel_impl(TRaster& raster, Index width, TFunc&& func, const Threads& threads)
+{
+  using Value = std::remove_cv_t<typename TRaster::Value>;
+  constexpr auto N = TRaster::Dimension;
+  constexpr auto J = panel_axis<I>();
+  if (raster.size() == 0) {
+    return;
+  }
+  const auto dimension = raster.dimension();
+  const auto domain = raster.domain();
+  const auto length = raster.length(I);
+  const auto breadth = J < dimension ? raster.length(J) : Index(1);
+  width = std::max(Index(1), std::min(width, breadth));
+  auto step = Position<N>::one(dimension);
+  step[I] = length;
+  if (J < dimension) {
+    step[J] = width;
+  }
+  const auto grid = Grid<N>(domain, step);
+  const std::vector<Position<N>> fronts(grid.begin(), grid.end());
+  const auto size = static_cast<Index>(fronts.size());
+#pragma omp parallel num_threads(threads.count())
+  {
+    Raster<Value, 2> panel({length, width});
+    Raster<Value, 2> last; // Narrower panel at the upper limit of the panel axis, if any
+#pragma omp for schedule(static)
+    for (Index i = 0; i < size; ++i) {
+      const auto& front = fronts[i];
+      const auto count = J < dimension ? std::min(width, breadth - front[J]) : Index(1);
+      if (count != width && last.length(1) != count) {
+        last = Raster<Value, 2>({length, count});
+      }
+      auto& p = count == width ? panel : last;
+      read_panel<I>(raster, front, p);
+      func(p, front);
+      if constexpr (Write) {
+        write_panel<I>(p, front, raster);
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup regions
+ * @brief Process the `I`-th profiles of a raster by panels of adjacent profiles.
+ * @tparam I The index of the profile axis
+ * @param raster The raster
+ * @param width The maximum number of profiles per panel
+ * @param func The function, called as `func(panel, front)`
+ * @param threads The threads
+ *
+ * The raster is partitioned into panels of up to `width` adjacent profiles (see `read_panel()`),
+ * which are copied into a small contiguous buffer, processed by the function and written back.
+ * In the buffer, the profiles are contiguous rows, such that per-profile operations along some axis `I > 0`,
+ * like 1D filters or cumulative sums, run at row speed, while the copies read and write the raster by rows.
+ * The width should be chosen such that the panel fits in cache, e.g. 8 to 64.
+ * Panels are processed concurrently, each thread owning a buffer.
+ *
+ * \code
+ * for_each_panel<1>(raster, 16, [](auto& panel, const auto&) {
+ *   for (auto& profile : rows(panel)) {
+ *     std::partial_sum(profile.begin(), profile.end(), profile.begin());
+ *   }
+ * }, Threads());
+ * \endcode
+ *
+ * If the raster is constant, the panels are not written back.
+ */
+template <Index I, typename T, Index N, typename THolder, typename TFunc>
+void for_each_panel(Raster<T, N, THolder>& raster, Index width, TFunc&& func, const Threads& threads = Threads(1))
+{
+  Internal::for_each_panel_impl<I, not std::is_const_v<T>>(raster, width, LINX_FORWARD(func), threads);
+}
+
+/**
+ * @ingroup regions
+ * @copybrief for_each_panel()
+ */
+template <Index I, typename T, Index N, typename THolder, typename TFunc>
+void for_each_panel(const Raster<T, N, THolder>& raster, Index width, TFunc&& func, const Threads& threads = Threads(1))
+{
+  Internal::for_each_panel_impl<I, false>(raster, width, LINX_FORWARD(func), threads);
+}
+
 } // namespace Linx
 
 #include "Linx/Data/impl/ProfileGenerator.h"
@@ -15,22 +15,44 @@
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The holder of a vector.
+ * 
+ * Variable-dimension vectors store up to 8 values inline instead of allocating them.
+ */
+template <typename T, Index N>
+struct VectorHolder {
+  using Type = StdHolder<Coordinates<T, N>>;
+};
+
+template <typename T>
+struct VectorHolder<T, -1> {
+  using Type = SmallHolder<T, 8>;
+};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup data_classes
  * @brief N-dimensional vector, mainly intended for pixel position or image shape, i.e. set of coordinates.
  * @tparam N A non-negative dimension (0 is allowed), or -1 for variable dimension.
  * 
  * The values are stored in a `std::array<T, N>` in general (`N &ge; 0`),
- * or `std::vector<T>` for variable dimension (`N = -1`).
+ * or in a `SmallHolder` for variable dimension (`N = -1`), which allocates only above dimension 8.
  *
- * Memory and services are optimized when dimension is fixed at compile-time (`N &ge; 0`).
+ * Memory and services are optimized when dimension is fixed at compile-time (`N &ge; 0`),
+ * and element-wise arithmetic is unrolled up to dimension 4.
  * 
  * @tspecialization{Position}
  */
 template <typename T, Index N = 2>
 class Vector :
     public Dimensional<N>,
-    public DataContainer<T, StdHolder<Coordinates<T, N>>, VectorArithmetic, Vector<T, N>> {
+    public DataContainer<T, typename Internal::VectorHolder<T, N>::Type, VectorArithmetic, Vector<T, N>> {
 public:
 
   /**
@@ -41,7 +63,7 @@ public:
   /**
    * @brief The container type.
    */
-  using Container = DataContainer<T, StdHolder<Coordinates<T, N>>, VectorArithmetic, Vector<T, N>>;
+  using Container = DataContainer<T, typename Internal::VectorHolder<T, N>::Type, VectorArithmetic, Vector<T, N>>;
 
   LINX_VIRTUAL_DTOR(Vector)
   LINX_DEFAULT_COPYABLE(Vector)
@@ -263,6 +285,22 @@ Index shape_stride(const Position<N>& shape)
   return shape_stride(shape, Axis);
 }
 
+/**
+ * @relatesalso Position
+ * @brief Get the strides along all axes.
+ */
+template <Index N>
+Position<N> shape_strides(const Position<N>& shape)
+{
+  Position<N> out(shape.size());
+  Index s = 1;
+  for (std::size_t i = 0; i < shape.size(); ++i) {
+    out[i] = s;
+    s = shape[i] > 0 ? s * shape[i] : 0;
+  }
+  return out;
+}
+
 /**
  * @relatesalso Position
  * @brief Compute the number of pixels in a given shape.
@@ -76,16 +76,22 @@ public:
    */
   Iterator& operator++()
   {
-    if (m_current == m_region.back()) { // TODO simpler?
-      m_current = end_position(m_region);
+    const auto& front = m_region.front();
+    const auto& back = m_region.back();
+    ++m_current[0];
+    if (m_current[0] <= back[0]) { // Fast path: no carry
       return *this;
     }
-    ++m_current[0];
-    for (std::size_t i = 0; i < m_current.size() - 1; ++i) {
-      if (m_current[i] > m_region.back()[i]) {
-        m_current[i] = m_region.front()[i];
-        ++m_current[i + 1];
+    const auto last = m_current.ssize() - 1;
+    for (Index i = 0; i < last; ++i) {
+      if (m_current[i] <= back[i]) {
+        return *this;
       }
+      m_current[i] = front[i];
+      ++m_current[i + 1];
+    }
+    if (m_current[last] > back[last]) {
+      m_current = end_position(m_region);
     }
     return *this;
   }
@@ -16,13 +16,12 @@ private:
   /**
    * @brief Constructor.
    */
-  explicit Iterator(const Mask<N>& region, const bool* current) :
-      m_flag_it(current), m_flag_end(region.m_flags.end()),
-      m_current(region.m_box, Box<N>::Iterator::begin_position(region.m_box))
+  explicit Iterator(const Mask<N>& region, const Run* run) :
+      m_run(run), m_end(region.runs().data() + region.runs().size()), m_offset(0), m_front(region.m_box.front()),
+      m_current(m_front)
   {
-    while (m_flag_it != m_flag_end && not *m_flag_it) {
-      ++m_flag_it;
-      ++m_current;
+    if (m_run != m_end) {
+      m_current += m_run->front;
     }
   }
 
@@ -33,7 +32,7 @@ public:
    */
   static Iterator begin(const Mask<N>& region)
   {
-    return Iterator(region, region.m_flags.begin());
+    return Iterator(region, region.runs().data());
   }
 
   /**
@@ -41,7 +40,7 @@ public:
    */
   static Iterator end(const Mask<N>& region)
   {
-    return Iterator(region, region.m_flags.end());
+    return Iterator(region, region.runs().data() + region.runs().size());
   }
 
   /**
@@ -49,7 +48,7 @@ public:
    */
   const Position<N>& operator*() const
   {
-    return *m_current;
+    return m_current;
   }
 
   /**
@@ -57,7 +56,7 @@ public:
    */
   const Position<N>* operator->() const
   {
-    return &*m_current;
+    return &m_current;
   }
 
   /**
@@ -65,10 +64,16 @@ public:
    */
   Iterator& operator++()
   {
-    do {
-      ++m_flag_it;
-      ++m_current;
-    } while (m_flag_it != m_flag_end && not *m_flag_it);
+    ++m_offset;
+    if (m_offset < m_run->length) {
+      ++m_current[0];
+      return *this;
+    }
+    m_offset = 0;
+    ++m_run;
+    if (m_run != m_end) {
+      m_current = m_front + m_run->front;
+    }
     return *this;
   }
 
@@ -87,7 +92,7 @@ public:
    */
   bool operator==(const Iterator& rhs) const
   {
-    return m_flag_it == rhs.m_flag_it;
+    return m_run == rhs.m_run && m_offset == rhs.m_offset;
   }
 
   /**
@@ -95,24 +100,35 @@ public:
    */
   bool operator!=(const Iterator& rhs) const
   {
-    return m_flag_it != rhs.m_flag_it;
+    return not(*this == rhs);
   }
 
 private:
 
   /**
-   * @brief The current flag iterator.
+   * @brief The current run.
+   */
+  const Run* m_run;
+
+  /**
+   * @brief The run end.
    */
-  const bool* m_flag_it;
+  const Run* m_end;
+
+  /**
+   * @brief The offset in the current run.
+   */
+  Index m_offset;
+
   /**
-   * @brief The flag iterator end.
+   * @brief The bounding box front.
    */
-  const bool* m_flag_end;
+  Position<N> m_front;
 
   /**
-   * @brief The current box iterator.
+   * @brief The current position.
    */
-  typename Box<N>::Iterator m_current;
+  Position<N> m_current;
 };
 
 } // namespace Linx
@@ -52,6 +52,24 @@ public:
   {
     return begin<T>(parent, region) + region.size();
   }
+
+  template <typename T>
+  Iterator<T> begin_at(T* front, std::size_t) const
+  {
+    return front;
+  }
+
+  template <typename T>
+  Iterator<T> end_at(T* front, std::size_t size) const
+  {
+    return front + size;
+  }
+
+  template <typename T, typename TFunc>
+  void for_each_span(TParent& parent, const TRegion& region, TFunc&& func) const
+  {
+    func(begin<T>(parent, region), Index(region.size()), Index(1));
+  }
 };
 
 /**
@@ -94,6 +112,17 @@ public:
   {
     return Iterator<T>(parent, region.end());
   }
+
+  /**
+   * @brief Apply a function to each pixel, as a span of size 1.
+   */
+  template <typename T, typename TFunc>
+  void for_each_span(TParent& parent, const TRegion& region, TFunc&& func) const
+  {
+    for (const auto& p : region) {
+      func(&parent[p], Index(1), Index(1));
+    }
+  }
 };
 
 /**
@@ -134,7 +163,8 @@ public:
    * @brief Constructor for grids.
    */
   StrideBasedIndexing(const TParent& parent, const Grid<TParent::Dimension>& region) :
-      m_step(region.step()[0]), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1)
+      m_step(region.step()[0]), m_width(m_step * (region.length(0) - 1) + 1),
+      m_offsets(region.size() / std::max(region.length(0), 1L) + 1)
   // for max and +1 see above
   {
     if (region.size() <= 0) { // FIXME needed?
@@ -161,7 +191,7 @@ public:
   template <typename T>
   Iterator<T> begin(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data());
+    return begin_at<T>(&raster[region.front()], region.size());
   }
 
   /**
@@ -170,7 +200,42 @@ public:
   template <typename T>
   Iterator<T> end(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data() + m_offsets.size() - 1);
+    return end_at<T>(&raster[region.front()], region.size());
+  }
+
+  /**
+   * @brief Get an iterator to the beginning, given a pointer to the front pixel.
+   */
+  template <typename T>
+  Iterator<T> begin_at(T* front, std::size_t) const
+  {
+    return Iterator<T>(front, m_step, m_width, m_offsets.data());
+  }
+
+  /**
+   * @brief Get an iterator to the end, given a pointer to the front pixel.
+   */
+  template <typename T>
+  Iterator<T> end_at(T* front, std::size_t) const
+  {
+    return Iterator<T>(front, m_step, m_width, m_offsets.data() + m_offsets.size() - 1);
+  }
+
+  /**
+   * @brief Apply a function to each row.
+   */
+  template <typename T, typename TFunc>
+  void for_each_span(TParent& raster, const TRegion& region, TFunc&& func) const
+  {
+    if (region.size() <= 0) {
+      return;
+    }
+    T* front = &raster[region.front()];
+    const auto size = (m_width - 1) / m_step + 1;
+    const auto* end = m_offsets.data() + m_offsets.size() - 1;
+    for (const auto* offset = m_offsets.data(); offset != end; ++offset) {
+      func(front + *offset, size, m_step);
+    }
   }
 
 private:
@@ -227,7 +292,7 @@ public:
   template <typename T>
   Iterator<T> begin(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[box(region).front()], m_offsets.data());
+    return begin_at<T>(&raster[box(region).front()], region.size());
   }
 
   /**
@@ -236,7 +301,38 @@ public:
   template <typename T>
   Iterator<T> end(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[box(region).front()], m_offsets.data() + m_offsets.size() - 1);
+    return end_at<T>(&raster[box(region).front()], region.size());
+  }
+
+  /**
+   * @brief Get an iterator to the beginning, given a pointer to the bounding box front.
+   */
+  template <typename T>
+  Iterator<T> begin_at(T* front, std::size_t) const
+  {
+    return Iterator<T>(front, m_offsets.data());
+  }
+
+  /**
+   * @brief Get an iterator to the end, given a pointer to the bounding box front.
+   */
+  template <typename T>
+  Iterator<T> end_at(T* front, std::size_t) const
+  {
+    return Iterator<T>(front, m_offsets.data() + m_offsets.size() - 1);
+  }
+
+  /**
+   * @brief Apply a function to each pixel, as a span of size 1.
+   */
+  template <typename T, typename TFunc>
+  void for_each_span(TParent& raster, const TRegion& region, TFunc&& func) const
+  {
+    T* front = &raster[box(region).front()];
+    const auto* end = m_offsets.data() + m_offsets.size() - 1;
+    for (const auto* offset = m_offsets.data(); offset != end; ++offset) {
+      func(front + *offset, Index(1), Index(1));
+    }
   }
 
 private:
@@ -247,6 +343,106 @@ private:
   std::vector<Index> m_offsets;
 };
 
+/**
+ * @brief Indexing of run-length encoded regions, based on the offsets and lengths of the runs.
+ */
+template <typename TParent, typename TRegion>
+class RunBasedIndexing {
+public:
+
+  /**
+   * @brief The patch iterator.
+   */
+  template <typename T>
+  class Iterator;
+
+  /**
+   * @brief Default constructor.
+   */
+  RunBasedIndexing() : m_offsets(1, 0), m_lengths(1, 0) {}
+
+  /**
+   * @brief Constructor.
+   */
+  RunBasedIndexing(const TParent& parent, const TRegion& region) : RunBasedIndexing()
+  {
+    const auto& runs = region.runs();
+    m_offsets.resize(runs.size() + 1, 0); // +1 in order to dereference m_offsets.end() in iterator
+    m_lengths.resize(runs.size() + 1, 0);
+    auto* offset = m_offsets.data();
+    auto* length = m_lengths.data();
+    for (const auto& r : runs) {
+      *offset++ = parent.index(r.front);
+      *length++ = r.length;
+    }
+  }
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  template <typename T>
+  Iterator<T> begin(TParent& raster, const TRegion& region) const
+  {
+    return begin_at<T>(&raster[box(region).front()], 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  template <typename T>
+  Iterator<T> end(TParent& raster, const TRegion& region) const
+  {
+    return end_at<T>(&raster[box(region).front()], 0);
+  }
+
+  /**
+   * @brief Get an iterator to the beginning, given a pointer to the bounding box front.
+   */
+  template <typename T>
+  Iterator<T> begin_at(T* front, std::size_t) const
+  {
+    return Iterator<T>(front, m_offsets.data(), m_lengths.data());
+  }
+
+  /**
+   * @brief Get an iterator to the end, given a pointer to the bounding box front.
+   */
+  template <typename T>
+  Iterator<T> end_at(T* front, std::size_t) const
+  {
+    const auto last = m_offsets.size() - 1;
+    return Iterator<T>(front, m_offsets.data() + last, m_lengths.data() + last);
+  }
+
+  /**
+   * @brief Apply a function to each run.
+   */
+  template <typename T, typename TFunc>
+  void for_each_span(TParent& raster, const TRegion& region, TFunc&& func) const
+  {
+    const auto count = m_offsets.size() - 1;
+    if (count == 0) {
+      return;
+    }
+    T* front = &raster[box(region).front()];
+    for (std::size_t i = 0; i < count; ++i) {
+      func(front + m_offsets[i], m_lengths[i], Index(1));
+    }
+  }
+
+private:
+
+  /**
+   * @brief The run offsets relative to the bounding box front.
+   */
+  std::vector<Index> m_offsets;
+
+  /**
+   * @brief The run lengths.
+   */
+  std::vector<Index> m_lengths;
+};
+
 template <typename TParent, typename TRegion, bool IsContiguous = false>
 struct PatchTraits {
   /**
@@ -309,7 +505,7 @@ struct PatchTraits<Raster<T, N, THolder>, Line<I, N>> {
 template <typename T, Index N, typename THolder>
 struct PatchTraits<Raster<T, N, THolder>, Mask<N>> {
   template <typename UParent, typename URegion>
-  using Indexing = OffsetBasedIndexing<UParent, URegion>;
+  using Indexing = RunBasedIndexing<UParent, URegion>;
 };
 
 /// @endcond
@@ -217,6 +217,109 @@ private:
   const Index* m_current;
 };
 
+template <typename TParent, typename TRegion>
+template <typename T>
+class RunBasedIndexing<TParent, TRegion>::Iterator : public std::iterator<std::forward_iterator_tag, T> {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief Constructor.
+   */
+  Iterator(Value* front, const Index* offset, const Index* length) :
+      m_front(front), m_current(front + *offset), m_eol(m_current + *length), m_offset_it(offset),
+      m_length_it(length)
+  {}
+
+  /**
+   * @brief Dereference operator.
+   */
+  Value& operator*() const
+  {
+    return *m_current;
+  }
+
+  /**
+   * @brief Arrow operator.
+   */
+  Value* operator->() const
+  {
+    return m_current;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator& operator++()
+  {
+    ++m_current;
+    if (m_current < m_eol) {
+      return *this;
+    }
+    m_current = m_front + *(++m_offset_it);
+    // The sentinel run is empty, see m_offset_it for dereferencing
+    m_eol = m_current + *(++m_length_it);
+    return *this;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator operator++(int)
+  {
+    auto out = *this;
+    ++(*this);
+    return out;
+  }
+
+  /**
+   * @brief Equality operator.
+   */
+  bool operator==(const Iterator& rhs) const
+  {
+    return m_current == rhs.m_current && m_offset_it == rhs.m_offset_it;
+  }
+
+  /**
+   * @brief Non equality operator.
+   */
+  bool operator!=(const Iterator& rhs) const
+  {
+    return not(*this == rhs);
+  }
+
+private:
+
+  /**
+   * @brief The bounding box front pointer.
+   */
+  Value* m_front;
+
+  /**
+   * @brief The current pointer.
+   */
+  Value* m_current;
+
+  /**
+   * @brief The current end of run pointer.
+   */
+  Value* m_eol;
+
+  /**
+   * @brief The current run offset iterator.
+   */
+  const Index* m_offset_it;
+
+  /**
+   * @brief The current run length iterator.
+   */
+  const Index* m_length_it;
+};
+
 } // namespace Linx
 
 #endif
@@ -10,6 +10,7 @@
 
 #include <functional> // multiplies
 #include <numeric> // accumulate
+#include <utility> // index_sequence
 
 namespace Linx {
 
@@ -17,52 +18,61 @@ namespace Linx {
 namespace Internal {
 
 /**
- * @brief nD-index recursive implementation.
+ * @brief nD-index implementation as the dot product of the position and strides.
  * @tparam N The raster dimension.
- * @tparam i The dimension of the current recursion step, should be initialized with `N - 1`.
+ * 
+ * The product is unrolled for fixed dimensions, and the stride along axis 0 (always 1) is skipped.
  */
-template <Index N, Index I = N - 1>
-struct IndexRecursionImpl {
+template <Index N>
+struct StrideIndexImpl {
+  /**
+   * @brief pos[0] + strides[1] * pos[1] + strides[2] * pos[2] + ...
+   */
+  static Index index(const Position<N>& strides, const Position<N>& pos)
+  {
+    return index(strides, pos, std::make_index_sequence<N - 1>());
+  }
+
   /**
-   * @brief Index of given position in given shape for Raster::index.
+   * @brief Unrolled implementation.
    */
-  static Index index(const Position<N>& shape, const Position<N>& pos)
+  template <std::size_t... Is>
+  static Index index(const Position<N>& strides, const Position<N>& pos, std::index_sequence<Is...>)
   {
-    return std::get<N - 1 - I>(pos.container()) +
-        std::get<N - 1 - I>(shape.container()) * IndexRecursionImpl<N, I - 1>::index(shape, pos);
+    return (std::get<0>(pos.container()) + ... +
+            (std::get<Is + 1>(strides.container()) * std::get<Is + 1>(pos.container())));
   }
 };
 
 /**
- * @brief Terminal case: dimension 0.
+ * @brief Dimension 0 case.
  */
-template <Index N>
-struct IndexRecursionImpl<N, 0> {
+template <>
+struct StrideIndexImpl<0> {
   /**
-   * @brief pos[N - 1]
+   * @brief 0
    */
-  static Index index(const Position<N>& shape, const Position<N>& pos)
+  static Index index(const Position<0>&, const Position<0>&)
   {
-    (void)(shape);
-    return std::get<N - 1>(pos.container());
+    return 0;
   }
 };
 
 /**
  * @brief Variable dimension case.
  */
-template <Index I>
-struct IndexRecursionImpl<-1, I> {
+template <>
+struct StrideIndexImpl<-1> {
   /**
-   * @brief pos[0] + shape[1] * (pos[1] + shape[2] * (pos[2] + shape[3] * (...)))
+   * @brief pos[0] + strides[1] * pos[1] + strides[2] * pos[2] + ...
    */
-  static Index index(const Position<-1>& shape, const Position<-1>& pos)
+  static Index index(const Position<-1>& strides, const Position<-1>& pos)
   {
-    const auto n = shape.size();
+    const auto n = strides.size();
     SizeError::may_throw(pos.size(), n);
     Index res = 0;
-    for (std::size_t j = 0; j < shape.size(); ++j) {
-      res = pos[n - 1 - j] + shape[n - 1 - j] * res;
+    for (std::size_t j = 0; j < n; ++j) {
+      res += strides[j] * pos[j];
     }
     return res;
   }
@@ -101,7 +111,7 @@ inline Index Raster<T, N, THolder>::length() const
 template <typename T, Index N, typename THolder>
 inline Index Raster<T, N, THolder>::index(const Position<N>& pos) const
 {
-  return Internal::IndexRecursionImpl<N>::index(m_shape, pos);
+  return Internal::StrideIndexImpl<N>::index(m_strides, pos);
 }
 
 template <typename T, Index N, typename THolder>
@@ -113,6 +123,7 @@ inline const T& Raster<T, N, THolder>::operator[](const Position<N>& pos) const
 template <typename T, Index N, typename THolder>
 inline T& Raster<T, N, THolder>::operator[](const Position<N>& pos)
 {
+  Internal::detach(*this);
   return const_cast<T&>(const_cast<const Raster&>(*this)[pos]);
 }
 
@@ -134,6 +145,7 @@ inline const T& Raster<T, N, THolder>::at(const Position<N>& pos) const
 template <typename T, Index N, typename THolder>
 inline T& Raster<T, N, THolder>::at(const Position<N>& pos)
 {
+  Internal::detach(*this);
   return const_cast<T&>(const_cast<const Raster&>(*this).at(pos));
 }
 
@@ -5,11 +5,15 @@
 #ifndef _LINX_IO_H
 #define _LINX_IO_H
 
+#include "Linx/Base/Threads.h"
 #include "Linx/Io/Fits.h"
+#include "Linx/Io/Raw.h"
 #include "Linx/Io/Temporary.h"
 
+#include <exception> // exception_ptr
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace Linx {
 
@@ -39,6 +43,87 @@ void write(const TRaster& in, const std::filesystem::path& path, char mode = 'x'
   }
 }
 
+/**
+ * @brief Read rasters from several files concurrently.
+ * @param paths The file paths
+ * @param index The (0-based) HDU index in each file
+ * @param threads The threading policy, which distributes the files among the threads
+ * 
+ * Each file is read through its own CFITSIO handle, such that I/O latencies overlap, e.g. on network file systems.
+ * Unless CFITSIO is built reentrant, a single thread should be used.
+ * If some read fails, the first exception is rethrown after all the reads complete.
+ */
+template <typename T, Index N = 2, typename TPaths>
+std::vector<Raster<T, N>> read_each(const TPaths& paths, Index index = 0, const Threads& threads = Threads(1))
+{
+  const std::vector<std::filesystem::path> list(std::begin(paths), std::end(paths));
+  std::vector<Raster<T, N>> out(list.size());
+  std::exception_ptr error;
+  const Index count = list.size();
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+  for (Index i = 0; i < count; ++i) {
+    try {
+      out[i] = read<T, N>(list[i], index);
+    } catch (...) {
+#pragma omp critical
+      if (not error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return out;
+}
+
+/**
+ * @brief Read rasters of the same shape from several files concurrently, as a stack.
+ * @param paths The file paths
+ * @param index The (0-based) HDU index in each file
+ * @param threads The threading policy, which distributes the files among the threads
+ * 
+ * Section `i` of the output is the raster of file `i`.
+ * The stack is allocated once, and each raster is read directly into its section.
+ * An exception is thrown if the shapes differ.
+ * @see `read_each()`
+ */
+template <typename T, Index N = 2, typename TPaths>
+Raster<T, N + 1> read_stack(const TPaths& paths, Index index = 0, const Threads& threads = Threads(1))
+{
+  const std::vector<std::filesystem::path> list(std::begin(paths), std::end(paths));
+  const Index count = list.size();
+  if (count == 0) {
+    return Raster<T, N + 1>();
+  }
+  const auto shape = Fits(list[0]).read_shape<N>(index);
+  auto stack_shape = extend<N + 1>(shape);
+  stack_shape[N] = count;
+  Raster<T, N + 1> out(stack_shape);
+  std::exception_ptr error;
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+  for (Index i = 0; i < count; ++i) {
+    try {
+      Fits fits(list[i]);
+      fits.open();
+      if (fits.read_shape<N>(index) != shape) {
+        throw Exception("Shape mismatch", list[i].string());
+      }
+      auto section = out.section(i);
+      fits.read_chunk_to(0, section, index);
+    } catch (...) {
+#pragma omp critical
+      if (not error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return out;
+}
+
 } // namespace Linx
 
 #endif
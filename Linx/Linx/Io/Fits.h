@@ -5,13 +5,19 @@
 #ifndef _LINXIO_FITS_H
 #define _LINXIO_FITS_H
 
+#include "Linx/Base/Trace.h"
+#include "Linx/Data/Grid.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Io/Exceptions.h"
+#include "Linx/Io/Mapping.h"
 
+#include <algorithm> // copy, max, min
 #include <filesystem>
 #include <fitsio.h>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace Linx {
 
@@ -19,8 +25,14 @@ namespace Linx {
  * @brief FITS file reader/writer.
  * 
  * This is a simple handler able to read or write an image HDU.
- * For example, streaming and keyword records are not handled.
+ * For example, keyword records are not handled.
  * For anything more complex, see EleFits: https://cnes.github.io/EleFits/
+ * 
+ * Regions or grids of images can be read without reading the whole HDU, with `read()` and `read_to()`.
+ * Images can be streamed by chunks along the last axis, with `read_chunk()` and `write_chunk()`,
+ * or iterated by chunks or sections, with `chunks()` and `sections()`.
+ * Uncompressed images can be mapped into memory with `map()`.
+ * By default, the file is opened and closed by each operation; see `open()` to keep it open.
  */
 class Fits {
 public:
@@ -52,10 +64,138 @@ public:
     }
   };
 
+  /**
+   * @brief Tile compression parameters.
+   * 
+   * Compressed images are written as binary table extensions:
+   * if the file is empty, CFITSIO first writes an empty Primary, such that the image is at index 1.
+   */
+  struct Compression {
+    /**
+     * @brief The algorithm, e.g. `RICE_1`, `GZIP_1`, `GZIP_2`, `HCOMPRESS_1` or `PLIO_1`.
+     */
+    int algorithm = RICE_1;
+
+    /**
+     * @brief The tile shape, or an empty position for CFITSIO's default (row-wise tiling).
+     */
+    Position<-1> tile = {};
+
+    /**
+     * @brief The quantization level of floating point values, or 0 for lossless compression.
+     */
+    float quantization = 4;
+  };
+
+  /**
+   * @brief Input range over the chunks or sections of an image.
+   * @see `chunks()`
+   * @see `sections()`
+   */
+  template <typename TRaster>
+  class ChunkReader;
+
   /**
    * @brief Constructor.
+   * 
+   * The file is not opened: unless `open()` is called, it is opened and closed by each read or write operation.
    */
-  Fits(const std::filesystem::path& path) : m_path(path) {}
+  Fits(const std::filesystem::path& path) : m_path(path), m_fptr(nullptr) {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  Fits(const Fits&) = delete;
+
+  /**
+   * @brief Move constructor.
+   */
+  Fits(Fits&& other) : m_path(LINX_MOVE(other.m_path)), m_fptr(other.m_fptr)
+  {
+    other.m_fptr = nullptr;
+  }
+
+  /**
+   * @brief Non-copyable.
+   */
+  Fits& operator=(const Fits&) = delete;
+
+  /**
+   * @brief Move assignment.
+   */
+  Fits& operator=(Fits&& other)
+  {
+    if (this != &other) {
+      close();
+      m_path = LINX_MOVE(other.m_path);
+      m_fptr = other.m_fptr;
+      other.m_fptr = nullptr;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor, which closes the file if needed.
+   */
+  ~Fits()
+  {
+    if (m_fptr) {
+      int status = 0;
+      fits_close_file(m_fptr, &status);
+    }
+  }
+
+  /**
+   * @brief Open the file and keep it open until `close()` is called.
+   * @param mode `r` to read, `x` to create a new file, `w` to create or overwrite, `a` to read and write
+   * 
+   * While the file is open, read and write operations reuse the same handle,
+   * such that headers are parsed only once and HDU offsets are known after the first visit.
+   * This is much faster for files with many HDUs.
+   * Writing with mode `a` appends an HDU to the open file,
+   * while writing with mode `w` reopens the file with that mode,
+   * and writing with mode `x` throws a `PathExistsError`, since the file exists.
+   * If the file is open for reading only, it is reopened with mode `a` prior to writing.
+   * 
+   * \code
+   * Fits fits("exposure.fits");
+   * fits.open();
+   * for (Index i = 1; i < fits.hdu_count(); ++i) {
+   *   const auto raster = fits.read<Raster<float>>(i);
+   *   ...
+   * }
+   * fits.close();
+   * \endcode
+   */
+  void open(char mode = 'r')
+  {
+    close();
+    m_fptr = open_file(mode);
+  }
+
+  /**
+   * @brief Close the file if it is open.
+   */
+  void close()
+  {
+    if (not m_fptr) {
+      return;
+    }
+    int status = 0;
+    fits_close_file(m_fptr, &status);
+    m_fptr = nullptr;
+    if (status != 0) {
+      throw Error("Cannot close file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Check whether the file is kept open.
+   */
+  bool is_open() const
+  {
+    return m_fptr;
+  }
 
   /**
    * @brief Get the file path.
@@ -71,40 +211,419 @@ public:
   template <typename TRaster>
   TRaster read(Index hdu = 0)
   {
-    FileNotFoundError::may_throw(m_path);
+    LINX_TRACE_SCOPE("Fits::read");
     int status = 0;
-    fitsfile* fptr;
+    fitsfile* fptr = open_for_reading();
     int naxis = 0;
-    fits_open_file(&fptr, m_path.c_str(), READONLY, &status);
-    if (status != 0) {
-      throw FileFormatError("Cannot read file", m_path);
-    }
     fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
     fits_get_img_dim(fptr, &naxis, &status);
     Position<TRaster::Dimension> shape(naxis);
     fits_get_img_size(fptr, naxis, shape.data(), &status);
     TRaster out(shape);
     fits_read_img(fptr, typecode<typename TRaster::Value>(), 1, out.size(), nullptr, out.data(), nullptr, &status);
-    fits_close_file(fptr, &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Read a region of an image at given (0-based) HDU index.
+   * 
+   * Only the pixels of the region are read from the file, e.g. to extract postage stamps from large images.
+   */
+  template <typename TRaster, Index N>
+  TRaster read(const Box<N>& region, Index hdu = 0)
+  {
+    TRaster out(region.shape());
+    read_to(region, out, hdu);
+    return out;
+  }
+
+  /**
+   * @brief Read a grid of an image at given (0-based) HDU index.
+   */
+  template <typename TRaster, Index N>
+  TRaster read(const Grid<N>& grid, Index hdu = 0)
+  {
+    TRaster out(grid.shape());
+    read_to(grid, out, hdu);
+    return out;
+  }
+
+  /**
+   * @brief Read a region of an image into an existing raster or patch.
+   * @param region The region to be read
+   * @param out The output raster or patch, of size `region.size()`
+   * @param hdu The (0-based) HDU index
+   */
+  template <Index N, typename TOut>
+  void read_to(const Box<N>& region, TOut& out, Index hdu = 0)
+  {
+    read_subset(region.front(), region.back(), Position<N>(region.dimension()).fill(1), out, hdu);
+  }
+
+  /**
+   * @brief Read a grid of an image into an existing raster or patch.
+   * @param grid The grid to be read
+   * @param out The output raster or patch, of size `grid.size()`
+   * @param hdu The (0-based) HDU index
+   */
+  template <Index N, typename TOut>
+  void read_to(const Grid<N>& grid, TOut& out, Index hdu = 0)
+  {
+    read_subset(grid.front(), grid.back(), grid.step(), out, hdu);
+  }
+
+  /**
+   * @brief Map an uncompressed image at given (0-based) HDU index into memory.
+   * 
+   * The returned raster is a read-only view of the file data, which is loaded lazily by the operating system.
+   * This is well suited for random access to small regions of huge files.
+   * Values are converted from big-endian byte order on read.
+   * 
+   * The image type must match `T` exactly: compressed or scaled images (including unsigned integers,
+   * which FITS stores as scaled signed integers) cannot be mapped, and a `FileFormatError` is thrown.
+   * @see `MappedRaster`
+   */
+  template <typename T, Index N = 2>
+  MappedRaster<T, N> map(Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading();
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    int bitpix = 0;
+    int equivalent = 0;
+    fits_get_img_type(fptr, &bitpix, &status);
+    fits_get_img_equivtype(fptr, &equivalent, &status);
+    const bool compressed = fits_is_compressed_image(fptr, &status);
+    int naxis = 0;
+    fits_get_img_dim(fptr, &naxis, &status);
+    Position<N> shape(naxis);
+    fits_get_img_size(fptr, naxis, shape.data(), &status);
+    LONGLONG header = 0;
+    LONGLONG data = 0;
+    LONGLONG end = 0;
+    fits_get_hduaddrll(fptr, &header, &data, &end, &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    if (compressed || bitpix != equivalent || bitpix != Fits::bitpix<T>()) {
+      throw FileFormatError("Cannot map image of BITPIX " + std::to_string(equivalent), m_path);
+    }
+    return MappedRaster<T, N>(shape, std::size_t(data), m_path);
+  }
+
+  /**
+   * @brief Get the number of HDUs.
+   */
+  Index hdu_count()
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading();
+    int count = 0;
+    fits_get_num_hdus(fptr, &count, &status);
+    release(fptr, status);
     if (status != 0) {
       throw Error("Cannot read file", m_path, status);
     }
-    fptr = nullptr;
+    return count;
+  }
+
+  /**
+   * @brief Read the shape of an image at given (0-based) HDU index.
+   */
+  template <Index N = 2>
+  Position<N> read_shape(Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading();
+    int naxis = 0;
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    fits_get_img_dim(fptr, &naxis, &status);
+    Position<N> shape(naxis);
+    fits_get_img_size(fptr, naxis, shape.data(), &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    return shape;
+  }
+
+  /**
+   * @brief Read a chunk of an image, i.e. consecutive sections.
+   * @param front The chunk front index along the last axis
+   * @param back The chunk back index along the last axis
+   * @param hdu The (0-based) HDU index
+   * 
+   * This allows streaming images which do not fit in memory.
+   * @see `Raster::chunk()`
+   */
+  template <typename TRaster>
+  TRaster read_chunk(Index front, Index back, Index hdu = 0)
+  {
+    auto shape = read_shape<TRaster::Dimension>(hdu);
+    shape[shape.size() - 1] = back - front + 1;
+    TRaster out(shape);
+    read_chunk_to(front, out, hdu);
     return out;
   }
 
+  /**
+   * @brief Read consecutive sections of an image into an existing raster.
+   * @param front The front index along the last axis
+   * @param out The output raster, whose size is a multiple of the section size
+   * @param hdu The (0-based) HDU index
+   * 
+   * This is used to stream images into reused buffers, e.g. with `chunks()` or `sections()`.
+   */
+  template <typename TRaster>
+  void read_chunk_to(Index front, TRaster& out, Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading();
+    int naxis = 0;
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    fits_get_img_dim(fptr, &naxis, &status);
+    Position<-1> shape(naxis);
+    fits_get_img_size(fptr, naxis, shape.data(), &status);
+    const auto section_size = shape_size(shape) / shape[naxis - 1];
+    fits_read_img(
+        fptr,
+        typecode<typename TRaster::Value>(),
+        front * section_size + 1,
+        out.size(),
+        nullptr,
+        out.data(),
+        nullptr,
+        &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Get an input range over the chunks of an image.
+   * @param thickness The chunk thickness along the last axis
+   * @param hdu The (0-based) HDU index
+   * @param prefetch Read the next chunk in a background thread while the current chunk is processed
+   * 
+   * Chunks are read into a reused buffer, such that memory is bounded by one chunk (or two with prefetch).
+   * Like with `Linx::chunks()`, the last chunk may be thinner.
+   * The reader opens its own handle, such that this object can be used independently.
+   * 
+   * \code
+   * for (const auto& chunk : Fits("cube.fits").chunks<Raster<float, 3>>(8, 0, true)) {
+   *   process(chunk);
+   * }
+   * \endcode
+   */
+  template <typename TRaster>
+  ChunkReader<TRaster> chunks(Index thickness, Index hdu = 0, bool prefetch = false) const
+  {
+    return ChunkReader<TRaster>(m_path, hdu, thickness, prefetch);
+  }
+
+  /**
+   * @brief Get an input range over the sections of an image.
+   * @param hdu The (0-based) HDU index
+   * @param prefetch Read the next section in a background thread while the current section is processed
+   * 
+   * Like with `Linx::sections()`, sections are of one less dimension than the image.
+   * @see `chunks()`
+   */
+  template <typename TRaster>
+  ChunkReader<TRaster> sections(Index hdu = 0, bool prefetch = false) const
+  {
+    return ChunkReader<TRaster>(m_path, hdu, 0, prefetch);
+  }
+
+  /**
+   * @brief Write an image filled with zeros, to be written later by chunks.
+   * @param shape The image shape
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   * @see `write_chunk()`
+   */
+  template <typename T, Index N>
+  void write_shape(const Position<N>& shape, char mode = 'x')
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_writing(mode);
+    auto nonconst = shape;
+    fits_create_img(fptr, image_typecode<T>(), nonconst.size(), nonconst.data(), &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Write a chunk of an existing image, i.e. consecutive sections.
+   * @param raster The chunk to be written
+   * @param front The chunk front index along the last axis
+   * @param hdu The (0-based) HDU index
+   */
+  template <typename TRaster>
+  void write_chunk(const TRaster& raster, Index front, Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_updating();
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    const auto box = raster.domain();
+    const auto section_size = raster.size() / std::max(Index(1), box.length(box.dimension() - 1));
+    write_values(fptr, front * section_size + 1, raster, status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Write a region of an existing image, e.g. a tile of a mosaic.
+   * @param raster The raster or patch to be written, of shape `region.shape()`
+   * @param region The region to be written
+   * @param hdu The (0-based) HDU index
+   * @see `write_shape()`
+   */
+  template <typename TRaster, Index N>
+  void write_region(const TRaster& raster, const Box<N>& region, Index hdu = 0)
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    int status = 0;
+    fitsfile* fptr = open_for_updating();
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    auto front = region.front() + 1;
+    auto back = region.back() + 1;
+    if constexpr (not is_patch<TRaster>()) {
+      auto* data = const_cast<T*>(raster.data()); // CFITSIO does not modify input data
+      fits_write_subset(fptr, typecode<T>(), front.data(), back.data(), data, &status);
+    } else {
+      std::vector<T> buffer(raster.begin(), raster.end());
+      fits_write_subset(fptr, typecode<T>(), front.data(), back.data(), buffer.data(), &status);
+    }
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+  }
+
   /**
    * @brief Write an image as a new FITS file.
-   * @param raster The raster to be written
+   * @param raster The raster or patch to be written
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   * 
+   * Rasters are written directly from their data, and non-contiguous patches through a buffer of bounded size.
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, char mode = 'x')
+  {
+    LINX_TRACE_SCOPE("Fits::write");
+    int status = 0;
+    fitsfile* fptr = open_for_writing(mode);
+    write_image(fptr, raster, status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Write an image as a new tile-compressed HDU.
+   * @param raster The raster or patch to be written
+   * @param compression The compression parameters
    * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   * 
+   * Tiles are compressed by CFITSIO.
+   * Tiles which span whole rows compress faster, because values are written row-wise.
    */
   template <typename TRaster>
-  void write(TRaster raster, char mode = 'x')
+  void write(const TRaster& raster, const Compression& compression, char mode = 'x')
+  {
+    LINX_TRACE_SCOPE("Fits::write");
+    int status = 0;
+    fitsfile* fptr = open_for_writing(mode);
+    fits_set_compression_type(fptr, compression.algorithm, &status);
+    if (compression.tile.size() > 0) {
+      auto tile = compression.tile;
+      fits_set_tile_dim(fptr, tile.size(), tile.data(), &status);
+    }
+    fits_set_quantize_level(fptr, compression.quantization, &status);
+    write_image(fptr, raster, status);
+    fits_set_compression_type(fptr, NOCOMPRESS, &status); // Do not compress the next HDUs
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+  }
+
+  /**
+   * @brief Get the BITPIX of a given type.
+   */
+  template <typename T>
+  static constexpr int bitpix()
+  {
+    if constexpr (std::is_integral_v<T>) {
+      return 8 * static_cast<int>(sizeof(T));
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+      return -8 * static_cast<int>(sizeof(T));
+    }
+    return 0;
+  }
+
+private:
+
+  /**
+   * @brief Read a strided subset of an image with `fits_read_subset()`.
+   * 
+   * Rasters are filled in place, while patches are filled through a temporary buffer.
+   */
+  template <Index N, typename TOut>
+  void read_subset(Position<N> front, Position<N> back, Position<N> step, TOut& out, Index hdu)
+  {
+    using T = std::decay_t<typename TOut::Value>;
+    constexpr bool is_raster = not is_patch<TOut>();
+    int status = 0;
+    fitsfile* fptr = open_for_reading();
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    front += 1;
+    back += 1;
+    std::vector<T> buffer(is_raster ? 0 : out.size());
+    T* data = nullptr;
+    if constexpr (is_raster) {
+      data = out.data();
+    } else {
+      data = buffer.data();
+    }
+    fits_read_subset(fptr, typecode<T>(), front.data(), back.data(), step.data(), nullptr, data, nullptr, &status);
+    release(fptr, status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    if constexpr (not is_raster) {
+      std::copy(buffer.begin(), buffer.end(), out.begin());
+    }
+  }
+
+  /**
+   * @brief Open the file with given mode.
+   */
+  fitsfile* open_file(char mode)
   {
     int status = 0;
     fitsfile* fptr;
     std::string path = "!"; // For overwriting
     switch (mode) {
+      case 'r':
+        FileNotFoundError::may_throw(m_path);
+        fits_open_file(&fptr, m_path.c_str(), READONLY, &status);
+        if (status != 0) {
+          throw FileFormatError("Cannot read file", m_path);
+        }
+        return fptr;
       case 'x':
         PathExistsError::may_throw(m_path);
         fits_create_file(&fptr, m_path.c_str(), &status);
@@ -123,35 +642,115 @@ public:
     if (status != 0) {
       throw FileFormatError("Cannot write file", m_path);
     }
-    auto shape = raster.shape();
-    fits_create_img(fptr, image_typecode<typename TRaster::Value>(), raster.dimension(), shape.data(), &status);
-    if (raster.size() > 0) {
-      std::vector<std::decay_t<typename TRaster::Value>> nonconst(raster.begin(), raster.end());
-      fits_write_img(fptr, typecode<typename TRaster::Value>(), 1, raster.size(), nonconst.data(), &status);
+    return fptr;
+  }
+
+  /**
+   * @brief Get the open handle, or open the file for reading.
+   */
+  fitsfile* open_for_reading()
+  {
+    return m_fptr ? m_fptr : open_file('r');
+  }
+
+  /**
+   * @brief Get the open handle, or open the file for updating existing HDUs.
+   * 
+   * If the open handle is read-only, the file is reopened with mode `a`.
+   */
+  fitsfile* open_for_updating()
+  {
+    if (not m_fptr) {
+      return open_file('a');
     }
-    fits_close_file(fptr, &status);
-    if (status != 0) {
-      throw Error("Cannot write file", m_path, status);
+    int status = 0;
+    int iomode = READWRITE;
+    fits_file_mode(m_fptr, &iomode, &status);
+    if (iomode == READONLY) {
+      open('a');
     }
-    fptr = nullptr;
+    return m_fptr;
   }
 
   /**
-   * @brief Get the BITPIX of a given type.
+   * @brief Get the open handle, or create or open the file for writing a new HDU.
    */
-  template <typename T>
-  static constexpr int bitpix()
+  fitsfile* open_for_writing(char mode)
   {
-    if constexpr (std::is_integral_v<T>) {
-      return 8 * static_cast<int>(sizeof(T));
+    if (not m_fptr) {
+      return open_file(mode);
     }
-    if constexpr (std::is_floating_point_v<T>) {
-      return -8 * static_cast<int>(sizeof(T));
+    switch (mode) {
+      case 'x': {
+        PathExistsError error(m_path);
+        error.append("File is open: cannot be created with mode 'x'");
+        throw error;
+      }
+      case 'w':
+        open(mode);
+        return m_fptr;
+      case 'a':
+        return open_for_updating();
+      default:
+        throw Exception("Unknown write mode", std::string(1, mode));
     }
-    return 0;
   }
 
-private:
+  /**
+   * @brief Create an image HDU and write the values of a raster or patch.
+   */
+  template <typename TRaster>
+  void write_image(fitsfile* fptr, const TRaster& raster, int& status)
+  {
+    const auto box = raster.domain();
+    auto shape = box.shape();
+    fits_create_img(fptr, image_typecode<typename TRaster::Value>(), box.dimension(), shape.data(), &status);
+    write_values(fptr, 1, raster, status);
+  }
+
+  /**
+   * @brief Write the values of a raster or patch from some (1-based) pixel index.
+   * 
+   * Rasters and contiguous patches (e.g. chunks) are written without copy.
+   * Other patches are copied into a buffer of at most `buffer_size` values, which is written as many times as needed.
+   */
+  template <typename TRaster>
+  void write_values(fitsfile* fptr, Index first, const TRaster& raster, int& status)
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    constexpr Index buffer_size = 1 << 16;
+    const Index size = raster.size();
+    if (size == 0) {
+      return;
+    }
+    if constexpr (not is_patch<TRaster>()) {
+      auto* data = const_cast<T*>(raster.data()); // CFITSIO does not modify input data
+      fits_write_img(fptr, typecode<T>(), first, size, data, &status);
+    } else if (raster.contiguity() == 1) {
+      auto* data = const_cast<T*>(raster.data());
+      fits_write_img(fptr, typecode<T>(), first, size, data, &status);
+    } else {
+      std::vector<T> buffer(std::min(size, buffer_size));
+      auto it = raster.begin();
+      for (Index done = 0; done < size; done += buffer.size()) {
+        const auto count = std::min<Index>(buffer.size(), size - done);
+        for (Index i = 0; i < count; ++i, ++it) {
+          buffer[i] = *it;
+        }
+        fits_write_img(fptr, typecode<T>(), first + done, count, buffer.data(), &status);
+      }
+    }
+  }
+
+  /**
+   * @brief Close a handle unless it is the open handle.
+   */
+  void release(fitsfile* fptr, int& status)
+  {
+    if (fptr != m_fptr) {
+      fits_close_file(fptr, &status);
+    }
+  }
 
   /**
    * @brief Get CFITSIO's typecode.
@@ -223,9 +822,19 @@ private:
 
 private:
 
+  /**
+   * @brief The file path.
+   */
   std::filesystem::path m_path;
+
+  /**
+   * @brief The open handle, or `nullptr`.
+   */
+  fitsfile* m_fptr;
 };
 
 } // namespace Linx
 
+#include "Linx/Io/impl/FitsChunkReader.h"
+
 #endif
@@ -0,0 +1,153 @@
+/// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_MAPPING_H
+#define _LINXIO_MAPPING_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <algorithm> // reverse_copy
+#include <fcntl.h> // open
+#include <filesystem>
+#include <memory> // shared_ptr
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h> // close, sysconf
+
+namespace Linx {
+
+/**
+ * @brief A value stored in big-endian byte order.
+ * 
+ * The value is converted to native byte order on read, such that
+ * big-endian data (e.g. FITS data) can be accessed in place, without being swapped beforehand.
+ */
+template <typename T>
+class BigEndian {
+public:
+
+  /**
+   * @brief The native value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief Get the value in native byte order.
+   */
+  operator T() const
+  {
+    if constexpr (sizeof(T) == 1 || is_native()) {
+      return m_value;
+    } else {
+      T out;
+      const auto* bytes = reinterpret_cast<const unsigned char*>(&m_value);
+      std::reverse_copy(bytes, bytes + sizeof(T), reinterpret_cast<unsigned char*>(&out));
+      return out;
+    }
+  }
+
+  /**
+   * @brief Check whether the native byte order is big-endian.
+   */
+  static constexpr bool is_native()
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return true;
+#else
+    return false;
+#endif
+  }
+
+private:
+
+  /**
+   * @brief The value in big-endian byte order.
+   */
+  T m_value;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Holder of a read-only memory-mapped file region.
+ * 
+ * The mapping is shared by copies of the holder and unmapped when the last copy is destroyed.
+ * Pages are loaded lazily by the operating system, such that only accessed values are read from the file.
+ */
+template <typename T>
+class MappedHolder {
+public:
+
+  /**
+   * @brief Null constructor.
+   */
+  explicit MappedHolder(std::size_t = 0) : m_mapping(), m_begin(nullptr), m_end(nullptr) {}
+
+  /**
+   * @brief Map the file region which starts at given offset.
+   * @param size The number of elements
+   * @param offset The offset of the first element, in bytes
+   * @param path The file path
+   */
+  MappedHolder(std::size_t size, std::size_t offset, const std::filesystem::path& path) : MappedHolder()
+  {
+    if (size == 0) {
+      return;
+    }
+    FileNotFoundError::may_throw(path);
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const auto front = offset / page * page;
+    const auto length = offset - front + size * sizeof(T);
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw FileFormatError("Cannot open file", path);
+    }
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, front);
+    ::close(fd); // The mapping remains valid
+    if (mapped == MAP_FAILED) {
+      throw FileFormatError("Cannot map file", path);
+    }
+    m_mapping = std::shared_ptr<void>(mapped, [=](void* p) {
+      munmap(p, length);
+    });
+    m_begin = reinterpret_cast<T*>(static_cast<char*>(mapped) + (offset - front));
+    m_end = m_begin + size;
+  }
+
+  inline const T* begin() const
+  {
+    return m_begin;
+  }
+
+  inline const T* end() const
+  {
+    return m_end;
+  }
+
+private:
+
+  std::shared_ptr<void> m_mapping;
+  T* m_begin;
+  T* m_end;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Read-only raster over a memory-mapped big-endian file region.
+ * 
+ * Elements are `BigEndian<T>` values, which are implicitly converted to `T` when read.
+ * Regions can be copied into standard rasters, e.g. to extract postage stamps:
+ * 
+ * \code
+ * const auto mapped = Fits("huge.fits").map<float>();
+ * const auto stamp = mapped(Box<2>({x - 10, y - 10}, {x + 10, y + 10}));
+ * Raster<float> raster(stamp.domain().shape());
+ * std::copy(stamp.begin(), stamp.end(), raster.begin());
+ * \endcode
+ */
+template <typename T, Index N = 2>
+using MappedRaster = Raster<const BigEndian<T>, N, MappedHolder<const BigEndian<T>>>;
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,216 @@
+/// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_RAW_H
+#define _LINXIO_RAW_H
+
+#include "Linx/Base/Trace.h"
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+#include "Linx/Io/Mapping.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief Raw binary file reader/writer, for fast checkpoints.
+ * 
+ * The file is made of a small header, which stores the value type and the raster shape,
+ * followed by the native-endian values, which start at an offset aligned to `alignment` bytes.
+ * As opposed to FITS files, raw files are therefore not portable across architectures,
+ * but they are written and read without any conversion, in a single I/O operation.
+ * Data can be also mapped into memory with `map()`.
+ * 
+ * \code
+ * Raw("checkpoint.raw").write(state, 'w');
+ * ...
+ * const auto state = Raw("checkpoint.raw").read<AlignedRaster<float, 3>>();
+ * \endcode
+ */
+class Raw {
+public:
+
+  /**
+   * @brief The data alignment, in bytes.
+   */
+  static constexpr Index alignment = 64;
+
+  /**
+   * @brief Constructor.
+   */
+  Raw(const std::filesystem::path& path) : m_path(path) {}
+
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Read the shape of the raster.
+   */
+  template <Index N = 2>
+  Position<N> read_shape() const
+  {
+    std::ifstream file(m_path, std::ios::binary);
+    return read_header<N>(file, 0);
+  }
+
+  /**
+   * @brief Read the raster.
+   * 
+   * The value type must match that of the file exactly, and a `FileFormatError` is thrown otherwise.
+   */
+  template <typename TRaster>
+  TRaster read() const
+  {
+    LINX_TRACE_SCOPE("Raw::read");
+    using T = std::decay_t<typename TRaster::Value>;
+    std::ifstream file(m_path, std::ios::binary);
+    const auto shape = read_header<TRaster::Dimension>(file, typecode<T>());
+    TRaster out(shape);
+    file.seekg(data_offset(shape.size()));
+    file.read(reinterpret_cast<char*>(out.data()), out.size() * sizeof(T));
+    if (not file) {
+      throw FileFormatError("Cannot read file", m_path);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Map the raster into memory.
+   * 
+   * The returned raster is a read-only view of the file data, which is loaded lazily by the operating system.
+   * The data is aligned to `alignment` bytes.
+   */
+  template <typename T, Index N = 2>
+  Raster<const T, N, MappedHolder<const T>> map() const
+  {
+    std::ifstream file(m_path, std::ios::binary);
+    const auto shape = read_header<N>(file, typecode<T>());
+    return Raster<const T, N, MappedHolder<const T>>(shape, std::size_t(data_offset(shape.size())), m_path);
+  }
+
+  /**
+   * @brief Write a raster.
+   * @param raster The raster to be written, which must be contiguous
+   * @param mode `x` to create a new file, `w` to create or overwrite
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, char mode = 'x') const
+  {
+    LINX_TRACE_SCOPE("Raw::write");
+    using T = std::decay_t<typename TRaster::Value>;
+    switch (mode) {
+      case 'x':
+        PathExistsError::may_throw(m_path);
+        break;
+      case 'w':
+        break;
+      default:
+        throw Exception("Unknown write mode", std::string(1, mode));
+    }
+    const auto shape = raster.shape();
+    const Index dimension = shape.size();
+    std::vector<std::int64_t> header(data_offset(dimension) / sizeof(std::int64_t), 0);
+    header[0] = magic();
+    header[1] = typecode<T>();
+    header[2] = dimension;
+    std::copy(shape.begin(), shape.end(), header.begin() + 3);
+    std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size() * sizeof(std::int64_t));
+    file.write(reinterpret_cast<const char*>(raster.data()), raster.size() * sizeof(T));
+    if (not file) {
+      throw FileFormatError("Cannot write file", m_path);
+    }
+  }
+
+  /**
+   * @brief Get the type code of a given value type.
+   * 
+   * The type code encodes the kind of type (boolean, signed or unsigned integer, floating point or complex),
+   * and its size in bytes.
+   */
+  template <typename T>
+  static constexpr std::int64_t typecode()
+  {
+    std::int64_t kind = 0;
+    if constexpr (std::is_same_v<T, bool>) {
+      kind = 'b';
+    } else if constexpr (std::is_integral_v<T>) {
+      kind = std::is_signed_v<T> ? 'i' : 'u';
+    } else if constexpr (std::is_floating_point_v<T>) {
+      kind = 'f';
+    } else if constexpr (IsComplex<T>::value) {
+      kind = 'c';
+    }
+    return (kind << 8) + sizeof(T);
+  }
+
+private:
+
+  /**
+   * @brief Get the magic number which starts the header.
+   */
+  static constexpr std::int64_t magic()
+  {
+    return 0x5752584e494c; // "LINXRW" in native byte order
+  }
+
+  /**
+   * @brief Get the data offset in bytes, i.e. the header size rounded up to the alignment.
+   */
+  static Index data_offset(Index dimension)
+  {
+    const Index size = (3 + dimension) * sizeof(std::int64_t);
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * @brief Read and check the header.
+   * @param code The expected type code, or 0 to skip the check
+   */
+  template <Index N>
+  Position<N> read_header(std::ifstream& file, std::int64_t code) const
+  {
+    FileNotFoundError::may_throw(m_path);
+    std::int64_t prefix[3] = {0, 0, 0};
+    file.read(reinterpret_cast<char*>(prefix), sizeof(prefix));
+    if (not file || prefix[0] != magic()) {
+      throw FileFormatError("Not a raw file", m_path);
+    }
+    if (code != 0 && prefix[1] != code) {
+      throw FileFormatError("Type mismatch: " + std::to_string(prefix[1]) + " in", m_path);
+    }
+    if (N != -1 && prefix[2] != N) {
+      throw FileFormatError("Dimension mismatch: " + std::to_string(prefix[2]) + " in", m_path);
+    }
+    Position<N> shape(prefix[2]);
+    std::vector<std::int64_t> lengths(prefix[2]);
+    file.read(reinterpret_cast<char*>(lengths.data()), lengths.size() * sizeof(std::int64_t));
+    if (not file) {
+      throw FileFormatError("Cannot read file", m_path);
+    }
+    std::copy(lengths.begin(), lengths.end(), shape.begin());
+    return shape;
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
+};
+
+} // namespace Linx
+
+#endif
@@ -5,8 +5,23 @@
 #ifndef _LINXIO_TEMPORARY_H
 #define _LINXIO_TEMPORARY_H
 
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <atomic>
+#include <cstdlib> // atexit, getenv
+#include <fcntl.h> // open, posix_fallocate
 #include <filesystem>
+#include <limits>
+#include <memory> // shared_ptr
+#include <mutex>
+#include <set>
 #include <string>
+#include <sys/file.h> // flock
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h> // access, close, gethostname, getpid
+#include <utility> // exchange
+#include <vector>
 
 namespace Linx {
 
@@ -51,6 +66,432 @@ private:
   std::filesystem::path m_path;
 };
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The scratch directories of the process, which are removed at exit if they were not at destruction.
+ */
+class ScratchRegistry {
+public:
+
+  static ScratchRegistry& instance()
+  {
+    static auto* registry = new ScratchRegistry(); // Never destroyed, since used by the exit handler
+    return *registry;
+  }
+
+  void insert(const std::filesystem::path& path)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paths.insert(path);
+  }
+
+  void erase(const std::filesystem::path& path)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paths.erase(path);
+  }
+
+private:
+
+  ScratchRegistry()
+  {
+    std::atexit([]() {
+      auto& registry = instance();
+      std::lock_guard<std::mutex> lock(registry.m_mutex);
+      for (const auto& p : registry.m_paths) {
+        std::error_code ec;
+        std::filesystem::remove_all(p, ec);
+      }
+      registry.m_paths.clear();
+    });
+  }
+
+  std::mutex m_mutex;
+  std::set<std::filesystem::path> m_paths;
+};
+
+/**
+ * @brief The usage accounting of a scratch space, shared with its files.
+ */
+struct ScratchUsage {
+  std::size_t budget;
+  std::atomic<std::size_t> used;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief A preallocated file of a `ScratchSpace`, mapped into memory, and removed at destruction.
+ * @see `ScratchSpace::allocate()`
+ */
+class ScratchFile {
+public:
+
+  /**
+   * @brief Create, preallocate and map a file.
+   */
+  ScratchFile(std::filesystem::path path, std::size_t size, std::shared_ptr<Internal::ScratchUsage> usage) :
+      m_path(LINX_MOVE(path)), m_size(size), m_usage(LINX_MOVE(usage)), m_data(nullptr)
+  {
+    const int fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+      m_usage->used -= m_size;
+      throw PathExistsError(m_path);
+    }
+    void* mapped = nullptr;
+    if (m_size > 0 && posix_fallocate(fd, 0, m_size) == 0) {
+      mapped = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd); // The mapping remains valid
+    if (m_size > 0 && (not mapped || mapped == MAP_FAILED)) {
+      std::filesystem::remove(m_path);
+      m_usage->used -= m_size;
+      throw FileFormatError("Cannot preallocate scratch file of " + std::to_string(m_size) + " bytes", m_path);
+    }
+    m_data = m_size > 0 ? static_cast<char*>(mapped) : nullptr;
+  }
+
+  ScratchFile(const ScratchFile&) = delete;
+  ScratchFile& operator=(const ScratchFile&) = delete;
+
+  /**
+   * @brief Move constructor.
+   */
+  ScratchFile(ScratchFile&& other) :
+      m_path(LINX_MOVE(other.m_path)), m_size(std::exchange(other.m_size, 0)), m_usage(LINX_MOVE(other.m_usage)),
+      m_data(std::exchange(other.m_data, nullptr))
+  {
+    other.m_path.clear();
+  }
+
+  /**
+   * @brief Destructor.
+   * 
+   * Unmaps and removes the file, and releases its size from the scratch usage.
+   */
+  ~ScratchFile()
+  {
+    if (m_data) {
+      munmap(m_data, m_size);
+    }
+    if (not m_path.empty()) {
+      std::error_code ec;
+      std::filesystem::remove(m_path, ec);
+    }
+    if (m_usage) {
+      m_usage->used -= m_size;
+    }
+  }
+
+  /**
+   * @brief Get the path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Get the size in bytes.
+   */
+  std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the mapped data.
+   */
+  char* data() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Get a raster view of the mapped data.
+   * 
+   * The file must outlive the view.
+   */
+  template <typename T, Index N>
+  PtrRaster<T, N> raster(const Position<N>& shape) const
+  {
+    const auto size = shape_size(shape) * sizeof(T);
+    if (size > m_size) {
+      throw Exception("Scratch file too small: " + std::to_string(size) + " > " + std::to_string(m_size) + " bytes");
+    }
+    return PtrRaster<T, N>(shape, reinterpret_cast<T*>(m_data));
+  }
+
+private:
+
+  /**
+   * @brief The path.
+   */
+  std::filesystem::path m_path;
+
+  /**
+   * @brief The size in bytes.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The usage of the owning scratch space.
+   */
+  std::shared_ptr<Internal::ScratchUsage> m_usage;
+
+  /**
+   * @brief The mapped data.
+   */
+  char* m_data;
+};
+
+/**
+ * @brief A private directory on fast local storage for spill buffers, with size accounting.
+ * 
+ * The directory is created under the first suitable root, in order of preference, e.g. a tmpfs or a local NVMe mount.
+ * Roots are given explicitly, or read from the colon-separated environment variable `LINX_SCRATCH`,
+ * and default to `/dev/shm` and `std::filesystem::temp_directory_path()`.
+ * A root is suitable if it is a writable directory which has at least `budget` bytes available,
+ * or if it is the last root.
+ * 
+ * Files are preallocated with `posix_fallocate()`, such that running out of space fails at allocation,
+ * instead of at some later write (or with a `SIGBUS` on a mapping).
+ * The total size of the files is checked against the budget.
+ * 
+ * The directory is removed at destruction, or at exit, e.g. if `std::exit()` is called.
+ * Directories left by processes which were killed are removed when a new scratch space is created in the same root:
+ * each directory holds a lock file which is locked with `flock()` as long as the scratch space lives,
+ * and which is released by the system when the owning process dies, whatever the host,
+ * such that only unlocked directories are removed, even in roots shared between hosts.
+ * 
+ * \code
+ * ScratchSpace scratch(1L << 30); // 1 GiB budget
+ * auto file = scratch.allocate(raster.size() * sizeof(float), "spill");
+ * auto spill = file.raster<float>(raster.shape());
+ * spill = raster;
+ * \endcode
+ */
+class ScratchSpace {
+public:
+
+  /**
+   * @brief Create a scratch directory under the default roots.
+   */
+  explicit ScratchSpace(std::size_t budget = std::numeric_limits<std::size_t>::max()) :
+      ScratchSpace(default_roots(), budget)
+  {}
+
+  /**
+   * @brief Create a scratch directory under given roots, in order of preference.
+   */
+  ScratchSpace(const std::vector<std::filesystem::path>& roots, std::size_t budget) :
+      m_path(), m_usage(std::make_shared<Internal::ScratchUsage>()), m_count(0), m_lock(-1)
+  {
+    m_usage->budget = budget;
+    m_usage->used = 0;
+    const auto root = select_root(roots, budget);
+    remove_stale(root);
+    static std::atomic<Index> instance_count(0);
+    const auto name = prefix() + hostname() + "-" + std::to_string(getpid()) + "-" + std::to_string(instance_count++);
+    // The directory is locked under a hidden name, then renamed, such that it is never seen unlocked
+    const auto staging = root / ("." + name);
+    std::filesystem::create_directories(staging);
+    m_lock = ::open((staging / lock_name()).c_str(), O_RDWR | O_CREAT, 0600);
+    if (m_lock < 0 || flock(m_lock, LOCK_EX | LOCK_NB) != 0) {
+      if (m_lock >= 0) {
+        ::close(m_lock);
+      }
+      std::error_code ec;
+      std::filesystem::remove_all(staging, ec);
+      throw FileFormatError("Cannot lock scratch directory", staging);
+    }
+    m_path = root / name;
+    std::filesystem::rename(staging, m_path);
+    Internal::ScratchRegistry::instance().insert(m_path);
+  }
+
+  ScratchSpace(const ScratchSpace&) = delete;
+  ScratchSpace& operator=(const ScratchSpace&) = delete;
+
+  /**
+   * @brief Destructor.
+   * 
+   * Removes the directory, including the files which are still alive.
+   */
+  ~ScratchSpace()
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(m_path, ec);
+    Internal::ScratchRegistry::instance().erase(m_path);
+    ::close(m_lock);
+  }
+
+  /**
+   * @brief Get the default roots.
+   */
+  static std::vector<std::filesystem::path> default_roots()
+  {
+    std::vector<std::filesystem::path> out;
+    if (const char* env = std::getenv("LINX_SCRATCH")) {
+      std::string list(env);
+      std::size_t begin = 0;
+      while (begin <= list.size()) {
+        const auto end = std::min(list.find(':', begin), list.size());
+        if (end > begin) {
+          out.emplace_back(list.substr(begin, end - begin));
+        }
+        begin = end + 1;
+      }
+    }
+    out.emplace_back("/dev/shm");
+    out.push_back(std::filesystem::temp_directory_path());
+    return out;
+  }
+
+  /**
+   * @brief Get the directory path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Get the budget in bytes.
+   */
+  std::size_t budget() const
+  {
+    return m_usage->budget;
+  }
+
+  /**
+   * @brief Get the total size of the live files in bytes.
+   */
+  std::size_t usage() const
+  {
+    return m_usage->used;
+  }
+
+  /**
+   * @brief Create a preallocated and mapped file.
+   * @param size The file size in bytes
+   * @param name The file name prefix, which is made unique
+   * 
+   * An exception is thrown if the budget would be exceeded, or if the file cannot be preallocated.
+   */
+  ScratchFile allocate(std::size_t size, const std::string& name = "scratch")
+  {
+    const auto used = m_usage->used.fetch_add(size) + size;
+    if (used > m_usage->budget || used < size) {
+      m_usage->used -= size;
+      throw Exception(
+          "Scratch budget exceeded: " + std::to_string(used - size) + " + " + std::to_string(size) + " > " +
+          std::to_string(m_usage->budget) + " bytes");
+    }
+    return ScratchFile(m_path / (name + "-" + std::to_string(m_count++)), size, m_usage);
+  }
+
+private:
+
+  /**
+   * @brief The directory name prefix, followed by the host name and process ID.
+   */
+  static std::string prefix()
+  {
+    return "linx-scratch-";
+  }
+
+  /**
+   * @brief The name of the lock file in each directory.
+   */
+  static std::string lock_name()
+  {
+    return ".lock";
+  }
+
+  /**
+   * @brief Get the host name, for unique naming in shared roots.
+   */
+  static std::string hostname()
+  {
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0) {
+      return "localhost";
+    }
+    return name;
+  }
+
+  /**
+   * @brief Select the first suitable root.
+   */
+  static std::filesystem::path select_root(const std::vector<std::filesystem::path>& roots, std::size_t budget)
+  {
+    const Index count = roots.size();
+    for (Index i = 0; i < count; ++i) {
+      const auto& root = roots[i];
+      std::error_code ec;
+      if (not std::filesystem::is_directory(root, ec) || access(root.c_str(), W_OK) != 0) {
+        continue;
+      }
+      const auto info = std::filesystem::space(root, ec);
+      const bool unlimited = budget == std::numeric_limits<std::size_t>::max();
+      if (i == count - 1 || (not ec && (unlimited || info.available >= budget))) {
+        return root;
+      }
+    }
+    throw Exception("No suitable scratch root");
+  }
+
+  /**
+   * @brief Remove the scratch directories of dead processes, i.e. whose lock file is not locked.
+   * 
+   * Directories without lock files are left untouched.
+   */
+  static void remove_stale(const std::filesystem::path& root)
+  {
+    std::error_code ec;
+    std::vector<std::filesystem::path> candidates;
+    for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+      if (entry.path().filename().string().rfind(prefix(), 0) == 0) {
+        candidates.push_back(entry.path());
+      }
+    }
+    for (const auto& p : candidates) {
+      const int fd = ::open((p / lock_name()).c_str(), O_RDWR);
+      if (fd < 0) {
+        continue;
+      }
+      if (flock(fd, LOCK_EX | LOCK_NB) == 0) { // Removed while locked, such that no other process reaps it
+        std::filesystem::remove_all(p, ec);
+      }
+      ::close(fd);
+    }
+  }
+
+  /**
+   * @brief The directory path.
+   */
+  std::filesystem::path m_path;
+
+  /**
+   * @brief The usage accounting.
+   */
+  std::shared_ptr<Internal::ScratchUsage> m_usage;
+
+  /**
+   * @brief The number of allocated files, for unique naming.
+   */
+  std::atomic<Index> m_count;
+
+  /**
+   * @brief The descriptor of the locked file, which marks the directory as alive.
+   */
+  int m_lock;
+};
+
 } // namespace Linx
 
 #endif
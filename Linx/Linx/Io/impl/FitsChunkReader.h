@@ -0,0 +1,214 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_IMPL_FITSCHUNKREADER_H
+#define _LINXIO_IMPL_FITSCHUNKREADER_H
+
+#include "Linx/Io/Fits.h"
+
+#include <algorithm> // min
+#include <future>
+#include <iterator> // input_iterator_tag
+#include <utility> // swap
+
+namespace Linx {
+
+/**
+ * @brief Input range over the chunks or sections of an image.
+ * 
+ * The current chunk is stored in a buffer which is reused as long as the chunk thickness does not change.
+ * If prefetching is enabled, the next chunk is read asynchronously into a second buffer,
+ * which is swapped with the current buffer when the range is incremented.
+ * 
+ * The reader is not copyable nor movable, and is meant to be iterated once, typically in a range-based loop.
+ */
+template <typename TRaster>
+class Fits::ChunkReader {
+public:
+
+  /**
+   * @brief Iterator over the chunks.
+   */
+  class Iterator : public std::iterator<std::input_iterator_tag, const TRaster> {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(ChunkReader* reader, Index front) : m_reader(reader), m_front(front) {}
+
+    /**
+     * @brief Get the current chunk.
+     */
+    const TRaster& operator*() const
+    {
+      return m_reader->m_current;
+    }
+
+    /**
+     * @brief Get the current chunk.
+     */
+    const TRaster* operator->() const
+    {
+      return &m_reader->m_current;
+    }
+
+    /**
+     * @brief Read the next chunk.
+     */
+    Iterator& operator++()
+    {
+      m_front = m_reader->next();
+      return *this;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same chunk.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_front == rhs.m_front;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different chunks.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_front != rhs.m_front;
+    }
+
+  private:
+
+    ChunkReader* m_reader;
+    Index m_front;
+  };
+
+  /**
+   * @brief Constructor.
+   * @param path The file path
+   * @param hdu The (0-based) HDU index
+   * @param thickness The chunk thickness, or 0 for sections
+   * @param prefetch Read the next chunk asynchronously
+   */
+  ChunkReader(const std::filesystem::path& path, Index hdu, Index thickness, bool prefetch) :
+      m_fits(path), m_hdu(hdu), m_thickness(thickness ? thickness : 1), m_is_section(thickness == 0),
+      m_prefetch(prefetch), m_length(0), m_front(0), m_current(), m_next(), m_pending()
+  {
+    m_fits.open();
+    const auto shape = m_fits.read_shape<-1>(m_hdu);
+    m_length = shape[shape.size() - 1];
+    m_shape = Position<TRaster::Dimension>(m_is_section ? shape.size() - 1 : shape.size());
+    std::copy_n(shape.begin(), m_shape.size(), m_shape.begin());
+    if (m_length > 0) {
+      read(0, m_current);
+      if (m_prefetch) {
+        prefetch_next();
+      }
+    }
+  }
+
+  ChunkReader(const ChunkReader&) = delete;
+  ChunkReader(ChunkReader&&) = delete;
+  ChunkReader& operator=(const ChunkReader&) = delete;
+  ChunkReader& operator=(ChunkReader&&) = delete;
+
+  /**
+   * @brief Destructor, which waits for the pending read, if any.
+   */
+  ~ChunkReader()
+  {
+    if (m_pending.valid()) {
+      m_pending.wait();
+    }
+  }
+
+  /**
+   * @brief Get an iterator to the current chunk.
+   */
+  Iterator begin()
+  {
+    return Iterator(this, m_front);
+  }
+
+  /**
+   * @brief Get the end iterator.
+   */
+  Iterator end()
+  {
+    return Iterator(this, m_length);
+  }
+
+private:
+
+  /**
+   * @brief Read the chunk at given front index into a buffer, which is reshaped if needed.
+   */
+  void read(Index front, TRaster& out)
+  {
+    if (not m_is_section) {
+      m_shape[m_shape.size() - 1] = std::min(m_thickness, m_length - front);
+    }
+    if (out.shape() != m_shape) {
+      out = TRaster(m_shape);
+    }
+    m_fits.read_chunk_to(front, out, m_hdu);
+  }
+
+  /**
+   * @brief Launch the asynchronous read of the chunk which follows the current one.
+   */
+  void prefetch_next()
+  {
+    const auto front = m_front + m_thickness;
+    if (front >= m_length) {
+      return;
+    }
+    if (not m_is_section) {
+      m_shape[m_shape.size() - 1] = std::min(m_thickness, m_length - front);
+    }
+    if (m_next.shape() != m_shape) {
+      m_next = TRaster(m_shape); // Allocate in the calling thread
+    }
+    m_pending = std::async(std::launch::async, [this, front]() {
+      m_fits.read_chunk_to(front, m_next, m_hdu);
+    });
+  }
+
+  /**
+   * @brief Move to the next chunk.
+   * @return The front index of the new chunk
+   */
+  Index next()
+  {
+    m_front = std::min(m_front + m_thickness, m_length);
+    if (m_front == m_length) {
+      return m_front;
+    }
+    if (m_prefetch) {
+      m_pending.get(); // Rethrows
+      std::swap(m_current, m_next);
+      prefetch_next();
+    } else {
+      read(m_front, m_current);
+    }
+    return m_front;
+  }
+
+  Fits m_fits;
+  Index m_hdu;
+  Index m_thickness;
+  bool m_is_section;
+  bool m_prefetch;
+  Index m_length;
+  Position<TRaster::Dimension> m_shape;
+  Index m_front;
+  TRaster m_current;
+  TRaster m_next;
+  std::future<void> m_pending;
+};
+
+} // namespace Linx
+
+#endif
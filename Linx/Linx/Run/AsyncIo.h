@@ -0,0 +1,353 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_ASYNCIO_H
+#define _LINXRUN_ASYNCIO_H
+
+#include "Linx/Base/TypeUtils.h" // Index
+#include "Linx/Run/StreamingPipeline.h" // BoundedQueue
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits> // decay_t, invoke_result_t
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief A small thread pool dedicated to I/O, e.g. to read the next inputs or write the products in the background.
+ *
+ * Tasks are executed in order of submission by a few threads, which mostly wait for the storage,
+ * such that they should not compete with the computing threads.
+ * The results, or the exceptions, are retrieved through futures.
+ * The destructor waits for the submitted tasks.
+ *
+ * \code
+ * IoPool io(2);
+ * auto next = io.submit([&]() { return Fits(names[i + 1]).read<Raster<float>>(); });
+ * process(current);
+ * auto written = io.submit([&]() { Fits(products[i]).write(current, 'w'); });
+ * current = next.get();
+ * written.get();
+ * \endcode
+ *
+ * @see `BufferPool`, `prefetch()`
+ */
+class IoPool {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param threads The number of I/O threads
+   * @param capacity The maximum number of pending tasks, above which `submit()` waits
+   */
+  explicit IoPool(Index threads = 2, Index capacity = 64) : m_tasks(capacity), m_threads()
+  {
+    m_threads.reserve(threads);
+    for (Index i = 0; i < threads; ++i) {
+      m_threads.emplace_back([&]() {
+        while (auto task = m_tasks.pop()) {
+          (*task)();
+        }
+      });
+    }
+  }
+
+  /**
+   * @brief Destructor, which waits for the pending tasks.
+   */
+  ~IoPool()
+  {
+    m_tasks.close();
+    for (auto& t : m_threads) {
+      t.join();
+    }
+  }
+
+  IoPool(const IoPool&) = delete;
+  IoPool& operator=(const IoPool&) = delete;
+
+  /**
+   * @brief Get the number of threads.
+   */
+  Index size() const
+  {
+    return m_threads.size();
+  }
+
+  /**
+   * @brief Submit a task.
+   * @return The future of the task result, which rethrows the task exception, if any
+   */
+  template <typename TFunc>
+  std::future<std::invoke_result_t<std::decay_t<TFunc>&>> submit(TFunc&& func)
+  {
+    std::packaged_task<std::invoke_result_t<std::decay_t<TFunc>&>()> task(std::forward<TFunc>(func));
+    auto out = task.get_future();
+    m_tasks.push(std::packaged_task<void()>([task = std::move(task)]() mutable {
+      task();
+    }));
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief The pending tasks.
+   */
+  Internal::BoundedQueue<std::packaged_task<void()>> m_tasks;
+
+  /**
+   * @brief The I/O threads.
+   */
+  std::vector<std::thread> m_threads;
+};
+
+/**
+ * @brief A fixed set of reusable buffers, e.g. rasters of the shape of the inputs.
+ *
+ * Buffers are handed out as shared pointers, which give the buffer back to the pool when released,
+ * even after the pool is destroyed.
+ * Since the number of buffers is fixed, the memory in flight is bounded:
+ * `acquire()` waits until a buffer is given back.
+ *
+ * \code
+ * BufferPool<Raster<float>> buffers(4, [&]() { return Raster<float>(shape); });
+ * \endcode
+ */
+template <typename T>
+class BufferPool {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param count The number of buffers
+   * @param factory The function which creates a buffer
+   */
+  template <typename TFactory>
+  BufferPool(Index count, TFactory&& factory) : m_state(std::make_shared<State>())
+  {
+    for (Index i = 0; i < count; ++i) {
+      m_state->buffers.push_back(std::make_unique<T>(factory()));
+      m_state->free.push_back(m_state->buffers.back().get());
+    }
+  }
+
+  /**
+   * @brief Get the number of buffers.
+   */
+  Index size() const
+  {
+    return m_state->buffers.size();
+  }
+
+  /**
+   * @brief Get the number of available buffers.
+   */
+  Index available() const
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->free.size();
+  }
+
+  /**
+   * @brief Get a buffer, waiting until one is available.
+   */
+  std::shared_ptr<T> acquire()
+  {
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->released.wait(lock, [&]() {
+      return not m_state->free.empty();
+    });
+    return pop();
+  }
+
+  /**
+   * @brief Get a buffer if one is available, or `nullptr` otherwise.
+   */
+  std::shared_ptr<T> try_acquire()
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->free.empty()) {
+      return nullptr;
+    }
+    return pop();
+  }
+
+private:
+
+  /**
+   * @brief The shared state, which is kept alive by the buffers in use.
+   */
+  struct State {
+    std::vector<std::unique_ptr<T>> buffers;
+    std::vector<T*> free;
+    std::mutex mutex;
+    std::condition_variable released;
+  };
+
+  /**
+   * @brief Pop a free buffer, assuming the mutex is locked.
+   */
+  std::shared_ptr<T> pop()
+  {
+    T* buffer = m_state->free.back();
+    m_state->free.pop_back();
+    return std::shared_ptr<T>(buffer, [state = m_state](T* ptr) {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->free.push_back(ptr);
+      }
+      state->released.notify_one();
+    });
+  }
+
+  /**
+   * @brief The state.
+   */
+  std::shared_ptr<State> m_state;
+};
+
+/**
+ * @brief An input sequence which is read ahead in the background.
+ * @see `prefetch()`
+ */
+template <typename T, typename TIn, typename TRead>
+class Prefetcher {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  Prefetcher(IoPool& io, BufferPool<T>& buffers, std::vector<TIn> inputs, TRead read, Index depth) :
+      m_io(io), m_buffers(buffers), m_inputs(std::move(inputs)), m_read(std::move(read)), m_depth(depth), m_next(0),
+      m_pending()
+  {
+    fill();
+  }
+
+  /**
+   * @brief Destructor, which waits for the pending reads.
+   */
+  ~Prefetcher()
+  {
+    for (auto& f : m_pending) {
+      f.wait();
+    }
+  }
+
+  Prefetcher(const Prefetcher&) = delete;
+  Prefetcher& operator=(const Prefetcher&) = delete;
+
+  /**
+   * @brief Get the next value, or `nullptr` if all the inputs were read.
+   *
+   * If the read function threw, the exception is rethrown.
+   */
+  std::shared_ptr<T> next()
+  {
+    if (m_pending.empty()) {
+      if (m_next >= static_cast<Index>(m_inputs.size())) {
+        return nullptr;
+      }
+      submit(m_buffers.acquire());
+    }
+    auto future = std::move(m_pending.front());
+    m_pending.pop_front();
+    auto out = future.get();
+    fill();
+    return out;
+  }
+
+  /**
+   * @brief Get the number of reads in flight.
+   */
+  Index pending() const
+  {
+    return m_pending.size();
+  }
+
+private:
+
+  /**
+   * @brief Submit reads while buffers are available, up to the depth.
+   */
+  void fill()
+  {
+    while (static_cast<Index>(m_pending.size()) < m_depth && m_next < static_cast<Index>(m_inputs.size())) {
+      auto buffer = m_buffers.try_acquire();
+      if (not buffer) {
+        return;
+      }
+      submit(std::move(buffer));
+    }
+  }
+
+  /**
+   * @brief Submit the read of the next input.
+   */
+  void submit(std::shared_ptr<T> buffer)
+  {
+    const auto& input = m_inputs[m_next];
+    ++m_next;
+    m_pending.push_back(m_io.submit([&read = m_read, &input, buffer = std::move(buffer)]() mutable {
+      read(input, *buffer);
+      return std::move(buffer); // Such that the task does not hold the buffer anymore
+    }));
+  }
+
+  IoPool& m_io;
+  BufferPool<T>& m_buffers;
+  std::vector<TIn> m_inputs;
+  TRead m_read;
+  Index m_depth;
+  Index m_next;
+  std::deque<std::future<std::shared_ptr<T>>> m_pending;
+};
+
+/**
+ * @relatesalso Prefetcher
+ * @brief Read a sequence of inputs ahead, in the background.
+ * @param io The I/O threads
+ * @param buffers The buffers into which the inputs are read
+ * @param inputs The inputs, e.g. file names
+ * @param read The read function, with signature `void(const TIn&, T&)`
+ * @param depth The maximum number of reads in flight
+ *
+ * Reads are submitted as long as buffers are available, such that the memory footprint is bounded by the pool.
+ * The consumer must give the buffers back by releasing them,
+ * and must hold less buffers than the pool size when calling `Prefetcher::next()`, otherwise it waits forever.
+ * Finished products can be written in the background with `IoPool::submit()`,
+ * in which case the buffer is given back once written.
+ *
+ * \code
+ * IoPool io(2);
+ * BufferPool<Raster<float>> buffers(4, [&]() { return Raster<float>(shape); });
+ * auto frames = prefetch(io, buffers, names, [](const auto& name, auto& out) {
+ *   Fits(name).read_to(out.domain(), out);
+ * });
+ * std::vector<std::future<void>> written;
+ * while (auto frame = frames.next()) {
+ *   calibrate(*frame);
+ *   written.push_back(io.submit([frame, name = product(frame)]() { Fits(name).write(*frame, 'w'); }));
+ * }
+ * for (auto& w : written) {
+ *   w.get();
+ * }
+ * \endcode
+ */
+template <typename T, typename TIn, typename TRead>
+Prefetcher<T, TIn, std::decay_t<TRead>>
+prefetch(IoPool& io, BufferPool<T>& buffers, std::vector<TIn> inputs, TRead&& read, Index depth = 2)
+{
+  return Prefetcher<T, TIn, std::decay_t<TRead>>(io, buffers, std::move(inputs), std::forward<TRead>(read), depth);
+}
+
+} // namespace Linx
+
+#endif
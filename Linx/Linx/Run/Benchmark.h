@@ -0,0 +1,530 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_BENCHMARK_H
+#define _LINXRUN_BENCHMARK_H
+
+#include "Linx/Base/DataDistribution.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Threads.h" // pin_thread
+#include "Linx/Base/TypeUtils.h" // Index
+#include "Linx/Run/PerfCounters.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Run/Timer.h"
+
+#include <chrono>
+#include <cmath> // abs, sqrt
+#include <fstream>
+#include <iostream> // cerr, cout
+#include <optional>
+#include <ratio>
+#include <string>
+#include <type_traits> // is_same_v
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief The parameters of a `Benchmark`.
+ */
+struct BenchmarkOptions {
+  /**
+   * @brief The number of untimed runs before the measurements.
+   */
+  Index warmup = 1;
+
+  /**
+   * @brief The minimum number of timed runs.
+   */
+  Index min_runs = 5;
+
+  /**
+   * @brief The maximum number of timed runs.
+   */
+  Index max_runs = 100;
+
+  /**
+   * @brief The maximum cumulated duration of the timed runs, in seconds, after which no run is added.
+   */
+  double max_seconds = 10;
+
+  /**
+   * @brief The target relative standard error of the median, or 0 to always perform `max_runs` runs.
+   */
+  double precision = 0.01;
+
+  /**
+   * @brief The outlier rejection threshold, in robust standard deviations from the median, or 0 to disable rejection.
+   */
+  double outlier = 5;
+
+  /**
+   * @brief The index of the CPU to which the benchmarking thread is pinned, or -1 to disable pinning.
+   */
+  Index cpu = -1;
+
+  /**
+   * @brief The number of bytes written before each run to evict the caches, or 0 to disable flushing.
+   */
+  Index flush_bytes = 0;
+
+  /**
+   * @brief The number of bytes read and written by each run, to report the bandwidth, or 0 if unknown.
+   */
+  Index bytes = 0;
+
+  /**
+   * @brief Whether to read the hardware performance counters around each run.
+   * @see `PerfCounters`
+   */
+  bool counters = false;
+
+  /**
+   * @brief Declare the options in a `ProgramOptions`, with the current values as defaults.
+   */
+  void declare(ProgramOptions& options) const
+  {
+    options.named("warmup", "Number of untimed warmup runs", warmup);
+    options.named("min-runs", "Minimum number of timed runs", min_runs);
+    options.named("max-runs", "Maximum number of timed runs", max_runs);
+    options.named("max-seconds", "Maximum cumulated duration of the timed runs (s)", max_seconds);
+    options.named("precision", "Target relative standard error of the median (or 0 to run max-runs times)", precision);
+    options.named("outlier", "Outlier rejection threshold in robust sigmas (or 0 to disable)", outlier);
+    options.named("cpu", "CPU to pin the benchmarking thread to (or -1 to disable)", cpu);
+    options.named("flush", "Number of bytes written before each run to flush caches (or 0 to disable)", flush_bytes);
+    options.flag("counters", "Read hardware performance counters (if available)");
+  }
+
+  /**
+   * @brief Read the options declared with `declare()` from a parsed `ProgramOptions`.
+   */
+  static BenchmarkOptions parse(const ProgramOptions& options)
+  {
+    BenchmarkOptions out;
+    out.warmup = options.as<Index>("warmup");
+    out.min_runs = options.as<Index>("min-runs");
+    out.max_runs = options.as<Index>("max-runs");
+    out.max_seconds = options.as<double>("max-seconds");
+    out.precision = options.as<double>("precision");
+    out.outlier = options.as<double>("outlier");
+    out.cpu = options.as<Index>("cpu");
+    out.flush_bytes = options.as<Index>("flush");
+    out.counters = options.as<bool>("counters");
+    return out;
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the symbol of a time unit.
+ */
+template <typename TUnit>
+const char* unit_symbol()
+{
+  using Period = typename TUnit::period;
+  if constexpr (std::is_same_v<Period, std::nano>) {
+    return "ns";
+  } else if constexpr (std::is_same_v<Period, std::micro>) {
+    return "us";
+  } else if constexpr (std::is_same_v<Period, std::milli>) {
+    return "ms";
+  } else if constexpr (std::is_same_v<Period, std::ratio<1>>) {
+    return "s";
+  } else {
+    return "";
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief A statistical benchmark runner.
+ * @tparam TUnit The time unit, which should have a floating point representation for short runs
+ *
+ * A function is run repeatedly after some warmup runs,
+ * until the median duration is known to some relative precision, or until a maximum number of runs or duration.
+ * The precision is estimated as the standard error of the median, computed from the median absolute deviation (MAD).
+ * Outliers, e.g. due to preemption, are rejected relative to the median and MAD.
+ * Optionally, an untimed setup function is called before each run, e.g. to reset the inputs,
+ * the caches are flushed, and the benchmarking thread is pinned to some CPU
+ * (which also pins the threads it spawns, e.g. with OpenMP, such that pinning is meant for serial benchmarks).
+ *
+ * To tell whether a function is memory or compute bound,
+ * the bandwidth can be reported if the number of bytes processed per run is given,
+ * and hardware performance counters (cycles, instructions, cache and branch misses) can be read around each run.
+ *
+ * \code
+ * Benchmark<> benchmark;
+ * benchmark.run([&]() { raster.exp(); });
+ * benchmark.report(std::cout); // 12.3 ms (MAD 0.1 ms, min 12.1 ms, 21 runs, 1 outlier)
+ * \endcode
+ */
+template <typename TUnit = std::chrono::duration<double, std::milli>>
+class Benchmark {
+public:
+
+  /**
+   * @brief The time unit.
+   */
+  using Unit = TUnit;
+
+  /**
+   * @brief Constructor.
+   */
+  explicit Benchmark(BenchmarkOptions options = {}) :
+      m_options(options), m_timer(), m_samples(), m_converged(false), m_counters()
+  {}
+
+  /**
+   * @brief Get the options.
+   */
+  const BenchmarkOptions& options() const
+  {
+    return m_options;
+  }
+
+  /**
+   * @brief Benchmark a function.
+   */
+  template <typename TFunc>
+  Benchmark& run(TFunc&& func)
+  {
+    return run(std::forward<TFunc>(func), []() {});
+  }
+
+  /**
+   * @brief Benchmark a function, with an untimed setup before each run.
+   */
+  template <typename TFunc, typename TSetup>
+  Benchmark& run(TFunc&& func, TSetup&& setup)
+  {
+    m_timer.reset();
+    m_converged = false;
+    m_counters = PerfSample();
+    std::optional<PerfCounters> counters;
+    if (m_options.counters) {
+      counters.emplace();
+      m_counters.counts.fill(0);
+    }
+    if (m_options.cpu >= 0 && not Internal::pin_thread(m_options.cpu)) {
+      std::cerr << "Warning: cannot pin thread to CPU " << m_options.cpu << std::endl;
+    }
+    std::vector<unsigned char> flush(m_options.flush_bytes);
+    const auto prepare = [&]() {
+      for (std::size_t i = 0; i < flush.size(); i += 64) { // Cache line size
+        ++flush[i];
+      }
+      setup();
+    };
+    for (Index i = 0; i < m_options.warmup; ++i) {
+      prepare();
+      func();
+    }
+    const auto max_duration = std::chrono::duration<double>(m_options.max_seconds);
+    while (static_cast<Index>(m_timer.size()) < m_options.max_runs) {
+      prepare();
+      if (counters) {
+        counters->start();
+      }
+      m_timer.start();
+      func();
+      m_timer.stop();
+      if (counters) {
+        m_counters += counters->stop();
+      }
+      if (static_cast<Index>(m_timer.size()) < m_options.min_runs) {
+        continue;
+      }
+      filter();
+      m_converged = m_options.precision > 0 && relative_error() <= m_options.precision;
+      if (m_converged || m_timer.total() >= max_duration) {
+        break;
+      }
+    }
+    filter();
+    if (counters) {
+      m_counters /= m_timer.size();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Get the timer of all the runs, including outliers.
+   */
+  const Timer<TUnit>& timer() const
+  {
+    return m_timer;
+  }
+
+  /**
+   * @brief Get the durations of the runs which were not rejected as outliers.
+   */
+  const std::vector<double>& samples() const
+  {
+    return m_samples;
+  }
+
+  /**
+   * @brief Get the distribution of the durations, without outliers.
+   */
+  DataDistribution<double> distribution() const
+  {
+    return DataDistribution<double>(m_samples);
+  }
+
+  /**
+   * @brief Get the number of rejected runs.
+   */
+  Index outliers() const
+  {
+    return m_timer.size() - m_samples.size();
+  }
+
+  /**
+   * @brief Check whether the target precision was reached.
+   */
+  bool converged() const
+  {
+    return m_converged;
+  }
+
+  /**
+   * @brief Get the mean hardware performance counts per run, including outliers.
+   *
+   * Counts are unavailable if disabled or not supported.
+   */
+  const PerfSample& counters() const
+  {
+    return m_counters;
+  }
+
+  /**
+   * @brief Get the bandwidth in GB/s, computed from the median duration, or 0 if the number of bytes is unknown.
+   */
+  double bandwidth() const
+  {
+    const std::chrono::duration<double, typename TUnit::period> median(distribution().median());
+    const auto seconds = std::chrono::duration<double>(median).count();
+    return seconds > 0 ? m_options.bytes / seconds * 1e-9 : 0;
+  }
+
+  /**
+   * @brief Get the estimated relative standard error of the median.
+   */
+  double relative_error() const
+  {
+    auto dist = distribution();
+    const auto median = dist.median();
+    if (median <= 0) {
+      return 0;
+    }
+    // Standard error of the median of a normal distribution, with sigma estimated from the MAD
+    return 1.2533 * 1.4826 * dist.mad() / std::sqrt(double(dist.size())) / median;
+  }
+
+  /**
+   * @brief Print the median, MAD and minimum durations, and the numbers of runs and outliers.
+   */
+  void report(std::ostream& out) const
+  {
+    const auto unit = Internal::unit_symbol<TUnit>();
+    auto dist = distribution();
+    out << dist.median() << " " << unit << " (MAD " << dist.mad() << " " << unit << ", min " << dist.min() << " "
+        << unit << ", " << m_timer.size() << " runs, " << outliers() << " outliers";
+    if (not m_converged && m_options.precision > 0) {
+      out << ", not converged";
+    }
+    out << ")";
+    if (m_options.bytes > 0) {
+      out << ", " << bandwidth() << " GB/s";
+    }
+    if (m_options.counters) {
+      out << "\n  " << m_counters;
+    }
+  }
+
+  /**
+   * @brief Get the comma-separated names of the columns written by `write_csv()`, without line break.
+   */
+  static std::string csv_header()
+  {
+    const std::string unit = Internal::unit_symbol<TUnit>();
+    return "median_" + unit + ",mad_" + unit + ",min_" + unit +
+        ",runs,outliers,converged,gbps,cycles,instructions,ipc,cache_misses,branch_misses";
+  }
+
+  /**
+   * @brief Write the results as comma-separated values, without line break, e.g. to compare runs in a spreadsheet.
+   *
+   * Unavailable counters are written as -1.
+   * @see `csv_header()`
+   */
+  void write_csv(std::ostream& out) const
+  {
+    auto dist = distribution();
+    out << dist.median() << ',' << dist.mad() << ',' << dist.min() << ',' << m_timer.size() << ',' << outliers() << ','
+        << m_converged << ',' << bandwidth() << ',' << m_counters[PerfSample::Cycles] << ','
+        << m_counters[PerfSample::Instructions] << ',' << m_counters.ipc() << ','
+        << m_counters[PerfSample::CacheMisses] << ',' << m_counters[PerfSample::BranchMisses];
+  }
+
+private:
+
+  /**
+   * @brief Select the samples which are not outliers.
+   */
+  void filter()
+  {
+    const auto& all = m_timer.container();
+    m_samples = all;
+    if (m_options.outlier <= 0 || all.size() < 3) {
+      return;
+    }
+    DataDistribution<double> dist(all);
+    const auto median = dist.median();
+    const auto threshold = m_options.outlier * 1.4826 * dist.mad();
+    if (threshold <= 0) {
+      return;
+    }
+    m_samples.clear();
+    for (auto d : all) {
+      if (std::abs(d - median) <= threshold) {
+        m_samples.push_back(d);
+      }
+    }
+  }
+
+  /**
+   * @brief The options.
+   */
+  BenchmarkOptions m_options;
+
+  /**
+   * @brief The timer of all the runs.
+   */
+  Timer<TUnit> m_timer;
+
+  /**
+   * @brief The durations of the accepted runs.
+   */
+  std::vector<double> m_samples;
+
+  /**
+   * @brief Whether the target precision was reached.
+   */
+  bool m_converged;
+
+  /**
+   * @brief The mean performance counts per run.
+   */
+  PerfSample m_counters;
+};
+
+/**
+ * @relatesalso Benchmark
+ * @brief Print a benchmark report.
+ */
+template <typename TUnit>
+std::ostream& operator<<(std::ostream& out, const Benchmark<TUnit>& benchmark)
+{
+  benchmark.report(out);
+  return out;
+}
+
+/**
+ * @brief A CSV table of benchmark results, with one row per benchmark case.
+ * 
+ * Each row is made of the case parameters followed by the `Benchmark::write_csv()` columns.
+ * The table is written to a file or to the standard output, depending on the `output` program option.
+ * 
+ * \code
+ * BenchmarkCsv<>::declare(options);
+ * options.parse(argc, argv);
+ * BenchmarkCsv<> csv(options, "operation,side");
+ * for (auto side : options.as_list<Index>("sides")) {
+ *   Benchmark<> benchmark;
+ *   benchmark.run(...);
+ *   csv.write(benchmark, "exp", side);
+ * }
+ * \endcode
+ */
+template <typename TUnit = std::chrono::duration<double, std::milli>>
+class BenchmarkCsv {
+public:
+
+  /**
+   * @brief Declare the `output` option in a `ProgramOptions`.
+   */
+  static void declare(ProgramOptions& options)
+  {
+    options.named("output", "Output CSV file (or - for the standard output)", std::string("-"));
+  }
+
+  /**
+   * @brief Open a file or the standard output and write the header.
+   * @param filename The file name, or `-` for the standard output
+   * @param columns The comma-separated names of the case parameters
+   */
+  BenchmarkCsv(const std::string& filename, const std::string& columns) : m_file()
+  {
+    if (filename != "-") {
+      m_file.open(filename);
+      if (not m_file) {
+        throw Exception("Cannot open CSV file: " + filename);
+      }
+    }
+    stream() << columns << ',' << Benchmark<TUnit>::csv_header() << std::endl;
+  }
+
+  /**
+   * @brief Open the file given by the `output` option and write the header.
+   */
+  BenchmarkCsv(const ProgramOptions& options, const std::string& columns) :
+      BenchmarkCsv(options.as<std::string>("output"), columns)
+  {}
+
+  /**
+   * @brief Check whether the table is written to a file rather than to the standard output.
+   * 
+   * This is typically used to print human-readable reports to the standard output only when it is free.
+   */
+  bool is_file() const
+  {
+    return m_file.is_open();
+  }
+
+  /**
+   * @brief Write a row made of the case parameters and the benchmark results.
+   */
+  template <typename... Ts>
+  void write(const Benchmark<TUnit>& benchmark, const Ts&... parameters)
+  {
+    auto& out = stream();
+    ((out << parameters << ','), ...);
+    benchmark.write_csv(out);
+    out << std::endl;
+  }
+
+private:
+
+  /**
+   * @brief Get the output stream.
+   */
+  std::ostream& stream()
+  {
+    return is_file() ? m_file : std::cout;
+  }
+
+  /**
+   * @brief The output file, if any.
+   */
+  std::ofstream m_file;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,274 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_MPIEXECUTOR_H
+#define _LINXRUN_MPIEXECUTOR_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Tiling.h" // HaloTile
+
+#include <algorithm> // min
+#include <cstdint>
+#include <exception> // terminate
+#include <iostream> // cerr
+#include <mpi.h>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief Executor which distributes tiles across the ranks of an MPI communicator, e.g. to process large mosaics.
+ *
+ * This header is optional: it requires an MPI implementation, which the rest of the library does not depend on.
+ * Programs are compiled with e.g. `mpicxx` and launched with `mpirun`.
+ *
+ * Rank 0 is the coordinator: it hands out the tiles dynamically to the other ranks, the workers,
+ * such that slower (e.g. border) tiles do not unbalance the ranks,
+ * and it gathers the processed tiles, which it writes, e.g. into a FITS file with `Fits::write_region()`.
+ * Workers read their inputs themselves, e.g. the outer box of the tile from a shared file system,
+ * such that only the results are transferred.
+ * On a single rank, tiles are processed sequentially by rank 0.
+ *
+ * Each tile is processed by three functions:
+ * - `read(tile)` is called by a worker and returns the input, e.g. the outer box of the input image;
+ * - `process(tile, input)` is called by a worker and returns the result, as a `Raster<T, N>` of shape `tile.inner`;
+ * - `write(tile, result)` is called by rank 0.
+ *
+ * \code
+ * MPI_Init(&argc, &argv);
+ * {
+ *   MpiExecutor executor;
+ *   if (executor.rank() == 0) {
+ *     Fits(output).write(Raster<float>(shape), 'w'); // Allocate the output file
+ *   }
+ *   MPI_Barrier(MPI_COMM_WORLD);
+ *   const auto domain = Box<2>::from_shape(Position<2>::zero(), shape);
+ *   const auto tiles = halo_tiles(domain, Position<2> {1024, 1024}, Box<2>::from_center(radius));
+ *   executor.run<float>(
+ *       tiles,
+ *       [&](const auto& tile) { return Fits(input).read<Raster<float>>(tile.outer & domain); },
+ *       [&](const auto& tile, const auto& in) { return filter(tile, in); },
+ *       [&](const auto& tile, const auto& out) { Fits(output).write_region(out, tile.inner); });
+ * }
+ * MPI_Finalize();
+ * \endcode
+ */
+class MpiExecutor {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param comm The communicator, which must outlive the executor
+   *
+   * MPI must be initialized.
+   */
+  explicit MpiExecutor(MPI_Comm comm = MPI_COMM_WORLD) : m_comm(comm), m_rank(0), m_size(1)
+  {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (not initialized) {
+      throw Exception("MPI is not initialized");
+    }
+    int value = 0;
+    MPI_Comm_rank(m_comm, &value);
+    m_rank = value;
+    MPI_Comm_size(m_comm, &value);
+    m_size = value;
+  }
+
+  /**
+   * @brief Get the rank of the calling process.
+   */
+  Index rank() const
+  {
+    return m_rank;
+  }
+
+  /**
+   * @brief Get the number of ranks.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the number of tiles processed by each worker during the last run (rank 0 only).
+   */
+  const std::vector<Index>& counts() const
+  {
+    return m_counts;
+  }
+
+  /**
+   * @brief Process tiles across the ranks.
+   * @tparam T The value type of the results
+   * @param tiles The tiles, which must be the same on all ranks
+   * @param read The function which reads the input of a tile
+   * @param process The function which processes a tile, and returns a `Raster<T, N>` of shape `tile.inner.shape()`
+   * @param write The function which writes the result of a tile, on rank 0
+   *
+   * The function is collective: it must be called by all the ranks, and returns when all the tiles are written.
+   *
+   * On several ranks, if a function throws, e.g. because a processed tile has the wrong shape,
+   * the other ranks would wait forever for the messages of the failing rank:
+   * the error is printed to the standard error and the communicator is aborted with `MPI_Abort()` instead.
+   */
+  template <typename T, Index N, typename TRead, typename TProcess, typename TWrite>
+  void run(const std::vector<HaloTile<N>>& tiles, TRead&& read, TProcess&& process, TWrite&& write)
+  {
+    m_counts.assign(m_size, 0);
+    if (m_size == 1) {
+      for (const auto& tile : tiles) {
+        write(tile, process(tile, read(tile)));
+        ++m_counts[0];
+      }
+    } else {
+      try {
+        if (m_rank == 0) {
+          coordinate<T>(tiles, write);
+        } else {
+          work<T>(tiles, read, process);
+        }
+      } catch (const std::exception& e) {
+        abort(e.what());
+      } catch (...) {
+        abort("Unknown error");
+      }
+    }
+    MPI_Barrier(m_comm);
+  }
+
+private:
+
+  /**
+   * @brief The message tags.
+   */
+  enum Tag {
+    Request = 1, ///< Worker to coordinator: index of the processed tile, or -1 initially
+    Result = 2, ///< Worker to coordinator: values of the processed tile
+    Assign = 3 ///< Coordinator to worker: index of the next tile, or -1 to stop
+  };
+
+  /**
+   * @brief Hand out the tiles and write the results.
+   */
+  template <typename T, Index N, typename TWrite>
+  void coordinate(const std::vector<HaloTile<N>>& tiles, TWrite& write)
+  {
+    const auto count = static_cast<std::int64_t>(tiles.size());
+    std::int64_t next = 0;
+    Index running = m_size - 1;
+    while (running > 0) {
+      std::int64_t done = -1;
+      MPI_Status status;
+      MPI_Recv(&done, 1, MPI_INT64_T, MPI_ANY_SOURCE, Request, m_comm, &status);
+      const auto worker = status.MPI_SOURCE;
+      if (done >= 0) {
+        const auto& tile = tiles[done];
+        Raster<T, N> result(tile.inner.shape());
+        receive(result, worker);
+        write(tile, result);
+        ++m_counts[worker];
+      }
+      std::int64_t assigned = next < count ? next++ : -1;
+      if (assigned < 0) {
+        --running;
+      }
+      MPI_Send(&assigned, 1, MPI_INT64_T, worker, Assign, m_comm);
+    }
+  }
+
+  /**
+   * @brief Process the assigned tiles until told to stop.
+   */
+  template <typename T, Index N, typename TRead, typename TProcess>
+  void work(const std::vector<HaloTile<N>>& tiles, TRead& read, TProcess& process)
+  {
+    std::int64_t done = -1;
+    MPI_Send(&done, 1, MPI_INT64_T, 0, Request, m_comm);
+    while (true) {
+      std::int64_t assigned = -1;
+      MPI_Recv(&assigned, 1, MPI_INT64_T, 0, Assign, m_comm, MPI_STATUS_IGNORE);
+      if (assigned < 0) {
+        return;
+      }
+      const auto& tile = tiles[assigned];
+      const Raster<T, N> result = process(tile, read(tile));
+      if (result.shape() != tile.inner.shape()) {
+        throw Exception("Processed tile shape differs from the inner box shape");
+      }
+      MPI_Send(&assigned, 1, MPI_INT64_T, 0, Request, m_comm);
+      send(result, 0);
+    }
+  }
+
+  /**
+   * @brief Print an error and abort all the ranks of the communicator.
+   */
+  [[noreturn]] void abort(const char* message)
+  {
+    std::cerr << "Rank " << m_rank << " failed: " << message << std::endl;
+    MPI_Abort(m_comm, 1);
+    std::terminate(); // MPI_Abort should not return
+  }
+
+  /**
+   * @brief Send the values of a raster, by blocks of at most 1 GiB.
+   */
+  template <typename T, Index N>
+  void send(const Raster<T, N>& raster, int destination)
+  {
+    const auto* data = reinterpret_cast<const char*>(raster.data());
+    const std::int64_t bytes = raster.size() * sizeof(T);
+    for (std::int64_t offset = 0; offset < bytes; offset += block_bytes) {
+      const int length = static_cast<int>(std::min(bytes - offset, block_bytes));
+      MPI_Send(data + offset, length, MPI_BYTE, destination, Result, m_comm);
+    }
+  }
+
+  /**
+   * @brief Receive the values of a raster sent with `send()`.
+   */
+  template <typename T, Index N>
+  void receive(Raster<T, N>& raster, int source)
+  {
+    auto* data = reinterpret_cast<char*>(raster.data());
+    const std::int64_t bytes = raster.size() * sizeof(T);
+    for (std::int64_t offset = 0; offset < bytes; offset += block_bytes) {
+      const int length = static_cast<int>(std::min(bytes - offset, block_bytes));
+      MPI_Recv(data + offset, length, MPI_BYTE, source, Result, m_comm, MPI_STATUS_IGNORE);
+    }
+  }
+
+  /**
+   * @brief The maximum size of a message, in bytes.
+   */
+  static constexpr std::int64_t block_bytes = std::int64_t(1) << 30;
+
+  /**
+   * @brief The communicator.
+   */
+  MPI_Comm m_comm;
+
+  /**
+   * @brief The rank.
+   */
+  Index m_rank;
+
+  /**
+   * @brief The number of ranks.
+   */
+  Index m_size;
+
+  /**
+   * @brief The numbers of processed tiles per rank.
+   */
+  std::vector<Index> m_counts;
+};
+
+} // namespace Linx
+
+#endif
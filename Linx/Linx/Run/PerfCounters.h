@@ -0,0 +1,325 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_PERFCOUNTERS_H
+#define _LINXRUN_PERFCOUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#ifdef __linux__
+#include <cstring> // memset
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @brief A sample of hardware performance counters.
+ *
+ * Counters which are not available are set to -1.
+ * @see `PerfCounters`
+ */
+struct PerfSample {
+  /**
+   * @brief The counted events.
+   */
+  enum Event {
+    Cycles = 0, ///< CPU cycles
+    Instructions, ///< Retired instructions
+    CacheReferences, ///< Last-level cache references
+    CacheMisses, ///< Last-level cache misses
+    Branches, ///< Retired branch instructions
+    BranchMisses ///< Mispredicted branches
+  };
+
+  /**
+   * @brief The number of events.
+   */
+  static constexpr std::size_t Size = 6;
+
+  /**
+   * @brief The event counts, indexed by `Event`.
+   */
+  std::array<double, Size> counts {-1, -1, -1, -1, -1, -1};
+
+  /**
+   * @brief Get the count of some event, or -1 if unavailable.
+   */
+  double operator[](Event event) const
+  {
+    return counts[event];
+  }
+
+  /**
+   * @brief Check whether some event was counted.
+   */
+  bool has(Event event) const
+  {
+    return counts[event] >= 0;
+  }
+
+  /**
+   * @brief Check whether any event was counted.
+   */
+  bool available() const
+  {
+    for (auto c : counts) {
+      if (c >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Get the number of instructions per cycle, or -1 if unavailable.
+   */
+  double ipc() const
+  {
+    return ratio(Instructions, Cycles);
+  }
+
+  /**
+   * @brief Get the ratio of cache misses to cache references, or -1 if unavailable.
+   */
+  double cache_miss_rate() const
+  {
+    return ratio(CacheMisses, CacheReferences);
+  }
+
+  /**
+   * @brief Get the ratio of branch misses to branches, or -1 if unavailable.
+   */
+  double branch_miss_rate() const
+  {
+    return ratio(BranchMisses, Branches);
+  }
+
+  /**
+   * @brief Add the counts of another sample, e.g. to accumulate runs.
+   */
+  PerfSample& operator+=(const PerfSample& rhs)
+  {
+    for (std::size_t i = 0; i < Size; ++i) {
+      counts[i] = counts[i] < 0 || rhs.counts[i] < 0 ? -1 : counts[i] + rhs.counts[i];
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Divide the counts, e.g. to average runs.
+   */
+  PerfSample& operator/=(double rhs)
+  {
+    for (auto& c : counts) {
+      c = c < 0 ? -1 : c / rhs;
+    }
+    return *this;
+  }
+
+private:
+
+  double ratio(Event num, Event den) const
+  {
+    return has(num) && has(den) && counts[den] > 0 ? counts[num] / counts[den] : -1;
+  }
+};
+
+/**
+ * @relatesalso PerfSample
+ * @brief Print the available counts and ratios.
+ */
+inline std::ostream& operator<<(std::ostream& out, const PerfSample& sample)
+{
+  if (not sample.available()) {
+    return out << "counters unavailable";
+  }
+  const char* sep = "";
+  const auto print = [&](const char* name, double value) {
+    if (value >= 0) {
+      out << sep << name << " " << value;
+      sep = ", ";
+    }
+  };
+  print("cycles", sample[PerfSample::Cycles]);
+  print("instructions", sample[PerfSample::Instructions]);
+  print("IPC", sample.ipc());
+  print("cache misses", sample[PerfSample::CacheMisses]);
+  print("cache miss rate", sample.cache_miss_rate());
+  print("branch misses", sample[PerfSample::BranchMisses]);
+  print("branch miss rate", sample.branch_miss_rate());
+  return out;
+}
+
+/**
+ * @brief Hardware performance counters of the calling thread, e.g. to know whether a kernel is memory or compute bound.
+ *
+ * On Linux, events are counted with `perf_event_open()` in user space only, as a group.
+ * Elsewhere, or if the kernel refuses (e.g. due to `/proc/sys/kernel/perf_event_paranoid`,
+ * a container, or a virtual machine without PMU), counters are unavailable and samples are filled with -1.
+ * Counts are scaled if the kernel multiplexes the counters.
+ *
+ * Only the thread which created the counters is monitored, such that parallel kernels are under-counted:
+ * the counters are better suited to serial benchmarks, e.g. with `Threads(1)`.
+ *
+ * \code
+ * PerfCounters counters;
+ * counters.start();
+ * convolution * extrapolation(raster);
+ * std::cout << counters.stop() << std::endl; // cycles 1.2e+09, instructions 3.4e+09, IPC 2.8, ...
+ * \endcode
+ *
+ * @see `Benchmark`, `StepperPipeline::counters()`
+ */
+class PerfCounters {
+public:
+
+  /**
+   * @brief Open the counters.
+   */
+  PerfCounters() : m_fds(), m_indices(), m_leader(-1), m_start()
+  {
+    m_fds.fill(-1);
+    m_indices.fill(-1);
+#ifdef __linux__
+    static constexpr std::array<std::uint64_t, PerfSample::Size> configs {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    int opened = 0;
+    for (std::size_t i = 0; i < PerfSample::Size; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.disabled = m_leader < 0;
+      attr.inherit = 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int fd = syscall(__NR_perf_event_open, &attr, 0, -1, m_leader, 0);
+      if (fd < 0) {
+        continue;
+      }
+      if (m_leader < 0) {
+        m_leader = fd;
+      }
+      m_fds[i] = fd;
+      m_indices[i] = opened;
+      ++opened;
+    }
+    if (m_leader >= 0) {
+      ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+  }
+
+  /**
+   * @brief Close the counters.
+   */
+  ~PerfCounters()
+  {
+#ifdef __linux__
+    for (auto fd : m_fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /**
+   * @brief Check whether some counter could be opened.
+   */
+  bool available() const
+  {
+    return m_leader >= 0;
+  }
+
+  /**
+   * @brief Read the cumulated counts since the creation.
+   */
+  PerfSample read() const
+  {
+    PerfSample out;
+#ifdef __linux__
+    if (m_leader < 0) {
+      return out;
+    }
+    std::array<std::uint64_t, 3 + PerfSample::Size> buffer {};
+    if (::read(m_leader, buffer.data(), sizeof(buffer)) <= 0) {
+      return out;
+    }
+    // Layout: nr, time_enabled, time_running, values[nr]
+    const double enabled = buffer[1];
+    const double running = buffer[2];
+    const double scale = running > 0 ? enabled / running : 0;
+    for (std::size_t i = 0; i < PerfSample::Size; ++i) {
+      if (m_indices[i] >= 0) {
+        out.counts[i] = buffer[3 + m_indices[i]] * scale;
+      }
+    }
+#endif
+    return out;
+  }
+
+  /**
+   * @brief Start a measurement.
+   */
+  void start()
+  {
+    m_start = read();
+  }
+
+  /**
+   * @brief Stop a measurement and get the counts since `start()`.
+   */
+  PerfSample stop() const
+  {
+    auto out = read();
+    for (std::size_t i = 0; i < PerfSample::Size; ++i) {
+      out.counts[i] = out.counts[i] < 0 || m_start.counts[i] < 0 ? -1 : out.counts[i] - m_start.counts[i];
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief The file descriptors, or -1 for unavailable events.
+   */
+  std::array<int, PerfSample::Size> m_fds;
+
+  /**
+   * @brief The positions of the events in the group, or -1 for unavailable events.
+   */
+  std::array<int, PerfSample::Size> m_indices;
+
+  /**
+   * @brief The group leader file descriptor, or -1 if no counter is available.
+   */
+  int m_leader;
+
+  /**
+   * @brief The counts at `start()`.
+   */
+  PerfSample m_start;
+};
+
+} // namespace Linx
+
+#endif
@@ -6,6 +6,7 @@
 #define _LINXRUN_PIPELINESTEP_H
 
 #include <tuple>
+#include <type_traits> // is_base_of_v
 
 namespace Linx {
 
@@ -55,6 +56,29 @@ struct PipelineStep<T(TSteps...)> {
   static constexpr std::size_t Cardinality = sizeof...(TSteps);
 };
 
+/**
+ * @brief Base class of the steps whose values can be cached.
+ * 
+ * Usage:
+ * \code
+ * struct MasterDark : PipelineStep<Raster<float>(Bias)>, CachedStep {
+ *   static constexpr const char* Name = "MasterDark";
+ * };
+ * \endcode
+ * 
+ * @see `StepperPipeline::cache()`
+ */
+struct CachedStep {};
+
+/**
+ * @brief Check whether a step can be cached.
+ */
+template <typename S>
+constexpr bool is_cached_step()
+{
+  return std::is_base_of_v<CachedStep, S>;
+}
+
 } // namespace Linx
 
 #endif
@@ -5,11 +5,16 @@
 #ifndef _LINXRUN_PROGRAMOPTIONS_H
 #define _LINXRUN_PROGRAMOPTIONS_H
 
+#include "Linx/Base/MemoryBudget.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/Trace.h"
 #include "Linx/Base/TypeUtils.h" // LINX_FORWARD
 
 #include <boost/program_options.hpp>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace Linx {
 
@@ -38,6 +43,9 @@ namespace po = boost::program_options;
  * 
  * After parsing, arguments are queried with `as()`.
  * 
+ * Standard performance options can be declared with `performance()`,
+ * in which case the process-wide execution settings are configured by `parse()`.
+ * 
  * Here is an example command line with every kind of options:
  * 
  * `tree -d -L 2 --sort=size ~`
@@ -260,7 +268,7 @@ public:
    */
   ProgramOptions(const std::string& description = "", const std::string& help = "help,h") :
       m_named("Options", 120), m_add(m_named.add_options()), m_positional(), m_variables(), m_desc(description),
-      m_help(help)
+      m_help(help), m_performance(false)
   {
     if (m_help.length() > 0) {
       flag(m_help.c_str(), "Print help message");
@@ -331,6 +339,24 @@ public:
     m_desc.flag(name, description);
   }
 
+  /**
+   * @brief Declare the standard performance options, which are applied by `parse()`.
+   * 
+   * The options are:
+   * - `--threads`: the process-wide maximum number of threads, see `Threads::limit()`;
+   * - `--pin`: pin the threads to successive CPUs, see `Threads::pin()`;
+   * - `--memory`: the memory budget in MiB for streaming, see `MemoryBudget`;
+   * - `--trace`: the output file of the trace events, written at exit, see `Trace`.
+   */
+  void performance()
+  {
+    named("threads", "Maximum number of threads (or 0 for the OpenMP default)", Index(0));
+    flag("pin", "Pin threads to successive CPUs");
+    named("memory", "Memory budget for streaming, in MiB (or 0 for unlimited)", Index(0));
+    named("trace", "Output file of the trace events (requires LINX_TRACE at compile time)", std::string());
+    m_performance = true;
+  }
+
   /**
    * @brief Parse a command line.
    * 
@@ -351,6 +377,9 @@ public:
       m_desc.to_stream(argv[0], std::cerr);
       std::rethrow_exception(std::current_exception());
     }
+    if (m_performance) {
+      configure();
+    }
   }
 
   /**
@@ -405,8 +434,61 @@ public:
     return m_variables[name].as<T>();
   }
 
+  /**
+   * @brief Get the values of a comma-separated list option, e.g. a parameter sweep.
+   * 
+   * The option is declared as a string, e.g. `options.named("sides", "Image sides", std::string("512,2048"))`,
+   * and each non-empty item is converted to `T`, e.g. `options.as_list<Index>("sides")`.
+   */
+  template <typename T = std::string>
+  std::vector<T> as_list(const char* name) const
+  {
+    std::vector<T> out;
+    std::istringstream is(as<std::string>(name));
+    std::string item;
+    while (std::getline(is, item, ',')) {
+      if (item.empty()) {
+        continue;
+      }
+      if constexpr (std::is_same_v<T, std::string>) {
+        out.push_back(item);
+      } else {
+        std::istringstream iss(item);
+        T value;
+        if (not(iss >> value)) {
+          throw std::invalid_argument(std::string("Invalid item of option ") + name + ": " + item);
+        }
+        out.push_back(value);
+      }
+    }
+    return out;
+  }
+
 private:
 
+  /**
+   * @brief Apply the performance options.
+   */
+  void configure() const
+  {
+    const auto threads = as<Index>("threads");
+    Threads::limit(threads);
+#ifdef _OPENMP
+    if (threads > 0) {
+      omp_set_num_threads(static_cast<int>(threads));
+    }
+#endif
+    if (as<bool>("pin") && not Threads::pin()) {
+      std::cerr << "WARNING: Cannot pin threads.\n";
+    }
+    MemoryBudget::limit(as<Index>("memory") << 20);
+    const auto trace = as<std::string>("trace");
+    if (not trace.empty() && not Trace::enabled()) {
+      std::cerr << "WARNING: Tracing is disabled; compile with LINX_TRACE.\n";
+    }
+    Trace::write_at_exit(trace);
+  }
+
   /**
    * @brief Declare a positional option with custom semantics.
    */
@@ -435,6 +517,7 @@ private:
   po::variables_map m_variables;
   Help m_desc;
   std::string m_help;
+  bool m_performance;
 };
 
 } // namespace Linx
@@ -0,0 +1,296 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_STEPCACHE_H
+#define _LINXRUN_STEPCACHE_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Raw.h"
+
+#include <any>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits> // enable_if_t, is_trivially_copyable_v
+
+namespace Linx {
+
+/**
+ * @brief Compute a 64-bit FNV-1a hash of some bytes, which is stable across runs and platforms.
+ * @param data The bytes
+ * @param size The number of bytes
+ * @param seed The hash to be extended, e.g. of previous bytes
+ */
+inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ULL)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  auto out = seed;
+  for (std::size_t i = 0; i < size; ++i) {
+    out ^= bytes[i];
+    out *= 1099511628211ULL;
+  }
+  return out;
+}
+
+/**
+ * @brief Hash a step parameter, e.g. to compute the cache key of a step.
+ *
+ * Trivially copyable values are hashed bytewise,
+ * and strings, rasters and contiguous containers of trivially copyable values are hashed elementwise.
+ */
+template <typename T>
+std::uint64_t hash_value(const T& value, std::uint64_t seed = fnv1a(nullptr, 0))
+{
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    return fnv1a(&value, sizeof(T), seed);
+  } else {
+    using Value = std::decay_t<decltype(*value.data())>;
+    static_assert(std::is_trivially_copyable_v<Value>, "Cannot hash this type.");
+    if constexpr (is_raster<T>()) {
+      const auto shape = value.shape();
+      seed = fnv1a(shape.data(), shape.size() * sizeof(Index), seed);
+    }
+    return fnv1a(value.data(), value.size() * sizeof(Value), seed);
+  }
+}
+
+/**
+ * @brief Serialization of cached step values, to be specialized for persistent caching of custom types.
+ *
+ * Specializations must provide the following static functions:
+ * - `void write(const std::filesystem::path& path, const T& value)`;
+ * - `T read(const std::filesystem::path& path)`.
+ *
+ * Specializations are provided for trivially copyable types, which are written bytewise after a small header,
+ * and for rasters, which are written with `Raw`, the fast native format.
+ * In both cases, the value type is stored in the header and checked when reading,
+ * and a `FileFormatError` is thrown if the value cannot be written or read.
+ */
+template <typename T, typename = void>
+struct StepSerializer {
+  /**
+   * @brief Whether the type can be serialized.
+   */
+  static constexpr bool Enabled = false;
+};
+
+/// @copydoc StepSerializer
+template <typename T>
+struct StepSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  /// @copydoc StepSerializer::Enabled
+  static constexpr bool Enabled = true;
+
+  /**
+   * @brief Write a value, after a header made of a magic number and the type code.
+   */
+  static void write(const std::filesystem::path& path, const T& value)
+  {
+    const std::int64_t header[2] = {magic(), Raw::typecode<T>()};
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    file.close();
+    if (not file) {
+      throw FileFormatError("Cannot write cached value", path);
+    }
+  }
+
+  /**
+   * @brief Read a value, and check the header and size.
+   */
+  static T read(const std::filesystem::path& path)
+  {
+    std::int64_t header[2] = {0, 0};
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (not file || header[0] != magic()) {
+      throw FileFormatError("Not a cached value", path);
+    }
+    if (header[1] != Raw::typecode<T>()) {
+      throw FileFormatError("Type mismatch: " + std::to_string(header[1]) + " in", path);
+    }
+    T out;
+    file.read(reinterpret_cast<char*>(&out), sizeof(T));
+    if (not file || file.peek() != std::ifstream::traits_type::eof()) {
+      throw FileFormatError("Size mismatch in", path);
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Get the magic number which starts the header.
+   */
+  static constexpr std::int64_t magic()
+  {
+    return 0x5453584e494c; // "LINXST" in native byte order
+  }
+};
+
+/// @copydoc StepSerializer
+template <typename T, Index N, typename THolder>
+struct StepSerializer<Raster<T, N, THolder>> {
+  /// @copydoc StepSerializer::Enabled
+  static constexpr bool Enabled = true;
+
+  /**
+   * @brief Write a raster.
+   */
+  static void write(const std::filesystem::path& path, const Raster<T, N, THolder>& value)
+  {
+    Raw(path).write(value, 'w');
+  }
+
+  /**
+   * @brief Read a raster.
+   */
+  static Raster<T, N, THolder> read(const std::filesystem::path& path)
+  {
+    return Raw(path).read<Raster<T, N, THolder>>();
+  }
+};
+
+/**
+ * @brief A cache of step values, keyed by a hash of the step name, parameters and inputs.
+ *
+ * Values are always kept in memory, and optionally written to a directory,
+ * such that they persist across runs, if the type has an enabled `StepSerializer`.
+ * Files are named after the key, and are never deleted automatically.
+ * Errors while writing or reading files are not silenced, e.g. `store()` throws if the disk is full.
+ * The cache is thread-safe.
+ *
+ * @see `StepperPipeline::cache()`
+ */
+class StepCache {
+public:
+
+  /**
+   * @brief Create an in-memory cache.
+   */
+  StepCache() : m_directory(), m_values(), m_hits(0), m_misses(0) {}
+
+  /**
+   * @brief Create a persistent cache, backed by some directory, which is created if needed.
+   */
+  explicit StepCache(std::filesystem::path directory) : StepCache()
+  {
+    std::filesystem::create_directories(directory);
+    m_directory = std::move(directory);
+  }
+
+  /**
+   * @brief Get the number of successful lookups.
+   */
+  Index hits() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+  }
+
+  /**
+   * @brief Get the number of failed lookups.
+   */
+  Index misses() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+  }
+
+  /**
+   * @brief Look a value up, in memory first, and then on disk.
+   */
+  template <typename T>
+  std::optional<T> load(std::uint64_t key)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_values.find(key);
+    if (it != m_values.end()) {
+      if (const auto* value = std::any_cast<T>(&it->second)) {
+        ++m_hits;
+        return *value;
+      }
+    }
+    if constexpr (StepSerializer<T>::Enabled) {
+      if (m_directory) {
+        const auto path = file(key);
+        if (std::filesystem::exists(path)) {
+          auto value = StepSerializer<T>::read(path);
+          m_values[key] = value;
+          ++m_hits;
+          return value;
+        }
+      }
+    }
+    ++m_misses;
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Store a value, in memory, and on disk if persistent.
+   */
+  template <typename T>
+  void store(std::uint64_t key, const T& value)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_values[key] = value;
+    if constexpr (StepSerializer<T>::Enabled) {
+      if (m_directory) {
+        StepSerializer<T>::write(file(key), value);
+      }
+    }
+  }
+
+  /**
+   * @brief Clear the in-memory values (files are kept).
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_values.clear();
+  }
+
+private:
+
+  /**
+   * @brief Get the file path of a key.
+   */
+  std::filesystem::path file(std::uint64_t key) const
+  {
+    return *m_directory / (std::to_string(key) + ".step");
+  }
+
+  /**
+   * @brief The directory, if persistent.
+   */
+  std::optional<std::filesystem::path> m_directory;
+
+  /**
+   * @brief The in-memory values.
+   */
+  std::map<std::uint64_t, std::any> m_values;
+
+  /**
+   * @brief The number of hits.
+   */
+  Index m_hits;
+
+  /**
+   * @brief The number of misses.
+   */
+  Index m_misses;
+
+  /**
+   * @brief The mutex.
+   */
+  mutable std::mutex m_mutex;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,213 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_STEPRECORD_H
+#define _LINXRUN_STEPRECORD_H
+
+#include "Linx/Base/AllocationStats.h"
+#include "Linx/Base/TypeUtils.h" // Index
+#include "Linx/Run/PerfCounters.h"
+
+#include <cstdlib> // free
+#include <ctime> // clock
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // getrusage
+#endif
+
+#ifdef __GNUG__
+#include <cxxabi.h> // __cxa_demangle
+#endif
+
+namespace Linx {
+
+/**
+ * @brief The instrumentation record of a pipeline step evaluation.
+ * @see `StepperPipeline::records()`
+ */
+struct StepRecord {
+  /**
+   * @brief The step name, i.e. the demangled type name if available.
+   */
+  std::string name;
+
+  /**
+   * @brief The index of the thread which evaluated the step, in order of appearance.
+   */
+  Index thread = 0;
+
+  /**
+   * @brief The start time, in microseconds since the pipeline creation.
+   */
+  double start_us = 0;
+
+  /**
+   * @brief The wall-clock time, in milliseconds.
+   */
+  double wall_ms = 0;
+
+  /**
+   * @brief The process CPU time, in milliseconds.
+   *
+   * This includes the worker threads of the step, but also concurrent steps, if any.
+   */
+  double cpu_ms = 0;
+
+  /**
+   * @brief The increase of the peak resident set size of the process, in bytes, or 0 if unavailable.
+   */
+  long long peak_rss_delta = 0;
+
+  /**
+   * @brief The allocation statistics of the holders allocated by the evaluating thread.
+   *
+   * Statistics are recorded only if `LINX_TRACK_ALLOCATIONS` is defined.
+   * @see `AllocationScope`
+   */
+  AllocationStats allocations;
+
+  /**
+   * @brief The hardware performance counts of the evaluating thread.
+   *
+   * Counts are read only if enabled with `StepperPipeline::counters()` and supported, and are -1 otherwise.
+   */
+  PerfSample counters;
+
+  /**
+   * @brief Get the average number of busy threads, i.e. the ratio of the CPU time to the wall-clock time.
+   */
+  double utilization() const
+  {
+    return wall_ms > 0 ? cpu_ms / wall_ms : 0;
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the readable name of a type.
+ */
+inline std::string type_name(const std::type_info& type)
+{
+#ifdef __GNUG__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+  std::string out = status == 0 ? demangled : type.name();
+  std::free(demangled);
+  return out;
+#else
+  return type.name();
+#endif
+}
+
+/**
+ * @brief Get the process CPU time, in milliseconds.
+ */
+inline double process_cpu_ms()
+{
+  return 1000. * std::clock() / CLOCKS_PER_SEC;
+}
+
+/**
+ * @brief Get the peak resident set size of the process, in bytes, or 0 if unavailable.
+ */
+inline long long peak_rss()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss; // Bytes
+#else
+  return usage.ru_maxrss * 1024LL; // Kilobytes
+#endif
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Write a string as a JSON string literal.
+ */
+inline void write_json_string(std::ostream& out, const std::string& value)
+{
+  out << '"';
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso StepRecord
+ * @brief Write step records as CSV, with a header line.
+ */
+inline void write_csv(std::ostream& out, const std::vector<StepRecord>& records)
+{
+  out << "step,thread,start_us,wall_ms,cpu_ms,utilization,peak_rss_delta,allocations,allocated_bytes,peak_bytes,"
+      << "cycles,instructions,ipc,cache_misses,branch_misses\n";
+  for (const auto& r : records) {
+    out << '"' << r.name << "\"," << r.thread << ',' << r.start_us << ',' << r.wall_ms << ',' << r.cpu_ms << ','
+        << r.utilization() << ',' << r.peak_rss_delta << ',' << r.allocations.allocations << ','
+        << r.allocations.allocated_bytes << ',' << r.allocations.peak_bytes << ',' << r.counters[PerfSample::Cycles]
+        << ',' << r.counters[PerfSample::Instructions] << ',' << r.counters.ipc() << ','
+        << r.counters[PerfSample::CacheMisses] << ',' << r.counters[PerfSample::BranchMisses] << '\n';
+  }
+}
+
+/**
+ * @relatesalso StepRecord
+ * @brief Write step records as a JSON array of objects.
+ */
+inline void write_json(std::ostream& out, const std::vector<StepRecord>& records)
+{
+  out << '[';
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const auto& r = records[i];
+    out << (i ? ",\n " : "\n ") << "{\"step\": ";
+    Internal::write_json_string(out, r.name);
+    out << ", \"thread\": " << r.thread << ", \"start_us\": " << r.start_us << ", \"wall_ms\": " << r.wall_ms
+        << ", \"cpu_ms\": " << r.cpu_ms << ", \"utilization\": " << r.utilization()
+        << ", \"peak_rss_delta\": " << r.peak_rss_delta << ", \"allocations\": " << r.allocations.allocations
+        << ", \"allocated_bytes\": " << r.allocations.allocated_bytes
+        << ", \"peak_bytes\": " << r.allocations.peak_bytes << ", \"cycles\": " << r.counters[PerfSample::Cycles]
+        << ", \"instructions\": " << r.counters[PerfSample::Instructions] << ", \"ipc\": " << r.counters.ipc()
+        << ", \"cache_misses\": " << r.counters[PerfSample::CacheMisses]
+        << ", \"branch_misses\": " << r.counters[PerfSample::BranchMisses] << '}';
+  }
+  out << "\n]\n";
+}
+
+/**
+ * @relatesalso StepRecord
+ * @brief Write step records as Chrome trace events, e.g. to be loaded in `chrome://tracing` or Perfetto.
+ */
+inline void write_trace(std::ostream& out, const std::vector<StepRecord>& records)
+{
+  out << "{\"traceEvents\": [";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const auto& r = records[i];
+    out << (i ? ",\n " : "\n ") << "{\"name\": ";
+    Internal::write_json_string(out, r.name);
+    out << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << r.thread << ", \"ts\": " << r.start_us
+        << ", \"dur\": " << r.wall_ms * 1000 << ", \"args\": {\"cpu_ms\": " << r.cpu_ms
+        << ", \"allocated_bytes\": " << r.allocations.allocated_bytes << ", \"ipc\": " << r.counters.ipc() << "}}";
+  }
+  out << "\n]}\n";
+}
+
+} // namespace Linx
+
+#endif
@@ -5,22 +5,76 @@
 #ifndef _LINXRUN_STEPPERPIPELINE_H
 #define _LINXRUN_STEPPERPIPELINE_H
 
+#include "Linx/Base/Threads.h"
+#include "Linx/Run/StepCache.h"
+#include "Linx/Run/StepRecord.h"
 #include "PipelineStep.h"
 
 #include <chrono>
+#include <cstring> // strlen
+#include <exception> // exception_ptr
 #include <map>
+#include <mutex>
 #include <numeric> // accumulate
+#include <optional>
+#include <thread>
 #include <tuple>
+#include <type_traits> // false_type, void_t
 #include <typeindex>
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether a step defines a `Name`.
+ */
+template <typename S, typename = void>
+struct HasStepName : std::false_type {};
+
+/// @copydoc HasStepName
+template <typename S>
+struct HasStepName<S, std::void_t<decltype(S::Name)>> : std::true_type {};
+
+/**
+ * @brief The synchronization state of a pipeline, which is reset instead of copied.
+ * 
+ * This keeps pipelines copyable and movable, e.g. such that they can be returned by value.
+ * Resetting the once-only flags is consistent, because the evaluated steps are recorded separately.
+ */
+struct StepSync {
+  StepSync() = default;
+
+  StepSync(const StepSync&) : StepSync() {}
+
+  StepSync& operator=(const StepSync&)
+  {
+    flags.clear();
+    return *this;
+  }
+
+  /**
+   * @brief The mutex which guards the pipeline state.
+   */
+  std::mutex mutex;
+
+  /**
+   * @brief The once-only evaluation flags of the steps.
+   */
+  std::map<std::type_index, std::once_flag> flags;
+};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @brief A pipeline or directed acyclic graph (DAG) which can be run step-by-step using lazy evaluation.
  * 
  * The main method, `get<S>()`, returns the value of step `S`.
  * If not already done, the prerequisites of `S` are first triggered, recursively.
  * Run times of the steps are stored; They are accessed with `milliseconds()`.
+ * More detailed instrumentation records (CPU time, memory, allocations, threads) are accessed with `records()`.
  * 
  * This class relies on the CRTP, i.e. child classes should inherit this class with their name as template parameter, e.g.
  * \code
@@ -37,6 +91,20 @@ namespace Linx {
  * - `Value` is the return value type of `get<S>()`;
  * - `Prerequisite` is (are) the step(s) which must be run prior to `S`, or `void` if there is no prerequisite;
  *   Multiple prerequisites are describled with tuples.
+ * 
+ * By default, steps are evaluated sequentially.
+ * If the pipeline is given several threads with `threads()`, independent prerequisites are evaluated concurrently,
+ * as OpenMP tasks, e.g. the bias, dark and flat steps which are prerequisites of some calibration step.
+ * Each step is evaluated once, even if it is a prerequisite of several concurrent steps.
+ * In this case, `evaluate_impl<S>()` specializations of independent steps must be thread-safe,
+ * e.g. write to separate members.
+ * Exceptions thrown by prerequisites are rethrown by `get()`.
+ * 
+ * Steps which inherit `CachedStep` can be skipped if their value is found in a `StepCache`, see `cache()`.
+ * Such steps must define a unique name, as `static constexpr const char* Name`.
+ * For each such step `S`, child classes must additionally provide:
+ * - `std::uint64_t hash_impl<S>()`, which hashes the parameters of `S`, e.g. with `hash_value()`;
+ * - `void restore_impl<S>(V value)`, where `V` is the decayed `S::Value`, which restores the state of `S`.
  */
 template <typename TDerived>
 class StepperPipeline {
@@ -48,12 +116,89 @@ public:
   template <typename S>
   typename S::Value get()
   {
+    if (m_threads.count() > 1 && not evaluated<S>()) {
+      std::exception_ptr error;
+#pragma omp parallel num_threads(m_threads.count())
+#pragma omp single
+      {
+        try {
+          run<S>();
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    } else {
+      run<S>();
+    }
+    return Accessor<S>::get(derived());
+  }
+
+  /**
+   * @brief Set the threads used to evaluate independent prerequisites concurrently.
+   */
+  void threads(const Threads& threads)
+  {
+    m_threads = threads;
+  }
+
+  /**
+   * @brief Get the threads.
+   */
+  const Threads& threads() const
+  {
+    return m_threads;
+  }
+
+  /**
+   * @brief Enable or disable the reading of hardware performance counters around each step evaluation.
+   *
+   * Only the evaluating thread is monitored, e.g. not the threads of a parallel filter.
+   * @see `PerfCounters`, `StepRecord::counters`
+   */
+  void counters(bool enabled)
+  {
+    m_counters = enabled;
+  }
+
+  /**
+   * @brief Attach a cache of step values, or detach it with `nullptr`.
+   * 
+   * When a cached step is triggered, its key is computed from its name, its parameters (see `hash_impl<S>()`),
+   * and recursively the keys of its prerequisites.
+   * Keys do not depend on the compiler or platform, such that persistent caches can be shared across builds.
+   * If the key is found in the cache, the value is restored, and the prerequisites are not evaluated.
+   * Otherwise, the step is evaluated and its value is stored.
+   * Parameters of non-cached steps are not part of the keys: such steps should be cached too,
+   * or their parameters should be hashed by the downstream cached steps.
+   * 
+   * The cache must outlive the pipeline or be detached.
+   */
+  void cache(StepCache* cache)
+  {
+    m_cache = cache;
+  }
+
+  /**
+   * @brief Compute the cache key of step `S`.
+   */
+  template <typename S>
+  std::uint64_t cache_key()
+  {
+    auto out = fnv1a(nullptr, 0);
+    if constexpr (is_cached_step<S>()) {
+      static_assert(Internal::HasStepName<S>::value, "Cached steps must define: static constexpr const char* Name");
+      out = fnv1a(S::Name, std::strlen(S::Name), out);
+      out = hash_value(Accessor<S>::hash(derived()), out);
+    }
     if constexpr (S::Cardinality == 1) {
-      get<typename S::Prerequisite>();
+      out = hash_value(cache_key<typename S::Prerequisite>(), out);
     } else if constexpr (S::Cardinality > 1) {
-      get_multiple<typename S::Prerequisite>(std::make_index_sequence<S::Cardinality> {});
+      out = cache_key_multiple<typename S::Prerequisite>(out, std::make_index_sequence<S::Cardinality> {});
     }
-    return evaluate_get<S>();
+    return out;
   }
 
   /**
@@ -62,6 +207,7 @@ public:
   template <typename S>
   bool evaluated() const
   {
+    std::lock_guard<std::mutex> lock(m_sync.mutex);
     return m_milliseconds.find(key<S>()) != m_milliseconds.end();
   }
 
@@ -72,6 +218,7 @@ public:
   template <typename S>
   double milliseconds() const
   {
+    std::lock_guard<std::mutex> lock(m_sync.mutex);
     const auto it = m_milliseconds.find(key<S>());
     if (it != m_milliseconds.end()) {
       return it->second;
@@ -79,11 +226,24 @@ public:
     return -1;
   }
 
+  /**
+   * @brief Get the instrumentation records of the evaluated steps, in order of completion.
+   * 
+   * The records can be exported with `write_csv()`, `write_json()` or `write_trace()`.
+   * Restored cached steps are recorded, too.
+   */
+  std::vector<StepRecord> records() const
+  {
+    std::lock_guard<std::mutex> lock(m_sync.mutex);
+    return m_records;
+  }
+
   /**
    * @brief Get the total elapsed time.
    */
   double milliseconds() const
   {
+    std::lock_guard<std::mutex> lock(m_sync.mutex);
     return std::accumulate(m_milliseconds.begin(), m_milliseconds.end(), 0., [](const auto sum, const auto& e) {
       return sum + e.second;
     });
@@ -96,20 +256,102 @@ protected:
    */
   void reset()
   {
+    std::lock_guard<std::mutex> lock(m_sync.mutex);
     m_milliseconds.clear();
+    m_sync.flags.clear();
+    m_records.clear();
   }
 
 private:
 
   /**
-   * @brief Call `get()` on each element of a tuple.
+   * @brief Evaluate the prerequisites of step `S` if needed, and then `S` itself.
+   */
+  template <typename S>
+  void run()
+  {
+    if (evaluated<S>()) {
+      return;
+    }
+    if constexpr (is_cached_step<S>()) {
+      if (m_cache) {
+        const auto k = cache_key<S>();
+        if (auto value = m_cache->template load<std::decay_t<typename S::Value>>(k)) {
+          once<S>([&]() {
+            Accessor<S>::restore(derived(), std::move(*value));
+          });
+          return;
+        }
+        run_prerequisites<S>();
+        once<S>([&]() {
+          Accessor<S>::evaluate(derived());
+          m_cache->store(k, std::decay_t<typename S::Value>(Accessor<S>::get(derived())));
+        });
+        return;
+      }
+    }
+    run_prerequisites<S>();
+    once<S>([&]() {
+      Accessor<S>::evaluate(derived());
+    });
+  }
+
+  /**
+   * @brief Evaluate the prerequisites of step `S` if needed.
+   */
+  template <typename S>
+  void run_prerequisites()
+  {
+    if constexpr (S::Cardinality == 1) {
+      run<typename S::Prerequisite>();
+    } else if constexpr (S::Cardinality > 1) {
+      run_multiple<typename S::Prerequisite>(std::make_index_sequence<S::Cardinality> {});
+    }
+  }
+
+  /**
+   * @brief Combine the cache keys of the elements of a tuple.
+   */
+  template <typename STuple, std::size_t... Is>
+  std::uint64_t cache_key_multiple(std::uint64_t seed, std::index_sequence<Is...>)
+  {
+    ((seed = hash_value(cache_key<std::tuple_element_t<Is, STuple>>(), seed)), ...);
+    return seed;
+  }
+
+  /**
+   * @brief Call `run()` on each element of a tuple, in concurrent tasks.
+   * 
+   * Outside of a parallel region, i.e. if the pipeline has a single thread, the tasks are run immediately.
    */
   template <typename STuple, std::size_t... Is>
-  void get_multiple(std::index_sequence<Is...>)
+  void run_multiple(std::index_sequence<Is...>)
   {
+    std::exception_ptr errors[sizeof...(Is)];
     using mock_unpack = int[];
-    (void)mock_unpack {0, (get<std::tuple_element_t<Is, STuple>>(), void(), 0)...};
-    // TODO could be done in threads!
+    (void)mock_unpack {0, (spawn<std::tuple_element_t<Is, STuple>>(errors[Is]), 0)...};
+#pragma omp taskwait
+    for (const auto& e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+  }
+
+  /**
+   * @brief Call `run()` in a task, and catch exceptions, which cannot escape tasks.
+   */
+  template <typename S>
+  void spawn(std::exception_ptr& error)
+  {
+#pragma omp task shared(error)
+    {
+      try {
+        run<S>();
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
   }
 
   /**
@@ -134,21 +376,76 @@ private:
       auto f = &Accessor::template get_impl<S>;
       return (algo.*f)();
     }
+
+    /**
+     * @brief Call `algo.hash_impl<S>()`.
+     */
+    static std::uint64_t hash(TDerived& algo)
+    {
+      auto f = &Accessor::template hash_impl<S>;
+      return (algo.*f)();
+    }
+
+    /**
+     * @brief Call `algo.restore_impl<S>(value)`.
+     */
+    static void restore(TDerived& algo, std::decay_t<typename S::Value> value)
+    {
+      auto f = &Accessor::template restore_impl<S>;
+      (algo.*f)(std::move(value));
+    }
   };
 
   /**
-   * @brief Run step `S` if not done and return its output.
+   * @brief Evaluate or restore step `S` once, assuming its prerequisites were evaluated if needed.
+   * 
+   * Concurrent callers wait until the first one is done.
    */
-  template <typename S>
-  typename S::Value evaluate_get()
+  template <typename S, typename TFunc>
+  void once(TFunc&& func)
   {
-    if (not evaluated<S>()) { // FIXME not thread-safe
+    std::once_flag* flag;
+    {
+      std::lock_guard<std::mutex> lock(m_sync.mutex);
+      flag = &m_sync.flags[key<S>()];
+    }
+    std::call_once(*flag, [&]() {
+      StepRecord record;
+      record.name = Internal::type_name(typeid(S));
+      const auto allocations = AllocationScope::stats(record.name);
+      const auto rss = Internal::peak_rss();
+      const auto cpu = Internal::process_cpu_ms();
+      std::optional<PerfCounters> counters;
+      if (m_counters) {
+        counters.emplace();
+        counters->start();
+      }
       const auto start = std::chrono::high_resolution_clock::now();
-      Accessor<S>::evaluate(derived());
+      {
+        AllocationScope scope(record.name);
+        func();
+      }
       const auto stop = std::chrono::high_resolution_clock::now();
-      m_milliseconds[key<S>()] = std::chrono::duration<double, std::milli>(stop - start).count();
-    }
-    return Accessor<S>::get(derived());
+      if (counters) {
+        record.counters = counters->stop();
+      }
+      record.cpu_ms = Internal::process_cpu_ms() - cpu;
+      record.peak_rss_delta = Internal::peak_rss() - rss;
+      record.wall_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+      record.start_us = std::chrono::duration<double, std::micro>(start - m_epoch).count();
+      record.allocations = AllocationScope::stats(record.name);
+      record.allocations.allocations -= allocations.allocations;
+      record.allocations.deallocations -= allocations.deallocations;
+      record.allocations.allocated_bytes -= allocations.allocated_bytes;
+      record.allocations.freed_bytes -= allocations.freed_bytes;
+      record.allocations.copies -= allocations.copies;
+      record.allocations.copied_bytes -= allocations.copied_bytes;
+      std::lock_guard<std::mutex> lock(m_sync.mutex);
+      const auto thread = m_thread_indices.emplace(std::this_thread::get_id(), m_thread_indices.size()).first;
+      record.thread = thread->second;
+      m_milliseconds[key<S>()] = record.wall_ms;
+      m_records.push_back(std::move(record));
+    });
   }
 
   /**
@@ -174,6 +471,41 @@ private:
    * @brief The set of performed steps and durations.
    */
   std::map<std::type_index, double> m_milliseconds;
+
+  /**
+   * @brief The mutex and once-only evaluation flags.
+   */
+  mutable Internal::StepSync m_sync;
+
+  /**
+   * @brief The threads.
+   */
+  Threads m_threads = Threads(1);
+
+  /**
+   * @brief The cache, if any.
+   */
+  StepCache* m_cache = nullptr;
+
+  /**
+   * @brief Whether to read the performance counters.
+   */
+  bool m_counters = false;
+
+  /**
+   * @brief The instrumentation records.
+   */
+  std::vector<StepRecord> m_records;
+
+  /**
+   * @brief The indices of the threads which evaluated steps.
+   */
+  std::map<std::thread::id, Index> m_thread_indices;
+
+  /**
+   * @brief The origin of the record times.
+   */
+  std::chrono::high_resolution_clock::time_point m_epoch = std::chrono::high_resolution_clock::now();
 };
 
 } // namespace Linx
@@ -0,0 +1,355 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_STREAMINGPIPELINE_H
+#define _LINXRUN_STREAMINGPIPELINE_H
+
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception> // exception_ptr
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits> // decay_t, invoke_result_t
+#include <utility> // declval, index_sequence, move
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A blocking FIFO queue with bounded capacity.
+ *
+ * Producers wait while the queue is full, which propagates backpressure upstream.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  explicit BoundedQueue(Index capacity) : m_capacity(capacity), m_values(), m_closed(false), m_canceled(false) {}
+
+  /**
+   * @brief Push a value, waiting while the queue is full.
+   * @return False if the queue was closed or canceled, in which case the value is dropped
+   */
+  bool push(T value)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [&]() {
+      return static_cast<Index>(m_values.size()) < m_capacity || m_closed || m_canceled;
+    });
+    if (m_closed || m_canceled) {
+      return false;
+    }
+    m_values.push_back(std::move(value));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Pop a value, waiting while the queue is empty.
+   * @return The value, or nothing if the queue was closed and is empty, or if it was canceled
+   */
+  std::optional<T> pop()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [&]() {
+      return not m_values.empty() || m_closed || m_canceled;
+    });
+    if (m_canceled || m_values.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> out(std::move(m_values.front()));
+    m_values.pop_front();
+    m_not_full.notify_one();
+    return out;
+  }
+
+  /**
+   * @brief Declare that no more values will be pushed, such that consumers stop once the queue is drained.
+   */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+  /**
+   * @brief Stop producers and consumers immediately, dropping the pending values.
+   */
+  void cancel()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_canceled = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+private:
+
+  /**
+   * @brief The capacity.
+   */
+  Index m_capacity;
+
+  /**
+   * @brief The pending values.
+   */
+  std::deque<T> m_values;
+
+  /**
+   * @brief Whether the queue was closed.
+   */
+  bool m_closed;
+
+  /**
+   * @brief Whether the queue was canceled.
+   */
+  bool m_canceled;
+
+  /**
+   * @brief The mutex which guards the values and flags.
+   */
+  std::mutex m_mutex;
+
+  /**
+   * @brief The condition which wakes consumers up.
+   */
+  std::condition_variable m_not_empty;
+
+  /**
+   * @brief The condition which wakes producers up.
+   */
+  std::condition_variable m_not_full;
+};
+
+/**
+ * @brief The tuple of the input types of a chain of stages.
+ */
+template <typename TIn, typename... TStages>
+struct StageInputs {
+  using Type = std::tuple<>;
+};
+
+/// @copydoc StageInputs
+template <typename TIn, typename TStage, typename... TStages>
+struct StageInputs<TIn, TStage, TStages...> {
+  using Next = std::decay_t<std::invoke_result_t<TStage&, TIn>>;
+  using Type = decltype(std::tuple_cat(
+      std::declval<std::tuple<TIn>>(),
+      std::declval<typename StageInputs<Next, TStages...>::Type>()));
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief A pipeline which streams many inputs through a chain of stages, e.g. to reduce a sequence of frames.
+ * @tparam TStages The stage functions
+ *
+ * As opposed to `StepperPipeline`, which evaluates each step once, this pipeline processes a stream:
+ * each stage runs in its own thread, and consumes the outputs of the previous stage from a bounded queue,
+ * such that input `k + 1` can be processed by some stage while input `k` is processed by the next one,
+ * e.g. to overlap I/O with computation.
+ * When a queue is full, the upstream stage waits, such that the memory footprint is bounded.
+ * The order of the inputs is preserved.
+ *
+ * Stages are callables which take the output of the previous stage (or an input for the first stage) by value.
+ * The last stage may return `void`, e.g. to write the results.
+ * If a stage throws, the pipeline is canceled and the exception is rethrown by `run()`.
+ *
+ * \code
+ * auto pipeline = streaming_pipeline(2)
+ *                     .then([](const std::string& name) { return read_frame(name); })
+ *                     .then([&](Raster<float> frame) { return calibrate(frame, master); })
+ *                     .then([](Raster<float> frame) { write_frame(frame); });
+ * pipeline.run(filenames);
+ * \endcode
+ *
+ * @see `streaming_pipeline()`
+ */
+template <typename... TStages>
+class StreamingPipeline {
+public:
+
+  /**
+   * @brief The number of stages.
+   */
+  static constexpr std::size_t Size = sizeof...(TStages);
+
+  /**
+   * @brief Constructor.
+   * @param capacity The capacity of the queues between the stages
+   * @param stages The stages
+   */
+  explicit StreamingPipeline(Index capacity, TStages... stages) :
+      m_capacity(capacity), m_stages(std::move(stages)...), m_milliseconds(Size, 0.), m_counts(Size, 0)
+  {}
+
+  /**
+   * @brief Append a stage.
+   */
+  template <typename TStage>
+  StreamingPipeline<TStages..., std::decay_t<TStage>> then(TStage&& stage) &&
+  {
+    return std::apply(
+        [&](auto&... stages) {
+          return StreamingPipeline<TStages..., std::decay_t<TStage>>(
+              m_capacity,
+              std::move(stages)...,
+              std::forward<TStage>(stage));
+        },
+        m_stages);
+  }
+
+  /**
+   * @brief Stream a range of inputs through the stages.
+   *
+   * Inputs are fed by the calling thread, which waits until all the stages are done.
+   */
+  template <typename TRange>
+  void run(const TRange& inputs)
+  {
+    static_assert(Size > 0, "Cannot run an empty pipeline.");
+    using Inputs = typename Internal::StageInputs<std::decay_t<decltype(*inputs.begin())>, TStages...>::Type;
+    run_impl<Inputs>(inputs, std::make_index_sequence<Size> {});
+  }
+
+  /**
+   * @brief Get the cumulated processing time of a stage, in milliseconds.
+   */
+  double milliseconds(std::size_t stage) const
+  {
+    return m_milliseconds[stage];
+  }
+
+  /**
+   * @brief Get the number of inputs processed by a stage.
+   */
+  Index count(std::size_t stage) const
+  {
+    return m_counts[stage];
+  }
+
+private:
+
+  /**
+   * @brief Create the queues and threads, feed the inputs and wait.
+   */
+  template <typename TInputs, typename TRange, std::size_t... Is>
+  void run_impl(const TRange& inputs, std::index_sequence<Is...>)
+  {
+    std::tuple<Internal::BoundedQueue<std::tuple_element_t<Is, TInputs>>...> queues(((void)Is, m_capacity)...);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto fail = [&](std::exception_ptr e) {
+      {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (not error) {
+          error = e;
+        }
+      }
+      (std::get<Is>(queues).cancel(), ...);
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(Size);
+    (workers.emplace_back([&]() {
+      work<Is>(queues, fail);
+    }),
+     ...);
+    auto& front = std::get<0>(queues);
+    for (const auto& e : inputs) {
+      if (not front.push(e)) {
+        break;
+      }
+    }
+    front.close();
+    for (auto& w : workers) {
+      w.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   * @brief Run stage `I` until its input queue is drained.
+   */
+  template <std::size_t I, typename TQueues, typename TFail>
+  void work(TQueues& queues, const TFail& fail)
+  {
+    auto& in = std::get<I>(queues);
+    auto& stage = std::get<I>(m_stages);
+    try {
+      while (auto value = in.pop()) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        const auto stop = [&]() {
+          const auto elapsed = std::chrono::high_resolution_clock::now() - start;
+          m_milliseconds[I] += std::chrono::duration<double, std::milli>(elapsed).count();
+          ++m_counts[I];
+        };
+        if constexpr (I + 1 < Size) {
+          auto out = stage(std::move(*value));
+          stop();
+          if (not std::get<I + 1>(queues).push(std::move(out))) {
+            break;
+          }
+        } else {
+          stage(std::move(*value));
+          stop();
+        }
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+    if constexpr (I + 1 < Size) {
+      std::get<I + 1>(queues).close();
+    }
+  }
+
+  /**
+   * @brief The capacity of the queues.
+   */
+  Index m_capacity;
+
+  /**
+   * @brief The stages.
+   */
+  std::tuple<TStages...> m_stages;
+
+  /**
+   * @brief The cumulated processing times of the stages, each written by a single thread.
+   */
+  std::vector<double> m_milliseconds;
+
+  /**
+   * @brief The numbers of processed inputs, each written by a single thread.
+   */
+  std::vector<Index> m_counts;
+};
+
+/**
+ * @relatesalso StreamingPipeline
+ * @brief Create an empty streaming pipeline, to which stages are appended with `then()`.
+ * @param capacity The capacity of the queues between the stages
+ */
+inline StreamingPipeline<> streaming_pipeline(Index capacity = 2)
+{
+  return StreamingPipeline<>(capacity);
+}
+
+} // namespace Linx
+
+#endif
@@ -5,12 +5,20 @@
 #ifndef _LINXTRANSFORMS_AFFINITY_H
 #define _LINXTRANSFORMS_AFFINITY_H
 
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Matrix.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Data/Vector.h"
+#include "Linx/Transforms/Extrapolation.h"
 #include "Linx/Transforms/Interpolation.h"
 
-#include <eigen3/Eigen/Core>
-#include <eigen3/Eigen/LU> // inverse
+#include <algorithm> // fill, minmax_element
+#include <array>
+#include <cmath> // abs, ceil, remainder, sin, tan
+#include <cstddef> // nullptr_t
+#include <iterator> // advance
+#include <type_traits> // decay_t, enable_if_t, is_same_v, remove_const_t
+#include <vector>
 
 namespace Linx {
 
@@ -24,6 +32,168 @@ class Affinity;
 template <Index N>
 Affinity<N> inverse(const Affinity<N>& in);
 
+namespace Internal {
+
+/**
+ * @brief Check whether the first type of a pack is `Threads`.
+ */
+template <typename... Ts>
+struct IsThreadsFirst : std::false_type {};
+
+template <typename T, typename... Ts>
+struct IsThreadsFirst<T, Ts...> : std::is_same<std::decay_t<T>, Threads> {};
+
+/**
+ * @brief Get a pointer to the output pixel at given position, contiguous along axis 0, or `nullptr` if unsupported.
+ */
+template <typename TOut, typename TPos>
+std::nullptr_t affinity_row(TOut&, const TPos&)
+{
+  return nullptr;
+}
+
+template <typename T, Index N, typename THolder>
+T* affinity_row(Raster<T, N, THolder>& out, const Position<N>& position)
+{
+  return &out[position];
+}
+
+template <typename T, typename U, Index N, typename THolder, bool IsContiguous>
+T* affinity_row(Patch<T, Raster<U, N, THolder>, Box<N>, IsContiguous>& out, const Position<N>& position)
+{
+  return &out.parent()[position];
+}
+
+/**
+ * @brief Check whether an interpolator relies on a separable method with 1D weight tables.
+ */
+template <typename T, typename = void>
+struct IsSeparableInterpolation : std::false_type {};
+
+template <typename TParent, typename TMethod>
+struct IsSeparableInterpolation<Interpolation<TParent, TMethod>, std::void_t<decltype(TMethod::Taps)>> :
+    std::true_type {};
+
+/**
+ * @brief Rotate each plane `(from, to)` of some input data by three successive 1D shears.
+ *
+ * The passes are: shear along `from`, shear along `to`, shear along `from`.
+ * Intermediate planes are enlarged along the sheared axes such that no content is lost,
+ * and are accumulated in the floating point type of the input.
+ * Angles larger than a quarter of a turn are reduced by an exact half-turn flip,
+ * such that the shear factors do not exceed 1.
+ */
+template <typename TMethod, typename TIn, typename TOut>
+void shear_rotate(const TIn& in, TOut& out, double angle, Index from, Index to, const Threads& threads)
+{
+  using Value = std::remove_const_t<typename TIn::Value>;
+  using Floating = std::remove_const_t<typename TypeTraits<Value>::Floating>;
+  constexpr Index taps = TMethod::Taps;
+
+  const auto half_turn = Linx::pi<double>();
+  angle = std::remainder(angle, 2 * half_turn);
+  const bool flip = std::abs(angle) > half_turn / 2;
+  if (flip) {
+    angle -= angle > 0 ? half_turn : -half_turn;
+  }
+  const auto alpha = -std::tan(angle / 2);
+  const auto beta = std::sin(angle);
+
+  const auto domain = box(in.domain());
+  const auto& front = domain.front();
+  const auto width = domain.length(from);
+  const auto height = domain.length(to);
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  const auto cx = (width - 1) / 2.;
+  const auto cy = (height - 1) / 2.;
+  const auto margin = static_cast<Index>(std::ceil(std::abs(alpha) * cy)) + taps + 1;
+  const auto padded_width = width + 2 * margin;
+  const auto padded_margin = static_cast<Index>(std::ceil(std::abs(beta) * (cx + margin))) + taps + 1;
+  const auto padded_height = height + 2 * padded_margin;
+
+  // Per-column weights of the second pass
+  std::vector<Index> column_fronts(padded_width);
+  std::vector<double> column_weights(padded_width * taps);
+  for (Index j = 0; j < padded_width; ++j) {
+    const auto shift = beta * (j - margin - cx);
+    column_fronts[j] = TMethod::weights(padded_margin - shift, &column_weights[j * taps]);
+  }
+
+  std::vector<Floating> first(padded_width * padded_height);
+  std::vector<Floating> second(padded_width * height);
+  std::vector<Floating> line;
+  auto back = domain.back();
+  back[from] = front[from];
+  back[to] = front[to];
+  for (const auto& p : Box<TIn::Dimension>(front, back)) {
+
+    // Shear the input along `from`
+#pragma omp parallel for num_threads(threads.count()) schedule(static) firstprivate(line)
+    for (Index i = 0; i < padded_height; ++i) {
+      const auto y = i - padded_margin;
+      std::array<double, taps> weights;
+      const auto f = TMethod::weights(-margin - alpha * (y - cy), weights.data());
+      line.resize(padded_width + taps - 1);
+      auto q = p;
+      q[to] = front[to] + y;
+      for (Index k = 0; k < static_cast<Index>(line.size()); ++k) {
+        const auto x = f + k;
+        q[from] = front[from] + x;
+        if constexpr (is_extrapolator<TIn>()) {
+          line[k] = in[q];
+        } else {
+          line[k] = (x >= 0 && x < width && y >= 0 && y < height) ? Floating(in[q]) : Floating();
+        }
+      }
+      auto* row = &first[i * padded_width];
+      for (Index j = 0; j < padded_width; ++j) {
+        Floating sum {};
+        for (Index t = 0; t < taps; ++t) {
+          sum += weights[t] * line[j + t];
+        }
+        row[j] = sum;
+      }
+    }
+
+    // Shear the result along `to`
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index y = 0; y < height; ++y) {
+      auto* row = &second[y * padded_width];
+      for (Index j = 0; j < padded_width; ++j) {
+        const auto* w = &column_weights[j * taps];
+        const auto* src = &first[(column_fronts[j] + y) * padded_width + j];
+        Floating sum {};
+        for (Index t = 0; t < taps; ++t) {
+          sum += w[t] * src[t * padded_width];
+        }
+        row[j] = sum;
+      }
+    }
+
+    // Shear the result along `from` again
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index y = 0; y < height; ++y) {
+      std::array<double, taps> weights;
+      const auto f = TMethod::weights(margin - alpha * (y - cy), weights.data());
+      const auto* row = &second[y * padded_width + f];
+      auto q = p - front;
+      q[to] = flip ? height - 1 - y : y;
+      for (Index x = 0; x < width; ++x) {
+        Floating sum {};
+        for (Index t = 0; t < taps; ++t) {
+          sum += weights[t] * row[x + t];
+        }
+        q[from] = flip ? width - 1 - x : x;
+        out[q] = static_cast<Value>(sum);
+      }
+    }
+  }
+}
+
+} // namespace Internal
+
 /// @endcond
 
 /**
@@ -33,7 +203,7 @@ Affinity<N> inverse(const Affinity<N>& in);
 template <typename TIn>
 Vector<double, TIn::Dimension> center(const TIn& in)
 {
-  const auto& domain = box(in.domain());
+  const auto domain = box(in.domain());
   Vector<double, TIn::Dimension> out(domain.front() + domain.back());
   out /= 2;
   return out;
@@ -100,25 +270,17 @@ Vector<double, TIn::Dimension> center(const TIn& in)
  * out = upsample<Cubic>(in, 3);
  * \endcode
  * 
- * \note
- * This class depends on Eigen.
+ * The linear map is a `Matrix`, such that applying the transform to a vector is an unrolled matrix-vector product.
  */
 template <Index N>
 class Affinity {
-private:
-
-  using EigenMatrix = Eigen::Matrix<double, N, N, Eigen::RowMajor>;
-  using EigenVector = Eigen::Matrix<double, N, 1>;
-  using EigenDiagonal = Eigen::DiagonalMatrix<double, N>;
-
 public:
 
   /**
    * @brief Create an affinity around given center.
    */
   explicit Affinity(const Vector<double, N>& center = Vector<double, N>::zero()) :
-      m_map(EigenMatrix::Identity(center.size(), center.size())), m_translation(EigenVector::Zero(center.size())),
-      m_center(to_eigen_vector(center))
+      m_map(Matrix<double, N>::identity()), m_translation(Vector<double, N>::zero()), m_center(center)
   {}
 
   /**
@@ -188,7 +350,7 @@ public:
   Affinity& operator+=(const Vector<double, N>& vector)
   {
     if (not vector.is_zero()) {
-      m_translation += to_eigen_vector(vector);
+      m_translation += vector;
     }
     return *this;
   }
@@ -208,7 +370,7 @@ public:
   Affinity& operator-=(const Vector<double, N>& vector)
   {
     if (not vector.is_zero()) {
-      m_translation -= to_eigen_vector(vector);
+      m_translation -= vector;
     }
     return *this;
   }
@@ -218,7 +380,7 @@ public:
    */
   Affinity& operator*=(double value)
   {
-    m_map *= EigenVector::Constant(m_translation.size(), value).asDiagonal();
+    m_map *= value;
     return *this;
   }
 
@@ -228,7 +390,7 @@ public:
   Affinity& operator*=(const Vector<double, N>& vector)
   {
     if (not vector.is_one()) {
-      m_map *= to_eigen_vector(vector).asDiagonal();
+      m_map = m_map * Matrix<double, N>::diagonal(vector);
     }
     return *this;
   }
@@ -247,7 +409,11 @@ public:
   Affinity& operator/=(const Vector<double, N>& vector)
   {
     if (not vector.is_one()) {
-      m_map *= to_eigen_vector(vector).cwiseInverse().asDiagonal();
+      auto inverse = vector;
+      for (auto& e : inverse) {
+        e = 1. / e;
+      }
+      m_map = m_map * Matrix<double, N>::diagonal(inverse);
     }
     return *this;
   }
@@ -258,14 +424,14 @@ public:
   Affinity& rotate_rad(double angle, Index from = 0, Index to = 1)
   {
     if (angle != 0) {
-      EigenMatrix rotation = EigenMatrix::Identity();
+      auto rotation = Matrix<double, N>::identity();
       const auto sin = std::sin(angle);
       const auto cos = std::cos(angle);
       rotation(from, from) = cos;
       rotation(from, to) = -sin;
       rotation(to, from) = sin;
       rotation(to, to) = cos;
-      m_map *= rotation;
+      m_map = m_map * rotation;
     }
     return *this;
   }
@@ -283,8 +449,8 @@ public:
    */
   Affinity& inverse()
   {
-    m_map = m_map.inverse().eval();
-    m_translation = -m_map * m_translation;
+    m_map.inverse();
+    m_translation = -(m_map * m_translation);
     return *this;
   }
 
@@ -294,18 +460,39 @@ public:
   template <typename T>
   Vector<double, N> operator()(const Vector<T, N>& in) const
   {
-    return Vector<double, N>(m_translation + m_center + m_map * (to_eigen_vector(in) - m_center));
-    // TODO faster without cast, i.e. without Eigen?
+    Vector<double, N> centered;
+    Internal::unroll(std::make_index_sequence<N>(), [&](std::size_t i) {
+      centered[i] = in[i] - m_center[i];
+    });
+    return m_translation + m_center + m_map * centered;
   }
 
   /**
    * @brief Apply the transform with a given interpolation method.
+   * 
+   * The output is a `SmallRaster` if the input is or decorates a `SmallRaster`, and a `Raster` otherwise.
+   */
+  template <
+      typename TInterpolation,
+      typename TIn,
+      typename... TArgs,
+      typename std::enable_if_t<not Internal::IsThreadsFirst<TArgs...>::value>* = nullptr>
+  Internal::SimilarRaster<TIn> warp(const TIn& in, TArgs&&... args) const
+  {
+    return warp<TInterpolation>(in, Threads(1), LINX_FORWARD(args)...);
+  }
+
+  /**
+   * @brief Apply the transform with a given interpolation method, using several threads.
+   * @param in The input data
+   * @param threads The threads
+   * @param args The interpolation arguments
    */
   template <typename TInterpolation, typename TIn, typename... TArgs>
-  Raster<typename TIn::Value, TIn::Dimension> warp(const TIn& in, TArgs&&... args) const
+  Internal::SimilarRaster<TIn> warp(const TIn& in, const Threads& threads, TArgs&&... args) const
   {
-    Raster<typename TIn::Value, TIn::Dimension> out(in.shape());
-    transform(interpolation<TInterpolation>(in, LINX_FORWARD(args)...), out);
+    Internal::SimilarRaster<TIn> out(in.shape());
+    transform(interpolation<TInterpolation>(in, LINX_FORWARD(args)...), out, threads);
     return out;
   }
 
@@ -315,15 +502,75 @@ public:
    * The domain of the output parameter (which can be a raster or a patch)
    * is used to decide which positions to take into account.
    * If positions outside the input domain are required, then `in` must be an extrapolator, too.
+   * 
+   * If the output domain is a box, the inverse transform is evaluated once per row only:
+   * since the transform is affine, the input position of the `x`-th pixel of a row
+   * is that of the row front plus `x` times a constant vector (the first column of the inverse linear map).
+   * Otherwise, the inverse transform is evaluated at each position.
+   * 
+   * If the output is a raster or a box-patch of a raster, rows are distributed among the threads.
+   * Otherwise, the transform is single-threaded.
+   * 
+   * Moreover, if the affinity is axis-aligned (i.e. the linear map is diagonal, as for translations and scalings),
+   * the output is a raster or a box-patch of a raster,
+   * and the interpolation method is `Nearest`, `Linear`, `Cubic` or a `WindowedSinc` like `Lanczos`,
+   * then the interpolation is separable:
+   * 1D weight tables are precomputed once per axis, and applied as successive 1D passes
+   * instead of evaluating the full N-D interpolation at each pixel.
    */
   template <typename TIn, typename TOut>
-  TOut& transform(const TIn& in, TOut& out) const
+  TOut& transform(const TIn& in, TOut& out, const Threads& threads = Threads(1)) const
   {
     const Affinity inv = Linx::inverse(*this);
-    auto it = out.begin();
-    for (const auto& p : out.domain()) {
-      *it = in(inv(p));
-      ++it;
+    const auto& domain = out.domain();
+    if constexpr (std::is_same_v<std::decay_t<decltype(domain)>, Box<N>>) {
+      if (domain.size() <= 0) {
+        return out;
+      }
+      if constexpr (
+          Internal::IsSeparableInterpolation<TIn>::value &&
+          not std::is_same_v<decltype(Internal::affinity_row(out, domain.front())), std::nullptr_t>) {
+        if (inv.is_diagonal() && inv.transform_separable(in, out, domain, threads)) {
+          return out;
+        }
+      }
+      const auto dimension = domain.dimension();
+      const auto width = domain.length(0);
+      Vector<double, N> step(dimension);
+      for (Index i = 0; i < dimension; ++i) {
+        step[i] = inv.m_map(i, 0);
+      }
+      const auto transform_row = [&](const Position<N>& front, auto row) {
+        const auto q0 = inv(front);
+        Vector<double, N> q(dimension);
+        for (Index x = 0; x < width; ++x, ++row) {
+          for (Index i = 0; i < dimension; ++i) {
+            q[i] = q0[i] + x * step[i];
+          }
+          *row = in(q);
+        }
+      };
+      const auto plane = project(domain);
+      if constexpr (std::is_same_v<decltype(Internal::affinity_row(out, domain.front())), std::nullptr_t>) {
+        auto it = out.begin();
+        for (const auto& front : plane) {
+          transform_row(front, it);
+          std::advance(it, width);
+        }
+      } else {
+        const std::vector<Position<N>> fronts(plane.begin(), plane.end());
+        const auto height = static_cast<Index>(fronts.size());
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+        for (Index r = 0; r < height; ++r) {
+          transform_row(fronts[r], Internal::affinity_row(out, fronts[r]));
+        }
+      }
+    } else {
+      auto it = out.begin();
+      for (const auto& p : domain) {
+        *it = in(inv(p));
+        ++it;
+      }
     }
     return out;
   }
@@ -331,30 +578,136 @@ public:
 private:
 
   /**
-   * @brief Copy a vector into an `EigenVector`.
+   * @brief Check whether the linear map is diagonal.
    */
-  template <typename T>
-  static EigenVector to_eigen_vector(const Vector<T, N>& in)
+  bool is_diagonal() const
   {
-    EigenVector out(in.size());
-    std::copy(in.begin(), in.end(), out.begin());
-    return out;
+    for (Index i = 0; i < N; ++i) {
+      for (Index j = 0; j < N; ++j) {
+        if (i != j && m_map(i, j) != 0) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Apply a diagonal inverse transform with a separable interpolation.
+   * 
+   * The input is first copied over the bounding box of the samples involved (with extrapolation if any),
+   * and then resampled along each axis successively, such that no extrapolation is needed by the passes.
+   * If the input is not extrapolated and some samples lie out of its domain, nothing is done and false is returned,
+   * such that the caller falls back to the per-pixel interpolation.
+   * Along axis `a`, the samples of consecutive axes are contiguous, such that the weighted sums are vectorizable.
+   */
+  template <typename TIn, typename TOut>
+  bool transform_separable(const TIn& in, TOut& out, const Box<N>& domain, const Threads& threads) const
+  {
+    using Method = std::decay_t<decltype(in.method())>;
+    using Floating = std::remove_const_t<typename TIn::Floating>;
+    constexpr Index taps = Method::Taps;
+    const auto dimension = domain.dimension();
+
+    // Precompute the 1D weight tables
+    const auto q0 = (*this)(domain.front());
+    std::vector<std::vector<Index>> origins(dimension);
+    std::vector<std::vector<double>> weights(dimension);
+    Position<N> lo(dimension);
+    Position<N> hi(dimension);
+    for (Index a = 0; a < dimension; ++a) {
+      const auto length = domain.length(a);
+      origins[a].resize(length);
+      weights[a].resize(length * taps);
+      for (Index x = 0; x < length; ++x) {
+        origins[a][x] = Method::weights(q0[a] + x * m_map(a, a), &weights[a][x * taps]);
+      }
+      const auto minmax = std::minmax_element(origins[a].begin(), origins[a].end());
+      lo[a] = *minmax.first;
+      hi[a] = *minmax.second + taps - 1;
+      for (auto& o : origins[a]) {
+        o -= lo[a];
+      }
+    }
+
+    // Copy the input samples
+    const Box<N> support(lo, hi);
+    const auto& parent = in.parent();
+    if constexpr (not is_extrapolator<decltype(parent)>()) {
+      if (not(support <= parent.domain())) {
+        return false;
+      }
+    }
+    Raster<Floating, N> current(support.shape());
+    auto it = current.begin();
+    for (const auto& p : support) {
+      *it = parent[p];
+      ++it;
+    }
+
+    // Resample along each axis
+    for (Index a = 0; a < dimension; ++a) {
+      auto shape = current.shape();
+      shape[a] = domain.length(a);
+      Raster<Floating, N> next(shape);
+      const auto inner = next.strides()[a];
+      const auto in_length = current.length(a);
+      const auto out_length = shape[a];
+      const Index outer = next.size() / (inner * out_length);
+      const auto* src = current.data();
+      auto* dst = next.data();
+      const auto* o = origins[a].data();
+      const auto* w = weights[a].data();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index k = 0; k < outer; ++k) {
+        const auto* s = src + k * inner * in_length;
+        auto* d = dst + k * inner * out_length;
+        for (Index x = 0; x < out_length; ++x) {
+          auto* dx = d + x * inner;
+          std::fill(dx, dx + inner, Floating());
+          for (Index t = 0; t < taps; ++t) {
+            const auto* st = s + (o[x] + t) * inner;
+            const auto wt = w[x * taps + t];
+            for (Index j = 0; j < inner; ++j) {
+              dx[j] += wt * st[j];
+            }
+          }
+        }
+      }
+      current = LINX_MOVE(next);
+    }
+
+    // Write the output rows
+    const auto plane = project(domain);
+    const std::vector<Position<N>> fronts(plane.begin(), plane.end());
+    const auto height = static_cast<Index>(fronts.size());
+    const auto width = domain.length(0);
+    const auto* data = current.data();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index r = 0; r < height; ++r) {
+      auto* row = Internal::affinity_row(out, fronts[r]);
+      const auto* values = data + r * width;
+      for (Index x = 0; x < width; ++x) {
+        row[x] = values[x];
+      }
+    }
+    return true;
   }
 
   /**
    * @brief The linear map.
    */
-  EigenMatrix m_map;
+  Matrix<double, N> m_map;
 
   /**
    * @brief The translation vector.
    */
-  EigenVector m_translation;
+  Vector<double, N> m_translation;
 
   /**
    * @brief The linear map center.
    */
-  EigenVector m_center;
+  Vector<double, N> m_center;
 };
 
 /**
@@ -374,9 +727,10 @@ Affinity<N> inverse(const Affinity<N>& in)
  * @brief Translate some input data using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> translate(const TIn& in, const Vector<double, TIn::Dimension>& vector)
+Internal::SimilarRaster<TIn>
+translate(const TIn& in, const Vector<double, TIn::Dimension>& vector, const Threads& threads = Threads(1))
 {
-  return Affinity<TIn::Dimension>::translate(vector).template warp<TInterpolation>(in); // FIXME optimize
+  return Affinity<TIn::Dimension>::translation(vector).template warp<TInterpolation>(in, threads);
 }
 
 /**
@@ -384,9 +738,10 @@ Raster<typename TIn::Value, TIn::Dimension> translate(const TIn& in, const Vecto
  * @brief Scale some input data from its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
+Internal::SimilarRaster<TIn> scale(const TIn& in, double factor, const Threads& threads = Threads(1))
 {
-  return Affinity<TIn::Dimension>::scaling(factor, center(in)).template warp<TInterpolation>(in); // FIXME optimize
+  return Affinity<TIn::Dimension>::scaling(factor, center(in))
+      .template warp<TInterpolation>(in, threads);
 }
 
 /**
@@ -396,20 +751,21 @@ Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
  * @tparam M The number of sampling dimensions
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double factor)
+Raster<std::remove_const_t<typename TIn::Value>, TIn::Dimension>
+upsample(const TIn& in, double factor, const Threads& threads = Threads(1))
 {
-  Vector<double, TIn::Dimension> factors(in.dimension());
+  Vector<double, TIn::Dimension> factors(in.shape().size());
   auto shape = in.shape();
   for (Index i = 0; i < M; ++i) {
     factors[i] = factor;
     shape[i] *= factor;
   }
-  for (Index i = M; i < in.dimension(); ++i) {
+  for (Index i = M; i < static_cast<Index>(shape.size()); ++i) {
     factors[i] = 1;
   }
-  Raster<typename TIn::Value, TIn::Dimension> out(std::move(shape));
+  Raster<std::remove_const_t<typename TIn::Value>, TIn::Dimension> out(std::move(shape));
   const auto scaling = Affinity<TIn::Dimension>::scaling(std::move(factors));
-  scaling.transform(interpolation<TInterpolation>(in), out);
+  scaling.transform(interpolation<TInterpolation>(in), out, threads);
   return out;
 }
 
@@ -420,9 +776,10 @@ Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double facto
  * @tparam M The number of sampling dimensions
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> downsample(const TIn& in, double factor)
+Raster<std::remove_const_t<typename TIn::Value>, TIn::Dimension>
+downsample(const TIn& in, double factor, const Threads& threads = Threads(1))
 {
-  return upsample<TInterpolation, M>(in, 1. / factor);
+  return upsample<TInterpolation, M>(in, 1. / factor, threads);
 }
 
 /**
@@ -430,9 +787,11 @@ Raster<typename TIn::Value, TIn::Dimension> downsample(const TIn& in, double fac
  * @brief Rotate some input data around its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1)
+Internal::SimilarRaster<TIn>
+rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1, const Threads& threads = Threads(1))
 {
-  return Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in)).template warp<TInterpolation>(in);
+  return Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in))
+      .template warp<TInterpolation>(in, threads);
 }
 
 /**
@@ -440,9 +799,51 @@ Raster<typename TIn::Value, TIn::Dimension> rotate_rad(const TIn& in, double ang
  * @brief Rotate some input data around its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1)
+Internal::SimilarRaster<TIn>
+rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1, const Threads& threads = Threads(1))
+{
+  return Affinity<TIn::Dimension>::rotation_deg(angle, from, to, center(in))
+      .template warp<TInterpolation>(in, threads);
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive 1D shears.
+ * @tparam TMethod The 1D interpolation method, e.g. `Linear`, `Cubic` or `Lanczos<3>`
+ * @param in The input raster or extrapolator
+ * @param angle The angle in radians
+ * @param from The axis to rotate from
+ * @param to The axis to rotate to
+ * @param threads The threads
+ *
+ * The rotation is decomposed as a shear along `from`, a shear along `to`, and a shear along `from` again (Paeth),
+ * each of which shifts whole rows or columns by a constant offset, with a single set of 1D weights.
+ * This is much cheaper than `rotate_rad()` for large images, especially with long kernels,
+ * accesses memory row by row, and preserves flux as well as the underlying 1D interpolation.
+ * The result is the same as that of `rotate_rad()`, up to interpolation errors.
+ *
+ * Values outside the input domain are extrapolated if the input is an extrapolator, and are zero otherwise.
+ * Higher-dimensional data is rotated plane by plane.
+ */
+template <typename TMethod, typename TIn>
+Internal::SimilarRaster<TIn, std::remove_const_t<typename TIn::Value>>
+shear_rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1, const Threads& threads = Threads(1))
+{
+  Internal::SimilarRaster<TIn, std::remove_const_t<typename TIn::Value>> out(in.shape());
+  Internal::shear_rotate<TMethod>(in, out, angle, from, to, threads);
+  return out;
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive 1D shears.
+ * @see `shear_rotate_rad()`
+ */
+template <typename TMethod, typename TIn>
+Internal::SimilarRaster<TIn, std::remove_const_t<typename TIn::Value>>
+shear_rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1, const Threads& threads = Threads(1))
 {
-  return Affinity<TIn::Dimension>::rotation_deg(angle, from, to, center(in)).template warp<TInterpolation>(in);
+  return shear_rotate_rad<TMethod>(in, Linx::pi<double>() / 180. * angle, from, to, threads);
 }
 
 } // namespace Linx
@@ -0,0 +1,453 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BACKGROUND_H
+#define _LINXTRANSFORMS_BACKGROUND_H
+
+#include "Linx/Base/SigmaClipping.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/ResamplingMethods.h" // Cubic, Nearest
+
+#include <algorithm> // copy, min_element, nth_element
+#include <array>
+#include <cmath> // abs
+#include <limits>
+#include <type_traits> // remove_const_t
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief A smooth background and noise map, estimated on a mesh of tiles, as in SExtractor.
+ * @tparam T The value type
+ * @tparam N The dimension
+ *
+ * The input raster is partitioned into tiles (clamped at the upper domain limits, as with `tiles()`),
+ * on which robust statistics are estimated in parallel:
+ * the values are sigma-clipped with `SigmaClipping`, and the background is estimated as the mode,
+ * approximated by `2.5 * median - 1.5 * mean`, unless the tile is crowded
+ * (i.e. the mean and median differ by more than 30% of the standard deviation),
+ * in which case the median is used.
+ * The noise is estimated as the clipped standard deviation.
+ * NaNs are ignored, and tiles without valid values are filled by the median filter.
+ *
+ * The resulting mesh is median-filtered with a box window of given radius, clamped to the mesh domain,
+ * to remove the residuals of bright sources.
+ * The background is then the bicubic (Catmull-Rom) interpolation of the mesh, whose nodes are the tile centers,
+ * extrapolated with `Nearest` outside the node range.
+ *
+ * The full-resolution maps are never materialized unless requested:
+ * `at()` evaluates a single pixel, and `subtract()` removes the background from a raster in place.
+ * Full-resolution evaluation is row by row: the mesh is first interpolated along all axes but the first one,
+ * which only involves mesh-sized buffers, such that each pixel then costs four multiply-adds.
+ *
+ * \code
+ * const auto bkg = background(image, {64, 64}, 1, Threads(8));
+ * bkg.subtract(image, Threads(8));
+ * const auto noise = bkg.rms_mesh();
+ * \endcode
+ *
+ * @see `background()`
+ */
+template <typename T, Index N = 2>
+class Background {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param in The input raster
+   * @param tile The tile shape
+   * @param radius The radius of the median filter of the mesh, or 0 to disable it
+   * @param threads The threads
+   * @param k The sigma-clipping threshold
+   * @param iterations The maximum number of sigma-clipping iterations
+   */
+  template <typename U, typename THolder>
+  Background(
+      const Raster<U, N, THolder>& in,
+      Position<N> tile,
+      Index radius = 1,
+      const Threads& threads = Threads(1),
+      double k = 3,
+      Index iterations = 5) :
+      m_shape(in.shape()),
+      m_tile(LINX_MOVE(tile)), m_mesh(), m_rms()
+  {
+    auto mesh_shape = m_shape;
+    for (Index i = 0; i < N; ++i) {
+      mesh_shape[i] = (m_shape[i] + m_tile[i] - 1) / m_tile[i];
+    }
+    m_mesh = Raster<T, N>(mesh_shape);
+    m_rms = Raster<T, N>(mesh_shape);
+    estimate(in, threads, k, iterations);
+    m_mesh = median_filter(m_mesh, radius);
+    m_rms = median_filter(m_rms, radius);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the shape of the full-resolution maps.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the tile shape.
+   */
+  const Position<N>& tile() const
+  {
+    return m_tile;
+  }
+
+  /**
+   * @brief Get the filtered background mesh, i.e. one value per tile.
+   */
+  const Raster<T, N>& mesh() const
+  {
+    return m_mesh;
+  }
+
+  /**
+   * @brief Get the filtered noise mesh, i.e. one value per tile.
+   */
+  const Raster<T, N>& rms_mesh() const
+  {
+    return m_rms;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Evaluate the background at given pixel.
+   */
+  T at(const Position<N>& position) const
+  {
+    return evaluate(m_mesh, position);
+  }
+
+  /**
+   * @brief Evaluate the noise at given pixel.
+   */
+  T rms_at(const Position<N>& position) const
+  {
+    return evaluate(m_rms, position);
+  }
+
+  /**
+   * @brief Materialize the full-resolution background map.
+   */
+  Raster<T, N> background(const Threads& threads = Threads(1)) const
+  {
+    Raster<T, N> out(m_shape);
+    for_each_row(m_mesh, threads, [&](Index offset, const T* row) {
+      std::copy(row, row + m_shape[0], out.data() + offset);
+    });
+    return out;
+  }
+
+  /**
+   * @brief Materialize the full-resolution noise map.
+   */
+  Raster<T, N> rms(const Threads& threads = Threads(1)) const
+  {
+    Raster<T, N> out(m_shape);
+    for_each_row(m_rms, threads, [&](Index offset, const T* row) {
+      std::copy(row, row + m_shape[0], out.data() + offset);
+    });
+    return out;
+  }
+
+  /**
+   * @brief Subtract the background from a raster of the same shape, in place.
+   */
+  template <typename U, typename THolder>
+  Raster<U, N, THolder>& subtract(Raster<U, N, THolder>& raster, const Threads& threads = Threads(1)) const
+  {
+    for_each_row(m_mesh, threads, [&](Index offset, const T* row) {
+      auto* it = raster.data() + offset;
+      for (Index x = 0; x < m_shape[0]; ++x, ++it) {
+        *it -= row[x];
+      }
+    });
+    return raster;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Estimate the raw mesh values, tile by tile.
+   */
+  template <typename U, typename THolder>
+  void estimate(const Raster<U, N, THolder>& in, const Threads& threads, double k, Index iterations)
+  {
+    const Index count = m_mesh.size();
+    const auto mesh_shape = m_mesh.shape();
+    std::vector<double> buffer;
+    SigmaClipping<double> clipping(k, iterations);
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic) firstprivate(buffer, clipping)
+    for (Index t = 0; t < count; ++t) {
+      auto front = mesh_shape;
+      auto index = t;
+      for (Index i = 0; i < N; ++i) {
+        front[i] = (index % mesh_shape[i]) * m_tile[i];
+        index /= mesh_shape[i];
+      }
+      const auto box = Box<N>::from_shape(front, m_tile) & in.domain();
+      buffer.clear();
+      for (const auto& p : box) {
+        const double v = in[p];
+        if (v == v) {
+          buffer.push_back(v);
+        }
+      }
+      if (buffer.empty()) {
+        m_mesh.data()[t] = m_rms.data()[t] = std::numeric_limits<T>::quiet_NaN();
+        continue;
+      }
+      clipping.clip_inplace(buffer.data(), buffer.data() + buffer.size());
+      const auto mean = clipping.mean();
+      const auto median = clipping.median();
+      const auto stdev = clipping.stdev();
+      const bool crowded = std::abs(mean - median) > .3 * stdev;
+      m_mesh.data()[t] = crowded ? median : 2.5 * median - 1.5 * mean;
+      m_rms.data()[t] = stdev;
+    }
+  }
+
+  /**
+   * @brief Median-filter a mesh with a box window clamped to the mesh domain, ignoring NaNs.
+   *
+   * Remaining NaNs, i.e. nodes whose window only contains NaNs, are replaced with the median of the mesh.
+   */
+  static Raster<T, N> median_filter(const Raster<T, N>& mesh, Index radius)
+  {
+    Raster<T, N> out(mesh.shape());
+    std::vector<T> values;
+    const auto domain = mesh.domain();
+    auto it = out.begin();
+    for (const auto& p : domain) {
+      values.clear();
+      for (const auto& q : Box<N>::from_center(radius, p) & domain) {
+        const auto v = mesh[q];
+        if (v == v) {
+          values.push_back(v);
+        }
+      }
+      *it = median(values);
+      ++it;
+    }
+    values.clear();
+    for (const auto& v : out) {
+      if (v == v) {
+        values.push_back(v);
+      }
+    }
+    const auto fill = median(values);
+    for (auto& v : out) {
+      if (not(v == v)) {
+        v = fill;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the median of some values in place, or NaN if there is none.
+   */
+  static T median(std::vector<T>& values)
+  {
+    if (values.empty()) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    const auto middle = values.begin() + (values.size() - 1) / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    if (values.size() % 2) {
+      return *middle;
+    }
+    return (*middle + *std::min_element(middle + 1, values.end())) / 2;
+  }
+
+  /**
+   * @brief Compute the first mesh node and the Catmull-Rom weights of a pixel coordinate along some axis.
+   */
+  Index weights(Index axis, Index coordinate, double* out) const
+  {
+    const auto u = (coordinate + .5) / m_tile[axis] - .5;
+    return Cubic::weights(u, out);
+  }
+
+  /**
+   * @brief Evaluate a mesh at given pixel.
+   */
+  T evaluate(const Raster<T, N>& mesh, const Position<N>& position) const
+  {
+    std::array<double, N * Cubic::Taps> w;
+    std::array<Index, N * Cubic::Taps> offsets;
+    Index stride = 1;
+    for (Index i = 0; i < N; ++i) {
+      const auto front = weights(i, position[i], &w[i * Cubic::Taps]);
+      for (Index k = 0; k < Cubic::Taps; ++k) {
+        offsets[i * Cubic::Taps + k] = Nearest::index(front + k, mesh.shape()[i]) * stride;
+      }
+      stride *= mesh.shape()[i];
+    }
+    double out = 0;
+    Index combinations = 1;
+    for (Index i = 0; i < N; ++i) {
+      combinations *= Cubic::Taps;
+    }
+    for (Index c = 0; c < combinations; ++c) {
+      double weight = 1;
+      Index offset = 0;
+      auto index = c;
+      for (Index i = 0; i < N; ++i) {
+        const auto k = i * Cubic::Taps + index % Cubic::Taps;
+        weight *= w[k];
+        offset += offsets[k];
+        index /= Cubic::Taps;
+      }
+      out += weight * mesh.data()[offset];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Evaluate a mesh row by row, in parallel, and apply a function to each row.
+   * @param mesh The mesh
+   * @param threads The threads
+   * @param func The function, which takes the offset of the row in the full-resolution raster, and the row values
+   *
+   * The mesh is interpolated along all axes but the first one to get a mesh line,
+   * which is then interpolated along the first axis with precomputed weights and indices.
+   */
+  template <typename TFunc>
+  void for_each_row(const Raster<T, N>& mesh, const Threads& threads, TFunc&& func) const
+  {
+    const auto width = m_shape[0];
+    const auto mesh_width = mesh.shape()[0];
+    std::vector<Index> row_indices(width * Cubic::Taps);
+    std::vector<double> row_weights(width * Cubic::Taps);
+    for (Index x = 0; x < width; ++x) {
+      const auto front = weights(0, x, &row_weights[x * Cubic::Taps]);
+      for (Index k = 0; k < Cubic::Taps; ++k) {
+        row_indices[x * Cubic::Taps + k] = Nearest::index(front + k, mesh_width);
+      }
+    }
+    Index rows = 1;
+    for (Index i = 1; i < N; ++i) {
+      rows *= m_shape[i];
+    }
+    std::vector<double> line;
+    std::vector<T> row;
+#pragma omp parallel for num_threads(threads.count()) schedule(static) firstprivate(line, row)
+    for (Index r = 0; r < rows; ++r) {
+      line.assign(mesh_width, 0.);
+      row.resize(width);
+
+      // Interpolate along the axes 1 to N-1
+      std::array<double, N * Cubic::Taps> w;
+      std::array<Index, N * Cubic::Taps> offsets;
+      Index stride = mesh_width;
+      auto index = r;
+      for (Index i = 1; i < N; ++i) {
+        const auto front = weights(i, index % m_shape[i], &w[i * Cubic::Taps]);
+        for (Index k = 0; k < Cubic::Taps; ++k) {
+          offsets[i * Cubic::Taps + k] = Nearest::index(front + k, mesh.shape()[i]) * stride;
+        }
+        index /= m_shape[i];
+        stride *= mesh.shape()[i];
+      }
+      Index combinations = 1;
+      for (Index i = 1; i < N; ++i) {
+        combinations *= Cubic::Taps;
+      }
+      for (Index c = 0; c < combinations; ++c) {
+        double weight = 1;
+        Index offset = 0;
+        auto cindex = c;
+        for (Index i = 1; i < N; ++i) {
+          const auto k = i * Cubic::Taps + cindex % Cubic::Taps;
+          weight *= w[k];
+          offset += offsets[k];
+          cindex /= Cubic::Taps;
+        }
+        const auto* src = mesh.data() + offset;
+        for (Index u = 0; u < mesh_width; ++u) {
+          line[u] += weight * src[u];
+        }
+      }
+
+      // Interpolate along the axis 0
+      for (Index x = 0; x < width; ++x) {
+        const auto* rw = &row_weights[x * Cubic::Taps];
+        const auto* ri = &row_indices[x * Cubic::Taps];
+        double sum = 0;
+        for (Index k = 0; k < Cubic::Taps; ++k) {
+          sum += rw[k] * line[ri[k]];
+        }
+        row[x] = sum;
+      }
+      func(r * width, row.data());
+    }
+  }
+
+  /**
+   * @brief The shape of the full-resolution maps.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The tile shape.
+   */
+  Position<N> m_tile;
+
+  /**
+   * @brief The background mesh.
+   */
+  Raster<T, N> m_mesh;
+
+  /**
+   * @brief The noise mesh.
+   */
+  Raster<T, N> m_rms;
+};
+
+/**
+ * @relatesalso Background
+ * @brief Estimate the background and noise of a raster on a mesh of tiles.
+ * @param in The input raster
+ * @param tile The tile shape
+ * @param radius The radius of the median filter of the mesh, or 0 to disable it
+ * @param threads The threads
+ */
+template <typename T, Index N, typename THolder>
+Background<typename TypeTraits<std::remove_const_t<T>>::Floating, N>
+background(const Raster<T, N, THolder>& in, Position<N> tile, Index radius = 1, const Threads& threads = Threads(1))
+{
+  return Background<typename TypeTraits<std::remove_const_t<T>>::Floating, N>(in, LINX_MOVE(tile), radius, threads);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,243 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_DISTANCETRANSFORM_H
+#define _LINXTRANSFORMS_DISTANCETRANSFORM_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Mask.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // min, transform
+#include <cmath> // round, sqrt
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A finite value used as infinity, which keeps parabola intersections finite.
+ */
+constexpr double distance_infinity = 1e20;
+
+/**
+ * @brief Compute the 1D squared distance transform of a sampled function (Felzenszwalb & Huttenlocher).
+ * @param f The input function, of given size
+ * @param size The number of samples
+ * @param d The output, which may alias no input
+ * @param v The buffer of parabola locations, of at least `size` elements
+ * @param z The buffer of parabola boundaries, of at least `size + 1` elements
+ *
+ * The output is the lower envelope of the parabolas rooted at each sample, computed in linear time.
+ */
+inline void squared_distance_1d(const double* f, Index size, double* d, Index* v, double* z)
+{
+  Index k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<double>::infinity();
+  z[1] = std::numeric_limits<double>::infinity();
+  const auto intersection = [&](Index q, Index p) {
+    return ((f[q] + double(q * q)) - (f[p] + double(p * p))) / double(2 * q - 2 * p);
+  };
+  for (Index q = 1; q < size; ++q) {
+    auto s = intersection(q, v[k]);
+    while (s <= z[k]) { // Terminates since z[0] = -inf
+      --k;
+      s = intersection(q, v[k]);
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<double>::infinity();
+  }
+  k = 0;
+  for (Index q = 0; q < size; ++q) {
+    while (z[k + 1] < q) {
+      ++k;
+    }
+    const auto p = v[k];
+    d[q] = double((q - p) * (q - p)) + f[p];
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the exact squared Euclidean distance to the nearest non-zero pixel.
+ * @param in The input raster, whose non-zero pixels are the features
+ * @param threads The threads
+ *
+ * The Felzenszwalb-Huttenlocher algorithm is applied separably, along each axis successively,
+ * such that the cost is linear in the number of pixels, whatever the distances.
+ * Lines along a given axis are independent, and shared between the threads.
+ *
+ * Features are at distance 0, and if there is no feature, all distances are infinite.
+ *
+ * \code
+ * const auto d2 = squared_distance_transform(bad_pixels);
+ * const auto weights = d2.apply([](auto e) { return 1 - std::exp(-e / 2); }); // Down-weight neighbors
+ * \endcode
+ *
+ * @see `distance_transform()`
+ * @see `chamfer_distance_transform()`
+ */
+template <typename T, Index N, typename THolder>
+Raster<double, N> squared_distance_transform(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1))
+{
+  Raster<double, N> out(in.shape());
+  std::transform(in.begin(), in.end(), out.begin(), [](const auto& e) {
+    return e == T() ? Internal::distance_infinity : 0.;
+  });
+  const auto size = out.size();
+  Index stride = 1;
+  for (Index axis = 0; axis < out.dimension(); ++axis) {
+    const auto length = out.length(axis);
+    if (length <= 1 || size == 0) {
+      stride *= length;
+      continue;
+    }
+    const Index count = size / length;
+    auto* data = out.data();
+#pragma omp parallel num_threads(threads.count())
+    {
+      std::vector<double> f(length);
+      std::vector<double> d(length);
+      std::vector<Index> v(length);
+      std::vector<double> z(length + 1);
+#pragma omp for schedule(static)
+      for (Index k = 0; k < count; ++k) {
+        auto* line = data + (k / stride) * stride * length + k % stride;
+        for (Index q = 0; q < length; ++q) {
+          f[q] = line[q * stride];
+        }
+        Internal::squared_distance_1d(f.data(), length, d.data(), v.data(), z.data());
+        for (Index q = 0; q < length; ++q) {
+          line[q * stride] = d[q];
+        }
+      }
+    }
+    stride *= length;
+  }
+  for (auto& e : out) {
+    if (e >= Internal::distance_infinity) {
+      e = std::numeric_limits<double>::infinity();
+    }
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the exact Euclidean distance to the nearest non-zero pixel.
+ * @see `squared_distance_transform()`
+ */
+template <typename T, Index N, typename THolder>
+Raster<double, N> distance_transform(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1))
+{
+  auto out = squared_distance_transform(in, threads);
+  for (auto& e : out) {
+    e = std::sqrt(e);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the exact Euclidean distance to the nearest position of a mask, in its bounding box.
+ *
+ * The output raster is indexed relative to the bounding box front.
+ */
+template <Index N>
+Raster<double, N> distance_transform(const Mask<N>& in, const Threads& threads = Threads(1))
+{
+  Raster<char, N> flags(in.shape());
+  flags.fill(0);
+  const auto& front = in.box().front();
+  for (const auto& p : in) {
+    flags[p - front] = 1;
+  }
+  return distance_transform(flags, threads);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Approximate the Euclidean distance to the nearest non-zero pixel with a chamfer distance.
+ * @param in The input raster, whose non-zero pixels are the features
+ * @param weights The weights of the neighbors which differ along 1, 2... axes
+ *
+ * The distance is propagated in two raster scans (forward and backward) from the full-connectivity neighbors.
+ * The weight of a neighbor is given by the number of axes along which it differs from the current pixel.
+ * The default weights (1, 1.4, 1.7...) are close to the actual lengths (1, sqrt(2), sqrt(3)...).
+ *
+ * The chamfer distance is faster but less accurate than the exact `distance_transform()`.
+ * Pixels which are not connected to a feature are at infinite distance.
+ */
+template <typename T, Index N, typename THolder>
+Raster<float, N> chamfer_distance_transform(const Raster<T, N, THolder>& in, std::vector<float> weights = {})
+{
+  const auto dimension = in.dimension();
+  if (weights.empty()) {
+    for (Index i = 1; i <= dimension; ++i) {
+      weights.push_back(std::round(std::sqrt(float(i)) * 10) / 10);
+    }
+  }
+  Raster<float, N> out(in.shape());
+  std::transform(in.begin(), in.end(), out.begin(), [](const auto& e) {
+    return e == T() ? std::numeric_limits<float>::infinity() : 0.f;
+  });
+
+  // Split the neighbors into those which precede and follow the current pixel in memory
+  std::vector<std::pair<Position<N>, float>> backward;
+  std::vector<std::pair<Position<N>, float>> forward;
+  for (const auto& d : Box<N>(Position<N>::zero(dimension) - 1, Position<N>::zero(dimension) + 1)) {
+    Index nonzeros = 0;
+    Index last = 0;
+    for (auto e : d) {
+      if (e != 0) {
+        ++nonzeros;
+        last = e;
+      }
+    }
+    if (nonzeros > 0) {
+      (last < 0 ? backward : forward).emplace_back(d, weights[nonzeros - 1]);
+    }
+  }
+
+  const auto domain = out.domain();
+  const auto propagate = [&](const auto& p, const auto& neighbors) {
+    auto& e = out[p];
+    for (const auto& n : neighbors) {
+      const auto q = p + n.first;
+      if (domain.contains(q)) {
+        e = std::min(e, out[q] + n.second);
+      }
+    }
+  };
+  for (const auto& p : domain) {
+    propagate(p, backward);
+  }
+  const Index size = out.size();
+  const auto& shape = out.shape();
+  auto p = domain.back();
+  for (Index i = 0; i < size; ++i) { // Reverse scan
+    propagate(p, forward);
+    for (Index a = 0; a < dimension; ++a) {
+      if (p[a] > 0) {
+        --p[a];
+        break;
+      }
+      p[a] = shape[a] - 1;
+    }
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
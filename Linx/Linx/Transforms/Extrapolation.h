@@ -5,9 +5,13 @@
 #ifndef _LINXTRANSFORMS_EXTRAPOLATION_H
 #define _LINXTRANSFORMS_EXTRAPOLATION_H
 
+#include "Linx/Data/DimensionDispatch.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/impl/ResamplingMethods.h"
 
+#include <algorithm> // copy, fill, max, min
+#include <type_traits> // decay_t, false_type, is_same_v, remove_const_t, true_type, void_t
+
 namespace Linx {
 
 /**
@@ -74,14 +78,40 @@ public:
     return m_raster.domain();
   }
 
+  /**
+   * @brief Check whether a position lies inside the raster domain, i.e. needs no extrapolation.
+   */
+  inline bool is_inner(const Position<Dimension>& position) const
+  {
+    const auto& shape = m_raster.shape();
+    for (std::size_t i = 0; i < position.size(); ++i) {
+      // A single unsigned comparison also rejects negative coordinates
+      if (static_cast<std::size_t>(position[i]) >= static_cast<std::size_t>(shape[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check whether a box lies inside the raster domain, i.e. needs no extrapolation.
+   * 
+   * This allows callers to classify regions once, and to access the raster directly for inner regions.
+   */
+  inline bool is_inner(const Box<Dimension>& box) const
+  {
+    return is_inner(box.front()) && is_inner(box.back());
+  }
+
   /**
    * @brief Access the element at given position.
    * 
-   * If the position is outside the image domain, apply the extrapolation method.
+   * If the position is inside the image domain, the raster is accessed directly.
+   * Otherwise, the extrapolation method is applied.
    */
   inline const Value& operator[](const Position<Dimension>& position) const
   {
-    return m_method.at(m_raster, position);
+    return is_inner(position) ? m_raster[position] : m_method.at(m_raster, position);
   }
 
   /**
@@ -117,12 +147,52 @@ public:
   template <typename TRegion>
   Raster<std::decay_t<Value>, Dimension> copy(TRegion&& region) const
   {
-    // FIXME optimize
-    return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    if constexpr (std::is_same_v<std::decay_t<TRegion>, Box<Dimension>>) {
+      return copy_box(region);
+    } else {
+      return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    }
   }
 
 private:
 
+  /**
+   * @brief Copy the data in a box, row by row.
+   * 
+   * The parts of the rows which lie inside the raster domain are copied directly,
+   * and only the other values are extrapolated.
+   */
+  Raster<std::decay_t<Value>, Dimension> copy_box(const Box<Dimension>& box) const
+  {
+    Raster<std::decay_t<Value>, Dimension> out(box.shape());
+    const auto domain = m_raster.domain();
+    const auto front = box.front()[0];
+    const auto back = box.back()[0];
+    const auto inner_front = std::max(front, domain.front()[0]);
+    const auto inner_back = std::min(back, domain.back()[0]);
+    auto rows_back = box.back();
+    rows_back[0] = front;
+    auto* dst = out.data();
+    for (auto p : Box<Dimension>(box.front(), rows_back)) {
+      auto q = p;
+      q[0] = inner_front;
+      const auto inside = inner_front <= inner_back && domain.contains(q);
+      const auto split = inside ? inner_front : back + 1;
+      for (; p[0] < split; ++p[0], ++dst) {
+        *dst = m_method.at(m_raster, p);
+      }
+      if (inside) {
+        const auto* src = &m_raster[q];
+        dst = std::copy(src, src + inner_back - inner_front + 1, dst);
+        p[0] = inner_back + 1;
+      }
+      for (; p[0] <= back; ++p[0], ++dst) {
+        *dst = m_method.at(m_raster, p);
+      }
+    }
+    return out;
+  }
+
   /**
    * @brief The input raster.
    */
@@ -185,6 +255,150 @@ auto extrapolation(const Raster<T, N, THolder>& raster, T constant) -> decltype(
   return Extrapolation<Raster<T, N, THolder>, Constant<T>>(raster, Constant<T>(constant));
 }
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether an extrapolation method maps each coordinate independently, with a static `index()`.
+ */
+template <typename TMethod, typename = void>
+struct HasIndex : std::false_type {};
+
+template <typename TMethod>
+struct HasIndex<TMethod, std::void_t<decltype(TMethod::index(Index(), Index()))>> : std::true_type {};
+
+/**
+ * @brief Get the 1D source index of a padding coordinate, or -1 for a constant value.
+ */
+template <typename TMethod>
+Index pad_source(Index i, Index length)
+{
+  if constexpr (HasIndex<TMethod>::value) {
+    return TMethod::index(i, length);
+  } else {
+    return -1;
+  }
+}
+
+/**
+ * @brief Call `func` with an extrapolator of a raster of variable dimension, viewed in fixed dimension `N`.
+ */
+template <Index N, typename T, typename THolder, typename TMethod, typename TFunc>
+decltype(auto) with_dimension(const Extrapolation<Raster<T, -1, THolder>, TMethod>& in, TFunc&& func)
+{
+  return with_dimension<N>(in.raster(), [&](const auto& view) -> decltype(auto) {
+    const auto extrapolator = Extrapolation<std::decay_t<decltype(view)>, TMethod>(view, TMethod(in.method()));
+    return func(extrapolator);
+  });
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso Extrapolation
+ * @brief Materialize an extrapolator over its raster domain extended by a margin.
+ * @param in The extrapolator
+ * @param margin The margin, e.g. `Box<N>::from_center(radius)`, whose front is non-positive and back is non-negative
+ * 
+ * The value at position `p - margin.front()` of the output is that of the extrapolator at position `p`.
+ * 
+ * The padded raster is built axis by axis, without per-element dispatch:
+ * input rows are copied in bulk and completed along axis 0;
+ * then, along each next axis, whole border hyperplanes are copied from their source hyperplane
+ * (or filled for `Constant`).
+ * The supported methods are `Constant`, `Nearest`, `Periodic` and `Reflect`.
+ * 
+ * The output can then be processed (e.g. filtered or warped) without any border check.
+ */
+template <typename TRaster, typename TMethod>
+AlignedRaster<std::remove_const_t<typename TRaster::Value>, TRaster::Dimension>
+pad(const Extrapolation<TRaster, TMethod>& in, const Box<TRaster::Dimension>& margin)
+{
+  using T = std::remove_const_t<typename TRaster::Value>;
+  constexpr auto N = TRaster::Dimension;
+  const auto& raster = in.raster();
+  const auto& shape = raster.shape();
+  const auto dimension = shape.size();
+  const auto& front = margin.front();
+  const auto& back = margin.back();
+  Position<N> padded_shape = shape;
+  for (std::size_t i = 0; i < dimension; ++i) {
+    padded_shape[i] += back[i] - front[i];
+  }
+  AlignedRaster<T, N> out(padded_shape);
+  T constant {};
+  if constexpr (not Internal::HasIndex<TMethod>::value) {
+    constant = in.method();
+  }
+  if (raster.size() == 0) {
+    out.fill(constant);
+    return out;
+  }
+  const auto& strides = out.strides();
+
+  // Copy the input rows and complete them along axis 0
+  const auto width = shape[0];
+  const auto left = -front[0];
+  const auto right = back[0];
+  for (const auto& p : project(raster.domain())) {
+    const auto* src = &raster[p];
+    auto* dst = &out[p - front];
+    std::copy(src, src + width, dst);
+    for (Index k = -left; k < 0; ++k) {
+      const auto s = Internal::pad_source<TMethod>(k, width);
+      dst[k] = s < 0 ? constant : src[s];
+    }
+    for (Index k = width; k < width + right; ++k) {
+      const auto s = Internal::pad_source<TMethod>(k, width);
+      dst[k] = s < 0 ? constant : src[s];
+    }
+  }
+
+  // Complete the border hyperplanes along the next axes
+  for (std::size_t a = 1; a < dimension; ++a) {
+    const auto stride = strides[a];
+    const auto length = shape[a];
+    const auto offset = -front[a];
+    auto lo = Position<N>::zero() - front;
+    auto hi = lo + shape - 1;
+    for (std::size_t i = 0; i <= a; ++i) {
+      lo[i] = 0;
+      hi[i] = 0;
+    }
+    for (const auto& q : Box<N>(lo, hi)) {
+      auto* base = &out[q];
+      for (Index c = 0; c < padded_shape[a]; ++c) {
+        const auto i = c - offset;
+        if (i >= 0 && i < length) {
+          c = offset + length - 1; // Skip the inner hyperplanes
+          continue;
+        }
+        auto* dst = base + c * stride;
+        const auto s = Internal::pad_source<TMethod>(i, length);
+        if (s < 0) {
+          std::fill(dst, dst + stride, constant);
+        } else {
+          const auto* src = base + (offset + s) * stride;
+          std::copy(src, src + stride, dst);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Extrapolation
+ * @brief Materialize a raster extended by a margin with given extrapolation method.
+ * @see `pad(const Extrapolation&, const Box&)`
+ */
+template <typename TMethod = Nearest, typename T, Index N, typename THolder, typename... TArgs>
+AlignedRaster<std::remove_const_t<T>, N> pad(const Raster<T, N, THolder>& in, const Box<N>& margin, TArgs&&... args)
+{
+  return pad(extrapolation<TMethod>(in, std::forward<TArgs>(args)...), margin);
+}
+
 /**
  * @relatesalso Extrapolation
  * @brief Do not extrapolate if `in` is an extrapolator or patch of an extrapolator.
@@ -8,6 +8,7 @@
 #include "Linx/Base/SeqUtils.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/SimpleFilter.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
 #include <type_traits> // decay
@@ -17,6 +18,11 @@ namespace Linx {
 /**
  * @ingroup filtering
  * @brief An aggregate of filters.
+ * 
+ * If all the filters are `SimpleFilter`s, raster and extrapolated inputs are filtered in a single pass:
+ * the kernels are applied to the same position as the window slides,
+ * and the aggregation function is applied on the fly, without intermediate rasters.
+ * Extrapolated inputs are padded once for all the filters.
  */
 template <typename TFunc, typename... TFilters>
 class FilterAgg :
@@ -70,23 +76,79 @@ protected:
     return {front, back};
   }
 
+  /**
+   * @brief Apply the filters to an input raster, with cropping.
+   */
+  template <typename T, Index N, typename THolder, typename TOut>
+  void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
+  {
+    if constexpr (IsFusable) {
+      transform_fused(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    } else {
+      transform_separately(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    }
+  }
+
   /**
    * @brief Apply the filters to an input extrapolator.
    */
+  template <typename TRaster, typename TMethod, typename TOut>
+  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
+  {
+    if constexpr (IsFusable) {
+      const auto padded = in.copy(in.domain() + extend<TRaster::Dimension>(window_impl()));
+      transform_fused(padded, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    } else {
+      transform_separately(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    }
+  }
+
+  /**
+   * @brief Apply the filters to an input patch.
+   */
   template <typename TIn, typename TOut>
   void transform_impl(const TIn& in, TOut& out) const
   {
-    transform_impl(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    transform_separately(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
   }
 
 private:
 
+  /**
+   * @brief Check whether the filters can be applied in a single pass.
+   */
+  static constexpr bool IsFusable = (Internal::IsSimpleFilter<TFilters>::value && ...);
+
+  /**
+   * @brief Apply each filter separately and aggregate the outputs.
+   */
   template <typename TIn, typename TOut, std::size_t... Is>
-  void transform_impl(const TIn& in, TOut& out, std::index_sequence<Is...>) const
+  void transform_separately(const TIn& in, TOut& out, std::index_sequence<Is...>) const
   {
     out.generate(m_op, std::get<Is>(m_filters) * in...);
   }
 
+  /**
+   * @brief Slide the window once and apply all of the kernels at each position, with cropping.
+   */
+  template <typename T, Index N, typename THolder, typename TOut, std::size_t... Is>
+  void transform_fused(const Raster<T, N, THolder>& in, TOut& out, std::index_sequence<Is...>) const
+  {
+    auto patches = std::make_tuple(in(extend<N>(box(std::get<Is>(m_filters).window())))...);
+    auto scratches = std::make_tuple(
+        Internal::kernel_scratch<std::decay_t<decltype(std::get<Is>(m_filters).kernel())>>(std::get<Is>(patches))...);
+    auto out_it = out.begin();
+    for (const auto& p : in.domain() - extend<N>(window_impl())) {
+      ((std::get<Is>(patches) >>= p), ...);
+      *out_it = m_op(Internal::apply_kernel(
+          std::get<Is>(m_filters).kernel(),
+          std::get<Is>(patches),
+          std::get<Is>(scratches))...);
+      ++out_it;
+      ((std::get<Is>(patches) <<= p), ...);
+    }
+  }
+
 private:
 
   TFunc m_op;
@@ -104,7 +166,10 @@ template <
     typename std::enable_if_t<is_filter<TFilter>() && is_filter<UFilter>()>* = nullptr>
 auto operator+(const TFilter& lhs, const UFilter& rhs)
 {
-  return FilterAgg<TFilter, UFilter>(std::plus<typename TFilter::Value>(), lhs, rhs);
+  return FilterAgg<std::plus<typename TFilter::Value>, TFilter, UFilter>(
+      std::plus<typename TFilter::Value>(),
+      TFilter(lhs),
+      UFilter(rhs));
 }
 
 /**
@@ -122,7 +187,7 @@ auto norm(const TFilter0& filter0, const TFilters&... filters)
   auto agg = [&](const typename TFilter0::Value& e0, const typename TFilters::Value&... es) {
     return abspow<P>(e0) + (abspow<P>(es) + ...);
   };
-  return FilterAgg<decltype(agg), TFilter0, TFilters...>(agg, filter0, filters...);
+  return FilterAgg<decltype(agg), TFilter0, TFilters...>(LINX_MOVE(agg), TFilter0(filter0), TFilters(filters)...);
 }
 
 } // namespace Linx
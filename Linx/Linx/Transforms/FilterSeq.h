@@ -5,11 +5,15 @@
 #ifndef _LINXTRANSFORMS_FILTERSEQ_H
 #define _LINXTRANSFORMS_FILTERSEQ_H
 
+#include "Linx/Base/Exceptions.h"
 #include "Linx/Base/SeqUtils.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/impl/SeparableCorrelation.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
+#include <algorithm> // copy, max, min
+#include <string> // to_string
 #include <type_traits> // decay
 
 namespace Linx {
@@ -85,6 +89,39 @@ public:
     return FilterSeq<UFilter, TFilters...>(std::tuple_cat(std::make_tuple(lhs), rhs.m_filters));
   }
 
+  /**
+   * @brief Apply the filters by slabs along the last axis, such that intermediate rasters are bounded.
+   * @param in The input raster or extrapolated raster
+   * @param out The output, with the same domain as `filter * in`
+   * @param thickness The slab thickness along the last axis, which must be positive
+   * @param threads The threads which process slabs concurrently
+   * 
+   * Each slab of the output is computed from the slab of the input it depends on,
+   * such that the intermediate rasters hold at most `thickness` slices plus the window margins, per thread.
+   * This bounds peak memory at the cost of recomputing the margins of intermediate slabs.
+   */
+  template <typename TIn, typename TOut>
+  void stream(const TIn& in, TOut& out, Index thickness, const Threads& threads = Threads(1)) const
+  {
+    if (thickness <= 0) {
+      throw Exception("Slab thickness must be positive: " + std::to_string(thickness));
+    }
+    const auto out_box = Linx::box(out.domain());
+    const auto last = out_box.dimension() - 1;
+    const auto length = out_box.length(last);
+    const auto count = (length + thickness - 1) / thickness;
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+    for (Index i = 0; i < count; ++i) {
+      auto front = out_box.front();
+      auto back = out_box.back();
+      front[last] += i * thickness;
+      back[last] = std::min(back[last], front[last] + thickness - 1);
+      const auto result = slab(in, front[last] - out_box.front()[last], back[last] - out_box.front()[last]);
+      auto outsub = out(Box<TOut::Dimension>(LINX_MOVE(front), LINX_MOVE(back)));
+      std::copy(result.begin(), result.end(), outsub.begin());
+    }
+  }
+
   /// @group_properties
 
   /**
@@ -116,10 +153,19 @@ protected:
    * @brief Filter an input raster.
    * 
    * The input is cropped according to the filter window just enough so no extrapolation is required.
+   * 
+   * Sequences of 1D correlations or convolutions (e.g. made with `convolution_along()`) are run as line passes.
    */
   template <typename T, Index N, typename THolder, typename TOut>
   void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
   {
+    if constexpr (IsSeparable) {
+      Internal::SeparableCorrelation<Value, N> separable;
+      if (separable.assign(m_filters)) {
+        separable.transform(in, out);
+        return;
+      }
+    }
     const auto outK = upto_kth<sizeof...(TFilters) - 2>(in);
     filter<sizeof...(TFilters) - 1>().transform(outK, out);
   }
@@ -128,13 +174,12 @@ protected:
    * @brief Filter an input extrapolated raster.
    * 
    * The input and output must have the same size, although not necessarily the same domain.
+   * The input is extrapolated once according to the whole sequence window, and then cropped.
    */
   template <typename TRaster, typename TMethod, typename TOut>
   void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
   {
-    const auto domain0 = in.domain() + extend<TRaster::Dimension>(window_impl());
-    const auto outK = upto_kth<sizeof...(TFilters) - 2>(in(domain0));
-    filter<sizeof...(TFilters) - 1>().transform(outK, out);
+    transform_impl(in.copy(in.domain() + extend<TRaster::Dimension>(window_impl())), out);
   }
 
   /**
@@ -153,8 +198,67 @@ protected:
     filter<N - 1>().transform(outK(domainK), out);
   }
 
+  /**
+   * @brief Filter an input raster or extrapolated raster with multi-threading.
+   * 
+   * The output is split into one slab per thread along the last axis.
+   * @see `stream()`
+   */
+  template <typename TIn, typename TOut>
+  void transform_impl(const TIn& in, TOut& out, const Threads& threads) const
+  {
+    const auto out_box = Linx::box(out.domain());
+    const auto length = out_box.length(out_box.dimension() - 1);
+    const Index count = std::max(1, threads.count());
+    stream(in, out, std::max<Index>(1, (length + count - 1) / count), threads);
+  }
+
 private:
 
+  /**
+   * @brief Filter the input slab required to compute a given output slab of a cropped raster.
+   * @param front The output slab front index along the last axis, relative to the output front
+   * @param back The output slab back index along the last axis, relative to the output front
+   */
+  template <typename T, Index N, typename THolder>
+  auto slab(const Raster<T, N, THolder>& in, Index front, Index back) const
+  {
+    const auto last = in.dimension() - 1;
+    const auto margin = extend<N>(window_impl()).length(last) - 1;
+    auto shape = in.shape();
+    shape[last] = back - front + 1 + margin;
+    const PtrRaster<const T, N> view(shape, in.data() + front * shape_stride(in.shape(), last));
+    return *this * view;
+  }
+
+  /**
+   * @brief Filter the input slab required to compute a given output slab of an extrapolated raster.
+   * @param front The output slab front index along the last axis, relative to the output front
+   * @param back The output slab back index along the last axis, relative to the output front
+   */
+  template <typename TRaster, typename TMethod>
+  auto slab(const Extrapolation<TRaster, TMethod>& in, Index front, Index back) const
+  {
+    static constexpr Index N = TRaster::Dimension;
+    const auto domain = in.domain();
+    const auto last = domain.dimension() - 1;
+    auto slab_front = domain.front();
+    auto slab_back = domain.back();
+    slab_back[last] = slab_front[last] + back;
+    slab_front[last] += front;
+    const auto padded = in.copy(Box<N>(LINX_MOVE(slab_front), LINX_MOVE(slab_back)) + extend<N>(window_impl()));
+    return *this * padded;
+  }
+
+  /**
+   * @brief Check whether the filters are box-based correlations or convolutions of the same value type.
+   * 
+   * In this case, if all windows are lines, the sequence is run as line passes
+   * which do not rely on patches and reuse a pair of buffers.
+   */
+  static constexpr bool IsSeparable =
+      ((Internal::IsBoxCorrelation<TFilters>::value && std::is_same_v<typename TFilters::Value, Value>)&&...);
+
   template <std::size_t K, typename TIn>
   auto upto_kth(const TIn& in) const
   {
@@ -9,6 +9,16 @@
 #include "Linx/Transforms/FilterAgg.h"
 #include "Linx/Transforms/FilterSeq.h"
 #include "Linx/Transforms/SimpleFilter.h"
+#include "Linx/Transforms/impl/LinePasses.h"
+#include "Linx/Transforms/impl/RecursiveGaussian.h"
+#include "Linx/Transforms/impl/RowCorrelation.h"
+#include "Linx/Transforms/impl/SlidingMedian.h"
+#include "Linx/Transforms/impl/SlidingReduction.h"
+
+#include <algorithm> // nth_element, remove_if
+#include <array>
+#include <limits>
+#include <utility> // index_sequence
 
 namespace Linx {
 
@@ -58,6 +68,8 @@ private:
 /**
  * @ingroup filtering
  * @brief Correlation kernel.
+ * 
+ * If the window is a `Box`, whole rasters are filtered row by row, with vectorized inner loops.
  */
 template <typename T, typename TWindow>
 class Correlation : public KernelMixin<T, TWindow> {
@@ -85,6 +97,26 @@ public:
     return std::inner_product(m_values.begin(), m_values.end(), neighbors.begin(), T {});
   }
 
+  /**
+   * @brief Get the kernel values, conjugated if complex.
+   */
+  const std::vector<T>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @brief Filter and crop a raster, if the window is a box.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const
+      -> decltype(
+          Internal::row_correlation(in.data(), in.shape(), extend<M>(this->window()), values(), out.begin()),
+          void())
+  {
+    Internal::row_correlation(in.data(), in.shape(), extend<M>(this->window()), m_values, out.begin());
+  }
+
 private:
 
   /**
@@ -96,6 +128,8 @@ private:
 /**
  * @ingroup filtering
  * @brief Convolution kernel.
+ * 
+ * If the window is a `Box`, whole rasters are filtered row by row, with vectorized inner loops.
  */
 template <typename T, typename TWindow>
 class Convolution : public KernelMixin<T, TWindow> {
@@ -117,6 +151,27 @@ public:
     return std::inner_product(m_values.rbegin(), m_values.rend(), neighbors.begin(), T {});
   }
 
+  /**
+   * @brief Get the kernel values.
+   */
+  const std::vector<T>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @brief Filter and crop a raster, if the window is a box.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const
+      -> decltype(
+          Internal::row_correlation(in.data(), in.shape(), extend<M>(this->window()), values(), out.begin()),
+          void())
+  {
+    const std::vector<T> reversed(m_values.rbegin(), m_values.rend());
+    Internal::row_correlation(in.data(), in.shape(), extend<M>(this->window()), reversed, out.begin());
+  }
+
 private:
 
   /**
@@ -125,6 +180,172 @@ private:
   std::vector<T> m_values;
 };
 
+/**
+ * @ingroup filtering
+ * @brief Correlation kernel with compile-time window shape.
+ * @tparam T The value type
+ * @tparam Ls The window lengths along each axis
+ * 
+ * The window is centered, the origin position being rounded down in case of even lengths.
+ * The values are stored in a `std::array` and the inner product with the neighbors is unrolled.
+ * Whole rasters are filtered row by row like with `Correlation`, with a constant number of kernel values per row.
+ */
+template <typename T, Index... Ls>
+class FixedCorrelation : public KernelMixin<T, Box<sizeof...(Ls)>> {
+public:
+
+  /**
+   * @brief The window size.
+   */
+  static constexpr Index Size = (Ls * ...);
+
+  /**
+   * @brief The window length along axis 0.
+   */
+  static constexpr Index Width = std::array<Index, sizeof...(Ls)> {Ls...}[0];
+
+  /**
+   * @brief Constructor.
+   * @param values The kernel values, in window order
+   */
+  explicit FixedCorrelation(std::array<T, Size> values) :
+      KernelMixin<T, Box<sizeof...(Ls)>>(centered_window()), m_values(LINX_MOVE(values))
+  {
+    if constexpr (is_complex<T>()) {
+      for (auto& e : m_values) {
+        e = std::conj(e);
+      }
+    }
+  }
+
+  /**
+   * @brief Perform the operation on given neighborhood values.
+   */
+  template <typename TIn>
+  inline T operator()(const TIn& neighbors) const
+  {
+    return dot(neighbors.begin(), std::make_index_sequence<Size>());
+  }
+
+  /**
+   * @brief Get the kernel values, conjugated if complex.
+   */
+  const std::array<T, Size>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  void transform(const Raster<U, M, UHolder>& in, TOut& out) const
+  {
+    Internal::row_correlation<Width>(in.data(), in.shape(), extend<M>(this->window()), m_values, out.begin());
+  }
+
+  /**
+   * @brief Make the centered window.
+   */
+  static Box<sizeof...(Ls)> centered_window()
+  {
+    const Position<sizeof...(Ls)> shape {Ls...};
+    return Box<sizeof...(Ls)>::from_shape(-((shape - 1) / 2), shape);
+  }
+
+private:
+
+  /**
+   * @brief Compute the unrolled inner product with the neighbors.
+   */
+  template <typename TIt, std::size_t... Is>
+  inline T dot(TIt it, std::index_sequence<Is...>) const
+  {
+    T out {};
+    ((out += m_values[Is] * *it, ++it), ...);
+    return out;
+  }
+
+  /**
+   * @brief The kernel values.
+   */
+  std::array<T, Size> m_values;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Convolution kernel with compile-time window shape.
+ * @see `FixedCorrelation`
+ */
+template <typename T, Index... Ls>
+class FixedConvolution : public KernelMixin<T, Box<sizeof...(Ls)>> {
+public:
+
+  /**
+   * @brief The window size.
+   */
+  static constexpr Index Size = (Ls * ...);
+
+  /**
+   * @brief The window length along axis 0.
+   */
+  static constexpr Index Width = std::array<Index, sizeof...(Ls)> {Ls...}[0];
+
+  /**
+   * @brief Constructor.
+   * @param values The kernel values, in window order
+   */
+  explicit FixedConvolution(std::array<T, Size> values) :
+      KernelMixin<T, Box<sizeof...(Ls)>>(FixedCorrelation<T, Ls...>::centered_window()), m_values(LINX_MOVE(values))
+  {}
+
+  /**
+   * @brief Perform the operation on given neighborhood values.
+   */
+  template <typename TIn>
+  inline T operator()(const TIn& neighbors) const
+  {
+    return dot(neighbors.begin(), std::make_index_sequence<Size>());
+  }
+
+  /**
+   * @brief Get the kernel values.
+   */
+  const std::array<T, Size>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  void transform(const Raster<U, M, UHolder>& in, TOut& out) const
+  {
+    std::array<T, Size> reversed;
+    std::copy(m_values.rbegin(), m_values.rend(), reversed.begin());
+    Internal::row_correlation<Width>(in.data(), in.shape(), extend<M>(this->window()), reversed, out.begin());
+  }
+
+private:
+
+  /**
+   * @brief Compute the unrolled inner product with the reversed values.
+   */
+  template <typename TIt, std::size_t... Is>
+  inline T dot(TIt it, std::index_sequence<Is...>) const
+  {
+    T out {};
+    ((out += m_values[Size - 1 - Is] * *it, ++it), ...);
+    return out;
+  }
+
+  /**
+   * @brief The kernel values.
+   */
+  std::array<T, Size> m_values;
+};
+
 /**
  * @ingroup filtering
  * @brief Mean filtering kernel.
@@ -139,9 +360,62 @@ struct MeanFilter : public KernelMixin<T, TWindow> {
   }
 };
 
+/**
+ * @ingroup filtering
+ * @brief Mean filtering kernel over a box.
+ * 
+ * Whole rasters are filtered with running sums along each axis,
+ * such that the cost per pixel does not depend on the window size.
+ */
+template <typename T, Index N>
+struct MeanFilter<T, Box<N>> : public KernelMixin<T, Box<N>> {
+  using KernelMixin<T, Box<N>>::KernelMixin;
+
+  /**
+   * @brief The type of the sums.
+   */
+  using Sum = typename TypeTraits<T>::Floating;
+
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    return std::accumulate(neighbors.begin(), neighbors.end(), T()) / neighbors.size();
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  void transform(const Raster<U, M, UHolder>& in, TOut& out) const
+  {
+    const auto window = extend<M>(this->window());
+    std::vector<Sum> current(in.begin(), in.end());
+    std::vector<Sum> next;
+    auto shape = in.shape();
+    for (Index i = 0; i < window.dimension(); ++i) {
+      const auto length = window.length(i);
+      if (length > 1) {
+        shape = Internal::running_sum(current.data(), shape, i, length, next);
+        std::swap(current, next);
+      }
+    }
+    const Sum size = window.size();
+    std::transform(current.begin(), current.end(), out.begin(), [&](const auto& e) {
+      return static_cast<T>(e / size);
+    });
+  }
+};
+
 /**
  * @ingroup filtering
  * @brief Median filtering kernel.
+ * 
+ * For even window sizes, the mean of the two middle values is returned.
+ * NaNs are ignored, and NaN is returned if all the neighbors are NaNs.
+ * 
+ * If the window is a `Box` or a `Mask`, whole rasters are filtered with a sliding window,
+ * which is updated incrementally along each row:
+ * a histogram is used for integral types of at most 16 bits, and a sorted buffer otherwise.
  */
 template <typename T, typename TWindow>
 struct MedianFilter : public KernelMixin<T, TWindow> { // FIXME even and odd specializations
@@ -149,17 +423,41 @@ struct MedianFilter : public KernelMixin<T, TWindow> { // FIXME even and odd spe
   template <typename TIn>
   T operator()(const TIn& neighbors) const
   {
-    std::vector<T> v(neighbors.begin(), neighbors.end());
-    const auto size = v.size();
-    auto b = v.data();
-    auto e = b + size;
+    std::vector<T> scratch(neighbors.size());
+    return operator()(neighbors, scratch);
+  }
+
+  /**
+   * @brief Compute the median of the neighbors, using a scratch buffer of the same size.
+   */
+  template <typename TIn>
+  T operator()(const TIn& neighbors, std::vector<T>& scratch) const
+  {
+    std::copy(neighbors.begin(), neighbors.end(), scratch.begin());
+    auto b = scratch.data();
+    auto e = std::remove_if(b, b + scratch.size(), [](const T& v) {
+      return v != v;
+    });
+    const auto size = e - b;
+    if (size == 0) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
     auto n = b + size / 2;
     std::nth_element(b, n, e);
     if (size % 2 == 1) {
       return *n;
     }
-    std::nth_element(b, n + 1, e);
-    return (*n + *(n + 1)) * .5;
+    return (*std::max_element(b, n) + *n) * .5;
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const
+      -> decltype(Internal::sliding_median<T>(in.data(), in.shape(), this->window(), out.begin()), void())
+  {
+    Internal::sliding_median<T>(in.data(), in.shape(), this->window(), out.begin());
   }
 };
 
@@ -198,6 +496,10 @@ struct BinaryDilation : public KernelMixin<T, TWindow> {
 /**
  * @ingroup filtering
  * @brief Erosion (i.e. min filtering) kernel.
+ * 
+ * If the window is a `Box` or a `Mask`, whole rasters are filtered with van Herk/Gil-Werman passes,
+ * such that the number of comparisons per pixel does not depend (`Box`)
+ * or depends linearly (`Mask`) on the window radius.
  */
 template <typename T, typename TWindow>
 struct Erosion : public KernelMixin<T, TWindow> {
@@ -207,11 +509,33 @@ struct Erosion : public KernelMixin<T, TWindow> {
   {
     return *std::min_element(neighbors.begin(), neighbors.end());
   }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const -> decltype(
+      Internal::window_extremum(
+          in.data(),
+          in.shape(),
+          this->window(),
+          std::declval<std::vector<T>&>(),
+          Internal::Minimum()),
+      void())
+  {
+    std::vector<T> values;
+    Internal::window_extremum(in.data(), in.shape(), this->window(), values, Internal::Minimum());
+    std::copy(values.begin(), values.end(), out.begin());
+  }
 };
 
 /**
  * @ingroup filtering
  * @brief Dilation (i.e. max filtering) kernel.
+ * 
+ * If the window is a `Box` or a `Mask`, whole rasters are filtered with van Herk/Gil-Werman passes,
+ * such that the number of comparisons per pixel does not depend (`Box`)
+ * or depends linearly (`Mask`) on the window radius.
  */
 template <typename T, typename TWindow>
 struct Dilation : public KernelMixin<T, TWindow> {
@@ -221,6 +545,171 @@ struct Dilation : public KernelMixin<T, TWindow> {
   {
     return *std::max_element(neighbors.begin(), neighbors.end());
   }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const -> decltype(
+      Internal::window_extremum(
+          in.data(),
+          in.shape(),
+          this->window(),
+          std::declval<std::vector<T>&>(),
+          Internal::Maximum()),
+      void())
+  {
+    std::vector<T> values;
+    Internal::window_extremum(in.data(), in.shape(), this->window(), values, Internal::Maximum());
+    std::copy(values.begin(), values.end(), out.begin());
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief Kernel which reduces the neighbors with an invertible accumulator.
+ * @tparam TAccumulator The accumulator type
+ * @tparam TWindow The window type
+ * 
+ * The accumulator implements `add(value)`, `remove(value)` and `result()`,
+ * such that adding then removing a value leaves its result unchanged.
+ * Examples are local sums of powers, local variances or local counts of some value.
+ * 
+ * If the window is a `Box` or a `Mask`, whole rasters are filtered with a sliding window:
+ * when the window moves along a row, only entering values are added and leaving values are removed.
+ * Otherwise, a copy of the accumulator is filled from scratch for each pixel.
+ */
+template <typename TAccumulator, typename TWindow>
+class ReductionFilter :
+    public KernelMixin<std::decay_t<decltype(std::declval<TAccumulator&>().result())>, TWindow> {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = std::decay_t<decltype(std::declval<TAccumulator&>().result())>;
+
+  /**
+   * @brief Constructor.
+   * @param window The window
+   * @param accumulator The empty accumulator, which is copied as needed
+   */
+  explicit ReductionFilter(TWindow window, TAccumulator accumulator = TAccumulator()) :
+      KernelMixin<Value, TWindow>(LINX_MOVE(window)), m_accumulator(LINX_MOVE(accumulator))
+  {}
+
+  /**
+   * @brief Get the empty accumulator.
+   */
+  const TAccumulator& accumulator() const
+  {
+    return m_accumulator;
+  }
+
+  /**
+   * @brief Reduce the neighbors.
+   */
+  template <typename TIn>
+  Value operator()(const TIn& neighbors) const
+  {
+    auto accumulator = m_accumulator;
+    for (const auto& e : neighbors) {
+      accumulator.add(e);
+    }
+    return accumulator.result();
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  auto transform(const Raster<U, M, UHolder>& in, TOut& out) const -> decltype(
+      Internal::sliding_reduction(in.data(), in.shape(), this->window(), std::declval<TAccumulator&>(), out.begin()),
+      void())
+  {
+    auto accumulator = m_accumulator;
+    Internal::sliding_reduction(in.data(), in.shape(), this->window(), accumulator, out.begin());
+  }
+
+private:
+
+  /**
+   * @brief The empty accumulator.
+   */
+  TAccumulator m_accumulator;
+};
+
+/**
+ * @ingroup filtering
+ * @brief 1D Gaussian smoothing kernel along some axis.
+ * @tparam T The value type
+ * @tparam N The window dimension, i.e. the axis index plus one
+ * 
+ * The kernel behaves like a correlation with a Gaussian truncated at three standard deviations.
+ * If the standard deviation is larger than some threshold, raster and extrapolated inputs are filtered
+ * with the recursive filter of Young and van Vliet, whose cost per pixel does not depend on the standard deviation.
+ * The truncated window is kept as a margin, such that extrapolation and cropping semantics are the same in both cases.
+ */
+template <typename T, Index N>
+class GaussianFilter : public Correlation<T, Box<N>> {
+public:
+
+  /**
+   * @brief The direct correlation type.
+   */
+  using Direct = Correlation<T, Box<N>>;
+
+  /**
+   * @brief Constructor.
+   * @param sigma The standard deviation
+   * @param recursive_sigma The minimum standard deviation for which the recursive filter is used
+   */
+  explicit GaussianFilter(double sigma, double recursive_sigma = 3) :
+      Direct(Internal::gaussian_window<N>(sigma), Internal::gaussian_values<T>(sigma)), m_sigma(sigma),
+      m_recursive_sigma(std::max(recursive_sigma, .5))
+  {}
+
+  /**
+   * @brief Get the standard deviation.
+   */
+  double sigma() const
+  {
+    return m_sigma;
+  }
+
+  /**
+   * @brief Check whether rasters are filtered recursively.
+   */
+  bool is_recursive() const
+  {
+    return m_sigma >= m_recursive_sigma;
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, Index M, typename UHolder, typename TOut>
+  void transform(const Raster<U, M, UHolder>& in, TOut& out) const
+  {
+    if (not is_recursive()) {
+      Direct::transform(in, out);
+      return;
+    }
+    const auto radius = this->window().length(N - 1) / 2;
+    Internal::recursive_gaussian<T>(in.data(), in.shape(), N - 1, m_sigma, radius, out.begin());
+  }
+
+private:
+
+  /**
+   * @brief The standard deviation.
+   */
+  double m_sigma;
+
+  /**
+   * @brief The recursion threshold.
+   */
+  double m_recursive_sigma;
 };
 
 /**
@@ -289,6 +778,35 @@ auto correlation(const Raster<T, N, THolder>& values)
   return correlation(values.data(), values.domain() - (values.shape() - 1) / 2);
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a correlation kernel with compile-time window shape, with centered origin.
+ * @tparam Ls The window lengths
+ * 
+ * For example, a 3x3 correlation is made as:
+ * \code
+ * auto filter = fixed_correlation<float, 3, 3>({0, 1, 0, 1, -4, 1, 0, 1, 0});
+ * \endcode
+ * 
+ * @see `FixedCorrelation`
+ */
+template <typename T, Index... Ls>
+auto fixed_correlation(const std::array<T, (Ls * ...)>& values)
+{
+  return SimpleFilter<FixedCorrelation<T, Ls...>>(values);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a convolution kernel with compile-time window shape, with centered origin.
+ * @see `fixed_correlation()`
+ */
+template <typename T, Index... Ls>
+auto fixed_convolution(const std::array<T, (Ls * ...)>& values)
+{
+  return SimpleFilter<FixedConvolution<T, Ls...>>(values);
+}
+
 /**
  * @ingroup filtering
  * @brief Create a filter made of identical 1D correlation kernels along given axes.
@@ -331,6 +849,34 @@ auto convolution_along(const std::vector<T>& values)
   }
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a separable Gaussian filter along given axes.
+ * @param sigma The standard deviation
+ * @param recursive_sigma The minimum standard deviation for which the recursive implementation is used
+ * 
+ * Below `recursive_sigma`, the filter is a sequence of 1D correlations with a Gaussian truncated at `3 * sigma`;
+ * above, lines are smoothed by a recursive filter, whose cost does not depend on `sigma`.
+ * In both cases, the windows are the truncated Gaussian windows, such that extrapolated inputs are handled alike.
+ * 
+ * For example, to smooth a 2D raster with a Gaussian of standard deviation 5, do:
+ * \code
+ * auto filter = gaussian_filter<float, 0, 1>(5);
+ * auto smoothed = filter * extrapolation<Nearest>(raster);
+ * \endcode
+ * 
+ * @see `GaussianFilter`
+ */
+template <typename T, Index I0, Index... Is>
+auto gaussian_filter(double sigma, double recursive_sigma = 3)
+{
+  if constexpr (sizeof...(Is) == 0) {
+    return SimpleFilter<GaussianFilter<T, I0 + 1>>(sigma, recursive_sigma);
+  } else {
+    return gaussian_filter<T, I0>(sigma, recursive_sigma) * gaussian_filter<T, Is...>(sigma, recursive_sigma);
+  }
+}
+
 /**
  * @ingroup filtering
  * @brief Make a Prewitt gradient filter along given axes.
@@ -408,15 +954,22 @@ auto laplace_operator(T sign = 1)
 
 /**
  * @ingroup filtering
+ * @brief Make a mean filter.
+ * 
+ * If the window is a `Box`, raster and extrapolated inputs are filtered with running sums,
+ * such that the complexity does not depend on the window size.
  */
 template <typename T, typename TWindow>
 auto mean_filter(TWindow window)
 {
-  return SimpleFilter<MeanFilter<T, TWindow>>(MeanFilter<T, TWindow>(LINX_MOVE(window))); // FIXME separable
+  return SimpleFilter<MeanFilter<T, TWindow>>(MeanFilter<T, TWindow>(LINX_MOVE(window)));
 }
 
 /**
  * @ingroup filtering
+ * @brief Make a median filter.
+ * 
+ * If the window is a `Box` or a `Mask`, raster and extrapolated inputs are filtered with a sliding window.
  */
 template <typename T, typename TWindow>
 auto median_filter(TWindow window)
@@ -444,6 +997,9 @@ auto binary_dilation(TWindow window)
 
 /**
  * @ingroup filtering
+ * @brief Make an erosion (i.e. min filter).
+ * 
+ * If the window is a `Box` or a `Mask`, raster and extrapolated inputs are filtered with van Herk/Gil-Werman passes.
  */
 template <typename T, typename TWindow>
 auto erosion(TWindow window)
@@ -453,6 +1009,9 @@ auto erosion(TWindow window)
 
 /**
  * @ingroup filtering
+ * @brief Make a dilation (i.e. max filter).
+ * 
+ * If the window is a `Box` or a `Mask`, raster and extrapolated inputs are filtered with van Herk/Gil-Werman passes.
  */
 template <typename T, typename TWindow>
 auto dilation(TWindow window)
@@ -460,6 +1019,20 @@ auto dilation(TWindow window)
   return SimpleFilter<Dilation<T, TWindow>>(Dilation<T, TWindow>(LINX_MOVE(window)));
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a filter which reduces the neighbors with an invertible accumulator.
+ * 
+ * If the window is a `Box` or a `Mask`, raster and extrapolated inputs are filtered with a sliding window.
+ * 
+ * @see `ReductionFilter`
+ */
+template <typename TAccumulator, typename TWindow>
+auto reduction_filter(TWindow window, TAccumulator accumulator = TAccumulator())
+{
+  return SimpleFilter<ReductionFilter<TAccumulator, TWindow>>(LINX_MOVE(window), LINX_MOVE(accumulator));
+}
+
 // FIXME find better names for morphological operations, e.g.
 // - binary_erosion -> erosion
 // - erosion -> minimum_filter
@@ -0,0 +1,261 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_INTEGRALIMAGE_H
+#define _LINXTRANSFORMS_INTEGRALIMAGE_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy, min
+#include <type_traits>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The accumulation type of a value type, which prevents overflows of integral types.
+ */
+template <typename T>
+using SumType =
+    std::conditional_t<std::is_integral_v<T>, Index, std::conditional_t<std::is_floating_point_v<T>, double, T>>;
+
+/**
+ * @brief Compute the cumulative sums along an axis of some contiguous data, in place.
+ * @param data The data
+ * @param stride The distance between consecutive elements along the axis, i.e. the product of the previous lengths
+ * @param length The length along the axis
+ * @param outer The product of the next lengths
+ * @param threads The threads
+ *
+ * If the stride is 1, lines are independent and shared between the threads.
+ * Otherwise, consecutive hyperplanes are added block by block, such that the additions are contiguous
+ * and the blocks fit in cache, and blocks are shared between the threads.
+ */
+template <typename T>
+void cumsum_inplace(T* data, Index stride, Index length, Index outer, const Threads& threads)
+{
+  if (length <= 1) {
+    return;
+  }
+  if (stride == 1) {
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index o = 0; o < outer; ++o) {
+      auto* line = data + o * length;
+      for (Index k = 1; k < length; ++k) {
+        line[k] += line[k - 1];
+      }
+    }
+    return;
+  }
+  constexpr Index block = 256;
+  const auto block_count = (stride + block - 1) / block;
+  const auto task_count = outer * block_count;
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index t = 0; t < task_count; ++t) {
+    auto* base = data + (t / block_count) * stride * length;
+    const auto begin = (t % block_count) * block;
+    const auto end = std::min(stride, begin + block);
+    for (Index k = 1; k < length; ++k) {
+      auto* plane = base + k * stride;
+      const auto* previous = plane - stride;
+      for (Index x = begin; x < end; ++x) {
+        plane[x] += previous[x];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Compute the cumulative sums of a raster along a given axis, in place.
+ */
+template <typename T, Index N, typename THolder>
+void cumsum_inplace(Raster<T, N, THolder>& raster, Index axis, const Threads& threads)
+{
+  const auto length = raster.length(axis);
+  const auto stride = raster.strides()[axis];
+  const auto size = raster.size();
+  if (size == 0) {
+    return;
+  }
+  cumsum_inplace(raster.data(), stride, length, size / (stride * length), threads);
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the cumulative sums of a raster along the `I`-th axis.
+ * @param in The input raster
+ * @param threads The threads
+ *
+ * The output value at position `p` is the sum of the input values at the positions which differ from `p`
+ * only along axis `I`, with a lower or equal coordinate.
+ * The value type is preserved, such that overflows are possible for small integral types:
+ * use `integral_image()` or convert the input beforehand if needed.
+ *
+ * @see `integral_image()`
+ */
+template <Index I, typename T, Index N, typename THolder>
+Raster<std::remove_const_t<T>, N> cumsum(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1))
+{
+  Raster<std::remove_const_t<T>, N> out(in.shape(), in);
+  Internal::cumsum_inplace(out, I, threads);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief A summed-area table, to compute the sum of a raster over any box in constant time.
+ * @tparam T The accumulation type
+ * @tparam N The dimension
+ *
+ * The table is the cumulative sum of the raster along all axes,
+ * padded with a leading hyperplane of zeros along each axis, such that queries need no branching.
+ * The sum over a box is then obtained from the `2^N` values of the table at its corners,
+ * whatever the box shape, e.g. for fast box means, local variances or rectangle photometry.
+ *
+ * \code
+ * const auto table = integral_image(image);
+ * const auto flux = table.sum(aperture);
+ * \endcode
+ *
+ * @see `integral_image()`
+ */
+template <typename T, Index N = 2>
+class IntegralImage {
+public:
+
+  /**
+   * @brief The accumulation type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param in The input raster
+   * @param threads The threads
+   */
+  template <typename U, typename THolder>
+  explicit IntegralImage(const Raster<U, N, THolder>& in, const Threads& threads = Threads(1)) :
+      m_domain(in.domain()), m_table(in.shape() + 1)
+  {
+    m_table.fill(T());
+    if (in.size() == 0) {
+      return;
+    }
+    const auto width = in.length(0);
+    for (const auto& p : project(m_domain)) {
+      const auto* src = &in[p];
+      std::copy(src, src + width, &m_table[p + 1]);
+    }
+    for (Index i = 0; i < m_table.dimension(); ++i) {
+      Internal::cumsum_inplace(m_table, i, threads);
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the domain of the input raster.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /**
+   * @brief Get the padded table, of shape `domain().shape() + 1`.
+   */
+  const Raster<T, N>& table() const
+  {
+    return m_table;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the sum of the input raster over a box.
+   * @param box The box, which must be included in the domain
+   */
+  T sum(const Box<N>& box) const
+  {
+    const auto dimension = box.dimension();
+    const auto& front = box.front();
+    const auto& back = box.back();
+    auto q = front;
+    T out {};
+    for (Index corner = 0; corner < (Index(1) << dimension); ++corner) {
+      bool negative = false;
+      for (Index i = 0; i < dimension; ++i) {
+        if ((corner >> i) & 1) {
+          q[i] = back[i] + 1;
+        } else {
+          q[i] = front[i];
+          negative = not negative;
+        }
+      }
+      if (negative) {
+        out -= m_table[q];
+      } else {
+        out += m_table[q];
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the mean of the input raster over a box.
+   * @param box The box, which must be included in the domain
+   */
+  double mean(const Box<N>& box) const
+  {
+    return double(sum(box)) / box.size();
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The input domain.
+   */
+  Box<N> m_domain;
+
+  /**
+   * @brief The padded summed-area table.
+   */
+  Raster<T, N> m_table;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Compute the summed-area table of a raster.
+ * @param in The input raster
+ * @param threads The threads
+ *
+ * Integral values are accumulated as `Index`, and floating point values as `double`.
+ */
+template <typename T, Index N, typename THolder>
+IntegralImage<Internal::SumType<std::remove_const_t<T>>, N>
+integral_image(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1))
+{
+  return IntegralImage<Internal::SumType<std::remove_const_t<T>>, N>(in, threads);
+}
+
+} // namespace Linx
+
+#endif
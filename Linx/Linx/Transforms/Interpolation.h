@@ -5,11 +5,37 @@
 #ifndef _LINXTRANSFORMS_INTERPOLATION_H
 #define _LINXTRANSFORMS_INTERPOLATION_H
 
+#include "Linx/Base/Threads.h"
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+#include "Linx/Transforms/impl/BSpline.h"
 #include "Linx/Transforms/impl/ResamplingMethods.h"
 
+#include <algorithm> // clamp, sort
+#include <type_traits> // false_type, remove_const_t, true_type, void_t
+#include <utility> // pair
+#include <vector>
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether an interpolation method has to be prepared with the parent, e.g. to cache coefficients.
+ */
+template <typename TMethod, typename TParent, typename = void>
+struct HasPrepare : std::false_type {};
+
+template <typename TMethod, typename TParent>
+struct HasPrepare<
+    TMethod,
+    TParent,
+    std::void_t<decltype(std::declval<TMethod&>().prepare(std::declval<const TParent&>()))>> : std::true_type {};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup resampling
  * @brief Interpolation decorator with optional extrapolator.
@@ -24,6 +50,9 @@ namespace Linx {
  * 
  * If `TParent` is a raster, then no bound checking is performed.
  * This is the fastest option when no value outside the raster domain has to be evaluated.
+ * 
+ * If the method provides `prepare(parent)`, it is called once by the constructor,
+ * e.g. for `BSpline` to compute and cache its coefficients.
  */
 template <typename TParent, typename TMethod>
 class Interpolation {
@@ -49,7 +78,11 @@ public:
    */
   explicit Interpolation(const TParent& parent, TMethod&& method = TMethod()) :
       m_parent(parent), m_method(std::move(method))
-  {}
+  {
+    if constexpr (Internal::HasPrepare<TMethod, TParent>::value) {
+      m_method.prepare(m_parent);
+    }
+  }
 
   /**
    * @brief Get the decorated parent.
@@ -94,7 +127,7 @@ public:
   /**
    * @brief Get the value at given integral position.
    */
-  inline const Value& operator[](const Position<Dimension>& position) const
+  inline decltype(auto) operator[](const Position<Dimension>& position) const
   {
     return m_parent[position];
   }
@@ -107,6 +140,55 @@ public:
     return m_method.template at<Floating>(m_parent, position);
   }
 
+  /**
+   * @brief Compute the interpolated values at a list of positions, using several threads.
+   * 
+   * The values are returned in the order of the positions.
+   * Large lists are evaluated in tile order (tiles of 16 pixels along each axis) rather than in input order,
+   * such that consecutive evaluations access neighboring data, e.g. for randomly ordered catalog positions.
+   */
+  template <typename THolder>
+  Sequence<std::remove_const_t<Floating>>
+  operator()(const Sequence<Vector<double, Dimension>, THolder>& positions, const Threads& threads = Threads(1)) const
+  {
+    const auto size = static_cast<Index>(positions.size());
+    Sequence<std::remove_const_t<Floating>> out(size);
+    const auto* in = positions.data();
+    auto* values = out.data();
+    constexpr Index min_sorted_size = 1024;
+    if (size < min_sorted_size) {
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index i = 0; i < size; ++i) {
+        values[i] = (*this)(in[i]);
+      }
+      return out;
+    }
+
+    // Sort the positions by tile
+    constexpr Index tile_bits = 4;
+    const auto& shape = m_parent.shape();
+    std::vector<std::pair<Index, Index>> order(size); // Key, index
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index i = 0; i < size; ++i) {
+      Index key = 0;
+      for (Index a = shape.size() - 1; a >= 0; --a) {
+        const auto length = shape[a];
+        const auto tiles = ((length - 1) >> tile_bits) + 1;
+        const auto c = std::clamp(floor<Index>(in[i][a]), Index(0), length - 1);
+        key = key * tiles + (c >> tile_bits);
+      }
+      order[i] = {key, i};
+    }
+    std::sort(order.begin(), order.end());
+
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index i = 0; i < size; ++i) {
+      const auto j = order[i].second;
+      values[j] = (*this)(in[j]);
+    }
+    return out;
+  }
+
 private:
 
   /**
@@ -0,0 +1,362 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_LABELING_H
+#define _LINXTRANSFORMS_LABELING_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // max, min, sort, swap, unique
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief The connectivity of neighboring pixels.
+ */
+enum class Connectivity {
+  Faces, ///< Pixels are connected if they share a face (4-connectivity in 2D, 6-connectivity in 3D)
+  Full ///< Pixels are connected if they share a face, an edge or a corner (8-connectivity in 2D, 26 in 3D)
+};
+
+/**
+ * @ingroup regions
+ * @brief A connected component.
+ */
+template <Index N>
+struct Component {
+  /**
+   * @brief The bounding box.
+   */
+  Box<N> box;
+
+  /**
+   * @brief The number of pixels.
+   */
+  Index size;
+};
+
+/**
+ * @ingroup regions
+ * @brief The connected components of a raster.
+ * @see `label_components()`
+ */
+template <Index N>
+struct Components {
+  /**
+   * @brief The label map, where background pixels are labeled 0, and the pixels of the `k`-th component `k + 1`.
+   */
+  Raster<Index, N> labels;
+
+  /**
+   * @brief The components, in order of appearance.
+   */
+  std::vector<Component<N>> components;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A run of foreground pixels along axis 0.
+ */
+struct LabelRun {
+  Index begin; ///< The first pixel, along axis 0
+  Index end; ///< The pixel after the last one, along axis 0
+  Index row; ///< The row index
+};
+
+/**
+ * @brief Union-find forest over the runs.
+ */
+class RunForest {
+public:
+
+  explicit RunForest(Index size) : m_parents(size)
+  {
+    for (Index i = 0; i < size; ++i) {
+      m_parents[i] = i;
+    }
+  }
+
+  Index find(Index i)
+  {
+    while (m_parents[i] != i) {
+      m_parents[i] = m_parents[m_parents[i]]; // Path halving
+      i = m_parents[i];
+    }
+    return i;
+  }
+
+  void merge(Index i, Index j)
+  {
+    i = find(i);
+    j = find(j);
+    if (i < j) {
+      std::swap(i, j);
+    }
+    m_parents[i] = j; // The oldest run is the root
+  }
+
+private:
+
+  std::vector<Index> m_parents;
+};
+
+/**
+ * @brief Compute the row offsets of the neighbor rows which precede a row in memory.
+ * @param shape The raster shape
+ * @param connectivity The connectivity
+ * @return The row offsets of the neighbor rows, and their positions relative to the current row
+ */
+template <Index N>
+std::vector<std::pair<Index, Position<N>>> preceding_rows(const Position<N>& shape, Connectivity connectivity)
+{
+  std::vector<std::pair<Index, Position<N>>> out;
+  const auto n = shape.size();
+  if (n < 2) {
+    return out;
+  }
+  auto front = Position<N>::zero(n);
+  auto back = Position<N>::zero(n);
+  for (Index i = 1; i < Index(n); ++i) {
+    front[i] = -1;
+    back[i] = 1;
+  }
+  for (const auto& d : Box<N>(front, back)) {
+
+    // Keep rows before the current row, i.e. whose last non-zero coordinate is negative
+    Index last = 0;
+    Index nonzeros = 0;
+    for (Index i = 1; i < Index(n); ++i) {
+      if (d[i] != 0) {
+        last = d[i];
+        ++nonzeros;
+      }
+    }
+    if (last >= 0 || (connectivity == Connectivity::Faces && nonzeros > 1)) {
+      continue;
+    }
+
+    Index offset = 0;
+    Index stride = 1;
+    for (Index i = 1; i < Index(n); ++i) {
+      offset += d[i] * stride;
+      stride *= shape[i];
+    }
+    out.emplace_back(offset, d);
+  }
+  return out;
+}
+
+/**
+ * @brief Compute the positions of the neighbors of the origin, excluding the origin.
+ */
+template <Index N>
+std::vector<Position<N>> neighbor_offsets(Index dimension, Connectivity connectivity)
+{
+  std::vector<Position<N>> out;
+  for (const auto& d : Box<N>(Position<N>::zero(dimension) - 1, Position<N>::zero(dimension) + 1)) {
+    Index nonzeros = 0;
+    for (auto e : d) {
+      nonzeros += (e != 0);
+    }
+    if (nonzeros > 0 && (connectivity == Connectivity::Full || nonzeros == 1)) {
+      out.push_back(d);
+    }
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup regions
+ * @brief Label the connected components of a raster.
+ * @param in The input raster, whose non-zero pixels are foreground
+ * @param connectivity The connectivity
+ *
+ * Components are labeled with a two-pass, run-based union-find algorithm:
+ * the foreground is first decomposed into runs along axis 0,
+ * runs are merged with the overlapping runs of the neighboring rows which precede them in memory,
+ * and the label map is finally filled run by run with consecutive labels.
+ * The cost is linear in the number of pixels, and merges are performed per run instead of per pixel.
+ *
+ * \code
+ * const auto mask = Cosmics::detect(...);
+ * const auto components = label_components(mask);
+ * for (const auto& c : components.components) {
+ *   ... // Use c.box and c.size
+ * }
+ * \endcode
+ */
+template <typename T, Index N, typename THolder>
+Components<N> label_components(const Raster<T, N, THolder>& in, Connectivity connectivity = Connectivity::Full)
+{
+  const auto& shape = in.shape();
+  Components<N> out {Raster<Index, N>(shape), {}};
+  out.labels.fill(0);
+  const auto size = in.size();
+  const auto width = size > 0 ? shape[0] : Index(0);
+  if (width == 0) {
+    return out;
+  }
+  const Index row_count = size / width;
+  const auto domain = project(in.domain());
+
+  // First pass: extract the runs
+  std::vector<Internal::LabelRun> runs;
+  std::vector<Index> row_runs(row_count + 1, 0); // Index of the first run of each row
+  const auto* data = in.data();
+  for (Index r = 0; r < row_count; ++r, data += width) {
+    row_runs[r] = runs.size();
+    for (Index x = 0; x < width; ++x) {
+      if (data[x] == T()) {
+        continue;
+      }
+      const auto begin = x;
+      while (x < width && data[x] != T()) {
+        ++x;
+      }
+      runs.push_back({begin, x, r});
+    }
+  }
+  row_runs[row_count] = runs.size();
+
+  // Merge the runs with the overlapping runs of the preceding neighbor rows
+  Internal::RunForest forest(runs.size());
+  const auto neighbors = Internal::preceding_rows(shape, connectivity);
+  const Index margin = connectivity == Connectivity::Full ? 1 : 0;
+  Index r = 0;
+  for (const auto& p : domain) {
+    for (const auto& n : neighbors) {
+      if (not domain.contains(p + n.second)) {
+        continue;
+      }
+      const auto q = r + n.first;
+      auto j = row_runs[q];
+      for (auto i = row_runs[r]; i < row_runs[r + 1]; ++i) {
+        const auto& run = runs[i];
+        while (j < row_runs[q + 1] && runs[j].end + margin <= run.begin) {
+          ++j;
+        }
+        for (auto k = j; k < row_runs[q + 1] && runs[k].begin < run.end + margin; ++k) {
+          forest.merge(i, k);
+        }
+      }
+    }
+    ++r;
+  }
+
+  // Second pass: resolve the labels of the roots and fill the map
+  std::vector<Index> labels(runs.size(), 0);
+  auto* label_data = out.labels.data();
+  Position<N> row_front = domain.front();
+  r = -1;
+  auto it = domain.begin();
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    const auto& run = runs[i];
+    while (r < run.row) {
+      row_front = *it;
+      ++it;
+      ++r;
+    }
+    const auto root = forest.find(i);
+    if (labels[root] == 0) {
+      out.components.push_back({Box<N>(row_front, row_front), 0});
+      labels[root] = out.components.size();
+    }
+    const auto label = labels[root];
+    std::fill(label_data + run.row * width + run.begin, label_data + run.row * width + run.end, label);
+
+    auto& component = out.components[label - 1];
+    auto front = row_front;
+    auto back = row_front;
+    front[0] = run.begin;
+    back[0] = run.end - 1;
+    if (component.size == 0) {
+      component.box = Box<N>(front, back);
+    } else {
+      component.box |= Box<N>(front, back);
+    }
+    component.size += run.end - run.begin;
+  }
+  return out;
+}
+
+/**
+ * @ingroup regions
+ * @brief Grow the foreground of a raster from its frontier.
+ * @param mask The mask, whose non-zero pixels are foreground, and which is modified in place
+ * @param predicate The function which decides whether a background position is added to the foreground
+ * @param connectivity The connectivity
+ * @param iterations The maximum number of iterations, or -1 to grow until stability
+ * @return The number of added pixels
+ * 
+ * At each iteration, the predicate is evaluated once on each background neighbor of the pixels
+ * which were added at the previous iteration (initially, of the foreground), in memory order.
+ * Accepted positions are set to 1 immediately, such that the next evaluations see them.
+ * Growing stops when no pixel is accepted, such that the cost is proportional to the size of the frontiers,
+ * and not to the raster size times the number of iterations.
+ * 
+ * \code
+ * grow(mask, [&](const auto& p) {
+ *   return std::abs(image[p] - mean) < threshold;
+ * });
+ * \endcode
+ */
+template <typename T, Index N, typename THolder, typename TPredicate>
+Index grow(
+    Raster<T, N, THolder>& mask,
+    TPredicate&& predicate,
+    Connectivity connectivity = Connectivity::Full,
+    Index iterations = -1)
+{
+  const auto domain = mask.domain();
+  const auto offsets = Internal::neighbor_offsets<N>(mask.dimension(), connectivity);
+  std::vector<Position<N>> frontier;
+  for (const auto& p : domain) {
+    if (mask[p] != T()) {
+      frontier.push_back(p);
+    }
+  }
+  std::vector<std::pair<Index, Position<N>>> candidates;
+  Index count = 0;
+  for (Index i = 0; not frontier.empty() && i != iterations; ++i) {
+
+    // Gather the background neighbors once each, in memory order
+    candidates.clear();
+    for (const auto& p : frontier) {
+      for (const auto& d : offsets) {
+        auto q = p + d;
+        if (domain.contains(q) && mask[q] == T()) {
+          candidates.emplace_back(mask.index(q), LINX_MOVE(q));
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    const auto end = std::unique(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first == rhs.first;
+    });
+
+    // Accept candidates, which become the next frontier
+    frontier.clear();
+    for (auto it = candidates.begin(); it != end; ++it) {
+      if (predicate(it->second)) {
+        mask[it->second] = T(1);
+        frontier.push_back(it->second);
+      }
+    }
+    count += frontier.size();
+  }
+  return count;
+}
+
+} // namespace Linx
+
+#endif
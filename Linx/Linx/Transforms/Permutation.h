@@ -0,0 +1,190 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_PERMUTATION_H
+#define _LINXTRANSFORMS_PERMUTATION_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, min
+#include <array>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether a list of axes is a permutation of `0, ..., N - 1`.
+ */
+template <Index N, Index... Is>
+constexpr bool is_permutation()
+{
+  constexpr std::array<Index, sizeof...(Is)> axes {Is...};
+  if (sizeof...(Is) != N) {
+    return false;
+  }
+  for (Index i = 0; i < N; ++i) {
+    bool found = false;
+    for (auto a : axes) {
+      found |= (a == i);
+    }
+    if (not found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Permute the axes of contiguous data.
+ * @param in The input data
+ * @param in_shape The input shape
+ * @param axes The input axis of each output axis
+ * @param out The output data
+ * @param threads The threads
+ * 
+ * The input axis which becomes the output axis 0, and the output axis which comes from input axis 0,
+ * are transposed by square blocks which fit in the L1 cache, such that both reads and writes are local.
+ * Other axes are iterated over, and shared between the threads.
+ */
+template <typename T, typename U, Index N>
+void permute_data(
+    const T* in,
+    const Position<N>& in_shape,
+    const Position<N>& axes,
+    U* out,
+    const Threads& threads)
+{
+  constexpr Index block = 32;
+
+  // Strides
+  Position<N> in_strides;
+  Position<N> shape; // Output shape
+  Position<N> strides; // Input stride of each output axis
+  Position<N> out_strides;
+  Index s = 1;
+  for (Index i = 0; i < N; ++i) {
+    in_strides[i] = s;
+    s *= in_shape[i];
+  }
+  s = 1;
+  Index b = 0; // Output axis which comes from input axis 0
+  for (Index i = 0; i < N; ++i) {
+    shape[i] = in_shape[axes[i]];
+    strides[i] = in_strides[axes[i]];
+    out_strides[i] = s;
+    s *= shape[i];
+    if (axes[i] == 0) {
+      b = i;
+    }
+  }
+  if (s == 0) {
+    return;
+  }
+
+  // Work items: positions along the outer axes (other than 0 and b), times blocks along axis b
+  const Index b_length = b == 0 ? 1 : shape[b];
+  const Index b_blocks = (b_length + block - 1) / block;
+  const Index outer_count = s / shape[0] / b_length;
+  const Index item_count = outer_count * b_blocks;
+
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index item = 0; item < item_count; ++item) {
+    Index outer = item / b_blocks;
+    Index in_base = 0;
+    Index out_base = 0;
+    for (Index i = 1; i < N; ++i) {
+      if (i == b) {
+        continue;
+      }
+      const auto p = outer % shape[i];
+      outer /= shape[i];
+      in_base += p * strides[i];
+      out_base += p * out_strides[i];
+    }
+    if (b == 0) { // Input axis 0 is output axis 0: copy rows
+      std::copy_n(in + in_base, shape[0], out + out_base);
+      continue;
+    }
+    const Index b_front = (item % b_blocks) * block;
+    const Index b_end = std::min(b_front + block, b_length);
+    for (Index front = 0; front < shape[0]; front += block) {
+      const auto end = std::min(front + block, shape[0]);
+      for (Index j = b_front; j < b_end; ++j) {
+        const auto* row_in = in + in_base + j;
+        auto* row_out = out + out_base + j * out_strides[b];
+        for (Index i = front; i < end; ++i) {
+          row_out[i] = row_in[i * strides[0]];
+        }
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup affinity
+ * @brief Get the shape of a raster whose axes are permuted.
+ * @tparam Is The input axis of each output axis
+ * @see `permute()`
+ */
+template <Index... Is, Index N>
+Position<N> permute_shape(const Position<N>& shape)
+{
+  static_assert(Internal::is_permutation<N, Is...>(), "Axes must be a permutation of 0, ..., N - 1.");
+  return {shape[Is]...};
+}
+
+/**
+ * @ingroup affinity
+ * @brief Permute the axes of a raster into an existing raster.
+ * @tparam Is The input axis of each output axis
+ * @param in The input raster
+ * @param out The output raster, whose shape is `permute_shape<Is...>(in.shape())`
+ * @param threads The threads
+ * @see `permute()`
+ */
+template <Index... Is, typename T, Index N, typename THolder, typename TOut>
+TOut& permute_into(const Raster<T, N, THolder>& in, TOut& out, const Threads& threads = Threads(1))
+{
+  static_assert(N > 0, "Permutation does not support variable dimension.");
+  if (out.shape() != permute_shape<Is...>(in.shape())) {
+    throw Exception("Permutation output shape mismatch");
+  }
+  Internal::permute_data(in.data(), in.shape(), Position<N> {Is...}, out.data(), threads);
+  return out;
+}
+
+/**
+ * @ingroup affinity
+ * @brief Permute the axes of a raster.
+ * @tparam Is The input axis of each output axis
+ * @param in The input raster
+ * @param threads The threads
+ * 
+ * Output axis `i` is input axis `Is[i]`, such that, e.g., a wavelength-last cube is made wavelength-first with:
+ * 
+ * \code
+ * Raster<float, 3> cube({width, height, wavelengths});
+ * auto spectra = permute<2, 0, 1>(cube); // Shape {wavelengths, width, height}: spectra are contiguous
+ * \endcode
+ * 
+ * The permutation is computed by blocks, such that it is cache-friendly.
+ * If some output raster is already allocated, `permute_into()` should be preferred.
+ */
+template <Index... Is, typename T, Index N, typename THolder>
+Raster<std::remove_const_t<T>, N> permute(const Raster<T, N, THolder>& in, const Threads& threads = Threads(1))
+{
+  Raster<std::remove_const_t<T>, N> out(permute_shape<Is...>(in.shape()));
+  permute_into<Is...>(in, out, threads);
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,248 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_PYRAMID_H
+#define _LINXTRANSFORMS_PYRAMID_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/ResamplingMethods.h" // Reflect
+
+#include <cmath> // round
+#include <type_traits> // is_integral_v, remove_const_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Low-pass filter with a 5-tap binomial kernel and decimate by 2 along one axis.
+ * @param in The input data
+ * @param out The output data
+ * @param inner The product of the lengths of the previous axes
+ * @param length The input length along the axis
+ * @param outer The product of the lengths of the next axes
+ * @param threads The threads
+ *
+ * The input is reflected at the borders, such that the kernel is normalized everywhere.
+ * Input samples are accessed in contiguous runs of `inner` elements.
+ */
+template <typename T, typename U>
+void binomial_decimate(const T* in, U* out, Index inner, Index length, Index outer, const Threads& threads)
+{
+  constexpr double weights[] = {1. / 16., 4. / 16., 6. / 16., 4. / 16., 1. / 16.};
+  const auto half = (length + 1) / 2;
+  std::vector<double> sums;
+#pragma omp parallel for num_threads(threads.count()) schedule(static) firstprivate(sums)
+  for (Index t = 0; t < outer * half; ++t) {
+    const auto o = t / half;
+    const auto x = t % half;
+    sums.assign(inner, 0.);
+    const auto* base = in + o * length * inner;
+    for (Index k = 0; k < 5; ++k) {
+      const auto* src = base + Reflect::index(2 * x + k - 2, length) * inner;
+      const auto w = weights[k];
+      for (Index i = 0; i < inner; ++i) {
+        sums[i] += w * src[i];
+      }
+    }
+    auto* dst = out + (o * half + x) * inner;
+    for (Index i = 0; i < inner; ++i) {
+      if constexpr (std::is_integral_v<U>) {
+        dst[i] = static_cast<U>(std::round(sums[i]));
+      } else {
+        dst[i] = static_cast<U>(sums[i]);
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup affinity
+ * @brief A multi-resolution pyramid, e.g. for quicklooks or coarse-to-fine registration.
+ * @tparam T The value type
+ * @tparam N The dimension
+ *
+ * Level 0 is a copy of the input raster, and each next level is obtained from the previous one
+ * by a separable 5-tap binomial low-pass filter (1, 4, 6, 4, 1) / 16 fused with a decimation by 2 along each axis,
+ * such that only the retained samples are computed.
+ * The length of level `k + 1` along each axis is that of level `k` divided by 2 and rounded up.
+ * Borders are reflected, such that the mean value is preserved.
+ * Integral values are rounded.
+ *
+ * All the levels are allocated at once, contiguously, and are accessed as `PtrRaster`s.
+ * They remain valid as long as the pyramid is alive, even if it is moved.
+ *
+ * \code
+ * const auto levels = pyramid(image, 4, Threads(8));
+ * const auto& quicklook = levels[3];
+ * \endcode
+ *
+ * @see `pyramid()`
+ */
+template <typename T, Index N = 2>
+class Pyramid {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param in The input raster
+   * @param levels The number of levels, including the input
+   * @param threads The threads
+   *
+   * Fewer levels are built if all the lengths reach 1.
+   */
+  template <typename U, typename THolder>
+  Pyramid(const Raster<U, N, THolder>& in, Index levels, const Threads& threads = Threads(1)) : m_arena(), m_levels()
+  {
+    // Compute the shapes and allocate the arena
+    std::vector<Position<N>> shapes;
+    Index size = 0;
+    auto shape = in.shape();
+    for (Index l = 0; l < levels; ++l) {
+      shapes.push_back(shape);
+      size += shape_size(shape);
+      bool done = true;
+      for (auto& s : shape) {
+        done &= s <= 1;
+        s = (s + 1) / 2;
+      }
+      if (done) {
+        break;
+      }
+    }
+    m_arena = AlignedRaster<T, 1>({size});
+    auto* data = m_arena.data();
+    for (const auto& s : shapes) {
+      m_levels.emplace_back(s, data);
+      data += shape_size(s);
+    }
+    if (m_levels.empty()) {
+      return;
+    }
+    std::copy(in.begin(), in.end(), m_levels[0].begin());
+
+    // Build each level from the previous one, axis by axis, with unrounded intermediate passes
+    std::vector<double> buffers[2];
+    for (std::size_t l = 1; l < m_levels.size(); ++l) {
+      auto current = m_levels[l - 1].shape();
+      const auto dimension = current.size();
+      for (std::size_t a = 0; a < dimension; ++a) {
+        const auto length = current[a];
+        Index inner = 1;
+        for (std::size_t i = 0; i < a; ++i) {
+          inner *= current[i];
+        }
+        const auto outer = shape_size(current) / (inner * length);
+        current[a] = (length + 1) / 2;
+        const auto decimate = [&](const auto* src) {
+          if (a + 1 < dimension) {
+            buffers[a % 2].resize(shape_size(current));
+            Internal::binomial_decimate(src, buffers[a % 2].data(), inner, length, outer, threads);
+          } else {
+            Internal::binomial_decimate(src, m_levels[l].data(), inner, length, outer, threads);
+          }
+        };
+        if (a == 0) {
+          decimate(m_levels[l - 1].data());
+        } else {
+          decimate(buffers[(a - 1) % 2].data());
+        }
+      }
+    }
+  }
+
+  Pyramid(const Pyramid&) = delete;
+  Pyramid(Pyramid&&) = default;
+  Pyramid& operator=(const Pyramid&) = delete;
+  Pyramid& operator=(Pyramid&&) = default;
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of levels.
+   */
+  Index levels() const
+  {
+    return m_levels.size();
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Access a level.
+   */
+  const PtrRaster<T, N>& operator[](Index level) const
+  {
+    return m_levels[level];
+  }
+
+  /// @copydoc operator[]()
+  PtrRaster<T, N>& operator[](Index level)
+  {
+    return m_levels[level];
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the number of elements of a shape.
+   */
+  static Index shape_size(const Position<N>& shape)
+  {
+    Index out = 1;
+    for (auto s : shape) {
+      out *= s;
+    }
+    return out;
+  }
+
+  /**
+   * @brief The contiguous storage of all the levels.
+   */
+  AlignedRaster<T, 1> m_arena;
+
+  /**
+   * @brief The levels.
+   */
+  std::vector<PtrRaster<T, N>> m_levels;
+};
+
+/**
+ * @relatesalso Pyramid
+ * @brief Build a multi-resolution pyramid with anti-aliased decimation by 2.
+ * @param in The input raster
+ * @param levels The number of levels, including the input
+ * @param threads The threads
+ */
+template <typename T, Index N, typename THolder>
+Pyramid<std::remove_const_t<T>, N>
+pyramid(const Raster<T, N, THolder>& in, Index levels, const Threads& threads = Threads(1))
+{
+  return Pyramid<std::remove_const_t<T>, N>(in, levels, threads);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,298 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_REMAP_H
+#define _LINXTRANSFORMS_REMAP_H
+
+#include "Linx/Base/Holders.h" // SizeError
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Interpolation.h"
+
+#include <type_traits> // decay_t, is_same_v, remove_const_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the parent of an interpolator, or the input itself otherwise.
+ */
+template <typename TIn>
+const TIn& remap_source(const TIn& in)
+{
+  return in;
+}
+
+template <typename TParent, typename TMethod>
+const TParent& remap_source(const Interpolation<TParent, TMethod>& in)
+{
+  return in.parent();
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup affinity
+ * @brief A precomputed geometric distortion, to resample many rasters with the same coordinate map.
+ * @tparam TMethod The interpolation method, e.g. `Linear`, `Cubic` or `Lanczos<3>`
+ * @tparam N The dimension
+ *
+ * The coordinate map associates the input position of each output pixel,
+ * e.g. from a polynomial distortion or a WCS-to-WCS mapping.
+ * It is evaluated once, at construction, and only the interpolation stencils are stored:
+ * for each output pixel, the front position of the input neighborhood and the `N * Taps` 1D weights.
+ * Applying the remap then consists in weighted sums of input samples, without any coordinate computation.
+ *
+ * The input can be a raster, an extrapolator, or an interpolator with the same method,
+ * following the calling convention of `Affinity::transform()`.
+ * As for interpolation, rasters are not bound-checked:
+ * if positions outside the input domain are required, then the input must be an extrapolator.
+ * Extrapolation is only performed for the stencils which cross the input border.
+ *
+ * \code
+ * const Remap<Cubic> distortion(frame_domain, [&](const auto& p) { return sip(p); });
+ * for (const auto& frame : frames) {
+ *   const auto corrected = distortion.warp(extrapolation(frame, 0.), Threads(8));
+ *   ...
+ * }
+ * \endcode
+ */
+template <typename TMethod, Index N = 2>
+class Remap {
+public:
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The number of samples involved in 1D interpolation.
+   */
+  static constexpr Index Taps = TMethod::Taps;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param domain The output domain
+   * @param map The coordinate map, which returns the input position of an output position
+   * @param threads The threads
+   *
+   * The map must be thread-safe if several threads are used.
+   */
+  template <typename TMap>
+  Remap(const Box<N>& domain, TMap&& map, const Threads& threads = Threads(1)) :
+      m_domain(domain), m_dimension(domain.dimension()), m_fronts(), m_weights()
+  {
+    const auto size = m_domain.size();
+    m_fronts.resize(size * m_dimension);
+    m_weights.resize(size * m_dimension * Taps);
+    if (size <= 0) {
+      return;
+    }
+    const auto plane = project(m_domain);
+    const std::vector<Position<N>> rows(plane.begin(), plane.end());
+    const auto height = static_cast<Index>(rows.size());
+    const auto width = m_domain.length(0);
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+    for (Index r = 0; r < height; ++r) {
+      auto p = rows[r];
+      for (Index x = 0; x < width; ++x, ++p[0]) {
+        const auto q = map(p);
+        const auto i = r * width + x;
+        for (Index a = 0; a < m_dimension; ++a) {
+          m_fronts[i * m_dimension + a] = TMethod::weights(q[a], &m_weights[(i * m_dimension + a) * Taps]);
+        }
+      }
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the output domain.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Apply the remap to a raster or extrapolator, using several threads.
+   *
+   * The output raster is of shape `domain().shape()`.
+   */
+  template <typename TIn>
+  Raster<std::remove_const_t<typename TIn::Value>, N> warp(const TIn& in, const Threads& threads = Threads(1)) const
+  {
+    Raster<std::remove_const_t<typename TIn::Value>, N> out(m_domain.shape());
+    transform(in, out, threads);
+    return out;
+  }
+
+  /**
+   * @brief Apply the remap to a raster, extrapolator or interpolator, and write the result in a raster or patch.
+   *
+   * The output is filled in iteration order, and must have the same size as the remap domain.
+   * If the output is a raster, pixels are distributed among the threads.
+   * Otherwise, the transform is single-threaded.
+   */
+  template <typename TIn, typename TOut>
+  TOut& transform(const TIn& in, TOut& out, const Threads& threads = Threads(1)) const
+  {
+    if constexpr (not std::is_same_v<std::decay_t<decltype(Internal::remap_source(in))>, TIn>) {
+      static_assert(
+          std::is_same_v<std::decay_t<decltype(in.method())>, TMethod>,
+          "The interpolation method must be that of the remap.");
+    }
+    const auto& source = Internal::remap_source(in);
+    const auto size = m_domain.size();
+    if (static_cast<Index>(out.size()) != size) {
+      throw SizeError(out.size(), size);
+    }
+    if constexpr (is_raster<TOut>()) {
+      auto* data = out.data();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+      for (Index i = 0; i < size; ++i) {
+        data[i] = at(source, i);
+      }
+    } else {
+      Index i = 0;
+      for (auto& e : out) {
+        e = at(source, i);
+        ++i;
+      }
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Interpolate the input at the `i`-th output pixel.
+   *
+   * If the input decorates contiguous data and the stencil lies inside the input domain,
+   * the samples are read from a base pointer and the strides.
+   * Otherwise, they are accessed by position.
+   */
+  template <typename TIn>
+  auto at(const TIn& in, Index i) const
+  {
+    using Floating = std::remove_const_t<typename TypeTraits<typename TIn::Value>::Floating>;
+    const auto* fronts = &m_fronts[i * m_dimension];
+    const auto* weights = &m_weights[i * m_dimension * Taps];
+    if constexpr (is_raster<TIn>() || Internal::IsRasterExtrapolator<TIn>::value) {
+      const auto& raster = [&]() -> decltype(auto) {
+        if constexpr (is_raster<TIn>()) {
+          return in;
+        } else {
+          return in.raster();
+        }
+      }();
+      const auto& shape = raster.shape();
+      const auto& strides = raster.strides();
+      bool inside = true;
+      Index offset = 0;
+      for (Index a = 0; a < m_dimension; ++a) {
+        if constexpr (not is_raster<TIn>()) {
+          inside &= fronts[a] >= 0 && fronts[a] + Taps <= shape[a];
+        }
+        offset += fronts[a] * strides[a];
+      }
+      if (inside) {
+        const auto* data = raster.data() + offset;
+        const auto get = [&](Index o) {
+          return data[o];
+        };
+        return accumulate<Floating>(m_dimension - 1, weights, 0, get, strides.data());
+      }
+    }
+    Position<N> p(m_dimension);
+    return accumulate_at<Floating>(in, m_dimension - 1, fronts, weights, p);
+  }
+
+  /**
+   * @brief Recursively accumulate the weighted samples of a contiguous neighborhood, from the last axis.
+   */
+  template <typename T, typename TFunc>
+  T accumulate(Index axis, const double* weights, Index base, TFunc&& get, const Index* strides) const
+  {
+    T out {};
+    const auto* w = weights + axis * Taps;
+    if (axis == 0) {
+      for (Index k = 0; k < Taps; ++k) {
+        out += w[k] * static_cast<T>(get(base + k));
+      }
+      return out;
+    }
+    for (Index k = 0; k < Taps; ++k) {
+      out += w[k] * accumulate<T>(axis - 1, weights, base + k * strides[axis], get, strides);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Recursively accumulate the weighted samples of a neighborhood, by position.
+   */
+  template <typename T, typename TIn>
+  T accumulate_at(const TIn& in, Index axis, const Index* fronts, const double* weights, Position<N>& p) const
+  {
+    T out {};
+    const auto* w = weights + axis * Taps;
+    for (Index k = 0; k < Taps; ++k) {
+      p[axis] = fronts[axis] + k;
+      if (axis == 0) {
+        out += w[k] * static_cast<T>(in[p]);
+      } else {
+        out += w[k] * accumulate_at<T>(in, axis - 1, fronts, weights, p);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief The output domain.
+   */
+  Box<N> m_domain;
+
+  /**
+   * @brief The dimension.
+   */
+  Index m_dimension;
+
+  /**
+   * @brief The front position of the input neighborhood of each output pixel.
+   */
+  std::vector<Index> m_fronts;
+
+  /**
+   * @brief The 1D weights of each output pixel, along each axis.
+   */
+  std::vector<double> m_weights;
+};
+
+/**
+ * @relatesalso Remap
+ * @brief Make a remap from an output domain and a coordinate map.
+ */
+template <typename TMethod, Index N, typename TMap>
+Remap<TMethod, N> remap(const Box<N>& domain, TMap&& map, const Threads& threads = Threads(1))
+{
+  return Remap<TMethod, N>(domain, LINX_FORWARD(map), threads);
+}
+
+} // namespace Linx
+
+#endif
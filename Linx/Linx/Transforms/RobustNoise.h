@@ -0,0 +1,102 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_ROBUSTNOISE_H
+#define _LINXTRANSFORMS_ROBUSTNOISE_H
+
+#include "Linx/Base/DataDistribution.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Grid.h"
+#include "Linx/Data/Raster.h"
+
+#include <cmath> // isnan
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief Robust location and scale estimates of some noisy data.
+ * @see `robust_noise()`
+ */
+struct RobustNoise {
+  /**
+   * @brief The median.
+   */
+  double median;
+
+  /**
+   * @brief The median absolute deviation.
+   */
+  double mad;
+
+  /**
+   * @brief The number of samples.
+   */
+  Index count;
+
+  /**
+   * @brief Get the standard deviation of a Gaussian distribution with the same MAD.
+   */
+  double sigma() const
+  {
+    return 1.4826 * mad;
+  }
+};
+
+/**
+ * @relatesalso RobustNoise
+ * @brief Estimate the median and MAD of a raster from a subsampled grid of pixels, ignoring NaNs.
+ * @param in The input raster
+ * @param step The grid step along each axis, e.g. 4 for a 1/16 subsample of a 2D raster
+ * @param threads The threads
+ *
+ * The grid is traversed in parallel by slices along the last axis,
+ * and the median and MAD are then selected in place (without sorting) from the gathered samples.
+ * The estimates are NaN if all the sampled values are NaN.
+ *
+ * Contrary to the mean absolute value, the estimates are insensitive to the sparse outliers
+ * (e.g. sources or cosmic rays) up to 50%, which makes them well-suited to thresholding.
+ */
+template <typename T, Index N, typename THolder>
+RobustNoise robust_noise(const Raster<T, N, THolder>& in, Index step = 4, const Threads& threads = Threads(1))
+{
+  const auto& domain = in.domain();
+  const auto last = in.dimension() - 1;
+  const auto front = domain.front()[last];
+  const auto slice_count = (domain.length(last) + step - 1) / step;
+  std::vector<std::vector<double>> slices(slice_count);
+
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index s = 0; s < slice_count; ++s) {
+    auto slice_front = domain.front();
+    auto slice_back = domain.back();
+    slice_front[last] = slice_back[last] = front + s * step;
+    auto& samples = slices[s];
+    for (const auto& p : Grid<N>(Box<N>(slice_front, slice_back), step)) {
+      const double value = in[p];
+      if (not std::isnan(value)) {
+        samples.push_back(value);
+      }
+    }
+  }
+
+  std::vector<double> samples;
+  for (const auto& s : slices) {
+    samples.insert(samples.end(), s.begin(), s.end());
+  }
+  const Index count = samples.size();
+  if (count == 0) {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    return {nan, nan, 0};
+  }
+  DataDistribution<double> distribution(samples.data(), samples.data() + count);
+  const auto median = distribution.median();
+  return {median, distribution.mad(), count};
+}
+
+} // namespace Linx
+
+#endif
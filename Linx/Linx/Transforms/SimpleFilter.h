@@ -11,12 +11,87 @@
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a kernel can filter a whole raster at once.
+ * 
+ * Such kernels implement `transform(in, out)`, where `in` is a raster
+ * and `out` has domain `in.domain() - window()`, i.e. `in` is cropped.
+ */
+template <typename TKernel, typename TIn, typename TOut, typename = void>
+struct HasKernelTransform : std::false_type {};
+
+template <typename TKernel, typename TIn, typename TOut>
+struct HasKernelTransform<
+    TKernel,
+    TIn,
+    TOut,
+    std::void_t<
+        decltype(std::declval<const TKernel&>().transform(std::declval<const TIn&>(), std::declval<TOut&>()))>> :
+    std::true_type {};
+
+/**
+ * @brief Test whether a kernel accepts a scratch buffer.
+ * 
+ * Such kernels implement `operator()(neighbors, scratch)`,
+ * where `scratch` is a `std::vector<Value>` with as many elements as `neighbors`.
+ */
+template <typename TKernel, typename TIn, typename = void>
+struct HasKernelScratch : std::false_type {};
+
+template <typename TKernel, typename TIn>
+struct HasKernelScratch<
+    TKernel,
+    TIn,
+    std::void_t<decltype(std::declval<const TKernel&>()(
+        std::declval<const TIn&>(),
+        std::declval<std::vector<typename TKernel::Value>&>()))>> : std::true_type {};
+
+/**
+ * @brief Apply a kernel to some neighbors, with a scratch buffer if the kernel accepts one.
+ */
+template <typename TKernel, typename TIn>
+inline typename TKernel::Value
+apply_kernel(const TKernel& kernel, const TIn& neighbors, std::vector<typename TKernel::Value>& scratch)
+{
+  if constexpr (HasKernelScratch<TKernel, TIn>::value) {
+    return kernel(neighbors, scratch);
+  } else {
+    return kernel(neighbors);
+  }
+}
+
+/**
+ * @brief Make a scratch buffer for a kernel, which is empty if the kernel does not accept one.
+ */
+template <typename TKernel, typename TIn>
+std::vector<typename TKernel::Value> kernel_scratch(const TIn& neighbors)
+{
+  return std::vector<typename TKernel::Value>(HasKernelScratch<TKernel, TIn>::value ? neighbors.size() : 0);
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief A structuring element for morphological operations.
  * @tparam TOp The morphological operator
  * @tparam T The value type
  * @tparam TWindow The type of window, e.g. `Box` or `Mask`
+ * 
+ * The kernel is generally called on each neighborhood, through its `operator()`.
+ * Kernels which can process a whole raster more efficiently (e.g. with running sums)
+ * additionally implement `transform(in, out)`, where `in` is a raster and `out` has domain `in.domain() - window()`.
+ * In this case, `transform()` is preferred for raster and extrapolated inputs:
+ * extrapolated inputs are padded once before being transformed.
+ * 
+ * Kernels which need a temporary copy of the neighbors (e.g. for sorting)
+ * can implement `operator()(neighbors, scratch)` instead of `operator()(neighbors)`.
+ * The scratch buffer is a `std::vector<Value>` of the window size, allocated once per call to `transform()`
+ * (or once per thread and slice in multi-threaded mode), and its contents are unspecified.
  */
 template <typename TKernel>
 class SimpleFilter : public FilterMixin<typename TKernel::Value, typename TKernel::Window, SimpleFilter<TKernel>> {
@@ -85,18 +160,33 @@ protected:
   template <typename T, Index N, typename THolder, typename TOut>
   void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
   {
-    const auto region = in.domain() - window_box<N>();
-    transform_monolith(in(region), out);
+    if constexpr (Internal::HasKernelTransform<TKernel, Raster<T, N, THolder>, TOut>::value) {
+      m_kernel.transform(in, out);
+    } else {
+      const auto region = in.domain() - window_box<N>();
+      transform_monolith(in(region), out);
+    }
   }
 
   /**
    * @brief Filter an extrapolated raster.
    * 
    * The output raster has the same shape as the input raster.
+   * The inner region is filtered without extrapolation, and the bordering regions are extrapolated piecewise,
+   * unless most of the output depends on extrapolated values, in which case the whole input is padded once.
    */
   template <typename TRaster, typename TMethod, typename TOut>
   void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
   {
+    using Padded = Raster<std::decay_t<typename TRaster::Value>, TRaster::Dimension>;
+    if constexpr (Internal::HasKernelTransform<TKernel, Padded, TOut>::value) {
+      m_kernel.transform(in.copy(in.domain() + window_box<TRaster::Dimension>()), out);
+      return;
+    }
+    if (pads_whole(in.domain())) {
+      transform_impl(in.copy(in.domain() + window_box<TRaster::Dimension>()), out);
+      return;
+    }
     const auto& raw = dont_extrapolate(in);
     const auto bbox = Internal::BorderedBox<TRaster::Dimension>(raw.domain(), window_box<TRaster::Dimension>());
     bbox.apply_inner_border(
@@ -127,9 +217,203 @@ protected:
    * then `in` can be a raw patch.
    * 
    * The output raster has the same shape as the grid.
+   * Only the grid nodes are filtered, with direct index arithmetic.
    */
   template <typename T, typename TParent, typename TRegion, typename TOut>
   void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out) const
+  {
+    if constexpr (std::is_same_v<TRegion, Grid<TParent::Dimension>>) {
+      transform_grid(in.parent(), in.domain(), out);
+    } else {
+      transform_patch(in, out);
+    }
+  }
+
+  /**
+   * @brief Filter and crop an input raster with multi-threading.
+   * 
+   * The output domain is split into slices along the last axis, which are filtered concurrently.
+   */
+  template <typename T, Index N, typename THolder, typename TOut>
+  void transform_impl(const Raster<T, N, THolder>& in, TOut& out, const Threads& threads) const
+  {
+    if constexpr (Internal::HasKernelTransform<TKernel, PtrRaster<const T, N>, TOut>::value) {
+      transform_bands(in, out, threads);
+    } else {
+      const auto region = in.domain() - window_box<N>();
+      transform_monolith(in(region), out, threads);
+    }
+  }
+
+  /**
+   * @brief Filter an extrapolated raster with multi-threading.
+   * 
+   * The inner region is split into slices along the last axis, which are filtered concurrently
+   * without extrapolation.
+   * The bordering regions are then extrapolated and filtered concurrently.
+   */
+  template <typename TRaster, typename TMethod, typename TOut>
+  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out, const Threads& threads) const
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    static constexpr Index N = TRaster::Dimension;
+    if constexpr (Internal::HasKernelTransform<TKernel, PtrRaster<const T, N>, TOut>::value) {
+      transform_bands(in.copy(in.domain() + window_box<N>()), out, threads);
+      return;
+    }
+    if (pads_whole(in.domain())) {
+      transform_impl(in.copy(in.domain() + window_box<N>()), out, threads);
+      return;
+    }
+    const auto& raw = dont_extrapolate(in);
+    const auto bbox = Internal::BorderedBox<TRaster::Dimension>(raw.domain(), window_box<TRaster::Dimension>());
+    std::vector<Box<TRaster::Dimension>> borders;
+    bbox.apply_inner_border(
+        [&](const auto& ib) {
+          const auto insub = raw(ib);
+          if (insub.size() > 0) {
+            auto outsub = out(insub.domain());
+            transform_monolith(insub, outsub, threads);
+          }
+        },
+        [&](const auto& ib) {
+          borders.push_back(ib);
+        });
+    const Index count = borders.size();
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+    for (Index i = 0; i < count; ++i) {
+      const auto insub = in(borders[i]);
+      auto outsub = out(insub.domain());
+      transform_monolith_extrapolator(insub, outsub);
+    }
+  }
+
+  /**
+   * @brief Filter and decimate a grid- or box-based patch with multi-threading.
+   * 
+   * The grid or box is split into slices along the last axis, which are filtered concurrently.
+   * Slices of an extrapolated box whose neighborhood lies inside the raster are filtered without extrapolation.
+   * 
+   * @warning Multi-threading is not supported for other patches: the threading policy is ignored.
+   */
+  template <typename T, typename TParent, typename TRegion, typename TOut>
+  void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out, const Threads& threads) const
+  {
+    static constexpr Index N = TParent::Dimension;
+    if constexpr (std::is_same_v<TRegion, Grid<N>>) {
+      const auto& grid = in.domain();
+      const auto last = grid.dimension() - 1;
+      const auto length = grid.shape()[last];
+      const auto out_box = Linx::box(out.domain());
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+      for (Index i = 0; i < length; ++i) {
+        auto front = grid.front();
+        auto back = grid.back();
+        front[last] = back[last] = grid.front()[last] + i * grid.step()[last];
+        const Grid<N> slice(Box<N>(LINX_MOVE(front), LINX_MOVE(back)), grid.step());
+        auto out_front = out_box.front();
+        auto out_back = out_box.back();
+        out_front[last] = out_back[last] = out_box.front()[last] + i;
+        auto outsub = out(Box<N>(LINX_MOVE(out_front), LINX_MOVE(out_back)));
+        transform_grid(in.parent(), slice, outsub);
+      }
+    } else if constexpr (std::is_same_v<TRegion, Box<N>>) {
+      if constexpr (not is_extrapolator<TParent>()) {
+        transform_monolith(in, out, threads);
+      } else {
+        const auto& domain = in.domain();
+        const auto& raw = dont_extrapolate(in.parent());
+        const auto last = domain.dimension() - 1;
+        const auto length = domain.length(last);
+        const auto offset = Linx::box(out.domain()).front() - domain.front();
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+        for (Index i = 0; i < length; ++i) {
+          auto front = domain.front();
+          auto back = domain.back();
+          front[last] = back[last] = domain.front()[last] + i;
+          const Box<N> slice(LINX_MOVE(front), LINX_MOVE(back));
+          auto outsub = out(slice + offset);
+          if (slice + window_box<N>() <= raw.domain()) {
+            transform_monolith(raw(slice), outsub);
+          } else {
+            transform_monolith(in.parent()(slice), outsub);
+          }
+        }
+      }
+    } else {
+      transform_impl(in, out);
+    }
+  }
+
+  /**
+   * @brief Filter an input raster or extrapolator at given positions.
+   * 
+   * The offsets of the window positions in the raster are computed once,
+   * and the neighbors are gathered into a single buffer which is reused for all positions.
+   * Neighborhoods which do not fit in the raster domain are gathered through the extrapolator.
+   */
+  template <typename TIn, typename TPositions, typename TFunc>
+  void transform_at_impl(const TIn& in, const TPositions& positions, TFunc&& func) const
+  {
+    static constexpr Index N = std::decay_t<TIn>::Dimension;
+    const auto& raw = dont_extrapolate(in);
+    const auto& shape = raw.shape();
+    std::vector<Position<N>> window;
+    std::vector<Index> offsets;
+    for (const auto& q : m_kernel.window()) {
+      window.push_back(extend<N>(q));
+      Index offset = 0;
+      for (Index i = 0; i < N; ++i) {
+        offset += window.back()[i] * shape_stride(shape, i);
+      }
+      offsets.push_back(offset);
+    }
+    const auto inner = raw.domain() - window_box<N>();
+    std::vector<std::decay_t<typename TIn::Value>> neighbors(offsets.size());
+    auto scratch = Internal::kernel_scratch<TKernel>(neighbors);
+    const auto* data = raw.data();
+    for (const auto& p : positions) {
+      if constexpr (is_extrapolator<TIn>()) {
+        if (not inner.contains(p)) {
+          std::transform(window.begin(), window.end(), neighbors.begin(), [&](const auto& q) {
+            return in[p + q];
+          });
+          func(p, Internal::apply_kernel(m_kernel, neighbors, scratch));
+          continue;
+        }
+      }
+      const auto* center = data + raw.index(p);
+      std::transform(offsets.begin(), offsets.end(), neighbors.begin(), [&](auto o) {
+        return center[o];
+      });
+      func(p, Internal::apply_kernel(m_kernel, neighbors, scratch));
+    }
+  }
+
+private:
+
+  /**
+   * @brief Check whether an extrapolated input is better padded once as a whole.
+   * 
+   * This is the case when most output pixels depend on extrapolated values, e.g. for small inputs and large windows:
+   * a single halo is then extrapolated around the input, and the padded raster is filtered without branching.
+   */
+  template <Index N>
+  bool pads_whole(const Box<N>& domain) const
+  {
+    const auto window = window_box<N>();
+    Index inner = 1;
+    for (Index i = 0; i < domain.dimension(); ++i) {
+      inner *= std::max(Index(0), domain.length(i) - window.length(i) + 1);
+    }
+    return 2 * inner < domain.size();
+  }
+
+  /**
+   * @brief Filter and decimate a patch whose region is split into an inner region and borders.
+   */
+  template <typename T, typename TParent, typename TRegion, typename TOut>
+  void transform_patch(const Patch<T, TParent, TRegion>& in, TOut& out) const
   {
     const auto& raw = dont_extrapolate(in);
     const auto& front = in.domain().front();
@@ -164,7 +448,21 @@ protected:
         });
   }
 
-private:
+  /**
+   * @brief Filter a raster or extrapolator at the nodes of a grid only.
+   * 
+   * The neighbors are gathered with direct index arithmetic, see `transform_at_impl()`,
+   * such that decimation costs as many kernel evaluations as output pixels.
+   */
+  template <typename TIn, typename TOut>
+  void transform_grid(const TIn& in, const Grid<std::decay_t<TIn>::Dimension>& grid, TOut& out) const
+  {
+    auto it = out.begin();
+    transform_at_impl(in, grid, [&](const auto&, const auto& v) {
+      *it = v;
+      ++it;
+    });
+  }
 
   /**
    * @brief Filter a monolithic patch (no region splitting).
@@ -187,18 +485,172 @@ private:
    * then `in` must be an extrapolator.
    * If the bounding box of `in` is small enough so that no extrapolated values are required,
    * then `in` can be a raw patch.
+   * 
+   * For raster parents and box or mask windows, the window is slid as a `Stencil`,
+   * i.e. by index increments along each row; masks are traversed run by run.
    */
   template <typename TIn, typename TOut>
   void transform_monolith(const TIn& in, TOut& out) const
   {
-    // FIXME accept any region
-    auto patch = in.parent()(window_box<TIn::Dimension>());
+    using Window = typename TKernel::Window;
+    static constexpr bool IsBox = std::is_same_v<Window, Box<Window::Dimension>>;
+    static constexpr bool IsMask = std::is_same_v<Window, Mask<TIn::Dimension>>;
+    if constexpr (is_extrapolator<typename TIn::Parent>() && IsBox) {
+      auto patch = in.parent()(window_box<TIn::Dimension>());
+      auto scratch = Internal::kernel_scratch<TKernel>(patch);
+      auto out_it = out.begin();
+      for (const auto& p : in.domain()) {
+        patch >>= p;
+        *out_it = Internal::apply_kernel(m_kernel, patch, scratch);
+        ++out_it;
+        patch <<= p;
+      }
+    } else if constexpr (is_extrapolator<typename TIn::Parent>()) {
+      transform_positions(in, out);
+    } else if constexpr (not(IsBox || IsMask)) {
+      transform_offsets(in, out);
+    } else {
+      const auto& parent = in.parent();
+      const auto patch = [&]() {
+        if constexpr (IsBox) {
+          return parent(window_box<TIn::Dimension>());
+        } else {
+          return parent(m_kernel.window()); // Run-based
+        }
+      }();
+      auto stencil = patch.stencil();
+      auto scratch = Internal::kernel_scratch<TKernel>(stencil);
+      const auto origin = stencil.index();
+      auto out_it = out.begin();
+      in.domain().for_each_row([&](const auto& front, Index length) {
+        stencil.move_to(origin + parent.index(front));
+        for (Index x = 0; x < length; ++x, ++out_it, stencil += 1) {
+          *out_it = Internal::apply_kernel(m_kernel, stencil, scratch);
+        }
+      });
+    }
+  }
+
+  /**
+   * @brief Filter a patch with a non-box window, through a table of index offsets.
+   * 
+   * The offsets of the window positions in the parent raster are computed once.
+   * For each output pixel, the neighbors are gathered into a contiguous buffer which is passed to the kernel.
+   */
+  template <typename TIn, typename TOut>
+  void transform_offsets(const TIn& in, TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    const auto& parent = in.parent();
+    const auto& shape = parent.shape();
+    std::vector<Index> offsets;
+    for (const auto& q : m_kernel.window()) {
+      const auto e = extend<N>(q);
+      Index offset = 0;
+      for (Index i = 0; i < static_cast<Index>(e.size()); ++i) {
+        offset += e[i] * shape_stride(shape, i);
+      }
+      offsets.push_back(offset);
+    }
+    std::vector<std::decay_t<typename TIn::Value>> neighbors(offsets.size());
+    auto scratch = Internal::kernel_scratch<TKernel>(neighbors);
+    const auto* data = parent.data();
+    auto out_it = out.begin();
+    for (const auto& p : in.domain()) {
+      const auto* center = data + parent.index(p);
+      auto it = neighbors.begin();
+      for (auto o : offsets) {
+        *it = center[o];
+        ++it;
+      }
+      *out_it = Internal::apply_kernel(m_kernel, neighbors, scratch);
+      ++out_it;
+    }
+  }
+
+  /**
+   * @brief Filter a patch of an extrapolator with a non-box window, position by position.
+   * 
+   * The window positions are computed once, and the neighbors are read through the extrapolator,
+   * which has no data pointer for index offsets.
+   */
+  template <typename TIn, typename TOut>
+  void transform_positions(const TIn& in, TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    const auto& parent = in.parent();
+    std::vector<Position<N>> window;
+    for (const auto& q : m_kernel.window()) {
+      window.push_back(extend<N>(q));
+    }
+    std::vector<std::decay_t<typename TIn::Value>> neighbors(window.size());
+    auto scratch = Internal::kernel_scratch<TKernel>(neighbors);
     auto out_it = out.begin();
     for (const auto& p : in.domain()) {
-      patch >>= p;
-      *out_it = m_kernel(patch);
+      std::transform(window.begin(), window.end(), neighbors.begin(), [&](const auto& q) {
+        return parent[p + q];
+      });
+      *out_it = Internal::apply_kernel(m_kernel, neighbors, scratch);
       ++out_it;
-      patch <<= p;
+    }
+  }
+
+  /**
+   * @brief Filter a box-based patch by slices along the last axis, concurrently.
+   * 
+   * Each slice is processed with `transform_monolith()`.
+   */
+  template <typename TIn, typename TOut>
+  void transform_monolith(const TIn& in, TOut& out, const Threads& threads) const
+  {
+    const auto& domain = in.domain();
+    const auto last = domain.dimension() - 1;
+    const auto front = domain.front()[last];
+    const auto length = domain.length(last);
+    const auto offset = Linx::box(out.domain()).front() - domain.front();
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+    for (Index i = 0; i < length; ++i) {
+      auto slice_front = domain.front();
+      auto slice_back = domain.back();
+      slice_front[last] = slice_back[last] = front + i;
+      const Box<TIn::Dimension> slice(LINX_MOVE(slice_front), LINX_MOVE(slice_back));
+      const auto insub = in.parent()(slice);
+      auto outsub = out(slice + offset);
+      transform_monolith(insub, outsub);
+    }
+  }
+
+  /**
+   * @brief Filter and crop an input raster with the kernel's `transform()`, by bands along the last axis, concurrently.
+   * 
+   * The input bands are contiguous views which overlap according to the window.
+   */
+  template <typename T, Index N, typename THolder, typename TOut>
+  void transform_bands(const Raster<T, N, THolder>& in, TOut& out, const Threads& threads) const
+  {
+    const auto window = window_box<N>();
+    const auto last = in.dimension() - 1;
+    const auto margin = window.length(last) - 1;
+    const auto length = in.length(last) - margin;
+    if (length <= 0) {
+      return;
+    }
+    const auto stride = shape_stride(in.shape(), last);
+    const auto out_box = Linx::box(out.domain());
+    const Index count = std::min<Index>(threads.count(), length);
+#pragma omp parallel for num_threads(count)
+    for (Index i = 0; i < count; ++i) {
+      const auto front = length * i / count;
+      const auto back = length * (i + 1) / count;
+      auto in_shape = in.shape();
+      in_shape[last] = back - front + margin;
+      const PtrRaster<const T, N> in_band(in_shape, in.data() + front * stride);
+      auto out_front = out_box.front();
+      auto out_back = out_box.back();
+      out_back[last] = out_front[last] + back - 1;
+      out_front[last] += front;
+      auto out_band = out(Box<N>(LINX_MOVE(out_front), LINX_MOVE(out_back)));
+      m_kernel.transform(in_band, out_band);
     }
   }
 
@@ -210,6 +662,21 @@ private:
   TKernel m_kernel;
 };
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a filter is a `SimpleFilter`.
+ */
+template <typename TFilter>
+struct IsSimpleFilter : std::false_type {};
+
+template <typename TKernel>
+struct IsSimpleFilter<SimpleFilter<TKernel>> : std::true_type {};
+
+} // namespace Internal
+/// @endcond
+
 } // namespace Linx
 
 #endif
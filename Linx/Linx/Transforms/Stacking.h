@@ -0,0 +1,158 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STACKING_H
+#define _LINXTRANSFORMS_STACKING_H
+
+#include "Linx/Base/SigmaClipping.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // min, min_element, nth_element
+#include <limits>
+#include <type_traits> // remove_const_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Combine a stack of frames pixel by pixel, block by block.
+ * @param stack The stack, whose last axis indexes the frames
+ * @param func The reducer, which takes a pointer to the contiguous valid values of a pixel and their count,
+ * and is copied for each thread
+ * @param threads The threads
+ * @param block The number of pixels per block
+ *
+ * For each block of consecutive pixels, a panel is filled with the values of all the frames,
+ * such that the values of each pixel are contiguous.
+ * The stack is read in contiguous runs of `block` elements, and NaNs are skipped while transposing.
+ * Blocks are processed in parallel, and the memory footprint is `block` times the number of frames per thread.
+ */
+template <typename T, typename U, Index N, typename THolder, typename TFunc>
+Raster<T, N - 1> combine_stack(const Raster<U, N, THolder>& stack, TFunc func, const Threads& threads, Index block)
+{
+  static_assert(N > 1, "Stacks must have at least two dimensions.");
+  const auto shape = stack.shape();
+  const auto depth = shape[N - 1];
+  Raster<T, N - 1> out(slice<N - 1>(shape));
+  const Index plane = out.size();
+  const auto* data = stack.data();
+  auto* out_data = out.data();
+  const auto block_count = (plane + block - 1) / block;
+  std::vector<double> panel;
+  std::vector<Index> counts;
+#pragma omp parallel for num_threads(threads.count()) schedule(static) firstprivate(panel, counts, func)
+  for (Index b = 0; b < block_count; ++b) {
+    const auto front = b * block;
+    const auto width = std::min(block, plane - front);
+    panel.resize(width * depth);
+    counts.assign(width, 0);
+    for (Index f = 0; f < depth; ++f) {
+      const auto* src = data + f * plane + front;
+      for (Index p = 0; p < width; ++p) {
+        const double v = src[p];
+        auto& c = counts[p];
+        panel[p * depth + c] = v;
+        c += (v == v);
+      }
+    }
+    for (Index p = 0; p < width; ++p) {
+      out_data[front + p] = counts[p] ? T(func(panel.data() + p * depth, counts[p])) :
+                                        std::numeric_limits<T>::quiet_NaN();
+    }
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the pixelwise mean of a stack of frames.
+ * @param stack The stack, whose last axis indexes the frames
+ * @param threads The threads
+ * @param block The number of pixels processed at once by each thread
+ *
+ * NaNs are ignored, and pixels without valid values are set to NaN.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::remove_const_t<T>>::Floating, N - 1>
+stack_mean(const Raster<T, N, THolder>& stack, const Threads& threads = Threads(1), Index block = 256)
+{
+  using Floating = typename TypeTraits<std::remove_const_t<T>>::Floating;
+  return Internal::combine_stack<Floating>(
+      stack,
+      [](double* values, Index count) {
+        double sum = 0;
+        for (Index i = 0; i < count; ++i) {
+          sum += values[i];
+        }
+        return sum / count;
+      },
+      threads,
+      block);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the pixelwise median of a stack of frames.
+ * @copydetails stack_mean()
+ *
+ * The median of an even number of values is the mean of the two central values.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::remove_const_t<T>>::Floating, N - 1>
+stack_median(const Raster<T, N, THolder>& stack, const Threads& threads = Threads(1), Index block = 256)
+{
+  using Floating = typename TypeTraits<std::remove_const_t<T>>::Floating;
+  return Internal::combine_stack<Floating>(
+      stack,
+      [](double* values, Index count) {
+        auto* middle = values + (count - 1) / 2;
+        std::nth_element(values, middle, values + count);
+        return count % 2 ? *middle : .5 * (*middle + *std::min_element(middle + 1, values + count));
+      },
+      threads,
+      block);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the pixelwise sigma-clipped mean of a stack of frames, e.g. to build master darks or flats.
+ * @param stack The stack, whose last axis indexes the frames
+ * @param k The rejection threshold, in number of standard deviations around the median
+ * @param iterations The maximum number of clipping iterations
+ * @param threads The threads
+ * @param block The number of pixels processed at once by each thread
+ *
+ * The values of each pixel are clipped with `SigmaClipping`, e.g. to reject cosmic rays,
+ * and the mean of the survivors is returned.
+ * NaNs are ignored, and pixels without valid values are set to NaN.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::remove_const_t<T>>::Floating, N - 1> stack_clipped_mean(
+    const Raster<T, N, THolder>& stack,
+    double k = 3,
+    Index iterations = 5,
+    const Threads& threads = Threads(1),
+    Index block = 256)
+{
+  using Floating = typename TypeTraits<std::remove_const_t<T>>::Floating;
+  SigmaClipping<double> clipping(k, iterations);
+  return Internal::combine_stack<Floating>(
+      stack,
+      [clipping](double* values, Index count) mutable {
+        return clipping.clip_inplace(values, values + count).mean();
+      },
+      threads,
+      block);
+}
+
+} // namespace Linx
+
+#endif
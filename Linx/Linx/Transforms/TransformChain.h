@@ -0,0 +1,486 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_TRANSFORMCHAIN_H
+#define _LINXTRANSFORMS_TRANSFORMCHAIN_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Interpolation.h"
+#include "Linx/Transforms/mixins/Filter.h"
+
+#include <algorithm> // copy, max, min, transform
+#include <cmath> // ceil, floor
+#include <limits>
+#include <type_traits> // decay_t, false_type, invoke_result_t, is_same_v, remove_const_t, true_type
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The first node of a transform chain, which materializes regions of an extrapolated raster.
+ */
+template <typename TIn>
+class ChainSource {
+public:
+
+  using Value = std::remove_const_t<typename TIn::Value>;
+  static constexpr Index Dimension = TIn::Dimension;
+
+  explicit ChainSource(const TIn& in) : m_in(in) {}
+
+  Position<Dimension> shape() const
+  {
+    return m_in.shape();
+  }
+
+  Box<Dimension> source_region(const Box<Dimension>& region) const
+  {
+    return region;
+  }
+
+  Raster<Value, Dimension> evaluate(const Box<Dimension>& region) const
+  {
+    return m_in.copy(region);
+  }
+
+private:
+
+  TIn m_in;
+};
+
+/**
+ * @brief A filtering node, whose input region is the output region extended by the filter window.
+ */
+template <typename TParent, typename TFilter>
+class ChainFilter {
+public:
+
+  using Value = typename TFilter::Value;
+  static constexpr Index Dimension = TParent::Dimension;
+
+  ChainFilter(TParent parent, TFilter filter) : m_parent(LINX_MOVE(parent)), m_filter(LINX_MOVE(filter)) {}
+
+  Position<Dimension> shape() const
+  {
+    return m_parent.shape();
+  }
+
+  Box<Dimension> source_region(const Box<Dimension>& region) const
+  {
+    return m_parent.source_region(halo(region));
+  }
+
+  Raster<Value, Dimension> evaluate(const Box<Dimension>& region) const
+  {
+    const auto in = m_parent.evaluate(halo(region));
+    Raster<Value, Dimension> out(region.shape());
+    m_filter.transform(in, out); // Cropped, since the input is not extrapolated
+    return out;
+  }
+
+private:
+
+  Box<Dimension> halo(const Box<Dimension>& region) const
+  {
+    return region + box(m_filter.window());
+  }
+
+  TParent m_parent;
+  TFilter m_filter;
+};
+
+/**
+ * @brief A pixel-wise node, which is applied in place to the tile of its parent whenever possible.
+ */
+template <typename TParent, typename TFunc>
+class ChainPixelwise {
+public:
+
+  using Value = std::decay_t<std::invoke_result_t<const TFunc&, const typename TParent::Value&>>;
+  static constexpr Index Dimension = TParent::Dimension;
+
+  ChainPixelwise(TParent parent, TFunc func) : m_parent(LINX_MOVE(parent)), m_func(LINX_MOVE(func)) {}
+
+  const TParent& parent() const
+  {
+    return m_parent;
+  }
+
+  const TFunc& function() const
+  {
+    return m_func;
+  }
+
+  Position<Dimension> shape() const
+  {
+    return m_parent.shape();
+  }
+
+  Box<Dimension> source_region(const Box<Dimension>& region) const
+  {
+    return m_parent.source_region(region);
+  }
+
+  Raster<Value, Dimension> evaluate(const Box<Dimension>& region) const
+  {
+    auto in = m_parent.evaluate(region);
+    if constexpr (std::is_same_v<Value, typename TParent::Value>) {
+      for (auto& e : in) {
+        e = m_func(e);
+      }
+      return in;
+    } else {
+      Raster<Value, Dimension> out(region.shape());
+      std::transform(in.begin(), in.end(), out.begin(), m_func);
+      return out;
+    }
+  }
+
+private:
+
+  TParent m_parent;
+  TFunc m_func;
+};
+
+/**
+ * @brief Check whether a chain node is pixel-wise, i.e. can be fused with a subsequent pixel-wise node.
+ */
+template <typename TNode>
+struct IsChainPixelwise : std::false_type {};
+
+template <typename TParent, typename TFunc>
+struct IsChainPixelwise<ChainPixelwise<TParent, TFunc>> : std::true_type {};
+
+/**
+ * @brief A resampling node, whose input region is the bounding box of the inverse-transformed output region.
+ */
+template <typename TParent, typename TMethod>
+class ChainWarp {
+public:
+
+  using Value = typename TParent::Value;
+  static constexpr Index Dimension = TParent::Dimension;
+
+  ChainWarp(TParent parent, const Affinity<Dimension>& affinity, Position<Dimension> shape) :
+      m_parent(LINX_MOVE(parent)), m_inverse(inverse(affinity)), m_shape(LINX_MOVE(shape))
+  {}
+
+  Position<Dimension> shape() const
+  {
+    return m_shape;
+  }
+
+  Box<Dimension> source_region(const Box<Dimension>& region) const
+  {
+    return m_parent.source_region(support(region));
+  }
+
+  Raster<Value, Dimension> evaluate(const Box<Dimension>& region) const
+  {
+    const auto src = support(region);
+    const auto in = m_parent.evaluate(src);
+    const auto extrapolator = extrapolation<Nearest>(in); // Referenced by the interpolator
+    const auto interpolator = interpolation<TMethod>(extrapolator);
+    Raster<Value, Dimension> out(region.shape());
+    auto it = out.begin();
+    for (const auto& q : region) {
+      auto p = m_inverse(q);
+      for (Index i = 0; i < Dimension; ++i) {
+        p[i] -= src.front()[i];
+      }
+      *it = interpolator(p);
+      ++it;
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Compute the bounding box of the inverse-transformed corners, extended by the interpolation taps.
+   */
+  Box<Dimension> support(const Box<Dimension>& region) const
+  {
+    constexpr Index taps = TMethod::Taps;
+    const auto& front = region.front();
+    const auto& back = region.back();
+    Vector<double, Dimension> min;
+    Vector<double, Dimension> max;
+    min.fill(std::numeric_limits<double>::infinity());
+    max.fill(-std::numeric_limits<double>::infinity());
+    for (Index k = 0; k < (Index(1) << Dimension); ++k) {
+      Position<Dimension> corner;
+      for (Index i = 0; i < Dimension; ++i) {
+        corner[i] = (k >> i) & 1 ? back[i] : front[i];
+      }
+      const auto p = m_inverse(corner);
+      for (Index i = 0; i < Dimension; ++i) {
+        min[i] = std::min(min[i], p[i]);
+        max[i] = std::max(max[i], p[i]);
+      }
+    }
+    Position<Dimension> src_front;
+    Position<Dimension> src_back;
+    for (Index i = 0; i < Dimension; ++i) {
+      src_front[i] = static_cast<Index>(std::floor(min[i])) - taps;
+      src_back[i] = static_cast<Index>(std::ceil(max[i])) + taps;
+    }
+    return Box<Dimension>(src_front, src_back);
+  }
+
+  TParent m_parent;
+  Affinity<Dimension> m_inverse;
+  Position<Dimension> m_shape;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief A lazy chain of filters, warps and pixel-wise operations, evaluated tile by tile.
+ * @tparam TNode The last operation of the chain
+ *
+ * Eager expressions like `filter2 * extrapolation(filter1 * extrapolation(in))` materialize
+ * one full raster per step, which is read back from memory by the next step.
+ * Chains record the operations instead, and evaluate them at once when `raster()` or `transform()` is called:
+ *
+ * \code
+ * const auto out = (filter2 * (filter1 * chain(extrapolation(in)))).warp<Linear>(affinity, shape) * gain;
+ * const auto raster = out.raster(Threads(4));
+ * \endcode
+ *
+ * The output domain is split into tiles (slabs along the last axis) which fit in cache,
+ * and which are evaluated concurrently.
+ * For each tile, the region required by each step is computed backward (the halo),
+ * from the filter windows and from the bounding boxes of the inverse warps,
+ * such that each step only computes what the next steps need, and the input is extrapolated once.
+ * Consecutive pixel-wise operations are fused into a single function,
+ * and pixel-wise operations are applied in place to the tile of the previous step.
+ *
+ * Like `FilterSeq`, the chain extrapolates the input only:
+ * intermediate values which lie outside the domain are computed from the extrapolated input
+ * instead of being extrapolated themselves.
+ * The values therefore differ from the eager expression near the borders only,
+ * within the cumulated halo of the filters.
+ *
+ * Steps are copied into the chain, while the input raster is referenced by the extrapolator,
+ * and must outlive the chain.
+ */
+template <typename TNode>
+class TransformChain {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = typename TNode::Value;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = TNode::Dimension;
+
+  static_assert(Dimension >= 0, "TransformChain does not support variable dimension.");
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit TransformChain(TNode node) : m_node(LINX_MOVE(node)) {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the output shape.
+   */
+  Position<Dimension> shape() const
+  {
+    return m_node.shape();
+  }
+
+  /**
+   * @brief Get the output domain.
+   */
+  Box<Dimension> domain() const
+  {
+    return Box<Dimension>::from_shape(shape());
+  }
+
+  /**
+   * @brief Get the region of the input which is required to compute a given region of the output.
+   */
+  Box<Dimension> source_region(const Box<Dimension>& region) const
+  {
+    return m_node.source_region(region);
+  }
+
+  /**
+   * @brief Get the last operation.
+   */
+  const TNode& node() const
+  {
+    return m_node;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Append a filter.
+   * @see `operator*(const FilterMixin&, const TransformChain&)`
+   */
+  template <typename TFilter>
+  TransformChain<Internal::ChainFilter<TNode, TFilter>> filter(TFilter step) const
+  {
+    return TransformChain<Internal::ChainFilter<TNode, TFilter>>({m_node, LINX_MOVE(step)});
+  }
+
+  /**
+   * @brief Append an affine transform.
+   * @tparam TMethod The interpolation method
+   * @param affinity The transform
+   * @param shape The output shape
+   */
+  template <typename TMethod>
+  TransformChain<Internal::ChainWarp<TNode, TMethod>>
+  warp(const Affinity<Dimension>& affinity, Position<Dimension> shape) const
+  {
+    return TransformChain<Internal::ChainWarp<TNode, TMethod>>({m_node, affinity, LINX_MOVE(shape)});
+  }
+
+  /**
+   * @brief Append a pixel-wise function, which is fused with the previous operation if it is pixel-wise, too.
+   */
+  template <typename TFunc>
+  auto apply(TFunc&& func) const
+  {
+    if constexpr (Internal::IsChainPixelwise<TNode>::value) {
+      auto fused = [f = m_node.function(), g = LINX_FORWARD(func)](const auto& e) {
+        return g(f(e));
+      };
+      using Fused = Internal::ChainPixelwise<std::decay_t<decltype(m_node.parent())>, decltype(fused)>;
+      return TransformChain<Fused>(Fused(m_node.parent(), LINX_MOVE(fused)));
+    } else {
+      using Pixelwise = Internal::ChainPixelwise<TNode, std::decay_t<TFunc>>;
+      return TransformChain<Pixelwise>(Pixelwise(m_node, LINX_FORWARD(func)));
+    }
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Evaluate the chain over a region of the output, which may lie outside the domain, into a new raster.
+   */
+  Raster<Value, Dimension> copy(const Box<Dimension>& region) const
+  {
+    return m_node.evaluate(region);
+  }
+
+  /**
+   * @brief Evaluate the chain into a given raster.
+   * @param out The output raster, of shape `shape()`
+   * @param threads The threads, among which the tiles are distributed
+   */
+  template <typename T, typename THolder>
+  Raster<T, Dimension, THolder>& transform(Raster<T, Dimension, THolder>& out, const Threads& threads = Threads(1))
+      const
+  {
+    constexpr Index last = Dimension - 1;
+    const auto domain = this->domain();
+    if (out.shape() != domain.shape()) {
+      throw Exception("Output shape differs from the chain shape");
+    }
+    if (out.size() == 0) {
+      return out;
+    }
+    const Index length = domain.length(last);
+    const Index count = std::max(1, threads.count());
+    const Index section_size = out.size() / length;
+    Index thickness = std::max<Index>(1, (Index(1) << 16) / section_size);
+    thickness = std::min(thickness, (length + count - 1) / count);
+    const Index tile_count = (length + thickness - 1) / thickness;
+
+#pragma omp parallel for num_threads(count) schedule(dynamic)
+    for (Index t = 0; t < tile_count; ++t) {
+      auto front = domain.front();
+      auto back = domain.back();
+      front[last] = t * thickness;
+      back[last] = std::min(front[last] + thickness, length) - 1;
+      const auto tile = copy(Box<Dimension>(front, back));
+      std::copy(tile.begin(), tile.end(), &out[front]);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Evaluate the chain into a new raster.
+   */
+  Raster<Value, Dimension> raster(const Threads& threads = Threads(1)) const
+  {
+    Raster<Value, Dimension> out(shape());
+    return transform(out, threads);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The last operation.
+   */
+  TNode m_node;
+};
+
+/**
+ * @relatesalso TransformChain
+ * @brief Start a chain from an extrapolated raster, or from any input with `copy(const Box&)`, e.g. a `LazyRaster`.
+ */
+template <typename TIn>
+TransformChain<Internal::ChainSource<TIn>> chain(const TIn& in)
+{
+  return TransformChain<Internal::ChainSource<TIn>>(Internal::ChainSource<TIn>(in));
+}
+
+/**
+ * @relatesalso TransformChain
+ * @brief Append a filter to a chain.
+ *
+ * This mirrors the eager syntax: `filter * chain(extrapolation(in))` is lazy,
+ * while `filter * extrapolation(in)` is not.
+ */
+template <typename T, typename TWindow, typename TDerived, typename TNode>
+auto operator*(const FilterMixin<T, TWindow, TDerived>& filter, const TransformChain<TNode>& in)
+{
+  return in.filter(static_cast<const TDerived&>(filter));
+}
+
+#define LINX_CHAIN_OPERATOR(op) \
+  /** @relatesalso TransformChain @brief Append a pixel-wise operation with a scalar, of the chain value type. */ \
+  template <typename TNode, typename U, typename = std::enable_if_t<std::is_arithmetic_v<U>>> \
+  auto operator op(const TransformChain<TNode>& lhs, U rhs) \
+  { \
+    return lhs.apply([rhs](const auto& e) { \
+      return static_cast<std::decay_t<decltype(e)>>(e op rhs); \
+    }); \
+  }
+
+LINX_CHAIN_OPERATOR(+)
+LINX_CHAIN_OPERATOR(-)
+LINX_CHAIN_OPERATOR(*)
+LINX_CHAIN_OPERATOR(/)
+
+#undef LINX_CHAIN_OPERATOR
+
+} // namespace Linx
+
+#endif
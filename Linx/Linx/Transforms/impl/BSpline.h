@@ -0,0 +1,328 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_BSPLINE_H
+#define _LINXTRANSFORMS_IMPL_BSPLINE_H
+
+#include "Linx/Base/Threads.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/ResamplingMethods.h" // Reflect
+
+#include <algorithm> // max
+#include <array>
+#include <cmath> // abs, ceil, log, pow, sqrt
+#include <type_traits> // conditional_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the initial causal coefficient of a B-spline prefilter line, with mirror boundary conditions.
+ */
+inline double bspline_causal_init(const double* line, Index length, double pole)
+{
+  constexpr double tolerance = 1.e-12;
+  const auto horizon = static_cast<Index>(std::ceil(std::log(tolerance) / std::log(std::abs(pole))));
+  if (horizon < length) {
+    double zn = pole;
+    double sum = line[0];
+    for (Index k = 1; k < horizon; ++k) {
+      sum += zn * line[k];
+      zn *= pole;
+    }
+    return sum;
+  }
+  double zn = pole;
+  const auto iz = 1. / pole;
+  double z2n = std::pow(pole, double(length - 1));
+  double sum = line[0] + z2n * line[length - 1];
+  z2n *= z2n * iz;
+  for (Index k = 1; k < length - 1; ++k) {
+    sum += (zn + z2n) * line[k];
+    zn *= pole;
+    z2n *= iz;
+  }
+  return sum / (1. - zn * zn);
+}
+
+/**
+ * @brief Apply the B-spline prefilter to a contiguous line, in place.
+ */
+template <std::size_t P>
+void bspline_prefilter(double* line, Index length, const std::array<double, P>& poles)
+{
+  if (length <= 1) {
+    return;
+  }
+  double gain = 1;
+  for (auto z : poles) {
+    gain *= (1. - z) * (1. - 1. / z);
+  }
+  for (Index k = 0; k < length; ++k) {
+    line[k] *= gain;
+  }
+  for (auto z : poles) {
+    line[0] = bspline_causal_init(line, length, z);
+    for (Index k = 1; k < length; ++k) {
+      line[k] += z * line[k - 1];
+    }
+    line[length - 1] = (z / (z * z - 1.)) * (z * line[length - 2] + line[length - 1]);
+    for (Index k = length - 2; k >= 0; --k) {
+      line[k] = z * (line[k + 1] - line[k]);
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup resampling
+ * @brief B-spline interpolation of given order, with cached prefiltered coefficients.
+ * @tparam Order The spline order, from 1 (linear) to 5
+ *
+ * B-spline interpolation of order greater than 1 does not interpolate the samples themselves,
+ * but coefficients which are obtained by a recursive (IIR) prefilter over the whole raster.
+ * The prefilter is separable, and is applied line by line along each axis, in parallel.
+ *
+ * The coefficients are computed once, when the interpolator is created, and cached in the method,
+ * such that subsequent interpolations only cost `(Order + 1)^N` multiply-adds,
+ * e.g. to shift the same image by many subpixel offsets:
+ *
+ * \code
+ * const auto spline = interpolation<BSpline<3>>(in, Threads(8)); // Prefiltering
+ * for (const auto& offset : offsets) {
+ *   const auto shifted = Affinity<2>::translation(offset).transform(spline, out); // Cheap
+ *   ...
+ * }
+ * \endcode
+ *
+ * Boundary conditions are those of `Reflect`, such that positions outside the domain
+ * can be interpolated without extrapolator, and the values are real.
+ */
+template <Index Order>
+class BSpline {
+  static_assert(Order >= 1 && Order <= 5, "Only B-spline orders from 1 to 5 are supported.");
+
+public:
+
+  /**
+   * @brief The number of coefficients involved in 1D interpolation.
+   */
+  static constexpr Index Support = Order + 1;
+
+  /**
+   * @brief Constructor.
+   * @param threads The threads used for prefiltering
+   */
+  explicit BSpline(const Threads& threads = Threads(1)) :
+      m_threads(threads), m_shape(), m_strides(), m_coefficients()
+  {}
+
+  /**
+   * @brief Compute the 1D B-spline basis weights at given coordinate.
+   * @return The coordinate of the first coefficient
+   */
+  static Index basis(double coordinate, double* out)
+  {
+    if constexpr (Order == 1) {
+      const auto f = floor<Index>(coordinate);
+      const auto w = coordinate - f;
+      out[0] = 1. - w;
+      out[1] = w;
+      return f;
+    } else if constexpr (Order == 2) {
+      const auto f = floor<Index>(coordinate + .5);
+      const auto w = coordinate - f;
+      out[1] = 3. / 4. - w * w;
+      out[2] = .5 * (w - out[1] + 1.);
+      out[0] = 1. - out[1] - out[2];
+      return f - 1;
+    } else if constexpr (Order == 3) {
+      const auto f = floor<Index>(coordinate);
+      const auto w = coordinate - f;
+      out[3] = (1. / 6.) * w * w * w;
+      out[0] = (1. / 6.) + .5 * w * (w - 1.) - out[3];
+      out[2] = w + out[0] - 2. * out[3];
+      out[1] = 1. - out[0] - out[2] - out[3];
+      return f - 1;
+    } else if constexpr (Order == 4) {
+      const auto f = floor<Index>(coordinate + .5);
+      const auto w = coordinate - f;
+      const auto w2 = w * w;
+      const auto t = (1. / 6.) * w2;
+      out[0] = .5 - w;
+      out[0] *= out[0];
+      out[0] *= (1. / 24.) * out[0];
+      const auto t0 = w * (t - 11. / 24.);
+      const auto t1 = 19. / 96. + w2 * (.25 - t);
+      out[1] = t1 + t0;
+      out[3] = t1 - t0;
+      out[4] = out[0] + t0 + .5 * w;
+      out[2] = 1. - out[0] - out[1] - out[3] - out[4];
+      return f - 2;
+    } else {
+      const auto f = floor<Index>(coordinate);
+      auto w = coordinate - f;
+      auto w2 = w * w;
+      out[5] = (1. / 120.) * w * w2 * w2;
+      w2 -= w;
+      const auto w4 = w2 * w2;
+      w -= .5;
+      const auto t = w2 * (w2 - 3.);
+      out[0] = (1. / 24.) * (1. / 5. + w2 + w4) - out[5];
+      auto t0 = (1. / 24.) * (w2 * (w2 - 5.) + 46. / 5.);
+      auto t1 = (-1. / 12.) * w * (t + 4.);
+      out[2] = t0 + t1;
+      out[3] = t0 - t1;
+      t0 = (1. / 16.) * (9. / 5. - t);
+      t1 = (1. / 24.) * w * (w4 - w2 - 5.);
+      out[1] = t0 + t1;
+      out[4] = t0 - t1;
+      return f - 2;
+    }
+  }
+
+  /**
+   * @brief Compute and cache the coefficients of some raster or extrapolator.
+   *
+   * This is called once by the constructor of `Interpolation`.
+   */
+  template <typename TParent>
+  void prepare(const TParent& parent)
+  {
+    const auto domain = parent.domain();
+    const auto dimension = domain.dimension();
+    const auto shape = domain.shape();
+    m_shape.assign(shape.begin(), shape.end());
+    m_strides.resize(dimension);
+    Index stride = 1;
+    for (Index i = 0; i < dimension; ++i) {
+      m_strides[i] = stride;
+      stride *= m_shape[i];
+    }
+    m_coefficients.resize(domain.size());
+    auto it = m_coefficients.begin();
+    for (const auto& p : domain) {
+      *it = parent[p];
+      ++it;
+    }
+    const auto size = static_cast<Index>(m_coefficients.size());
+    if constexpr (Order > 1) {
+      for (Index i = 0; i < dimension && size > 0; ++i) {
+        const auto length = m_shape[i];
+        const auto inner = m_strides[i];
+        const auto count = size / length;
+        auto* data = m_coefficients.data();
+#pragma omp parallel for num_threads(m_threads.count()) schedule(static)
+        for (Index l = 0; l < count; ++l) {
+          std::vector<double> line(length);
+          auto* front = data + (l / inner) * inner * length + l % inner;
+          for (Index k = 0; k < length; ++k) {
+            line[k] = front[k * inner];
+          }
+          Internal::bspline_prefilter(line.data(), length, poles());
+          for (Index k = 0; k < length; ++k) {
+            front[k * inner] = line[k];
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Get the cached coefficients, in raster order.
+   */
+  const std::vector<double>& coefficients() const
+  {
+    return m_coefficients;
+  }
+
+  /**
+   * @brief Return the interpolated value at given position.
+   *
+   * The parent is ignored, since the coefficients are cached.
+   */
+  template <typename T, typename TParent, Index N>
+  T at(const TParent&, const Vector<double, N>& position) const
+  {
+    const Index dimension = position.size();
+    std::conditional_t<(N > 0), std::array<double, std::max<Index>(N, 1) * Support>, std::vector<double>> weights;
+    std::conditional_t<(N > 0), std::array<Index, std::max<Index>(N, 1) * Support>, std::vector<Index>> offsets;
+    if constexpr (N <= 0) {
+      weights.resize(dimension * Support);
+      offsets.resize(dimension * Support);
+    }
+    for (Index i = 0; i < dimension; ++i) {
+      const auto front = basis(position[i], &weights[i * Support]);
+      for (Index k = 0; k < Support; ++k) {
+        offsets[i * Support + k] = Reflect::index(front + k, m_shape[i]) * m_strides[i];
+      }
+    }
+    return accumulate(dimension - 1, 0, weights.data(), offsets.data());
+  }
+
+private:
+
+  /**
+   * @brief Get the poles of the prefilter.
+   */
+  static auto poles()
+  {
+    if constexpr (Order == 2) {
+      return std::array<double, 1> {std::sqrt(8.) - 3.};
+    } else if constexpr (Order == 3) {
+      return std::array<double, 1> {std::sqrt(3.) - 2.};
+    } else if constexpr (Order == 4) {
+      return std::array<double, 2> {
+          std::sqrt(664. - std::sqrt(438976.)) + std::sqrt(304.) - 19.,
+          std::sqrt(664. + std::sqrt(438976.)) - std::sqrt(304.) - 19.};
+    } else {
+      return std::array<double, 2> {
+          std::sqrt(135. / 2. - std::sqrt(17745. / 4.)) + std::sqrt(105. / 4.) - 13. / 2.,
+          std::sqrt(135. / 2. + std::sqrt(17745. / 4.)) - std::sqrt(105. / 4.) - 13. / 2.};
+    }
+  }
+
+  /**
+   * @brief Recursively accumulate the weighted coefficients, from the last axis.
+   */
+  double accumulate(Index axis, Index base, const double* weights, const Index* offsets) const
+  {
+    const auto* w = weights + axis * Support;
+    const auto* o = offsets + axis * Support;
+    double out = 0;
+    for (Index k = 0; k < Support; ++k) {
+      out += w[k] * (axis == 0 ? m_coefficients[base + o[k]] : accumulate(axis - 1, base + o[k], weights, offsets));
+    }
+    return out;
+  }
+
+  /**
+   * @brief The prefiltering threads.
+   */
+  Threads m_threads;
+
+  /**
+   * @brief The shape of the coefficient raster.
+   */
+  std::vector<Index> m_shape;
+
+  /**
+   * @brief The strides of the coefficient raster.
+   */
+  std::vector<Index> m_strides;
+
+  /**
+   * @brief The coefficients.
+   */
+  std::vector<double> m_coefficients;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,303 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_LINEPASSES_H
+#define _LINXTRANSFORMS_IMPL_LINEPASSES_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Mask.h"
+#include "Linx/Data/Vector.h"
+
+#include <algorithm> // copy, max, min
+#include <map>
+#include <numeric> // inner_product
+#include <type_traits> // enable_if_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the output shape of a cropping line pass.
+ * @param shape The input shape
+ * @param axis The pass axis
+ * @param length The window length along the axis
+ */
+template <Index N>
+Position<N> line_pass_shape(const Position<N>& shape, Index axis, Index length)
+{
+  auto out = shape;
+  out[axis] = std::max(Index(0), shape[axis] - length + 1);
+  return out;
+}
+
+/**
+ * @brief Compute the sums of the values of a sliding 1D window along some axis.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param axis The axis
+ * @param length The window length
+ * @param out The output buffer, resized as needed
+ * @return The output shape, which is cropped along `axis`
+ * 
+ * Running sums are used, such that the cost per pixel does not depend on `length`.
+ * Along axis 0, sums are updated pixel-wise;
+ * along other axes, sums are updated row-wise, such that inner loops are contiguous.
+ */
+template <typename T, Index N>
+Position<N> running_sum(const T* in, const Position<N>& shape, Index axis, Index length, std::vector<T>& out)
+{
+  const auto out_shape = line_pass_shape(shape, axis, length);
+  out.resize(shape_size(out_shape));
+  const auto stride = shape_stride(shape, axis);
+  const auto in_length = shape[axis];
+  const auto out_length = out_shape[axis];
+  const auto block = out_length * stride;
+  const Index outer_count = block > 0 ? out.size() / block : 0;
+
+  if (axis == 0) {
+    for (Index o = 0; o < outer_count; ++o) {
+      const auto* src = in + o * in_length;
+      auto* dst = out.data() + o * out_length;
+      T sum {};
+      for (Index j = 0; j < length; ++j) {
+        sum += src[j];
+      }
+      dst[0] = sum;
+      for (Index x = 1; x < out_length; ++x) {
+        sum += src[x + length - 1] - src[x - 1];
+        dst[x] = sum;
+      }
+    }
+    return out_shape;
+  }
+
+  for (Index o = 0; o < outer_count; ++o) {
+    const auto* src = in + o * in_length * stride;
+    auto* dst = out.data() + o * block;
+    std::fill(dst, dst + stride, T {});
+    for (Index j = 0; j < length; ++j) {
+      const auto* row = src + j * stride;
+      for (Index x = 0; x < stride; ++x) {
+        dst[x] += row[x];
+      }
+    }
+    for (Index y = 1; y < out_length; ++y) {
+      const auto* prev = dst + (y - 1) * stride;
+      const auto* leaving = src + (y - 1) * stride;
+      const auto* entering = src + (y + length - 1) * stride;
+      auto* current = dst + y * stride;
+      for (Index x = 0; x < stride; ++x) {
+        current[x] = prev[x] + entering[x] - leaving[x];
+      }
+    }
+  }
+  return out_shape;
+}
+
+/**
+ * @brief Compute the extrema of the values of a sliding 1D window along some axis.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param axis The axis
+ * @param length The window length
+ * @param out The output buffer, resized as needed
+ * @param op The binary extremum operator, e.g. min or max
+ * @return The output shape, which is cropped along `axis`
+ * 
+ * The van Herk/Gil-Werman algorithm is used:
+ * lines are split into blocks of `length` values, in which prefix and suffix extrema are computed,
+ * such that each output value is the extremum of one suffix and one prefix.
+ * The number of comparisons per pixel does therefore not depend on `length`.
+ */
+template <typename T, typename U, Index N, typename TOp>
+Position<N>
+running_extremum(const U* in, const Position<N>& shape, Index axis, Index length, std::vector<T>& out, TOp&& op)
+{
+  const auto out_shape = line_pass_shape(shape, axis, length);
+  out.resize(shape_size(out_shape));
+  const auto stride = shape_stride(shape, axis);
+  const auto in_length = shape[axis];
+  const auto out_length = out_shape[axis];
+  const auto block = out_length * stride;
+  const Index outer_count = block > 0 ? out.size() / block : 0;
+  if (outer_count == 0) {
+    return out_shape;
+  }
+
+  std::vector<T> prefix(in_length * stride);
+  std::vector<T> suffix(in_length * stride);
+  for (Index o = 0; o < outer_count; ++o) {
+    const auto* src = in + o * in_length * stride;
+    auto* dst = out.data() + o * block;
+    for (Index b = 0; b < in_length; b += length) {
+      const auto e = std::min(b + length, in_length);
+      std::copy(src + b * stride, src + (b + 1) * stride, prefix.data() + b * stride);
+      for (Index y = b + 1; y < e; ++y) {
+        for (Index x = 0; x < stride; ++x) {
+          prefix[y * stride + x] = op(prefix[(y - 1) * stride + x], T(src[y * stride + x]));
+        }
+      }
+      std::copy(src + (e - 1) * stride, src + e * stride, suffix.data() + (e - 1) * stride);
+      for (Index y = e - 2; y >= b; --y) {
+        for (Index x = 0; x < stride; ++x) {
+          suffix[y * stride + x] = op(suffix[(y + 1) * stride + x], T(src[y * stride + x]));
+        }
+      }
+    }
+    for (Index y = 0; y < out_length; ++y) {
+      const auto* s = suffix.data() + y * stride;
+      const auto* p = prefix.data() + (y + length - 1) * stride;
+      auto* d = dst + y * stride;
+      for (Index x = 0; x < stride; ++x) {
+        d[x] = op(s[x], p[x]);
+      }
+    }
+  }
+  return out_shape;
+}
+
+/**
+ * @brief Compute the extrema of the values of a sliding box.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param window The window
+ * @param out The output buffer, resized as needed
+ * @param op The binary extremum operator
+ * @return The output shape, which is cropped by the window
+ * 
+ * One van Herk/Gil-Werman pass is run along each axis where the window length is greater than one.
+ */
+template <typename T, typename U, Index M, Index N, typename TOp>
+Position<M> window_extremum(const U* in, const Position<M>& shape, const Box<N>& window, std::vector<T>& out, TOp&& op)
+{
+  const auto extended = extend<M>(window);
+  auto out_shape = shape;
+  std::vector<T> current(in, in + shape_size(shape));
+  for (Index i = 0; i < extended.dimension(); ++i) {
+    const auto length = extended.length(i);
+    if (length > 1) {
+      out_shape = running_extremum(current.data(), out_shape, i, length, out, op);
+      std::swap(current, out);
+    }
+  }
+  std::swap(current, out);
+  return out_shape;
+}
+
+/**
+ * @brief Decompose a mask into segments along axis 0.
+ * @return The map from segment lengths to the segment positions relative to the mask front
+ */
+template <Index N>
+std::map<Index, std::vector<Position<N>>> mask_segments(const Mask<N>& window)
+{
+  std::map<Index, std::vector<Position<N>>> out;
+  for (const auto& r : window.runs()) {
+    out[r.length].push_back(r.front);
+  }
+  return out;
+}
+
+/**
+ * @brief Compute the extrema of the values of a sliding mask.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param window The window
+ * @param out The output buffer, resized as needed
+ * @param op The binary extremum operator
+ * @return The output shape, which is cropped by the window bounding box
+ * 
+ * The mask is decomposed into segments along axis 0.
+ * For each segment length, a van Herk/Gil-Werman pass is run,
+ * and its result is merged into the output at the offset of each segment of this length.
+ * For a 2D ball of radius `r`, this results in `O(r)` comparisons per pixel instead of `O(r^2)`.
+ */
+template <typename T, typename U, Index N, typename TOp>
+Position<N> window_extremum(const U* in, const Position<N>& shape, const Mask<N>& window, std::vector<T>& out, TOp&& op)
+{
+  auto out_shape = shape;
+  for (Index i = 0; i < static_cast<Index>(out_shape.size()); ++i) {
+    out_shape[i] = std::max(Index(0), shape[i] - window.length(i) + 1);
+  }
+  out.resize(shape_size(out_shape));
+  const Index width = out_shape[0];
+  const Index row_count = width > 0 ? out.size() / width : 0;
+  if (row_count == 0) {
+    return out_shape;
+  }
+
+  auto rows_shape = out_shape;
+  rows_shape[0] = 1;
+  const auto rows = Box<N>::from_shape(rows_shape);
+  std::vector<T> line;
+  bool first = true;
+  for (const auto& segments : mask_segments(window)) {
+    const auto line_shape = running_extremum(in, shape, 0, segments.first, line, op);
+    std::vector<Index> strides(line_shape.size());
+    for (std::size_t i = 0; i < strides.size(); ++i) {
+      strides[i] = shape_stride(line_shape, i);
+    }
+    for (const auto& start : segments.second) {
+      auto* dst = out.data();
+      for (const auto& r : rows) {
+        const auto p = r + start;
+        const auto* src = line.data() + std::inner_product(p.begin(), p.end(), strides.begin(), Index(0));
+        if (first) {
+          std::copy(src, src + width, dst);
+        } else {
+          for (Index x = 0; x < width; ++x) {
+            dst[x] = op(dst[x], src[x]);
+          }
+        }
+        dst += width;
+      }
+      first = false;
+    }
+  }
+  return out_shape;
+}
+
+/**
+ * @brief Compute the extrema of the values of a sliding mask of lower dimension than the input.
+ * 
+ * The mask is extended with unit lengths, such that each section of the input is processed independently.
+ */
+template <typename T, typename U, Index M, Index N, typename TOp>
+std::enable_if_t<M != N, Position<M>>
+window_extremum(const U* in, const Position<M>& shape, const Mask<N>& window, std::vector<T>& out, TOp&& op)
+{
+  return window_extremum(in, shape, extend<M>(window), out, LINX_FORWARD(op));
+}
+
+/**
+ * @brief Minimum operator.
+ */
+struct Minimum {
+  template <typename T>
+  T operator()(const T& lhs, const T& rhs) const
+  {
+    return std::min(lhs, rhs);
+  }
+};
+
+/**
+ * @brief Maximum operator.
+ */
+struct Maximum {
+  template <typename T>
+  T operator()(const T& lhs, const T& rhs) const
+  {
+    return std::max(lhs, rhs);
+  }
+};
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,171 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_RECURSIVEGAUSSIAN_H
+#define _LINXTRANSFORMS_IMPL_RECURSIVEGAUSSIAN_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Vector.h"
+#include "Linx/Transforms/impl/LinePasses.h"
+
+#include <algorithm> // copy, transform
+#include <cmath> // ceil, exp, sqrt
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the radius of a truncated Gaussian kernel: three standard deviations.
+ */
+inline Index gaussian_radius(double sigma)
+{
+  return Index(std::ceil(3. * sigma));
+}
+
+/**
+ * @brief Make the window of a truncated Gaussian kernel along the last axis.
+ */
+template <Index N>
+Box<N> gaussian_window(double sigma)
+{
+  const auto radius = gaussian_radius(sigma);
+  auto front = Position<N>::zero();
+  front[N - 1] = -radius;
+  auto back = Position<N>::zero();
+  back[N - 1] = radius;
+  return {front, back};
+}
+
+/**
+ * @brief Compute the normalized values of a truncated Gaussian kernel.
+ */
+template <typename T>
+std::vector<T> gaussian_values(double sigma)
+{
+  const auto radius = gaussian_radius(sigma);
+  std::vector<double> values(2 * radius + 1);
+  double sum = 0;
+  for (Index i = -radius; i <= radius; ++i) {
+    const auto v = std::exp(-.5 * i * i / (sigma * sigma));
+    values[i + radius] = v;
+    sum += v;
+  }
+  std::vector<T> out(values.size());
+  std::transform(values.begin(), values.end(), out.begin(), [&](auto v) {
+    return T(v / sum);
+  });
+  return out;
+}
+
+/**
+ * @brief The coefficients of the Young-van Vliet recursive Gaussian filter.
+ * 
+ * Each pass computes `y[n] = b * x[n] + a1 * y[n - 1] + a2 * y[n - 2] + a3 * y[n - 3]`.
+ */
+struct YoungVanVliet {
+  /**
+   * @brief Constructor.
+   */
+  explicit YoungVanVliet(double sigma)
+  {
+    const auto q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1. - 0.26891 * sigma);
+    const auto q2 = q * q;
+    const auto q3 = q2 * q;
+    const auto b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    a1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+    a2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+    a3 = 0.422205 * q3 / b0;
+    b = 1. - (a1 + a2 + a3);
+  }
+
+  /**
+   * @brief Filter a line in place, forward then backward.
+   * 
+   * The recursions are initialized with the steady states of the extreme values.
+   */
+  void apply(std::vector<double>& line) const
+  {
+    const Index length = line.size();
+    double y1 = line[0];
+    double y2 = y1;
+    double y3 = y1;
+    for (Index n = 0; n < length; ++n) {
+      const auto y = b * line[n] + a1 * y1 + a2 * y2 + a3 * y3;
+      line[n] = y;
+      y3 = y2;
+      y2 = y1;
+      y1 = y;
+    }
+    y1 = y2 = y3 = line[length - 1];
+    for (Index n = length - 1; n >= 0; --n) {
+      const auto y = b * line[n] + a1 * y1 + a2 * y2 + a3 * y3;
+      line[n] = y;
+      y3 = y2;
+      y2 = y1;
+      y1 = y;
+    }
+  }
+
+  /**
+   * @brief The input coefficient.
+   */
+  double b;
+
+  /**
+   * @brief The recursion coefficients.
+   */
+  double a1, a2, a3;
+};
+
+/**
+ * @brief Smooth a contiguous buffer along some axis with a recursive Gaussian filter.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param axis The axis
+ * @param sigma The standard deviation
+ * @param margin The number of values cropped at each end of the lines
+ * @param out The output iterator
+ * 
+ * The cost per pixel does not depend on `sigma`.
+ * Lines are filtered entirely, such that the margins absorb the effects of the recursion initialization,
+ * and the output is cropped along `axis`, i.e. its shape is `line_pass_shape(shape, axis, 2 * margin + 1)`.
+ */
+template <typename T, typename U, Index N, typename TOutIt>
+void recursive_gaussian(const U* in, const Position<N>& shape, Index axis, double sigma, Index margin, TOutIt out)
+{
+  const auto out_shape = line_pass_shape(shape, axis, 2 * margin + 1);
+  const auto stride = shape_stride(shape, axis);
+  const auto length = shape[axis];
+  const auto out_length = out_shape[axis];
+  const auto block = out_length * stride;
+  std::vector<T> result(shape_size(out_shape));
+  const Index outer_count = block > 0 ? result.size() / block : 0;
+
+  const YoungVanVliet coefficients(sigma);
+  std::vector<double> line(length);
+  for (Index o = 0; o < outer_count; ++o) {
+    for (Index x = 0; x < stride; ++x) {
+      const auto* src = in + o * length * stride + x;
+      for (Index n = 0; n < length; ++n) {
+        line[n] = src[n * stride];
+      }
+      coefficients.apply(line);
+      auto* dst = result.data() + o * block + x;
+      for (Index n = 0; n < out_length; ++n) {
+        dst[n * stride] = T(line[n + margin]);
+      }
+    }
+  }
+  std::copy(result.begin(), result.end(), out);
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
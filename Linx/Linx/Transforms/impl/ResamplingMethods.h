@@ -7,8 +7,111 @@
 
 #include "Linx/Data/Raster.h"
 
+#include <cmath> // abs, cos, sin
+#include <type_traits> // bool_constant, remove_const_t, void_t
+#include <vector>
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The normalized sinc function, `sin(pi x) / (pi x)`.
+ */
+inline double sinc(double x)
+{
+  if (x == 0) {
+    return 1;
+  }
+  const auto pi_x = pi<double>() * x;
+  return std::sin(pi_x) / pi_x;
+}
+
+/**
+ * @brief Check whether some input is an extrapolator of a raster, i.e. whether it decorates contiguous data.
+ */
+template <typename TIn, typename = void>
+struct IsRasterExtrapolator : std::false_type {};
+
+template <typename TIn>
+struct IsRasterExtrapolator<TIn, std::void_t<decltype(std::declval<const TIn&>().raster())>> :
+    std::bool_constant<is_raster<decltype(std::declval<const TIn&>().raster())>()> {};
+
+/**
+ * @brief Interpolate a raster or raster extrapolator in 2D or 3D with a separable method.
+ * @param in The raster or extrapolator
+ * @param position The position
+ * @param out The interpolated value
+ * @return False if the stencil is not fully inside the domain of an extrapolator, in which case `out` is not set
+ * 
+ * The floor and weights are computed once per axis, and the neighborhood is read directly from the data,
+ * from a base pointer and the strides.
+ * Rasters are not bound-checked, as in the generic implementation.
+ */
+template <typename TMethod, typename T, typename TIn, Index N>
+bool stencil_at(const TIn& in, const Vector<double, N>& position, T& out)
+{
+  constexpr Index taps = TMethod::Taps;
+  const auto& raster = [&]() -> decltype(auto) {
+    if constexpr (is_raster<TIn>()) {
+      return in;
+    } else {
+      return in.raster();
+    }
+  }();
+  const auto& shape = raster.shape();
+  const auto& strides = raster.strides();
+  double weights[N][taps];
+  Index offset = 0;
+  for (Index i = 0; i < N; ++i) {
+    const auto front = TMethod::weights(position[i], weights[i]);
+    if constexpr (not is_raster<TIn>()) {
+      if (front < 0 || front + taps > shape[i]) {
+        return false;
+      }
+    }
+    offset += front * strides[i];
+  }
+  const auto* data = raster.data() + offset;
+  const auto s1 = strides[1];
+  const auto plane = [&](const auto* base) {
+    T sum {};
+    for (Index y = 0; y < taps; ++y) {
+      const auto* row = base + y * s1;
+      T line {};
+      for (Index x = 0; x < taps; ++x) {
+        line += weights[0][x] * static_cast<T>(row[x]);
+      }
+      sum += weights[1][y] * line;
+    }
+    return sum;
+  };
+  if constexpr (N == 2) {
+    out = plane(data);
+  } else {
+    const auto s2 = strides[2];
+    T sum {};
+    for (Index z = 0; z < taps; ++z) {
+      sum += weights[2][z] * plane(data + z * s2);
+    }
+    out = sum;
+  }
+  return true;
+}
+
+/**
+ * @brief Check whether `stencil_at()` can be used for some input and position dimension.
+ */
+template <typename TIn, Index N, typename... TIndices>
+constexpr bool has_stencil()
+{
+  return sizeof...(TIndices) == 0 && (N == 2 || N == 3) && (is_raster<TIn>() || IsRasterExtrapolator<TIn>::value);
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup resampling
  * @brief Constant, a.k.a. Dirichlet boundary conditions.
@@ -52,6 +155,29 @@ private:
  * @brief Nearest-neighbor interpolation or extrapolation, a.k.a. zero-flux Neumann boundary conditions.
  */
 struct Nearest {
+  /**
+   * @brief The number of samples involved in 1D interpolation.
+   */
+  static constexpr Index Taps = 1;
+
+  /**
+   * @brief Compute the 1D interpolation weights at given coordinate.
+   * @return The coordinate of the first sample
+   */
+  static Index weights(double coordinate, double* out)
+  {
+    out[0] = 1;
+    return coordinate + .5;
+  }
+
+  /**
+   * @brief Get the in-bounds index of a 1D index.
+   */
+  static Index index(Index i, Index length)
+  {
+    return i < 0 ? 0 : i >= length ? length - 1 : i;
+  }
+
   /**
    * @brief Return the value at the nearest in-bounds position.
    */
@@ -81,6 +207,15 @@ struct Nearest {
  * @brief Periodic, a.k.a. symmetric or wrap-around, boundary conditions.
  */
 struct Periodic {
+  /**
+   * @brief Get the in-bounds index of a 1D index.
+   */
+  static Index index(Index i, Index length)
+  {
+    const auto q = i % length;
+    return q < 0 ? q + length : q; // Positive modulo
+  }
+
   /**
    * @brief Return the value at the modulo position.
    */
@@ -90,8 +225,44 @@ struct Periodic {
     Position<TRaster::Dimension> inbounds(position.size());
     inbounds.generate(
         [](auto p, auto s) {
-          auto q = p % s;
-          return q < 0 ? q + s : q; // Positive modulo
+          return index(p, s);
+        },
+        position,
+        raster.shape());
+    return raster[inbounds];
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Reflect, a.k.a. mirror or whole-sample symmetric, boundary conditions.
+ * 
+ * The edge samples are not repeated, e.g. positions -2, -1 are mapped to 2, 1.
+ */
+struct Reflect {
+  /**
+   * @brief Get the in-bounds index of a 1D index.
+   */
+  static Index index(Index i, Index length)
+  {
+    if (length == 1) {
+      return 0;
+    }
+    const auto period = 2 * length - 2;
+    const auto q = std::abs(i) % period;
+    return q < length ? q : period - q;
+  }
+
+  /**
+   * @brief Return the value at the reflected position.
+   */
+  template <typename TRaster>
+  inline const typename TRaster::value_type& at(TRaster& raster, const Position<TRaster::Dimension>& position) const
+  {
+    Position<TRaster::Dimension> inbounds(position.size());
+    inbounds.generate(
+        [](auto p, auto s) {
+          return index(p, s);
         },
         position,
         raster.shape());
@@ -104,6 +275,24 @@ struct Periodic {
  * @brief Linear interpolation.
  */
 struct Linear {
+  /**
+   * @brief The number of samples involved in 1D interpolation.
+   */
+  static constexpr Index Taps = 2;
+
+  /**
+   * @brief Compute the 1D interpolation weights at given coordinate.
+   * @return The coordinate of the first sample
+   */
+  static Index weights(double coordinate, double* out)
+  {
+    const auto f = floor<Index>(coordinate);
+    const auto d = coordinate - f;
+    out[0] = 1 - d;
+    out[1] = d;
+    return f;
+  }
+
   /**
    * @brief Return the interpolated value at given index.
    */
@@ -124,6 +313,12 @@ struct Linear {
   inline std::enable_if_t<N != 1, T> // FIXME use if constexpr
   at(const TRaster& raster, const Vector<double, N>& position, TIndices... indices) const
   {
+    if constexpr (Internal::has_stencil<TRaster, N, TIndices...>()) {
+      std::remove_const_t<T> out {};
+      if (Internal::stencil_at<Linear>(raster, position, out)) {
+        return out;
+      }
+    }
     const auto f = floor<Index>(position.back());
     const auto d = position.back() - f;
     const auto pos = slice<N - 1>(position);
@@ -138,6 +333,28 @@ struct Linear {
  * @brief Cubic interpolation.
  */
 struct Cubic {
+  /**
+   * @brief The number of samples involved in 1D interpolation.
+   */
+  static constexpr Index Taps = 4;
+
+  /**
+   * @brief Compute the 1D interpolation weights at given coordinate.
+   * @return The coordinate of the first sample
+   */
+  static Index weights(double coordinate, double* out)
+  {
+    const auto f = floor<Index>(coordinate);
+    const auto d = coordinate - f;
+    const auto d2 = d * d;
+    const auto d3 = d2 * d;
+    out[0] = 0.5 * (-d + 2 * d2 - d3);
+    out[1] = 1 + 0.5 * (-5 * d2 + 3 * d3);
+    out[2] = 0.5 * (d + 4 * d2 - 3 * d3);
+    out[3] = 0.5 * (-d2 + d3);
+    return f - 1;
+  }
+
   /**
    * @brief Return the interpolated value at given index.
    */
@@ -160,6 +377,12 @@ struct Cubic {
   inline std::enable_if_t<N != 1, T> // FIXME use if constexpr
   at(const TRaster& raster, const Vector<double, N>& position, TIndices... indices) const
   {
+    if constexpr (Internal::has_stencil<TRaster, N, TIndices...>()) {
+      std::remove_const_t<T> out {};
+      if (Internal::stencil_at<Cubic>(raster, position, out)) {
+        return out;
+      }
+    }
     const auto f = floor<Index>(position.back());
     const auto d = position.back() - f;
     const auto pos = slice<N - 1>(position);
@@ -171,6 +394,150 @@ struct Cubic {
   }
 };
 
+/**
+ * @ingroup resampling
+ * @brief The Lanczos window, i.e. the central lobe of a sinc.
+ */
+struct LanczosWindow {
+  /**
+   * @brief Evaluate the window at given reduced coordinate, in `[-1, 1]`.
+   */
+  static double at(double x)
+  {
+    return Internal::sinc(x);
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief The Hann window, i.e. a raised cosine.
+ */
+struct HannWindow {
+  /**
+   * @brief Evaluate the window at given reduced coordinate, in `[-1, 1]`.
+   */
+  static double at(double x)
+  {
+    return 0.5 * (1 + std::cos(pi<double>() * x));
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Windowed-sinc interpolation.
+ * @tparam A The kernel radius, such that `2 * A` samples are involved along each axis
+ * @tparam TWindow The window, which provides `static double at(double x)` for `x` in `[-1, 1]`
+ * 
+ * The kernel `sinc(x) * TWindow::at(x / A)` is tabulated once, at `Resolution` samples per pixel,
+ * and linearly interpolated in the table.
+ * The weights are normalized to sum to 1, such that flux is conserved and constant inputs are preserved.
+ * 
+ * @see `Lanczos`
+ */
+template <Index A, typename TWindow>
+struct WindowedSinc {
+  static_assert(A > 0, "The kernel radius must be positive.");
+
+  /**
+   * @brief The number of samples involved in 1D interpolation.
+   */
+  static constexpr Index Taps = 2 * A;
+
+  /**
+   * @brief The number of table samples per pixel.
+   */
+  static constexpr Index Resolution = 1024;
+
+  /**
+   * @brief Evaluate the kernel at given distance, from the table.
+   */
+  static double kernel(double distance)
+  {
+    static const std::vector<double> table = [] {
+      std::vector<double> out(A * Resolution + 2, 0.);
+      for (Index i = 0; i < A * Resolution; ++i) {
+        const auto x = double(i) / Resolution;
+        out[i] = i % Resolution == 0 ? (i == 0) : Internal::sinc(x) * TWindow::at(x / A);
+      }
+      return out;
+    }();
+    const auto x = std::abs(distance) * Resolution;
+    const auto i = static_cast<Index>(x);
+    if (i >= A * Resolution) {
+      return 0;
+    }
+    const auto d = x - i;
+    return table[i] + d * (table[i + 1] - table[i]);
+  }
+
+  /**
+   * @brief Compute the 1D interpolation weights at given coordinate.
+   * @return The coordinate of the first sample
+   */
+  static Index weights(double coordinate, double* out)
+  {
+    const auto f = floor<Index>(coordinate);
+    const auto d = coordinate - f;
+    double sum = 0;
+    for (Index k = 0; k < Taps; ++k) {
+      out[k] = kernel(d + A - 1 - k);
+      sum += out[k];
+    }
+    for (Index k = 0; k < Taps; ++k) {
+      out[k] /= sum;
+    }
+    return f - A + 1;
+  }
+
+  /**
+   * @brief Return the interpolated value at given index.
+   */
+  template <typename T, typename TRaster, typename... TIndices>
+  inline T at(const TRaster& raster, const Vector<double, 1>& position, TIndices... indices) const
+  {
+    double w[Taps];
+    const auto front = weights(position.front(), w);
+    std::remove_const_t<T> out {};
+    for (Index k = 0; k < Taps; ++k) {
+      out += w[k] * static_cast<std::remove_const_t<T>>(raster[{front + k, indices...}]);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Return the interpolated value at given position.
+   */
+  template <typename T, Index N, typename TRaster, typename... TIndices>
+  inline std::enable_if_t<N != 1, T> // FIXME use if constexpr
+  at(const TRaster& raster, const Vector<double, N>& position, TIndices... indices) const
+  {
+    if constexpr (Internal::has_stencil<TRaster, N, TIndices...>()) {
+      std::remove_const_t<T> out {};
+      if (Internal::stencil_at<WindowedSinc>(raster, position, out)) {
+        return out;
+      }
+    }
+    double w[Taps];
+    const auto front = weights(position.back(), w);
+    const auto pos = slice<N - 1>(position);
+    std::remove_const_t<T> out {};
+    for (Index k = 0; k < Taps; ++k) {
+      out += w[k] * at<std::remove_const_t<T>>(raster, pos, front + k, indices...);
+    }
+    return out;
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Lanczos interpolation, i.e. sinc interpolation with a sinc window.
+ * @tparam A The kernel radius, typically 2 or 3
+ * 
+ * This is a good compromise between sharpness and ringing, e.g. for astrometric resampling.
+ */
+template <Index A>
+using Lanczos = WindowedSinc<A, LanczosWindow>;
+
 } // namespace Linx
 
 #endif
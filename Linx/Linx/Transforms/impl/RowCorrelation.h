@@ -0,0 +1,88 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_ROWCORRELATION_H
+#define _LINXTRANSFORMS_IMPL_ROWCORRELATION_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Vector.h"
+
+#include <algorithm> // copy, max
+#include <numeric> // inner_product
+#include <type_traits> // decay_t
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Correlate a contiguous buffer with a box kernel, row by row.
+ * @tparam Width The window length along axis 0 if known at compile time, or 0
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param window The window, of same dimension as the input
+ * @param weights The kernel values, in window order, as a contiguous container, e.g. `std::vector` or `std::array`
+ * @param out The output iterator
+ * 
+ * The output is cropped, i.e. its shape is `shape - window.shape() + 1`.
+ * Loops are interchanged: for each output row, each kernel value is multiplied with a whole input row,
+ * and accumulated into a contiguous row buffer.
+ * Inner loops are therefore contiguous and vectorized, and the row buffer remains in cache.
+ * If `Width` is provided, the loop over the kernel values of a row has a constant trip count and can be unrolled.
+ */
+template <Index Width = 0, typename TWeights, typename U, Index N, typename TOutIt>
+void row_correlation(const U* in, const Position<N>& shape, const Box<N>& window, const TWeights& weights, TOutIt out)
+{
+  using T = std::decay_t<decltype(*weights.data())>;
+  auto out_shape = shape;
+  for (Index i = 0; i < static_cast<Index>(out_shape.size()); ++i) {
+    out_shape[i] = std::max(Index(0), shape[i] - window.length(i) + 1);
+  }
+  if (shape_size(out_shape) == 0) {
+    return;
+  }
+  const Index width = out_shape[0];
+  const Index kernel_width = Width > 0 ? Width : window.length(0);
+
+  std::vector<Index> strides(shape.size());
+  for (std::size_t i = 0; i < strides.size(); ++i) {
+    strides[i] = shape_stride(shape, i);
+  }
+  auto kernel_rows_shape = window.shape();
+  kernel_rows_shape[0] = 1;
+  std::vector<Index> offsets; // Of the kernel rows
+  for (const auto& q : Box<N>::from_shape(kernel_rows_shape)) {
+    offsets.push_back(std::inner_product(q.begin(), q.end(), strides.begin(), Index(0)));
+  }
+
+  auto rows_shape = out_shape;
+  rows_shape[0] = 1;
+  std::vector<T> row(width);
+  for (const auto& r : Box<N>::from_shape(rows_shape)) {
+    const auto* src = in + std::inner_product(r.begin(), r.end(), strides.begin(), Index(0));
+    std::fill(row.begin(), row.end(), T {});
+    auto* dst = row.data();
+    auto w = weights.data();
+    for (auto o : offsets) {
+      for (Index j = 0; j < kernel_width; ++j, ++w) {
+        const auto* s = src + o + j;
+        const auto k = *w;
+#pragma omp simd
+        for (Index x = 0; x < width; ++x) {
+          dst[x] += k * s[x];
+        }
+      }
+    }
+    out = std::copy(row.begin(), row.end(), out);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,205 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SEPARABLECORRELATION_H
+#define _LINXTRANSFORMS_IMPL_SEPARABLECORRELATION_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/SimpleFilter.h"
+
+#include <algorithm> // copy, fill
+#include <type_traits> // false_type, true_type
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+template <typename T, typename TWindow>
+class Correlation;
+
+template <typename T, typename TWindow>
+class Convolution;
+/// @endcond
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a filter is a box-based correlation or convolution.
+ * 
+ * Such filters can be run as line passes if their window is one-dimensional.
+ */
+template <typename TFilter>
+struct IsBoxCorrelation : std::false_type {};
+
+template <typename T, Index N>
+struct IsBoxCorrelation<SimpleFilter<Correlation<T, Box<N>>>> : std::true_type {};
+
+template <typename T, Index N>
+struct IsBoxCorrelation<SimpleFilter<Convolution<T, Box<N>>>> : std::true_type {};
+
+/**
+ * @brief Get the weights of a correlation kernel, in window order.
+ */
+template <typename T, Index N>
+std::vector<T> line_weights(const Correlation<T, Box<N>>& kernel)
+{
+  return kernel.values();
+}
+
+/**
+ * @brief Get the weights of a convolution kernel, in window order.
+ */
+template <typename T, Index N>
+std::vector<T> line_weights(const Convolution<T, Box<N>>& kernel)
+{
+  const auto& values = kernel.values();
+  return std::vector<T>(values.rbegin(), values.rend());
+}
+
+/**
+ * @brief A 1D correlation along some axis.
+ */
+template <typename T>
+struct LineCorrelation {
+  /**
+   * @brief The correlation axis.
+   */
+  Index axis;
+
+  /**
+   * @brief The correlation weights, in window order.
+   */
+  std::vector<T> weights;
+};
+
+/**
+ * @brief A sequence of 1D correlations, run as line passes over contiguous buffers.
+ * 
+ * Each pass crops the data along its axis, as `SimpleFilter` would do with a raster input.
+ * Passes along axis 0 are computed row-wise; passes along other axes are computed as
+ * weighted sums of whole rows, such that inner loops are always contiguous.
+ * Two buffers are allocated once and swapped between passes.
+ */
+template <typename T, Index N>
+class SeparableCorrelation {
+public:
+
+  /**
+   * @brief Try to make a separable correlation from a tuple of simple filters.
+   * 
+   * Return `false` (and leave the object in an unspecified state) if some window is not a line.
+   */
+  template <typename TFilters>
+  bool assign(const TFilters& filters)
+  {
+    m_passes.clear();
+    bool separable = true;
+    seq_foreach(filters, [&](const auto& f) {
+      const auto window = extend<N>(box(f.window()));
+      Index axis = 0;
+      Index count = 0;
+      for (Index i = 0; i < window.dimension(); ++i) {
+        if (window.length(i) > 1) {
+          axis = i;
+          ++count;
+        }
+      }
+      separable &= (count <= 1);
+      m_passes.push_back({axis, line_weights(f.kernel())});
+    });
+    return separable;
+  }
+
+  /**
+   * @brief Apply the passes to a raster and copy the cropped result into an output.
+   */
+  template <typename U, typename UHolder, typename TOut>
+  void transform(const Raster<U, N, UHolder>& in, TOut& out)
+  {
+    auto shape = in.shape();
+    auto it = m_passes.begin();
+    shape = pass(in.data(), shape, *it, m_next);
+    for (++it; it != m_passes.end(); ++it) {
+      std::swap(m_current, m_next);
+      shape = pass(m_current.data(), shape, *it, m_next);
+    }
+    std::copy(m_next.begin(), m_next.end(), out.begin());
+  }
+
+private:
+
+  /**
+   * @brief Run one pass from an input buffer of given shape, and return the output shape.
+   */
+  template <typename U>
+  Position<N> pass(const U* in, const Position<N>& shape, const LineCorrelation<T>& line, std::vector<T>& out) const
+  {
+    const auto& weights = line.weights;
+    const Index size = weights.size();
+    auto out_shape = shape;
+    out_shape[line.axis] = std::max(Index(0), shape[line.axis] - size + 1);
+    out.resize(shape_size(out_shape));
+    std::fill(out.begin(), out.end(), T {});
+
+    const auto width = shape[0];
+    const auto out_width = out_shape[0];
+    if (line.axis == 0) {
+      const Index row_count = out_width > 0 ? out.size() / out_width : 0;
+      for (Index r = 0; r < row_count; ++r) {
+        const auto* src = in + r * width;
+        auto* dst = out.data() + r * out_width;
+        for (Index j = 0; j < size; ++j) {
+          const auto w = weights[j];
+          for (Index x = 0; x < out_width; ++x) {
+            dst[x] += w * src[x + j];
+          }
+        }
+      }
+      return out_shape;
+    }
+
+    // Rows of the blocks before the axis are contiguous: weighted sums of whole blocks
+    const auto stride = shape_stride(shape, line.axis);
+    const auto length = shape[line.axis];
+    const auto out_length = out_shape[line.axis];
+    const Index outer_count = out_length * stride > 0 ? out.size() / (out_length * stride) : 0;
+    for (Index o = 0; o < outer_count; ++o) {
+      for (Index y = 0; y < out_length; ++y) {
+        auto* dst = out.data() + (o * out_length + y) * stride;
+        for (Index j = 0; j < size; ++j) {
+          const auto w = weights[j];
+          const auto* src = in + (o * length + y + j) * stride;
+          for (Index x = 0; x < stride; ++x) {
+            dst[x] += w * src[x];
+          }
+        }
+      }
+    }
+    return out_shape;
+  }
+
+  /**
+   * @brief The passes.
+   */
+  std::vector<LineCorrelation<T>> m_passes;
+
+  /**
+   * @brief The input buffer of the current pass.
+   */
+  std::vector<T> m_current;
+
+  /**
+   * @brief The output buffer of the current pass.
+   */
+  std::vector<T> m_next;
+};
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,278 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SLIDINGMEDIAN_H
+#define _LINXTRANSFORMS_IMPL_SLIDINGMEDIAN_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Mask.h"
+#include "Linx/Transforms/impl/SlidingReduction.h"
+
+#include <algorithm> // lower_bound, upper_bound
+#include <limits>
+#include <type_traits> // conditional_t, is_integral, is_same
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Sliding window of values, stored in a sorted buffer.
+ * 
+ * Insertion and deletion are logarithmic searches followed by contiguous moves,
+ * which is fast for the window sizes of usual filters.
+ * NaNs, which cannot be ordered, are only counted, and are not part of the window size.
+ */
+template <typename T>
+class SortedWindow {
+public:
+
+  /**
+   * @brief Insert a value.
+   */
+  void insert(T value)
+  {
+    if (value != value) {
+      ++m_nans;
+      return;
+    }
+    m_values.insert(std::upper_bound(m_values.begin(), m_values.end(), value), value);
+  }
+
+  /**
+   * @brief Remove a value, which must have been inserted.
+   */
+  void erase(T value)
+  {
+    if (value != value) {
+      --m_nans;
+      return;
+    }
+    m_values.erase(std::lower_bound(m_values.begin(), m_values.end(), value));
+  }
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index size() const
+  {
+    return m_values.size();
+  }
+
+  /**
+   * @brief Get the value of given rank.
+   */
+  T nth(Index rank)
+  {
+    return m_values[rank];
+  }
+
+private:
+
+  /**
+   * @brief The sorted values.
+   */
+  std::vector<T> m_values;
+
+  /**
+   * @brief The number of NaNs.
+   */
+  Index m_nans = 0;
+};
+
+/**
+ * @brief Sliding window of values, stored as a histogram.
+ * 
+ * Following Huang's algorithm, a cursor bin and the number of values below it are maintained,
+ * such that queries only move the cursor by a few bins when the window slides.
+ * This is suitable for integral types of at most 16 bits.
+ */
+template <typename T>
+class HistogramWindow {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  HistogramWindow() :
+      m_bins(Index(std::numeric_limits<T>::max()) - Index(std::numeric_limits<T>::min()) + 1, 0), m_size(0),
+      m_cursor(0), m_below(0)
+  {}
+
+  /**
+   * @brief Insert a value.
+   */
+  void insert(T value)
+  {
+    const auto b = bin(value);
+    ++m_bins[b];
+    ++m_size;
+    if (b < m_cursor) {
+      ++m_below;
+    }
+  }
+
+  /**
+   * @brief Remove a value, which must have been inserted.
+   */
+  void erase(T value)
+  {
+    const auto b = bin(value);
+    --m_bins[b];
+    --m_size;
+    if (b < m_cursor) {
+      --m_below;
+    }
+  }
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the value of given rank.
+   */
+  T nth(Index rank)
+  {
+    while (m_below > rank) {
+      --m_cursor;
+      m_below -= m_bins[m_cursor];
+    }
+    while (m_below + m_bins[m_cursor] <= rank) {
+      m_below += m_bins[m_cursor];
+      ++m_cursor;
+    }
+    return T(m_cursor + std::numeric_limits<T>::min());
+  }
+
+private:
+
+  /**
+   * @brief Get the bin index of a value.
+   */
+  static Index bin(T value)
+  {
+    return Index(value) - Index(std::numeric_limits<T>::min());
+  }
+
+  /**
+   * @brief The bin counts.
+   */
+  std::vector<Index> m_bins;
+
+  /**
+   * @brief The number of values.
+   */
+  Index m_size;
+
+  /**
+   * @brief The cursor bin.
+   */
+  Index m_cursor;
+
+  /**
+   * @brief The number of values in the bins below the cursor.
+   */
+  Index m_below;
+};
+
+/**
+ * @brief The sliding window type used to compute medians of a given type.
+ */
+template <typename T>
+using MedianWindow = std::conditional_t<
+    std::is_integral<T>::value && not std::is_same<T, bool>::value && sizeof(T) <= 2,
+    HistogramWindow<T>,
+    SortedWindow<T>>;
+
+/**
+ * @brief Compute the median of a window.
+ * 
+ * For even sizes, the mean of the two middle values is returned.
+ * For empty windows, e.g. of NaNs only, NaN is returned.
+ */
+template <typename T, typename TWindow>
+T window_median(TWindow& window)
+{
+  const auto size = window.size();
+  if (size == 0) {
+    return std::numeric_limits<T>::quiet_NaN();
+  }
+  const auto upper = window.nth(size / 2);
+  if (size % 2 == 1) {
+    return upper;
+  }
+  return (window.nth(size / 2 - 1) + upper) * .5;
+}
+
+/**
+ * @brief Accumulator which computes the median of a sliding window.
+ */
+template <typename T>
+class MedianAccumulator {
+public:
+
+  /**
+   * @brief Insert a value.
+   */
+  template <typename U>
+  void add(U value)
+  {
+    m_window.insert(T(value));
+  }
+
+  /**
+   * @brief Remove a value, which must have been inserted.
+   */
+  template <typename U>
+  void remove(U value)
+  {
+    m_window.erase(T(value));
+  }
+
+  /**
+   * @brief Get the median.
+   */
+  T result()
+  {
+    return window_median<T>(m_window);
+  }
+
+private:
+
+  /**
+   * @brief The window values.
+   */
+  MedianWindow<T> m_window;
+};
+
+/**
+ * @brief Compute the medians of the values of a sliding box or mask.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param window The window
+ * @param out The output iterator
+ * 
+ * The window is updated incrementally along each row, see `sliding_reduction()`.
+ */
+template <typename T, typename U, Index M, typename TWindow, typename TOutIt>
+auto sliding_median(const U* in, const Position<M>& shape, const TWindow& window, TOutIt out)
+    -> decltype(sliding_reduction(in, shape, window, std::declval<MedianAccumulator<T>&>(), out), void())
+{
+  MedianAccumulator<T> accumulator;
+  sliding_reduction(in, shape, window, accumulator, out);
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
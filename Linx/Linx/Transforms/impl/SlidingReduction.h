@@ -0,0 +1,126 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SLIDINGREDUCTION_H
+#define _LINXTRANSFORMS_IMPL_SLIDINGREDUCTION_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Mask.h"
+#include "Linx/Transforms/impl/LinePasses.h"
+
+#include <algorithm> // max
+#include <numeric> // inner_product
+#include <type_traits> // enable_if_t
+#include <utility> // pair
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Reduce the values of a sliding mask with an invertible accumulator.
+ * @param in The contiguous input data
+ * @param shape The input shape
+ * @param window The window
+ * @param accumulator The accumulator, which implements `add(value)`, `remove(value)` and `result()`
+ * @param out The output iterator
+ * 
+ * The mask is decomposed into segments along axis 0.
+ * When the window moves to the next pixel, one value per segment leaves the window and one value enters it,
+ * such that the accumulator is updated incrementally along each row.
+ * At the end of a row, values are removed one by one, such that the accumulator needs not be resettable.
+ */
+template <typename TAccumulator, typename U, Index N, typename TOutIt>
+void sliding_reduction(
+    const U* in,
+    const Position<N>& shape,
+    const Mask<N>& window,
+    TAccumulator& accumulator,
+    TOutIt out)
+{
+  auto out_shape = shape;
+  for (Index i = 0; i < static_cast<Index>(out_shape.size()); ++i) {
+    out_shape[i] = std::max(Index(0), shape[i] - window.length(i) + 1);
+  }
+  const Index width = out_shape[0];
+  if (shape_size(out_shape) == 0) {
+    return;
+  }
+
+  std::vector<Index> strides(shape.size());
+  for (std::size_t i = 0; i < strides.size(); ++i) {
+    strides[i] = shape_stride(shape, i);
+  }
+  std::vector<std::pair<Index, Index>> segments; // Offset and length
+  for (const auto& s : mask_segments(window)) {
+    for (const auto& p : s.second) {
+      segments.emplace_back(std::inner_product(p.begin(), p.end(), strides.begin(), Index(0)), s.first);
+    }
+  }
+
+  auto rows_shape = out_shape;
+  rows_shape[0] = 1;
+  for (const auto& r : Box<N>::from_shape(rows_shape)) {
+    const auto* row = in + std::inner_product(r.begin(), r.end(), strides.begin(), Index(0));
+    for (const auto& s : segments) {
+      const auto* src = row + s.first;
+      for (Index j = 0; j < s.second; ++j) {
+        accumulator.add(src[j]);
+      }
+    }
+    *out = accumulator.result();
+    ++out;
+    for (Index x = 1; x < width; ++x) {
+      for (const auto& s : segments) {
+        const auto* src = row + s.first + x - 1;
+        accumulator.remove(src[0]);
+        accumulator.add(src[s.second]);
+      }
+      *out = accumulator.result();
+      ++out;
+    }
+    for (const auto& s : segments) {
+      const auto* src = row + s.first + width - 1;
+      for (Index j = 0; j < s.second; ++j) {
+        accumulator.remove(src[j]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Reduce the values of a sliding mask of lower dimension than the input.
+ * 
+ * The mask is extended with unit lengths, such that each section of the input is processed independently.
+ */
+template <typename TAccumulator, typename U, Index M, Index N, typename TOutIt>
+std::enable_if_t<M != N>
+sliding_reduction(const U* in, const Position<M>& shape, const Mask<N>& window, TAccumulator& accumulator, TOutIt out)
+{
+  sliding_reduction(in, shape, extend<M>(window), accumulator, out);
+}
+
+/**
+ * @brief Reduce the values of a sliding box with an invertible accumulator.
+ * @see `sliding_reduction()` for masks
+ */
+template <typename TAccumulator, typename U, Index M, Index N, typename TOutIt>
+void sliding_reduction(
+    const U* in,
+    const Position<M>& shape,
+    const Box<N>& window,
+    TAccumulator& accumulator,
+    TOutIt out)
+{
+  sliding_reduction(in, shape, Mask<M>(extend<M>(window)), accumulator, out);
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -5,12 +5,20 @@
 #ifndef _LINXTRANSFORMS_MIXINS_FILTER_H
 #define _LINXTRANSFORMS_MIXINS_FILTER_H
 
+#include "Linx/Base/Threads.h"
+#include "Linx/Base/Trace.h"
 #include "Linx/Data/BorderedBox.h"
 #include "Linx/Data/Box.h"
+#include "Linx/Data/DimensionDispatch.h"
 #include "Linx/Data/Grid.h"
+#include "Linx/Data/LazyRaster.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
 
+#include <algorithm> // max, min
+#include <iterator> // begin, distance, end
+#include <type_traits> // decay_t
+
 namespace Linx {
 
 /**
@@ -18,6 +26,10 @@ namespace Linx {
  * @brief Spatial filtering mixin.
  * 
  * Child classes must implement `window()` and `transform(in, out)`.
+ * 
+ * Windows of lower dimension than the input are extended with unit lengths along the remaining axes.
+ * For example, a 2D filter applied to a 3D cube smoothes all the sections of the cube in a single pass,
+ * and multi-threaded filtering distributes the sections among the threads.
  */
 template <typename T, typename TWindow, typename TDerived>
 class FilterMixin {
@@ -55,23 +67,119 @@ public:
 
   /**
    * @brief Apply the filter into a given output.
+   * 
+   * The output is any raster or patch with compatible domain, e.g. a `PtrRaster` to preallocated memory.
+   * No allocation is made by the filter itself, apart from small work buffers.
    */
   template <typename TIn, typename TOut>
   inline void transform(const TIn& in, TOut& out) const
   {
-    // FIXME make applicable to Sequence<Position>?
-    LINX_CRTP_CONST_DERIVED.transform_impl(in, out);
+    LINX_TRACE_SCOPE("Filter::transform");
+    transform_fixed_dimension(in, out);
+  }
+
+  /**
+   * @brief Apply the filter into a given output with multi-threading.
+   * 
+   * The output domain is split into parts which are filtered concurrently.
+   */
+  template <typename TIn, typename TOut>
+  inline void transform(const TIn& in, TOut& out, const Threads& threads) const
+  {
+    LINX_TRACE_SCOPE("Filter::transform");
+    transform_fixed_dimension(in, out, threads);
+  }
+
+  /**
+   * @brief Apply the filter to each input of a batch, e.g. to many small stamps.
+   * @param ins A random-access range of inputs, e.g. rasters or extrapolators
+   * @param outs A random-access range of outputs with compatible domains
+   * @param threads The threading policy, which distributes the inputs among the threads
+   * 
+   * If the inputs have the same shape, it is generally more efficient to stack them into a raster of dimension `N + 1`,
+   * and to filter it at once, e.g. `filter.transform(extrapolation(stack), out, threads)`:
+   * since the window has unit length along the stacking axis, the stamps are filtered independently,
+   * yet the setup and border splitting are shared.
+   */
+  template <typename TIns, typename TOuts>
+  void transform_each(const TIns& ins, TOuts& outs, const Threads& threads = Threads(1)) const
+  {
+    const Index count = std::distance(std::begin(ins), std::end(ins));
+    const auto in_begin = std::begin(ins);
+    const auto out_begin = std::begin(outs);
+#pragma omp parallel for num_threads(threads.count()) schedule(dynamic)
+    for (Index i = 0; i < count; ++i) {
+      auto& out = out_begin[i];
+      transform(in_begin[i], out);
+    }
+  }
+
+  /**
+   * @brief Apply the filter with extrapolation, in place.
+   * @tparam TMethod The extrapolation method
+   * @param raster The input raster, which receives the output values
+   * @param buffer A work raster of the same shape as `raster`, e.g. an `AlignedRaster` or a `PtrRaster` to a pool
+   * @param args The extrapolation method arguments, e.g. the constant value
+   * 
+   * The raster is filtered into the buffer, which is then copied back into the raster,
+   * such that long-running loops can reuse the same buffer and allocate nothing.
+   * 
+   * @see `transform()` to filter into a caller-provided output without the copy
+   */
+  template <typename TMethod = Nearest, typename U, Index N, typename UHolder, typename TBuffer, typename... TArgs>
+  void transform_inplace(Raster<U, N, UHolder>& raster, TBuffer& buffer, TArgs&&... args) const
+  {
+    transform(extrapolation<TMethod>(raster, LINX_FORWARD(args)...), buffer);
+    std::copy(buffer.begin(), buffer.end(), raster.begin());
+  }
+
+  /**
+   * @brief Apply the filter at selected positions only.
+   * @param in The input raster or extrapolator
+   * @param positions The positions at which the filter is evaluated, e.g. a `Sequence` of positions or a `Mask`
+   * @param out The output raster, which is only assigned at `positions`
+   * 
+   * This is useful when few positions are of interest: other output values are left untouched,
+   * such that `out` can be pre-filled.
+   * If the neighborhood of some position is not fully inside the raster domain, then `in` must be an extrapolator.
+   */
+  template <typename TIn, typename TPositions, typename TOut>
+  void transform_at(const TIn& in, const TPositions& positions, TOut& out) const
+  {
+    LINX_CRTP_CONST_DERIVED.transform_at_impl(in, positions, [&](const auto& p, const auto& v) {
+      out[p] = v;
+    });
+  }
+
+  /**
+   * @brief Apply the filter at the positions flagged in a selection map.
+   * @see `transform_at()`
+   */
+  template <typename TIn, typename U, Index N, typename UHolder, typename TOut>
+  void transform_at(const TIn& in, const Raster<U, N, UHolder>& selection, TOut& out) const
+  {
+    std::vector<Position<N>> positions;
+    auto it = selection.begin();
+    for (const auto& p : selection.domain()) {
+      if (*it) {
+        positions.push_back(p);
+      }
+      ++it;
+    }
+    transform_at(in, positions, out);
   }
 
   /**
    * @brief Apply the filter with cropping.
+   * 
+   * The output is a `SmallRaster` if the input is, and a `Raster` otherwise.
    */
   template <typename U, Index N, typename UHolder>
-  Raster<Value, N> operator*(const Raster<U, N, UHolder>& in) const
+  Internal::SimilarRaster<Raster<U, N, UHolder>, Value> operator*(const Raster<U, N, UHolder>& in) const
   {
-    const auto& w = box(window());
+    const auto w = box(window()); // window() may return by value
     const auto shape = in.shape() - extend<N>(w.shape() - 1);
-    Raster<Value, N> out(shape);
+    Internal::SimilarRaster<Raster<U, N, UHolder>, Value> out(shape);
     transform(in, out);
     return out;
   }
@@ -80,21 +188,52 @@ public:
    * @brief Apply the filter with extrapolation.
    */
   template <typename URaster, typename UMethod>
-  Raster<Value, URaster::Dimension> operator*(const Extrapolation<URaster, UMethod>& in) const
+  Internal::SimilarRaster<URaster, Value> operator*(const Extrapolation<URaster, UMethod>& in) const
   {
-    Raster<Value, URaster::Dimension> out(in.shape());
+    Internal::SimilarRaster<URaster, Value> out(in.shape());
     transform(in, out);
     return out;
   }
 
+  /**
+   * @brief Apply the filter to a lazy raster.
+   * 
+   * The output raster has the same shape as the input raster.
+   * Since lazy rasters are defined outside their domain, no extrapolation is needed.
+   * The input is generated by bands along the last axis, including the margins required by the window,
+   * such that memory usage is bounded whatever the raster size.
+   */
+  template <typename TFunc, Index N>
+  Raster<Value, N> operator*(const LazyRaster<TFunc, N>& in) const
+  {
+    Raster<Value, N> out(in.shape());
+    if (out.size() == 0) {
+      return out;
+    }
+    const auto margin = extend<N>(box(window()));
+    const Index length = in.length(N - 1);
+    const Index band = std::max<Index>(1, (Index(1) << 16) / (in.size() / length));
+    for (Index front = 0; front < length; front += band) {
+      auto first = Position<N>::zero();
+      auto last = in.shape() - 1;
+      first[N - 1] = front;
+      last[N - 1] = std::min(front + band, length) - 1;
+      const Box<N> region(first, last);
+      const auto generated = in.copy(region + margin);
+      auto patch = out(region);
+      transform(generated, patch);
+    }
+    return out;
+  }
+
   /**
    * @brief Apply the filter to a box-, line- or grid-based patch.
    */
   template <typename U, typename UParent, typename URegion>
-  Raster<Value, URegion::Dimension> operator*(const Patch<U, UParent, URegion>& in) const
+  Internal::SimilarRaster<UParent, Value, URegion::Dimension> operator*(const Patch<U, UParent, URegion>& in) const
   {
     // URegion::Dimension is not defined for Sequence
-    Raster<Value, URegion::Dimension> out(in.domain().shape()); // Box or Grid
+    Internal::SimilarRaster<UParent, Value, URegion::Dimension> out(in.domain().shape()); // Box or Grid
     // FIXME support arbitrary patches
     transform(in, out);
     return out;
@@ -119,11 +258,55 @@ public:
   Sequence<Value> operator*(const Patch<U, UParent, Sequence<Position<UParent::Dimension>, UHolder>>& in) const
   {
     Sequence<Value> out(in.size());
-    std::transform(in.domain().begin(), in.domain().end(), out.begin(), [&](const auto& p) {
-      return (*this) * in.parent()(p);
+    auto it = out.begin();
+    LINX_CRTP_CONST_DERIVED.transform_at_impl(in.parent(), in.domain(), [&](const auto&, const auto& v) {
+      *it = v;
+      ++it;
     });
     return out;
   }
+
+protected:
+
+  /**
+   * @brief Apply the filter at given positions, and pass each position and value to some function.
+   * 
+   * This default implementation filters each pixel independently.
+   * Child classes can shadow it with a batched implementation.
+   */
+  template <typename TIn, typename TPositions, typename TFunc>
+  void transform_at_impl(const TIn& in, const TPositions& positions, TFunc&& func) const
+  {
+    for (const auto& p : positions) {
+      func(p, (*this) * in(p));
+    }
+  }
+
+  /**
+   * @brief Call `transform_impl()`, with rasters of variable dimension viewed in fixed dimension.
+   *
+   * If the output is a raster of variable dimension, it is dispatched with `dispatch_dimension()`,
+   * and the input (raster or extrapolated raster) is viewed in the same dimension,
+   * such that the filter is instantiated with `Position<N>` instead of `Position<-1>`.
+   */
+  template <typename TIn, typename TOut, typename... TArgs>
+  void transform_fixed_dimension(const TIn& in, TOut& out, const TArgs&... args) const
+  {
+    if constexpr (Internal::IsVariableRaster<TOut>::value) {
+      dispatch_dimension<std::max<Index>(Dimension, 1)>(out, [&](auto& o) {
+        constexpr Index M = std::decay_t<decltype(o)>::Dimension;
+        if constexpr (M == -1) {
+          LINX_CRTP_CONST_DERIVED.transform_impl(in, o, args...);
+        } else {
+          Internal::with_dimension<M>(in, [&](const auto& i) {
+            LINX_CRTP_CONST_DERIVED.transform_impl(i, o, args...);
+          });
+        }
+      });
+    } else {
+      LINX_CRTP_CONST_DERIVED.transform_impl(in, out, args...);
+    }
+  }
 };
 
 /**
@@ -59,6 +59,21 @@ BOOST_AUTO_TEST_CASE(release_reset_test)
   BOOST_TEST(not owner.begin());
 }
 
+BOOST_AUTO_TEST_CASE(memory_options_test)
+{
+  MemoryOptions options;
+  options.page_size = MemoryOptions::huge_page;
+  options.interleave = true;
+  options.first_touch = Threads(4);
+  AlignedBuffer<float> buffer(1000000, options);
+  BOOST_TEST(buffer.owns());
+  BOOST_TEST(buffer.alignment_req() == MemoryOptions::huge_page);
+  BOOST_TEST(buffer.alignment() % MemoryOptions::huge_page == 0);
+  BOOST_TEST((std::all_of(buffer.begin(), buffer.end(), [](auto e) {
+    return e == 0;
+  })));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#define LINX_TRACK_ALLOCATIONS
+
+#include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Base/AllocationStats.h"
+#include "Linx/Base/Holders.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(AllocationStats_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(std_holder_test)
+{
+  BOOST_TEST(AllocationStats::enabled());
+  AllocationScope::reset();
+  {
+    AllocationScope scope("std");
+    StdHolder<std::vector<float>> a(100);
+    auto b = a;
+    auto c = std::move(b);
+    const auto stats = AllocationScope::stats("std");
+    BOOST_TEST(stats.allocations == 2);
+    BOOST_TEST(stats.allocated_bytes == 800);
+    BOOST_TEST(stats.copies == 1);
+    BOOST_TEST(stats.copied_bytes == 400);
+    BOOST_TEST(stats.live_bytes() == 800);
+  }
+  const auto stats = AllocationScope::stats("std");
+  BOOST_TEST(stats.deallocations == 2);
+  BOOST_TEST(stats.live_bytes() == 0);
+  BOOST_TEST(stats.peak_bytes == 800);
+  BOOST_TEST(AllocationScope::total().live_bytes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(nested_scopes_test)
+{
+  AllocationScope::reset();
+  {
+    AllocationScope outer("outer");
+    AlignedBuffer<double> a(10);
+    {
+      AllocationScope inner("inner");
+      StdHolder<std::unique_ptr<int[]>> b(5);
+      auto c = b;
+    }
+  }
+  const auto outer = AllocationScope::stats("outer");
+  const auto inner = AllocationScope::stats("inner");
+  BOOST_TEST(outer.allocations == 3);
+  BOOST_TEST(outer.allocated_bytes == 120);
+  BOOST_TEST(outer.peak_bytes == 120);
+  BOOST_TEST(inner.allocations == 2);
+  BOOST_TEST(inner.allocated_bytes == 40);
+  BOOST_TEST(inner.copies == 1);
+  BOOST_TEST(AllocationScope::report().size() >= 2);
+  BOOST_TEST(AllocationScope::stats("unknown").allocations == 0);
+}
+
+BOOST_AUTO_TEST_CASE(move_to_test)
+{
+  AllocationScope::reset();
+  std::vector<int> data;
+  {
+    AllocationScope scope("move");
+    StdHolder<std::vector<int>> a(3);
+    a.move_to(data);
+  }
+  const auto stats = AllocationScope::stats("move");
+  BOOST_TEST(stats.allocations == 1);
+  BOOST_TEST(stats.deallocations == 1); // Not owned anymore
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
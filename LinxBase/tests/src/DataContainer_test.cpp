@@ -6,6 +6,7 @@
 #include "Linx/Data/Sequence.h"
 
 #include <boost/test/unit_test.hpp>
+#include <numeric>
 #include <sstream>
 
 using namespace Linx;
@@ -71,6 +72,72 @@ BOOST_AUTO_TEST_CASE(singleton_contains_nan_test)
   BOOST_TEST(container.contains_nan());
 }
 
+BOOST_AUTO_TEST_CASE(parallel_generate_apply_test)
+{
+  Sequence<float> a(1000);
+  a.range();
+  Sequence<float> b(1000);
+  b.fill(2);
+  Sequence<float> sequential(1000);
+  sequential.generate(
+      [](auto v, auto w) {
+        return v * w;
+      },
+      a,
+      b);
+  Sequence<float> parallel(1000);
+  parallel.generate(
+      Threads(4),
+      [](auto v, auto w) {
+        return v * w;
+      },
+      a,
+      b);
+  BOOST_TEST(parallel == sequential);
+  const Threads threads(3);
+  parallel.apply(
+      threads,
+      [](auto v, auto w) {
+        return v - w;
+      },
+      a);
+  BOOST_TEST(parallel == a);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_reduction_test)
+{
+  constexpr Index size = 100000;
+  Sequence<double> a(size);
+  a.generate([]() {
+    static double x = 0;
+    return x += 0.1;
+  });
+  a[size / 2] = -1;
+  a[size / 3] = 1e9;
+  a[size / 4] = 1e9;
+  Sequence<double> b(size);
+  b.fill(2);
+
+  const auto sequential_sum = sum(a);
+  BOOST_TEST(sum(a, Threads(3)) == sequential_sum); // Exactly
+  BOOST_TEST(sum(a, Threads(4)) == sequential_sum);
+  BOOST_TEST(sequential_sum == std::accumulate(a.begin(), a.end(), 0.), boost::test_tools::tolerance(1e-12));
+
+  BOOST_TEST(norm<1>(a, Threads(4)) == norm<1>(a));
+  BOOST_TEST(norm<2>(a, Threads(4)) == norm<2>(a));
+  BOOST_TEST(distance<1>(a, b, Threads(4)) == distance<1>(a, b));
+  BOOST_TEST(dot(a, b, Threads(4)) == dot(a, b));
+  BOOST_TEST(dot(a, b) == 2 * sequential_sum, boost::test_tools::tolerance(1e-12));
+
+  BOOST_TEST(&min(a, Threads(4)) == &a[size / 2]);
+  BOOST_TEST(&max(a, Threads(4)) == &a[size / 4]); // First max
+  const auto parallel = minmax(a, Threads(4));
+  const auto sequential = minmax(a);
+  BOOST_TEST(&parallel.first == &sequential.first);
+  BOOST_TEST(&parallel.second == &sequential.second); // Last max
+  BOOST_TEST(&parallel.second == &a[size / 3]);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
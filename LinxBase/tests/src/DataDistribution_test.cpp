@@ -2,6 +2,7 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Base/Random.h"
 #include "Linx/Base/mixins/DataContainer.h"
 
 #include <boost/test/unit_test.hpp>
@@ -49,6 +50,39 @@ BOOST_AUTO_TEST_CASE(robust_test)
   BOOST_TEST(dist.mad() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(interpolated_quantile_test)
+{
+  MinimalDataContainer<double> data {9, 3, 0, 7, 1, 8, 4, 2, 6, 5};
+  BOOST_TEST(distribution(data).quantile(.25) == 2.25, boost::test_tools::tolerance(1.e-12));
+  BOOST_TEST(distribution(data).quantile(.7) == 6.3, boost::test_tools::tolerance(1.e-12));
+}
+
+BOOST_AUTO_TEST_CASE(multi_quantiles_test)
+{
+  MinimalDataContainer<int> data(1001);
+  data.generate(UniformNoise<int>(-1000, 1000, 42));
+  const std::vector<double> qs {.9, .1, .5, 0, 1, .25, .123, .75};
+  auto dist = distribution(data);
+  const auto out = dist.quantiles(qs);
+  BOOST_TEST(out.size() == qs.size());
+  for (std::size_t i = 0; i < qs.size(); ++i) {
+    auto expected = distribution(data);
+    expected.sort();
+    BOOST_TEST(out[i] == expected.quantile(qs[i]), boost::test_tools::tolerance(1.e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(inplace_test)
+{
+  std::vector<int> buffer {2, 1, 9, 4, 1, 2, 6};
+  DataDistribution<int> dist(buffer.data(), buffer.data() + buffer.size());
+  BOOST_TEST(dist.size() == 7);
+  BOOST_TEST(dist.median() == 2);
+  BOOST_TEST(dist.mad() == 1);
+  BOOST_TEST(buffer[3] == 2); // Partitioned in place
+  BOOST_TEST(dist.mad() == 1);
+}
+
 BOOST_AUTO_TEST_CASE(histogram_test)
 {
   MinimalDataContainer<int> data(10);
@@ -0,0 +1,93 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Expression.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Expression_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(calibration_test)
+{
+  const Position<2> shape {4, 3};
+  Raster<float> raw(shape);
+  raw.range(10);
+  Raster<float> bias(shape);
+  bias.fill(1);
+  Raster<float> dark(shape);
+  dark.range();
+  Raster<float> flat(shape);
+  flat.fill(2);
+  const double t = 0.5;
+
+  const auto expected = (raw - bias - dark * t) / flat;
+  Raster<float> out(shape);
+  out = (lazy(raw) - bias - lazy(dark) * t) / flat;
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(scalar_and_unary_test)
+{
+  Raster<int> in({3, 2});
+  in.range(1);
+  Raster<int> out(in.shape());
+  out = 10 - lazy(in) * 2 % 3;
+  out = -lazy(out) + 1;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(out[i] == -(10 - in[i] * 2 % 3) + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(math_functions_test)
+{
+  Raster<double, 1> in({5});
+  in.range(1);
+  const auto expression = sqrt(exp(lazy(in)) + pow(lazy(in), 2));
+  const Raster<double, 1> out(in.shape(), expression);
+  auto expected = exp(in) + pow(in, 2);
+  expected.sqrt();
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(patch_evaluate_test)
+{
+  Raster<int> in({4, 4});
+  in.range();
+  Raster<int> out(in.shape());
+  out.fill(-1);
+  const Box<2> box({1, 1}, {2, 2});
+  const auto patch = in(box);
+  auto out_patch = out(box);
+  (lazy(patch) * 2).evaluate(out_patch);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == (box.contains(p) ? in[p] * 2 : -1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(size_mismatch_test)
+{
+  Raster<int> large({4, 4});
+  large.range();
+  Raster<int> small({2, 2});
+  small.fill(-1);
+  BOOST_TEST((lazy(large) * 2).size() == large.size());
+  BOOST_TEST((lazy(large) + lazy(small)).size() == small.size());
+  BOOST_CHECK_THROW(small = lazy(large) * 2, SizeError);
+  BOOST_CHECK_THROW(large = lazy(small) + 1, SizeError);
+  BOOST_CHECK_THROW((lazy(large) * 2).evaluate(small), SizeError);
+  for (const auto& e : small) {
+    BOOST_TEST(e == -1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/FastMath.h"
+#include "Linx/Data/Sequence.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+
+using namespace Linx;
+
+template <typename T, typename TFast, typename TStd>
+double max_relative_error(T front, T back, Index count, TFast&& fast, TStd&& ref)
+{
+  double out = 0;
+  for (Index i = 0; i < count; ++i) {
+    const T x = front + (back - front) * i / (count - 1);
+    const double expected = ref(x);
+    const double error = std::abs(fast(x) - expected) / std::max(std::abs(expected), 1.);
+    out = std::max(out, error / std::numeric_limits<T>::epsilon());
+  }
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FastMath_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(exp_accuracy_test)
+{
+  auto fast_d = [](double x) {
+    return fast_exp(x);
+  };
+  auto std_d = [](double x) {
+    return std::exp(x);
+  };
+  auto fast_f = [](float x) {
+    return fast_exp(x);
+  };
+  auto std_f = [](float x) {
+    return std::exp(x);
+  };
+  BOOST_TEST(max_relative_error(-700., 709., 100000, fast_d, std_d) < 4);
+  BOOST_TEST(max_relative_error(-87.f, 88.f, 100000, fast_f, std_f) < 4);
+}
+
+BOOST_AUTO_TEST_CASE(log_accuracy_test)
+{
+  auto fast_d = [](double x) {
+    return fast_log(x);
+  };
+  auto std_d = [](double x) {
+    return std::log(x);
+  };
+  auto fast_f = [](float x) {
+    return fast_log(x);
+  };
+  auto std_f = [](float x) {
+    return std::log(x);
+  };
+  BOOST_TEST(max_relative_error(1e-300, 1e300, 100000, fast_d, std_d) < 2);
+  BOOST_TEST(max_relative_error(0.5, 2., 100000, fast_d, std_d) < 2);
+  BOOST_TEST(max_relative_error(1e-37f, 1e37f, 100000, fast_f, std_f) < 2);
+  BOOST_TEST(max_relative_error(0.5f, 2.f, 100000, fast_f, std_f) < 2);
+}
+
+BOOST_AUTO_TEST_CASE(special_values_test)
+{
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  BOOST_TEST(fast_exp(0.) == 1.);
+  BOOST_TEST(fast_exp(1000.) == inf);
+  BOOST_TEST(fast_exp(-1000.) == 0.);
+  BOOST_TEST(fast_exp(-inf) == 0.);
+  BOOST_TEST(std::isnan(fast_exp(std::nan(""))));
+  BOOST_TEST(fast_log(1.) == 0.);
+  BOOST_TEST(fast_log(0.) == -inf);
+  BOOST_TEST(fast_log(inf) == inf);
+  BOOST_TEST(std::isnan(fast_log(-1.)));
+  BOOST_TEST(std::isnan(fast_log(std::nan(""))));
+  BOOST_TEST(fast_log(5e-324) == std::log(5e-324));
+}
+
+BOOST_AUTO_TEST_CASE(container_test)
+{
+  Sequence<float> in {0.5f, 1.f, 2.f, 4.f};
+  const auto exp = fast_exp(in);
+  const auto log = fast_log(in);
+  const auto pow = fast_pow(in, 3);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(exp[i] == std::exp(in[i]), boost::test_tools::tolerance(1e-6f));
+    BOOST_TEST(log[i] == std::log(in[i]), boost::test_tools::tolerance(1e-6f));
+    BOOST_TEST(pow[i] == std::pow(in[i], 3.f), boost::test_tools::tolerance(1e-6f));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Histogram.h"
+#include "Linx/Base/Random.h"
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <limits>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Histogram_test)
+
+//-----------------------------------------------------------------------------
+
+template <typename TRange>
+std::vector<std::size_t> naive_histogram(const TRange& values, const std::vector<double>& bins)
+{
+  std::vector<std::size_t> out(bins.size() - 1, 0);
+  for (const auto& v : values) {
+    for (std::size_t b = 0; b + 1 < bins.size(); ++b) {
+      if (v >= bins[b] && (v < bins[b + 1] || (b + 2 == bins.size() && v == bins[b + 1]))) {
+        ++out[b];
+        break;
+      }
+    }
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(small_uniform_histogram_test)
+{
+  const std::vector<double> values {-1, 0, 0.5, 1, 2.5, 3.9, 4, 4.5, 10};
+  const auto h = uniform_histogram(values, 0, 4, 4);
+  const std::vector<std::size_t> expected {2, 1, 1, 2};
+  BOOST_TEST(h == expected);
+}
+
+BOOST_AUTO_TEST_CASE(small_sorted_histogram_test)
+{
+  const std::vector<double> values {-1, 0, 0.5, 1, 2.5, 3.9, 4, 4.5, 10};
+  const std::vector<double> bins {0, 1, 3, 4};
+  const auto h = histogram(values, bins);
+  const std::vector<std::size_t> expected {2, 2, 2};
+  BOOST_TEST(h == expected);
+}
+
+BOOST_AUTO_TEST_CASE(non_finite_histogram_test)
+{
+  const auto inf = std::numeric_limits<double>::infinity();
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<double> values {inf, -inf, nan, 1e30, -1e30, 0.5, 3.5};
+  const std::vector<std::size_t> expected {1, 0, 0, 1};
+  BOOST_TEST(uniform_histogram(values, 0, 4, 4) == expected);
+  BOOST_TEST(uniform_histogram(values, 0, 4, 4, Threads(2)) == expected);
+  BOOST_TEST(histogram(values, std::vector<double> {0, 1, 3, 4}) == (std::vector<std::size_t> {1, 0, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(uniform_histogram_threads_test)
+{
+  MinimalDataContainer<float> data(100000);
+  data.generate(GaussianNoise<float>(0, 1, 42));
+  std::vector<double> bins;
+  for (Index b = 0; b <= 20; ++b) {
+    bins.push_back(-2.5 + .25 * b);
+  }
+  const auto expected = naive_histogram(data, bins);
+  BOOST_TEST(uniform_histogram(data, -2.5, 2.5, 20) == expected);
+  BOOST_TEST(uniform_histogram(data, -2.5, 2.5, 20, Threads(4)) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(sorted_histogram_threads_test)
+{
+  MinimalDataContainer<double> data(100000);
+  data.generate(GaussianNoise<double>(0, 1, 42));
+  const std::vector<double> bins {-3, -2, -1.5, -1, -.5, -.1, 0, .1, .5, 2, 4};
+  const auto expected = naive_histogram(data, bins);
+  BOOST_TEST(histogram(data, bins) == expected);
+  BOOST_TEST(histogram(data, bins, Threads(3)) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(full_histogram_test)
+{
+  MinimalDataContainer<std::uint16_t> data(100000);
+  data.generate(UniformNoise<std::uint16_t>(0, 65535, 42));
+  std::vector<std::size_t> expected(65536, 0);
+  for (const auto& v : data) {
+    ++expected[v];
+  }
+  BOOST_TEST(full_histogram(data) == expected);
+  BOOST_TEST(full_histogram(data, Threads(4)) == expected);
+  const std::vector<std::int8_t> signed_values {-128, -1, 0, 0, 127};
+  const auto h = full_histogram(signed_values);
+  BOOST_TEST(h.size() == 256);
+  BOOST_TEST(h[0] == 1);
+  BOOST_TEST(h[127] == 1);
+  BOOST_TEST(h[128] == 2);
+  BOOST_TEST(h[255] == 1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,38 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/MemoryBudget.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MemoryBudget_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(unlimited_test)
+{
+  BOOST_TEST(MemoryBudget::limit() == 0);
+  BOOST_TEST(MemoryBudget::thickness(1000, 42) == 42);
+}
+
+BOOST_AUTO_TEST_CASE(scoped_limit_test)
+{
+  {
+    MemoryBudget::Limit guard(10000);
+    BOOST_TEST(MemoryBudget::limit() == 10000);
+    BOOST_TEST(MemoryBudget::thickness(1000, 42) == 10);
+    BOOST_TEST(MemoryBudget::thickness(1000, 42, 2) == 5);
+    BOOST_TEST(MemoryBudget::thickness(1000, 3) == 3);
+    BOOST_TEST(MemoryBudget::thickness(100000, 42) == 1);
+  }
+  BOOST_TEST(MemoryBudget::limit() == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/OnlineDistribution.h"
+#include "Linx/Base/Random.h"
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(OnlineDistribution_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(moments_test)
+{
+  MinimalDataContainer<double> data(1001);
+  data.generate(GaussianNoise<double>(1.e6, 3., 42));
+  OnlineDistribution<double> online;
+  online.push(data);
+  auto exact = distribution(data);
+  BOOST_TEST(online.size() == exact.size());
+  BOOST_TEST(online.min() == exact.min());
+  BOOST_TEST(online.max() == exact.max());
+  BOOST_TEST(online.sum() == exact.sum(), boost::test_tools::tolerance(1.e-12));
+  BOOST_TEST(online.mean() == exact.mean(), boost::test_tools::tolerance(1.e-12));
+  double m2 = 0; // Two-pass reference, since the mean is large
+  for (const auto& e : data) {
+    m2 += (e - exact.mean()) * (e - exact.mean());
+  }
+  BOOST_TEST(online.variance() == m2 / 1000, boost::test_tools::tolerance(1.e-9));
+  BOOST_TEST(online.variance(false) == m2 / 1001, boost::test_tools::tolerance(1.e-9));
+}
+
+BOOST_AUTO_TEST_CASE(small_quantiles_test)
+{
+  MinimalDataContainer<double> data(51);
+  data.range();
+  OnlineDistribution<double> online;
+  online.push(data);
+  BOOST_TEST(online.centroid_count() == 51);
+  BOOST_TEST(online.quantile(0) == 0);
+  BOOST_TEST(online.quantile(1) == 50);
+  BOOST_TEST(online.median() == 25, boost::test_tools::tolerance(1.e-12));
+}
+
+BOOST_AUTO_TEST_CASE(large_quantiles_test)
+{
+  constexpr Index size = 200000;
+  MinimalDataContainer<double> data(size);
+  data.generate(UniformNoise<double>(0, 1, 42));
+  OnlineDistribution<double> online;
+  online.push(data);
+  BOOST_TEST(online.centroid_count() <= 100);
+  auto exact = distribution(data);
+  for (double q : {.001, .01, .1, .25, .5, .75, .9, .99, .999}) {
+    BOOST_TEST(std::abs(online.quantile(q) - exact.quantile(q)) < .01 * std::sqrt(q * (1 - q)) + 1.e-4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(degenerate_test)
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  OnlineDistribution<float> online;
+  BOOST_TEST(std::isnan(online.variance()));
+  BOOST_TEST(std::isnan(online.variance(false)));
+  online.push(nan);
+  BOOST_TEST(online.size() == 0);
+  online.push(2);
+  BOOST_TEST(std::isnan(online.variance()));
+  BOOST_TEST(online.variance(false) == 0);
+  for (int i = 0; i < 1000; ++i) { // Trigger compression
+    online.push(i % 2 ? nan : float(i));
+  }
+  BOOST_TEST(online.size() == 501);
+  BOOST_TEST(online.max() == 998);
+  BOOST_TEST(not std::isnan(online.mean()));
+  BOOST_TEST(not std::isnan(online.median()));
+}
+
+BOOST_AUTO_TEST_CASE(merge_test)
+{
+  constexpr Index size = 100000;
+  MinimalDataContainer<float> data(size);
+  data.generate(GaussianNoise<float>(10, 2, 42));
+  OnlineDistribution<float> sequential;
+  sequential.push(data);
+  for (Index t : {1, 3, 8}) {
+    auto parallel = online_distribution(data, Threads(t));
+    BOOST_TEST(parallel.size() == sequential.size());
+    BOOST_TEST(parallel.min() == sequential.min());
+    BOOST_TEST(parallel.max() == sequential.max());
+    BOOST_TEST(parallel.mean() == sequential.mean(), boost::test_tools::tolerance(1.e-9));
+    BOOST_TEST(parallel.variance() == sequential.variance(), boost::test_tools::tolerance(1.e-9));
+    BOOST_TEST(std::abs(parallel.median() - sequential.median()) < .02);
+    BOOST_TEST(std::abs(parallel.quantile(.99) - sequential.quantile(.99)) < .05);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Pool.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Pool_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(same_shape_is_recycled_test)
+{
+  auto& pool = BlockPool::local();
+  pool.clear();
+  const float* data = nullptr;
+  {
+    PoolRaster<float> raster({16, 8});
+    raster.fill(1);
+    data = raster.data();
+  }
+  BOOST_TEST(pool.cached() >= 16 * 8 * sizeof(float));
+  PoolRaster<float> raster({8, 16});
+  BOOST_TEST(raster.data() == data);
+  BOOST_TEST(pool.cached() == 0);
+  BOOST_TEST(is_aligned(raster.data(), BlockPool::alignment));
+}
+
+BOOST_AUTO_TEST_CASE(copy_move_test)
+{
+  PoolRaster<int> raster({3, 2});
+  raster.range();
+  const auto copy = raster;
+  BOOST_TEST(copy.data() != raster.data());
+  BOOST_TEST(copy == raster);
+  const auto* data = raster.data();
+  const auto moved = std::move(raster);
+  BOOST_TEST(moved.data() == data);
+  BOOST_TEST(moved == copy);
+}
+
+BOOST_AUTO_TEST_CASE(capacity_test)
+{
+  auto& pool = BlockPool::local();
+  pool.clear();
+  const auto capacity = pool.capacity();
+  pool.capacity(0);
+  {
+    PoolRaster<float> raster({16, 16});
+  }
+  BOOST_TEST(pool.cached() == 0);
+  pool.capacity(capacity);
+}
+
+BOOST_AUTO_TEST_CASE(arena_scope_test)
+{
+  Arena arena(1024);
+  {
+    Arena::Scope scope(arena);
+    ArenaRaster<float> a({8, 8});
+    BOOST_TEST(arena.used() == 8 * 8 * sizeof(float));
+    {
+      Arena::Scope nested(arena);
+      ArenaRaster<float> b({4, 4});
+      BOOST_TEST(arena.used() == 8 * 8 * sizeof(float) + 64);
+    }
+    BOOST_TEST(arena.used() == 8 * 8 * sizeof(float));
+    ArenaRaster<float> c({32, 32}); // Too large, falls back to the pool
+    BOOST_TEST(arena.used() == 8 * 8 * sizeof(float));
+    c.fill(1);
+  }
+  BOOST_TEST(arena.used() == 0);
+  BOOST_TEST(not Arena::current());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include "Linx/Base/Random.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath> // abs, floor, sqrt
 
 using namespace Linx;
 
@@ -124,6 +125,166 @@ BOOST_AUTO_TEST_CASE(reproducible_poisson_test)
   BOOST_TEST(sequence_a[2] == sequence_b[2]);
 }
 
+BOOST_AUTO_TEST_CASE(stable_poisson_statistics_test)
+{
+  for (double mean : {.5, 3., 9.9, 10., 42., 1000., 1.e6}) {
+    StablePoissonNoise<double> noise(0, 42);
+    constexpr Index count = 20000;
+    double sum = 0;
+    double sum2 = 0;
+    for (Index i = 0; i < count; ++i) {
+      const auto v = noise(mean);
+      BOOST_TEST(v >= 0);
+      BOOST_TEST(v == std::floor(v));
+      sum += v;
+      sum2 += v * v;
+    }
+    const auto m = sum / count;
+    const auto var = sum2 / count - m * m;
+    BOOST_TEST(std::abs(m - mean) < 5 * std::sqrt(mean / count));
+    BOOST_TEST(std::abs(var / mean - 1) < .05);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stable_poisson_counter_test)
+{
+  StablePoissonNoise<int> noise(0, 7);
+  const StablePoissonNoise<int> counter(0, 7);
+  for (std::size_t i = 0; i < 10; ++i) {
+    BOOST_TEST(noise(100 * i) == counter.at(i, 100 * i));
+  }
+  MinimalDataContainer<int> sequential(1000);
+  sequential.range(0, 100);
+  auto parallel = sequential;
+  sequential.apply(StablePoissonNoise<int>(0, 7));
+  parallel.apply(Threads(4), StablePoissonNoise<int>(0, 7));
+  BOOST_TEST(parallel == sequential);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_impulse_test)
+{
+  constexpr Index size = 1000000;
+  MinimalDataContainer<int> data(size);
+  data.fill(1);
+  auto noise = ImpulseNoise<int>::salt_and_pepper(.001, .002, 100, 0, 42);
+  noise.apply_sparse(data);
+  Index salt = 0;
+  Index pepper = 0;
+  for (const auto& e : data) {
+    salt += e == 100;
+    pepper += e == 0;
+    BOOST_TEST((e == 1 || e == 100 || e == 0));
+  }
+  BOOST_TEST(std::abs(salt - 1000) < 5 * std::sqrt(1000.));
+  BOOST_TEST(std::abs(pepper - 2000) < 5 * std::sqrt(2000.));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_impulse_bounds_test)
+{
+  MinimalDataContainer<int> data(100);
+  data.fill(1);
+  ImpulseNoise<int>(7, 0., 42).apply_sparse(data);
+  for (const auto& e : data) {
+    BOOST_TEST(e == 1);
+  }
+  ImpulseNoise<int>(7, 1., 42).apply_sparse(data);
+  for (const auto& e : data) {
+    BOOST_TEST(e == 7);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(philox_known_answer_test)
+{
+  const auto zero = PhiloxEngine::block({0, 0, 0, 0}, {0, 0});
+  BOOST_TEST((zero == PhiloxEngine::Block {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  const auto ones = PhiloxEngine::block({~0u, ~0u, ~0u, ~0u}, {~0u, ~0u});
+  BOOST_TEST((ones == PhiloxEngine::Block {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  const auto pi = PhiloxEngine::block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+  BOOST_TEST((pi == PhiloxEngine::Block {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+BOOST_AUTO_TEST_CASE(philox_stream_test)
+{
+  PhiloxEngine engine(42, 7);
+  const auto first = PhiloxEngine::block({7, 0, 0, 0}, {42, 0});
+  const auto second = PhiloxEngine::block({7, 0, 1, 0}, {42, 0});
+  for (auto e : first) {
+    BOOST_TEST(engine() == e);
+  }
+  for (auto e : second) {
+    BOOST_TEST(engine() == e);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(counter_based_thread_count_test)
+{
+  const GaussianNoise<float> noise(10, 2, 42);
+  MinimalDataContainer<float> sequential(1000);
+  sequential.generate(noise);
+  for (Index t : {1, 3, 8}) {
+    MinimalDataContainer<float> parallel(1000);
+    parallel.generate(Threads(t), noise);
+    BOOST_TEST(parallel == sequential);
+  }
+  for (std::size_t i = 0; i < 1000; i += 100) {
+    BOOST_TEST(sequential[i] == noise.at(i));
+  }
+  MinimalDataContainer<float> other(1000);
+  other.generate(GaussianNoise<float>(10, 2, 43));
+  BOOST_TEST(other != sequential);
+}
+
+BOOST_AUTO_TEST_CASE(counter_based_gaussian_statistics_test)
+{
+  const GaussianNoise<std::complex<double>> noise({10, -5}, {2, 3}, 42);
+  constexpr Index count = 100000;
+  std::complex<double> sum {};
+  double sum2_re = 0;
+  double sum2_im = 0;
+  double sum_cross = 0;
+  for (Index i = 0; i < count; ++i) {
+    const auto v = noise.at(i) - std::complex<double>(10, -5);
+    sum += v;
+    sum2_re += v.real() * v.real();
+    sum2_im += v.imag() * v.imag();
+    sum_cross += v.real() * v.imag();
+  }
+  BOOST_TEST(std::abs(sum.real() / count) < 5 * 2 / std::sqrt(count));
+  BOOST_TEST(std::abs(sum.imag() / count) < 5 * 3 / std::sqrt(count));
+  BOOST_TEST(std::abs(sum2_re / count / 4 - 1) < .02);
+  BOOST_TEST(std::abs(sum2_im / count / 9 - 1) < .02);
+  BOOST_TEST(std::abs(sum_cross / count / 6) < .02);
+}
+
+BOOST_AUTO_TEST_CASE(counter_based_apply_test)
+{
+  MinimalDataContainer<int> in(100);
+  in.range(10, 10);
+  auto sequential = in;
+  sequential.apply(PoissonNoise<int>(0, 42));
+  auto parallel = in;
+  parallel.apply(Threads(4), PoissonNoise<int>(0, 42));
+  BOOST_TEST(parallel == sequential);
+  BOOST_TEST(parallel != in);
+}
+
+BOOST_AUTO_TEST_CASE(counter_based_successive_frames_test)
+{
+  GaussianNoise<float> noise(10, 2, 42);
+  MinimalDataContainer<float> first(1000);
+  MinimalDataContainer<float> second(1000);
+  first.generate(noise);
+  second.generate(noise);
+  BOOST_TEST(second != first);
+  GaussianNoise<float> parallel_noise(10, 2, 42);
+  MinimalDataContainer<float> parallel_first(1000);
+  MinimalDataContainer<float> parallel_second(1000);
+  parallel_first.generate(Threads(3), parallel_noise);
+  parallel_second.generate(Threads(3), parallel_noise);
+  BOOST_TEST(parallel_first == first);
+  BOOST_TEST(parallel_second == second);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
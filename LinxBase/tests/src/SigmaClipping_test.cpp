@@ -0,0 +1,72 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Base/SigmaClipping.h"
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SigmaClipping_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(no_outlier_test)
+{
+  MinimalDataContainer<double> data {1, 2, 3, 4, 5};
+  SigmaClipping<double> clipping;
+  clipping.clip(data);
+  BOOST_TEST(clipping.size() == 5);
+  BOOST_TEST(clipping.iterations() == 1);
+  BOOST_TEST(clipping.mean() == 3);
+  BOOST_TEST(clipping.median() == 3);
+  BOOST_TEST(clipping.stdev() == std::sqrt(2.5));
+}
+
+BOOST_AUTO_TEST_CASE(outliers_test)
+{
+  constexpr Index size = 100000;
+  MinimalDataContainer<float> data(size);
+  data.generate(GaussianNoise<float>(100, 5, 42));
+  for (Index i = 0; i < size; i += 100) {
+    data[i] = 10000; // Cosmic rays
+  }
+  SigmaClipping<float> clipping(3, 10);
+  clipping.clip(data);
+  BOOST_TEST(clipping.size() < size - size / 100);
+  BOOST_TEST(std::abs(clipping.median() - 100) < .1);
+  BOOST_TEST(std::abs(clipping.mean() - 100) < .1);
+  BOOST_TEST(std::abs(clipping.stdev() - 5) < .2);
+  for (Index t : {2, 5}) {
+    SigmaClipping<float> parallel(3, 10);
+    parallel.clip(data, Threads(t));
+    BOOST_TEST(parallel.size() == clipping.size());
+    BOOST_TEST(parallel.iterations() == clipping.iterations());
+    BOOST_TEST(parallel.median() == clipping.median());
+    BOOST_TEST(parallel.mean() == clipping.mean(), boost::test_tools::tolerance(1.e-6f));
+    BOOST_TEST(parallel.stdev() == clipping.stdev(), boost::test_tools::tolerance(1.e-5f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(masked_inplace_test)
+{
+  MinimalDataContainer<int> data {1, 2, 3, 1000, 4, 5, -1000};
+  MinimalDataContainer<char> mask {1, 1, 1, 0, 1, 1, 0};
+  SigmaClipping<int> clipping(3, 5, SigmaClipping<int>::Center::Mean);
+  clipping.clip_masked(data, mask);
+  BOOST_TEST(clipping.size() == 5);
+  BOOST_TEST(clipping.mean() == 3);
+  std::vector<int> buffer {1, 2, 3, 1000, 4, 5, 3, 2, 4, 3, 2, 4, 3};
+  SigmaClipping<int>(2).clip_inplace(buffer.data(), buffer.data() + buffer.size());
+  BOOST_TEST(*std::max_element(buffer.begin(), buffer.begin() + 12) == 5);
+  BOOST_TEST(buffer.back() == 1000);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
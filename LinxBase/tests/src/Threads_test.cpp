@@ -0,0 +1,78 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Threads.h"
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Threads_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(count_test)
+{
+  BOOST_TEST(Threads().count() >= 1);
+#ifdef _OPENMP
+  BOOST_TEST(Threads(3).count() == 3);
+#else
+  BOOST_TEST(Threads(3).count() == 1);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(limit_test)
+{
+  BOOST_TEST(Threads::limit() == 0);
+  Threads::limit(2);
+  BOOST_TEST(Threads(3).count() <= 2);
+  {
+    Threads::Limit guard(1);
+    BOOST_TEST(Threads::limit() == 1);
+    BOOST_TEST(Threads(3).count() == 1);
+  }
+  BOOST_TEST(Threads::limit() == 2);
+  Threads::limit(0);
+  BOOST_TEST(Threads::limit() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_limit_test)
+{
+  Threads::Limit outer(3);
+  Index other = -1;
+  std::thread thread([&]() {
+    Threads::Limit guard(1);
+    {
+      Threads::Limit nested(0);
+      BOOST_TEST(Threads::limit() == 0);
+    }
+    other = Threads::limit();
+  });
+  thread.join();
+  BOOST_TEST(other == 1);
+  BOOST_TEST(Threads::limit() == 3); // Not overwritten by the other thread
+  Threads::limit(2);
+  BOOST_TEST(Threads::limit() == 3); // Scoped limit prevails
+  Threads::limit(0);
+}
+
+#ifdef _OPENMP
+BOOST_AUTO_TEST_CASE(nested_test)
+{
+  int nested = 0;
+#pragma omp parallel num_threads(2)
+  {
+#pragma omp single
+    nested = Threads(3).count();
+  }
+  BOOST_TEST(nested == 1);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#define LINX_TRACE
+
+#include "Linx/Base/Trace.h"
+
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Trace_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(nested_scopes_test)
+{
+  BOOST_TEST(Trace::enabled());
+  Trace::clear();
+  {
+    LINX_TRACE_SCOPE("outer");
+    {
+      LINX_TRACE_SCOPE("inner");
+    }
+  }
+  const auto events = Trace::events();
+  BOOST_TEST(events.size() == 2);
+  BOOST_TEST(std::string(events[0].name) == "inner");
+  BOOST_TEST(std::string(events[1].name) == "outer");
+  BOOST_TEST(events[1].start_ns <= events[0].start_ns);
+  BOOST_TEST(events[0].stop_ns <= events[1].stop_ns);
+  Trace::clear();
+  BOOST_TEST(Trace::events().empty());
+}
+
+BOOST_AUTO_TEST_CASE(threads_test)
+{
+  Trace::clear();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) {
+    threads.emplace_back([]() {
+      LINX_TRACE_SCOPE("worker");
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const auto events = Trace::events();
+  BOOST_TEST(events.size() == 3);
+  std::set<std::size_t> indices;
+  for (const auto& e : events) {
+    indices.insert(e.thread);
+  }
+  BOOST_TEST(indices.size() == 3);
+  Trace::clear();
+}
+
+BOOST_AUTO_TEST_CASE(write_test)
+{
+  Trace::clear();
+  {
+    LINX_TRACE_SCOPE("written");
+  }
+  std::ostringstream out;
+  Trace::write(out);
+  const auto json = out.str();
+  BOOST_TEST(json.find("traceEvents") != std::string::npos);
+  BOOST_TEST(json.find("\"written\"") != std::string::npos);
+  Trace::clear();
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BitRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+template <Index N>
+Raster<char, N> naive_dilation(const Raster<char, N>& in, Index radius)
+{
+  Raster<char, N> out(in.shape());
+  const auto domain = in.domain();
+  for (const auto& p : domain) {
+    for (const auto& q : Box<N>::from_center(radius, p) & domain) {
+      if (in[q]) {
+        out[p] = 1;
+        break;
+      }
+    }
+  }
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BitRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(conversion_test)
+{
+  Raster<int> raster({70, 3});
+  for (const auto& p : raster.domain()) {
+    raster[p] = (p[0] * p[1]) % 3 == 0;
+  }
+  const BitRaster<2> bits(raster);
+  BOOST_TEST(bits.row_words() == 2);
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(bits[p] == bool(raster[p]));
+  }
+  BOOST_TEST(bits.raster<int>() == raster);
+}
+
+BOOST_AUTO_TEST_CASE(logical_test)
+{
+  BitRaster<2> a({100, 2});
+  BitRaster<2> b({100, 2});
+  a.set({3, 0});
+  a.set({99, 1});
+  b.set({3, 0});
+  b.set({64, 1});
+  BOOST_TEST((a & b).count() == 1);
+  BOOST_TEST((a | b).count() == 3);
+  BOOST_TEST((a ^ b).count() == 2);
+  BOOST_TEST((~a).count() == 198);
+  BOOST_TEST((~~a == a));
+  a.set({3, 0}, false);
+  BOOST_TEST(not(a[{3, 0}]));
+  BOOST_TEST(BitRaster<2>({65, 3}, true).count() == 195);
+}
+
+BOOST_AUTO_TEST_CASE(dilation_erosion_test)
+{
+  Raster<char, 3> raster({150, 7, 5});
+  for (const auto& p : {Position<3> {0, 0, 0}, {63, 3, 2}, {64, 6, 4}, {149, 1, 0}, {100, 3, 3}}) {
+    raster[p] = 1;
+  }
+  for (Index radius : {1, 2, 65}) {
+    BitRaster<3> bits(raster);
+    bits.dilate(radius);
+    BOOST_TEST(bits.raster() == naive_dilation(raster, radius));
+  }
+  BitRaster<3> bits(raster);
+  bits.dilate(2).erode(2);
+  BOOST_TEST(((bits & BitRaster<3>(raster)) == BitRaster<3>(raster))); // Closing is extensive
+  BitRaster<3> full(raster.shape(), true);
+  BOOST_TEST(full.erode(3).count() == full.size()); // Borders are not eroded
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
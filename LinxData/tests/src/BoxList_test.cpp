@@ -0,0 +1,81 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BoxList.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BoxList_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(batched_arithmetic_test)
+{
+  const std::vector<Box<2>> boxes {Box<2>({-2, 1}, {3, 4}), Box<2>({5, 5}, {12, 6}), Box<2>({20, 20}, {21, 21})};
+  BoxList<2> list(boxes);
+  BOOST_TEST(list.size() == 3);
+  BOOST_TEST(list.dimension() == 2);
+  BOOST_TEST(list[1] == boxes[1]);
+
+  const auto margin = Box<2>::from_center(1);
+  const auto translation = Position<2>({1, -1});
+  const Box<2> domain({0, 0}, {9, 9});
+  list += margin;
+  list += translation;
+  list &= domain;
+  for (std::size_t i = 0; i < boxes.size(); ++i) {
+    const auto expected = (boxes[i] + margin + translation) & domain;
+    BOOST_TEST(list[i] == expected);
+  }
+  BOOST_TEST(not list.is_empty(0));
+  BOOST_TEST(list.is_empty(2));
+  BOOST_TEST(list.sizes()[2] == 0);
+  BOOST_TEST(list.sizes()[0] == list[0].size());
+
+  list.erase_empty();
+  BOOST_TEST(list.size() == 2);
+  list -= translation;
+  list -= margin;
+  BOOST_TEST(list[0] == Box<2>({0, 2}, {3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(merge_test)
+{
+  BoxList<2> list;
+  list.push_back(Box<2>({0, 0}, {2, 2}));
+  list.push_back(Box<2>({10, 10}, {12, 12}));
+  list.push_back(Box<2>({2, 2}, {4, 4})); // Overlaps the first one
+  list.push_back(Box<2>({4, 0}, {6, 1})); // Overlaps their bounding box only
+  list.push_back(Box<2>({20, 0}, {19, 0})); // Empty
+  const auto merged = list.merge();
+  BOOST_TEST(merged.size() == 2);
+  BOOST_TEST(merged[0] == Box<2>({0, 0}, {6, 4}));
+  BOOST_TEST(merged[1] == Box<2>({10, 10}, {12, 12}));
+}
+
+BOOST_AUTO_TEST_CASE(coverage_test)
+{
+  BoxList<2> list;
+  list.push_back(Box<2>({0, 0}, {3, 2}));
+  list.push_back(Box<2>({2, 1}, {8, 8}));
+  list.push_back(Box<2>({-5, -5}, {-1, -1})); // Outside
+  const Box<2> domain({1, 0}, {6, 5});
+  const auto coverage = list.coverage(domain);
+  BOOST_TEST(coverage.shape() == domain.shape());
+  for (const auto& p : domain) {
+    Index expected = 0;
+    for (Index i = 0; i < list.size(); ++i) {
+      expected += list[i].contains(p);
+    }
+    BOOST_TEST(coverage[p - domain.front()] == expected);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -50,6 +50,33 @@ BOOST_AUTO_TEST_CASE(translation_test)
   BOOST_TEST(region.front() == back);
 }
 
+BOOST_AUTO_TEST_CASE(split_test)
+{
+  const Box<3> in({1, 2, 3}, {10, 20, 12});
+  const auto parts = split(in, 4);
+  BOOST_TEST(parts.size() == 4);
+  Index size = 0;
+  Index next = in.front()[2];
+  for (const auto& part : parts) {
+    BOOST_TEST(part.front()[2] == next);
+    BOOST_TEST(part.length(2) >= 2);
+    BOOST_TEST(part.length(2) <= 3);
+    BOOST_TEST(part.length(0) == in.length(0));
+    size += part.size();
+    next = part.back()[2] + 1;
+  }
+  BOOST_TEST(next == in.back()[2] + 1);
+  BOOST_TEST(size == in.size());
+
+  const auto thin = split(Box<2>({0, 0}, {99, 1}), 3); // Too short along axis 1
+  BOOST_TEST(thin.size() == 3);
+  BOOST_TEST(thin[0].length(0) == 33);
+  BOOST_TEST(thin[0].length(1) == 2);
+
+  const auto rows = split_along<1>(in, 100);
+  BOOST_TEST(rows.size() == in.length(1));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,76 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Broadcast.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Broadcast_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(row_broadcast_test)
+{
+  Raster<int> frame({4, 3});
+  frame.range();
+  Raster<int, 1> offsets({4});
+  offsets.range();
+  const auto expected = frame;
+  frame += offsets;
+  for (const auto& p : frame.domain()) {
+    BOOST_TEST((frame[p] == expected[p] + offsets[p[0]]));
+  }
+  const auto diff = frame - offsets;
+  BOOST_TEST(diff == expected);
+}
+
+BOOST_AUTO_TEST_CASE(singleton_broadcast_test)
+{
+  Raster<float> frame({5, 3});
+  frame.fill(10);
+  Raster<float> bias({1, 3});
+  bias.range();
+  frame -= broadcast(bias, frame.shape());
+  for (const auto& p : frame.domain()) {
+    BOOST_TEST((frame[p] == 10 - p[1]));
+  }
+  Raster<float> wrong({2, 3});
+  BOOST_CHECK_THROW(broadcast(wrong, frame.shape()), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(cube_broadcast_test)
+{
+  Raster<double, 3> cube({2, 3, 4});
+  cube.fill(1);
+  Raster<double> plane({2, 3});
+  plane.range();
+  cube *= plane;
+  const auto bc = broadcast(plane, cube.shape());
+  BOOST_TEST(std::equal(cube.begin(), cube.end(), bc.begin(), bc.end()));
+  for (const auto& p : cube.domain()) {
+    BOOST_TEST((cube[p] == bc[p]));
+    BOOST_TEST((cube[p] == plane[{p[0], p[1]}]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_broadcast_test)
+{
+  Raster<int> frame({4, 3});
+  frame.range();
+  Raster<int> column({1, 3});
+  column.fill(2);
+  Raster<int> out(frame.shape());
+  out = lazy(frame) * broadcast(column, frame.shape()) + 1;
+  for (const auto& p : frame.domain()) {
+    BOOST_TEST((out[p] == frame[p] * 2 + 1));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,64 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Channels.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Channels_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(planar_views_test)
+{
+  ChannelRaster<int> planes({4, 3}, 2);
+  BOOST_TEST(planes.shape() == Position<2>({4, 3}));
+  BOOST_TEST(planes.channel_count() == 2);
+  BOOST_TEST(planes.pixel_count() == 12);
+  BOOST_TEST((planes.raster().shape() == Position<3>({4, 3, 2})));
+  planes.channel(0).fill(1);
+  planes.channel(1).fill(2);
+  BOOST_TEST(planes.channel(1).data() == planes.raster().data() + 12);
+  const auto pixel = planes.pixel({3, 2});
+  BOOST_TEST((std::vector<int>(pixel.begin(), pixel.end()) == std::vector<int> {1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(interleaved_views_test)
+{
+  ChannelRaster<int, 2, ChannelLayout::Interleaved> rgb({4, 3}, 3);
+  BOOST_TEST(rgb.shape() == Position<2>({4, 3}));
+  BOOST_TEST((rgb.raster().shape() == Position<3>({3, 4, 3})));
+  rgb.raster().range();
+  auto pixel = rgb.pixel({1, 2});
+  BOOST_TEST((std::vector<int>(pixel.begin(), pixel.end()) == std::vector<int> {27, 28, 29}));
+  auto green = rgb.channel(1);
+  green.fill(-1);
+  BOOST_TEST((rgb.raster()[{1, 3, 2}]) == -1);
+  BOOST_TEST((rgb.raster()[{2, 3, 2}]) == 35);
+}
+
+BOOST_AUTO_TEST_CASE(transpose_test)
+{
+  ChannelRaster<float, 2, ChannelLayout::Interleaved> rgb({300, 5}, 3); // More pixels than a block
+  rgb.raster().range();
+  const auto planes = rgb.transpose();
+  BOOST_TEST((planes.MemoryLayout == ChannelLayout::Planar));
+  BOOST_TEST(planes.shape() == rgb.shape());
+  for (const auto& p : Box<2>::from_shape(rgb.shape())) {
+    for (Index c = 0; c < 3; ++c) {
+      BOOST_TEST((planes.raster()[{p[0], p[1], c}]) == (rgb.raster()[{c, p[0], p[1]}]));
+    }
+  }
+  ChannelRaster<float, 2, ChannelLayout::Interleaved> back({300, 5}, 3);
+  planes.transpose_into(back);
+  BOOST_TEST(back.raster() == rgb.raster());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
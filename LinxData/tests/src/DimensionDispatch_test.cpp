@@ -0,0 +1,94 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Broadcast.h"
+#include "Linx/Data/DimensionDispatch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <type_traits>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DimensionDispatch_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(index_dispatch_test)
+{
+  for (Index n = 0; n < 7; ++n) {
+    const auto dimension = dispatch_dimension(n, [](auto m) {
+      return Index(decltype(m)::value);
+    });
+    BOOST_TEST(dimension == (n >= 1 && n <= 4 ? n : -1));
+  }
+  const auto narrow = dispatch_dimension<2, 3>(4, [](auto m) {
+    return Index(decltype(m)::value);
+  });
+  BOOST_TEST(narrow == -1);
+}
+
+BOOST_AUTO_TEST_CASE(raster_dispatch_test)
+{
+  Raster<int, -1> raster(Position<-1> {3, 4, 5});
+  raster.range();
+  const auto dimension = dispatch_dimension(raster, [&](auto& view) {
+    using View = std::decay_t<decltype(view)>;
+    static_assert(View::Dimension != -1 || std::is_same_v<View, Raster<int, -1>>);
+    if constexpr (View::Dimension == 3) {
+      BOOST_TEST(view.data() == raster.data());
+      BOOST_TEST(view.shape() == Position<3>({3, 4, 5}));
+      for (const auto& p : view.domain()) {
+        view[p] *= 2;
+      }
+    }
+    return View::Dimension;
+  });
+  BOOST_TEST(dimension == 3);
+  for (Index i = 0; i < static_cast<Index>(raster.size()); ++i) {
+    BOOST_TEST(raster[i] == 2 * i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_raster_forward_test)
+{
+  const Raster<int, 2> raster({3, 4});
+  const auto* data = dispatch_dimension(raster, [](const auto& r) {
+    return r.data();
+  });
+  BOOST_TEST(data == raster.data());
+}
+
+BOOST_AUTO_TEST_CASE(high_dimension_fallback_test)
+{
+  Raster<int, -1> raster(Position<-1> {2, 1, 2, 1, 2});
+  const auto dimension = dispatch_dimension(raster, [](const auto& r) {
+    return std::decay_t<decltype(r)>::Dimension;
+  });
+  BOOST_TEST(dimension == -1);
+}
+
+BOOST_AUTO_TEST_CASE(broadcast_dispatch_test)
+{
+  Raster<int, -1> frame(Position<-1> {4, 3});
+  frame.range();
+  const auto expected = frame;
+  Raster<int, 1> offsets({4});
+  offsets.range();
+  dispatch_dimension<2, 2>(frame, [&](auto& f) {
+    if constexpr (std::decay_t<decltype(f)>::Dimension == 2) {
+      f += offsets;
+    }
+  });
+  for (Index y = 0; y < 3; ++y) {
+    for (Index x = 0; x < 4; ++x) {
+      BOOST_TEST((frame[{x, y}] == expected[{x, y}] + x));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -66,6 +66,23 @@ BOOST_AUTO_TEST_CASE(grid_clamp_is_shrunk_test)
   BOOST_TEST(out6.step()[0] == 3);
 }
 
+BOOST_AUTO_TEST_CASE(split_test)
+{
+  const Grid<2> in({{0, 1}, {9, 20}}, {3, 2});
+  const auto parts = split_along<1>(in, 3);
+  BOOST_TEST(parts.size() == 3);
+  Index size = 0;
+  for (const auto& part : parts) {
+    BOOST_TEST(part.step() == in.step());
+    BOOST_TEST(part.length(0) == in.length(0));
+    BOOST_TEST(in.contains(part.front()));
+    BOOST_TEST(in.contains(part.back()));
+    size += part.size();
+  }
+  BOOST_TEST(size == in.size());
+  BOOST_TEST(parts.back().back() == in.back());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
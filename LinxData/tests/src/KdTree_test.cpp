@@ -0,0 +1,110 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/KdTree.h"
+#include "Linx/Data/Sequence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(KdTree_test)
+
+//-----------------------------------------------------------------------------
+
+std::vector<Vector<double, 2>> spiral(Index size)
+{
+  std::vector<Vector<double, 2>> out;
+  for (Index i = 0; i < size; ++i) {
+    out.push_back({i * std::cos(i * 0.5), i * std::sin(i * 0.5)});
+  }
+  return out;
+}
+
+double distance2(const Vector<double, 2>& lhs, const Vector<double, 2>& rhs)
+{
+  const auto dx = lhs[0] - rhs[0];
+  const auto dy = lhs[1] - rhs[1];
+  return dx * dx + dy * dy;
+}
+
+BOOST_AUTO_TEST_CASE(within_radius_test)
+{
+  const auto points = spiral(200);
+  const KdTree<double, 2> tree(points);
+  BOOST_TEST(tree.size() == 200);
+  BOOST_TEST(tree.dimension() == 2);
+  const Vector<double, 2> center {10.5, -3.2};
+  const double radius = 30;
+  auto indices = tree.within(center, radius);
+  std::sort(indices.begin(), indices.end());
+  std::vector<Index> expected;
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    if (distance2(points[i], center) <= radius * radius) {
+      expected.push_back(i);
+    }
+  }
+  BOOST_TEST(not expected.empty());
+  BOOST_TEST(indices == expected);
+}
+
+BOOST_AUTO_TEST_CASE(within_box_test)
+{
+  Sequence<Position<2>> positions(100);
+  Index i = 0;
+  for (auto& p : positions) {
+    p = {(i * 37) % 50, (i * 11) % 30};
+    ++i;
+  }
+  const KdTree<Index, 2> tree(positions);
+  const Box<2> box({10, 5}, {25, 12});
+  auto indices = tree.within(box);
+  std::sort(indices.begin(), indices.end());
+  std::vector<Index> expected;
+  for (std::size_t j = 0; j < positions.size(); ++j) {
+    if (box.contains(positions[j])) {
+      expected.push_back(j);
+    }
+  }
+  BOOST_TEST(not expected.empty());
+  BOOST_TEST(indices == expected);
+}
+
+BOOST_AUTO_TEST_CASE(nearest_test)
+{
+  const auto points = spiral(300);
+  const KdTree<double, 2> tree(points);
+  const Vector<double, 2> point {-42.1, 17.3};
+  const auto indices = tree.nearest(point, 5);
+  BOOST_TEST(indices.size() == 5);
+  std::vector<Index> expected(points.size());
+  std::iota(expected.begin(), expected.end(), 0);
+  std::sort(expected.begin(), expected.end(), [&](auto lhs, auto rhs) {
+    return distance2(points[lhs], point) < distance2(points[rhs], point);
+  });
+  expected.resize(5);
+  BOOST_TEST(indices == expected);
+  BOOST_TEST(tree.nearest(point) == expected[0]);
+  BOOST_TEST(tree.nearest(points[123]) == 123);
+}
+
+BOOST_AUTO_TEST_CASE(small_and_empty_test)
+{
+  const KdTree<double, 2> empty(std::vector<Vector<double, 2>>{});
+  BOOST_TEST(empty.size() == 0);
+  BOOST_TEST(empty.nearest(Vector<double, 2> {0, 0}) == -1);
+  BOOST_TEST(empty.within(Vector<double, 2> {0, 0}, 1).empty());
+  const auto points = spiral(3);
+  const KdTree<double, 2> tree(points);
+  BOOST_TEST(tree.nearest(Vector<double, 2> {0, 0}, 10).size() == 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/LazyRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(LazyRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(access_test)
+{
+  const auto in = lazy_raster<2>({4, 3}, [](const auto& p) {
+    return p[0] + 10 * p[1];
+  });
+  BOOST_TEST(in.size() == 12);
+  BOOST_TEST((in[{3, 2}]) == 23);
+  BOOST_TEST((in[{-1, 5}]) == 49); // Outside the domain
+  BOOST_TEST(in.contains({3, 2}));
+  BOOST_TEST(not in.contains({4, 2}));
+  const auto raster = in.raster();
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(raster[p] == in[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(iterator_test)
+{
+  const auto in = lazy_raster<3>({2, 3, 4}, [](const auto& p) {
+    return p[0] + 2 * p[1] + 6 * p[2];
+  });
+  Index i = 0;
+  for (auto v : in) {
+    BOOST_TEST(v == i);
+    ++i;
+  }
+  BOOST_TEST(i == in.size());
+  const auto begin = in.begin();
+  BOOST_TEST(*(begin + 17) == 17);
+  BOOST_TEST(begin[23] == 23);
+  BOOST_TEST((in.end() - begin == in.size()));
+}
+
+BOOST_AUTO_TEST_CASE(range_test)
+{
+  const Position<2> shape {5, 4};
+  const auto x = lazy_coordinates<float>(shape, 0, 1, 0.5);
+  const auto y = lazy_coordinates<float>(shape, 1);
+  Raster<float> expression(shape);
+  expression = lazy(x) * y;
+  Raster<float> generated(shape);
+  generated.generate(
+      [](auto u, auto v) {
+        return u * v;
+      },
+      x,
+      y);
+  Raster<float> parallel(shape);
+  parallel.generate(
+      Threads(3),
+      [](auto u, auto v) {
+        return u * v;
+      },
+      x,
+      y);
+  const Raster<float> copied(shape, x);
+  for (const auto& p : expression.domain()) {
+    const auto expected = (1 + 0.5 * p[0]) * p[1];
+    BOOST_TEST(expression[p] == expected);
+    BOOST_TEST(generated[p] == expected);
+    BOOST_TEST(parallel[p] == expected);
+    BOOST_TEST(copied[p] == 1 + 0.5 * p[0]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
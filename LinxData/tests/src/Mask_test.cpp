@@ -74,6 +74,78 @@ BOOST_AUTO_TEST_CASE(empty_mask_iterator_passes_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(extend_test)
+{
+  const auto ball = Mask<2>::ball<1>(1);
+  const auto extended = extend<3>(ball);
+  BOOST_TEST(extended.box() == extend<3>(ball.box()));
+  BOOST_TEST(extended.size() == ball.size());
+  for (const auto& p : ball.box()) {
+    BOOST_TEST(extended[extend<3>(p)] == ball[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(runs_test)
+{
+  auto mask = Mask<2>::ball<1>(2, Position<2> {10, 20});
+  const auto& runs = mask.runs();
+  BOOST_TEST(runs.size() == 5);
+  const std::vector<Index> lengths {1, 3, 5, 3, 1};
+  Index size = 0;
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    BOOST_TEST(runs[i].length == lengths[i]);
+    BOOST_TEST(runs[i].front[0] == 2 - lengths[i] / 2);
+    BOOST_TEST(runs[i].front[1] == Index(i));
+    size += lengths[i];
+  }
+  BOOST_TEST(mask.size() == size);
+
+  mask[{10, 20}] = false; // Split the middle run
+  BOOST_TEST(mask.runs().size() == 6);
+  BOOST_TEST(mask.size() == size - 1);
+}
+
+BOOST_AUTO_TEST_CASE(mask_patch_test)
+{
+  Raster<int, 2> raster({7, 6});
+  raster.range();
+  const auto mask = Mask<2>::ball<2>(2, Position<2> {3, 2});
+  const auto patch = raster(mask);
+  std::vector<int> expected;
+  for (const auto& p : mask) {
+    expected.push_back(raster[p]);
+  }
+  const std::vector<int> values(patch.begin(), patch.end());
+  BOOST_TEST(values == expected);
+  std::vector<int> spans;
+  patch.for_each_span([&](const auto* data, Index size, Index stride) {
+    BOOST_TEST(stride == 1);
+    spans.insert(spans.end(), data, data + size);
+  });
+  BOOST_TEST(spans == expected);
+}
+
+BOOST_AUTO_TEST_CASE(split_test)
+{
+  const auto ball = Mask<2>::ball<2>(10);
+  const auto parts = split(ball, 4);
+  BOOST_TEST(parts.size() == 4);
+  std::vector<Position<2>> positions;
+  for (const auto& part : parts) {
+    BOOST_TEST(part.size() > ball.size() / 8);
+    BOOST_TEST(part.size() < ball.size() / 2);
+    for (const auto& p : part) {
+      positions.push_back(p);
+    }
+  }
+  const std::vector<Position<2>> expected(ball.begin(), ball.end());
+  BOOST_TEST(positions == expected);
+
+  const auto point = split(Mask<2>::ball<0>(0), 4);
+  BOOST_TEST(point.size() == 1);
+  BOOST_TEST(point[0].size() == 1);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Matrix.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Check that two matrices are approximately equal.
+ */
+template <typename T, Index N, Index M>
+void check_close(const Matrix<T, N, M>& lhs, const Matrix<T, N, M>& rhs)
+{
+  for (Index i = 0; i < N; ++i) {
+    for (Index j = 0; j < M; ++j) {
+      BOOST_TEST(std::abs(lhs(i, j) - rhs(i, j)) < 1e-9);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Matrix_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(init_test)
+{
+  const Matrix<int, 2, 3> m {1, 2, 3, 4, 5, 6};
+  BOOST_TEST(m.size() == 6);
+  BOOST_TEST((m.shape() == Position<2> {3, 2}));
+  BOOST_TEST(m(0, 2) == 3);
+  BOOST_TEST(m(1, 0) == 4);
+  BOOST_TEST((m.at<1, 2>() == 6));
+  const auto zero = Matrix<int, 3>();
+  BOOST_TEST(zero.contains_only(0));
+  const auto identity = Matrix<int, 3>::identity();
+  const auto diagonal = Matrix<int, 3>::diagonal(std::vector<int> {1, 1, 1});
+  BOOST_TEST(identity == diagonal);
+  BOOST_TEST((identity(1, 1) == 1 && identity(1, 2) == 0));
+}
+
+BOOST_AUTO_TEST_CASE(copy_test)
+{
+  Matrix<double, 2> m {1, 2, 3, 4};
+  auto copy = m;
+  m(0, 0) = 10;
+  BOOST_TEST(copy(0, 0) == 1); // No shared state
+  BOOST_TEST(copy.determinant() == -2);
+}
+
+BOOST_AUTO_TEST_CASE(product_test)
+{
+  const Matrix<int, 2, 3> lhs {1, 2, 3, 4, 5, 6};
+  const Matrix<int, 3, 2> rhs {7, 8, 9, 10, 11, 12};
+  const Matrix<int, 2> expected {58, 64, 139, 154};
+  BOOST_TEST((lhs * rhs == expected));
+  BOOST_TEST((transpose(lhs) == Matrix<int, 3, 2> {1, 4, 2, 5, 3, 6}));
+  const auto v = lhs * Position<3> {1, 0, -1};
+  BOOST_TEST((v == Vector<int, 2> {-2, -2}));
+  const auto w = Matrix<double, 2> {0, -1, 1, 0} * Position<2> {1, 0};
+  BOOST_TEST((w == Vector<double, 2> {0, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(determinant_test)
+{
+  BOOST_TEST((Matrix<double, 1> {3}.determinant() == 3));
+  BOOST_TEST((Matrix<double, 2> {1, 2, 3, 4}.determinant() == -2));
+  BOOST_TEST((Matrix<double, 3> {2, 0, 1, 1, 3, 2, 1, 1, 2}.determinant() == 6));
+  BOOST_TEST(std::abs(determinant(Matrix<double, 4> {1, 0, 2, -1, 3, 0, 0, 5, 2, 1, 4, -3, 1, 0, 5, 0}) - 30) < 1e-9);
+  BOOST_TEST((Matrix<double, 4> {1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 1, 0, 1, 0}.determinant() == 0));
+}
+
+BOOST_AUTO_TEST_CASE(inverse_test)
+{
+  const Matrix<double, 1> m1 {4};
+  check_close(m1 * inverse(m1), Matrix<double, 1>::identity());
+  const Matrix<double, 2> m2 {1, 2, 3, 4};
+  check_close(m2 * inverse(m2), Matrix<double, 2>::identity());
+  const Matrix<double, 3> m3 {2, 0, 1, 1, 3, 2, 1, 1, 2};
+  check_close(m3 * inverse(m3), Matrix<double, 3>::identity());
+  check_close(inverse(m3) * m3, Matrix<double, 3>::identity());
+  const Matrix<double, 4> m4 {0, 0, 2, -1, 3, 0, 0, 5, 2, 1, 4, -3, 1, 0, 5, 0}; // Requires pivoting
+  check_close(m4 * inverse(m4), Matrix<double, 4>::identity());
+}
+
+BOOST_AUTO_TEST_CASE(batch_test)
+{
+  std::vector<Matrix<double, 2>> matrices;
+  for (Index i = 1; i <= 100; ++i) {
+    matrices.push_back({double(i), 1, 0, 2});
+  }
+  const auto determinants = batch_determinant(matrices, Threads(4));
+  for (Index i = 0; i < 100; ++i) {
+    BOOST_TEST(determinants[i] == 2. * (i + 1));
+  }
+
+  std::vector<Vector<double, 2>> vectors(matrices.size());
+  batch_multiply(matrices, std::vector<Vector<double, 2>> {{1, 1}}, vectors, Threads(4));
+  for (Index i = 0; i < 100; ++i) {
+    BOOST_TEST((vectors[i] == Vector<double, 2> {i + 2., 2}));
+  }
+
+  auto inverses = matrices;
+  batch_inverse(inverses, Threads(4));
+  std::vector<Matrix<double, 2>> products(matrices.size());
+  batch_multiply(matrices, inverses, products);
+  for (const auto& p : products) {
+    check_close(p, Matrix<double, 2>::identity());
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/Grid.h"
 #include "Linx/Data/Raster.h"
 
 #include <boost/test/unit_test.hpp>
@@ -55,6 +56,87 @@ BOOST_AUTO_TEST_CASE(contiguity_test)
   }
 }
 
+template <typename TPatch>
+std::vector<int> span_values(const TPatch& patch, Index& count)
+{
+  std::vector<int> out;
+  count = 0;
+  patch.for_each_span([&](const auto* data, Index size, Index stride) {
+    ++count;
+    for (Index i = 0; i < size; ++i) {
+      out.push_back(data[i * stride]);
+    }
+  });
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(span_test)
+{
+  Raster<int> raster({10, 6});
+  raster.range();
+  Index count = 0;
+
+  const auto box = raster(Box<2>({1, 1}, {4, 3}));
+  BOOST_TEST(span_values(box, count) == std::vector<int>(box.begin(), box.end()));
+  BOOST_TEST(count == 3);
+
+  const auto grid = raster(Grid<2>(Box<2>({0, 0}, {8, 4}), {2, 2}));
+  BOOST_TEST(std::distance(grid.begin(), grid.end()) == 15);
+  BOOST_TEST(span_values(grid, count) == std::vector<int>(grid.begin(), grid.end()));
+  BOOST_TEST(count == 3);
+
+  const auto row = raster.row({2});
+  BOOST_TEST(span_values(row, count) == std::vector<int>(row.begin(), row.end()));
+  BOOST_TEST(count == 1);
+
+  const auto profile = raster.profile<1>({2});
+  BOOST_TEST(span_values(profile, count) == std::vector<int>(profile.begin(), profile.end()));
+  BOOST_TEST(count == 1);
+
+  BOOST_TEST(Raster<int>(grid) == Raster<int>({5, 3}, grid));
+}
+
+BOOST_AUTO_TEST_CASE(box_rows_test)
+{
+  const Box<3> box({1, 2, 3}, {4, 3, 5});
+  std::vector<Position<3>> positions;
+  box.for_each_row([&](const auto& front, Index length) {
+    BOOST_TEST(length == 4);
+    for (Index i = 0; i < length; ++i) {
+      positions.push_back(front + Position<3>({i, 0, 0}));
+    }
+  });
+  BOOST_TEST(positions == std::vector<Position<3>>(box.begin(), box.end()));
+  Index rows = 0;
+  Grid<2>(Box<2>({0, 0}, {8, 4}), {2, 2}).for_each_row([&](const auto&, Index length) {
+    BOOST_TEST(length == 5);
+    ++rows;
+  });
+  BOOST_TEST(rows == 3);
+}
+
+BOOST_AUTO_TEST_CASE(stencil_test)
+{
+  Raster<int> raster({10, 6});
+  raster.range();
+  auto patch = raster(Box<2>::from_center(1));
+  auto stencil = patch.stencil();
+  BOOST_TEST(stencil.size() == 9);
+  const auto origin = stencil.index();
+  BOOST_TEST(origin == raster.index({-1, -1}));
+  const Position<2> p {3, 2};
+  stencil.move_to(origin + raster.index(p));
+  patch >>= p;
+  BOOST_TEST(std::vector<int>(stencil.begin(), stencil.end()) == std::vector<int>(patch.begin(), patch.end()));
+  stencil += 1;
+  patch >>= Position<2> {1, 0};
+  BOOST_TEST(std::vector<int>(stencil.begin(), stencil.end()) == std::vector<int>(patch.begin(), patch.end()));
+  for (auto& v : stencil) {
+    v = -1;
+  }
+  BOOST_TEST((raster[{5, 3}]) == -1);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,75 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/PositionOffsets.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PositionOffsets_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(gather_scatter_test)
+{
+  auto raster = Raster<int, 3>({5, 4, 3}).range();
+  const std::vector<Position<3>> positions {{4, 3, 2}, {0, 0, 0}, {1, 2, 1}, {3, 0, 2}};
+  for (bool sorted : {false, true}) {
+    const PositionOffsets<3> offsets(raster.shape(), positions, sorted);
+    BOOST_TEST(offsets.size() == positions.size());
+    BOOST_TEST(offsets.is_sorted() == sorted);
+    const auto values = offsets.gather(raster);
+    for (std::size_t k = 0; k < positions.size(); ++k) {
+      BOOST_TEST(values[k] == raster[positions[k]]);
+    }
+
+    auto copy = raster;
+    offsets.scatter(-values, copy, Threads(2));
+    for (const auto& p : positions) {
+      BOOST_TEST(copy[p] == -raster[p]);
+    }
+    offsets.scatter(values, copy, std::plus<int>());
+    for (const auto& p : positions) {
+      BOOST_TEST(copy[p] == 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(out_of_bounds_test)
+{
+  const Position<2> shape {5, 4};
+  BOOST_CHECK_THROW(PositionOffsets<2>(shape, std::vector<Position<2>> {{1, 1}, {5, 0}}), OutOfBoundsError);
+  BOOST_CHECK_THROW(PositionOffsets<2>(shape, std::vector<Position<2>> {{0, -1}}), OutOfBoundsError);
+  BOOST_CHECK_NO_THROW(PositionOffsets<2>(shape, std::vector<Position<2>> {{4, 3}}));
+}
+
+BOOST_AUTO_TEST_CASE(free_functions_test)
+{
+  auto raster = Raster<float>({6, 5}).range();
+  const Sequence<Position<2>> positions {{1, 1}, {5, 4}};
+  const auto values = gather(raster, positions);
+  BOOST_TEST(values[0] == 7);
+  BOOST_TEST(values[1] == 29);
+  scatter(values * 2, raster, positions);
+  BOOST_TEST((raster[{5, 4}]) == 58);
+  BOOST_CHECK_THROW(PositionOffsets<2>({3, 3}, std::vector<Position<2>> {{1, 1}}).gather(raster), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(sequence_patch_test)
+{
+  auto raster = Raster<int>({6, 5}).range();
+  const Sequence<Position<2>> positions {{1, 1}, {5, 4}, {0, 2}};
+  auto patch = raster(positions);
+  const std::vector<int> values(patch.begin(), patch.end());
+  BOOST_TEST(values == std::vector<int>({7, 29, 12}));
+  patch >>= Position<2> {1, 0};
+  BOOST_TEST(*patch.begin() == 8);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "Linx/Data/Raster.h"
 
 #include <boost/test/unit_test.hpp>
+#include <utility> // as_const
 
 using namespace Linx;
 
@@ -25,7 +26,7 @@ BOOST_AUTO_TEST_CASE(index_test)
   for (auto& coord : fixed_pos) {
     coord = std::rand();
   }
-  auto fixed_index = Internal::IndexRecursionImpl<4>::index(fixed_shape, fixed_pos);
+  auto fixed_index = Internal::StrideIndexImpl<4>::index(shape_strides(fixed_shape), fixed_pos);
   auto expected_index = fixed_pos[0] +
       fixed_shape[0] * (fixed_pos[1] + fixed_shape[1] * (fixed_pos[2] + fixed_shape[2] * (fixed_pos[3])));
   BOOST_TEST(fixed_index == expected_index);
@@ -33,10 +34,22 @@ BOOST_AUTO_TEST_CASE(index_test)
   /* Variable dimension */
   Position<-1> variable_shape(fixed_shape);
   Position<-1> variable_pos(fixed_pos);
-  auto variable_index = Internal::IndexRecursionImpl<-1>::index(variable_shape, variable_pos);
+  auto variable_index = Internal::StrideIndexImpl<-1>::index(shape_strides(variable_shape), variable_pos);
   BOOST_TEST(variable_index == fixed_index);
 }
 
+BOOST_AUTO_TEST_CASE(strides_test)
+{
+  Raster<int, 3> raster({4, 3, 2});
+  BOOST_TEST(raster.strides() == Position<3>({1, 4, 12}));
+  raster.range();
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster.index(p) == raster[p]);
+  }
+  const Raster<int, -1> variable({4, 3, 2});
+  BOOST_TEST(variable.strides() == Position<-1>({1, 4, 12}));
+}
+
 BOOST_AUTO_TEST_CASE(ptrraster_data_test)
 {
   int data[] = {0, 1, 2};
@@ -101,6 +114,88 @@ BOOST_AUTO_TEST_CASE(alignedraster_alignment_test)
   BOOST_TEST(raw.alignment() == sizeof(int));
 }
 
+BOOST_AUTO_TEST_CASE(uninitialized_raster_test)
+{
+  const Position<2> shape {3, 4};
+  Raster<int> standard(shape, uninitialized);
+  BOOST_TEST(standard.shape() == shape);
+  AlignedRaster<int> aligned(shape, uninitialized);
+  BOOST_TEST(aligned.owns());
+  BOOST_TEST(aligned.size() == shape_size(shape));
+  PoolRaster<int> pooled(shape, uninitialized);
+  BOOST_TEST(pooled.size() == shape_size(shape));
+  VecRaster<int, 2, DefaultInitAllocator<int>> vec(shape, uninitialized);
+  BOOST_TEST(vec.size() == shape_size(shape));
+  vec.fill(1);
+  BOOST_TEST((vec[{2, 3}]) == 1);
+  const VecRaster<int, 2, DefaultInitAllocator<int>> zeros(shape);
+  for (const auto& e : zeros) {
+    BOOST_TEST(e == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cast_test)
+{
+  Raster<std::int16_t, 1> raw({5}, {-32768, -1, 0, 1, 32767});
+  const auto physical = raw.cast<float>({1, 32768});
+  BOOST_TEST((physical == Raster<float, 1>({5}, {0, 32767, 32768, 32769, 65535})));
+  const auto shifted = raw.cast<std::int32_t>();
+  BOOST_TEST(std::equal(shifted.begin(), shifted.end(), raw.begin()));
+
+  Raster<float, 1> values({5}, {-1.6, -0.4, 0.5, 1e6, -1e6});
+  Raster<std::uint8_t, 1> out({5});
+  values.convert_into(out, {2, 0, true});
+  BOOST_TEST((out == Raster<std::uint8_t, 1>({5}, {0, 0, 1, 255, 0})));
+  values.convert_into(raw, {1, 0, true});
+  BOOST_TEST((raw == Raster<std::int16_t, 1>({5}, {-2, 0, 1, 32767, -32768})));
+  Raster<double, 1> small({3});
+  BOOST_CHECK_THROW(values.convert_into(small), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(cowraster_test)
+{
+  CowRaster<int> a({3, 2});
+  a.range();
+  const auto b = a;
+  BOOST_TEST(b.is_shared());
+  BOOST_TEST(b.data() == std::as_const(a).data()); // Constant access does not detach
+  auto c = b;
+  c[{1, 1}] = -1;
+  BOOST_TEST(not c.is_shared());
+  BOOST_TEST(a.is_shared());
+  BOOST_TEST(c.data() != b.data());
+  BOOST_TEST((b[{1, 1}]) == 4);
+  BOOST_TEST((c[{1, 1}]) == -1);
+  a.fill(0);
+  BOOST_TEST(not a.is_shared());
+  BOOST_TEST(not b.is_shared());
+  BOOST_TEST((b[{1, 1}]) == 4);
+  BOOST_TEST((a[{1, 1}]) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(smallraster_test)
+{
+  SmallRaster<int, 2, 16> a({4, 3});
+  BOOST_TEST(a.is_inline());
+  BOOST_TEST((a[{3, 2}]) == 0);
+  a.range();
+  auto b = a;
+  BOOST_TEST(b.is_inline());
+  BOOST_TEST(b == a);
+  BOOST_TEST(b.data() != a.data());
+  const auto c = std::move(b);
+  BOOST_TEST(c == a);
+  SmallRaster<int, 2, 16> d({5, 4});
+  BOOST_TEST(not d.is_inline());
+  d.range();
+  auto e = std::move(d);
+  BOOST_TEST(not e.is_inline());
+  BOOST_TEST((e[{4, 3}]) == 19);
+  e = c;
+  BOOST_TEST(e.is_inline());
+  BOOST_TEST(e == a);
+}
+
 BOOST_AUTO_TEST_CASE(variable_dimension_raster_size_test)
 {
   const Index width = 4;
@@ -0,0 +1,82 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/StridedRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(StridedRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(box_view_test)
+{
+  auto raster = Raster<int, 3>({5, 4, 3}).range();
+  const Box<3> box({1, 1, 1}, {3, 2, 2});
+  const auto view = strided(raster, box);
+  BOOST_TEST(view.shape() == box.shape());
+  BOOST_TEST(view.size() == box.size());
+  BOOST_TEST(not view.is_contiguous());
+  BOOST_TEST(view.data() == &raster[box.front()]);
+  const auto patch = raster(box);
+  BOOST_TEST(std::equal(view.begin(), view.end(), patch.begin()));
+  for (const auto& p : view.domain()) {
+    BOOST_TEST(view[p] == raster[p + box.front()]);
+  }
+  const auto copy = view.copy();
+  BOOST_TEST(std::equal(copy.begin(), copy.end(), patch.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(grid_view_test)
+{
+  auto raster = Raster<int>({7, 6}).range();
+  const Grid<2> grid({{1, 0}, {6, 5}}, {2, 3});
+  auto view = strided(raster, grid);
+  BOOST_TEST(view.shape() == grid.shape());
+  std::vector<int> expected;
+  for (const auto& p : grid) {
+    expected.push_back(raster[p]);
+  }
+  const std::vector<int> values(view.begin(), view.end());
+  BOOST_TEST(values == expected);
+
+  view *= 10;
+  for (const auto& p : raster.domain()) {
+    const auto value = raster.index(p);
+    BOOST_TEST(raster[p] == (grid.contains(p) ? value * 10 : value));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(arithmetics_test)
+{
+  Raster<int> raster({4, 4});
+  raster.fill(0);
+  const auto view = strided(raster, Box<2>({1, 1}, {2, 2}));
+  BOOST_TEST(view.is_contiguous() == false);
+  view.fill(1);
+  const Raster<int> ones({2, 2}, {1, 2, 3, 4});
+  view += ones;
+  BOOST_TEST((raster[{1, 1}]) == 2);
+  BOOST_TEST((raster[{2, 2}]) == 5);
+  BOOST_TEST((raster[{0, 0}]) == 0);
+  view.assign(ones);
+  BOOST_TEST(view.copy().container() == ones.container());
+  BOOST_CHECK_THROW(view -= Raster<int>({3, 3}), SizeError);
+
+  Raster<int> sum({2, 2});
+  sum.fill(1);
+  sum += view;
+  BOOST_TEST(sum.container() == (ones + 1).container());
+
+  const auto full = strided(raster, raster.domain());
+  BOOST_TEST(full.is_contiguous());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
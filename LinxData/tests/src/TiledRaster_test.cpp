@@ -0,0 +1,59 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/TiledRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(TiledRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(index_test)
+{
+  TiledRaster<int, 2, 4> tiled({10, 6});
+  BOOST_TEST(tiled.tile_counts() == Position<2>({3, 2}));
+  BOOST_TEST(tiled.index({0, 0}) == 0);
+  BOOST_TEST(tiled.index({3, 0}) == 3);
+  BOOST_TEST(tiled.index({0, 1}) == 4);
+  BOOST_TEST(tiled.index({4, 0}) == 16);
+  BOOST_TEST(tiled.index({0, 4}) == 3 * 16);
+  BOOST_TEST(tiled.index({9, 5}) == 5 * 16 + 1 * 4 + 1);
+}
+
+BOOST_AUTO_TEST_CASE(conversion_test)
+{
+  Raster<int, 3> raster({13, 7, 5});
+  raster.range();
+  const TiledRaster<int, 3, 4> tiled(raster);
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(tiled[p] == raster[p]);
+  }
+  BOOST_TEST(tiled.raster() == raster);
+  Raster<long, 3> other(raster.shape());
+  tiled.copy_to(other);
+  BOOST_TEST(other == raster);
+}
+
+BOOST_AUTO_TEST_CASE(tile_test)
+{
+  Raster<int> raster({5, 3});
+  raster.range();
+  TiledRaster<int, 2, 4> tiled(raster);
+  auto tile = tiled.tile({1, 0});
+  BOOST_TEST(tile.shape() == Position<2>({4, 4}));
+  BOOST_TEST((tile[{0, 0}]) == (raster[{4, 0}]));
+  BOOST_TEST((tile[{0, 2}]) == (raster[{4, 2}]));
+  BOOST_TEST((tile[{1, 0}]) == 0); // Padding
+  tile[{0, 1}] = -1;
+  BOOST_TEST((tiled[{4, 1}]) == -1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "Linx/Data/Tiling.h"
 
 #include <boost/test/unit_test.hpp>
+#include <numeric> // partial_sum
 #include <omp.h>
 
 using namespace Linx;
@@ -142,6 +143,90 @@ BOOST_AUTO_TEST_CASE(patch_rows_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(halo_tiles_test)
+{
+  const auto domain = Box<2>::from_shape(Position<2>::zero(), {10, 7});
+  const auto halo = Box<2>::from_center(1);
+  const auto parts = halo_tiles(domain, {4, 3}, halo);
+  BOOST_TEST(parts.size() == 9);
+  Index size = 0;
+  for (const auto& t : parts) {
+    BOOST_TEST(t.inner <= domain);
+    BOOST_TEST(t.outer == t.inner + halo);
+    BOOST_TEST(t.is_border == not(t.outer <= domain));
+    size += t.inner.size();
+  }
+  BOOST_TEST(size == domain.size());
+  BOOST_TEST(parts[0].is_border);
+  BOOST_TEST(not parts[4].is_border); // Central tile
+  BOOST_TEST(parts[8].inner == Box<2>({8, 6}, {9, 6})); // Clamped
+}
+
+BOOST_AUTO_TEST_CASE(for_each_tile_test)
+{
+  Raster<Index, 2> raster({10, 7});
+  raster.fill(0);
+  const auto parts = halo_tiles(raster.domain(), {3, 3}, Box<2>::from_center(1));
+  for_each_tile(
+      parts,
+      [&](const auto& tile) {
+        raster(tile.inner) += tile.is_border ? 1 : 2;
+      },
+      Threads(2));
+  for (const auto& t : parts) {
+    for (const auto& p : t.inner) {
+      BOOST_TEST(raster[p] == (t.is_border ? 1 : 2));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_write_panel_test)
+{
+  const auto raster = Raster<Index, 3>({5, 4, 3}).range();
+  Raster<Index, 2> panel({4, 2});
+  read_panel<1>(raster, {2, 0, 1}, panel);
+  for (const auto& p : panel.domain()) {
+    BOOST_TEST((panel[p] == raster[{2 + p[1], p[0], 1}]));
+  }
+  auto copy = Raster<Index, 3>(raster.shape()).fill(-1);
+  write_panel<1>(panel, {2, 0, 1}, copy);
+  for (const auto& p : copy.domain()) {
+    const auto inside = p[0] >= 2 && p[0] < 4 && p[2] == 1;
+    BOOST_TEST(copy[p] == (inside ? raster[p] : -1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(for_each_panel_test)
+{
+  auto raster = Raster<Index, 3>({5, 4, 3}).range();
+  auto expected = raster;
+  for (const auto& p : expected.domain()) {
+    if (p[1] > 0) {
+      expected[p] += expected[{p[0], p[1] - 1, p[2]}];
+    }
+  }
+  for_each_panel<1>(
+      raster,
+      2,
+      [](auto& panel, const auto&) {
+        for (auto profile : rows(panel)) {
+          std::partial_sum(profile.begin(), profile.end(), profile.begin());
+        }
+      },
+      Threads(2));
+  BOOST_TEST(raster == expected);
+
+  const auto& constant = raster;
+  Index count = 0;
+  for_each_panel<0>(constant, 3, [&](const auto& panel, const auto& front) {
+    BOOST_TEST(panel.length(0) == 5);
+    BOOST_TEST(panel.length(1) == (front[1] == 3 ? 1 : 3));
+    BOOST_TEST((panel[{0, 0}] == constant[front]));
+    ++count;
+  });
+  BOOST_TEST(count == 6);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -80,6 +80,21 @@ BOOST_AUTO_TEST_CASE(arithmetics_test)
   BOOST_TEST(dec == indices);
 }
 
+BOOST_AUTO_TEST_CASE(variable_dimension_arithmetics_test)
+{
+  for (Index n : {3, 12}) { // Inline and heap-allocated
+    auto indices = Position<-1>::zero(n);
+    indices.range();
+    const auto twice = indices * 2;
+    auto copy = indices;
+    copy += indices;
+    BOOST_TEST(copy == twice);
+    auto moved = std::move(copy);
+    BOOST_TEST(moved == twice);
+    BOOST_TEST(-(-moved) == twice);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(norm_test)
 {
   Position<3> zero {0, 0, 0};
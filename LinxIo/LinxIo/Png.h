@@ -5,25 +5,337 @@
 #ifndef _LINXIO_PNG_H
 #define _LINXIO_PNG_H
 
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <csetjmp> // setjmp
+#include <cstdint>
+#include <cstdio> // FILE, fopen, fclose, snprintf
+#include <filesystem>
 #include <png.h>
 #include <string>
+#include <type_traits>
 
 namespace Linx {
 
+/**
+ * @brief PNG file reader/writer, e.g. for quicklooks.
+ * 
+ * Images are streamed row by row into or out of the raster, without intermediate full-image buffer.
+ * Value types are `std::uint8_t` and `std::uint16_t`, for 8-bit and 16-bit samples, respectively;
+ * samples are converted on read if needed, and palettes and low bit depths are expanded to 8 bits.
+ * Grayscale images are read and written as 2D rasters; multi-channel images (gray-alpha, RGB, RGBA),
+ * as 3D rasters, where the channel index is axis 0, such that each image row is a contiguous section:
+ * 
+ * \code
+ * const auto rgb = Png("quicklook.png").read<Raster<std::uint8_t, 3>>();
+ * const auto red = rgb(Grid<3>({0, 0, 0}, rgb.shape() - 1, {3, 1, 1}));
+ * \endcode
+ */
 class Png {
 public:
 
-  Png(const std::string& filename);
+  /**
+   * @brief Constructor.
+   */
+  Png(const std::filesystem::path& path) : m_path(path) {}
 
   bool accept();
 
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Read the image as a 2D raster for grayscale images, or as a 3D raster with channels along axis 0.
+   */
   template <typename TRaster>
-  TRaster read();
+  TRaster read() const
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2, "Only 8-bit and 16-bit values are supported.");
+    static_assert(TRaster::Dimension == 2 || TRaster::Dimension == 3, "Only 2D and 3D rasters are supported.");
+    FileNotFoundError::may_throw(m_path);
+    Handle handle(m_path, 'r');
+    png_uint_32 width = 0;
+    png_uint_32 height = 0;
+    int channels = 0;
+    int passes = 0;
+    if (not read_header(handle, sizeof(T), width, height, channels, passes)) {
+      handle.throw_error();
+    }
+
+    // Shape
+    Position<TRaster::Dimension> shape;
+    if constexpr (TRaster::Dimension == 2) {
+      if (channels != 1) {
+        throw FileFormatError("Cannot read " + std::to_string(channels) + " channels as a 2D raster from", m_path);
+      }
+      shape = {Index(width), Index(height)};
+    } else {
+      shape = {Index(channels), Index(width), Index(height)};
+    }
 
+    // Rows
+    TRaster out(shape);
+    const auto row_size = std::size_t(channels) * width * sizeof(T);
+    if (not read_rows(handle, reinterpret_cast<png_bytep>(out.data()), row_size, height, passes)) {
+      handle.throw_error();
+    }
+    return out;
+  }
+
+  /**
+   * @brief Write a 2D raster as a grayscale image, or a 3D raster with 2 to 4 channels along axis 0.
+   * @param raster The raster to be written, which must be contiguous
+   * @param mode `x` to create a new file, `w` to create or overwrite
+   */
   template <typename TRaster>
-  void write(const TRaster& raster);
+  void write(const TRaster& raster, char mode = 'x') const
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2, "Only 8-bit and 16-bit values are supported.");
+    static_assert(TRaster::Dimension == 2 || TRaster::Dimension == 3, "Only 2D and 3D rasters are supported.");
+    switch (mode) {
+      case 'x':
+        PathExistsError::may_throw(m_path);
+        break;
+      case 'w':
+        break;
+      default:
+        throw Exception("Unknown write mode", std::string(1, mode));
+    }
+    const auto& shape = raster.shape();
+    const Index channels = TRaster::Dimension == 2 ? 1 : shape[0];
+    int color = PNG_COLOR_TYPE_GRAY;
+    switch (channels) {
+      case 1:
+        break;
+      case 2:
+        color = PNG_COLOR_TYPE_GRAY_ALPHA;
+        break;
+      case 3:
+        color = PNG_COLOR_TYPE_RGB;
+        break;
+      case 4:
+        color = PNG_COLOR_TYPE_RGBA;
+        break;
+      default:
+        throw FileFormatError("Cannot write " + std::to_string(channels) + " channels to", m_path);
+    }
+    const Index width = shape[TRaster::Dimension - 2];
+    const Index height = shape[TRaster::Dimension - 1];
+
+    Handle handle(m_path, 'w');
+    const auto* data = reinterpret_cast<png_const_bytep>(raster.data());
+    const auto row_size = std::size_t(channels) * width * sizeof(T);
+    if (not write_image(handle, data, row_size, width, height, sizeof(T), color)) {
+      handle.throw_error();
+    }
+  }
 
 private:
+
+  /**
+   * @brief RAII wrapper of the file and libpng structures.
+   * 
+   * Exceptions must not be thrown through the libpng C frames:
+   * the error callback saves the message and calls `png_longjmp()` back to the `setjmp()` of
+   * `read_header()`, `read_rows()` or `write_image()`, which only hold trivially destructible objects,
+   * and the exception is thrown by the caller with `throw_error()`.
+   */
+  struct Handle {
+
+    Handle(const std::filesystem::path& path, char mode) :
+        is_read(mode == 'r'), file(std::fopen(path.c_str(), is_read ? "rb" : "wb")), png(nullptr), info(nullptr),
+        path(path), message()
+    {
+      if (not file) {
+        throw FileFormatError("Cannot open file", path);
+      }
+      png = is_read ? png_create_read_struct(PNG_LIBPNG_VER_STRING, this, on_error, on_warning) :
+                      png_create_write_struct(PNG_LIBPNG_VER_STRING, this, on_error, on_warning);
+      if (png) {
+        info = png_create_info_struct(png);
+      }
+      if (not info) {
+        release();
+        throw FileFormatError("Cannot allocate PNG structures for", path);
+      }
+    }
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    ~Handle()
+    {
+      release();
+    }
+
+    void release()
+    {
+      if (png) {
+        if (is_read) {
+          png_destroy_read_struct(&png, info ? &info : nullptr, nullptr);
+        } else {
+          png_destroy_write_struct(&png, info ? &info : nullptr);
+        }
+      }
+      if (file) {
+        std::fclose(file);
+        file = nullptr;
+      }
+    }
+
+    [[noreturn]] void throw_error() const
+    {
+      throw FileFormatError(std::string(message) + " in", path);
+    }
+
+    static void on_error(png_structp png, png_const_charp message)
+    {
+      auto* handle = static_cast<Handle*>(png_get_error_ptr(png));
+      std::snprintf(handle->message, sizeof(handle->message), "%s", message);
+      png_longjmp(png, 1);
+    }
+
+    static void on_warning(png_structp, png_const_charp) {}
+
+    bool is_read;
+    std::FILE* file;
+    png_structp png;
+    png_infop info;
+    const std::filesystem::path& path;
+    char message[256];
+  };
+
+  /**
+   * @brief Read the image header and set the transformations.
+   * @return `false` if libpng reported an error
+   */
+  static bool read_header(
+      Handle& handle,
+      std::size_t bytes,
+      png_uint_32& width,
+      png_uint_32& height,
+      int& channels,
+      int& passes)
+  {
+    auto* png = handle.png;
+    auto* info = handle.info;
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    png_init_io(png, handle.file);
+    png_read_info(png, info);
+    const auto color = png_get_color_type(png, info);
+    const auto depth = png_get_bit_depth(png, info);
+    if (color == PNG_COLOR_TYPE_PALETTE) {
+      png_set_palette_to_rgb(png);
+    }
+    if (depth < 8) {
+      png_set_expand_gray_1_2_4_to_8(png);
+    }
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+      png_set_tRNS_to_alpha(png);
+    }
+    if (bytes == 1) {
+      png_set_strip_16(png);
+    } else {
+      png_set_expand_16(png);
+      if (not is_big_endian()) {
+        png_set_swap(png);
+      }
+    }
+    passes = png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+    width = png_get_image_width(png, info);
+    height = png_get_image_height(png, info);
+    channels = png_get_channels(png, info);
+    return true;
+  }
+
+  /**
+   * @brief Read the rows into contiguous data.
+   * 
+   * Interlaced images are read in several passes over the same rows.
+   * @return `false` if libpng reported an error
+   */
+  static bool read_rows(Handle& handle, png_bytep data, std::size_t row_size, png_uint_32 height, int passes)
+  {
+    auto* png = handle.png;
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    for (int pass = 0; pass < passes; ++pass) {
+      for (png_uint_32 y = 0; y < height; ++y) {
+        png_read_row(png, data + y * row_size, nullptr);
+      }
+    }
+    png_read_end(png, nullptr);
+    return true;
+  }
+
+  /**
+   * @brief Write the header and the rows from contiguous data.
+   * @return `false` if libpng reported an error
+   */
+  static bool write_image(
+      Handle& handle,
+      png_const_bytep data,
+      std::size_t row_size,
+      png_uint_32 width,
+      png_uint_32 height,
+      std::size_t bytes,
+      int color)
+  {
+    auto* png = handle.png;
+    auto* info = handle.info;
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    png_init_io(png, handle.file);
+    png_set_IHDR(
+        png,
+        info,
+        width,
+        height,
+        8 * bytes,
+        color,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT,
+        PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    if (bytes == 2 && not is_big_endian()) {
+      png_set_swap(png);
+    }
+    for (png_uint_32 y = 0; y < height; ++y) {
+      png_write_row(png, data + y * row_size);
+    }
+    png_write_end(png, nullptr);
+    return true;
+  }
+
+  /**
+   * @brief Check whether the native byte order is big-endian (PNG samples are big-endian).
+   */
+  static constexpr bool is_big_endian()
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
 };
 
 } // namespace Linx
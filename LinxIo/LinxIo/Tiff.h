@@ -5,18 +5,56 @@
 #ifndef _LINXIO_TIFF_H
 #define _LINXIO_TIFF_H
 
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <algorithm> // copy_n, max, min
+#include <cstdint>
+#include <filesystem>
 #include <string>
-#include <tiff.h>
+#include <tiffio.h>
+#include <type_traits>
+#include <vector>
 
 namespace Linx {
 
+/**
+ * @brief TIFF file reader.
+ * 
+ * Single-channel images are decoded natively, strip-wise or tile-wise, directly into the raster.
+ * Integral and floating point samples of any size are supported, as long as they match the raster value type.
+ * Pages (TIFF directories) are read as 2D rasters, or stacked into a 3D raster, where axis 2 is the page index.
+ * Region reads only decode the strips or tiles which intersect the region.
+ */
 class Tiff {
 public:
 
-  Tiff(const std::string& filename) : m_tif(TIFFOpen(filename.c_str(), "r"))
+  /**
+   * @brief Constructor.
+   */
+  Tiff(const std::filesystem::path& path) : m_path(path), m_tif(nullptr)
   { // FIXME mode
+    FileNotFoundError::may_throw(m_path);
+    m_tif = TIFFOpen(m_path.c_str(), "r");
+    if (not m_tif) {
+      throw FileFormatError("Cannot read file", m_path);
+    }
   }
 
+  /**
+   * @brief Non-copyable.
+   */
+  Tiff(const Tiff&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  Tiff& operator=(const Tiff&) = delete;
+
+  /**
+   * @brief Destructor.
+   */
   ~Tiff()
   {
     TIFFClose(m_tif);
@@ -24,14 +62,71 @@ public:
 
   bool accept();
 
-  template <typename TRaster>
-  TRaster read()
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
   {
-    std::uint32_t width, height;
+    return m_path;
+  }
+
+  /**
+   * @brief Get the number of pages.
+   */
+  Index page_count()
+  {
+    return TIFFNumberOfDirectories(m_tif);
+  }
+
+  /**
+   * @brief Read the shape of a page.
+   */
+  Position<2> read_shape(Index page = 0)
+  {
+    set_page(page);
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
     TIFFGetField(m_tif, TIFFTAG_IMAGEWIDTH, &width);
     TIFFGetField(m_tif, TIFFTAG_IMAGELENGTH, &height);
-    TRaster out({width, height});
-    TIFFReadRGBAImage(m_tif, w, h, out.data(), 0);
+    return {width, height};
+  }
+
+  /**
+   * @brief Read a page as a 2D raster, or all the pages as a 3D raster.
+   * @param page The page index, for 2D rasters only
+   */
+  template <typename TRaster>
+  TRaster read(Index page = 0)
+  {
+    static_assert(TRaster::Dimension == 2 || TRaster::Dimension == 3, "Only 2D and 3D rasters are supported.");
+    const auto shape = read_shape(page);
+    if constexpr (TRaster::Dimension == 2) {
+      return read<TRaster>(Box<2>::from_shape(shape), page);
+    } else {
+      return read<TRaster>(Box<3>::from_shape({shape[0], shape[1], page_count()}));
+    }
+  }
+
+  /**
+   * @brief Read a region of a page, or of several pages.
+   * @param region The region, where axis 2 (if any) is the page index
+   * @param page The page index, for 2D regions only
+   * 
+   * Only the strips or tiles which intersect the region are decoded.
+   */
+  template <typename TRaster, Index N>
+  TRaster read(const Box<N>& region, Index page = 0)
+  {
+    static_assert(N == 2 || N == 3, "Only 2D and 3D regions are supported.");
+    TRaster out(region.shape());
+    const Box<2> plane({region.front()[0], region.front()[1]}, {region.back()[0], region.back()[1]});
+    if constexpr (N == 2) {
+      read_to(plane, page, out.data());
+    } else {
+      for (Index p = region.front()[2]; p <= region.back()[2]; ++p) {
+        read_to(plane, p, out.section(p - region.front()[2]).data());
+      }
+    }
     return out;
   }
 
@@ -40,6 +135,114 @@ public:
 
 private:
 
+  /**
+   * @brief Select a page.
+   */
+  void set_page(Index page)
+  {
+    if (not TIFFSetDirectory(m_tif, page)) {
+      throw FileFormatError("Cannot read page " + std::to_string(page) + " of", m_path);
+    }
+  }
+
+  /**
+   * @brief Decode a region of a page into contiguous data.
+   */
+  template <typename T>
+  void read_to(const Box<2>& region, Index page, T* data)
+  {
+    set_page(page);
+    check_format<T>();
+    const auto shape = read_shape(page);
+    if (region.front()[0] < 0 || region.front()[1] < 0 || region.back()[0] >= shape[0] ||
+        region.back()[1] >= shape[1]) {
+      throw FileFormatError("Region out of bounds in", m_path);
+    }
+    if (TIFFIsTiled(m_tif)) {
+      std::uint32_t tile_width = 0;
+      std::uint32_t tile_height = 0;
+      TIFFGetField(m_tif, TIFFTAG_TILEWIDTH, &tile_width);
+      TIFFGetField(m_tif, TIFFTAG_TILELENGTH, &tile_height);
+      read_blocks(region, {tile_width, tile_height}, TIFFTileSize(m_tif), data, [&](Index x, Index y, void* buffer) {
+        return TIFFReadEncodedTile(m_tif, TIFFComputeTile(m_tif, x, y, 0, 0), buffer, -1);
+      });
+    } else {
+      std::uint32_t rows_per_strip = 0;
+      TIFFGetFieldDefaulted(m_tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+      const Index strip_height = std::min<Index>(rows_per_strip, shape[1]);
+      read_blocks(region, {shape[0], strip_height}, TIFFStripSize(m_tif), data, [&](Index, Index y, void* buffer) {
+        return TIFFReadEncodedStrip(m_tif, TIFFComputeStrip(m_tif, y, 0), buffer, -1);
+      });
+    }
+  }
+
+  /**
+   * @brief Decode the blocks (strips or tiles) which intersect a region, and copy the intersections.
+   * @param region The region
+   * @param block_shape The block shape
+   * @param block_size The decoded block size in bytes
+   * @param data The output data
+   * @param decode The block decoder, called as `decode(x, y, buffer)` for the block which contains pixel `(x, y)`
+   */
+  template <typename T, typename TDecode>
+  void read_blocks(const Box<2>& region, Position<2> block_shape, Index block_size, T* data, TDecode&& decode)
+  {
+    std::vector<T> buffer(std::max<Index>(block_size / sizeof(T), block_shape[0] * block_shape[1]));
+    const auto width = region.length(0);
+    const auto x0 = region.front()[0] / block_shape[0] * block_shape[0];
+    const auto y0 = region.front()[1] / block_shape[1] * block_shape[1];
+    for (Index y = y0; y <= region.back()[1]; y += block_shape[1]) {
+      for (Index x = x0; x <= region.back()[0]; x += block_shape[0]) {
+        if (decode(x, y, buffer.data()) < 0) {
+          throw FileFormatError("Cannot decode block in", m_path);
+        }
+        const auto front_x = std::max(x, region.front()[0]);
+        const auto back_x = std::min(x + block_shape[0] - 1, region.back()[0]);
+        const auto front_y = std::max(y, region.front()[1]);
+        const auto back_y = std::min(y + block_shape[1] - 1, region.back()[1]);
+        for (Index j = front_y; j <= back_y; ++j) {
+          const auto* src = buffer.data() + (j - y) * block_shape[0] + (front_x - x);
+          auto* dst = data + (j - region.front()[1]) * width + (front_x - region.front()[0]);
+          std::copy_n(src, back_x - front_x + 1, dst);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Check that the current page is made of single samples of type `T`.
+   */
+  template <typename T>
+  void check_format()
+  {
+    std::uint16_t samples = 1;
+    std::uint16_t bits = 1;
+    std::uint16_t format = SAMPLEFORMAT_UINT;
+    TIFFGetFieldDefaulted(m_tif, TIFFTAG_SAMPLESPERPIXEL, &samples);
+    TIFFGetFieldDefaulted(m_tif, TIFFTAG_BITSPERSAMPLE, &bits);
+    TIFFGetFieldDefaulted(m_tif, TIFFTAG_SAMPLEFORMAT, &format);
+    std::uint16_t expected = SAMPLEFORMAT_UINT;
+    if constexpr (std::is_floating_point_v<T>) {
+      expected = SAMPLEFORMAT_IEEEFP;
+    } else if constexpr (std::is_signed_v<T>) {
+      expected = SAMPLEFORMAT_INT;
+    }
+    if (samples != 1) {
+      throw FileFormatError("Unsupported samples per pixel: " + std::to_string(samples) + " in", m_path);
+    }
+    if (bits != 8 * sizeof(T) || format != expected) {
+      throw FileFormatError("Type mismatch: " + std::to_string(bits) + "-bit samples in", m_path);
+    }
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
+
+  /**
+   * @brief The file handle.
+   */
   TIFF* m_tif;
 };
 
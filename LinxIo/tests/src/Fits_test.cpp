@@ -6,7 +6,9 @@
 #include "Linx/Io.h"
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm> // equal
 #include <fstream>
+#include <vector>
 
 using namespace Linx;
 
@@ -79,6 +81,202 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(auto_append_read_test, T, SupportedFitsTypes)
   BOOST_TEST(out == in);
 }
 
+BOOST_AUTO_TEST_CASE(chunk_write_read_test)
+{
+  Raster<float, 3> in({4, 3, 5});
+  in.range();
+  TemporaryPath path("chunks.fits");
+  Fits io(path);
+  io.write_shape<float>(in.shape());
+  BOOST_TEST(io.read_shape<3>() == in.shape());
+  io.write_chunk(in.chunk(0), 0);
+  io.write_chunk(in.chunk(2, 4), 2);
+  const auto chunk = io.read_chunk<Raster<float, 3>>(1, 3);
+  BOOST_TEST((chunk.shape() == Position<3>({4, 3, 3})));
+  BOOST_TEST(chunk.section(1) == in.section(2));
+  for (const auto& e : chunk.section(0)) {
+    BOOST_TEST(e == 0);
+  }
+  io.write_chunk(in.chunk(1), 1);
+  const auto out = io.read<Raster<float, 3>>();
+  BOOST_TEST(out == in);
+}
+
+BOOST_AUTO_TEST_CASE(patch_write_read_test)
+{
+  Raster<int, 3> in({5, 4, 3});
+  in.range();
+  const Box<3> region({1, 1, 0}, {3, 2, 1});
+  const auto patch = in(region);
+  TemporaryPath path("patch.fits");
+  Fits io(path);
+  io.write(patch);
+  const auto out = io.read<Raster<int, 3>>();
+  BOOST_TEST((out.shape() == region.shape()));
+  BOOST_TEST(std::equal(out.begin(), out.end(), patch.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(compressed_write_read_test)
+{
+  Raster<int, 3> in({16, 8, 3});
+  in.range();
+  TemporaryPath path("compressed.fits");
+  Fits io(path);
+  Fits::Compression rice;
+  rice.tile = Position<-1>({16, 8, 1});
+  io.write(in, rice);
+  Fits::Compression gzip {GZIP_2};
+  io.write(in, gzip, 'a');
+  io.write(in, 'a');
+  const auto count = io.hdu_count();
+  BOOST_TEST(count >= 3);
+  for (Index i = count - 3; i < count; ++i) {
+    BOOST_TEST((io.read<Raster<int, 3>>(i) == in));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(region_read_test)
+{
+  Raster<int, 3> in({5, 4, 3});
+  in.range();
+  TemporaryPath path("region.fits");
+  Fits io(path);
+  io.write(in);
+  const Box<3> region({1, 1, 0}, {3, 2, 1});
+  const auto expected = in(region);
+  const auto out = io.read<Raster<int, 3>>(region);
+  BOOST_TEST((out.shape() == region.shape()));
+  BOOST_TEST(std::equal(out.begin(), out.end(), expected.begin()));
+  const Grid<3> grid(Box<3>({0, 0, 0}, {4, 3, 2}), 2);
+  const auto sampled = io.read<Raster<int, 3>>(grid);
+  const auto expected_sampled = in(grid);
+  BOOST_TEST((sampled.shape() == grid.shape()));
+  BOOST_TEST(std::equal(sampled.begin(), sampled.end(), expected_sampled.begin()));
+  Raster<int, 3> stamps({5, 4, 3});
+  auto patch = stamps(region);
+  io.read_to(region, patch);
+  BOOST_TEST(std::equal(patch.begin(), patch.end(), expected.begin()));
+  BOOST_TEST((stamps[{0, 0, 0}] == 0));
+}
+
+BOOST_AUTO_TEST_CASE(open_append_read_test)
+{
+  TemporaryPath path("open.fits");
+  Fits io(path);
+  BOOST_TEST(not io.is_open());
+  io.open('x');
+  BOOST_TEST(io.is_open());
+  std::vector<Raster<int>> in;
+  for (int i = 0; i < 10; ++i) {
+    in.emplace_back(Position<2>({3, 2}));
+    in.back().fill(i);
+    io.write(in.back(), 'a');
+  }
+  BOOST_TEST(io.hdu_count() == 10);
+  Fits moved(std::move(io));
+  BOOST_TEST(not io.is_open());
+  BOOST_TEST(moved.is_open());
+  for (int i = 9; i >= 0; --i) {
+    BOOST_TEST(moved.read<Raster<int>>(i) == in[i]);
+  }
+  moved.close();
+  BOOST_TEST(not moved.is_open());
+  BOOST_TEST(moved.read<Raster<int>>(5) == in[5]);
+}
+
+BOOST_AUTO_TEST_CASE(open_read_then_write_test)
+{
+  TemporaryPath path("reopen.fits");
+  Raster<int> in({3, 2});
+  in.range();
+  Fits io(path);
+  io.write(in);
+  io.open('r');
+  BOOST_TEST(io.read<Raster<int>>() == in);
+  BOOST_CHECK_THROW(io.write(in, 'x'), PathExistsError);
+  io.write(in, 'a');
+  BOOST_TEST(io.is_open());
+  BOOST_TEST(io.hdu_count() == 2);
+  auto chunk = in.chunk(1, 1);
+  chunk.fill(-1);
+  io.open('r');
+  io.write_chunk(chunk, 1);
+  const auto out = io.read<Raster<int>>();
+  BOOST_TEST((out[{0, 1}] == -1));
+  BOOST_TEST((out[{0, 0}] == 0));
+  io.close();
+}
+
+BOOST_AUTO_TEST_CASE(chunks_sections_read_test)
+{
+  Raster<float, 3> in({4, 3, 5});
+  in.range();
+  TemporaryPath path("stream.fits");
+  Fits io(path);
+  io.write(in);
+  for (bool prefetch : {false, true}) {
+    Index front = 0;
+    for (const auto& chunk : io.chunks<Raster<float, 3>>(2, 0, prefetch)) {
+      const auto back = std::min(front + 1, in.length(2) - 1);
+      BOOST_TEST(chunk.length(2) == back - front + 1);
+      const auto expected = in.chunk(front, back);
+      BOOST_TEST(std::equal(chunk.begin(), chunk.end(), expected.begin()));
+      front += 2;
+    }
+    BOOST_TEST(front == 6);
+    Index index = 0;
+    for (const auto& section : io.sections<Raster<float, 2>>(0, prefetch)) {
+      BOOST_TEST(section == in.section(index));
+      ++index;
+    }
+    BOOST_TEST(index == 5);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_each_stack_test)
+{
+  std::vector<TemporaryPath> paths;
+  paths.reserve(4); // The destructor removes the file
+  std::vector<Raster<float>> in;
+  for (int i = 0; i < 4; ++i) {
+    paths.emplace_back("batch" + std::to_string(i) + ".fits");
+    in.emplace_back(Position<2>({5, 3}));
+    in.back().range(i);
+    write(in.back(), paths.back());
+  }
+  std::vector<std::filesystem::path> list(paths.begin(), paths.end());
+  const auto each = read_each<float>(list, 0, Threads(2));
+  BOOST_TEST(each.size() == in.size());
+  const auto stack = read_stack<float>(list, 0, Threads(2));
+  BOOST_TEST((stack.shape() == Position<3>({5, 3, 4})));
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST((each[i] == in[i]));
+    BOOST_TEST((stack.section(i) == in[i]));
+  }
+  TemporaryPath other("batch_other.fits");
+  write(Raster<float>({3, 5}), other);
+  list.push_back(other);
+  BOOST_CHECK_THROW(read_stack<float>(list), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(map_test)
+{
+  Raster<float, 3> in({5, 4, 3});
+  in.range();
+  TemporaryPath path("mapped.fits");
+  Fits io(path);
+  write(Raster<int, 0>(), path); // Empty Primary
+  io.write(in, 'a');
+  const auto mapped = io.map<float, 3>(1);
+  BOOST_TEST((mapped.shape() == in.shape()));
+  BOOST_TEST(std::equal(mapped.begin(), mapped.end(), in.begin()));
+  const Box<3> region({1, 1, 1}, {3, 2, 2});
+  const auto patch = mapped(region);
+  const auto expected = in(region);
+  BOOST_TEST(std::equal(patch.begin(), patch.end(), expected.begin()));
+  BOOST_CHECK_THROW((io.map<double, 3>(1)), FileFormatError);
+}
+
 BOOST_AUTO_TEST_CASE(auto_read_wrong_format_test)
 {
   TemporaryPath path("dummy.txt"); // FIXME .fits
@@ -0,0 +1,72 @@
+/// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Temporary.h"
+#include "LinxIo/Png.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Png_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(gray_write_read_test)
+{
+  Raster<std::uint8_t> in({17, 5});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 256;
+  });
+  TemporaryPath path("gray.png");
+  Png io(path);
+  io.write(in);
+  const auto out = io.read<Raster<std::uint8_t>>();
+  BOOST_TEST(out == in);
+  BOOST_CHECK_THROW(io.write(in), PathExistsError);
+  const auto channels = io.read<Raster<std::uint8_t, 3>>();
+  BOOST_TEST(channels.shape() == Position<3>({1, 17, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(rgba16_write_read_test)
+{
+  Raster<std::uint16_t, 3> in({4, 7, 3});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 65536;
+  });
+  TemporaryPath path("rgba.png");
+  Png io(path);
+  io.write(in);
+  const auto out = io.read<Raster<std::uint16_t, 3>>();
+  BOOST_TEST(out == in);
+  BOOST_CHECK_THROW(io.read<Raster<std::uint16_t>>(), FileFormatError); // 4 channels as 2D
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_read_test)
+{
+  TemporaryPath path("corrupted.png");
+  std::ofstream(path.string()) << "Not a PNG file";
+  BOOST_CHECK_THROW(Png(path).read<Raster<std::uint8_t>>(), FileFormatError);
+}
+
+BOOST_AUTO_TEST_CASE(truncated_read_test)
+{
+  Raster<std::uint8_t> in({64, 64});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 256;
+  });
+  TemporaryPath path("truncated.png");
+  Png io(path);
+  io.write(in);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2); // Header is kept
+  BOOST_CHECK_THROW(io.read<Raster<std::uint8_t>>(), FileFormatError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+/// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io.h"
+
+#include <boost/test/unit_test.hpp>
+#include <complex>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Raw_test)
+
+//-----------------------------------------------------------------------------
+
+using SupportedRawTypes = std::tuple<bool, char, unsigned short, int, long long, float, double, std::complex<float>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(write_read_test, T, SupportedRawTypes)
+{
+  Raster<T, 3> in({5, 4, 3});
+  Index i = 0;
+  for (auto& e : in) {
+    e = T(i % 7);
+    ++i;
+  }
+  TemporaryPath path("checkpoint.raw");
+  Raw io(path);
+  io.write(in);
+  BOOST_TEST((io.read_shape<3>() == in.shape()));
+  const auto out = io.read<AlignedRaster<T, 3>>();
+  BOOST_TEST(out == in);
+  BOOST_CHECK_THROW(io.write(in), PathExistsError);
+  io.write(in, 'w');
+}
+
+BOOST_AUTO_TEST_CASE(map_test)
+{
+  Raster<float, 2> in({7, 5});
+  in.range();
+  TemporaryPath path("mapped.raw");
+  Raw io(path);
+  io.write(in);
+  const auto mapped = io.map<float>();
+  BOOST_TEST(mapped == in);
+  BOOST_TEST(is_aligned(mapped.data(), Raw::alignment));
+}
+
+BOOST_AUTO_TEST_CASE(mismatch_test)
+{
+  TemporaryPath path("mismatch.raw");
+  Raw io(path);
+  io.write(Raster<int, 2>({3, 2}));
+  BOOST_CHECK_THROW((io.read<Raster<float, 2>>()), FileFormatError);
+  BOOST_CHECK_THROW((io.read<Raster<int, 3>>()), FileFormatError);
+  BOOST_TEST((io.read<Raster<int, -1>>().shape() == Position<-1>({3, 2})));
+  TemporaryPath other("other.raw");
+  write(Raster<int, 2>({3, 2}), other);
+  BOOST_CHECK_THROW(Raw(other).read<Raster<int>>(), FileFormatError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Temporary_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(temporary_path_test)
+{
+  std::filesystem::path copy;
+  {
+    TemporaryPath path("temporary.txt");
+    copy = path;
+    std::ofstream(copy) << "content";
+    BOOST_TEST(std::filesystem::exists(copy));
+  }
+  BOOST_TEST(not std::filesystem::exists(copy));
+}
+
+BOOST_AUTO_TEST_CASE(scratch_usage_test)
+{
+  ScratchSpace scratch({std::filesystem::temp_directory_path()}, 1000);
+  BOOST_TEST(std::filesystem::is_directory(scratch.path()));
+  BOOST_TEST(scratch.budget() == 1000);
+  BOOST_TEST(scratch.usage() == 0);
+  std::filesystem::path path;
+  {
+    auto file = scratch.allocate(600, "spill");
+    path = file.path();
+    BOOST_TEST(std::filesystem::file_size(path) == 600);
+    BOOST_TEST(scratch.usage() == 600);
+    BOOST_CHECK_THROW(scratch.allocate(600), Exception);
+    BOOST_TEST(scratch.usage() == 600);
+    auto moved = std::move(file);
+    auto other = scratch.allocate(400);
+    BOOST_TEST(scratch.usage() == 1000);
+  }
+  BOOST_TEST(scratch.usage() == 0);
+  BOOST_TEST(not std::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(scratch_raster_test)
+{
+  ScratchSpace scratch;
+  Raster<float, 3> in({7, 5, 3});
+  in.range();
+  auto file = scratch.allocate(in.size() * sizeof(float));
+  auto spill = file.raster<float>(in.shape());
+  std::copy(in.begin(), in.end(), spill.begin());
+  BOOST_TEST(spill == in);
+  BOOST_CHECK_THROW(file.raster<float>(Position<3>({7, 5, 4})), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(scratch_root_test)
+{
+  TemporaryPath fast("fast");
+  std::filesystem::create_directories(fast);
+  std::filesystem::path path;
+  {
+    ScratchSpace scratch({"/nonexistent/linx", fast, std::filesystem::temp_directory_path()}, 1024);
+    path = scratch.path();
+    BOOST_TEST(path.parent_path() == std::filesystem::path(fast));
+  }
+  BOOST_TEST(not std::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(stale_cleanup_test)
+{
+  TemporaryPath root("stale");
+  const auto stale = std::filesystem::path(root) / "linx-scratch-otherhost-999999999-0";
+  std::filesystem::create_directories(stale);
+  std::ofstream(stale / ".lock").close(); // Unlocked, as if the owner was dead
+  const auto unknown = std::filesystem::path(root) / "linx-scratch-unknown";
+  std::filesystem::create_directories(unknown); // No lock file
+  ScratchSpace scratch({root}, 1024);
+  BOOST_TEST(not std::filesystem::exists(stale));
+  BOOST_TEST(std::filesystem::exists(unknown));
+  BOOST_TEST(std::filesystem::exists(scratch.path()));
+  ScratchSpace other({root}, 1024);
+  BOOST_TEST(std::filesystem::exists(scratch.path())); // Locked, hence alive
+  BOOST_TEST(std::filesystem::exists(other.path()));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
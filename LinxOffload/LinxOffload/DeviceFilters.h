@@ -0,0 +1,157 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXOFFLOAD_DEVICEFILTERS_H
+#define _LINXOFFLOAD_DEVICEFILTERS_H
+
+#include "Linx/Data/Mask.h"
+#include "Linx/Data/Raster.h"
+#include "LinxOffload/DeviceRaster.h"
+
+#include <algorithm> // max, min
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Throw if the input and output device rasters are incompatible.
+ */
+template <typename T, typename U>
+void check_device_io(const DeviceRaster<T, 2>& in, const DeviceRaster<U, 2>& out)
+{
+  if (in.shape() != out.shape()) {
+    throw Exception("Input and output device raster shapes differ");
+  }
+  if (in.device().id() != out.device().id()) {
+    throw Exception("Input and output device rasters live on different devices");
+  }
+}
+
+/**
+ * @brief Apply a morphological operation on the device, with nearest-neighbor extrapolation.
+ * @param init The neutral element
+ * @param func The reduction function, called as `func(current, value)`
+ */
+template <typename T, typename TFunc>
+DeviceRaster<T, 2>& device_morphology(
+    const DeviceRaster<T, 2>& in,
+    const Mask<2>& window,
+    DeviceRaster<T, 2>& out,
+    T init,
+    TFunc&& func)
+{
+  check_device_io(in, out);
+  std::vector<Index> offsets;
+  for (const auto& p : window) {
+    offsets.push_back(p[0]);
+    offsets.push_back(p[1]);
+  }
+  const Index count = offsets.size();
+  const auto* o = offsets.data();
+  const auto width = in.length(0);
+  const auto height = in.length(1);
+  const auto* src = in.data();
+  auto* dst = out.data();
+#pragma omp target teams distribute parallel for collapse(2) device(in.device().id()) is_device_ptr(src, dst) \
+    map(to : o[0 : count])
+  for (Index y = 0; y < height; ++y) {
+    for (Index x = 0; x < width; ++x) {
+      T value = init;
+      for (Index k = 0; k < count; k += 2) {
+        const auto sx = std::min(std::max<Index>(x + o[k], 0), width - 1);
+        const auto sy = std::min(std::max<Index>(y + o[k + 1], 0), height - 1);
+        value = func(value, src[sx + sy * width]);
+      }
+      dst[x + y * width] = value;
+    }
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup offload
+ * @brief Convolve a device raster, with nearest-neighbor extrapolation.
+ * @param in The input raster
+ * @param values The kernel values
+ * @param origin The kernel origin
+ * @param out The output raster, of same shape as the input and on the same device
+ *
+ * This is the device counterpart of `convolution(values, origin).transform(extrapolation<Nearest>(in), out)`.
+ * Each output pixel is computed by a device thread.
+ */
+template <typename T, typename U, typename THolder>
+DeviceRaster<T, 2>& convolve(
+    const DeviceRaster<T, 2>& in,
+    const Raster<U, 2, THolder>& values,
+    const Position<2>& origin,
+    DeviceRaster<T, 2>& out)
+{
+  Internal::check_device_io(in, out);
+  const std::vector<T> kernel(values.begin(), values.end());
+  const Index size = kernel.size();
+  const auto* k = kernel.data();
+  const auto kernel_width = values.length(0);
+  const auto kernel_height = values.length(1);
+  const auto dx = kernel_width - 1 - origin[0];
+  const auto dy = kernel_height - 1 - origin[1];
+  const auto width = in.length(0);
+  const auto height = in.length(1);
+  const auto* src = in.data();
+  auto* dst = out.data();
+#pragma omp target teams distribute parallel for collapse(2) device(in.device().id()) is_device_ptr(src, dst) \
+    map(to : k[0 : size])
+  for (Index y = 0; y < height; ++y) {
+    for (Index x = 0; x < width; ++x) {
+      T sum = 0;
+      for (Index j = 0; j < kernel_height; ++j) {
+        const auto sy = std::min(std::max<Index>(y + dy - j, 0), height - 1);
+        for (Index i = 0; i < kernel_width; ++i) {
+          const auto sx = std::min(std::max<Index>(x + dx - i, 0), width - 1);
+          sum += k[i + j * kernel_width] * src[sx + sy * width];
+        }
+      }
+      dst[x + y * width] = sum;
+    }
+  }
+  return out;
+}
+
+/**
+ * @ingroup offload
+ * @brief Dilate a device raster, with nearest-neighbor extrapolation.
+ *
+ * This is the device counterpart of `dilation<T>(window).transform(extrapolation<Nearest>(in), out)`.
+ */
+template <typename T>
+DeviceRaster<T, 2>& dilate(const DeviceRaster<T, 2>& in, const Mask<2>& window, DeviceRaster<T, 2>& out)
+{
+  return Internal::device_morphology(in, window, out, std::numeric_limits<T>::lowest(), [](T a, T b) {
+    return a < b ? b : a;
+  });
+}
+
+/**
+ * @ingroup offload
+ * @brief Erode a device raster, with nearest-neighbor extrapolation.
+ *
+ * This is the device counterpart of `erosion<T>(window).transform(extrapolation<Nearest>(in), out)`.
+ */
+template <typename T>
+DeviceRaster<T, 2>& erode(const DeviceRaster<T, 2>& in, const Mask<2>& window, DeviceRaster<T, 2>& out)
+{
+  return Internal::device_morphology(in, window, out, std::numeric_limits<T>::max(), [](T a, T b) {
+    return b < a ? b : a;
+  });
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,337 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXOFFLOAD_DEVICERASTER_H
+#define _LINXOFFLOAD_DEVICERASTER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+
+#include <future>
+#include <omp.h>
+#include <type_traits> // is_same_v, remove_const_t
+#include <utility> // exchange, swap
+
+namespace Linx {
+
+/**
+ * @ingroup offload
+ * @brief An OpenMP target device, i.e. the execution policy of the offloaded operations.
+ *
+ * The default device is the OpenMP default device if any, and the host otherwise,
+ * such that offloaded code runs everywhere, e.g. on CPU-only nodes or if Linx is built without offloading flags.
+ * Offloaded operations take a `Device` where their CPU counterparts take some `Threads`.
+ */
+class Device {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param id The OpenMP device number
+   */
+  explicit Device(int id = default_id()) : m_id(id) {}
+
+  /**
+   * @brief Get the host, as a device.
+   */
+  static Device host()
+  {
+    return Device(omp_get_initial_device());
+  }
+
+  /**
+   * @brief Get the number of available non-host devices.
+   */
+  static Index count()
+  {
+    return omp_get_num_devices();
+  }
+
+  /**
+   * @brief Get the OpenMP device number.
+   */
+  int id() const
+  {
+    return m_id;
+  }
+
+  /**
+   * @brief Check whether the device is the host.
+   */
+  bool is_host() const
+  {
+    return m_id == omp_get_initial_device();
+  }
+
+private:
+
+  /**
+   * @brief Get the default device number.
+   */
+  static int default_id()
+  {
+    return omp_get_num_devices() > 0 ? omp_get_default_device() : omp_get_initial_device();
+  }
+
+  /**
+   * @brief The device number.
+   */
+  int m_id;
+};
+
+/**
+ * @ingroup offload
+ * @brief A raster whose data lives in device memory.
+ * @tparam T The value type
+ * @tparam N The dimension
+ *
+ * Data is allocated with `omp_target_alloc()`, and transferred explicitly from and to host rasters,
+ * either synchronously with `upload()` and `download()`, or asynchronously with `upload_async()` and `download_async()`,
+ * such that transfers overlap with host computations.
+ * Device rasters are chained between offloaded operations without round-trips to the host.
+ *
+ * \code
+ * DeviceRaster<float> d_in(in); // Upload
+ * DeviceRaster<float> d_out(in.shape());
+ * convolve(d_in, kernel, origin, d_out);
+ * const auto out = d_out.download();
+ * \endcode
+ */
+template <typename T, Index N = 2>
+class DeviceRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Allocate an uninitialized raster.
+   */
+  explicit DeviceRaster(Position<N> shape, Device device = Device()) :
+      m_shape(LINX_MOVE(shape)), m_size(shape_size(m_shape)), m_device(device), m_data(nullptr)
+  {
+    if (m_size > 0) {
+      m_data = static_cast<T*>(omp_target_alloc(m_size * sizeof(T), m_device.id()));
+      if (not m_data) {
+        throw Exception("Cannot allocate device raster");
+      }
+    }
+  }
+
+  /**
+   * @brief Allocate a raster and upload some host data.
+   */
+  template <typename U, typename THolder>
+  explicit DeviceRaster(const Raster<U, N, THolder>& in, Device device = Device()) : DeviceRaster(in.shape(), device)
+  {
+    upload(in);
+  }
+
+  /**
+   * @brief Destructor.
+   */
+  ~DeviceRaster()
+  {
+    if (m_data) {
+      omp_target_free(m_data, m_device.id());
+    }
+  }
+
+  DeviceRaster(const DeviceRaster&) = delete;
+  DeviceRaster& operator=(const DeviceRaster&) = delete;
+
+  /**
+   * @brief Move constructor.
+   */
+  DeviceRaster(DeviceRaster&& other) :
+      m_shape(LINX_MOVE(other.m_shape)), m_size(std::exchange(other.m_size, 0)), m_device(other.m_device),
+      m_data(std::exchange(other.m_data, nullptr))
+  {}
+
+  /**
+   * @brief Move assignment.
+   */
+  DeviceRaster& operator=(DeviceRaster&& other)
+  {
+    std::swap(m_shape, other.m_shape);
+    std::swap(m_size, other.m_size);
+    std::swap(m_device, other.m_device);
+    std::swap(m_data, other.m_data);
+    return *this;
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the length along some axis.
+   */
+  Index length(Index i) const
+  {
+    return m_shape[i];
+  }
+
+  /**
+   * @brief Get the number of elements.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the device.
+   */
+  const Device& device() const
+  {
+    return m_device;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the device pointer, which is only dereferenceable on the device.
+   */
+  const T* data() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @copydoc data()
+   */
+  T* data()
+  {
+    return m_data;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Copy some host data to the device.
+   */
+  template <typename U, typename THolder>
+  void upload(const Raster<U, N, THolder>& in)
+  {
+    static_assert(std::is_same_v<std::remove_const_t<U>, T>, "Host and device value types differ");
+    check_shape(in.shape());
+    copy(m_data, in.data(), m_device.id(), omp_get_initial_device());
+  }
+
+  /**
+   * @brief Copy some host data to the device asynchronously.
+   *
+   * The host and device rasters must not be modified nor destroyed until the returned future is ready.
+   */
+  template <typename U, typename THolder>
+  std::future<void> upload_async(const Raster<U, N, THolder>& in)
+  {
+    static_assert(std::is_same_v<std::remove_const_t<U>, T>, "Host and device value types differ");
+    check_shape(in.shape());
+    return std::async(std::launch::async, [this, data = in.data()]() {
+      copy(m_data, data, m_device.id(), omp_get_initial_device());
+    });
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Copy the device data to some host raster.
+   */
+  template <typename THolder>
+  void download(Raster<T, N, THolder>& out) const
+  {
+    check_shape(out.shape());
+    copy(out.data(), m_data, omp_get_initial_device(), m_device.id());
+  }
+
+  /**
+   * @brief Copy the device data to a new host raster.
+   */
+  Raster<T, N> download() const
+  {
+    Raster<T, N> out(m_shape);
+    download(out);
+    return out;
+  }
+
+  /**
+   * @brief Copy the device data to some host raster asynchronously.
+   *
+   * The host raster must not be accessed, and neither raster destroyed, until the returned future is ready.
+   */
+  template <typename THolder>
+  std::future<void> download_async(Raster<T, N, THolder>& out) const
+  {
+    check_shape(out.shape());
+    return std::async(std::launch::async, [this, data = out.data()]() {
+      copy(data, m_data, omp_get_initial_device(), m_device.id());
+    });
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Throw if some host shape differs from the device shape.
+   */
+  void check_shape(const Position<N>& shape) const
+  {
+    if (shape != m_shape) {
+      throw Exception("Host and device raster shapes differ");
+    }
+  }
+
+  /**
+   * @brief Copy the raster data between devices.
+   */
+  void copy(T* dst, const T* src, int dst_device, int src_device) const
+  {
+    if (m_size > 0) {
+      omp_target_memcpy(dst, const_cast<T*>(src), m_size * sizeof(T), 0, 0, dst_device, src_device);
+    }
+  }
+
+  /**
+   * @brief The shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The number of elements.
+   */
+  Index m_size;
+
+  /**
+   * @brief The device.
+   */
+  Device m_device;
+
+  /**
+   * @brief The device pointer.
+   */
+  T* m_data;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,77 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXOFFLOAD_DEVICEWARP_H
+#define _LINXOFFLOAD_DEVICEWARP_H
+
+#include "Linx/Transforms/Affinity.h"
+#include "LinxOffload/DeviceRaster.h"
+
+namespace Linx {
+
+/**
+ * @ingroup offload
+ * @brief Apply an affine transform to a device raster, with constant extrapolation.
+ * @tparam TMethod The interpolation method, e.g. `Linear` or `Cubic`
+ * @param in The input raster
+ * @param affinity The transform
+ * @param out The output raster, on the same device as the input
+ * @param value The extrapolation value
+ *
+ * This is the device counterpart of `affinity.transform(interpolation<TMethod>(extrapolation(in, value)), out)`.
+ * The inverse transform is evaluated on the host once:
+ * since it is affine, the input position of output pixel `(x, y)` is `q0 + x * ex + y * ey`,
+ * which is computed on the device together with the `TMethod::weights()` of each axis.
+ */
+template <typename TMethod, typename T>
+DeviceRaster<T, 2>&
+warp(const DeviceRaster<T, 2>& in, const Affinity<2>& affinity, DeviceRaster<T, 2>& out, T value = T())
+{
+  if (in.device().id() != out.device().id()) {
+    throw Exception("Input and output device rasters live on different devices");
+  }
+  constexpr Index taps = TMethod::Taps;
+  const auto inv = inverse(affinity);
+  const auto q0 = inv(Position<2>::zero());
+  const auto ex = inv(Position<2> {1, 0}) - q0;
+  const auto ey = inv(Position<2> {0, 1}) - q0;
+  const double q0x = q0[0];
+  const double q0y = q0[1];
+  const double exx = ex[0];
+  const double exy = ex[1];
+  const double eyx = ey[0];
+  const double eyy = ey[1];
+  const auto in_width = in.length(0);
+  const auto in_height = in.length(1);
+  const auto width = out.length(0);
+  const auto height = out.length(1);
+  const auto* src = in.data();
+  auto* dst = out.data();
+#pragma omp target teams distribute parallel for collapse(2) device(in.device().id()) is_device_ptr(src, dst)
+  for (Index y = 0; y < height; ++y) {
+    for (Index x = 0; x < width; ++x) {
+      double wx[taps];
+      double wy[taps];
+      const auto fx = TMethod::weights(q0x + x * exx + y * eyx, wx);
+      const auto fy = TMethod::weights(q0y + x * exy + y * eyy, wy);
+      double sum = 0;
+      for (Index j = 0; j < taps; ++j) {
+        const auto sy = fy + j;
+        double row = 0;
+        for (Index i = 0; i < taps; ++i) {
+          const auto sx = fx + i;
+          const bool inside = sx >= 0 && sx < in_width && sy >= 0 && sy < in_height;
+          row += wx[i] * (inside ? src[sx + sy * in_width] : value);
+        }
+        sum += wy[j] * row;
+      }
+      dst[x + y * width] = sum;
+    }
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
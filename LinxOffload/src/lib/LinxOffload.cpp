@@ -0,0 +1,7 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxOffload/DeviceFilters.h"
+#include "LinxOffload/DeviceRaster.h"
+#include "LinxOffload/DeviceWarp.h"
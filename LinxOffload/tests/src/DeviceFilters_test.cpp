@@ -0,0 +1,62 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxOffload/DeviceFilters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Make a random image.
+ */
+Raster<float> make_image()
+{
+  Raster<float> out({37, 23});
+  out.generate(UniformNoise<float>(0, 1, 42));
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DeviceFilters_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(convolve_test)
+{
+  const auto in = make_image();
+  const auto values = Raster<float>({5, 3}).range();
+  const Position<2> origin {1, 2}; // Off-center
+  const auto expected = convolution(values, origin) * extrapolation<Nearest>(in);
+  DeviceRaster<float> d_in(in);
+  DeviceRaster<float> d_out(in.shape());
+  const auto out = convolve(d_in, values, origin, d_out).download();
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    BOOST_TEST(std::abs(out[i] - expected[i]) < 1e-4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(morphology_test)
+{
+  const auto in = make_image();
+  const auto window = Mask<2>::ball<2>(2);
+  DeviceRaster<float> d_in(in);
+  DeviceRaster<float> d_out(in.shape());
+  BOOST_TEST(dilate(d_in, window, d_out).download() == dilation<float>(window) * extrapolation<Nearest>(in));
+  BOOST_TEST(erode(d_in, window, d_out).download() == erosion<float>(window) * extrapolation<Nearest>(in));
+}
+
+BOOST_AUTO_TEST_CASE(shape_mismatch_test)
+{
+  DeviceRaster<float> d_in({4, 4});
+  DeviceRaster<float> d_out({4, 5});
+  BOOST_CHECK_THROW(dilate(d_in, Mask<2>::ball<2>(1), d_out), Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxOffload/DeviceRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DeviceRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(default_device_test)
+{
+  const Device device;
+  BOOST_TEST(device.is_host() == (Device::count() == 0));
+  BOOST_TEST(Device::host().is_host());
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+  const auto in = Raster<float>({7, 5}).range();
+  const DeviceRaster<float> d(in);
+  BOOST_TEST(d.shape() == in.shape());
+  BOOST_TEST(d.size() == in.size());
+  BOOST_TEST(d.download() == in);
+  Raster<float> out(in.shape());
+  d.download(out);
+  BOOST_TEST(out == in);
+}
+
+BOOST_AUTO_TEST_CASE(async_round_trip_test)
+{
+  const auto in = Raster<int>({64, 32}).range();
+  DeviceRaster<int> d(in.shape());
+  d.upload_async(in).wait();
+  Raster<int> out(in.shape());
+  auto done = d.download_async(out);
+  done.wait();
+  BOOST_TEST(out == in);
+}
+
+BOOST_AUTO_TEST_CASE(move_test)
+{
+  const auto in = Raster<double>({3, 3}).range();
+  DeviceRaster<double> d(in);
+  const auto* data = d.data();
+  DeviceRaster<double> moved(std::move(d));
+  BOOST_TEST(moved.data() == data);
+  BOOST_TEST(d.data() == nullptr);
+  BOOST_TEST(moved.download() == in);
+}
+
+BOOST_AUTO_TEST_CASE(shape_mismatch_test)
+{
+  DeviceRaster<float> d({4, 4});
+  Raster<float> out({4, 5});
+  BOOST_CHECK_THROW(d.download(out), Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "LinxOffload/DeviceWarp.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Check that a device warp matches the host warp.
+ */
+template <typename TMethod>
+void check_warp(const Affinity<2>& affinity)
+{
+  Raster<float> in({41, 29});
+  in.generate(UniformNoise<float>(0, 1, 42));
+  Raster<float> expected({35, 33});
+  affinity.transform(interpolation<TMethod>(extrapolation(in, 0.F)), expected);
+  DeviceRaster<float> d_in(in);
+  DeviceRaster<float> d_out(expected.shape());
+  const auto out = warp<TMethod>(d_in, affinity, d_out).download();
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    BOOST_TEST(std::abs(out[i] - expected[i]) < 1e-4);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DeviceWarp_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(linear_rotation_test)
+{
+  check_warp<Linear>(Affinity<2>::rotation_deg(20, 0, 1, {20, 14}));
+}
+
+BOOST_AUTO_TEST_CASE(cubic_affinity_test)
+{
+  Affinity<2> affinity({20, 14});
+  affinity += {1.5, -.5};
+  affinity *= 1.1;
+  affinity.rotate_deg(-35);
+  check_warp<Cubic>(affinity);
+}
+
+BOOST_AUTO_TEST_CASE(cubic_translation_test)
+{
+  check_warp<Cubic>(Affinity<2>::translation({2.3, -1.7})); // Separable on the host
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,9 @@
 
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/IntegralImage.h"
+#include "Linx/Transforms/Labeling.h"
+#include "Linx/Transforms/RobustNoise.h"
 
 namespace Linx {
 namespace Cosmics {
@@ -30,15 +33,18 @@ public:
   }
 
   template <typename TIn>
-  T operator()(const TIn& neighbors) const
+  T operator()(const TIn& neighbors, std::vector<T>& centered) const
   {
     const auto mean = std::accumulate(neighbors.begin(), neighbors.end(), T()) / neighbors.size();
-    auto centered = neighbors;
-    std::transform(centered.begin(), centered.end(), centered.begin(), [=](auto& e) {
+    std::transform(neighbors.begin(), neighbors.end(), centered.begin(), [=](auto e) {
       return e - mean;
     });
     const auto sum2 = std::inner_product(centered.begin(), centered.end(), centered.begin(), T());
-    return std::inner_product(m_template.begin(), m_template.end(), centered.begin(), T()) / std::sqrt(m_sum2 * sum2);
+    const auto norm = std::sqrt(m_sum2 * sum2);
+    if (norm <= 0) { // Flat neighborhood or template
+      return 0;
+    }
+    return std::inner_product(m_template.begin(), m_template.end(), centered.begin(), T()) / norm;
   }
 
 private:
@@ -89,21 +95,87 @@ Raster<typename TPsf::Value> quotient(const TIn& in, const TPsf& psf)
   return filter * extrapolation<Nearest>(in);
 }
 
+/**
+ * @brief Compute the Pearson correlation coefficient map between an image and a template.
+ * @param in The input 2D raster, extrapolated with nearest neighbor
+ * @param psf The template, centered at `(psf.shape() - 1) / 2`
+ * @param convolution The convolution filter factory, called as `convolution(values, origin)`
+ * 
+ * This is equivalent to filtering with `PearsonCorrelation` without recomputing the neighborhood statistics
+ * at each position:
+ * the local sums and sums of squares are read from integral images, such that the normalization costs O(1) per pixel,
+ * and the numerator is the convolution of the input with the flipped, zero-mean template.
+ * The coefficient is 0 where the neighborhood or the template is flat.
+ * For large templates, the convolution is best computed in Fourier domain, e.g.:
+ * 
+ * \code
+ * auto map = Cosmics::match(in, psf, [](const auto& values, const auto& origin) {
+ *   return dft_convolution(values, origin);
+ * });
+ * \endcode
+ */
+template <typename TIn, typename TPsf, typename TFactory>
+Raster<typename TPsf::Value> match(const TIn& in, const TPsf& psf, TFactory&& convolution)
+{
+  using T = typename TPsf::Value;
+  const auto origin = (psf.shape() - 1) / 2;
+  const auto size = psf.size();
+
+  // Flipped, zero-mean template
+  const auto mean = std::accumulate(psf.begin(), psf.end(), T()) / size;
+  Raster<T> flipped(psf.shape());
+  std::transform(psf.begin(), psf.end(), flipped.begin(), [=](auto e) {
+    return e - mean;
+  });
+  std::reverse(flipped.begin(), flipped.end());
+  const auto template_sum2 = std::inner_product(flipped.begin(), flipped.end(), flipped.begin(), 0.);
+  Raster<T> out = convolution(flipped, psf.shape() - 1 - origin) * extrapolation<Nearest>(in);
+
+  // Local sums and sums of squares over the padded input
+  const auto window = psf.domain() - origin;
+  const auto domain = in.domain();
+  Raster<double> padded((domain + window).shape());
+  Raster<double> squares(padded.shape());
+  auto pit = padded.begin();
+  auto sit = squares.begin();
+  for (const auto& p : domain + window) {
+    *pit = in[clamp(p, in.shape())];
+    *sit = *pit * *pit;
+    ++pit;
+    ++sit;
+  }
+  const auto sums = integral_image(padded);
+  const auto sums2 = integral_image(squares);
+  const auto shape = window.shape();
+  auto it = out.begin();
+  for (const auto& p : domain) {
+    const auto box = Box<2>::from_shape(p, shape);
+    const auto sum = sums.sum(box);
+    const auto sum2 = std::max(sums2.sum(box) - sum * sum / size, 0.); // Cancellation on flat regions
+    const auto norm = std::sqrt(template_sum2 * sum2);
+    *it = norm > 0 ? *it / norm : 0;
+    ++it;
+  }
+  return out;
+}
+
+/**
+ * @brief Compute the Pearson correlation coefficient map between an image and a template, in direct space.
+ */
 template <typename TIn, typename TPsf>
 Raster<typename TPsf::Value> match(const TIn& in, const TPsf& psf)
 {
-  using T = typename TPsf::Value;
-  auto filter =
-      SimpleFilter<PearsonCorrelation<T, Box<2>>>(psf.domain() - (psf.shape() - 1) / 2, psf.begin(), psf.end());
-  return filter * extrapolation<Nearest>(in);
+  return match(in, psf, [](const auto& values, const auto& origin) {
+    return convolution(values, origin);
+  });
 }
 
 template <typename TIn>
 Raster<typename TIn::Value> laplacian(const TIn& in)
 {
   using T = typename TIn::Value;
-  const auto filter = convolution(
-      Raster<T>({3, 3}, {-1. / 6., -2. / 3., -1. / 6., -2. / 3., 10. / 3., -2. / 3., -1. / 6., -2. / 3., -1. / 6.}));
+  const auto filter = fixed_convolution<T, 3, 3>(
+      {-1. / 6., -2. / 3., -1. / 6., -2. / 3., 10. / 3., -2. / 3., -1. / 6., -2. / 3., -1. / 6.});
   return filter * extrapolation<Nearest>(in);
 }
 
@@ -111,61 +183,415 @@ template <typename TIn>
 Raster<typename TIn::Value> dilate(const TIn& in, Index radius = 1)
 {
   using T = typename TIn::Value;
-  auto filter = dilation<T>(Box<2>::from_center(radius)); // FIXME L2-ball?
+  auto filter = dilation<T>(Mask<2>::ball<2>(radius));
   return filter * extrapolation<Nearest>(in);
 }
 
+/**
+ * @brief Compute the mean over a square window with nearest-neighbor extrapolation.
+ * 
+ * The input is padded by `radius` and the means are read from its integral image,
+ * such that the cost per pixel is independent of the radius.
+ */
 template <typename TIn>
 Raster<typename TIn::Value> blur(const TIn& in, Index radius = 1)
 {
   using T = typename TIn::Value;
-  auto filter = mean_filter<T>(Box<2>::from_center(radius)); // FIXME L2-ball?
-  return filter * extrapolation<Nearest>(in);
+  const auto window = Box<2>::from_center(radius); // FIXME L2-ball?
+  const auto domain = in.domain();
+  Raster<T> padded((domain + window).shape());
+  auto it = padded.begin();
+  for (const auto& p : domain + window) {
+    *it = in[clamp(p, in.shape())];
+    ++it;
+  }
+  const auto table = integral_image(padded);
+  const auto shape = window.shape();
+  Raster<T> out(in.shape());
+  for (const auto& p : domain) {
+    out[p] = table.mean(Box<2>::from_shape(p, shape));
+  }
+  return out;
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the Laplacian map with nearest-neighbor extrapolation in a single pass over the data.
+ * @param func The function called on each Laplacian value
+ */
+template <typename TIn, typename TFunc>
+Raster<std::remove_const_t<typename TIn::Value>> fused_laplacian(const TIn& in, TFunc&& func)
+{
+  using T = std::remove_const_t<typename TIn::Value>;
+  const auto width = in.length(0);
+  const auto height = in.length(1);
+  Raster<T> out(in.shape());
+  for (Index y = 0; y < height; ++y) {
+    const auto* above = in.data() + std::max<Index>(y - 1, 0) * width;
+    const auto* row = in.data() + y * width;
+    const auto* below = in.data() + std::min<Index>(y + 1, height - 1) * width;
+    auto* line = out.data() + y * width;
+    for (Index x = 0; x < width; ++x) {
+      const auto left = std::max<Index>(x - 1, 0);
+      const auto right = std::min<Index>(x + 1, width - 1);
+      const T edges = above[x] + below[x] + row[left] + row[right];
+      const T corners = above[left] + above[right] + below[left] + below[right];
+      const T value = (T(20) * row[x] - T(4) * edges - corners) / T(6);
+      line[x] = value;
+      func(value);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Estimate the scale of the Laplacian values, assuming a Laplace distribution.
+ * @param in The Laplacian map
+ * @param noise The robust noise estimates of the map
+ * 
+ * The scale is estimated from the MAD.
+ * On quantized or flat data, the MAD may be 0, such that the detection threshold would collapse to the median;
+ * the scale then falls back to the mean absolute deviation from the median,
+ * which is the maximum likelihood estimate of the scale.
+ */
+template <typename TRaster>
+double laplace_scale(const TRaster& in, const RobustNoise& noise)
+{
+  if (noise.mad > 0) {
+    return noise.mad / std::log(2.0);
+  }
+  double sum = 0;
+  Index count = 0;
+  for (const auto& e : in) {
+    if (not std::isnan(e)) {
+      sum += std::abs(e - noise.median);
+      ++count;
+    }
+  }
+  return count > 0 ? sum / count : 0;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief Compute the Laplacian map with nearest-neighbor extrapolation, and its mean absolute value.
+ * @param in The input 2D raster
+ * @param norm The mean absolute value of the non-NaN Laplacian values
+ * 
+ * This is equivalent to `laplacian()` followed by the computation of the norm, yet in a single pass over the data.
+ */
+template <typename TIn>
+Raster<std::remove_const_t<typename TIn::Value>> laplacian(const TIn& in, double& norm)
+{
+  double sum = 0;
+  Index count = 0;
+  auto out = Internal::fused_laplacian(in, [&](auto value) {
+    if (not std::isnan(value)) {
+      sum += std::abs(value);
+      ++count;
+    }
+  });
+  norm = count > 0 ? sum / count : 0;
+  return out;
+}
+
+/**
+ * @brief A sparse map of cosmic ray hits, i.e. the sorted indices of the flagged pixels of a frame.
+ * 
+ * The memory footprint is proportional to the number of flagged pixels instead of the frame size,
+ * and the dense mask is only built on demand, with `raster()`.
+ * Indices are stored rather than positions, which halves the footprint and makes lookups a binary search.
+ */
+class Hits {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param shape The frame shape
+   */
+  explicit Hits(Position<2> shape = Position<2>::zero()) : m_shape(LINX_MOVE(shape)), m_indices() {}
+
+  /**
+   * @brief Create a sparse map from a dense mask, whose non-zero pixels are flagged.
+   */
+  template <typename TMask>
+  static Hits from_mask(const TMask& mask)
+  {
+    Hits out(mask.shape());
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+      if (mask[i]) {
+        out.m_indices.push_back(i);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the frame shape.
+   */
+  const Position<2>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the number of flagged pixels.
+   */
+  Index size() const
+  {
+    return m_indices.size();
+  }
+
+  /**
+   * @brief Get the sorted indices of the flagged pixels.
+   */
+  const std::vector<Index>& indices() const
+  {
+    return m_indices;
+  }
+
+  /**
+   * @brief Get the index of a position.
+   */
+  Index index(const Position<2>& p) const
+  {
+    return p[0] + m_shape[0] * p[1];
+  }
+
+  /**
+   * @brief Get the position of an index.
+   */
+  Position<2> position(Index i) const
+  {
+    return {i % m_shape[0], i / m_shape[0]};
+  }
+
+  /**
+   * @brief Get the positions of the flagged pixels, in memory order.
+   */
+  std::vector<Position<2>> positions() const
+  {
+    std::vector<Position<2>> out;
+    out.reserve(m_indices.size());
+    for (auto i : m_indices) {
+      out.push_back(position(i));
+    }
+    return out;
+  }
+
+  /**
+   * @brief Check whether a pixel is flagged.
+   */
+  bool contains(const Position<2>& p) const
+  {
+    return std::binary_search(m_indices.begin(), m_indices.end(), index(p));
+  }
+
+  /**
+   * @copybrief contains()
+   * 
+   * This makes the map usable where a dense mask is expected, e.g. in `min_contrast()`.
+   */
+  bool operator[](const Position<2>& p) const
+  {
+    return contains(p);
+  }
+
+  /**
+   * @brief Flag pixels given their sorted indices.
+   */
+  void insert(const std::vector<Index>& sorted)
+  {
+    const auto middle = m_indices.size();
+    m_indices.insert(m_indices.end(), sorted.begin(), sorted.end());
+    std::inplace_merge(m_indices.begin(), m_indices.begin() + middle, m_indices.end());
+    m_indices.erase(std::unique(m_indices.begin(), m_indices.end()), m_indices.end());
+  }
+
+  /**
+   * @brief Build the dense mask.
+   */
+  Raster<char> raster() const
+  {
+    Raster<char> out(m_shape);
+    for (auto i : m_indices) {
+      out[i] = true;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the 8-connected hits, with their bounding boxes and sizes, in order of appearance.
+   * 
+   * The cost is proportional to the number of flagged pixels, and not to the frame size.
+   */
+  std::vector<Component<2>> components() const
+  {
+    std::vector<Component<2>> out;
+    std::vector<bool> visited(m_indices.size(), false);
+    std::vector<Index> stack;
+    for (std::size_t seed = 0; seed < m_indices.size(); ++seed) {
+      if (visited[seed]) {
+        continue;
+      }
+      visited[seed] = true;
+      stack.push_back(seed);
+      const auto front = position(m_indices[seed]);
+      Component<2> component {Box<2>(front, front), 0};
+      while (not stack.empty()) {
+        const auto p = position(m_indices[stack.back()]);
+        stack.pop_back();
+        ++component.size;
+        component.box = Box<2>(
+            {std::min(component.box.front()[0], p[0]), std::min(component.box.front()[1], p[1])},
+            {std::max(component.box.back()[0], p[0]), std::max(component.box.back()[1], p[1])});
+        for (Index y = std::max<Index>(p[1] - 1, 0); y <= std::min(p[1] + 1, m_shape[1] - 1); ++y) {
+          for (Index x = std::max<Index>(p[0] - 1, 0); x <= std::min(p[0] + 1, m_shape[0] - 1); ++x) {
+            const auto it = std::lower_bound(m_indices.begin(), m_indices.end(), index({x, y}));
+            if (it != m_indices.end() && *it == index({x, y}) && not visited[it - m_indices.begin()]) {
+              visited[it - m_indices.begin()] = true;
+              stack.push_back(it - m_indices.begin());
+            }
+          }
+        }
+      }
+      out.push_back(LINX_MOVE(component));
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief The frame shape.
+   */
+  Position<2> m_shape;
+
+  /**
+   * @brief The sorted indices of the flagged pixels.
+   */
+  std::vector<Index> m_indices;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Detect cosmic rays and pass the intermediate maps to some function.
+ * @param dump The function called as `dump(laplacian_map, quotient_map)`
+ */
+template <typename TIn, typename TPsf, typename TFunc>
+Hits detect(const TIn& in, const TPsf& psf, float pfa, float tq, TFunc&& dump)
+{
+  using T = typename TPsf::Value;
+  const auto& shape = in.shape();
+
+  // Laplacian, robust noise estimation on a 1/16 subsample, then thresholding
+  const auto laplacian_map = Internal::fused_laplacian(in, [](auto) {});
+  const auto noise = robust_noise(laplacian_map, 4);
+  const auto scale = Internal::laplace_scale(laplacian_map, noise);
+  const auto tl = noise.median - scale * std::log(2.0 * pfa);
+  std::vector<Position<2>> candidates;
+  auto it = laplacian_map.begin();
+  for (const auto& p : laplacian_map.domain()) {
+    if (*it > tl) {
+      candidates.push_back(p);
+    }
+    ++it;
+  }
+
+  // Quotient at the candidates and their dilation neighborhoods only
+  const Index radius = std::sqrt(psf.size()) / 4;
+  const auto ball = Mask<2>::ball<2>(radius);
+  const std::vector<Position<2>> neighborhood(ball.begin(), ball.end());
+  Raster<char> selection(shape);
+  for (const auto& p : candidates) {
+    for (const auto& q : neighborhood) {
+      selection[clamp(p + q, shape)] = true;
+    }
+  }
+  const auto filter =
+      SimpleFilter<QuotientFilter<T, Box<2>>>(psf.domain() - (psf.shape() - 1) / 2, psf.begin(), psf.end());
+  Raster<T> quotient_map(shape);
+  quotient_map.fill(std::numeric_limits<T>::quiet_NaN());
+  filter.transform_at(extrapolation<Nearest>(in), selection, quotient_map);
+
+  // Dilated quotient at the candidates, which are in memory order
+  Hits out(shape);
+  std::vector<Index> flagged;
+  for (const auto& p : candidates) {
+    auto q_max = std::numeric_limits<T>::lowest();
+    for (const auto& q : neighborhood) {
+      q_max = std::max(q_max, quotient_map[clamp(p + q, shape)]);
+    }
+    if (q_max < tq) {
+      flagged.push_back(out.index(p));
+    }
+  }
+  out.insert(flagged);
+
+  dump(laplacian_map, quotient_map);
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief Detect cosmic rays as a sparse map.
+ * 
+ * This is equivalent to `detect()` without building the dense mask.
+ * 
+ * @see `detect()`
+ */
+template <typename TIn, typename TPsf>
+Hits detect_sparse(const TIn& in, const TPsf& psf, float pfa, float tq)
+{
+  return Internal::detect(in, psf, pfa, tq, [](const auto&, const auto&) {});
 }
 
 /**
  * @brief Detect cosmic rays.
  * @param in The input 2D raster
+ * @param psf The PSF
  * @param pfa The detection probability of false alarm
+ * @param tq The star rejection quotient threshold
  * 
  * This is a simple adaptive Laplacian thresholding.
  * The input raster is convolved with some Laplacian kernel.
  * The parameters of the background noise (empirically assumed Laplace-distributed)
- * of the filtered image are estimated to deduce the detection threshold from a PFA.
+ * of the filtered image are robustly estimated with `robust_noise()` on a 1/16 subsample,
+ * to deduce the detection threshold from a PFA.
+ * Detections which match the PSF, i.e. whose dilated quotient is above `tq`, are rejected as stars.
+ * 
+ * The quotient is only computed in the neighborhood of the Laplacian detections,
+ * such that the cost is dominated by a single pass over the input.
  */
 template <typename TIn, typename TPsf>
 Raster<char> detect(const TIn& in, const TPsf& psf, float pfa, float tq)
 {
-  auto laplacian_map = laplacian(in);
-  Fits("/tmp/cosmic.fits").write(laplacian_map, 'a');
-  float n = 0;
-  float s = 0;
-  for (auto e : laplacian_map) {
-    if (not std::isnan(e)) {
-      n += std::abs(e);
-      ++s;
-    }
-  }
-  printf("Norm: %f\n", n);
-
-  // Empirically assume Laplace distribution
-  // const auto tl = -norm<1>(laplacian_map) / laplacian_map.size() * std::log(2.0 * pfa);
-  const auto tl = -n / s * std::log(2.0 * pfa);
-  printf("Threshold: %f\n", tl);
+  return detect_sparse(in, psf, pfa, tq).raster();
+}
 
-  const Index radius = std::sqrt(psf.size()) / 4;
-  printf("Radius: %li\n", radius);
-  auto quotient_map = dilate(quotient(in, psf), radius);
-  Fits("/tmp/cosmic.fits").write(quotient_map, 'a');
-
-  Raster<char> out(in.shape());
-  out.generate(
-      [=](auto l, auto q) {
-        return l > tl && q < tq; // FIXME compute quotient only where l > tl
-      },
-      laplacian_map,
-      quotient_map);
-  return out;
+/**
+ * @brief Detect cosmic rays and write the intermediate maps for debugging.
+ * @param debug The output file, e.g. a `Fits`, in which the Laplacian and quotient maps are appended
+ * 
+ * The quotient map is NaN where it was not computed.
+ * 
+ * @see `detect()`
+ */
+template <typename TIn, typename TPsf, typename TFile>
+Raster<char> detect(const TIn& in, const TPsf& psf, float pfa, float tq, TFile& debug)
+{
+  const auto hits = Internal::detect(in, psf, pfa, tq, [&](const auto& laplacian_map, const auto& quotient_map) {
+    debug.write(laplacian_map, 'a');
+    debug.write(quotient_map, 'a');
+  });
+  return hits.raster();
 }
 
 /**
@@ -194,23 +620,85 @@ float min_contrast(const TIn& in, const TMask& mask, const Position<2>& p)
  * @brief Segment detected cosmic rays.
  * @param mask The detection map
  * @param threshold The similarity threshold
+ * @param iterations The maximum number of iterations, or -1 to segment until stability
+ * @return The number of added pixels
  * 
  * Given a detection map, neighbors of flagged pixels are considered as candidate cosmic rays.
  * Some similarity distance is computed in the neighborhood in order to decide
  * whether the cadidate belongs to the cosmic ray or to the background, by thresholding.
+ * Only the neighbors of the pixels flagged at the previous iteration are considered.
+ * 
+ * @see `grow()`
  */
 template <typename TIn, typename TMask>
-void segment(const TIn& in, TMask& mask, float threshold)
+Index segment(const TIn& in, TMask& mask, float threshold, Index iterations = 1)
 {
   // FIXME Mask<2>::ball<1>(1)
-  auto candidates = dilation<typename TMask::Value>(Box<2>::from_center(1)) * extrapolation(mask, '\0') - mask;
-  for (const auto& p : candidates.domain() - Box<2>::from_center(1)) {
-    if (candidates[p]) {
+  const auto inner = mask.domain() - Box<2>::from_center(1);
+  return grow(
+      mask,
+      [&](const auto& p) {
+        return inner.contains(p) && min_contrast(in, mask, p) < threshold;
+      },
+      Connectivity::Full,
+      iterations);
+}
+
+/**
+ * @brief Segment detected cosmic rays in a sparse map.
+ * @param hits The detection map, to which the segmented pixels are added
+ * 
+ * This is equivalent to segmenting the dense mask, with the same acceptance order,
+ * yet the cost of each iteration is proportional to the number of pixels added at the previous iteration,
+ * and not to the frame size.
+ * 
+ * @see `segment()`
+ */
+template <typename TIn>
+Index segment(const TIn& in, Hits& hits, float threshold, Index iterations = 1)
+{
+  const auto inner = Box<2>::from_shape(Position<2>::zero(), hits.shape()) - Box<2>::from_center(1);
+  const auto offsets = Linx::Internal::neighbor_offsets<2>(2, Connectivity::Full);
+  auto frontier = hits.positions();
+  std::vector<Index> candidates;
+  std::vector<Index> accepted;
+
+  // The map and the pixels accepted during the current iteration, which are in memory order
+  struct Lookup {
+    bool operator[](const Position<2>& p) const
+    {
+      return hits.contains(p) || std::binary_search(accepted.begin(), accepted.end(), hits.index(p));
+    }
+    const Hits& hits;
+    const std::vector<Index>& accepted;
+  } mask {hits, accepted};
+
+  Index count = 0;
+  for (Index i = 0; not frontier.empty() && i != iterations; ++i) {
+    candidates.clear();
+    for (const auto& p : frontier) {
+      for (const auto& d : offsets) {
+        const auto q = p + d;
+        if (inner.contains(q) && not hits.contains(q)) {
+          candidates.push_back(hits.index(q));
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    accepted.clear();
+    frontier.clear();
+    for (auto c : candidates) {
+      const auto p = hits.position(c);
       if (min_contrast(in, mask, p) < threshold) {
-        mask[p] = true;
+        accepted.push_back(c);
+        frontier.push_back(p);
       }
     }
+    hits.insert(accepted);
+    count += accepted.size();
   }
+  return count;
 }
 
 } // namespace Cosmics
@@ -5,6 +5,7 @@
 #ifndef _LINXRUN_ITERATIONBENCHMARK_H
 #define _LINXRUN_ITERATIONBENCHMARK_H
 
+#include "Linx/Base/Threads.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Run/Timer.h"
 
@@ -56,11 +57,26 @@ public:
    */
   Duration iterate_over_positions_optimized();
 
+  /**
+   * @brief Loop over the rows of the domain, and over indices inside each row.
+   */
+  Duration iterate_over_rows();
+
+  /**
+   * @brief Loop over the spans of a patch, i.e. over runs of pixels equally spaced in memory.
+   */
+  Duration iterate_over_spans();
+
   /**
    * @brief Loop over indices.
    */
   Duration loop_over_indices();
 
+  /**
+   * @brief Loop over indices with multi-threading.
+   */
+  Duration loop_over_indices(const Threads& threads);
+
   /**
    * @brief Loop over values via a pixel iterator.
    */
@@ -9,6 +9,8 @@ def defineSpecificProgramOptions():
     parser.add_argument('--image', type=int, default=2048)
     parser.add_argument('--kernel', type=int, default=5)
     parser.add_argument('--extrapolation', default='nearest')
+    parser.add_argument('--library', default='scipy', choices=['scipy', 'linx'])
+    parser.add_argument('--threads', type=int, default=1)
     return parser
 
 
@@ -26,9 +28,15 @@ def mainMethod(args):
     print(f'  input: {image}')
 
     print('Filtering...')
-    start = time.time()
-    ndimage.convolve(image, kernel, output=image, mode=extrapolation)
-    end = time.time()
+    if args.library == 'linx':
+        import PyLinx  # Optional bindings, built if pybind11 is found
+        start = time.time()
+        image = PyLinx.convolve(image, kernel, extrapolation, args.threads)
+        end = time.time()
+    else:
+        start = time.time()
+        ndimage.convolve(image, kernel, output=image, mode=extrapolation)
+        end = time.time()
     print(f'  output: {image}')
 
     print(f'  Done in: {(end - start) * 1000} ms')
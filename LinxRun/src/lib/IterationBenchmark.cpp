@@ -69,6 +69,40 @@ IterationBenchmark::Duration IterationBenchmark::iterate_over_positions_optimize
   return m_timer.stop();
 }
 
+IterationBenchmark::Duration IterationBenchmark::iterate_over_rows()
+{
+  m_timer.start();
+  //! [row]
+  m_c.domain().for_each_row([&](const auto& front, Index length) {
+    const auto i = m_c.index(front);
+    const auto* a = m_a.data() + i;
+    const auto* b = m_b.data() + i;
+    auto* c = m_c.data() + i;
+    for (Index x = 0; x < length; ++x) {
+      c[x] = a[x] + b[x];
+    }
+  });
+  //! [row]
+  return m_timer.stop();
+}
+
+IterationBenchmark::Duration IterationBenchmark::iterate_over_spans()
+{
+  m_timer.start();
+  //! [span]
+  const auto* a = m_a.data();
+  const auto* b = m_b.data();
+  auto* front = m_c.data();
+  m_c(m_c.domain()).for_each_span([&](auto* c, Index size, Index stride) {
+    const auto i = c - front;
+    for (Index x = 0; x < size; ++x) {
+      c[x * stride] = a[i + x * stride] + b[i + x * stride];
+    }
+  });
+  //! [span]
+  return m_timer.stop();
+}
+
 IterationBenchmark::Duration IterationBenchmark::loop_over_indices()
 {
   m_timer.start();
@@ -81,6 +115,19 @@ IterationBenchmark::Duration IterationBenchmark::loop_over_indices()
   return m_timer.stop();
 }
 
+IterationBenchmark::Duration IterationBenchmark::loop_over_indices(const Threads& threads)
+{
+  m_timer.start();
+  //! [index-parallel]
+  const Index size = m_c.size();
+#pragma omp parallel for num_threads(threads.count()) schedule(static)
+  for (Index i = 0; i < size; ++i) {
+    m_c[i] = m_a[i] + m_b[i];
+  }
+  //! [index-parallel]
+  return m_timer.stop();
+}
+
 IterationBenchmark::Duration IterationBenchmark::iterate_over_values()
 {
   m_timer.start();
@@ -0,0 +1,158 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+#include "Linx/Run/Benchmark.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Interpolation.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The parameters of a benchmark case.
+ */
+struct Case {
+  std::string operation;
+  std::string method;
+  Linx::Index side;
+  Linx::Index threads;
+};
+
+/**
+ * @brief Benchmark a case for some interpolation method.
+ * @return The number of output pixels or interpolated points per run
+ */
+template <typename TMethod>
+Linx::Index benchmark_case(const Case& c, Linx::Index point_count, Linx::Benchmark<>& benchmark)
+{
+  const Linx::Threads threads(c.threads);
+  auto input = Linx::Raster<float>({c.side, c.side}).range();
+  const auto extrapolated = Linx::extrapolation(input, 0.F);
+  Linx::Raster<float> output;
+
+  if (c.operation == "affine") {
+    Linx::Affinity<2> affinity(Linx::center(input));
+    affinity += {1.5, -.5};
+    affinity *= 1.1;
+    affinity.rotate_deg(20);
+    benchmark.run([&]() {
+      output = affinity.template warp<TMethod>(extrapolated, threads);
+    });
+  } else if (c.operation == "translate") {
+    benchmark.run([&]() {
+      output = Linx::translate<TMethod>(extrapolated, {1.5, -.5}, threads);
+    });
+  } else if (c.operation == "scale") {
+    benchmark.run([&]() {
+      output = Linx::scale<TMethod>(extrapolated, 1.1, threads);
+    });
+  } else if (c.operation == "rotate") {
+    benchmark.run([&]() {
+      output = Linx::rotate_deg<TMethod>(extrapolated, 20, 0, 1, threads);
+    });
+  } else if (c.operation == "shear-rotate") {
+    benchmark.run([&]() {
+      output = Linx::shear_rotate_deg<TMethod>(extrapolated, 20, 0, 1, threads);
+    });
+  } else if (c.operation == "upsample") {
+    benchmark.run([&]() {
+      output = Linx::upsample<TMethod>(extrapolated, 2, threads);
+    });
+  } else if (c.operation == "downsample") {
+    benchmark.run([&]() {
+      output = Linx::downsample<TMethod>(extrapolated, 2, threads);
+    });
+  } else if (c.operation == "points") {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<double> coordinate(-.5, c.side - .5);
+    Linx::Sequence<Linx::Vector<double, 2>> positions(point_count);
+    for (auto& p : positions) {
+      p = {coordinate(engine), coordinate(engine)};
+    }
+    const auto interpolator = Linx::interpolation<TMethod>(extrapolated);
+    benchmark.run([&]() {
+      const auto values = interpolator(positions, threads);
+    });
+    return point_count;
+  } else {
+    throw std::runtime_error("Unknown operation: " + c.operation);
+  }
+  return output.size();
+}
+
+/**
+ * @brief Dispatch a case on the interpolation method.
+ */
+Linx::Index benchmark_method(const Case& c, Linx::Index point_count, Linx::Benchmark<>& benchmark)
+{
+  if (c.method == "nearest") {
+    return benchmark_case<Linx::Nearest>(c, point_count, benchmark);
+  }
+  if (c.method == "linear") {
+    return benchmark_case<Linx::Linear>(c, point_count, benchmark);
+  }
+  if (c.method == "cubic") {
+    return benchmark_case<Linx::Cubic>(c, point_count, benchmark);
+  }
+  if (c.method == "lanczos") {
+    return benchmark_case<Linx::Lanczos<3>>(c, point_count, benchmark);
+  }
+  throw std::runtime_error("Unknown interpolation method: " + c.method);
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options(
+      "Benchmark the geometric transforms and point interpolation, and write the results as CSV, "
+      "including the throughput in Mpix/s.");
+  options.named(
+      "operations",
+      "Comma-separated operations among: affine, translate, scale, rotate, shear-rotate, upsample, downsample, points",
+      std::string("affine,translate,scale,rotate,shear-rotate,upsample,downsample,points"));
+  options.named(
+      "methods",
+      "Comma-separated interpolation methods among: nearest, linear, cubic, lanczos (3 lobes)",
+      std::string("nearest,linear,cubic,lanczos"));
+  options.named("sides", "Comma-separated image widths and heights (same value)", std::string("512,2048"));
+  options.named("thread-counts", "Comma-separated numbers of threads", std::string("1"));
+  options.named("points", "Number of interpolated points (or 0 for one per pixel)", 0L);
+  Linx::BenchmarkCsv<>::declare(options);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
+  options.parse(argc, argv);
+
+  std::vector<Case> cases;
+  for (const auto& threads : options.as_list<Linx::Index>("thread-counts")) {
+    for (const auto& side : options.as_list<Linx::Index>("sides")) {
+      for (const auto& method : options.as_list("methods")) {
+        for (const auto& operation : options.as_list("operations")) {
+          cases.push_back({operation, method, side, threads});
+        }
+      }
+    }
+  }
+
+  Linx::BenchmarkCsv<> csv(options, "operation,method,side,threads,mpix_s");
+
+  const auto parameters = Linx::BenchmarkOptions::parse(options);
+  const auto points = options.as<Linx::Index>("points");
+  for (const auto& c : cases) {
+    Linx::Benchmark<> benchmark(parameters);
+    const auto size = benchmark_method(c, points > 0 ? points : c.side * c.side, benchmark);
+    const auto median = benchmark.distribution().median(); // ms
+    const auto throughput = median > 0 ? size / median * 1e-3 : 0;
+    csv.write(benchmark, c.operation, c.method, c.side, c.threads, throughput);
+    if (csv.is_file()) {
+      std::cout << c.operation << " (" << c.method << ", side " << c.side << ", " << c.threads
+                << " threads): " << throughput << " Mpix/s, " << benchmark << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -3,53 +3,33 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Run/Benchmark.h"
 #include "Linx/Run/ProgramOptions.h"
-#include "Linx/Run/Timer.h"
 
 #include <map>
 #include <string>
 #include <vector>
 
-using Timer = Linx::Timer<std::chrono::milliseconds>;
-
-Timer::Unit benchmark_buffer(Linx::Index size, Linx::Index alignment)
+template <typename TBuffer, typename TMake>
+void benchmark_buffer(const Linx::BenchmarkOptions& parameters, TMake make)
 {
-  Timer timer;
+  Linx::Benchmark<> benchmark(parameters);
   std::cout << "Assignment..." << std::endl;
-  timer.start();
-  Linx::AlignedBuffer<long> buffer(size, nullptr, alignment);
-  auto duration = timer.stop();
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl; // FIXME cout << duration << endl?
+  benchmark.run([&]() {
+    TBuffer buffer = make();
+  });
+  std::cout << "  Done in " << benchmark << std::endl;
+  TBuffer buffer = make();
   long sum = 0;
   std::cout << "Iteration..." << std::endl;
-  timer.start();
-  for (const auto& v : buffer) {
-    sum += v + 1;
-  }
-  duration = timer.stop();
-  std::cout << "  Sum:" << sum << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
-  return timer.total();
-}
-
-Timer::Unit benchmark_vector(Linx::Index size)
-{
-  Timer timer;
-  std::cout << "Initialization..." << std::endl;
-  timer.start();
-  std::vector<long> buffer(size);
-  auto duration = timer.stop();
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
-  long sum = 0;
-  std::cout << "Iteration..." << std::endl;
-  timer.start();
-  for (const auto& v : buffer) {
-    sum += v + 1;
-  }
-  duration = timer.stop();
+  benchmark.run([&]() {
+    sum = 0;
+    for (const auto& v : buffer) {
+      sum += v + 1;
+    }
+  });
   std::cout << "  Sum:" << sum << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
-  return timer.total();
+  std::cout << "  Done in " << benchmark << std::endl;
 }
 
 int main(int argc, char const* argv[])
@@ -57,16 +37,22 @@ int main(int argc, char const* argv[])
   Linx::ProgramOptions options;
   options.named<long>("align", "Alignment for an AlignedBuffer or 0 for a std::vector");
   options.named<long>("size", "Number of elements", 1000000);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
   options.parse(argc, argv);
   const auto alignment = options.as<long>("align");
   const auto size = options.as<long>("size");
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  parameters.bytes = size * sizeof(long);
 
   if (alignment > 0) {
-    const auto duration = benchmark_buffer(size, alignment);
-    std::cout << "Done in " << duration.count() << "ms" << std::endl;
+    benchmark_buffer<Linx::AlignedBuffer<long>>(parameters, [&]() {
+      return Linx::AlignedBuffer<long>(size, nullptr, alignment);
+    });
   } else {
-    const auto duration = benchmark_vector(size);
-    std::cout << "Done in " << duration.count() << "ms" << std::endl;
+    benchmark_buffer<std::vector<long>>(parameters, [&]() {
+      return std::vector<long>(size);
+    });
   }
 
   return 0;
@@ -2,15 +2,14 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Run/Benchmark.h"
 #include "Linx/Run/ProgramOptions.h"
-#include "Linx/Run/Timer.h"
 #include "Linx/Transforms/Filters.h"
 
 #include <map>
 #include <string>
 
 using Image = Linx::Raster<float>;
-using Duration = std::chrono::milliseconds;
 
 void filter_monolith(Image& image, const Image& values)
 {
@@ -53,11 +52,8 @@ void filter_hardcoded(Image& image, const Image& values)
   image = out;
 }
 
-template <typename TDuration>
-TDuration filter(Image& image, const Image& kernel, char setup)
+void filter(Image& image, const Image& kernel, char setup)
 {
-  Linx::Timer<TDuration> timer;
-  timer.start();
   switch (setup) {
     case '0':
       image = Linx::convolution(kernel) * Linx::extrapolation(image, 0.0F);
@@ -74,7 +70,6 @@ TDuration filter(Image& image, const Image& kernel, char setup)
     default:
       throw std::runtime_error("Case not implemented"); // FIXME CaseNotImplemented
   }
-  return timer.stop();
 }
 
 int main(int argc, char const* argv[])
@@ -83,6 +78,8 @@ int main(int argc, char const* argv[])
   options.named("case", "Test case: d (default), m (monolith), h (hardcoded)", 'd');
   options.named("image", "Raster length along each axis", 2048L);
   options.named("kernel", "Kernel length along each axis", 5L);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
   options.parse(argc, argv);
   const auto setup = options.as<char>("case");
   const auto image_diameter = options.as<Linx::Index>("image");
@@ -92,15 +89,25 @@ int main(int argc, char const* argv[])
   Linx::Position<2> kernel_shape {kernel_diameter, kernel_diameter};
 
   std::cout << "Generating raster and kernel..." << std::endl;
-  auto image = Image(image_shape).range();
+  const auto input = Image(image_shape).range();
   const auto kernel = Image(kernel_shape).range();
+  auto image = input;
   std::cout << "  input: " << image << std::endl;
 
   std::cout << "Filtering..." << std::endl;
-  const auto duration = filter<Duration>(image, kernel, setup);
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  parameters.bytes = 2 * image.size() * sizeof(float);
+  Linx::Benchmark<> benchmark(parameters);
+  benchmark.run(
+      [&]() {
+        filter(image, kernel, setup);
+      },
+      [&]() {
+        image = input;
+      });
   std::cout << "  output: " << image << std::endl;
 
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "  Done in " << benchmark << std::endl;
 
   return 0;
 }
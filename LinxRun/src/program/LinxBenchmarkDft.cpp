@@ -0,0 +1,235 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Linx/Run/Benchmark.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxTransforms/DftConvolution.h"
+#include "LinxTransforms/DftOptions.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief The parameters of a benchmark case.
+ */
+struct Case {
+  std::string operation;
+  Linx::Index side;
+  Linx::Index kernel;
+  Linx::Index threads;
+  std::string precision;
+};
+
+/**
+ * @brief Classify a length as a power of two, a 7-smooth number, a prime number, or other.
+ *
+ * FFTW is fastest for powers of two, fast for 7-smooth numbers, and slowest for large primes.
+ */
+std::string length_kind(Linx::Index length)
+{
+  if (length > 0 && (length & (length - 1)) == 0) {
+    return "pow2";
+  }
+  auto remainder = length;
+  for (Linx::Index factor : {2, 3, 5, 7}) {
+    while (remainder % factor == 0) {
+      remainder /= factor;
+    }
+  }
+  if (remainder == 1) {
+    return "smooth";
+  }
+  for (Linx::Index d = 2; d * d <= length; ++d) {
+    if (length % d == 0) {
+      return "other";
+    }
+  }
+  return "prime";
+}
+
+/**
+ * @brief Check whether an operation is a convolution, i.e. whether the kernel option applies.
+ */
+bool is_convolution(const std::string& operation)
+{
+  return operation == "dft-convolution" || operation == "direct-convolution";
+}
+
+/**
+ * @brief Benchmark a convolution, either in Fourier domain or in direct space.
+ */
+template <typename T>
+void benchmark_convolution(const Case& c, Linx::Index block, Linx::Benchmark<>& benchmark)
+{
+  const auto input = Linx::Raster<T>({c.side, c.side}).range();
+  const auto values = Linx::Raster<T>({c.kernel, c.kernel}).range();
+  const auto extrapolated = Linx::extrapolation<Linx::Nearest>(input);
+  Linx::Raster<T> output(input.shape());
+  if (c.operation == "dft-convolution") {
+    const auto filter = Linx::dft_convolution(values, (values.shape() - 1) / 2, block, 0); // Always in Fourier domain
+    benchmark.run([&]() {
+      filter.transform(extrapolated, output, Linx::Threads(c.threads));
+    });
+  } else {
+    const auto filter = Linx::convolution(values);
+    benchmark.run([&]() {
+      filter.transform(extrapolated, output, Linx::Threads(c.threads));
+    });
+  }
+}
+
+/**
+ * @brief Benchmark a case for some precision.
+ */
+template <typename T>
+void benchmark_case(const Case& c, Linx::Index block, Linx::Benchmark<>& benchmark)
+{
+  const Linx::Position<2> shape {c.side, c.side};
+  Linx::FftwAllocator::set_threads(Linx::Threads(c.threads));
+
+  if (c.operation == "plan") {
+    benchmark.run(
+        [&]() {
+          Linx::RealDft<2, T> dft(shape);
+        },
+        [&]() {
+          Linx::FftwAllocator::forget_wisdom<T>();
+        });
+    return;
+  }
+  if (c.operation == "plan-wisdom") {
+    Linx::RealDft<2, T> seed(shape); // Accumulate the wisdom
+    benchmark.run([&]() {
+      Linx::RealDft<2, T> dft(shape);
+    });
+    return;
+  }
+  if (is_convolution(c.operation)) {
+    benchmark_convolution<T>(c, block, benchmark);
+    return;
+  }
+
+  Linx::RealDft<2, T> dft(shape);
+  auto idft = dft.inverse();
+  if (c.operation == "forward") {
+    benchmark.run(
+        [&]() {
+          dft.transform();
+        },
+        [&]() {
+          dft.in().range();
+        });
+  } else if (c.operation == "inverse") {
+    benchmark.run(
+        [&]() {
+          idft.transform();
+        },
+        [&]() {
+          dft.in().range();
+          dft.transform();
+        });
+  } else if (c.operation == "normalize") {
+    benchmark.run(
+        [&]() {
+          idft.normalize();
+        },
+        [&]() {
+          idft.out().fill(1); // Prevent denormals
+        });
+  } else {
+    throw std::runtime_error("Unknown operation: " + c.operation);
+  }
+}
+
+/**
+ * @brief Dispatch a case on the precision.
+ */
+void benchmark_typed(const Case& c, Linx::Index block, Linx::Benchmark<>& benchmark)
+{
+  if (c.precision == "double") {
+    benchmark_case<double>(c, block, benchmark);
+  } else if (c.precision == "float") {
+    benchmark_case<float>(c, block, benchmark);
+  } else {
+    throw std::runtime_error("Unknown precision: " + c.precision);
+  }
+}
+
+/**
+ * @brief Get the number of bytes read and written by an operation.
+ */
+Linx::Index operation_bytes(const Case& c)
+{
+  const Linx::Index size = c.side * c.side * (c.precision == "float" ? sizeof(float) : sizeof(double));
+  if (c.operation == "plan" || c.operation == "plan-wisdom") {
+    return 0;
+  }
+  if (c.operation == "normalize") {
+    return 2 * size;
+  }
+  return 3 * size; // Real input and complex half-spectrum, or real input and output with the kernel
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options(
+      "Benchmark the DFTs and the DFT convolution against the direct convolution, and write the results as CSV.");
+  options.named(
+      "operations",
+      "Comma-separated operations among: plan (without wisdom), plan-wisdom, forward, inverse, normalize, "
+      "dft-convolution, direct-convolution",
+      std::string("plan,plan-wisdom,forward,inverse,normalize,dft-convolution,direct-convolution"));
+  options.named(
+      "sides",
+      "Comma-separated image widths and heights (same value), e.g. powers of two, 7-smooth numbers and primes",
+      std::string("256,250,251,1024,1000,1021"));
+  options.named("kernels", "Comma-separated kernel widths and heights for the convolutions", std::string("5,15,31"));
+  options.named("thread-counts", "Comma-separated numbers of threads", std::string("1"));
+  options.named("precisions", "Comma-separated precisions among: double, float", std::string("double,float"));
+  options.named("block", "Minimum block length of the DFT convolution", 256L);
+  Linx::BenchmarkCsv<>::declare(options);
+  Linx::BenchmarkOptions().declare(options);
+  Linx::DftOptions().declare(options);
+  options.performance();
+  options.parse(argc, argv);
+
+  const auto dft_options = Linx::DftOptions::parse(options);
+  dft_options.apply();
+  const auto& planner = dft_options.planner;
+  const auto block = options.as<Linx::Index>("block");
+
+  std::vector<Case> cases;
+  for (const auto& precision : options.as_list("precisions")) {
+    for (const auto& threads : options.as_list<Linx::Index>("thread-counts")) {
+      for (const auto& side : options.as_list<Linx::Index>("sides")) {
+        for (const auto& operation : options.as_list("operations")) {
+          if (not is_convolution(operation)) {
+            cases.push_back({operation, side, 0, threads, precision});
+            continue;
+          }
+          for (const auto& kernel : options.as_list<Linx::Index>("kernels")) {
+            cases.push_back({operation, side, kernel, threads, precision});
+          }
+        }
+      }
+    }
+  }
+
+  Linx::BenchmarkCsv<> csv(options, "operation,side,kind,kernel,threads,precision,planner");
+
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  for (const auto& c : cases) {
+    parameters.bytes = operation_bytes(c);
+    Linx::Benchmark<> benchmark(parameters);
+    benchmark_typed(c, block, benchmark);
+    csv.write(benchmark, c.operation, c.side, length_kind(c.side), c.kernel, c.threads, c.precision, planner);
+    if (csv.is_file()) {
+      std::cout << c.operation << " (side " << c.side << ", kernel " << c.kernel << ", " << c.threads << " threads, "
+                << c.precision << "): " << benchmark << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -3,8 +3,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Run/Benchmark.h"
 #include "Linx/Run/ProgramOptions.h"
-#include "Linx/Run/Timer.h"
 
 #include <map>
 #include <string>
@@ -31,37 +31,47 @@ void taylor_exp(Linx::Raster<double>& inout, Linx::Index order)
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options;
-  options.named<long>("order", "Taylor series order (or -1 for std::exp)", -1);
+  options.named<long>("order", "Taylor series order (or -1 for std::exp, -2 for Linx::fast_exp)", -1);
   options.named<long>("side", "Image width and height (same value)", 4096);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
   options.parse(argc, argv);
   const auto order = options.as<long>("order");
   const auto side = options.as<long>("side");
 
-  using Duration = std::chrono::milliseconds;
-  Linx::Timer<Duration> timer;
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  parameters.bytes = 2 * side * side * sizeof(double);
+  Linx::Benchmark<> benchmark(parameters);
 
   std::cout << "Generating random raster..." << std::endl;
-  auto raster = Linx::Raster<double>({side, side}).generate(Linx::GaussianNoise<double>(0, 1, 0));
+  const auto input = Linx::Raster<double>({side, side}).generate(Linx::GaussianNoise<double>(0, 1, 0));
+  auto raster = input;
 
   std::cout << "Computing exponential..." << std::endl;
-  timer.start();
-  switch (order) {
-    case -1:
-      raster.exp();
-      break;
-    case 0:
-      raster.fill(1);
-      break;
-    case 1:
-      raster += 1;
-      break;
-    default:
-      taylor_exp(raster, order);
-  }
-  const auto duration = timer.stop();
+  const auto compute = [&]() {
+    switch (order) {
+      case -2:
+        raster.fast_exp();
+        break;
+      case -1:
+        raster.exp();
+        break;
+      case 0:
+        raster.fill(1);
+        break;
+      case 1:
+        raster += 1;
+        break;
+      default:
+        taylor_exp(raster, order);
+    }
+  };
+  benchmark.run(compute, [&]() {
+    raster = input;
+  });
 
   std::cout << "  found: " << raster << std::endl;
-  std::cout << "  in " << duration.count() << "ms" << std::endl;
+  std::cout << "  in " << benchmark << std::endl;
 
   return 0;
 }
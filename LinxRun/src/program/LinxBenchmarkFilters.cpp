@@ -0,0 +1,233 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Mask.h"
+#include "Linx/Run/Benchmark.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <string>
+#include <type_traits> // is_floating_point_v
+#include <vector>
+
+/**
+ * @brief The parameters of a benchmark case.
+ */
+struct Case {
+  std::string filter;
+  std::string window;
+  Linx::Index radius;
+  std::string type;
+  std::string extrapolation;
+  Linx::Index side;
+};
+
+/**
+ * @brief Check whether a filter has a parametric window, i.e. whether the window and radius options apply.
+ */
+bool is_windowed(const std::string& filter)
+{
+  return filter == "convolution" || filter == "correlation" || filter == "mean" || filter == "median" ||
+      filter == "erosion" || filter == "dilation" || filter == "gaussian";
+}
+
+/**
+ * @brief Benchmark a filter on an extrapolated raster.
+ */
+template <typename TFilter, typename TMethod, typename T>
+void benchmark_filter(const TFilter& filter, const Linx::Raster<T>& input, Linx::Benchmark<>& benchmark)
+{
+  Linx::Raster<T> output;
+  const auto extrapolated = Linx::extrapolation<TMethod>(input);
+  benchmark.run([&]() {
+    output = filter * extrapolated;
+  });
+}
+
+/**
+ * @brief Benchmark a filter with a window which is either a box or a ball.
+ * @return false if the case is not applicable
+ */
+template <typename TMethod, typename T, typename TWindow>
+bool benchmark_windowed(const Case& c, TWindow window, const Linx::Raster<T>& input, Linx::Benchmark<>& benchmark)
+{
+  if (c.filter == "mean") {
+    benchmark_filter<decltype(Linx::mean_filter<T>(window)), TMethod>(Linx::mean_filter<T>(window), input, benchmark);
+  } else if (c.filter == "median") {
+    benchmark_filter<decltype(Linx::median_filter<T>(window)), TMethod>(
+        Linx::median_filter<T>(window),
+        input,
+        benchmark);
+  } else if (c.filter == "erosion") {
+    benchmark_filter<decltype(Linx::erosion<T>(window)), TMethod>(Linx::erosion<T>(window), input, benchmark);
+  } else if (c.filter == "dilation") {
+    benchmark_filter<decltype(Linx::dilation<T>(window)), TMethod>(Linx::dilation<T>(window), input, benchmark);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Benchmark a case for some value type and extrapolation method.
+ * @return false if the case is not applicable
+ */
+template <typename TMethod, typename T>
+bool benchmark_case(const Case& c, Linx::Benchmark<>& benchmark)
+{
+  const Linx::Position<2> shape {c.side, c.side};
+  const auto input = Linx::Raster<T>(shape).range();
+  const auto diameter = 2 * c.radius + 1;
+  const auto values = Linx::Raster<T>({diameter, diameter}).range();
+
+  if (c.window == "ball") {
+    if (c.filter == "convolution" || c.filter == "correlation" || c.filter == "gaussian") {
+      return false;
+    }
+    return benchmark_windowed<TMethod>(c, Linx::Mask<2>::ball<2>(c.radius), input, benchmark);
+  }
+  if (c.filter == "convolution") {
+    benchmark_filter<decltype(Linx::convolution(values)), TMethod>(Linx::convolution(values), input, benchmark);
+  } else if (c.filter == "correlation") {
+    benchmark_filter<decltype(Linx::correlation(values)), TMethod>(Linx::correlation(values), input, benchmark);
+  } else if (c.filter == "gaussian") {
+    if constexpr (std::is_floating_point_v<T>) {
+      const auto filter = Linx::gaussian_filter<T, 0, 1>(c.radius);
+      benchmark_filter<decltype(filter), TMethod>(filter, input, benchmark);
+    } else {
+      return false;
+    }
+  } else if (c.filter == "prewitt") {
+    benchmark_filter<decltype(Linx::prewitt_gradient<T, 0, 1>()), TMethod>(
+        Linx::prewitt_gradient<T, 0, 1>(),
+        input,
+        benchmark);
+  } else if (c.filter == "sobel") {
+    benchmark_filter<decltype(Linx::sobel_gradient<T, 0, 1>()), TMethod>(
+        Linx::sobel_gradient<T, 0, 1>(),
+        input,
+        benchmark);
+  } else if (c.filter == "scharr") {
+    benchmark_filter<decltype(Linx::scharr_gradient<T, 0, 1>()), TMethod>(
+        Linx::scharr_gradient<T, 0, 1>(),
+        input,
+        benchmark);
+  } else if (c.filter == "laplace") {
+    benchmark_filter<decltype(Linx::laplace_operator<T, 0, 1>()), TMethod>(
+        Linx::laplace_operator<T, 0, 1>(),
+        input,
+        benchmark);
+  } else {
+    return benchmark_windowed<TMethod>(c, Linx::Box<2>::from_center(c.radius), input, benchmark);
+  }
+  return true;
+}
+
+/**
+ * @brief Dispatch a case on the extrapolation method.
+ */
+template <typename T>
+bool benchmark_extrapolated(const Case& c, Linx::Benchmark<>& benchmark)
+{
+  if (c.extrapolation == "constant") {
+    return benchmark_case<Linx::Constant<T>, T>(c, benchmark);
+  }
+  if (c.extrapolation == "nearest") {
+    return benchmark_case<Linx::Nearest, T>(c, benchmark);
+  }
+  if (c.extrapolation == "periodic") {
+    return benchmark_case<Linx::Periodic, T>(c, benchmark);
+  }
+  if (c.extrapolation == "reflect") {
+    return benchmark_case<Linx::Reflect, T>(c, benchmark);
+  }
+  throw std::runtime_error("Unknown extrapolation method: " + c.extrapolation);
+}
+
+/**
+ * @brief Dispatch a case on the value type.
+ */
+bool benchmark_typed(const Case& c, Linx::Benchmark<>& benchmark)
+{
+  if (c.type == "float") {
+    return benchmark_extrapolated<float>(c, benchmark);
+  }
+  if (c.type == "double") {
+    return benchmark_extrapolated<double>(c, benchmark);
+  }
+  if (c.type == "int") {
+    return benchmark_extrapolated<int>(c, benchmark);
+  }
+  throw std::runtime_error("Unknown value type: " + c.type);
+}
+
+/**
+ * @brief Get the size of a value type.
+ */
+Linx::Index type_size(const std::string& type)
+{
+  return type == "double" ? sizeof(double) : sizeof(float);
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options("Benchmark the filters over a grid of parameters, and write the results as CSV.");
+  options.named(
+      "filters",
+      "Comma-separated filters among: convolution, correlation, mean, median, erosion, dilation, gaussian, "
+      "prewitt, sobel, scharr, laplace",
+      std::string("convolution,correlation,mean,median,erosion,dilation,gaussian,prewitt,sobel,scharr,laplace"));
+  options.named(
+      "windows",
+      "Comma-separated window shapes among: box, ball (ignored by gradients and Laplace)",
+      std::string("box,ball"));
+  options.named("radii", "Comma-separated window radii (or Gaussian sigmas)", std::string("1,2"));
+  options.named("types", "Comma-separated value types among: float, double, int", std::string("float"));
+  options.named(
+      "extrapolations",
+      "Comma-separated extrapolation methods among: constant, nearest, periodic, reflect",
+      std::string("constant,nearest"));
+  options.named("sides", "Comma-separated image widths and heights (same value)", std::string("512,2048"));
+  Linx::BenchmarkCsv<>::declare(options);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
+  options.parse(argc, argv);
+
+  std::vector<Case> cases;
+  for (const auto& side : options.as_list<Linx::Index>("sides")) {
+    for (const auto& type : options.as_list("types")) {
+      for (const auto& extrapolation : options.as_list("extrapolations")) {
+        for (const auto& filter : options.as_list("filters")) {
+          if (not is_windowed(filter)) {
+            cases.push_back({filter, "fixed", 1, type, extrapolation, side});
+            continue;
+          }
+          for (const auto& window : options.as_list("windows")) {
+            for (const auto& radius : options.as_list<Linx::Index>("radii")) {
+              cases.push_back({filter, window, radius, type, extrapolation, side});
+            }
+          }
+        }
+      }
+    }
+  }
+
+  Linx::BenchmarkCsv<> csv(options, "filter,window,radius,type,extrapolation,side");
+
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  for (const auto& c : cases) {
+    parameters.bytes = 2 * c.side * c.side * type_size(c.type);
+    Linx::Benchmark<> benchmark(parameters);
+    if (not benchmark_typed(c, benchmark)) {
+      continue;
+    }
+    csv.write(benchmark, c.filter, c.window, c.radius, c.type, c.extrapolation, c.side);
+    if (csv.is_file()) {
+      std::cout << c.filter << " (" << c.window << ", radius " << c.radius << ", " << c.type << ", " << c.extrapolation
+                << ", side " << c.side << "): " << benchmark << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Fits.h"
+#include "Linx/Io/Temporary.h"
+#include "Linx/Run/Benchmark.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Run/StepRecord.h" // peak_rss
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The parameters of a benchmark case.
+ */
+struct Case {
+  std::string mode;
+  std::string type;
+  Linx::Index side;
+  Linx::Index hdus;
+  Linx::Index region;
+  Linx::Index thickness;
+};
+
+/**
+ * @brief Reset the peak resident set size to the current one, if supported (Linux), such that each case has its peak.
+ */
+void reset_peak_rss()
+{
+  std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+/**
+ * @brief Benchmark a case for some value type.
+ * @return The number of bytes read or written per run
+ */
+template <typename T>
+Linx::Index benchmark_case(const Case& c, Linx::Benchmark<>& benchmark)
+{
+  const Linx::TemporaryPath path("LinxBenchmarkFits_" + c.mode + "_" + c.type + ".fits");
+  const Linx::Position<2> shape {c.side, c.side};
+  const auto raster = Linx::Raster<T>(shape).range();
+  const auto region = Linx::Box<2>::from_center(c.region / 2, shape / 2);
+  const Linx::Index full_bytes = c.hdus * raster.size() * sizeof(T);
+  const Linx::Index region_bytes = c.hdus * region.size() * sizeof(T);
+  Linx::Fits fits(path);
+  T sink = 0;
+
+  const auto write_all = [&]() {
+    for (Linx::Index h = 0; h < c.hdus; ++h) {
+      fits.write(raster, h == 0 ? 'w' : 'a');
+    }
+  };
+  const auto write_all_compressed = [&]() {
+    for (Linx::Index h = 0; h < c.hdus; ++h) {
+      fits.write(raster, Linx::Fits::Compression(), h == 0 ? 'w' : 'a');
+    }
+  };
+  const auto write_all_shapes = [&]() {
+    for (Linx::Index h = 0; h < c.hdus; ++h) {
+      fits.write_shape<T>(shape, h == 0 ? 'w' : 'a');
+    }
+  };
+
+  if (c.mode == "write") {
+    benchmark.run(write_all);
+    return full_bytes;
+  }
+  if (c.mode == "write-compressed") {
+    benchmark.run(write_all_compressed);
+    return full_bytes;
+  }
+  if (c.mode == "write-region") {
+    const auto patch = Linx::Raster<T>(region.shape()).range();
+    write_all_shapes();
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        fits.write_region(patch, region, h);
+      }
+    });
+    return region_bytes;
+  }
+  if (c.mode == "write-chunks") {
+    const auto chunk = Linx::Raster<T>({c.side, c.thickness}).range();
+    write_all_shapes();
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        for (Linx::Index front = 0; front + c.thickness <= c.side; front += c.thickness) {
+          fits.write_chunk(chunk, front, h);
+        }
+      }
+    });
+    return c.hdus * (c.side / c.thickness) * chunk.size() * sizeof(T);
+  }
+
+  if (c.mode == "read-compressed") {
+    write_all_compressed();
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        sink += fits.read<Linx::Raster<T>>(h + 1)[0]; // After the empty Primary
+      }
+    });
+    return full_bytes;
+  }
+  write_all();
+  if (c.mode == "read") {
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        sink += fits.read<Linx::Raster<T>>(h)[0];
+      }
+    });
+    return full_bytes;
+  }
+  if (c.mode == "read-region") {
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        sink += fits.read<Linx::Raster<T>>(region, h)[0];
+      }
+    });
+    return region_bytes;
+  }
+  if (c.mode == "read-chunks" || c.mode == "read-chunks-prefetch") {
+    const bool prefetch = c.mode == "read-chunks-prefetch";
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        for (const auto& chunk : fits.chunks<Linx::Raster<T>>(c.thickness, h, prefetch)) {
+          sink += chunk[0];
+        }
+      }
+    });
+    return full_bytes;
+  }
+  if (c.mode == "map") {
+    benchmark.run([&]() {
+      for (Linx::Index h = 0; h < c.hdus; ++h) {
+        const auto mapped = fits.map<T>(h);
+        for (const auto& v : mapped) { // Load the pages
+          sink += v;
+        }
+      }
+    });
+    return full_bytes;
+  }
+  throw std::runtime_error("Unknown mode: " + c.mode);
+}
+
+/**
+ * @brief Dispatch a case on the value type.
+ */
+Linx::Index benchmark_typed(const Case& c, Linx::Benchmark<>& benchmark)
+{
+  if (c.type == "float") {
+    return benchmark_case<float>(c, benchmark);
+  }
+  if (c.type == "double") {
+    return benchmark_case<double>(c, benchmark);
+  }
+  if (c.type == "int") {
+    return benchmark_case<std::int32_t>(c, benchmark);
+  }
+  if (c.type == "short") {
+    return benchmark_case<std::int16_t>(c, benchmark);
+  }
+  throw std::runtime_error("Unknown value type: " + c.type);
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options(
+      "Benchmark the FITS reads and writes in temporary files, and write the throughput and peak memory as CSV.");
+  options.named(
+      "modes",
+      "Comma-separated modes among: write, read, write-region, read-region, write-chunks, read-chunks, "
+      "read-chunks-prefetch, write-compressed, read-compressed, map",
+      std::string("write,read,write-region,read-region,write-chunks,read-chunks,read-chunks-prefetch,"
+                  "write-compressed,read-compressed,map"));
+  options.named("types", "Comma-separated value types among: float, double, int, short", std::string("float"));
+  options.named("sides", "Comma-separated image widths and heights (same value)", std::string("4096"));
+  options.named("hdus", "Number of image HDUs per file", 1L);
+  options.named("region", "Region width and height for the region modes", 512L);
+  options.named("thickness", "Chunk thickness (rows) for the chunk modes", 64L);
+  Linx::BenchmarkCsv<>::declare(options);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
+  options.parse(argc, argv);
+
+  const auto hdus = options.as<Linx::Index>("hdus");
+  const auto region = options.as<Linx::Index>("region");
+  const auto thickness = options.as<Linx::Index>("thickness");
+  std::vector<Case> cases;
+  for (const auto& side : options.as_list<Linx::Index>("sides")) {
+    for (const auto& type : options.as_list("types")) {
+      for (const auto& mode : options.as_list("modes")) {
+        cases.push_back({mode, type, side, hdus, region, thickness});
+      }
+    }
+  }
+
+  Linx::BenchmarkCsv<> csv(options, "mode,type,side,hdus,mb_s,peak_rss_delta");
+
+  const auto parameters = Linx::BenchmarkOptions::parse(options);
+  for (const auto& c : cases) {
+    Linx::Benchmark<> benchmark(parameters);
+    reset_peak_rss();
+    const auto rss = Linx::Internal::peak_rss();
+    const auto bytes = benchmark_typed(c, benchmark);
+    const auto peak = Linx::Internal::peak_rss() - rss;
+    const auto median = benchmark.distribution().median(); // ms
+    const auto throughput = median > 0 ? bytes / median * 1e-3 : 0;
+    csv.write(benchmark, c.mode, c.type, c.side, c.hdus, throughput, peak);
+    if (csv.is_file()) {
+      std::cout << c.mode << " (" << c.type << ", side " << c.side << ", " << c.hdus << " HDUs): " << throughput
+                << " MB/s, peak RSS +" << peak / 1000000 << " MB, " << benchmark << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -2,13 +2,15 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Run/Benchmark.h"
 #include "Linx/Run/ProgramOptions.h"
 #include "LinxRun/IterationBenchmark.h"
 
 #include <map>
 #include <string>
 
-Linx::IterationBenchmark::Duration iterate(Linx::IterationBenchmark& benchmark, char setup)
+Linx::IterationBenchmark::Duration
+iterate(Linx::IterationBenchmark& benchmark, char setup, const Linx::Threads& threads = Linx::Threads(1))
 {
   switch (setup) {
     case 'x':
@@ -19,8 +21,14 @@ Linx::IterationBenchmark::Duration iterate(Linx::IterationBenchmark& benchmark,
       return benchmark.iterate_over_positions();
     case 'q':
       return benchmark.iterate_over_positions_optimized();
+    case 'r':
+      return benchmark.iterate_over_rows();
+    case 's':
+      return benchmark.iterate_over_spans();
     case 'i':
       return benchmark.loop_over_indices();
+    case 't':
+      return benchmark.loop_over_indices(threads);
     case 'v':
       return benchmark.iterate_over_values();
     case 'o':
@@ -38,17 +46,25 @@ int main(int argc, char const* argv[])
   options.named<char>(
       "case",
       "Initial of the test case to be benchmarked: "
-      "x (x-y-z), z (z-y-x), p (position), i (index), v (value), o (operator), g (generate)");
+      "x (x-y-z), z (z-y-x), p (position), q (position-index), r (row), s (span), i (index), "
+      "t (index with multi-threading), v (value), o (operator), g (generate)");
   options.named<long>("side", "Image width, height and depth (same value)", 400);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
   options.parse(argc, argv);
 
   std::cout << "Generating random rasters..." << std::endl;
   Linx::IterationBenchmark benchmark(options.as<Linx::Index>("side"));
 
   std::cout << "Iterating over them..." << std::endl;
-  const auto duration = iterate(benchmark, options.as<char>("case"));
+  const auto setup = options.as<char>("case");
+  const Linx::Threads threads; // Of the t case, set with --threads
+  Linx::Benchmark<> runner(Linx::BenchmarkOptions::parse(options));
+  runner.run([&]() {
+    iterate(benchmark, setup, threads);
+  });
 
-  std::cout << "Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "Done in " << runner << std::endl;
 
   return 0;
 }
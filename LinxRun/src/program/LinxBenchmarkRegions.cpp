@@ -4,24 +4,26 @@
 
 #include "Linx/Data/Grid.h"
 #include "Linx/Data/Mask.h"
+#include "Linx/Data/PositionOffsets.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Data/Sequence.h"
+#include "Linx/Run/Benchmark.h"
 #include "Linx/Run/ProgramOptions.h"
-#include "Linx/Run/Timer.h"
 
 #include <map>
 #include <string>
 
-template <typename TDuration>
-TDuration filter(Linx::Raster<int, 3>& in, const Linx::Box<3>& box, char setup)
+void filter(
+    Linx::Raster<int, 3>& in,
+    const Linx::Box<3>& box,
+    const Linx::Grid<3>& grid,
+    const Linx::Mask<3>& mask,
+    const Linx::Sequence<Linx::Position<3>>& sequence,
+    const Linx::PositionOffsets<3>& offsets,
+    Linx::Sequence<int>& values,
+    const Linx::Threads& threads,
+    char setup)
 {
-  Linx::Timer<TDuration> timer;
-  //! [Make sparse regions]
-  Linx::Grid<3> grid(box, Linx::Position<3>::one());
-  Linx::Mask<3> mask(box);
-  Linx::Sequence<Linx::Position<3>> sequence(box);
-  //! [Make sparse regions]
-  timer.start();
   switch (setup) {
     case 'b':
       //! [Iterate over box]
@@ -43,41 +45,99 @@ TDuration filter(Linx::Raster<int, 3>& in, const Linx::Box<3>& box, char setup)
       in(sequence) += 1;
       //! [Iterate over sequence]
       break;
+    case 'r':
+      //! [Iterate over spans]
+      in(box).for_each_span([](auto* data, Linx::Index size, Linx::Index stride) {
+        for (Linx::Index i = 0; i < size; ++i) {
+          data[i * stride] += 1;
+        }
+      });
+      //! [Iterate over spans]
+      break;
+    case 't': {
+      //! [Shift patch]
+      auto patch = in(Linx::Box<3>::from_center(0));
+      for (const auto& p : box) {
+        patch >>= p;
+        patch += 1;
+        patch <<= p;
+      }
+      //! [Shift patch]
+    } break;
+    case 'o':
+      //! [Gather and scatter]
+      offsets.gather_into(in, values, threads);
+      values += 1;
+      offsets.scatter(values, in, threads);
+      //! [Gather and scatter]
+      break;
+    case 'l': {
+      //! [Iterate over slices concurrently]
+      const auto front = box.front()[2];
+      const auto length = box.length(2);
+#pragma omp parallel for num_threads(threads.count())
+      for (Linx::Index z = 0; z < length; ++z) {
+        auto slice_front = box.front();
+        auto slice_back = box.back();
+        slice_front[2] = slice_back[2] = front + z;
+        in(Linx::Box<3>(slice_front, slice_back)) += 1;
+      }
+      //! [Iterate over slices concurrently]
+    } break;
     default:
       throw std::runtime_error("Case not implemented"); // FIXME CaseNotImplemented
   }
-  return timer.stop();
 }
 
 int main(int argc, char const* argv[])
 {
-  using Duration = std::chrono::milliseconds;
-
   Linx::ProgramOptions options;
   options.named<char>(
       "case",
       "Initial of the test case to be benchmarked: "
-      "b (box), g (grid), m (mask), s (sequence)");
+      "b (box), g (grid), m (mask), s (sequence), r (box spans), t (shifted one-pixel patch), "
+      "o (offsets gather and scatter), l (box slices with multi-threading)");
   options.named("side", "Image width, height and depth (same value)", 400L);
   options.named("radius", "Region radius", 10L);
+  Linx::BenchmarkOptions().declare(options);
+  options.performance();
   options.parse(argc, argv);
 
   const auto setup = options.as<char>("case");
   const auto side = options.as<Linx::Index>("side");
   const auto radius = options.as<Linx::Index>("radius");
+  const Linx::Threads threads; // Of the o and l cases, set with --threads
 
   std::cout << "Generating random raster..." << std::endl;
   auto raster = Linx::Raster<int, 3>({side, side, side});
   //! [Make box]
   const auto box = Linx::Box<3>::from_center(radius, {side / 2, side / 2, side / 2});
   //! [Make box]
+  //! [Make sparse regions]
+  Linx::Grid<3> grid(box, Linx::Position<3>::one());
+  Linx::Mask<3> mask(box);
+  Linx::Sequence<Linx::Position<3>> sequence(box);
+  //! [Make sparse regions]
+  //! [Make offsets]
+  const Linx::PositionOffsets<3> offsets(raster.shape(), sequence);
+  Linx::Sequence<int> values(offsets.size());
+  //! [Make offsets]
 
   std::cout << "Filtering it..." << std::endl;
-  const auto duration = filter<Duration>(raster, box, setup);
+  auto parameters = Linx::BenchmarkOptions::parse(options);
+  parameters.bytes = 2 * box.size() * sizeof(int);
+  Linx::Benchmark<> benchmark(parameters);
+  benchmark.run(
+      [&]() {
+        filter(raster, box, grid, mask, sequence, offsets, values, threads, setup);
+      },
+      [&]() {
+        raster.fill(0);
+      });
   const auto count = std::accumulate(raster.begin(), raster.end(), 0);
 
   std::cout << "  Performed " << count << " additions" << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "  Done in " << benchmark << std::endl;
 
   return 0;
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ int main(int argc, char const* argv[])
   options.named<float>("translate", "Translation along first axis", 0);
   options.named<float>("scale", "Scaling factor", 1);
   options.named<float>("rotate", "Rotation angle (deg)", 0);
+  options.performance();
   options.parse(argc, argv);
   const auto filename = options.as<std::string>("output");
   const auto side = options.as<Linx::Index>("side");
@@ -13,19 +13,111 @@
 #include <string>
 #include <vector>
 
+/**
+ * @brief An image HDU of some input file.
+ */
+struct Frame {
+  std::size_t file;
+  Linx::Index hdu;
+};
+
+/**
+ * @brief The buffers of a worker, which are reused from frame to frame.
+ */
+struct Slot {
+  Linx::Raster<float> data;
+  Linx::Cosmics::Hits hits;
+  Linx::Index count = 0;
+};
+
+/**
+ * @brief List the 2D image HDUs of the input files, skipping empty HDUs such as the Primary of an extension file.
+ */
+std::vector<Frame> list_frames(std::vector<Linx::Fits>& files)
+{
+  std::vector<Frame> out;
+  for (std::size_t f = 0; f < files.size(); ++f) {
+    const auto count = files[f].hdu_count();
+    for (Linx::Index h = 0; h < count; ++h) {
+      const auto shape = files[f].read_shape<-1>(h);
+      if (shape.size() == 2 && shape_size(shape) > 0) {
+        out.push_back({f, h});
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Detect and segment the cosmic rays of all the image HDUs of the input files concurrently.
+ *
+ * Frames are processed by batches of one frame per thread:
+ * each batch is read serially into the worker buffers, processed in parallel as sparse maps,
+ * and the dense masks are appended to the output file in input order.
+ */
+void run_batch(
+    std::vector<Linx::Fits>& data_files,
+    Linx::Fits& map_fits,
+    const Linx::Raster<float>& psf,
+    double pfa,
+    double tq,
+    double tc,
+    Linx::Index iter_count)
+{
+  const auto frames = list_frames(data_files);
+  const Linx::Index frame_count = frames.size();
+  const Linx::Index thread_count = Linx::Threads().count();
+  const auto worker_count = std::max<Linx::Index>(1, std::min(thread_count, frame_count));
+  std::cout << "Processing " << frame_count << " frames with " << worker_count << " workers..." << std::endl;
+  std::vector<Slot> slots(worker_count);
+
+  Linx::Timer<std::chrono::milliseconds> timer;
+  timer.start();
+  for (Linx::Index front = 0; front < frame_count; front += worker_count) {
+    const auto size = std::min(worker_count, frame_count - front);
+    for (Linx::Index i = 0; i < size; ++i) {
+      const auto& frame = frames[front + i];
+      auto& fits = data_files[frame.file];
+      auto& slot = slots[i];
+      const auto shape = fits.read_shape(frame.hdu);
+      if (slot.data.shape() != shape) {
+        slot.data = Linx::Raster<float>(shape);
+      }
+      fits.read_to(slot.data.domain(), slot.data, frame.hdu);
+    }
+#pragma omp parallel for num_threads(size) schedule(dynamic)
+    for (Linx::Index i = 0; i < size; ++i) {
+      auto& slot = slots[i];
+      slot.hits = Linx::Cosmics::detect_sparse(slot.data, psf, pfa, tq);
+      slot.count = Linx::Cosmics::segment(slot.data, slot.hits, tc, iter_count);
+    }
+    for (Linx::Index i = 0; i < size; ++i) {
+      const auto& frame = frames[front + i];
+      const auto& slot = slots[i];
+      map_fits.write(slot.hits.raster(), 'a');
+      const auto density = double(slot.hits.size()) / slot.data.size();
+      std::cout << "  " << data_files[frame.file].path().filename().string() << "[" << frame.hdu
+                << "]: density: " << density << " (" << slot.count << " pixels added)" << std::endl;
+    }
+  }
+  timer.stop();
+  std::cout << "  Done in: " << timer.back().count() << " ms" << std::endl;
+}
+
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options;
-  options.positional<std::string>("input", "The input data file name");
+  options.positional<std::string>("input", "The input data file name, or comma-separated file names in batch mode");
   options.positional<std::string>("output", "The output mask file name");
   options.named<std::string>("psf", "The PSF file name");
-  options.named("hdu,i", "The 0-based input HDU index slice", 0L);
+  options.named("hdu,i", "The 0-based input HDU index slice, or -1 to process all HDUs in batch mode", 0L);
   options.named("pfa,p", "The detection probability of false alarm", 0.01);
   options.named("quotient,q", "The star rejection quotient threshold", 0.1);
   options.named("contrast,c", "The region-growing contrast threshold", 0.5);
-  options.named("niter,n", "The number of segmentation iterations", 1L);
+  options.named("niter,n", "The maximum number of segmentation iterations (-1 for no limit)", 1L);
+  options.named("debug", "The file name of the intermediate detection maps (or empty)", std::string());
+  options.performance();
   options.parse(argc, argv);
-  Linx::Fits data_fits(options.as<std::string>("input"));
   Linx::Fits map_fits(options.as<std::string>("output"));
   Linx::Fits psf_fits(options.as<std::string>("psf"));
   const auto hdu = options.as<Linx::Index>("hdu");
@@ -34,32 +126,54 @@ int main(int argc, char const* argv[])
   const auto tc = options.as<double>("contrast");
   const auto iter_count = options.as<Linx::Index>("niter");
 
+  std::cout << "Reading PSF: " << psf_fits.path() << std::endl;
+  auto psf = psf_fits.read<Linx::Raster<float>>();
+  map_fits.open('w');
+
+  if (hdu < 0) {
+    std::vector<std::string> names;
+    boost::split(names, options.as<std::string>("input"), boost::is_any_of(","));
+    std::vector<Linx::Fits> data_files;
+    for (const auto& name : names) {
+      data_files.emplace_back(name);
+      data_files.back().open(); // Keep open across frames
+    }
+    run_batch(data_files, map_fits, psf, pfa, tq, tc, iter_count);
+    std::cout << "Saved maps as: " << map_fits.path() << std::endl;
+    return 0;
+  }
+
+  Linx::Fits data_fits(options.as<std::string>("input"));
   Linx::Timer<std::chrono::milliseconds> timer;
 
   std::cout << "Reading data: " << data_fits.path() << std::endl;
   auto data = data_fits.read<Linx::Raster<float>>(hdu);
-  std::cout << "Reading PSF: " << psf_fits.path() << std::endl;
-  auto psf = psf_fits.read<Linx::Raster<float>>();
-  map_fits.write(data, 'w');
+  map_fits.write(data, 'a');
 
   std::cout << "Detecting cosmics..." << std::endl;
   timer.start();
-  auto mask = Linx::Cosmics::detect(data, psf, pfa, tq);
+  const auto debug = options.as<std::string>("debug");
+  Linx::Raster<char> mask;
+  if (debug.empty()) {
+    mask = Linx::Cosmics::detect(data, psf, pfa, tq);
+  } else {
+    Linx::Fits debug_fits(debug);
+    debug_fits.open('w');
+    mask = Linx::Cosmics::detect(data, psf, pfa, tq, debug_fits);
+  }
   timer.stop();
   std::cout << "  Done in: " << timer.back().count() << " ms" << std::endl;
   std::cout << "  Density: " << Linx::mean(mask) << std::endl;
   map_fits.write(mask, 'a');
 
   std::cout << "Segmenting cosmics..." << std::endl;
-  for (Linx::Index i = 0; i < iter_count; ++i) {
-    std::cout << "  Iteration " << i + 1 << "/" << iter_count << std::endl;
-    timer.start();
-    Linx::Cosmics::segment(data, mask, tc);
-    timer.stop();
-    std::cout << "    Done in: " << timer.back().count() << " ms" << std::endl;
-    std::cout << "    Density: " << Linx::mean(mask) << std::endl;
-    map_fits.write(mask, 'a');
-  }
+  timer.start();
+  const auto count = Linx::Cosmics::segment(data, mask, tc, iter_count);
+  timer.stop();
+  std::cout << "  Done in: " << timer.back().count() << " ms" << std::endl;
+  std::cout << "  Added pixels: " << count << std::endl;
+  std::cout << "  Density: " << Linx::mean(mask) << std::endl;
+  map_fits.write(mask, 'a');
 
   std::cout << "Saved map as: " << map_fits.path() << std::endl;
 
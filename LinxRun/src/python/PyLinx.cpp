@@ -0,0 +1,371 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/Interpolation.h"
+#include "LinxTransforms/Dft.h"
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file PyLinx.cpp
+ * @brief Python bindings of the rasters, filters, warps and DFTs.
+ *
+ * Rasters and NumPy arrays share their memory in both directions:
+ * - NumPy arrays are viewed as `PtrRaster`s when they are C-contiguous and of the right dtype (otherwise they are
+ *   converted once by NumPy);
+ * - Rasters expose the buffer protocol, such that `numpy.asarray(raster)` is a view;
+ * - Rasters computed by Linx are moved to the heap and returned as arrays which own them.
+ *
+ * Following NumPy, shapes are reversed with respect to Linx: a Linx raster of shape `{width, height}`
+ * is an array of shape `(height, width)`.
+ * The GIL is released during the computations, such that Python threads can run concurrently.
+ */
+
+namespace py = pybind11;
+
+namespace {
+
+/**
+ * @brief C-contiguous NumPy array of some value type.
+ */
+template <typename T>
+using Array = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief Get the NumPy shape of a raster.
+ */
+template <typename TRaster>
+std::vector<py::ssize_t> numpy_shape(const TRaster& raster)
+{
+  const auto& shape = raster.shape();
+  std::vector<py::ssize_t> out(shape.begin(), shape.end());
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+/**
+ * @brief Get the NumPy strides of a raster, in bytes.
+ */
+template <typename TRaster>
+std::vector<py::ssize_t> numpy_strides(const TRaster& raster)
+{
+  std::vector<py::ssize_t> out(raster.dimension());
+  py::ssize_t stride = sizeof(typename TRaster::Value);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    out[out.size() - 1 - i] = stride;
+    stride *= raster.length(i);
+  }
+  return out;
+}
+
+/**
+ * @brief Get the Linx shape of a NumPy array.
+ */
+template <Linx::Index N, typename TArray>
+Linx::Position<N> linx_shape(const TArray& array)
+{
+  if (array.ndim() != N) {
+    throw std::invalid_argument(
+        "Array dimension mismatch: got " + std::to_string(array.ndim()) + ", expected " + std::to_string(N));
+  }
+  Linx::Position<N> out;
+  for (Linx::Index i = 0; i < N; ++i) {
+    out[i] = array.shape(N - 1 - i);
+  }
+  return out;
+}
+
+/**
+ * @brief View a NumPy array as a raster, without copy.
+ */
+template <Linx::Index N, typename T>
+Linx::PtrRaster<const T, N> view(const Array<T>& array)
+{
+  return Linx::PtrRaster<const T, N>(linx_shape<N>(array), array.data());
+}
+
+/**
+ * @copydoc view()
+ */
+template <Linx::Index N, typename T>
+Linx::PtrRaster<T, N> view(Array<T>& array)
+{
+  return Linx::PtrRaster<T, N>(linx_shape<N>(array), array.mutable_data());
+}
+
+/**
+ * @brief Move a raster to the heap and return it as an array which owns it, without copy.
+ */
+template <typename TRaster>
+py::array to_array(TRaster&& raster)
+{
+  using Raster = std::decay_t<TRaster>;
+  auto* owner = new Raster(std::move(raster));
+  py::capsule base(owner, [](void* ptr) {
+    delete static_cast<Raster*>(ptr);
+  });
+  return py::array_t<typename Raster::Value>(numpy_shape(*owner), numpy_strides(*owner), owner->data(), base);
+}
+
+/**
+ * @brief Call a function with an extrapolator of a raster.
+ * @param method The extrapolation method: constant (zero), nearest, periodic or reflect
+ */
+template <typename TRaster, typename TFunc>
+void with_extrapolation(const std::string& method, const TRaster& in, TFunc&& func)
+{
+  using Value = std::remove_const_t<typename TRaster::Value>;
+  if (method == "constant") {
+    func(Linx::extrapolation<Linx::Constant<Value>>(in, Value(0)));
+  } else if (method == "nearest") {
+    func(Linx::extrapolation<Linx::Nearest>(in));
+  } else if (method == "periodic") {
+    func(Linx::extrapolation<Linx::Periodic>(in));
+  } else if (method == "reflect") {
+    func(Linx::extrapolation<Linx::Reflect>(in));
+  } else {
+    throw std::invalid_argument("Unknown extrapolation method: " + method);
+  }
+}
+
+/**
+ * @brief Call a function with an interpolation method tag.
+ * @param method The interpolation method: nearest, linear, cubic or lanczos (3 lobes)
+ */
+template <typename TFunc>
+void with_interpolation(const std::string& method, TFunc&& func)
+{
+  if (method == "nearest") {
+    func(Linx::Nearest());
+  } else if (method == "linear") {
+    func(Linx::Linear());
+  } else if (method == "cubic") {
+    func(Linx::Cubic());
+  } else if (method == "lanczos") {
+    func(Linx::Lanczos<3>());
+  } else {
+    throw std::invalid_argument("Unknown interpolation method: " + method);
+  }
+}
+
+/**
+ * @brief Apply a filter to an extrapolated image into a new array.
+ */
+template <typename T, typename TFilter>
+py::array apply(const TFilter& filter, const Array<T>& image, const std::string& extrapolation, Linx::Index threads)
+{
+  const auto in = view<2>(image);
+  Array<T> output(numpy_shape(in));
+  auto out = view<2>(output);
+  {
+    py::gil_scoped_release release;
+    with_extrapolation(extrapolation, in, [&](const auto& extrapolated) {
+      filter.transform(extrapolated, out, Linx::Threads(threads));
+    });
+  }
+  return std::move(output);
+}
+
+/**
+ * @brief Warp an extrapolated image with some interpolation method into a new array.
+ */
+template <typename T, typename TFunc>
+py::array warp(const Array<T>& image, const std::string& interpolation, TFunc&& func)
+{
+  const auto in = view<2>(image);
+  Linx::Raster<T> out;
+  {
+    py::gil_scoped_release release;
+    const auto extrapolated = Linx::extrapolation<Linx::Constant<T>>(in, T(0));
+    with_interpolation(interpolation, [&](auto method) {
+      out = func(method, extrapolated);
+    });
+  }
+  return to_array(std::move(out));
+}
+
+/**
+ * @brief Bind a raster class with the buffer protocol.
+ */
+template <typename TRaster>
+void bind_raster(py::module_& m, const char* name)
+{
+  using Value = typename TRaster::Value;
+  py::class_<TRaster>(m, name, py::buffer_protocol(), "2D raster, viewable as a NumPy array with numpy.asarray()")
+      .def(py::init([](const Array<Value>& array) {
+             const auto in = view<2>(array);
+             TRaster out(in.shape());
+             std::copy(in.begin(), in.end(), out.begin());
+             return out;
+           }),
+           py::arg("array"),
+           "Copy a NumPy array.")
+      .def_property_readonly("shape", &numpy_shape<TRaster>, "The NumPy shape.")
+      .def_buffer([](TRaster& raster) {
+        return py::buffer_info(
+            raster.data(),
+            sizeof(Value),
+            py::format_descriptor<Value>::format(),
+            raster.dimension(),
+            numpy_shape(raster),
+            numpy_strides(raster));
+      });
+}
+
+/**
+ * @brief Bind the functions of some value type.
+ */
+template <typename T>
+void bind_functions(py::module_& m)
+{
+  const auto image_arg = py::arg("image");
+  const auto extrapolation_arg = py::arg("extrapolation") = "nearest";
+  const auto interpolation_arg = py::arg("interpolation") = "linear";
+  const auto threads_arg = py::arg("threads") = 1;
+
+  m.def(
+      "convolve",
+      [](const Array<T>& image, const Array<T>& kernel, const std::string& extrapolation, Linx::Index threads) {
+        return apply<T>(Linx::convolution(view<2>(kernel)), image, extrapolation, threads);
+      },
+      image_arg,
+      py::arg("kernel"),
+      extrapolation_arg,
+      threads_arg,
+      "Convolve an image with a kernel centered at (shape - 1) / 2.");
+  m.def(
+      "correlate",
+      [](const Array<T>& image, const Array<T>& kernel, const std::string& extrapolation, Linx::Index threads) {
+        return apply<T>(Linx::correlation(view<2>(kernel)), image, extrapolation, threads);
+      },
+      image_arg,
+      py::arg("kernel"),
+      extrapolation_arg,
+      threads_arg,
+      "Correlate an image with a kernel centered at (shape - 1) / 2.");
+  m.def(
+      "mean_filter",
+      [](const Array<T>& image, Linx::Index radius, const std::string& extrapolation, Linx::Index threads) {
+        return apply<T>(Linx::mean_filter<T>(Linx::Box<2>::from_center(radius)), image, extrapolation, threads);
+      },
+      image_arg,
+      py::arg("radius"),
+      extrapolation_arg,
+      threads_arg,
+      "Apply a mean filter over a square window.");
+  m.def(
+      "median_filter",
+      [](const Array<T>& image, Linx::Index radius, const std::string& extrapolation, Linx::Index threads) {
+        return apply<T>(Linx::median_filter<T>(Linx::Box<2>::from_center(radius)), image, extrapolation, threads);
+      },
+      image_arg,
+      py::arg("radius"),
+      extrapolation_arg,
+      threads_arg,
+      "Apply a median filter over a square window.");
+  m.def(
+      "gaussian_filter",
+      [](const Array<T>& image, double sigma, const std::string& extrapolation, Linx::Index threads) {
+        return apply<T>(Linx::gaussian_filter<T, 0, 1>(sigma), image, extrapolation, threads);
+      },
+      image_arg,
+      py::arg("sigma"),
+      extrapolation_arg,
+      threads_arg,
+      "Apply a separable Gaussian filter.");
+
+  m.def(
+      "translate",
+      [](const Array<T>& image, double dx, double dy, const std::string& interpolation, Linx::Index threads) {
+        return warp(image, interpolation, [&](auto method, const auto& in) {
+          return Linx::translate<decltype(method)>(in, {dx, dy}, Linx::Threads(threads));
+        });
+      },
+      image_arg,
+      py::arg("dx"),
+      py::arg("dy"),
+      interpolation_arg,
+      threads_arg,
+      "Translate an image, with zero extrapolation.");
+  m.def(
+      "scale",
+      [](const Array<T>& image, double factor, const std::string& interpolation, Linx::Index threads) {
+        return warp(image, interpolation, [&](auto method, const auto& in) {
+          return Linx::scale<decltype(method)>(in, factor, Linx::Threads(threads));
+        });
+      },
+      image_arg,
+      py::arg("factor"),
+      interpolation_arg,
+      threads_arg,
+      "Scale an image from its center, with zero extrapolation.");
+  m.def(
+      "rotate_deg",
+      [](const Array<T>& image, double angle, const std::string& interpolation, Linx::Index threads) {
+        return warp(image, interpolation, [&](auto method, const auto& in) {
+          return Linx::rotate_deg<decltype(method)>(in, angle, 0, 1, Linx::Threads(threads));
+        });
+      },
+      image_arg,
+      py::arg("angle"),
+      interpolation_arg,
+      threads_arg,
+      "Rotate an image around its center, with zero extrapolation.");
+
+  m.def(
+      "real_dft",
+      [](const Array<T>& image) {
+        const auto in = view<2>(image);
+        Linx::ComplexDftBuffer<2, T> out;
+        {
+          py::gil_scoped_release release;
+          out = Linx::real_dft<T>(in);
+        }
+        return to_array(std::move(out));
+      },
+      image_arg,
+      "Compute the real DFT, i.e. the half-spectrum of shape (height, width / 2 + 1).");
+  m.def(
+      "inverse_real_dft",
+      [](const Array<std::complex<T>>& spectrum, Linx::Index width) {
+        const auto in = view<2>(spectrum);
+        Linx::RealDftBuffer<2, T> out;
+        {
+          py::gil_scoped_release release;
+          out = Linx::inverse_real_dft<T>(in, {width, in.length(1)});
+        }
+        return to_array(std::move(out));
+      },
+      py::arg("spectrum"),
+      py::arg("width"),
+      "Compute the normalized inverse real DFT of a half-spectrum.");
+}
+
+} // namespace
+
+PYBIND11_MODULE(PyLinx, m)
+{
+  m.doc() = "Linx rasters, filters, warps and DFTs with zero-copy NumPy interoperability.";
+
+  bind_raster<Linx::Raster<float, 2>>(m, "RasterF");
+  bind_raster<Linx::Raster<double, 2>>(m, "RasterD");
+  bind_raster<Linx::AlignedRaster<float, 2>>(m, "AlignedRasterF");
+  bind_raster<Linx::AlignedRaster<double, 2>>(m, "AlignedRasterD");
+
+  // Overloads are resolved in order, without conversion first: float arrays select the float functions
+  bind_functions<float>(m);
+  bind_functions<double>(m);
+}
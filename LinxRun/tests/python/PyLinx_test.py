@@ -0,0 +1,66 @@
+# @copyright 2022-2024, Antoine Basset (CNES)
+# This file is part of Linx <github.com/kabasset/Linx>
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+import unittest
+
+import numpy as np
+
+try:
+    import PyLinx  # Optional bindings, built if pybind11 is found
+except ImportError:
+    raise unittest.SkipTest('PyLinx is not built')
+
+
+def naive_mean_filter(image, radius):
+    padded = np.pad(image.astype(np.float64), radius, mode='edge')
+    height, width = image.shape
+    out = np.zeros(image.shape)
+    for dy in range(2 * radius + 1):
+        for dx in range(2 * radius + 1):
+            out += padded[dy:dy + height, dx:dx + width]
+    return out / (2 * radius + 1) ** 2
+
+
+class PyLinxTest(unittest.TestCase):
+
+    def test_zero_copy_asarray(self):
+        image = np.arange(12, dtype=np.float32).reshape(3, 4)
+        raster = PyLinx.RasterF(image)
+        self.assertEqual(raster.shape, [3, 4])
+        view = np.asarray(raster)
+        self.assertEqual(view.shape, (3, 4))
+        self.assertEqual(view.dtype, np.float32)
+        np.testing.assert_array_equal(view, image)
+        view[1, 2] = -1
+        other = np.asarray(raster)
+        self.assertTrue(np.shares_memory(view, other))
+        self.assertEqual(other[1, 2], -1)
+        self.assertEqual(image[1, 2], 6)  # The raster owns a copy of the input
+
+    def test_ndim_rejection(self):
+        cube = np.zeros((2, 3, 4), dtype=np.float32)
+        with self.assertRaises(ValueError):
+            PyLinx.RasterF(cube)
+        with self.assertRaises(ValueError):
+            PyLinx.mean_filter(cube, 1)
+
+    def test_dtype_rejection(self):
+        strings = np.array([['a', 'b'], ['c', 'd']])
+        with self.assertRaises(TypeError):
+            PyLinx.mean_filter(strings, 1)
+        with self.assertRaises(TypeError):
+            PyLinx.inverse_real_dft(strings, 2)
+
+    def test_mean_filter(self):
+        image = (np.arange(35 * 23) * 7919 % 101).astype(np.float64).reshape(23, 35)
+        out = PyLinx.mean_filter(image, 2, 'nearest', 2)
+        self.assertEqual(out.dtype, np.float64)
+        np.testing.assert_allclose(out, naive_mean_filter(image, 2), rtol=1e-10)
+        out = PyLinx.mean_filter(image.astype(np.float32), 2)
+        self.assertEqual(out.dtype, np.float32)
+        np.testing.assert_allclose(out, naive_mean_filter(image, 2), rtol=1e-4)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,106 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Run/AsyncIo.h"
+
+#include <atomic>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <stdexcept>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(AsyncIo_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(io_pool_test)
+{
+  IoPool io(2);
+  BOOST_TEST(io.size() == 2);
+  auto answer = io.submit([]() {
+    return 42;
+  });
+  auto failure = io.submit([]() {
+    throw std::runtime_error("I/O error");
+  });
+  BOOST_TEST(answer.get() == 42);
+  BOOST_CHECK_THROW(failure.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_test)
+{
+  BufferPool<Raster<float>> buffers(2, []() {
+    return Raster<float>({3, 2});
+  });
+  BOOST_TEST(buffers.size() == 2);
+  auto a = buffers.acquire();
+  auto b = buffers.try_acquire();
+  BOOST_TEST(a);
+  BOOST_TEST(b);
+  BOOST_TEST(a.get() != b.get());
+  BOOST_TEST((a->shape() == Position<2> {3, 2}));
+  BOOST_TEST(not buffers.try_acquire());
+  BOOST_TEST(buffers.available() == 0);
+  const auto* ptr = a.get();
+  a.reset();
+  BOOST_TEST(buffers.available() == 1);
+  BOOST_TEST(buffers.acquire().get() == ptr);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_test)
+{
+  IoPool io(2);
+  BufferPool<Raster<int, 1>> buffers(3, []() {
+    return Raster<int, 1>({4});
+  });
+  std::atomic<int> reading(0);
+  std::atomic<int> max_reading(0);
+  std::vector<int> inputs {1, 2, 3, 4, 5, 6, 7};
+  auto frames = prefetch(
+      io,
+      buffers,
+      inputs,
+      [&](int i, Raster<int, 1>& out) {
+        const auto count = ++reading;
+        max_reading = std::max(max_reading.load(), count);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        out.fill(i);
+        --reading;
+      },
+      2);
+  BOOST_TEST(frames.pending() == 2);
+  std::vector<int> outputs;
+  while (auto frame = frames.next()) {
+    outputs.push_back((*frame)[0]);
+  }
+  BOOST_TEST(outputs == inputs);
+  BOOST_TEST(max_reading <= 2);
+  BOOST_TEST(buffers.available() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_error_test)
+{
+  IoPool io(1);
+  BufferPool<int> buffers(2, []() {
+    return 0;
+  });
+  auto values = prefetch(io, buffers, std::vector<int> {1, 0, 2}, [](int i, int& out) {
+    if (i == 0) {
+      throw std::runtime_error("Cannot read");
+    }
+    out = i;
+  });
+  BOOST_TEST(*values.next() == 1);
+  BOOST_CHECK_THROW(values.next(), std::runtime_error);
+  BOOST_TEST(*values.next() == 2);
+  BOOST_TEST(not values.next());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Temporary.h"
+#include "Linx/Run/Benchmark.h"
+
+#include <algorithm> // count
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Benchmark_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(runs_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 2;
+  options.min_runs = 3;
+  options.max_runs = 7;
+  options.precision = 0;
+  Benchmark<> benchmark(options);
+  Index calls = 0;
+  Index setups = 0;
+  benchmark.run(
+      [&]() {
+        ++calls;
+      },
+      [&]() {
+        ++setups;
+      });
+  BOOST_TEST(calls == 9);
+  BOOST_TEST(setups == 9);
+  BOOST_TEST(benchmark.timer().size() == 7);
+  BOOST_TEST(not benchmark.converged());
+}
+
+BOOST_AUTO_TEST_CASE(untimed_setup_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.max_runs = 5;
+  Benchmark<> benchmark(options);
+  benchmark.run(
+      []() {},
+      []() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      });
+  BOOST_TEST(benchmark.distribution().max() < 5);
+}
+
+BOOST_AUTO_TEST_CASE(outlier_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.min_runs = 20;
+  options.max_runs = 20;
+  Benchmark<> benchmark(options);
+  Index i = 0;
+  benchmark.run([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(i == 10 ? 100 : 2));
+    ++i;
+  });
+  BOOST_TEST(benchmark.timer().size() == 20);
+  BOOST_TEST(benchmark.outliers() >= 1);
+  BOOST_TEST(benchmark.distribution().max() < 50);
+  BOOST_TEST(benchmark.timer().max() >= 100);
+}
+
+BOOST_AUTO_TEST_CASE(convergence_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.min_runs = 5;
+  options.max_runs = 1000;
+  options.precision = 0.5;
+  Benchmark<> benchmark(options);
+  benchmark.run([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  BOOST_TEST(benchmark.converged());
+  BOOST_TEST(benchmark.timer().size() < 1000);
+  BOOST_TEST(benchmark.relative_error() <= 0.5);
+  std::ostringstream os;
+  os << benchmark;
+  BOOST_TEST(os.str().find("ms") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(bandwidth_and_counters_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.max_runs = 5;
+  options.bytes = 1000000;
+  options.counters = true;
+  Benchmark<> benchmark(options);
+  benchmark.run([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  BOOST_TEST(benchmark.bandwidth() > 0);
+  BOOST_TEST(benchmark.bandwidth() < 1);
+  BOOST_TEST(benchmark.counters().available() == PerfCounters().available());
+  std::ostringstream os;
+  os << benchmark;
+  BOOST_TEST(os.str().find("GB/s") != std::string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(csv_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.max_runs = 5;
+  Benchmark<std::chrono::microseconds> benchmark(options);
+  benchmark.run([]() {});
+  const auto header = Benchmark<std::chrono::microseconds>::csv_header();
+  BOOST_TEST(header.find("median_us,") == 0);
+  std::ostringstream os;
+  benchmark.write_csv(os);
+  const auto line = os.str();
+  BOOST_TEST(std::count(line.begin(), line.end(), ',') == std::count(header.begin(), header.end(), ','));
+  BOOST_TEST(line.find('\n') == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(csv_file_test)
+{
+  BenchmarkOptions options;
+  options.warmup = 0;
+  options.max_runs = 5;
+  Benchmark<> benchmark(options);
+  benchmark.run([]() {});
+  TemporaryPath path("Benchmark_csv_file_test.csv");
+  {
+    BenchmarkCsv<> csv(path.string(), "operation,side");
+    BOOST_TEST(csv.is_file());
+    csv.write(benchmark, "noop", 512);
+    csv.write(benchmark, "noop", 1024);
+  }
+  std::ifstream file(path.string());
+  std::string header;
+  std::getline(file, header);
+  BOOST_TEST(header == "operation,side," + Benchmark<>::csv_header());
+  std::string line;
+  Index count = 0;
+  while (std::getline(file, line)) {
+    BOOST_TEST(std::count(line.begin(), line.end(), ',') == std::count(header.begin(), header.end(), ','));
+    ++count;
+  }
+  BOOST_TEST(count == 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxRun/Cosmics.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Make a noisy image with a star and a few cosmic rays.
+ */
+Raster<float> make_image(const Raster<float>& psf, Index side)
+{
+  Raster<float> out({side, side});
+  out.generate(GaussianNoise<float>(100, 1, 42));
+  const Position<2> star {side / 4, side / 4};
+  const auto offset = star - (psf.shape() - 1) / 2;
+  for (const auto& p : psf.domain()) {
+    out[p + offset] += 1000 * psf[p];
+  }
+  out[{side / 2, side / 2}] += 200;
+  out[{side / 2 + 1, side / 2}] += 150;
+  out[{3 * side / 4, side / 3}] += 300;
+  out[{0, side - 1}] += 300;
+  return out;
+}
+
+/**
+ * @brief Make a Gaussian PSF.
+ */
+Raster<float> make_psf(Index radius)
+{
+  Raster<float> out({2 * radius + 1, 2 * radius + 1});
+  const auto center = Position<2>::one() * radius;
+  for (const auto& p : out.domain()) {
+    const auto d = p - center;
+    out[p] = std::exp(-float(d[0] * d[0] + d[1] * d[1]) / 4.F);
+  }
+  return out;
+}
+
+/**
+ * @brief Debug file which records the intermediate maps.
+ */
+struct DebugFile {
+  void write(const Raster<float>& raster, char)
+  {
+    maps.push_back(raster);
+  }
+
+  std::vector<Raster<float>> maps;
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Cosmics_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fused_laplacian_test)
+{
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, 64);
+  double norm = 0;
+  const auto fused = Cosmics::laplacian(in, norm);
+  const auto expected = Cosmics::laplacian(in);
+  double sum = 0;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    BOOST_TEST(std::abs(fused[i] - expected[i]) < 1e-3);
+    sum += std::abs(expected[i]);
+  }
+  BOOST_TEST(norm == sum / expected.size(), boost::test_tools::tolerance(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(detect_matches_full_frame_test)
+{
+  const Index side = 64;
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, side);
+  const float pfa = 0.001;
+  const float tq = 0.5;
+
+  double norm = 0;
+  const auto laplacian_map = Cosmics::laplacian(in, norm);
+  const auto noise = robust_noise(laplacian_map, 4);
+  const auto tl = noise.median - noise.mad / std::log(2.0) * std::log(2.0 * pfa);
+  const Index radius = std::sqrt(psf.size()) / 4;
+  const auto quotient_map = Cosmics::dilate(Cosmics::quotient(in, psf), radius);
+  Raster<char> expected(in.shape());
+  expected.generate(
+      [=](auto l, auto q) {
+        return l > tl && q < tq;
+      },
+      laplacian_map,
+      quotient_map);
+
+  const auto mask = Cosmics::detect(in, psf, pfa, tq);
+  BOOST_TEST(mask == expected);
+  BOOST_TEST((mask[{side / 2, side / 2}]));
+}
+
+BOOST_AUTO_TEST_CASE(debug_maps_test)
+{
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, 64);
+  DebugFile debug;
+  const auto mask = Cosmics::detect(in, psf, 0.001, 0.5, debug);
+  BOOST_TEST(mask == Cosmics::detect(in, psf, 0.001, 0.5));
+  BOOST_TEST(debug.maps.size() == 2);
+  BOOST_TEST(debug.maps[0].shape() == in.shape());
+  BOOST_TEST(debug.maps[1].shape() == in.shape());
+  const auto computed = std::count_if(debug.maps[1].begin(), debug.maps[1].end(), [](auto e) {
+    return not std::isnan(e);
+  });
+  BOOST_TEST(computed > 0);
+  BOOST_TEST(computed < in.size()); // Only around the candidates
+}
+
+BOOST_AUTO_TEST_CASE(quantized_noise_test)
+{
+  const Index side = 64;
+  const auto psf = make_psf(4);
+  Raster<float> in({side, side});
+  in.fill(100);
+  for (std::size_t i = 0; i < in.size(); i += 37) {
+    in[i] += 1; // Sparse quantization noise, such that the MAD of the Laplacian is 0
+  }
+  in[{side / 2, side / 2}] += 300;
+  const auto hits = Cosmics::detect_sparse(in, psf, 0.001, 0.5);
+  BOOST_TEST(hits.size() == 1);
+  BOOST_TEST(hits.contains({side / 2, side / 2}));
+  Raster<float> flat({side, side});
+  flat.fill(100);
+  BOOST_TEST(Cosmics::detect_sparse(flat, psf, 0.001, 0.5).size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_detect_test)
+{
+  const Index side = 64;
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, side);
+  const auto mask = Cosmics::detect(in, psf, 0.001, 0.5);
+  const auto hits = Cosmics::detect_sparse(in, psf, 0.001, 0.5);
+  BOOST_TEST(hits.shape() == in.shape());
+  BOOST_TEST(hits.size() == std::count(mask.begin(), mask.end(), 1));
+  BOOST_TEST(hits.raster() == mask);
+  BOOST_TEST(Cosmics::Hits::from_mask(mask).indices() == hits.indices());
+  BOOST_TEST(hits.contains({side / 2, side / 2}));
+  BOOST_TEST((hits[{side / 2, side / 2}]));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_segment_test)
+{
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, 64);
+  for (Index iterations : {1, 2, -1}) {
+    auto mask = Cosmics::detect(in, psf, 0.001, 0.5);
+    auto hits = Cosmics::Hits::from_mask(mask);
+    const auto expected = Cosmics::segment(in, mask, 0.5, iterations);
+    const auto count = Cosmics::segment(in, hits, 0.5, iterations);
+    BOOST_TEST(count == expected);
+    BOOST_TEST(hits.raster() == mask);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(hits_components_test)
+{
+  Cosmics::Hits hits({10, 8});
+  hits.insert({hits.index({1, 1}), hits.index({2, 2}), hits.index({7, 2}), hits.index({8, 2}), hits.index({3, 3})});
+  hits.insert({hits.index({2, 2}), hits.index({9, 7})}); // Duplicates are ignored
+  BOOST_TEST(hits.size() == 6);
+  const auto components = hits.components();
+  BOOST_TEST(components.size() == 3);
+  BOOST_TEST(components[0].size == 3);
+  BOOST_TEST(components[0].box == Box<2>({1, 1}, {3, 3}));
+  BOOST_TEST(components[1].size == 2);
+  BOOST_TEST(components[1].box == Box<2>({7, 2}, {8, 2}));
+  BOOST_TEST(components[2].size == 1);
+  BOOST_TEST(components[2].box == Box<2>({9, 7}, {9, 7}));
+}
+
+BOOST_AUTO_TEST_CASE(match_test)
+{
+  const auto psf = make_psf(4);
+  const auto in = make_image(psf, 64);
+  const auto filter = SimpleFilter<Cosmics::PearsonCorrelation<float, Box<2>>>(
+      psf.domain() - (psf.shape() - 1) / 2,
+      psf.begin(),
+      psf.end());
+  const auto expected = filter * extrapolation<Nearest>(in);
+  const auto map = Cosmics::match(in, psf);
+  BOOST_TEST(map.shape() == expected.shape());
+  for (std::size_t i = 0; i < map.size(); ++i) {
+    BOOST_TEST(std::abs(map[i] - expected[i]) < 1e-3);
+  }
+  BOOST_TEST((map[{16, 16}] > 0.9)); // Star
+}
+
+BOOST_AUTO_TEST_CASE(flat_match_test)
+{
+  const auto psf = make_psf(4);
+  Raster<float> in({64, 64});
+  in.fill(100);
+  const auto map = Cosmics::match(in, psf);
+  const auto filter = SimpleFilter<Cosmics::PearsonCorrelation<float, Box<2>>>(
+      psf.domain() - (psf.shape() - 1) / 2,
+      psf.begin(),
+      psf.end());
+  const auto expected = filter * extrapolation<Nearest>(in);
+  for (std::size_t i = 0; i < map.size(); ++i) {
+    BOOST_TEST(map[i] == 0);
+    BOOST_TEST(expected[i] == 0);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,12 +55,30 @@ BOOST_AUTO_TEST_CASE(position_optimized_test)
   validate();
 }
 
+BOOST_AUTO_TEST_CASE(row_test)
+{
+  iterate_over_rows();
+  validate();
+}
+
+BOOST_AUTO_TEST_CASE(span_test)
+{
+  iterate_over_spans();
+  validate();
+}
+
 BOOST_AUTO_TEST_CASE(index_test)
 {
   loop_over_indices();
   validate();
 }
 
+BOOST_AUTO_TEST_CASE(parallel_index_test)
+{
+  loop_over_indices(Threads(2));
+  validate();
+}
+
 BOOST_AUTO_TEST_CASE(value_test)
 {
   iterate_over_values();
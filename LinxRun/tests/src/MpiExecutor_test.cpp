@@ -0,0 +1,88 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Run/MpiExecutor.h"
+
+#include <algorithm> // copy
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+struct MpiFixture {
+  MpiFixture()
+  {
+    MPI_Init(nullptr, nullptr);
+  }
+
+  ~MpiFixture()
+  {
+    MPI_Finalize();
+  }
+};
+
+BOOST_TEST_GLOBAL_FIXTURE(MpiFixture);
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MpiExecutor_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(box_sum_test)
+{
+  MpiExecutor executor;
+  BOOST_TEST(executor.rank() >= 0);
+  BOOST_TEST(executor.rank() < executor.size());
+
+  Raster<int> in({13, 11});
+  in.range();
+  const auto domain = in.domain();
+  const auto window = Box<2>::from_center(1);
+  const auto tiles = halo_tiles(domain, Position<2> {4, 3}, window);
+
+  Raster<int> expected(in.shape());
+  for (const auto& p : domain) {
+    for (const auto& q : (window + p) & domain) {
+      expected[p] += in[q];
+    }
+  }
+
+  Raster<int> out(in.shape());
+  out.fill(-1);
+  executor.run<int>(
+      tiles,
+      [&](const auto& tile) {
+        return Raster<int>(in(tile.outer & domain)); // Copy as if read from a file
+      },
+      [&](const auto& tile, const auto& patch) {
+        Raster<int> result(tile.inner.shape());
+        for (const auto& p : tile.inner) {
+          auto& r = result[p - tile.inner.front()];
+          for (const auto& q : (window + p) & domain) {
+            r += patch[q - (tile.outer & domain).front()];
+          }
+        }
+        return result;
+      },
+      [&](const auto& tile, const auto& result) {
+        std::copy(result.begin(), result.end(), out(tile.inner).begin());
+      });
+
+  if (executor.rank() == 0) {
+    BOOST_TEST(out == expected);
+    Index count = 0;
+    for (auto c : executor.counts()) {
+      count += c;
+    }
+    BOOST_TEST(count == static_cast<Index>(tiles.size()));
+    if (executor.size() > 1) {
+      BOOST_TEST(executor.counts()[0] == 0);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
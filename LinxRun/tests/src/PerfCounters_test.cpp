@@ -0,0 +1,61 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/PerfCounters.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PerfCounters_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(unavailable_sample_test)
+{
+  PerfSample sample;
+  BOOST_TEST(not sample.available());
+  BOOST_TEST(sample.ipc() == -1);
+  std::stringstream out;
+  out << sample;
+  BOOST_TEST(out.str() == "counters unavailable");
+}
+
+BOOST_AUTO_TEST_CASE(sample_arithmetics_test)
+{
+  PerfSample sample;
+  sample.counts = {100, 250, 10, 5, 20, -1};
+  BOOST_TEST(sample.available());
+  BOOST_TEST(sample.ipc() == 2.5);
+  BOOST_TEST(sample.cache_miss_rate() == 0.5);
+  BOOST_TEST(sample.branch_miss_rate() == -1);
+  sample += sample;
+  BOOST_TEST(sample[PerfSample::Cycles] == 200);
+  BOOST_TEST(sample[PerfSample::BranchMisses] == -1);
+  sample /= 4;
+  BOOST_TEST(sample[PerfSample::Instructions] == 125);
+  BOOST_TEST(sample[PerfSample::BranchMisses] == -1);
+}
+
+BOOST_AUTO_TEST_CASE(measurement_test)
+{
+  PerfCounters counters;
+  counters.start();
+  volatile double sum = 0;
+  for (int i = 0; i < 100000; ++i) {
+    sum = sum + i;
+  }
+  const auto sample = counters.stop();
+  BOOST_TEST(sample.available() == counters.available());
+  if (sample.has(PerfSample::Instructions)) {
+    BOOST_TEST(sample[PerfSample::Instructions] >= 100000);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -73,6 +73,32 @@ BOOST_AUTO_TEST_CASE(bad_options_test)
   BOOST_CHECK_THROW(po.parse("spurious_arg 1 --named a -n b -f 1"), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(list_test)
+{
+  ProgramOptions options;
+  options.named("names", "Comma-separated names", std::string("a,,bc"));
+  options.named("sides", "Comma-separated sides", std::string("1,2"));
+  options.parse("exe --sides 512,,2048");
+  BOOST_TEST(options.as_list("names") == (std::vector<std::string> {"a", "bc"}));
+  BOOST_TEST(options.as_list<Index>("sides") == (std::vector<Index> {512, 2048}));
+  BOOST_CHECK_THROW(options.as_list<double>("names"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(performance_test)
+{
+  ProgramOptions options;
+  options.performance();
+  options.parse("exe --threads 3 --memory 64");
+  BOOST_TEST(Threads::limit() == 3);
+  BOOST_TEST(MemoryBudget::limit() == 64 << 20);
+  BOOST_TEST(MemoryBudget::thickness(1 << 20, 100, 2) == 32);
+  ProgramOptions defaults;
+  defaults.performance();
+  defaults.parse("exe");
+  BOOST_TEST(Threads::limit() == 0);
+  BOOST_TEST(MemoryBudget::limit() == 0);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
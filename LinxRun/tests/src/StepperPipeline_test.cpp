@@ -4,7 +4,12 @@
 
 #include "Linx/Run/StepperPipeline.h"
 
+#include <atomic>
 #include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 using namespace Linx;
 
@@ -116,6 +121,176 @@ Step2::Value Dag::get_impl<Step2>()
   return m_2.value;
 }
 
+struct Bias : PipelineStep<int()> {};
+
+struct Dark : PipelineStep<int(Bias)> {};
+
+struct Flat : PipelineStep<int(Bias)> {};
+
+struct BadPixels : PipelineStep<int()> {};
+
+struct Calibration : PipelineStep<int(Dark, Flat, BadPixels)> {};
+
+struct Failure : PipelineStep<int()> {};
+
+struct Dependent : PipelineStep<int(Bias, Failure)> {};
+
+class Calibrator : public StepperPipeline<Calibrator> {
+public:
+
+  template <typename S>
+  int count() const
+  {
+    return m_counts[index<S>()];
+  }
+
+protected:
+
+  template <typename S>
+  void evaluate_impl()
+  {
+    ++m_counts[index<S>()];
+    if constexpr (std::is_same_v<S, Failure>) {
+      throw std::runtime_error("Failure");
+    }
+    m_values[index<S>()] = index<S>();
+  }
+
+  template <typename S>
+  typename S::Value get_impl()
+  {
+    return m_values[index<S>()];
+  }
+
+private:
+
+  template <typename S>
+  static constexpr int index()
+  {
+    using Steps = std::tuple<Bias, Dark, Flat, BadPixels, Calibration, Failure, Dependent>;
+    return index<S, Steps>(std::make_index_sequence<7> {});
+  }
+
+  template <typename S, typename TSteps, std::size_t... Is>
+  static constexpr int index(std::index_sequence<Is...>)
+  {
+    return ((std::is_same_v<S, std::tuple_element_t<Is, TSteps>> ? int(Is) : 0) + ...);
+  }
+
+  std::atomic<int> m_counts[7] = {};
+  int m_values[7] = {};
+};
+
+struct Load : PipelineStep<Raster<float>()> {};
+
+struct Master : PipelineStep<const Raster<float>&(Load)>, CachedStep {
+  static constexpr const char* Name = "Master";
+};
+
+struct Scale : PipelineStep<float(Master)>, CachedStep {
+  static constexpr const char* Name = "Scale";
+};
+
+class Reducer : public StepperPipeline<Reducer> {
+public:
+
+  float offset = 1;
+  float factor = 2;
+  int loads = 0;
+  int masters = 0;
+  int scales = 0;
+
+protected:
+
+  template <typename S>
+  void evaluate_impl();
+
+  template <typename S>
+  typename S::Value get_impl();
+
+  template <typename S>
+  std::uint64_t hash_impl();
+
+  template <typename S>
+  void restore_impl(std::decay_t<typename S::Value> value);
+
+private:
+
+  Raster<float> m_frame;
+  Raster<float> m_master;
+  float m_scale = 0;
+};
+
+template <>
+void Reducer::evaluate_impl<Load>()
+{
+  ++loads;
+  m_frame = Raster<float>({3, 2}).range();
+}
+
+template <>
+void Reducer::evaluate_impl<Master>()
+{
+  ++masters;
+  m_master = m_frame + offset;
+}
+
+template <>
+void Reducer::evaluate_impl<Scale>()
+{
+  ++scales;
+  m_scale = m_master[{2, 1}] * factor;
+}
+
+template <>
+Load::Value Reducer::get_impl<Load>()
+{
+  return m_frame;
+}
+
+template <>
+Master::Value Reducer::get_impl<Master>()
+{
+  return m_master;
+}
+
+template <>
+Scale::Value Reducer::get_impl<Scale>()
+{
+  return m_scale;
+}
+
+template <>
+std::uint64_t Reducer::hash_impl<Master>()
+{
+  return hash_value(offset);
+}
+
+template <>
+std::uint64_t Reducer::hash_impl<Scale>()
+{
+  return hash_value(factor);
+}
+
+template <>
+void Reducer::restore_impl<Master>(Raster<float> value)
+{
+  m_master = std::move(value);
+}
+
+template <>
+void Reducer::restore_impl<Scale>(float value)
+{
+  m_scale = value;
+}
+
+Reducer make_reducer(float factor)
+{
+  Reducer out;
+  out.factor = factor;
+  return out;
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE(StepperPipeline_test)
@@ -185,6 +360,182 @@ BOOST_AUTO_TEST_CASE(all_in_one_test)
   BOOST_TEST(dag.milliseconds<Step2>() > 0);
 }
 
+BOOST_AUTO_TEST_CASE(records_test)
+{
+  Dag dag;
+  dag.get<Step2>();
+  const auto records = dag.records();
+  BOOST_TEST(records.size() == 4);
+  BOOST_TEST(records.front().name == "Step0");
+  BOOST_TEST(records.back().name == "Step2");
+  for (const auto& r : records) {
+    BOOST_TEST(r.thread == 0);
+    BOOST_TEST(r.wall_ms >= 0);
+    BOOST_TEST(r.cpu_ms >= 0);
+    BOOST_TEST(r.peak_rss_delta >= 0);
+  }
+  BOOST_TEST(records[1].start_us >= records[0].start_us);
+  std::stringstream csv;
+  write_csv(csv, records);
+  std::string line;
+  Index count = 0;
+  while (std::getline(csv, line)) {
+    ++count;
+  }
+  BOOST_TEST(count == 5);
+  std::stringstream json;
+  write_json(json, records);
+  BOOST_TEST(json.str().find("\"step\": \"Step1b\"") != std::string::npos);
+  std::stringstream trace;
+  write_trace(trace, records);
+  BOOST_TEST(trace.str().find("\"traceEvents\"") != std::string::npos);
+  BOOST_TEST(trace.str().find("\"ph\": \"X\"") != std::string::npos);
+
+  Dag counted;
+  counted.counters(true);
+  counted.get<Step0>();
+  BOOST_TEST(counted.records().front().counters.available() == PerfCounters().available());
+
+  Reducer reducer;
+  reducer.get<Master>();
+  const auto load = reducer.records().front();
+  BOOST_TEST(load.name == "Load");
+  if (AllocationStats::enabled()) {
+    BOOST_TEST(load.allocations.allocated_bytes >= 6 * sizeof(float));
+  } else {
+    BOOST_TEST(load.allocations.allocated_bytes == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_fan_in_test)
+{
+  for (int i = 0; i < 20; ++i) {
+    Calibrator pipeline;
+    pipeline.threads(Threads(4));
+    BOOST_TEST(pipeline.get<Calibration>() == 4);
+    BOOST_TEST(pipeline.count<Bias>() == 1);
+    BOOST_TEST(pipeline.count<Dark>() == 1);
+    BOOST_TEST(pipeline.count<Flat>() == 1);
+    BOOST_TEST(pipeline.count<BadPixels>() == 1);
+    BOOST_TEST(pipeline.count<Calibration>() == 1);
+    BOOST_TEST(pipeline.get<Dark>() == 1);
+    BOOST_TEST(pipeline.count<Dark>() == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_exception_test)
+{
+  Calibrator pipeline;
+  pipeline.threads(Threads(4));
+  BOOST_CHECK_THROW(pipeline.get<Dependent>(), std::runtime_error);
+  BOOST_TEST(pipeline.count<Bias>() == 1);
+  BOOST_TEST(pipeline.count<Dependent>() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(memory_cache_test)
+{
+  StepCache cache;
+  Reducer first;
+  first.cache(&cache);
+  BOOST_TEST(first.get<Scale>() == 12);
+  BOOST_TEST(first.loads == 1);
+
+  Reducer same;
+  same.cache(&cache);
+  BOOST_TEST(same.get<Scale>() == 12);
+  BOOST_TEST(same.loads == 0); // Upstream steps are skipped
+  BOOST_TEST(same.masters == 0);
+  BOOST_TEST(same.scales == 0);
+
+  Reducer tweaked;
+  tweaked.factor = 3;
+  tweaked.cache(&cache);
+  BOOST_TEST(tweaked.get<Scale>() == 18);
+  BOOST_TEST(tweaked.loads == 0);
+  BOOST_TEST(tweaked.masters == 0); // Restored
+  BOOST_TEST(tweaked.scales == 1);
+
+  Reducer upstream;
+  upstream.offset = 2;
+  upstream.cache(&cache);
+  BOOST_TEST(upstream.get<Scale>() == 14);
+  BOOST_TEST(upstream.masters == 1);
+  BOOST_TEST(cache.hits() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(persistent_cache_test)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "LinxStepCacheTest";
+  std::filesystem::remove_all(directory);
+  {
+    StepCache cache(directory);
+    Reducer first;
+    first.cache(&cache);
+    BOOST_TEST(first.get<Scale>() == 12);
+  }
+  {
+    StepCache cache(directory);
+    Reducer tweaked;
+    tweaked.factor = 4;
+    tweaked.cache(&cache);
+    BOOST_TEST(tweaked.get<Scale>() == 24);
+    BOOST_TEST(tweaked.loads == 0);
+    BOOST_TEST(tweaked.masters == 0); // Read from disk
+    BOOST_TEST(tweaked.get<Master>() == Raster<float>({3, 2}).range() + 1);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move_test)
+{
+  auto pipeline = make_reducer(3);
+  BOOST_TEST(pipeline.get<Master>()[0] == 1);
+  BOOST_TEST(pipeline.masters == 1);
+
+  auto copy = pipeline;
+  BOOST_TEST(copy.evaluated<Master>());
+  BOOST_TEST(copy.get<Scale>() == 18);
+  BOOST_TEST(copy.masters == 1); // Not evaluated again
+  BOOST_TEST(copy.scales == 1);
+  BOOST_TEST(not pipeline.evaluated<Scale>());
+
+  auto moved = std::move(copy);
+  BOOST_TEST(moved.get<Scale>() == 18);
+  BOOST_TEST(moved.scales == 1);
+
+  moved = make_reducer(4); // Flags are reset with the evaluated steps
+  BOOST_TEST(not moved.evaluated<Scale>());
+  BOOST_TEST(moved.get<Scale>() == 24);
+  BOOST_TEST(moved.scales == 1);
+}
+
+BOOST_AUTO_TEST_CASE(cache_key_test)
+{
+  Reducer first;
+  Reducer second;
+  BOOST_TEST(first.cache_key<Scale>() == second.cache_key<Scale>());
+  BOOST_TEST(first.cache_key<Master>() != first.cache_key<Scale>());
+  second.factor = 3;
+  BOOST_TEST(first.cache_key<Master>() == second.cache_key<Master>());
+  BOOST_TEST(first.cache_key<Scale>() != second.cache_key<Scale>());
+}
+
+BOOST_AUTO_TEST_CASE(serializer_errors_test)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "LinxStepSerializerTest";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  const auto path = directory / "value.step";
+  StepSerializer<float>::write(path, 3.F);
+  BOOST_TEST(StepSerializer<float>::read(path) == 3.F);
+  BOOST_CHECK_THROW(StepSerializer<int>::read(path), FileFormatError); // Same size, other type
+  BOOST_CHECK_THROW(StepSerializer<double>::read(path), FileFormatError);
+  std::ofstream(path, std::ios::app) << 'x';
+  BOOST_CHECK_THROW(StepSerializer<float>::read(path), FileFormatError); // Trailing bytes
+  BOOST_CHECK_THROW(StepSerializer<float>::write(directory / "missing" / "value.step", 3.F), FileFormatError);
+  std::filesystem::remove_all(directory);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
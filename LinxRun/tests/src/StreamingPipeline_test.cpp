@@ -0,0 +1,90 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/StreamingPipeline.h"
+
+#include <atomic>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <string>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(StreamingPipeline_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(ordered_stream_test)
+{
+  std::vector<int> inputs(100);
+  for (int i = 0; i < 100; ++i) {
+    inputs[i] = i;
+  }
+  std::vector<std::string> outputs;
+  auto pipeline = streaming_pipeline(3)
+                      .then([](int i) {
+                        return i * 2;
+                      })
+                      .then([](int i) {
+                        return std::to_string(i);
+                      })
+                      .then([&](std::string s) {
+                        outputs.push_back(std::move(s));
+                      });
+  pipeline.run(inputs);
+  BOOST_TEST(outputs.size() == 100);
+  for (int i = 0; i < 100; ++i) {
+    BOOST_TEST(outputs[i] == std::to_string(2 * i));
+  }
+  for (std::size_t s = 0; s < 3; ++s) {
+    BOOST_TEST(pipeline.count(s) == 100);
+    BOOST_TEST(pipeline.milliseconds(s) >= 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(backpressure_test)
+{
+  std::atomic<int> produced(0);
+  std::atomic<int> consumed(0);
+  std::atomic<int> max_pending(0);
+  auto pipeline = streaming_pipeline(2)
+                      .then([&](int i) {
+                        ++produced;
+                        return i;
+                      })
+                      .then([&](int) {
+                        const int pending = produced - consumed;
+                        if (pending > max_pending) {
+                          max_pending = pending;
+                        }
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                        ++consumed;
+                      });
+  pipeline.run(std::vector<int>(50, 0));
+  BOOST_TEST(consumed == 50);
+  BOOST_TEST(max_pending <= 4); // Queue capacity + items in flight
+}
+
+BOOST_AUTO_TEST_CASE(exception_test)
+{
+  int written = 0;
+  auto pipeline = streaming_pipeline(1)
+                      .then([](int i) {
+                        if (i == 5) {
+                          throw std::runtime_error("Corrupted frame");
+                        }
+                        return i;
+                      })
+                      .then([&](int) {
+                        ++written;
+                      });
+  BOOST_CHECK_THROW(pipeline.run(std::vector<int>(1000, 5)), std::runtime_error);
+  BOOST_TEST(written == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,38 +7,54 @@
 
 #include "LinxTransforms/DftPlan.h"
 
+#include <algorithm> // transform
 #include <complex>
+#include <functional> // multiplies
+#include <numeric> // accumulate
+#include <vector>
 
 namespace Linx {
 
 /**
  * @ingroup dft
  * @brief DFT buffer of real data.
+ * @tparam T The real type, `double` or `float`
  */
-template <Index N = 2>
-using RealDftBuffer = AlignedRaster<double, N>;
+template <Index N = 2, typename T = double>
+using RealDftBuffer = AlignedRaster<T, N>;
 
 /**
  * @ingroup dft
  * @brief DFT buffer of complex data.
+ * @tparam T The real type, `double` or `float`
  */
-template <Index N = 2>
-using ComplexDftBuffer = AlignedRaster<std::complex<double>, N>;
+template <Index N = 2, typename T = double>
+using ComplexDftBuffer = AlignedRaster<std::complex<T>, N>;
 
 /// @cond
 namespace Internal {
 
 /**
- * @brief Convert a raster shape into an FFTW shape.
+ * @brief Convert the leading axes of a raster shape into an FFTW shape.
+ * @param rank The number of transformed axes
  */
 template <typename TRaster>
-std::vector<int> fftw_shape(const TRaster& raster)
+std::vector<int> fftw_shape(const TRaster& raster, Index rank)
 {
-  std::vector<int> out(raster.shape().begin(), raster.shape().end());
+  std::vector<int> out(raster.shape().begin(), raster.shape().begin() + rank);
   std::reverse(out.begin(), out.end());
   return out;
 }
 
+/**
+ * @brief Get the number of transforms of `rank` dimensions in a raster.
+ */
+template <typename TRaster>
+int fftw_count(const TRaster& raster, Index rank)
+{
+  return std::accumulate(raster.shape().begin() + rank, raster.shape().end(), 1, std::multiplies<int>());
+}
+
 /**
  * @brief Inverse of a `DftTransformMixin`.
  */
@@ -47,6 +63,11 @@ struct Inverse; // Forward declaration for DftTransformMixin
 
 /**
  * @brief Base DFT transform to be inherited.
+ * 
+ * Concrete transforms implement `allocate_fftw_plan(in, out, flags, rank)`,
+ * which plans the transforms over the `rank` leading axes of the buffers, repeated along the other axes,
+ * and `execute_fftw_plan(plan, in, out)`, which executes a plan on new buffers.
+ * They may shadow `in_shape()` and `out_shape()`.
  */
 template <typename TIn, typename TOut, typename TDerived>
 struct DftTransformMixin {
@@ -70,6 +91,11 @@ struct DftTransformMixin {
    */
   using OutValue = TOut;
 
+  /**
+   * @brief The real type, which selects the FFTW precision.
+   */
+  using Real = typename TypeTraits<TIn>::Scalar;
+
   /**
    * @brief The tag of the inverse transform type.
    */
@@ -94,12 +120,15 @@ struct DftTransformMixin {
   {
     return shape;
   }
-
   /**
-   * @brief Allocate an FFTW plan.
+   * @brief Normalization factor of the inverse transform.
+   * @param shape The logical shape
    */
   template <Index N>
-  static FftwPlanPtr allocate_fftw_plan(AlignedRaster<TIn, N>& in, AlignedRaster<TOut, N>& out);
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return shape_size(shape);
+  }
 };
 
 /**
@@ -111,22 +140,26 @@ struct DftTransformMixin<TIn, TOut, Inverse<TTransform>> {
   using Transform = Inverse<TTransform>;
   using InValue = TOut;
   using OutValue = TIn;
+  using Real = typename TypeTraits<TIn>::Scalar;
   using InverseTransform = TTransform;
 
   template <Index N>
   static Position<N> in_shape(const Position<N>& shape)
   {
-    return DftTransformMixin<TIn, TOut, TTransform>::out_shape(shape);
+    return TTransform::out_shape(shape);
   }
 
   template <Index N>
   static Position<N> out_shape(const Position<N>& shape)
   {
-    return DftTransformMixin<TIn, TOut, TTransform>::in_shape(shape);
+    return TTransform::in_shape(shape);
   }
 
   template <Index N>
-  static FftwPlanPtr allocate_fftw_plan(AlignedRaster<TOut, N>& in, AlignedRaster<TIn, N>& out);
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return shape_size(shape);
+  }
 };
 
 template <typename TTransform>
@@ -134,104 +167,359 @@ struct Inverse : DftTransformMixin<typename TTransform::InValue, typename TTrans
 
 /**
  * @brief Real DFT type.
+ * @tparam T The real type
  */
-struct RealDftTransform;
-struct RealDftTransform : DftTransformMixin<double, std::complex<double>, RealDftTransform> {};
+template <typename T = double>
+struct RealDftTransform : DftTransformMixin<T, std::complex<T>, RealDftTransform<T>> {
+  template <Index N>
+  static Position<N> out_shape(const Position<N>& shape)
+  {
+    auto out = shape;
+    out[0] = out[0] / 2 + 1;
+    return out;
+  }
 
-template <>
-template <Index N>
-Position<N> RealDftTransform::Base::out_shape(const Position<N>& shape)
-{
-  auto out = shape;
-  out[0] = out[0] / 2 + 1;
-  return out;
-}
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      RealDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags,
+      Index rank = N)
+  {
+    using Fftw = FftwTraits<T>;
+    auto shape = fftw_shape(in, rank);
+    const auto count = fftw_count(in, rank);
+    return std::make_unique<typename Fftw::Plan>(Fftw::plan_r2c(
+        shape.size(),
+        shape.data(),
+        count,
+        reinterpret_cast<T*>(in.data()),
+        in.size() / count,
+        reinterpret_cast<typename Fftw::Complex*>(out.data()),
+        out.size() / count,
+        flags));
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr RealDftTransform::Base::allocate_fftw_plan(RealDftBuffer<N>& in, ComplexDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(in);
-  return std::make_unique<fftw_plan>(fftw_plan_dft_r2c(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<double*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_MEASURE));
-}
+  static void execute_fftw_plan(typename FftwTraits<T>::Plan plan, T* in, std::complex<T>* out)
+  {
+    FftwTraits<T>::execute_r2c(plan, in, reinterpret_cast<typename FftwTraits<T>::Complex*>(out));
+  }
+};
 
-template <>
-template <Index N>
-FftwPlanPtr Inverse<RealDftTransform>::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, RealDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(out);
-  return std::make_unique<fftw_plan>(fftw_plan_dft_c2r(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<double*>(out.data()),
-      FFTW_MEASURE));
-}
+/**
+ * @brief Inverse real DFT type.
+ */
+template <typename T>
+struct Inverse<RealDftTransform<T>> : DftTransformMixin<T, std::complex<T>, Inverse<RealDftTransform<T>>> {
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      RealDftBuffer<N, T>& out,
+      unsigned flags,
+      Index rank = N)
+  {
+    using Fftw = FftwTraits<T>;
+    auto shape = fftw_shape(out, rank);
+    const auto count = fftw_count(out, rank);
+    return std::make_unique<typename Fftw::Plan>(Fftw::plan_c2r(
+        shape.size(),
+        shape.data(),
+        count,
+        reinterpret_cast<typename Fftw::Complex*>(in.data()),
+        in.size() / count,
+        reinterpret_cast<T*>(out.data()),
+        out.size() / count,
+        flags));
+  }
+
+  static void execute_fftw_plan(typename FftwTraits<T>::Plan plan, std::complex<T>* in, T* out)
+  {
+    FftwTraits<T>::execute_c2r(plan, reinterpret_cast<typename FftwTraits<T>::Complex*>(in), out);
+  }
+};
 
 /**
  * @brief Complex DFT type.
+ * @tparam T The real type
  */
-struct ComplexDftTransform;
-struct ComplexDftTransform : DftTransformMixin<std::complex<double>, std::complex<double>, ComplexDftTransform> {};
+template <typename T = double>
+struct ComplexDftTransform : DftTransformMixin<std::complex<T>, std::complex<T>, ComplexDftTransform<T>> {
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags,
+      Index rank = N)
+  {
+    using Fftw = FftwTraits<T>;
+    auto shape = fftw_shape(in, rank);
+    const auto count = fftw_count(in, rank);
+    return std::make_unique<typename Fftw::Plan>(Fftw::plan_c2c(
+        shape.size(),
+        shape.data(),
+        count,
+        reinterpret_cast<typename Fftw::Complex*>(in.data()),
+        in.size() / count,
+        reinterpret_cast<typename Fftw::Complex*>(out.data()),
+        out.size() / count,
+        FFTW_FORWARD,
+        flags));
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr ComplexDftTransform::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, ComplexDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(in);
-  return std::make_unique<fftw_plan>(fftw_plan_dft(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_FORWARD,
-      FFTW_MEASURE));
-}
+  static void execute_fftw_plan(typename FftwTraits<T>::Plan plan, std::complex<T>* in, std::complex<T>* out)
+  {
+    using Complex = typename FftwTraits<T>::Complex;
+    FftwTraits<T>::execute_c2c(plan, reinterpret_cast<Complex*>(in), reinterpret_cast<Complex*>(out));
+  }
+};
+
+/**
+ * @brief Inverse complex DFT type.
+ */
+template <typename T>
+struct Inverse<ComplexDftTransform<T>> :
+    DftTransformMixin<std::complex<T>, std::complex<T>, Inverse<ComplexDftTransform<T>>> {
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags,
+      Index rank = N)
+  {
+    using Fftw = FftwTraits<T>;
+    auto shape = fftw_shape(out, rank);
+    const auto count = fftw_count(out, rank);
+    return std::make_unique<typename Fftw::Plan>(Fftw::plan_c2c(
+        shape.size(),
+        shape.data(),
+        count,
+        reinterpret_cast<typename Fftw::Complex*>(in.data()),
+        in.size() / count,
+        reinterpret_cast<typename Fftw::Complex*>(out.data()),
+        out.size() / count,
+        FFTW_BACKWARD,
+        flags));
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr Inverse<ComplexDftTransform>::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, ComplexDftBuffer<N>& out)
+  static void execute_fftw_plan(typename FftwTraits<T>::Plan plan, std::complex<T>* in, std::complex<T>* out)
+  {
+    using Complex = typename FftwTraits<T>::Complex;
+    FftwTraits<T>::execute_c2c(plan, reinterpret_cast<Complex*>(in), reinterpret_cast<Complex*>(out));
+  }
+};
+
+/**
+ * @brief Get the kind of the inverse of a real-to-real transform.
+ */
+constexpr fftw_r2r_kind inverse_r2r_kind(fftw_r2r_kind kind)
 {
-  auto shape = fftw_shape(out);
-  return std::make_unique<fftw_plan>(fftw_plan_dft(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_BACKWARD,
-      FFTW_MEASURE));
+  switch (kind) {
+    case FFTW_REDFT10:
+      return FFTW_REDFT01;
+    case FFTW_REDFT01:
+      return FFTW_REDFT10;
+    case FFTW_RODFT10:
+      return FFTW_RODFT01;
+    case FFTW_RODFT01:
+      return FFTW_RODFT10;
+    default:
+      return kind; // REDFT00, REDFT11, RODFT00, RODFT11 are their own inverses
+  }
 }
 
+/**
+ * @brief Real-to-real transform type, i.e. discrete cosine or sine transform.
+ * @tparam Kind The FFTW kind, e.g. `FFTW_REDFT10` for the DCT-II, applied along every axis
+ * @tparam T The real type
+ */
+template <fftw_r2r_kind Kind, typename T = double>
+struct RealToRealTransform : DftTransformMixin<T, T, RealToRealTransform<Kind, T>> {
+  using InverseTransform = RealToRealTransform<inverse_r2r_kind(Kind), T>;
+
+  /**
+   * @brief Normalization factor, i.e. the product of the logical lengths of the equivalent DFT.
+   */
+  template <Index N>
+  static double normalization_factor(const Position<N>& shape)
+  {
+    double factor = 1;
+    for (auto n : shape) {
+      factor *= Kind == FFTW_REDFT00 ? 2 * (n - 1) : Kind == FFTW_RODFT00 ? 2 * (n + 1) : 2 * n;
+    }
+    return factor;
+  }
+
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      RealDftBuffer<N, T>& in,
+      RealDftBuffer<N, T>& out,
+      unsigned flags,
+      Index rank = N)
+  {
+    using Fftw = FftwTraits<T>;
+    auto shape = fftw_shape(in, rank);
+    const auto count = fftw_count(in, rank);
+    const std::vector<fftw_r2r_kind> kinds(rank, Kind);
+    return std::make_unique<typename Fftw::Plan>(Fftw::plan_r2r(
+        shape.size(),
+        shape.data(),
+        count,
+        in.data(),
+        in.size() / count,
+        out.data(),
+        out.size() / count,
+        kinds.data(),
+        flags));
+  }
+
+  static void execute_fftw_plan(typename FftwTraits<T>::Plan plan, T* in, T* out)
+  {
+    FftwTraits<T>::execute_r2r(plan, in, out);
+  }
+};
+
+/**
+ * @brief Batch of transforms along the last axis.
+ * @tparam TTransform The transform of each element of the batch
+ * 
+ * Buffers are stacks of one more dimension than the transform,
+ * and a single FFTW plan computes the transforms of all the elements of the stack.
+ */
+template <typename TTransform>
+struct Batch {
+  using Transform = Batch;
+  using InValue = typename TTransform::InValue;
+  using OutValue = typename TTransform::OutValue;
+  using Real = typename TTransform::Real;
+  using InverseTransform = Batch<typename TTransform::InverseTransform>;
+
+  template <Index N>
+  static Position<N> in_shape(const Position<N>& shape)
+  {
+    auto out = extend<N>(TTransform::in_shape(slice<N - 1>(shape)));
+    out[N - 1] = shape[N - 1];
+    return out;
+  }
+
+  template <Index N>
+  static Position<N> out_shape(const Position<N>& shape)
+  {
+    auto out = extend<N>(TTransform::out_shape(slice<N - 1>(shape)));
+    out[N - 1] = shape[N - 1];
+    return out;
+  }
+
+  template <Index N>
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return TTransform::normalization_factor(slice<N - 1>(shape));
+  }
+
+  template <Index N>
+  static FftwPlanPtr<Real>
+  allocate_fftw_plan(AlignedRaster<InValue, N>& in, AlignedRaster<OutValue, N>& out, unsigned flags)
+  {
+    return TTransform::allocate_fftw_plan(in, out, flags, N - 1);
+  }
+
+  static void execute_fftw_plan(typename FftwTraits<Real>::Plan plan, InValue* in, OutValue* out)
+  {
+    TTransform::execute_fftw_plan(plan, in, out);
+  }
+};
+
 } // namespace Internal
 /// @endcond
 
 /**
  * @ingroup dft
  * @brief Real DFT plan.
+ * @tparam T The real type, `double` or `float`
+ * 
+ * Single precision plans rely on `fftwf_*` functions,
+ * such that `float` data is transformed without conversion, with half the memory footprint.
  */
-template <Index N = 2>
-using RealDft = DftPlan<Internal::RealDftTransform, N>;
+template <Index N = 2, typename T = double>
+using RealDft = DftPlan<Internal::RealDftTransform<T>, N>;
 
 /**
  * @ingroup dft
  * @brief Complex DFT plan.
+ * @tparam T The real type, `double` or `float`
+ */
+template <Index N = 2, typename T = double>
+using ComplexDft = DftPlan<Internal::ComplexDftTransform<T>, N>;
+
+/**
+ * @ingroup dft
+ * @brief Real-to-real DFT plan, i.e. discrete cosine or sine transform plan.
+ * @tparam Kind The FFTW kind, e.g. `FFTW_REDFT10` for the DCT-II or `FFTW_RODFT00` for the DST-I
+ * @tparam T The real type, `double` or `float`
+ * 
+ * Real-to-real transforms are computed directly, which is about four times faster
+ * than computing the complex DFT of the symmetrically padded data.
+ * The inverse plan has the inverse kind (e.g. `FFTW_REDFT01` for `FFTW_REDFT10`),
+ * and the normalization factor is the logical size of the equivalent DFT,
+ * e.g. `2 * n` per axis of length `n` for the DCT-II, or `2 * (n + 1)` for the DST-I.
+ */
+template <fftw_r2r_kind Kind, Index N = 2, typename T = double>
+using RealToRealDft = DftPlan<Internal::RealToRealTransform<Kind, T>, N>;
+
+/**
+ * @ingroup dft
+ * @brief DCT-II plan, whose inverse is the DCT-III.
+ */
+template <Index N = 2, typename T = double>
+using Dct = RealToRealDft<FFTW_REDFT10, N, T>;
+
+/**
+ * @ingroup dft
+ * @brief DST-II plan, whose inverse is the DST-III.
+ */
+template <Index N = 2, typename T = double>
+using Dst = RealToRealDft<FFTW_RODFT10, N, T>;
+
+/**
+ * @ingroup dft
+ * @brief Batched real DFT plan.
+ * @tparam N The dimension of each transform
+ * @tparam T The real type, `double` or `float`
+ * 
+ * The plan computes the real DFTs of a stack of `N`-dimensional rasters, stacked along axis `N`,
+ * in a single FFTW execution, which is much faster than looping over many small plans.
+ * The logical shape is that of the stack, and the normalization factor is the size of one element:
+ * 
+ * \code
+ * RealDftBatch<2> dft({32, 32, 1000}); // 1000 stamps of 32x32 pixels
+ * auto idft = dft.inverse();
+ * dft.in() = ... ; // Fill the stack, e.g. with std::copy(stamp.begin(), stamp.end(), dft.in().section(i).begin())
+ * dft.transform(); // dft.out().section(i) is the DFT of stamp i
+ * idft.transform().normalize();
+ * \endcode
+ */
+template <Index N = 2, typename T = double>
+using RealDftBatch = DftPlan<Internal::Batch<Internal::RealDftTransform<T>>, N + 1>;
+
+/**
+ * @ingroup dft
+ * @brief Batched complex DFT plan.
+ * @tparam N The dimension of each transform
+ * @tparam T The real type, `double` or `float`
+ * 
+ * @see `RealDftBatch`
  */
-template <Index N = 2>
-using ComplexDft = DftPlan<Internal::ComplexDftTransform, N>;
+template <Index N = 2, typename T = double>
+using ComplexDftBatch = DftPlan<Internal::Batch<Internal::ComplexDftTransform<T>>, N + 1>;
 
 /**
  * @relatesalso DftPlan
  * @brief Compute the complex DFT.
+ * @tparam T The real type of the transform
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> complex_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> complex_dft(const TRaster& in)
 {
-  ComplexDft<TRaster::Dimension> plan(in.shape());
+  ComplexDft<TRaster::Dimension, T> plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform();
   return std::move(plan.out());
@@ -241,10 +529,10 @@ ComplexDftBuffer<TRaster::Dimension> complex_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the inverse complex DFT.
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> inverse_complex_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> inverse_complex_dft(const TRaster& in)
 {
-  typename ComplexDft<TRaster::Dimension>::Inverse plan(in.shape());
+  typename ComplexDft<TRaster::Dimension, T>::Inverse plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform().normalize();
   return std::move(plan.out());
@@ -254,10 +542,10 @@ ComplexDftBuffer<TRaster::Dimension> inverse_complex_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the real DFT.
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> real_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> real_dft(const TRaster& in)
 {
-  RealDft<TRaster::Dimension> plan(in.shape());
+  RealDft<TRaster::Dimension, T> plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform();
   return std::move(plan.out());
@@ -267,15 +555,75 @@ ComplexDftBuffer<TRaster::Dimension> real_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the inverse real DFT.
  */
-template <typename TRaster>
-RealDftBuffer<TRaster::Dimension> inverse_real_dft(const TRaster& in, const Position<TRaster::Dimension>& shape)
+template <typename T = double, typename TRaster>
+RealDftBuffer<TRaster::Dimension, T> inverse_real_dft(const TRaster& in, const Position<TRaster::Dimension>& shape)
 {
-  typename RealDft<TRaster::Dimension>::Inverse plan(shape);
+  typename RealDft<TRaster::Dimension, T>::Inverse plan(shape);
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform().normalize();
   return std::move(plan.out());
 }
 
+/**
+ * @relatesalso DftPlan
+ * @brief Compute the inverse complex DFT over some region of an upsampled grid.
+ * @param in The complex DFT coefficients
+ * @param region The output region, in upsampled pixels
+ * @param factor The upsampling factor
+ * 
+ * Position `p` of the output corresponds to position `(region.front() + p) / factor` of the input grid.
+ * The output is the same as the normalized inverse DFT of `in` zero-padded around the central frequencies
+ * to `factor` times its shape, and cropped to `region`.
+ * Yet, instead of transforming the whole padded grid, the transform is computed as matrix products along each axis,
+ * such that the cost is proportional to the region size and does not depend on `factor`.
+ * 
+ * This is typically used to locate cross-correlation peaks with sub-pixel accuracy:
+ * the peak is first located on the DFT grid, and then refined in a small neighborhood at high upsampling factor.
+ */
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T>
+upsampled_inverse_dft(const TRaster& in, const Box<TRaster::Dimension>& region, double factor)
+{
+  auto shape = in.shape();
+  std::vector<std::complex<T>> current(in.begin(), in.end());
+  std::vector<std::complex<T>> next;
+  for (Index axis = 0; axis < shape.size(); ++axis) {
+    const auto n = shape[axis];
+    const auto m = region.length(axis);
+    const auto front = region.front()[axis];
+    std::vector<std::complex<T>> kernel(m * n);
+    for (Index j = 0; j < m; ++j) {
+      for (Index k = 0; k < n; ++k) {
+        const auto frequency = k <= (n - 1) / 2 ? k : k - n;
+        kernel[j * n + k] = std::polar(T(1), T(2 * pi<double>() * frequency * (front + j) / (factor * n)));
+      }
+    }
+    const auto stride = shape_stride(shape, axis);
+    const auto outer_count = shape_size(shape) / (n * stride);
+    next.assign(outer_count * m * stride, std::complex<T>());
+    for (Index o = 0; o < outer_count; ++o) {
+      for (Index j = 0; j < m; ++j) {
+        auto* dst = next.data() + (o * m + j) * stride;
+        for (Index k = 0; k < n; ++k) {
+          const auto w = kernel[j * n + k];
+          const auto* src = current.data() + (o * n + k) * stride;
+          for (Index x = 0; x < stride; ++x) {
+            dst[x] += w * src[x];
+          }
+        }
+      }
+    }
+    shape[axis] = m;
+    std::swap(current, next);
+  }
+  ComplexDftBuffer<TRaster::Dimension, T> out(shape);
+  const T normalization = 1. / shape_size(in.shape());
+  std::transform(current.begin(), current.end(), out.begin(), [&](const auto& e) {
+    return e * normalization;
+  });
+  return out;
+}
+
 } // namespace Linx
 
 #endif
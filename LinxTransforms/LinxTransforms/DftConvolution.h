@@ -0,0 +1,394 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_DFTCONVOLUTION_H
+#define _LINXTRANSFORMS_DFTCONVOLUTION_H
+
+#include "Linx/Base/Trace.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm> // copy, max, min
+#include <limits>
+#include <memory> // shared_ptr
+#include <mutex>
+#include <type_traits> // decay_t
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief Convolution kernel whose spectrum is prepared for some block shape.
+ * @tparam N The dimension
+ * 
+ * The kernel spectrum, and the pair of `RealDft` plans, are computed once at construction,
+ * such that convolving a raster only costs one forward and one inverse transform per block.
+ * This is typically used to convolve many frames with the same PSF:
+ * 
+ * \code
+ * const DftKernel<2> kernel(psf.shape(), psf, frame_shape);
+ * for (const auto& frame : frames) {
+ *   Raster<float> out(frame_shape - psf.shape() + 1);
+ *   kernel.apply(frame, out);
+ * }
+ * \endcode
+ * 
+ * Inputs larger than the block shape are convolved by blocks with the overlap-save method.
+ * As plans are executed on temporary buffers, `apply()` can be called concurrently.
+ */
+template <Index N = 2>
+class DftKernel {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param kernel_shape The kernel shape
+   * @param values The kernel values
+   * @param block_shape The block shape, which must be at least the kernel shape
+   * @param flags The planner flags
+   * 
+   * An `OutOfBoundsError` is thrown if the block shape is smaller than the kernel shape along some axis.
+   */
+  template <typename TRange>
+  DftKernel(
+      const Position<N>& kernel_shape,
+      const TRange& values,
+      const Position<N>& block_shape,
+      unsigned flags = FftwAllocator::flags()) :
+      m_kernel_shape(kernel_shape), m_flags(flags),
+      m_dft(checked_block_shape(kernel_shape, block_shape), nullptr, nullptr, flags), m_idft(m_dft.inverse()),
+      m_spectrum()
+  {
+    m_dft.in().fill(0);
+    auto vit = values.begin();
+    for (const auto& p : Box<N>::from_shape(kernel_shape)) {
+      m_dft.in()[p] = *vit;
+      ++vit;
+    }
+    m_dft.transform();
+    const auto factor = 1. / m_dft.normalization_factor();
+    m_spectrum.reserve(m_dft.out().size());
+    for (const auto& e : m_dft.out()) {
+      m_spectrum.push_back(e * factor);
+    }
+  }
+
+  /**
+   * @brief Get the kernel shape.
+   */
+  const Position<N>& kernel_shape() const
+  {
+    return m_kernel_shape;
+  }
+
+  /**
+   * @brief Get the block shape.
+   */
+  const Position<N>& block_shape() const
+  {
+    return m_dft.logical_shape();
+  }
+
+  /**
+   * @brief Get the planner flags.
+   */
+  unsigned flags() const
+  {
+    return m_flags;
+  }
+
+  /**
+   * @brief Convolve and crop a raster.
+   * @param in The input raster
+   * @param out The output raster, of shape `in.shape() - kernel_shape() + 1`
+   */
+  template <typename TIn, typename TOut>
+  void apply(const TIn& in, TOut& out) const
+  {
+    LINX_TRACE_SCOPE("DftKernel::apply");
+    const auto& block_shape = this->block_shape();
+    const auto& in_shape = in.shape();
+    auto out_shape = in_shape;
+    auto step = in_shape;
+    auto counts = in_shape;
+    for (Index i = 0; i < N; ++i) {
+      out_shape[i] = in_shape[i] - m_kernel_shape[i] + 1;
+      if (out_shape[i] <= 0) {
+        return;
+      }
+      step[i] = block_shape[i] - m_kernel_shape[i] + 1;
+      counts[i] = (out_shape[i] + step[i] - 1) / step[i];
+    }
+
+    // Overlap-save
+    using T = std::decay_t<decltype(*out.begin())>;
+    RealDftBuffer<N> block(block_shape);
+    ComplexDftBuffer<N> coefficients(m_dft.out_shape());
+    Raster<T, N> result(out_shape);
+    const auto in_box = in.domain();
+    for (const auto& c : Box<N>::from_shape(counts)) {
+      auto front = c;
+      auto back = c;
+      for (Index i = 0; i < N; ++i) {
+        front[i] *= step[i];
+        back[i] = std::min(front[i] + step[i], out_shape[i]) - 1;
+      }
+      for (const auto& p : block.domain()) {
+        const auto q = front + p;
+        block[p] = in_box.contains(q) ? double(in[q]) : 0.;
+      }
+      m_dft.transform(block, coefficients);
+      for (std::size_t i = 0; i < m_spectrum.size(); ++i) {
+        coefficients[i] *= m_spectrum[i];
+      }
+      m_idft.transform(coefficients, block);
+      for (const auto& p : Box<N>(front, back)) {
+        result[p] = static_cast<T>(block[p - front + m_kernel_shape - 1]);
+      }
+    }
+    std::copy(result.begin(), result.end(), out.begin());
+  }
+
+  /**
+   * @brief Convolve and crop a raster which is streamed by chunks along the last axis.
+   * @param in_shape The input shape
+   * @param read The chunk reader, called as `read(front, back)`, which returns the sections from `front` to `back`
+   * @param write The chunk writer, called as `write(front, chunk)`, where `chunk` is an output chunk
+   * 
+   * Input chunks overlap by the kernel length minus one along the last axis,
+   * such that the output chunks are independent and of the block length (at most) along the last axis.
+   * Memory is therefore bounded by the size of one chunk instead of that of the input, e.g. for large mosaics:
+   * 
+   * \code
+   * Fits in("mosaic.fits");
+   * Fits out("filtered.fits");
+   * const auto shape = in.read_shape<2>();
+   * const DftKernel<2> kernel(psf.shape(), psf, {512, 512});
+   * out.write_shape<float>(shape - psf.shape() + 1);
+   * kernel.apply_by_chunks(
+   *     shape,
+   *     [&](auto front, auto back) {
+   *       return in.read_chunk<Raster<float>>(front, back);
+   *     },
+   *     [&](auto front, const auto& chunk) {
+   *       out.write_chunk(chunk, front);
+   *     });
+   * \endcode
+   */
+  template <typename TRead, typename TWrite>
+  void apply_by_chunks(const Position<N>& in_shape, TRead&& read, TWrite&& write) const
+  {
+    const auto margin = m_kernel_shape[N - 1] - 1;
+    const auto out_length = in_shape[N - 1] - margin;
+    const auto step = block_shape()[N - 1] - margin;
+    for (Index front = 0; front < out_length; front += step) {
+      const auto back = std::min(front + step, out_length) - 1;
+      const auto chunk = read(front, back + margin);
+      Raster<typename std::decay_t<decltype(chunk)>::Value, N> out(chunk.shape() - m_kernel_shape + 1);
+      apply(chunk, out);
+      write(front, out);
+    }
+  }
+
+private:
+
+  /**
+   * @brief Check that the block shape is at least the kernel shape, such that blocks progress.
+   */
+  static const Position<N>& checked_block_shape(const Position<N>& kernel_shape, const Position<N>& block_shape)
+  {
+    for (Index i = 0; i < N; ++i) {
+      OutOfBoundsError::may_throw(
+          "block_shape[" + std::to_string(i) + "]",
+          block_shape[i],
+          {kernel_shape[i], std::numeric_limits<Index>::max()});
+    }
+    return block_shape;
+  }
+
+  /**
+   * @brief The kernel shape.
+   */
+  Position<N> m_kernel_shape;
+
+  /**
+   * @brief The planner flags.
+   */
+  unsigned m_flags;
+
+  /**
+   * @brief The direct plan.
+   */
+  RealDft<N> m_dft;
+
+  /**
+   * @brief The inverse plan.
+   */
+  typename RealDft<N>::Inverse m_idft;
+
+  /**
+   * @brief The normalized kernel spectrum.
+   */
+  std::vector<std::complex<double>> m_spectrum;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Convolution kernel which filters whole rasters in Fourier domain.
+ * @tparam T The value type, which must be real
+ * @tparam N The dimension
+ * 
+ * The kernel behaves like `Convolution<T, Box<N>>`, and is generally used through a `SimpleFilter`
+ * (see `dft_convolution()`), such that extrapolation and cropping semantics are the same.
+ * The difference lies in the filtering of raster and extrapolated inputs:
+ * if the window size is larger than some threshold, the input is convolved by blocks in Fourier domain,
+ * using the overlap-save method.
+ * Otherwise, it is convolved in direct space, like `Convolution`.
+ * 
+ * Each block is padded to a fixed shape, and the corresponding `DftKernel` is prepared once,
+ * and cached by block shape and planner flags.
+ * Filtering many rasters of the same shape, e.g. frames with the same PSF,
+ * therefore only costs one forward and one inverse transform per block.
+ * The cache is shared by copies of the kernel.
+ */
+template <typename T, Index N = 2>
+class DftConvolution : public Convolution<T, Box<N>> {
+public:
+
+  /**
+   * @brief The direct convolution type.
+   */
+  using Direct = Convolution<T, Box<N>>;
+
+  /**
+   * @brief Constructor.
+   * @param window The window
+   * @param values The kernel values
+   * @param block_length The minimum block length along each axis
+   * @param direct_size The maximum window size for which the convolution is computed in direct space
+   */
+  template <typename TRange>
+  DftConvolution(Box<N> window, TRange&& values, Index block_length = 256, Index direct_size = 15 * 15) :
+      Direct(LINX_MOVE(window), LINX_FORWARD(values)), m_block_length(block_length), m_direct_size(direct_size),
+      m_cache(std::make_shared<Cache>())
+  {}
+
+  /**
+   * @brief Check whether rasters are filtered in Fourier domain.
+   */
+  bool uses_dft() const
+  {
+    return this->window().size() > m_direct_size;
+  }
+
+  /**
+   * @brief Get the kernel prepared for some input shape.
+   * 
+   * The kernel is computed on first call for a given block shape and the current default planner flags,
+   * and retrieved from the cache afterwards.
+   * This function is thread-safe.
+   */
+  std::shared_ptr<const DftKernel<N>> prepare(const Position<N>& in_shape) const
+  {
+    const auto& kernel_shape = this->window().shape();
+    auto block_shape = in_shape;
+    for (Index i = 0; i < N; ++i) {
+      block_shape[i] = std::min(in_shape[i], std::max(m_block_length, 2 * kernel_shape[i]));
+    }
+    const auto flags = FftwAllocator::flags();
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    for (const auto& kernel : m_cache->kernels) {
+      if (kernel->block_shape() == block_shape && kernel->flags() == flags) {
+        return kernel;
+      }
+    }
+    m_cache->kernels.push_back(std::make_shared<const DftKernel<N>>(kernel_shape, this->values(), block_shape, flags));
+    return m_cache->kernels.back();
+  }
+
+  /**
+   * @brief Filter and crop a raster.
+   */
+  template <typename U, typename UHolder, typename TOut>
+  void transform(const Raster<U, N, UHolder>& in, TOut& out) const
+  {
+    if (not uses_dft()) {
+      Direct::transform(in, out);
+      return;
+    }
+    for (Index i = 0; i < N; ++i) {
+      if (in.shape()[i] < this->window().length(i)) {
+        return;
+      }
+    }
+    prepare(in.shape())->apply(in, out);
+  }
+
+private:
+
+  /**
+   * @brief The prepared kernels, by block shape and planner flags.
+   */
+  struct Cache {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<const DftKernel<N>>> kernels;
+  };
+
+  /**
+   * @brief The minimum block length.
+   */
+  Index m_block_length;
+
+  /**
+   * @brief The maximum window size for direct convolution.
+   */
+  Index m_direct_size;
+
+  /**
+   * @brief The cache of prepared kernels.
+   */
+  std::shared_ptr<Cache> m_cache;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Make a convolution filter which switches to Fourier domain for large kernels.
+ * @param values The kernel values
+ * @param origin The position of the origin in the kernel
+ * @param block_length The minimum block length along each axis
+ * @param direct_size The maximum kernel size for which the convolution is computed in direct space
+ * 
+ * The filter is a drop-in replacement of `convolution()`:
+ * for small kernels, it is equivalent; for large kernels, raster and extrapolated inputs are filtered by DFT.
+ */
+template <typename T, Index N, typename THolder>
+auto dft_convolution(
+    const Raster<T, N, THolder>& values,
+    Position<N> origin,
+    Index block_length = 256,
+    Index direct_size = 15 * 15)
+{
+  return SimpleFilter<DftConvolution<T, N>>(
+      values.domain() - origin,
+      std::vector<T>(values.begin(), values.end()),
+      block_length,
+      direct_size);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a convolution filter which switches to Fourier domain for large kernels, centered on the kernel.
+ * 
+ * In case of even lengths, origin position is rounded down.
+ */
+template <typename T, Index N, typename THolder>
+auto dft_convolution(const Raster<T, N, THolder>& values)
+{
+  return dft_convolution(values, (values.shape() - 1) / 2);
+}
+
+} // namespace Linx
+
+#endif
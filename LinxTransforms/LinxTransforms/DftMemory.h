@@ -5,9 +5,16 @@
 #ifndef _LINXTRANSFORMS_DFTMEMORY_H
 #define _LINXTRANSFORMS_DFTMEMORY_H
 
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Threads.h"
+
+#include <atomic>
 #include <complex>
 #include <fftw3.h>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits> // is_same_v
 
 namespace Linx {
 
@@ -15,11 +22,306 @@ namespace Linx {
 namespace Internal {
 
 /**
- * @brief RAII wrapper for `fftw_plan`.
+ * @brief FFTW API of some precision.
+ * @tparam T The real type, `double` (`fftw_*` functions) or `float` (`fftwf_*` functions)
  * 
- * `FftwPlan::get()` returns an `fftw_plan`.
+ * Plans are created with the advanced interface (`fftw_plan_many_*`),
+ * such that `count` contiguous transforms of `rank` dimensions are computed at once,
+ * with distances `in_dist` and `out_dist` between the first elements of successive inputs and outputs.
+ * The `execute_*()` functions run a plan on new buffers, which must have the same `alignment_of()` as the plan's.
+ */
+template <typename T>
+struct FftwTraits;
+
+/**
+ * @brief Double precision FFTW API.
+ */
+template <>
+struct FftwTraits<double> {
+  using Plan = fftw_plan;
+  using Complex = fftw_complex;
+
+  static Plan plan_r2c(
+      int rank,
+      const int* shape,
+      int count,
+      double* in,
+      int in_dist,
+      Complex* out,
+      int out_dist,
+      unsigned flags)
+  {
+    return fftw_plan_many_dft_r2c(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, flags);
+  }
+
+  static Plan plan_c2r(
+      int rank,
+      const int* shape,
+      int count,
+      Complex* in,
+      int in_dist,
+      double* out,
+      int out_dist,
+      unsigned flags)
+  {
+    return fftw_plan_many_dft_c2r(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, flags);
+  }
+
+  static Plan plan_c2c(
+      int rank,
+      const int* shape,
+      int count,
+      Complex* in,
+      int in_dist,
+      Complex* out,
+      int out_dist,
+      int sign,
+      unsigned flags)
+  {
+    return fftw_plan_many_dft(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, sign, flags);
+  }
+
+  static Plan plan_r2r(
+      int rank,
+      const int* shape,
+      int count,
+      double* in,
+      int in_dist,
+      double* out,
+      int out_dist,
+      const fftw_r2r_kind* kinds,
+      unsigned flags)
+  {
+    return fftw_plan_many_r2r(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, kinds, flags);
+  }
+
+  static void execute(const Plan plan)
+  {
+    fftw_execute(plan);
+  }
+
+  static void execute_r2r(const Plan plan, double* in, double* out)
+  {
+    fftw_execute_r2r(plan, in, out);
+  }
+
+  static void execute_r2c(const Plan plan, double* in, Complex* out)
+  {
+    fftw_execute_dft_r2c(plan, in, out);
+  }
+
+  static void execute_c2r(const Plan plan, Complex* in, double* out)
+  {
+    fftw_execute_dft_c2r(plan, in, out);
+  }
+
+  static void execute_c2c(const Plan plan, Complex* in, Complex* out)
+  {
+    fftw_execute_dft(plan, in, out);
+  }
+
+  static int alignment_of(const void* data)
+  {
+    return fftw_alignment_of(static_cast<double*>(const_cast<void*>(data)));
+  }
+
+  static void init_threads()
+  {
+    fftw_init_threads();
+  }
+
+  static void plan_with_nthreads(int count)
+  {
+    fftw_plan_with_nthreads(count);
+  }
+
+  static bool import_wisdom(const char* filename)
+  {
+    return fftw_import_wisdom_from_filename(filename);
+  }
+
+  static bool export_wisdom(const char* filename)
+  {
+    return fftw_export_wisdom_to_filename(filename);
+  }
+
+  static void forget_wisdom()
+  {
+    fftw_forget_wisdom();
+  }
+
+  static void cleanup()
+  {
+    fftw_cleanup_threads();
+  }
+};
+
+/**
+ * @brief Single precision FFTW API.
  */
-using FftwPlanPtr = std::unique_ptr<fftw_plan>;
+template <>
+struct FftwTraits<float> {
+  using Plan = fftwf_plan;
+  using Complex = fftwf_complex;
+
+  static Plan plan_r2c(
+      int rank,
+      const int* shape,
+      int count,
+      float* in,
+      int in_dist,
+      Complex* out,
+      int out_dist,
+      unsigned flags)
+  {
+    return fftwf_plan_many_dft_r2c(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, flags);
+  }
+
+  static Plan plan_c2r(
+      int rank,
+      const int* shape,
+      int count,
+      Complex* in,
+      int in_dist,
+      float* out,
+      int out_dist,
+      unsigned flags)
+  {
+    return fftwf_plan_many_dft_c2r(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, flags);
+  }
+
+  static Plan plan_c2c(
+      int rank,
+      const int* shape,
+      int count,
+      Complex* in,
+      int in_dist,
+      Complex* out,
+      int out_dist,
+      int sign,
+      unsigned flags)
+  {
+    return fftwf_plan_many_dft(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, sign, flags);
+  }
+
+  static Plan plan_r2r(
+      int rank,
+      const int* shape,
+      int count,
+      float* in,
+      int in_dist,
+      float* out,
+      int out_dist,
+      const fftw_r2r_kind* kinds,
+      unsigned flags)
+  {
+    return fftwf_plan_many_r2r(rank, shape, count, in, nullptr, 1, in_dist, out, nullptr, 1, out_dist, kinds, flags);
+  }
+
+  static void execute(const Plan plan)
+  {
+    fftwf_execute(plan);
+  }
+
+  static void execute_r2r(const Plan plan, float* in, float* out)
+  {
+    fftwf_execute_r2r(plan, in, out);
+  }
+
+  static void execute_r2c(const Plan plan, float* in, Complex* out)
+  {
+    fftwf_execute_dft_r2c(plan, in, out);
+  }
+
+  static void execute_c2r(const Plan plan, Complex* in, float* out)
+  {
+    fftwf_execute_dft_c2r(plan, in, out);
+  }
+
+  static void execute_c2c(const Plan plan, Complex* in, Complex* out)
+  {
+    fftwf_execute_dft(plan, in, out);
+  }
+
+  static int alignment_of(const void* data)
+  {
+    return fftwf_alignment_of(static_cast<float*>(const_cast<void*>(data)));
+  }
+
+  static void init_threads()
+  {
+    fftwf_init_threads();
+  }
+
+  static void plan_with_nthreads(int count)
+  {
+    fftwf_plan_with_nthreads(count);
+  }
+
+  static bool import_wisdom(const char* filename)
+  {
+    return fftwf_import_wisdom_from_filename(filename);
+  }
+
+  static bool export_wisdom(const char* filename)
+  {
+    return fftwf_export_wisdom_to_filename(filename);
+  }
+
+  static void forget_wisdom()
+  {
+    fftwf_forget_wisdom();
+  }
+
+  static void cleanup()
+  {
+    fftwf_cleanup_threads();
+  }
+};
+
+/**
+ * @brief Destroy a double precision plan.
+ */
+inline void destroy_fftw_plan(fftw_plan plan)
+{
+  fftw_destroy_plan(plan);
+}
+
+/**
+ * @brief Destroy a single precision plan.
+ */
+inline void destroy_fftw_plan(fftwf_plan plan)
+{
+  fftwf_destroy_plan(plan);
+}
+
+/**
+ * @brief RAII wrapper for FFTW plans.
+ * @tparam T The real type
+ * 
+ * `FftwPlanPtr<double>::get()` returns an `fftw_plan`, `FftwPlanPtr<float>::get()` returns an `fftwf_plan`.
+ */
+template <typename T = double>
+using FftwPlanPtr = std::unique_ptr<typename FftwTraits<T>::Plan>;
+
+/**
+ * @brief Get a human-readable representation of some planner flags, e.g. `"patient | wisdom-only"`.
+ */
+inline std::string fftw_flags_name(unsigned flags)
+{
+  std::string out = "measure";
+  if (flags & FFTW_ESTIMATE) {
+    out = "estimate";
+  } else if (flags & FFTW_EXHAUSTIVE) {
+    out = "exhaustive";
+  } else if (flags & FFTW_PATIENT) {
+    out = "patient";
+  }
+  if (flags & FFTW_WISDOM_ONLY) {
+    out += " | wisdom-only";
+  }
+  return out;
+}
 
 } // namespace Internal
 /// @endcond
@@ -28,7 +330,34 @@ using FftwPlanPtr = std::unique_ptr<fftw_plan>;
  * @brief Thread-safe singleton class to ensure proper FFTW memory management.
  * 
  * This is a Meyer's singleton.
- * The destructor, which is executed once (at the end of the program), calls `fftw_cleanup()`.
+ * The constructor calls `fftw_init_threads()`,
+ * and the destructor, which is executed once (at the end of the program), calls `fftw_cleanup_threads()`,
+ * and similarly for the single precision `fftwf_*` functions.
+ * 
+ * The singleton also holds the default planner flags (`FFTW_MEASURE` unless set otherwise),
+ * and optionally wisdom files, which are imported when set and exported at the end of the program.
+ * As FFTW wisdom depends on the precision, wisdom functions are templated by the real type (`double` by default).
+ * Within a process, FFTW keeps the wisdom accumulated by previous plans,
+ * such that planning the same shape again is fast.
+ * With a wisdom file, repeated runs on the same geometries are fast, too:
+ * 
+ * \code
+ * FftwAllocator::set_wisdom_file("linx.wisdom"); // Import now, export at exit
+ * RealDft<2> dft(shape); // Measured once, then instantaneous at next runs
+ * \endcode
+ * 
+ * Plans are single-threaded by default.
+ * For large transforms, the number of threads used by the subsequently created plans can be set:
+ * 
+ * \code
+ * FftwAllocator::set_threads(Threads(8));
+ * RealDft<2> dft({8192, 8192}); // Executed on 8 threads
+ * \endcode
+ * 
+ * Calls to the FFTW planner (plan creation and destruction, wisdom import and export) are serialized by a mutex,
+ * such that plans can be created and destroyed concurrently from any thread, e.g. with `DftPlan::compose()`.
+ * Plan execution is not locked: distinct plans, or a single plan with distinct buffers,
+ * can be executed concurrently.
  */
 class FftwAllocator {
 private:
@@ -36,14 +365,25 @@ private:
   /**
    * @brief Private constructor.
    */
-  FftwAllocator() {}
+  FftwAllocator() : m_flags(FFTW_MEASURE), m_threads(1), m_wisdom_file(), m_float_wisdom_file(), m_mutex()
+  {
+    Internal::FftwTraits<double>::init_threads();
+    Internal::FftwTraits<float>::init_threads();
+  }
 
   /**
-   * @brief Destructor which frees.
+   * @brief Destructor which exports the wisdom if needed, and frees.
    */
   ~FftwAllocator()
   {
-    fftw_cleanup();
+    if (not m_wisdom_file.empty()) {
+      Internal::FftwTraits<double>::export_wisdom(m_wisdom_file.c_str());
+    }
+    if (not m_float_wisdom_file.empty()) {
+      Internal::FftwTraits<float>::export_wisdom(m_float_wisdom_file.c_str());
+    }
+    Internal::FftwTraits<double>::cleanup();
+    Internal::FftwTraits<float>::cleanup();
   }
 
   /**
@@ -70,27 +410,179 @@ public:
    */
   FftwAllocator& operator=(const FftwAllocator&) = delete;
 
+  /**
+   * @brief Get the default planner flags.
+   */
+  static unsigned flags()
+  {
+    return instantiate().m_flags;
+  }
+
+  /**
+   * @brief Set the default planner flags, e.g. `FFTW_ESTIMATE`, `FFTW_PATIENT` or `FFTW_MEASURE | FFTW_WISDOM_ONLY`.
+   */
+  static void set_flags(unsigned flags)
+  {
+    instantiate().m_flags = flags;
+  }
+
+  /**
+   * @brief Get the number of threads of the plans.
+   */
+  static int threads()
+  {
+    return instantiate().m_threads;
+  }
+
+  /**
+   * @brief Set the number of threads of the plans created from now on.
+   * 
+   * Existing plans are not affected.
+   * Multi-threading is only profitable for large transforms, typically of millions of elements.
+   */
+  static void set_threads(Threads threads)
+  {
+    instantiate().m_threads = threads.count();
+  }
+
+  /**
+   * @brief Import some wisdom file.
+   * @tparam T The real type
+   * @return `true` if the file was read successfully
+   */
+  template <typename T = double>
+  static bool import_wisdom(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lock(instantiate().m_mutex);
+    return Internal::FftwTraits<T>::import_wisdom(filename.c_str());
+  }
+
+  /**
+   * @brief Export the accumulated wisdom to some file.
+   * @tparam T The real type
+   * @return `true` if the file was written successfully
+   */
+  template <typename T = double>
+  static bool export_wisdom(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lock(instantiate().m_mutex);
+    return Internal::FftwTraits<T>::export_wisdom(filename.c_str());
+  }
+
+  /**
+   * @brief Forget the accumulated wisdom, e.g. to measure the planning time from scratch.
+   * @tparam T The real type
+   */
+  template <typename T = double>
+  static void forget_wisdom()
+  {
+    std::lock_guard<std::mutex> lock(instantiate().m_mutex);
+    Internal::FftwTraits<T>::forget_wisdom();
+  }
+
+  /**
+   * @brief Set the wisdom file, which is imported now if it exists, and exported at the end of the program.
+   * @tparam T The real type
+   * @return `true` if the file was imported
+   */
+  template <typename T = double>
+  static bool set_wisdom_file(const std::string& filename)
+  {
+    auto& allocator = instantiate();
+    std::lock_guard<std::mutex> lock(allocator.m_mutex);
+    allocator.template wisdom_file<T>() = filename;
+    return Internal::FftwTraits<T>::import_wisdom(filename.c_str());
+  }
+
   /**
    * @brief Create a plan.
+   * @param in The input buffer
+   * @param out The output buffer
+   * @param flags The planner flags
+   * 
+   * This function is thread-safe.
    * @warning
+   * Unless `flags` contains `FFTW_ESTIMATE` or the plan is known from wisdom,
    * `in` and `out` are filled with garbage.
+   * 
+   * An `Exception` is thrown if FFTW cannot create the plan,
+   * e.g. if `flags` contains `FFTW_WISDOM_ONLY` and the plan is not known from wisdom.
+   */
+  template <typename TTransform, typename TIn, typename TOut>
+  static Internal::FftwPlanPtr<typename TTransform::Real> create_plan(TIn& in, TOut& out, unsigned flags)
+  {
+    auto& allocator = instantiate();
+    std::lock_guard<std::mutex> lock(allocator.m_mutex);
+    Internal::FftwTraits<typename TTransform::Real>::plan_with_nthreads(allocator.m_threads);
+    auto plan = TTransform::allocate_fftw_plan(in, out, flags);
+    if (not *plan) {
+      throw Exception("FFTW planner error", "Cannot create plan with flags: " + Internal::fftw_flags_name(flags));
+    }
+    return plan;
+  }
+
+  /**
+   * @brief Create a plan with the default flags.
    */
   template <typename TTransform, typename TIn, typename TOut>
-  static Internal::FftwPlanPtr create_plan(TIn& in, TOut& out)
+  static Internal::FftwPlanPtr<typename TTransform::Real> create_plan(TIn& in, TOut& out)
   {
-    instantiate();
-    return TTransform::allocate_fftw_plan(in, out);
+    return create_plan<TTransform>(in, out, flags());
   }
 
   /**
    * @brief Destroy a plan.
+   * 
+   * This function is thread-safe.
    */
-  static void destroy_plan(Internal::FftwPlanPtr& plan)
+  template <typename TPlan>
+  static void destroy_plan(std::unique_ptr<TPlan>& plan)
   {
     if (plan) {
-      fftw_destroy_plan(*plan);
+      std::lock_guard<std::mutex> lock(instantiate().m_mutex);
+      Internal::destroy_fftw_plan(*plan);
     }
   }
+
+private:
+
+  /**
+   * @brief Get the wisdom file of some precision.
+   */
+  template <typename T>
+  std::string& wisdom_file()
+  {
+    if constexpr (std::is_same_v<T, float>) {
+      return m_float_wisdom_file;
+    } else {
+      return m_wisdom_file;
+    }
+  }
+
+  /**
+   * @brief The default planner flags.
+   */
+  std::atomic<unsigned> m_flags;
+
+  /**
+   * @brief The number of threads of the plans.
+   */
+  std::atomic<int> m_threads;
+
+  /**
+   * @brief The double precision wisdom file, or empty.
+   */
+  std::string m_wisdom_file;
+
+  /**
+   * @brief The single precision wisdom file, or empty.
+   */
+  std::string m_float_wisdom_file;
+
+  /**
+   * @brief The planner mutex.
+   */
+  std::mutex m_mutex;
 };
 
 } // namespace Linx
@@ -0,0 +1,102 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_DFTOPTIONS_H
+#define _LINXTRANSFORMS_DFTOPTIONS_H
+
+#include "Linx/Run/ProgramOptions.h"
+#include "LinxTransforms/DftMemory.h"
+
+#include <stdexcept> // runtime_error
+#include <string>
+
+namespace Linx {
+
+/**
+ * @brief The FFTW planner options of a program.
+ *
+ * The options complement `ProgramOptions::performance()` for programs linked with `LinxTransforms`
+ * (the `Linx` package does not depend on FFTW):
+ * - `--planner`: the planner rigor, among `estimate`, `measure`, `patient` and `exhaustive`;
+ * - `--wisdom`: the wisdom file, which is imported at start and exported at exit.
+ *
+ * \code
+ * ProgramOptions options("Filter with large kernels");
+ * options.performance();
+ * DftOptions().declare(options);
+ * options.parse(argc, argv);
+ * DftOptions::parse(options).apply();
+ * \endcode
+ *
+ * @see `FftwAllocator::set_flags()`, `FftwAllocator::set_wisdom_file()`
+ */
+struct DftOptions {
+  /**
+   * @brief The planner rigor.
+   */
+  std::string planner = "measure";
+
+  /**
+   * @brief The double-precision wisdom file, or empty.
+   *
+   * The single-precision wisdom is stored in the same file name suffixed with `.float`.
+   */
+  std::string wisdom;
+
+  /**
+   * @brief Declare the options in a `ProgramOptions`, with the current values as defaults.
+   */
+  void declare(ProgramOptions& options) const
+  {
+    options.named("planner", "FFTW planner: estimate, measure, patient or exhaustive", planner);
+    options.named("wisdom", "FFTW wisdom file to be imported and exported at exit (or empty)", wisdom);
+  }
+
+  /**
+   * @brief Read the options declared with `declare()` from a parsed `ProgramOptions`.
+   */
+  static DftOptions parse(const ProgramOptions& options)
+  {
+    DftOptions out;
+    out.planner = options.as<std::string>("planner");
+    out.wisdom = options.as<std::string>("wisdom");
+    return out;
+  }
+
+  /**
+   * @brief Get the planner flags.
+   */
+  unsigned flags() const
+  {
+    if (planner == "estimate") {
+      return FFTW_ESTIMATE;
+    }
+    if (planner == "measure") {
+      return FFTW_MEASURE;
+    }
+    if (planner == "patient") {
+      return FFTW_PATIENT;
+    }
+    if (planner == "exhaustive") {
+      return FFTW_EXHAUSTIVE;
+    }
+    throw std::runtime_error("Unknown planner: " + planner);
+  }
+
+  /**
+   * @brief Set the default planner flags and the wisdom files of the `FftwAllocator`.
+   */
+  void apply() const
+  {
+    FftwAllocator::set_flags(flags());
+    if (not wisdom.empty()) {
+      FftwAllocator::set_wisdom_file<double>(wisdom);
+      FftwAllocator::set_wisdom_file<float>(wisdom + ".float");
+    }
+  }
+};
+
+} // namespace Linx
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef _LINXTRANSFORMS_DFTPLAN_H
 #define _LINXTRANSFORMS_DFTPLAN_H
 
+#include "Linx/Base/Trace.h"
 #include "Linx/Data/Raster.h"
 #include "LinxTransforms/DftMemory.h"
 
@@ -53,10 +54,18 @@ namespace Linx {
  * the length along the first axis is `length0 / 2 + 1` if `length0` is the logical length along the first axis.
  * None of the transforms are scaled, which means that a factor is introduced
  * by calling `transform()` and then `inverse().transform()` -- `normalize()` performs normalization on request.
- * The factor equals the logical number of elements.
+ * The factor equals the logical number of elements, or that of one element of the stack for batched plans.
+ * 
+ * Transforms are computed in double precision by default, or in single precision with `float` plans,
+ * e.g. `RealDft<2, float>`.
  * 
  * @tspecialization{ComplexDft}
+ * @tspecialization{ComplexDftBatch}
+ * @tspecialization{Dct}
+ * @tspecialization{Dst}
  * @tspecialization{RealDft}
+ * @tspecialization{RealDftBatch}
+ * @tspecialization{RealToRealDft}
  * 
  * @see http://www.fftw.org/fftw3_doc
  */
@@ -87,6 +96,11 @@ public:
    */
   using Inverse = DftPlan<InverseTransform, N>;
 
+  /**
+   * @brief The real type, which selects the FFTW precision.
+   */
+  using Real = typename Transform::Real;
+
   /**
    * @brief The input value type.
    */
@@ -102,10 +116,18 @@ public:
    * @param shape The logical shape
    * @param in_data The pre-existing input buffer, or `nullptr` to allocate a new one
    * @param out_data The pre-existing output buffer, or `nullptr` to allocate a new one
+   * @param flags The FFTW planner flags, e.g. `FFTW_ESTIMATE` or `FFTW_PATIENT`
+   * 
+   * @see `FftwAllocator` for default flags and wisdom management
    */
-  DftPlan(Position<N> shape, InValue* in_data = nullptr, OutValue* out_data = nullptr) :
-      m_shape {shape}, m_in {Transform::in_shape(m_shape), in_data}, m_out {Transform::out_shape(m_shape), out_data},
-      m_plan {FftwAllocator::create_plan<Transform>(m_in, m_out)}
+  DftPlan(
+      Position<N> shape,
+      InValue* in_data = nullptr,
+      OutValue* out_data = nullptr,
+      unsigned flags = FftwAllocator::flags()) :
+      m_shape {shape},
+      m_in {Transform::in_shape(m_shape), in_data}, m_out {Transform::out_shape(m_shape), out_data}, m_flags(flags),
+      m_plan {FftwAllocator::create_plan<Transform>(m_in, m_out, m_flags)}
   {}
 
   LINX_DEFAULT_COPYABLE(DftPlan)
@@ -136,7 +158,7 @@ public:
    */
   Inverse inverse()
   {
-    return Inverse {m_shape, m_out.data(), m_in.data()};
+    return Inverse {m_shape, m_out.data(), m_in.data(), m_flags};
   }
 
   /**
@@ -154,7 +176,7 @@ public:
   template <typename TPlan>
   TPlan compose(const Position<N>& shape)
   {
-    return {shape, m_out.data(), nullptr};
+    return {shape, m_out.data(), nullptr, m_flags};
   }
 
   /**
@@ -220,7 +242,7 @@ public:
    */
   double normalization_factor() const
   {
-    return shape_size(m_shape);
+    return Transform::normalization_factor(m_shape);
   }
 
   /**
@@ -228,7 +250,49 @@ public:
    */
   DftPlan& transform()
   {
-    fftw_execute(*m_plan);
+    LINX_TRACE_SCOPE("DftPlan::transform");
+    Internal::FftwTraits<Real>::execute(*m_plan);
+    return *this;
+  }
+
+  /**
+   * @brief Compute the transform of other buffers.
+   * @param in The input buffer
+   * @param out The output buffer
+   * 
+   * The plan is executed on `in` and `out` instead of its own buffers, which are left untouched.
+   * This allows applying a single plan to a stream of rasters without copies.
+   * The buffers must have the sizes of `in()` and `out()`, and the same alignment as them in the FFTW sense,
+   * which is the case of any owning `AlignedRaster`.
+   * Like with `transform()`, `in` may contain garbage afterwards, and `out` is not normalized.
+   * 
+   * As execution is thread-safe, different threads can apply the same plan to different buffers concurrently.
+   * 
+   * \code
+   * RealDft<2> dft(shape);
+   * #pragma omp parallel for
+   * for (std::size_t i = 0; i < images.size(); ++i) {
+   *   dft.transform(images[i], coefficients[i]);
+   * }
+   * \endcode
+   * 
+   * @throw SizeError if the buffer sizes do not match
+   * @throw AlignmentError if the buffers are not aligned like the plan buffers
+   */
+  template <typename TInHolder, typename TOutHolder>
+  const DftPlan& transform(Raster<InValue, N, TInHolder>& in, Raster<OutValue, N, TOutHolder>& out) const
+  {
+    LINX_TRACE_SCOPE("DftPlan::transform");
+    using Fftw = Internal::FftwTraits<Real>;
+    SizeError::may_throw(in.size(), m_in.size());
+    SizeError::may_throw(out.size(), m_out.size());
+    if (Fftw::alignment_of(in.data()) != Fftw::alignment_of(m_in.data())) {
+      throw AlignmentError(in.data(), alignment(m_in.data()));
+    }
+    if (Fftw::alignment_of(out.data()) != Fftw::alignment_of(m_out.data())) {
+      throw AlignmentError(out.data(), alignment(m_out.data()));
+    }
+    Transform::execute_fftw_plan(*m_plan, in.data(), out.data());
     return *this;
   }
 
@@ -237,7 +301,7 @@ public:
    */
   DftPlan& normalize()
   {
-    const auto factor = 1. / normalization_factor();
+    const Real factor = 1. / normalization_factor();
     m_out *= factor;
     return *this;
   }
@@ -259,10 +323,15 @@ private:
    */
   AlignedRaster<OutValue, N> m_out;
 
+  /**
+   * @brief The planner flags.
+   */
+  unsigned m_flags;
+
   /**
    * @brief The transform plan.
    */
-  Internal::FftwPlanPtr m_plan;
+  Internal::FftwPlanPtr<Real> m_plan;
 };
 
 } // namespace Linx
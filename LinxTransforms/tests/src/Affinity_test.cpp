@@ -3,8 +3,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath> // abs, cos, exp, sin
+#include <numeric> // accumulate
 
 using namespace Linx;
 
@@ -138,7 +141,7 @@ BOOST_AUTO_TEST_CASE(patch_rotation_center_30z_test)
   rotation.transform(interpolator, patch);
   for (const auto& p : out.domain()) {
     if (patch.domain().contains(p)) {
-      BOOST_TEST(out[p] == (interpolator(inv(p))));
+      BOOST_TEST(out[p] == (interpolator(inv(p))), boost::test_tools::tolerance(1.e-12));
     } else {
       BOOST_TEST(out[p] == 0);
     }
@@ -216,6 +219,126 @@ BOOST_AUTO_TEST_CASE(raster_upsampling_full_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(small_raster_rotation_test)
+{
+  SmallRaster<Index, 2, 16> in({4, 4});
+  in.range();
+  const auto out = rotate_deg<Nearest>(in, 90);
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(out)>, SmallRaster<Index, 2, 16>>));
+  BOOST_TEST(out.is_inline());
+  const auto expected = rotate_deg<Nearest>(Raster<Index>(in.shape(), in.data()), 90);
+  BOOST_TEST(std::equal(out.begin(), out.end(), expected.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(multithreaded_warp_test)
+{
+  const auto in = Raster<double>({17, 13}).range();
+  const auto zoom = Affinity<2>::scaling(2, center(in)); // Input positions are all inside the domain
+  const auto expected = zoom.warp<Linear>(in);
+  BOOST_TEST(zoom.warp<Linear>(in, Threads(3)) == expected);
+  BOOST_TEST(scale<Linear>(in, 2, Threads(3)) == expected);
+
+  const auto rotation = Affinity<2>::rotation_deg(30, 0, 1, center(in));
+
+  const auto extrapolator = extrapolation(in, 0.);
+  const auto interpolator = interpolation<Linear>(extrapolator);
+  Raster<double> full(in.shape());
+  rotation.transform(interpolator, full);
+  Raster<double> patched(in.shape());
+  patched.fill(-1);
+  auto patch = patched(Box<2>({2, 3}, {10, 8}));
+  rotation.transform(interpolator, patch, Threads(3));
+  for (const auto& p : patched.domain()) {
+    BOOST_TEST(patched[p] == (patch.domain().contains(p) ? full[p] : -1.), boost::test_tools::tolerance(1.e-12));
+  }
+
+  BOOST_TEST(translate<Nearest>(in, {0, 0}, Threads(2)) == in);
+}
+
+BOOST_AUTO_TEST_CASE(extrapolated_helpers_test)
+{
+  Raster<float> in({8, 6});
+  in.range();
+  const auto extrapolated = extrapolation(in, 0.F);
+  Raster<float> translated = translate<Nearest>(extrapolated, {0, 0});
+  BOOST_TEST(translated == in);
+  Raster<float> upsampled = upsample<Nearest>(extrapolated, 2);
+  BOOST_TEST(upsampled.shape() == in.shape() * 2);
+  Raster<float> downsampled = downsample<Linear>(extrapolated, 2);
+  BOOST_TEST(downsampled.shape() == in.shape() / 2);
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename TMethod, typename TIn>
+void check_separable(const Affinity<2>& affinity, const TIn& in)
+{
+  const auto extrapolator = extrapolation<Nearest>(in);
+  const auto interpolator = interpolation<TMethod>(extrapolator);
+  const auto inv = inverse(affinity);
+  Raster<double> out(in.shape());
+  affinity.transform(interpolator, out, Threads(2));
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == interpolator(inv(p)), boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(separable_transform_test)
+{
+  Raster<double> in({11, 9});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(p[0] * .7) + std::cos(p[1] * 1.3) * p[0];
+  }
+  const auto translation = Affinity<2>::translation({1.3, -2.6});
+  const auto scaling = Affinity<2>::scaling(Vector<double, 2>({0.7, 1.6}), center(in));
+  check_separable<Nearest>(translation, in);
+  check_separable<Linear>(translation, in);
+  check_separable<Cubic>(translation, in);
+  check_separable<Linear>(scaling, in);
+  check_separable<Cubic>(scaling, in);
+  check_separable<Lanczos<3>>(translation, in);
+  check_separable<Lanczos<3>>(scaling, in);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(shear_rotation_90_test)
+{
+  Raster<double> in({9, 9});
+  for (const auto& p : in.domain()) {
+    in[p] = p[0] + p[1] * 10;
+  }
+  const auto extrapolator = extrapolation(in, 0.);
+  Raster<double> expected(in.shape());
+  Affinity<2>::rotation_deg(90, 0, 1, center(in)).transform(interpolation<Nearest>(extrapolator), expected);
+  const auto out = shear_rotate_deg<Linear>(in, 90);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(shear_rotation_test)
+{
+  Raster<double> in({64, 48});
+  for (const auto& p : in.domain()) {
+    const auto x = (p[0] - 30.) / 6.;
+    const auto y = (p[1] - 25.) / 4.;
+    in[p] = std::exp(-(x * x + y * y) / 2.);
+  }
+  const auto in_sum = std::accumulate(in.begin(), in.end(), 0.);
+  const auto extrapolator = extrapolation(in, 0.);
+  Raster<double> expected(in.shape());
+  for (auto angle : {30., -70., 150., 200.}) {
+    Affinity<2>::rotation_deg(angle, 0, 1, center(in)).transform(interpolation<Cubic>(extrapolator), expected);
+    const auto out = shear_rotate_deg<Lanczos<3>>(in, angle, 0, 1, Threads(3));
+    for (const auto& p : in.domain()) {
+      BOOST_TEST(std::abs(out[p] - expected[p]) < .01);
+    }
+    const auto out_sum = std::accumulate(out.begin(), out.end(), 0.);
+    BOOST_TEST(out_sum == in_sum, boost::test_tools::tolerance(1.e-3));
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Transforms/Background.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Background_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(constant_test)
+{
+  auto in = Raster<float>({100, 70});
+  in.generate(GaussianNoise<float>(10, 2, 42));
+  const auto bkg = background(in, {32, 32});
+  BOOST_TEST(bkg.mesh().shape() == (Position<2> {4, 3}));
+  for (const auto& e : bkg.mesh()) {
+    BOOST_TEST(std::abs(e - 10) < 0.3);
+  }
+  for (const auto& e : bkg.rms_mesh()) {
+    BOOST_TEST(std::abs(e - 2) < 0.2); // Clipping bias and small border tiles
+  }
+  const auto map = bkg.background();
+  BOOST_TEST(map.shape() == in.shape());
+  for (const auto& p : map.domain()) {
+    BOOST_TEST(std::abs(map[p] - 10) < 0.3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gradient_with_sources_test)
+{
+  auto in = Raster<double>({128, 96});
+  in.generate(GaussianNoise<double>(0, 1, 42));
+  for (const auto& p : in.domain()) {
+    in[p] += 100 + .1 * p[0] + .05 * p[1];
+  }
+  for (Index i = 0; i < 40; ++i) {
+    in[{(i * 37) % 128, (i * 23) % 96}] += 1000; // Bright sources
+  }
+  in[{5, 5}] = std::numeric_limits<double>::quiet_NaN();
+  const auto bkg = background(in, {16, 16}, 1, Threads(3));
+  for (Index y = 16; y < 80; ++y) {
+    for (Index x = 16; x < 112; ++x) {
+      BOOST_TEST(bkg.at({x, y}) == 100 + .1 * x + .05 * y, boost::test_tools::tolerance(0.01));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_and_materialized_test)
+{
+  auto in = Raster<float, 3>({40, 30, 5});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(.1 * p[0]) + std::cos(.2 * p[1]) + p[2];
+  }
+  const auto bkg = background(in, {8, 8, 2}, 0, Threads(2));
+  const auto map = bkg.background(Threads(2));
+  const auto rms = bkg.rms(Threads(2));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(map[p] - bkg.at(p)) < 1.e-5);
+    BOOST_TEST(std::abs(rms[p] - bkg.rms_at(p)) < 1.e-5);
+  }
+  auto subtracted = in;
+  bkg.subtract(subtracted, Threads(2));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(subtracted[p] - (in[p] - map[p])) < 1.e-5);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
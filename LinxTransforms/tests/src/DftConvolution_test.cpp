@@ -0,0 +1,121 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LinxTransforms/DftConvolution.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DftConvolution_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(direct_dispatch_test)
+{
+  const auto values = Raster<double>({3, 3}).range();
+  BOOST_TEST(not dft_convolution(values).kernel().uses_dft());
+  BOOST_TEST(dft_convolution(values, {1, 1}, 256, 0).kernel().uses_dft());
+}
+
+BOOST_AUTO_TEST_CASE(extrapolation_test)
+{
+  auto in = Raster<float>({23, 19});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto values = Raster<float>({5, 4}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto expected = convolution(values) * extra;
+  const auto filter = dft_convolution(values, (values.shape() - 1) / 2, 8, 0); // Several blocks
+  const auto out = filter * extra;
+  Raster<float> threaded(in.shape());
+  filter.transform(extra, threaded, Threads(3));
+  BOOST_TEST(out.shape() == expected.shape());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    BOOST_TEST(out[i] == expected[i], boost::test_tools::tolerance(1e-3F));
+    BOOST_TEST(threaded[i] == out[i], boost::test_tools::tolerance(1e-3F));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(crop_3d_test)
+{
+  const auto in = Raster<double, 3>({12, 11, 10}).range();
+  const auto values = Raster<double, 3>({3, 4, 2}).range();
+  const auto expected = convolution(values) * in;
+  const auto out = dft_convolution(values, Position<3>::zero(), 6, 0) * in;
+  BOOST_TEST(out.shape() == expected.shape());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    BOOST_TEST(out[i] == expected[i], boost::test_tools::tolerance(1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(prepared_kernel_test)
+{
+  const auto values = Raster<double>({4, 3}).range();
+  const auto filter = dft_convolution(values, Position<2>::zero(), 256, 0);
+  const auto& kernel = filter.kernel();
+  const auto prepared = kernel.prepare({16, 12});
+  BOOST_TEST(kernel.prepare({16, 12}) == prepared);
+  BOOST_TEST(kernel.prepare({20, 12}) != prepared);
+  BOOST_TEST(prepared->block_shape() == Position<2>({16, 12}));
+
+  for (int frame = 0; frame < 3; ++frame) {
+    auto in = Raster<double>({16, 12});
+    in.generate([i = frame]() mutable {
+      return (i++ * 7919) % 101;
+    });
+    const auto expected = convolution(values) * in;
+    Raster<double> out(expected.shape());
+    prepared->apply(in, out);
+    const auto filtered = filter * in;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      BOOST_TEST(out[i] == expected[i], boost::test_tools::tolerance(1e-6));
+      BOOST_TEST(filtered[i] == expected[i], boost::test_tools::tolerance(1e-6));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chunks_test)
+{
+  auto in = Raster<float>({17, 29});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto values = Raster<double>({4, 3}).range();
+  const DftKernel<2> kernel(values.shape(), values, {8, 8});
+  Raster<float> expected(in.shape() - values.shape() + 1);
+  kernel.apply(in, expected);
+
+  Raster<float> out(expected.shape());
+  Index max_length = 0;
+  kernel.apply_by_chunks(
+      in.shape(),
+      [&](auto front, auto back) {
+        max_length = std::max(max_length, back - front + 1);
+        const auto chunk = in.chunk(front, back);
+        Raster<float> out({in.length(0), back - front + 1});
+        std::copy(chunk.begin(), chunk.end(), out.begin());
+        return out;
+      },
+      [&](auto front, const auto& chunk) {
+        std::copy(chunk.begin(), chunk.end(), out.chunk(front, front + chunk.length(1) - 1).begin());
+      });
+  BOOST_TEST(max_length == 8);
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(small_block_test)
+{
+  const auto values = Raster<double>({4, 3}).range();
+  BOOST_CHECK_THROW(DftKernel<2>(values.shape(), values, {8, 2}), OutOfBoundsError);
+  BOOST_CHECK_THROW(DftKernel<2>(values.shape(), values, {3, 8}), OutOfBoundsError);
+  BOOST_CHECK_NO_THROW(DftKernel<2>(values.shape(), values, values.shape()));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
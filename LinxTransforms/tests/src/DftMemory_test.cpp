@@ -6,6 +6,8 @@
 #include "LinxTransforms/DftMemory.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cstdio> // remove
+#include <vector>
 
 using namespace Linx;
 
@@ -42,20 +44,83 @@ BOOST_AUTO_TEST_CASE(allocate_plan_test)
   RealDftBuffer<3> rout(shape);
   ComplexDftBuffer<3> cin(shape);
   ComplexDftBuffer<3> cout(shape);
-  auto rc = FftwAllocator::create_plan<Internal::RealDftTransform>(rin, cout);
+  auto rc = FftwAllocator::create_plan<Internal::RealDftTransform<>>(rin, cout);
   BOOST_TEST(rc.get() != nullptr);
   FftwAllocator::destroy_plan(rc);
-  auto irc = FftwAllocator::create_plan<Internal::Inverse<Internal::RealDftTransform>>(cout, rin);
+  auto irc = FftwAllocator::create_plan<Internal::Inverse<Internal::RealDftTransform<>>>(cout, rin);
   BOOST_TEST(irc.get() != nullptr);
   FftwAllocator::destroy_plan(irc);
-  auto cc = FftwAllocator::create_plan<Internal::ComplexDftTransform>(cin, cout);
+  auto cc = FftwAllocator::create_plan<Internal::ComplexDftTransform<>>(cin, cout);
   BOOST_TEST(cc.get() != nullptr);
   FftwAllocator::destroy_plan(cc);
-  auto icc = FftwAllocator::create_plan<Internal::Inverse<Internal::ComplexDftTransform>>(cout, cin);
+  auto icc = FftwAllocator::create_plan<Internal::Inverse<Internal::ComplexDftTransform<>>>(cout, cin);
   BOOST_TEST(icc.get() != nullptr);
   FftwAllocator::destroy_plan(icc);
 }
 
+BOOST_AUTO_TEST_CASE(planner_flags_test)
+{
+  const auto flags = FftwAllocator::flags();
+  BOOST_TEST(flags == FFTW_MEASURE);
+  FftwAllocator::set_flags(FFTW_ESTIMATE);
+  BOOST_TEST(FftwAllocator::flags() == FFTW_ESTIMATE);
+  RealDft<2> dft({6, 4});
+  dft.in().fill(1);
+  dft.transform();
+  BOOST_TEST(dft.out()[0].real() == 24);
+  FftwAllocator::set_flags(flags);
+  RealDft<2> patient({6, 4}, nullptr, nullptr, FFTW_PATIENT);
+  BOOST_TEST(patient.in().size() == 24);
+}
+
+BOOST_AUTO_TEST_CASE(wisdom_only_planner_test)
+{
+  FftwAllocator::forget_wisdom();
+  BOOST_CHECK_THROW((RealDft<2>({7, 5}, nullptr, nullptr, FFTW_PATIENT | FFTW_WISDOM_ONLY)), Exception);
+  RealDft<2> dft({7, 5}, nullptr, nullptr, FFTW_ESTIMATE);
+  BOOST_TEST(dft.in().size() == 35);
+}
+
+BOOST_AUTO_TEST_CASE(planner_threads_test)
+{
+  BOOST_TEST(FftwAllocator::threads() == 1);
+  FftwAllocator::set_threads(Threads(2));
+  RealDft<2> dft({6, 4});
+  dft.in().fill(1);
+  dft.transform();
+  BOOST_TEST(dft.out()[0].real() == 24);
+  FftwAllocator::set_threads(Threads(1));
+  BOOST_TEST(FftwAllocator::threads() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_planning_test)
+{
+  std::vector<double> sums(16);
+#pragma omp parallel for num_threads(4)
+  for (int i = 0; i < int(sums.size()); ++i) {
+    RealDft<2> dft({4 + i % 3, 3});
+    auto complex = dft.template compose<ComplexDft<2>>(dft.out_shape());
+    dft.in().fill(1);
+    dft.transform();
+    sums[i] = dft.out()[0].real();
+  }
+  for (int i = 0; i < int(sums.size()); ++i) {
+    BOOST_TEST(sums[i] == (4 + i % 3) * 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(wisdom_file_test)
+{
+  const std::string filename = "/tmp/linx_DftMemory_test.wisdom";
+  std::remove(filename.c_str());
+  BOOST_TEST(not FftwAllocator::import_wisdom(filename));
+  RealDft<2> dft({8, 8});
+  BOOST_TEST(FftwAllocator::export_wisdom(filename));
+  BOOST_TEST(FftwAllocator::import_wisdom(filename));
+  BOOST_TEST(FftwAllocator::set_wisdom_file(filename));
+  std::remove(filename.c_str());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Linx/Io/Temporary.h"
+#include "LinxTransforms/Dft.h"
+#include "LinxTransforms/DftOptions.h"
+
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DftOptions_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(default_test)
+{
+  ProgramOptions options;
+  DftOptions().declare(options);
+  options.parse("program");
+  const auto parsed = DftOptions::parse(options);
+  BOOST_TEST(parsed.planner == "measure");
+  BOOST_TEST(parsed.wisdom.empty());
+  BOOST_TEST(parsed.flags() == FFTW_MEASURE);
+}
+
+BOOST_AUTO_TEST_CASE(planner_test)
+{
+  ProgramOptions options;
+  DftOptions().declare(options);
+  options.parse("program --planner estimate");
+  const auto parsed = DftOptions::parse(options);
+  BOOST_TEST(parsed.flags() == FFTW_ESTIMATE);
+  const auto flags = FftwAllocator::flags();
+  parsed.apply();
+  BOOST_TEST(FftwAllocator::flags() == FFTW_ESTIMATE);
+  FftwAllocator::set_flags(flags);
+  const DftOptions unknown {"fast", ""};
+  BOOST_CHECK_THROW(unknown.flags(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(wisdom_test)
+{
+  TemporaryPath wisdom("linx.wisdom");
+  ProgramOptions options;
+  DftOptions().declare(options);
+  options.parse("program --planner estimate --wisdom " + wisdom.string());
+  const auto flags = FftwAllocator::flags();
+  DftOptions::parse(options).apply();
+  RealDft<2> dft({16, 12});
+  BOOST_TEST(FftwAllocator::export_wisdom(wisdom.string()));
+  BOOST_TEST(std::filesystem::exists(std::filesystem::path(wisdom)));
+  FftwAllocator::set_flags(flags);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
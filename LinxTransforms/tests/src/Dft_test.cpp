@@ -5,6 +5,7 @@
 #include "LinxTransforms/Dft.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 
 using namespace Linx;
 
@@ -89,6 +90,158 @@ BOOST_AUTO_TEST_CASE(dft_r2c_c2c_ic2c_ir2c_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(float_dft_test)
+{
+  const Position<2> shape {5, 6};
+  RealDft<2, float> real(shape);
+  auto inverse_real = real.inverse();
+  BOOST_TEST(sizeof(*real.in().data()) == sizeof(float));
+  BOOST_TEST(real.out().shape() == Position<2>({3, 6}));
+
+  auto& signal = real.in();
+  for (const auto& p : signal.domain()) {
+    signal[p] = 1 + p[0] + p[1];
+  }
+  real.transform();
+  BOOST_TEST(std::abs(real.out()[0] - std::complex<float>(165, 0)) < 1.e-3);
+  inverse_real.transform().normalize();
+  for (const auto& p : signal.domain()) {
+    const float expected = 1 + p[0] + p[1];
+    BOOST_TEST(std::abs(signal[p] - expected) < 1.e-4 * expected);
+  }
+
+  Raster<float, 2> raster(shape);
+  raster.fill(1);
+  const auto coefficients = complex_dft<float>(raster);
+  BOOST_TEST(std::abs(coefficients[0] - std::complex<float>(30, 0)) < 1.e-4);
+  const auto recovered = inverse_complex_dft<float>(coefficients);
+  BOOST_TEST(std::abs(recovered[Position<2>({2, 3})] - std::complex<float>(1, 0)) < 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(batch_dft_test)
+{
+  const Position<2> shape {5, 4};
+  const Index count = 3;
+  RealDftBatch<2> batch({shape[0], shape[1], count});
+  auto inverse_batch = batch.inverse();
+  BOOST_TEST(batch.out_shape() == Position<3>({3, 4, count}));
+  BOOST_TEST(batch.normalization_factor() == shape_size(shape));
+
+  for (const auto& p : batch.in().domain()) {
+    batch.in()[p] = 1 + p[0] * p[2] - p[1];
+  }
+  const auto signal = batch.in();
+  batch.transform();
+
+  for (Index i = 0; i < count; ++i) {
+    RealDft<2> dft(shape);
+    std::copy(signal.section(i).begin(), signal.section(i).end(), dft.in().begin());
+    dft.transform();
+    const auto coefficients = batch.out().section(i);
+    for (const auto& p : dft.out().domain()) {
+      BOOST_TEST(std::abs(coefficients[p] - dft.out()[p]) < 1.e-9);
+    }
+  }
+
+  inverse_batch.transform().normalize();
+  for (const auto& p : signal.domain()) {
+    BOOST_TEST(std::abs(batch.in()[p] - signal[p]) < 1.e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(new_array_dft_test)
+{
+  const Position<2> shape {5, 4};
+  RealDft<2> dft(shape);
+  for (const auto& p : dft.in().domain()) {
+    dft.in()[p] = 1 + p[0] - p[1];
+  }
+  RealDftBuffer<2> in(dft.in().shape());
+  std::copy(dft.in().begin(), dft.in().end(), in.begin());
+  ComplexDftBuffer<2> out(dft.out_shape());
+  dft.transform(in, out);
+  dft.transform();
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(std::abs(out[p] - dft.out()[p]) < 1.e-9);
+  }
+
+  ComplexDftBuffer<2> wrong_size(shape);
+  BOOST_CHECK_THROW(dft.transform(in, wrong_size), SizeError);
+  RealDftBuffer<1> unaligned({in.size() + 1});
+  PtrRaster<double, 2> misaligned(in.shape(), unaligned.data() + 1);
+  BOOST_CHECK_THROW(dft.transform(misaligned, out), AlignmentError);
+}
+
+BOOST_AUTO_TEST_CASE(dct_test)
+{
+  const Index length = 4;
+  Dct<1> dct({length});
+  auto idct = dct.inverse();
+  BOOST_TEST(dct.out_shape() == Position<1>({length}));
+  BOOST_TEST(dct.normalization_factor() == 2 * length);
+  BOOST_TEST(idct.normalization_factor() == 2 * length);
+
+  const std::vector<double> signal {1, 3, -2, 5};
+  std::copy(signal.begin(), signal.end(), dct.in().begin());
+  dct.transform();
+  for (Index k = 0; k < length; ++k) {
+    double expected = 0;
+    for (Index j = 0; j < length; ++j) {
+      expected += 2 * signal[j] * std::cos(3.14159265358979323846 * (j + .5) * k / length);
+    }
+    BOOST_TEST(std::abs(dct.out()[k] - expected) < 1.e-9);
+  }
+  idct.transform().normalize();
+  for (Index j = 0; j < length; ++j) {
+    BOOST_TEST(std::abs(dct.in()[j] - signal[j]) < 1.e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dst1_roundtrip_test)
+{
+  const Position<2> shape {4, 3};
+  RealToRealDft<FFTW_RODFT00, 2> dst(shape);
+  auto idst = dst.inverse();
+  BOOST_TEST(dst.normalization_factor() == 2 * 5 * 2 * 4);
+  for (const auto& p : dst.in().domain()) {
+    dst.in()[p] = 1 + p[0] * p[1];
+  }
+  const auto signal = dst.in();
+  dst.transform();
+  idst.transform().normalize();
+  for (const auto& p : signal.domain()) {
+    BOOST_TEST(std::abs(dst.in()[p] - signal[p]) < 1.e-9);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(upsampled_inverse_dft_test)
+{
+  const Position<2> shape {5, 4};
+  Raster<std::complex<double>> signal(shape);
+  for (const auto& p : signal.domain()) {
+    signal[p] = {1. + p[0] * p[1], 1. * p[1]};
+  }
+  const auto coefficients = complex_dft(signal);
+
+  const auto identity = upsampled_inverse_dft(coefficients, signal.domain(), 1);
+  for (const auto& p : signal.domain()) {
+    BOOST_TEST(std::abs(identity[p] - signal[p]) < 1.e-9);
+  }
+
+  const Index factor = 3;
+  const Box<2> region({-factor, -factor}, {2 * factor, factor});
+  const auto upsampled = upsampled_inverse_dft(coefficients, region, factor);
+  BOOST_TEST(upsampled.shape() == region.shape());
+  for (const auto& p : region) {
+    if (p[0] % factor == 0 && p[1] % factor == 0) {
+      const Position<2> q {(p[0] / factor + shape[0]) % shape[0], (p[1] / factor + shape[1]) % shape[1]};
+      BOOST_TEST(std::abs(upsampled[p - region.front()] - signal[q]) < 1.e-9);
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
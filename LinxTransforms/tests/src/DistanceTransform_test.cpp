@@ -0,0 +1,103 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/DistanceTransform.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DistanceTransform_test)
+
+//-----------------------------------------------------------------------------
+
+template <Index N>
+Raster<double, N> brute_force_squared_distance(const Raster<char, N>& in)
+{
+  Raster<double, N> out(in.shape());
+  for (const auto& p : in.domain()) {
+    double min = std::numeric_limits<double>::infinity();
+    for (const auto& q : in.domain()) {
+      if (in[q]) {
+        min = std::min(min, double(distance<2>(p, q)));
+      }
+    }
+    out[p] = min;
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(exact_2d_test)
+{
+  Raster<char> in({13, 9});
+  in.fill(0);
+  in[{2, 3}] = 1;
+  in[{10, 1}] = 1;
+  in[{7, 8}] = 1;
+  const auto expected = brute_force_squared_distance(in);
+  const auto out = squared_distance_transform(in);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == expected[p]);
+  }
+  const auto threaded = squared_distance_transform(in, Threads(2));
+  BOOST_TEST(threaded.container() == out.container());
+  const auto d = distance_transform(in);
+  BOOST_TEST(d[Position<2>({5, 3})] == 3.);
+}
+
+BOOST_AUTO_TEST_CASE(exact_3d_test)
+{
+  Raster<char, 3> in({6, 5, 4});
+  in.fill(0);
+  in[{0, 0, 0}] = 1;
+  in[{5, 2, 3}] = 1;
+  const auto expected = brute_force_squared_distance(in);
+  const auto out = squared_distance_transform(in);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == expected[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(no_feature_test)
+{
+  Raster<char> in({4, 3});
+  in.fill(0);
+  for (auto e : distance_transform(in)) {
+    BOOST_TEST(std::isinf(e));
+  }
+  for (auto e : chamfer_distance_transform(in)) {
+    BOOST_TEST(std::isinf(e));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mask_test)
+{
+  const auto mask = Mask<2>::ball<1>(1, Position<2> {5, 5});
+  const auto out = distance_transform(mask);
+  BOOST_TEST(out.shape() == mask.shape());
+  BOOST_TEST(out[Position<2>({5, 5}) - mask.box().front()] == 0.);
+  BOOST_TEST(out[Position<2>({6, 6}) - mask.box().front()] == 1.);
+}
+
+BOOST_AUTO_TEST_CASE(chamfer_test)
+{
+  Raster<char> in({11, 11});
+  in.fill(0);
+  in[{5, 5}] = 1;
+  const auto out = chamfer_distance_transform(in);
+  BOOST_TEST(out[Position<2>({5, 5})] == 0.f);
+  BOOST_TEST(out[Position<2>({8, 5})] == 3.f);
+  BOOST_TEST(out[Position<2>({5, 1})] == 4.f);
+  BOOST_TEST(out[Position<2>({7, 7})] == 2.8f, boost::test_tools::tolerance(1e-5f));
+  const auto exact = distance_transform(in);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(out[p] - exact[p]) < 0.1 * exact[p] + 1e-3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
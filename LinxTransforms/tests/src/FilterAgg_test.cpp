@@ -27,6 +27,35 @@ BOOST_AUTO_TEST_CASE(laplacian_minus_test)
   BOOST_TEST((laplace_operator<int, 0, 1>(-1).impulse()) == expected);
 }
 
+BOOST_AUTO_TEST_CASE(fused_extrapolation_test)
+{
+  const auto in = Raster<int>({7, 6}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto lhs = convolution_along<int, 0>({1, -2, 1});
+  const auto rhs = convolution(Raster<int>({3, 5}).range());
+  const auto out = (lhs + rhs) * extra;
+  Raster<int> expected = lhs * extra;
+  expected += rhs * extra;
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(fused_crop_test)
+{
+  const auto in = Raster<double, 3>({7, 6, 5}).range();
+  const auto mean = mean_filter<double>(Box<3>::from_center(1));
+  const auto dilate = dilation<double>(Box<3>({-1, 0, 0}, {2, 1, 0}));
+  const auto out = norm<1>(mean, dilate) * in;
+  const auto inner = in.domain() - Box<3>({-1, -1, -1}, {2, 1, 1});
+  BOOST_TEST(out.shape() == inner.shape());
+  const auto mean_out = mean * extrapolation(in, 0.);
+  const auto dilate_out = dilate * extrapolation(in, 0.);
+  auto it = out.begin();
+  for (const auto& p : inner) {
+    BOOST_TEST(*it == std::abs(mean_out[p]) + std::abs(dilate_out[p]), boost::test_tools::tolerance(1e-9));
+    ++it;
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
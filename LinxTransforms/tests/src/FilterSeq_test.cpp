@@ -98,6 +98,47 @@ BOOST_AUTO_TEST_CASE(orthogonal_associativity_commutativity_test)
   BOOST_TEST(commutated == direct);
 }
 
+BOOST_AUTO_TEST_CASE(separable_sobel_test)
+{
+  const auto raster = Raster<int>({7, 5}).range();
+  const auto sobel = sobel_gradient<int, 0, 1>();
+  const auto dense = convolution(Raster<int>({3, 3}, {1, 0, -1, 2, 0, -2, 1, 0, -1}));
+  BOOST_TEST((sobel * extrapolation(raster, 0)) == (dense * extrapolation(raster, 0)));
+  BOOST_TEST((sobel * extrapolation<Nearest>(raster)) == (dense * extrapolation<Nearest>(raster)));
+  BOOST_TEST((sobel * raster) == (dense * raster));
+}
+
+BOOST_AUTO_TEST_CASE(separable_3d_test)
+{
+  const auto raster = Raster<double, 3>({6, 5, 4}).range();
+  const auto a = correlation_along<double, 0>({1, 2});
+  const auto c = correlation_along<double, 2>({1, -1, 3});
+  const auto dense = correlation(Raster<double, 3>({2, 1, 3}, {1, 2, -1, -2, 3, 6}), {1, 0, 1});
+  const auto separable = a * c;
+  BOOST_TEST((separable * extrapolation<Periodic>(raster)) == (dense * extrapolation<Periodic>(raster)));
+  BOOST_TEST((separable * raster) == (dense * raster));
+}
+
+BOOST_AUTO_TEST_CASE(stream_test)
+{
+  const auto in = Raster<float, 3>({8, 7, 11}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto seq = mean_filter<float>(Box<3>::from_center(1)) * median_filter<float>(Box<3>({-1, 0, 0}, {1, 1, 2}));
+  const auto expected = seq * extra;
+  Raster<float, 3> streamed(in.shape());
+  seq.stream(extra, streamed, 2);
+  BOOST_TEST(streamed == expected);
+  Raster<float, 3> threaded(in.shape());
+  seq.transform(extra, threaded, Threads(3));
+  BOOST_TEST(threaded == expected);
+  const auto cropped = seq * in;
+  Raster<float, 3> cropped_streamed(cropped.shape());
+  seq.stream(in, cropped_streamed, 3, Threads(2));
+  BOOST_TEST(cropped_streamed == cropped);
+  BOOST_CHECK_THROW(seq.stream(extra, streamed, 0), Exception);
+  BOOST_CHECK_THROW(seq.stream(extra, streamed, -1), Exception);
+}
+
 // BOOST_AUTO_TEST_CASE(sum3x3_dirichlet_test)
 // {
 //   const SeparableKernel<int, 0, 1, 2> kernel({1, 1, 1});
@@ -2,9 +2,13 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/Mask.h"
 #include "Linx/Transforms/Filters.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath> // isnan
+#include <limits>
+#include <numeric> // accumulate
 
 using namespace Linx;
 
@@ -41,6 +45,34 @@ BOOST_AUTO_TEST_CASE(crop_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(small_raster_test)
+{
+  SmallRaster<int, 2, 100> in({10, 8});
+  in.range();
+  const auto k = convolution(Raster<int>({3, 3}).fill(1));
+  const auto cropped = k * in;
+  const auto extrapolated = k * extrapolation(in, 0);
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(cropped)>, SmallRaster<int, 2, 100>>));
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(extrapolated)>, SmallRaster<int, 2, 100>>));
+  BOOST_TEST(cropped.is_inline());
+  const auto expected = k * Raster<int>(in.shape(), in.data());
+  BOOST_TEST(cropped.shape() == expected.shape());
+  BOOST_TEST(std::equal(cropped.begin(), cropped.end(), expected.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(lazy_raster_test)
+{
+  const auto in = lazy_raster<3>({20, 10, 700}, [](const auto& p) {
+    return int(p[0] * p[1] + p[2] % 7);
+  });
+  const auto k = convolution(Raster<int>({3, 3}).fill(1));
+  const auto out = k * in;
+  const auto raster = in.copy(in.domain() + Box<3>({-1, -1, 0}, {1, 1, 0}));
+  const auto expected = k * raster;
+  BOOST_TEST(out.shape() == in.shape());
+  BOOST_TEST(out == expected);
+}
+
 BOOST_AUTO_TEST_CASE(inner_box_test)
 {
   const auto in = Raster<int, 3>({5, 6, 7}).range();
@@ -120,6 +152,375 @@ BOOST_AUTO_TEST_CASE(extrapolated_decimate_3d_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(box_mean_test)
+{
+  const auto in = Raster<double, 3>({9, 8, 7}).range();
+  const auto box = Box<3>({-1, -2, 0}, {2, 1, 1});
+  const auto fast = mean_filter<double>(box);
+  const auto slow = mean_filter<double>(Mask<3>(box));
+  const auto fast_cropped = fast * in;
+  const auto slow_cropped = slow * in;
+  BOOST_TEST(fast_cropped.shape() == slow_cropped.shape());
+  for (std::size_t i = 0; i < fast_cropped.size(); ++i) {
+    BOOST_TEST(fast_cropped[i] == slow_cropped[i], boost::test_tools::tolerance(1e-9));
+  }
+  const auto fast_extrapolated = fast * extrapolation<Nearest>(in);
+  const auto slow_extrapolated = slow * extrapolation<Nearest>(in);
+  for (std::size_t i = 0; i < fast_extrapolated.size(); ++i) {
+    BOOST_TEST(fast_extrapolated[i] == slow_extrapolated[i], boost::test_tools::tolerance(1e-9));
+  }
+  Raster<double, 3> threaded(in.shape());
+  fast.transform(extrapolation<Nearest>(in), threaded, Threads(3));
+  BOOST_TEST(threaded == fast_extrapolated);
+}
+
+BOOST_AUTO_TEST_CASE(box_mean_int_test)
+{
+  const auto in = Raster<int>({6, 5}).range();
+  const auto box = Box<2>::from_center(2);
+  const auto fast = mean_filter<int>(box) * extrapolation(in, 0);
+  const auto slow = mean_filter<int>(Mask<2>(box)) * extrapolation(in, 0);
+  BOOST_TEST(fast == slow);
+}
+
+BOOST_AUTO_TEST_CASE(box_erosion_dilation_test)
+{
+  auto in = Raster<int, 3>({9, 8, 7});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto box = Box<3>({-1, -2, 0}, {3, 1, 1});
+  const auto extra = extrapolation<Nearest>(in);
+  const auto eroded = erosion<int>(box) * extra;
+  const auto dilated = dilation<int>(box) * extra;
+  for (const auto& p : in.domain()) {
+    int min = extra[p];
+    int max = extra[p];
+    for (const auto& q : box + p) {
+      min = std::min(min, extra[q]);
+      max = std::max(max, extra[q]);
+    }
+    BOOST_TEST(eroded[p] == min);
+    BOOST_TEST(dilated[p] == max);
+  }
+  Raster<int, 3> threaded(in.shape());
+  erosion<int>(box).transform(extra, threaded, Threads(3));
+  BOOST_TEST(threaded == eroded);
+}
+
+BOOST_AUTO_TEST_CASE(ball_erosion_dilation_test)
+{
+  auto in = Raster<int>({17, 15});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto ball = Mask<2>::ball<2>(3);
+  const auto extra = extrapolation(in, 50);
+  const auto eroded = erosion<int>(ball) * extra;
+  const auto dilated = dilation<int>(ball) * extra;
+  for (const auto& p : in.domain()) {
+    int min = extra[p];
+    int max = extra[p];
+    for (const auto& q : ball + p) {
+      min = std::min(min, extra[q]);
+      max = std::max(max, extra[q]);
+    }
+    BOOST_TEST(eroded[p] == min);
+    BOOST_TEST(dilated[p] == max);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(extrapolated_mask_patch_test)
+{
+  auto in = Raster<float>({9, 8});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto ball = Mask<2>::ball<2>(1);
+  const auto extra = extrapolation(in, 0.F);
+  const Box<2> region({0, 3}, {5, 7}); // Along the borders
+  const auto mean = mean_filter<float>(ball) * extra(region);
+  const auto median = median_filter<float>(ball) * extra(region);
+  BOOST_TEST(mean.shape() == region.shape());
+  BOOST_TEST(median.shape() == region.shape());
+  for (const auto& p : mean.domain()) {
+    std::vector<float> values;
+    for (const auto& q : ball + (p + region.front())) {
+      values.push_back(extra[q]);
+    }
+    const auto sum = std::accumulate(values.begin(), values.end(), 0.F);
+    BOOST_TEST(mean[p] == sum / values.size(), boost::test_tools::tolerance(1e-4F));
+    std::sort(values.begin(), values.end());
+    BOOST_TEST(median[p] == values[values.size() / 2]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(threaded_box_patch_test)
+{
+  auto in = Raster<float, 3>({19, 17, 5});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto extra = extrapolation(in, 1.F);
+  const Box<3> region({0, 3, 1}, {18, 16, 3}); // Along the borders
+  const auto mean = mean_filter<float>(Box<2>({-1, -2}, {1, 2}));
+  const auto median = median_filter<float>(Mask<2>::ball<2>(1));
+  Raster<float, 3> expected(region.shape());
+  Raster<float, 3> out(region.shape());
+  mean.transform(extra(region), expected);
+  mean.transform(extra(region), out, Threads(3));
+  BOOST_TEST(out == expected);
+  median.transform(extra(region), expected);
+  median.transform(extra(region), out, Threads(3));
+  BOOST_TEST(out == expected);
+  const Box<3> inner({2, 3, 0}, {16, 14, 4});
+  Raster<float, 3> inner_expected(inner.shape());
+  Raster<float, 3> inner_out(inner.shape());
+  mean.transform(in(inner), inner_expected);
+  mean.transform(in(inner), inner_out, Threads(3));
+  BOOST_TEST(inner_out == inner_expected);
+}
+
+using MedianTypes = std::tuple<unsigned char, short, int, float>;
+
+template <typename T, typename TIn, typename TWindow>
+T naive_median(const TIn& in, const TWindow& window, const Position<2>& p)
+{
+  std::vector<T> values;
+  for (const auto& q : window + p) {
+    values.push_back(in[q]);
+  }
+  std::sort(values.begin(), values.end());
+  const auto size = values.size();
+  if (size % 2 == 1) {
+    return values[size / 2];
+  }
+  return (values[size / 2 - 1] + values[size / 2]) * .5;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sliding_median_test, T, MedianTypes)
+{
+  auto in = Raster<T>({17, 15});
+  in.generate([i = 0]() mutable {
+    return T((i++ * 7919) % 101);
+  });
+  const auto extra = extrapolation<Nearest>(in);
+  const auto box = Box<2>({-2, -1}, {2, 1});
+  const auto even = Box<2>({0, 0}, {1, 1});
+  const auto ball = Mask<2>::ball<2>(3);
+  const auto box_out = median_filter<T>(box) * extra;
+  const auto even_out = median_filter<T>(even) * extra;
+  const auto ball_out = median_filter<T>(ball) * extra;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(box_out[p] == naive_median<T>(extra, box, p));
+    BOOST_TEST(even_out[p] == naive_median<T>(extra, even, p));
+    BOOST_TEST(ball_out[p] == naive_median<T>(extra, ball, p));
+  }
+  Raster<T> threaded(in.shape());
+  median_filter<T>(ball).transform(extra, threaded, Threads(3));
+  BOOST_TEST(threaded == ball_out);
+}
+
+BOOST_AUTO_TEST_CASE(nan_median_test)
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  auto in = Raster<float>({9, 7});
+  in.generate([i = 0]() mutable {
+    const auto v = i++;
+    return v % 3 == 0 ? std::numeric_limits<float>::quiet_NaN() : float((v * 7919) % 101);
+  });
+  for (const auto& p : Box<2>({0, 0}, {2, 2})) {
+    in[p] = nan;
+  }
+  const auto box = Box<2>({-1, -1}, {1, 1});
+  const auto out = median_filter<float>(box) * in; // Sliding
+  BOOST_TEST(std::isnan(out[{0, 0}]));
+  for (const auto& p : out.domain()) {
+    std::vector<float> values;
+    for (const auto& q : box + (p + 1)) {
+      if (not std::isnan(in[q])) {
+        values.push_back(in[q]);
+      }
+    }
+    const auto pixel = median_filter<float>(box) * in(Box<2>(p + 1, p + 1)); // Kernel
+    if (values.empty()) {
+      BOOST_TEST(std::isnan(out[p]));
+      BOOST_TEST(std::isnan(pixel[0]));
+      continue;
+    }
+    std::sort(values.begin(), values.end());
+    const auto size = values.size();
+    const auto expected = size % 2 == 1 ? values[size / 2] : (values[size / 2 - 1] + values[size / 2]) * .5F;
+    BOOST_TEST(out[p] == expected);
+    BOOST_TEST(pixel[0] == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(even_median_test)
+{
+  const auto in = Raster<float>({2, 2}, {4, 1, 3, 2});
+  const auto out = median_filter<float>(Grid<2>(Box<2>({0, 0}, {1, 1}), 1)) * in;
+  BOOST_TEST(out[0] == 2.5);
+}
+
+struct SumOfSquares {
+  void add(int value)
+  {
+    sum += value * value;
+  }
+  void remove(int value)
+  {
+    sum -= value * value;
+  }
+  long result() const
+  {
+    return sum;
+  }
+  long sum = 0;
+};
+
+BOOST_AUTO_TEST_CASE(reduction_filter_test)
+{
+  Raster<int> in({13, 11});
+  Index i = 0;
+  in.generate([&]() {
+    return (++i * 7919) % 101 - 50;
+  });
+  const auto extra = extrapolation(in, 0);
+  const auto ball = Mask<2>::ball<2>(2);
+  const auto out = reduction_filter<SumOfSquares>(ball) * extra;
+  const auto box_out = reduction_filter<SumOfSquares>(Box<2>::from_center(1)) * in;
+  for (const auto& p : in.domain()) {
+    long sum = 0;
+    for (const auto& q : ball + p) {
+      sum += extra[q] * extra[q];
+    }
+    BOOST_TEST(out[p] == sum);
+  }
+  auto it = box_out.begin();
+  for (const auto& p : in.domain() - Box<2>::from_center(1)) {
+    long sum = 0;
+    for (const auto& q : Box<2>::from_center(1) + p) {
+      sum += in[q] * in[q];
+    }
+    BOOST_TEST(*it == sum);
+    ++it;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gaussian_filter_test)
+{
+  Raster<float> in({64, 48});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(.1 * p[0]) * std::cos(.07 * p[1]) + (p[0] == 30 && p[1] == 20 ? 10 : 0);
+  }
+  const auto extra = extrapolation<Nearest>(in);
+  const auto direct = gaussian_filter<float, 0, 1>(4, 100);
+  const auto recursive = gaussian_filter<float, 0, 1>(4, 2);
+  const auto expected = direct * extra;
+  const auto out = recursive * extra;
+  BOOST_TEST(out.shape() == in.shape());
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(out[p] - expected[p]) < .02);
+  }
+  Raster<float> constant({32, 32});
+  constant.fill(3);
+  const auto smoothed = gaussian_filter<float, 1>(10) * extrapolation<Nearest>(constant);
+  for (const auto& e : smoothed) {
+    BOOST_TEST(e == 3.f, boost::test_tools::tolerance(1e-4f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_kernel_test)
+{
+  Raster<double, 3> in({11, 10, 9});
+  Index i = 0;
+  in.generate([&]() {
+    return (++i * 7919) % 101;
+  });
+  const auto extra = extrapolation<Periodic>(in);
+  std::array<double, 3 * 2 * 3> values;
+  std::iota(values.begin(), values.end(), -5.);
+  const Raster<double, 3> raster({3, 2, 3}, values.data());
+  const auto origin = Position<3>({1, 0, 1});
+  BOOST_TEST((fixed_correlation<double, 3, 2, 3>(values) * extra) == (correlation(raster, origin) * extra));
+  BOOST_TEST((fixed_convolution<double, 3, 2, 3>(values) * extra) == (convolution(raster, origin) * extra));
+  BOOST_TEST((fixed_correlation<double, 3, 2, 3>(values) * in) == (correlation(raster, origin) * in));
+  const auto sequence = Sequence<Position<3>>({{0, 0, 0}, {5, 5, 5}, {10, 9, 8}});
+  const auto seq_out = fixed_convolution<double, 3, 2, 3>(values) * extra(sequence);
+  const auto seq_expected = convolution(raster, origin) * extra(sequence);
+  BOOST_TEST(seq_out == seq_expected);
+}
+
+BOOST_AUTO_TEST_CASE(sections_test)
+{
+  Raster<int, 3> in({12, 10, 4});
+  Index i = 0;
+  in.generate([&]() {
+    return (++i * 7919) % 101;
+  });
+  const auto ball = Mask<2>::ball<2>(2);
+  const auto median = median_filter<int>(ball);
+  const auto erode = erosion<int>(ball);
+  const auto mean = mean_filter<int>(Box<2>::from_center(1));
+  const auto median_out = median * extrapolation(in, 0);
+  const auto erode_out = erode * extrapolation(in, 0);
+  Raster<int, 3> mean_out(in.shape());
+  mean.transform(extrapolation(in, 0), mean_out, Threads(2));
+  for (Index k = 0; k < in.length(2); ++k) {
+    const auto section = in.section(k);
+    const auto extra = extrapolation(section, 0);
+    BOOST_TEST(median_out.section(k) == median * extra);
+    BOOST_TEST(erode_out.section(k) == erode * extra);
+    BOOST_TEST(mean_out.section(k) == mean * extra);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(row_correlation_test)
+{
+  auto in = Raster<int, 3>({9, 8, 7});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto values = Raster<double, 3>({4, 3, 2}).range();
+  const auto box = Box<3>({-1, -1, 0}, {2, 1, 1});
+  const auto extra = extrapolation<Periodic>(in);
+  const auto correlated = correlation(values, -box.front()) * extra;
+  const auto convolved = convolution(values, -box.front()) * extra;
+  for (const auto& p : in.domain()) {
+    double corr = 0;
+    double conv = 0;
+    auto it = values.begin();
+    auto rit = values.end();
+    for (const auto& q : box + p) {
+      corr += *it * extra[q];
+      --rit;
+      conv += *rit * extra[q];
+      ++it;
+    }
+    BOOST_TEST(correlated[p] == corr);
+    BOOST_TEST(convolved[p] == conv);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(variable_dimension_test)
+{
+  auto fixed = Raster<float, 3>({9, 8, 3});
+  fixed.range();
+  auto variable = Raster<float, -1>(Position<-1> {9, 8, 3});
+  std::copy(fixed.begin(), fixed.end(), variable.begin());
+  const auto kernel = Raster<float>({3, 3}).fill(1);
+  const auto expected = convolution(kernel) * extrapolation(fixed, 0.F);
+  auto out = Raster<float, -1>(variable.shape());
+  convolution(kernel).transform(extrapolation(variable, 0.F), out);
+  BOOST_TEST(out.dimension() == 3);
+  BOOST_TEST(std::equal(out.begin(), out.end(), expected.begin()));
+  auto threaded = Raster<float, -1>(variable.shape());
+  convolution(kernel).transform(extrapolation<Nearest>(variable), threaded, Threads(2));
+  const auto nearest = convolution(kernel) * extrapolation<Nearest>(fixed);
+  BOOST_TEST(std::equal(threaded.begin(), threaded.end(), nearest.begin()));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
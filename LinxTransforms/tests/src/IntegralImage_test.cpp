@@ -0,0 +1,68 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/IntegralImage.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(IntegralImage_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(cumsum_test)
+{
+  const auto in = Raster<Index, 3>({5, 300, 3}).range();
+  const auto out0 = cumsum<0>(in);
+  const auto out1 = cumsum<1>(in, Threads(2));
+  const auto out2 = cumsum<2>(in);
+  for (const auto& p : in.domain()) {
+    Index s0 = 0;
+    Index s1 = 0;
+    Index s2 = 0;
+    auto q = p;
+    for (q[0] = 0; q[0] <= p[0]; ++q[0]) {
+      s0 += in[q];
+    }
+    q = p;
+    for (q[1] = 0; q[1] <= p[1]; ++q[1]) {
+      s1 += in[q];
+    }
+    q = p;
+    for (q[2] = 0; q[2] <= p[2]; ++q[2]) {
+      s2 += in[q];
+    }
+    BOOST_TEST(out0[p] == s0);
+    BOOST_TEST(out1[p] == s1);
+    BOOST_TEST(out2[p] == s2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(integral_image_test)
+{
+  auto in = Raster<char, 3>({6, 5, 4});
+  Index i = 0;
+  for (auto& e : in) {
+    e = char(i % 7);
+    ++i;
+  }
+  const auto table = integral_image(in);
+  BOOST_TEST(table.domain() == in.domain());
+  BOOST_TEST(table.table().shape() == in.shape() + 1);
+  for (const auto& box : {Box<3>({0, 0, 0}, {5, 4, 3}), Box<3>({1, 2, 0}, {4, 2, 3}), Box<3>({5, 4, 3}, {5, 4, 3})}) {
+    Index expected = 0;
+    for (const auto& p : box) {
+      expected += in[p];
+    }
+    BOOST_TEST(table.sum(box) == expected);
+    BOOST_TEST(table.mean(box) == double(expected) / box.size());
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,12 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/LazyRaster.h"
 #include "Linx/Transforms/Extrapolation.h" // FIXME own test suite
 #include "Linx/Transforms/Interpolation.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath> // sin
 
 using namespace Linx;
 
@@ -48,6 +50,49 @@ BOOST_AUTO_TEST_CASE(periodic_test)
   BOOST_TEST(extra[positive] == (raster[{0, 1, 0}]));
 }
 
+BOOST_AUTO_TEST_CASE(inner_extrapolation_test)
+{
+  Raster<int, 2> raster({4, 3});
+  raster.range(1);
+  const auto extra = extrapolation<Periodic>(raster);
+  BOOST_TEST(extra.is_inner(Position<2> {3, 2}));
+  BOOST_TEST(not extra.is_inner(Position<2> {-1, 2}));
+  BOOST_TEST(not extra.is_inner(Position<2> {0, 3}));
+  BOOST_TEST(extra.is_inner(Box<2>({1, 0}, {3, 2})));
+  BOOST_TEST(not extra.is_inner(Box<2>({1, 0}, {4, 2})));
+  for (const auto& p : Box<2>({-5, -4}, {8, 6})) {
+    Position<2> q {(p[0] + 8) % 4, (p[1] + 6) % 3};
+    BOOST_TEST(extra[p] == raster[q]);
+    BOOST_TEST(&extra[p] == &raster[q]);
+  }
+}
+
+template <typename TExtrapolator>
+void check_pad(const TExtrapolator& extrapolator, const Box<3>& margin)
+{
+  const auto padded = pad(extrapolator, margin);
+  BOOST_TEST(padded.shape() == (extrapolator.domain() + margin).shape());
+  for (const auto& p : extrapolator.domain() + margin) {
+    BOOST_TEST(padded[p - margin.front()] == extrapolator[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pad_test)
+{
+  Raster<int, 3> raster({4, 3, 2});
+  raster.range(1);
+  const Box<3> margin({-3, -1, -4}, {5, 2, 0});
+  check_pad(extrapolation(raster, -1), margin);
+  check_pad(extrapolation<Nearest>(raster), margin);
+  check_pad(extrapolation<Periodic>(raster), margin);
+  check_pad(extrapolation<Reflect>(raster), margin);
+  BOOST_TEST(pad<Reflect>(raster, Box<3>::from_center(0)) == raster);
+
+  const auto reflected = extrapolation<Reflect>(raster);
+  BOOST_TEST((reflected[{-2, 0, 0}]) == (raster[{2, 0, 0}]));
+  BOOST_TEST((reflected[{4, 0, 0}]) == (raster[{2, 0, 0}]));
+}
+
 BOOST_AUTO_TEST_CASE(linear_test)
 {
   Raster<int, 3> raster({2, 2, 2});
@@ -82,6 +127,144 @@ BOOST_AUTO_TEST_CASE(cubic_test)
   BOOST_TEST(center == 32.5);
 }
 
+BOOST_AUTO_TEST_CASE(lazy_linear_test)
+{
+  const auto plane = lazy_raster<2>({4, 3}, [](const auto& p) {
+    return 1. + 2. * p[0] + 3. * p[1];
+  });
+  const auto inter = interpolation<Linear>(plane);
+  BOOST_TEST((inter[{2, 1}]) == 8);
+  BOOST_TEST(inter({1.5, 0.5}) == 5.5);
+  BOOST_TEST(inter({-1.5, 3.5}) == 8.5); // No extrapolation needed
+}
+
+/**
+ * @brief A decorator which hides the raster of an extrapolator, to force the generic interpolation.
+ */
+template <typename TIn>
+struct Opaque {
+  using Value = typename TIn::Value;
+  static constexpr Index Dimension = TIn::Dimension;
+  const TIn& in;
+  decltype(auto) operator[](const Position<Dimension>& p) const
+  {
+    return in[p];
+  }
+};
+
+template <typename TMethod, Index N>
+void check_stencil(const Position<N>& shape)
+{
+  Raster<double, N> raster(shape);
+  for (const auto& p : raster.domain()) {
+    raster[p] = 1;
+    for (Index i = 0; i < N; ++i) {
+      raster[p] += (i + 2) * p[i] * p[i] - (i + 1) * p[i];
+    }
+  }
+  const auto extrapolator = extrapolation<Nearest>(raster);
+  const Opaque<decltype(extrapolator)> opaque {extrapolator};
+  const auto fast = interpolation<TMethod>(extrapolator);
+  const auto slow = interpolation<TMethod>(opaque);
+  for (const auto& p : Box<N>(Position<N>::zero() - 1, shape)) {
+    Vector<double, N> q(p);
+    q -= .3;
+    BOOST_TEST(fast(q) == slow(q), boost::test_tools::tolerance(1.e-9));
+    q += .6; // Fractional part above .5
+    BOOST_TEST(fast(q) == slow(q), boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stencil_test)
+{
+  check_stencil<Linear>(Position<2>({6, 5}));
+  check_stencil<Cubic>(Position<2>({6, 5}));
+  check_stencil<Linear>(Position<3>({5, 4, 6}));
+  check_stencil<Cubic>(Position<3>({5, 4, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(lanczos_test)
+{
+  double w[6];
+  BOOST_TEST(Lanczos<3>::weights(2.25, w) == 0);
+  BOOST_TEST(w[0] + w[1] + w[2] + w[3] + w[4] + w[5] == 1., boost::test_tools::tolerance(1.e-12));
+  BOOST_TEST(w[2] > w[3]);
+  BOOST_TEST(w[3] > 0);
+  BOOST_TEST(w[1] < 0);
+
+  Raster<int, 2> raster({8, 7});
+  raster.range(1);
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  const auto interpolator = interpolation<Lanczos<3>>(extrapolated);
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(interpolator(Vector<double, 2>(p)) == raster[p], boost::test_tools::tolerance(1.e-12));
+  }
+
+  const auto constant = Raster<float, 2>({5, 5}).fill(3);
+  const auto extrapolator = extrapolation<Nearest>(constant);
+  const auto hann = interpolation<WindowedSinc<2, HannWindow>>(extrapolator);
+  BOOST_TEST(hann({1.3, 3.8}) == 3.f, boost::test_tools::tolerance(1.e-5f));
+  BOOST_TEST(hann({-0.6, 4.2}) == 3.f, boost::test_tools::tolerance(1.e-5f));
+
+  check_stencil<Lanczos<2>>(Position<2>({6, 5}));
+  check_stencil<Lanczos<3>>(Position<3>({5, 4, 6}));
+}
+
+template <Index Order>
+void check_bspline()
+{
+  Raster<double, 2> raster({9, 7});
+  for (const auto& p : raster.domain()) {
+    raster[p] = std::sin(p[0] * .8) + p[1] * p[1] * .1;
+  }
+  const auto spline = interpolation<BSpline<Order>>(raster, Threads(2));
+  BOOST_TEST(spline.method().coefficients().size() == raster.size());
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(spline(Vector<double, 2>(p)) == raster[p], boost::test_tools::tolerance(1.e-9));
+  }
+  BOOST_TEST(spline({-1., 2.}) == (raster[{1, 2}]), boost::test_tools::tolerance(1.e-9)); // Mirror
+  BOOST_TEST(spline({3., 8.}) == (raster[{3, 4}]), boost::test_tools::tolerance(1.e-9));
+}
+
+BOOST_AUTO_TEST_CASE(bspline_test)
+{
+  check_bspline<1>();
+  check_bspline<2>();
+  check_bspline<3>();
+  check_bspline<4>();
+  check_bspline<5>();
+
+  const auto constant = Raster<float, 3>({4, 5, 3}).fill(2);
+  const auto spline = interpolation<BSpline<3>>(constant);
+  BOOST_TEST(spline({1.2, 3.7, 0.4}) == 2.f, boost::test_tools::tolerance(1.e-5f));
+
+  double w[4];
+  BOOST_TEST(BSpline<3>::basis(2.5, w) == 1);
+  BOOST_TEST(w[0] + w[1] + w[2] + w[3] == 1., boost::test_tools::tolerance(1.e-12));
+  BOOST_TEST(w[1] == w[2], boost::test_tools::tolerance(1.e-12));
+}
+
+BOOST_AUTO_TEST_CASE(batch_test)
+{
+  Raster<float, 2> raster({70, 50});
+  for (const auto& p : raster.domain()) {
+    raster[p] = std::sin(p[0] * .3) * p[1];
+  }
+  const auto extrapolator = extrapolation<Nearest>(raster);
+  const auto interpolator = interpolation<Cubic>(extrapolator);
+  for (Index size : {10, 3000}) {
+    Sequence<Vector<double, 2>> positions(size);
+    for (Index i = 0; i < size; ++i) {
+      positions[i] = {(i * 37 % 101) * .73 - 2., (i * 53 % 89) * .61 - 1.}; // Scattered, including out of bounds
+    }
+    const auto values = interpolator(positions, Threads(2));
+    BOOST_TEST(values.size() == positions.size());
+    for (Index i = 0; i < size; ++i) {
+      BOOST_TEST(values[i] == interpolator(positions[i]));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Labeling.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Labeling_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+  Raster<char> in({4, 3});
+  in.fill(0);
+  const auto out = label_components(in);
+  BOOST_TEST(out.components.empty());
+  BOOST_TEST(out.labels.shape() == in.shape());
+  for (auto e : out.labels) {
+    BOOST_TEST(e == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(connectivity_2d_test)
+{
+  // 1 1 0 0 0 0
+  // 0 0 1 0 1 1
+  // 0 1 1 0 0 1
+  // 0 0 0 0 1 1
+  Raster<char> in({6, 4}, {1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1});
+
+  const auto faces = label_components(in, Connectivity::Faces);
+  BOOST_TEST(faces.components.size() == 3);
+  const std::vector<Index> faces_labels {1, 1, 0, 0, 0, 0, 0, 0, 2, 0, 3, 3, 0, 2, 2, 0, 0, 3, 0, 0, 0, 0, 3, 3};
+  BOOST_TEST(faces.labels.container() == faces_labels);
+  BOOST_TEST(faces.components[0].size == 2);
+  BOOST_TEST(faces.components[1].size == 3);
+  BOOST_TEST(faces.components[2].size == 5);
+  BOOST_TEST(faces.components[2].box == Box<2>({4, 1}, {5, 3}));
+
+  const auto full = label_components(in, Connectivity::Full);
+  BOOST_TEST(full.components.size() == 2);
+  BOOST_TEST(full.components[0].size == 5);
+  BOOST_TEST(full.components[0].box == Box<2>({0, 0}, {2, 2}));
+  BOOST_TEST(full.components[1].size == 5);
+}
+
+BOOST_AUTO_TEST_CASE(merge_u_shape_test)
+{
+  // Two branches which are merged by the last row
+  // 1 0 1
+  // 1 0 1
+  // 1 1 1
+  Raster<int> in({3, 3}, {1, 0, 1, 1, 0, 1, 1, 1, 1});
+  const auto out = label_components(in, Connectivity::Faces);
+  BOOST_TEST(out.components.size() == 1);
+  BOOST_TEST(out.components[0].size == 7);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out.labels[p] == (in[p] ? 1 : 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(connectivity_3d_test)
+{
+  Raster<char, 3> in({3, 3, 3});
+  in.fill(0);
+  in[{0, 0, 0}] = 1;
+  in[{1, 1, 1}] = 1; // Corner-connected to {0, 0, 0}
+  in[{1, 1, 2}] = 1; // Face-connected to {1, 1, 1}
+  in[{2, 0, 2}] = 1; // Edge-connected to {1, 1, 2}
+  BOOST_TEST(label_components(in, Connectivity::Faces).components.size() == 3);
+  const auto full = label_components(in, Connectivity::Full);
+  BOOST_TEST(full.components.size() == 1);
+  BOOST_TEST(full.components[0].size == 4);
+  BOOST_TEST(full.components[0].box == Box<3>({0, 0, 0}, {2, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(grow_test)
+{
+  Raster<char> mask({7, 5});
+  mask.fill(0);
+  mask[{3, 2}] = 1;
+  const Box<2> bounds({1, 1}, {5, 3});
+  Index calls = 0;
+  const auto predicate = [&](const auto& p) {
+    ++calls;
+    return bounds.contains(p);
+  };
+
+  auto faces = mask;
+  BOOST_TEST(grow(faces, predicate, Connectivity::Faces, 1) == 4);
+  BOOST_TEST(calls == 4);
+
+  auto full = mask;
+  const auto count = grow(full, predicate);
+  BOOST_TEST(count == bounds.size() - 1);
+  for (const auto& p : mask.domain()) {
+    BOOST_TEST(full[p] == bounds.contains(p));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Permutation.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Permutation_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(transpose_test)
+{
+  Raster<int> in({70, 45});
+  in.range();
+  const auto out = permute<1, 0>(in);
+  BOOST_TEST((out.shape() == Position<2> {45, 70}));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST((out[{p[1], p[0]}] == in[p]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cube_permutation_test)
+{
+  Raster<float, 3> cube({33, 7, 40});
+  cube.range();
+  const auto spectra = permute<2, 0, 1>(cube);
+  BOOST_TEST((spectra.shape() == Position<3> {40, 33, 7}));
+  for (const auto& p : cube.domain()) {
+    BOOST_TEST((spectra[{p[2], p[0], p[1]}] == cube[p]));
+  }
+  const auto back = permute<1, 2, 0>(spectra);
+  BOOST_TEST(back == cube);
+  const auto identity = permute<0, 2, 1>(permute<0, 2, 1>(cube));
+  BOOST_TEST(identity == cube);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_permutation_test)
+{
+  Raster<double, 4> in({9, 65, 3, 34});
+  in.range();
+  const auto serial = permute<3, 1, 0, 2>(in);
+  Raster<double, 4> parallel(serial.shape());
+  permute_into<3, 1, 0, 2>(in, parallel, Threads(4));
+  BOOST_TEST(parallel == serial);
+  Raster<double, 4> wrong(in.shape());
+  BOOST_CHECK_THROW((permute_into<3, 1, 0, 2>(in, wrong)), Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Pyramid.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Pyramid_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(shapes_test)
+{
+  const auto in = Raster<float, 3>({9, 4, 1}).range();
+  const auto levels = pyramid(in, 10);
+  BOOST_TEST(levels.levels() == 5); // 9, 5, 3, 2, 1
+  BOOST_TEST(levels[0] == in);
+  BOOST_TEST(levels[1].shape() == (Position<3> {5, 2, 1}));
+  BOOST_TEST(levels[2].shape() == (Position<3> {3, 1, 1}));
+  BOOST_TEST(levels[4].shape() == (Position<3> {1, 1, 1}));
+  BOOST_TEST(levels[1].data() == levels[0].data() + in.size()); // Single arena
+}
+
+BOOST_AUTO_TEST_CASE(binomial_test)
+{
+  Raster<double> in({8, 6});
+  for (const auto& p : in.domain()) {
+    in[p] = p[0] * p[0] + 3 * p[1];
+  }
+  const auto levels = pyramid(in, 2, Threads(2));
+  const auto& out = levels[1];
+  const double w[] = {1. / 16., 4. / 16., 6. / 16., 4. / 16., 1. / 16.};
+  const auto reflect = [](Index i, Index n) {
+    return i < 0 ? -i : i >= n ? 2 * n - 2 - i : i;
+  };
+  for (const auto& p : out.domain()) {
+    double expected = 0;
+    for (Index j = 0; j < 5; ++j) {
+      for (Index i = 0; i < 5; ++i) {
+        const auto x = reflect(2 * p[0] + i - 2, 8);
+        const auto y = reflect(2 * p[1] + j - 2, 6);
+        expected += w[i] * w[j] * in[{x, y}];
+      }
+    }
+    BOOST_TEST(out[p] == expected, boost::test_tools::tolerance(1.e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(constant_integral_test)
+{
+  const auto in = Raster<int>({17, 11}).fill(7);
+  auto levels = pyramid(in, 4);
+  auto moved = std::move(levels);
+  for (Index l = 0; l < moved.levels(); ++l) {
+    for (const auto& e : moved[l]) {
+      BOOST_TEST(e == 7);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
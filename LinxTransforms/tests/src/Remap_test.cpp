@@ -0,0 +1,89 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Remap.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Remap_test)
+
+//-----------------------------------------------------------------------------
+
+template <typename TMethod, Index N, typename TMap>
+void check_remap(const Raster<double, N>& in, const Box<N>& domain, TMap&& map)
+{
+  const auto extrapolator = extrapolation(in, -1.);
+  const auto interpolator = interpolation<TMethod>(extrapolator);
+  const auto r = remap<TMethod>(domain, map, Threads(2));
+  BOOST_TEST(r.domain() == domain);
+  const auto out = r.warp(extrapolator, Threads(2));
+  BOOST_TEST(out.shape() == domain.shape());
+  Index i = 0;
+  for (const auto& p : domain) {
+    BOOST_TEST(out[i] == interpolator(map(p)), boost::test_tools::tolerance(1.e-9));
+    ++i;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(distortion_test)
+{
+  Raster<double> in({16, 12});
+  for (const auto& p : in.domain()) {
+    in[p] = 1. + p[0] * p[0] - 2. * p[1] + p[0] * p[1];
+  }
+  const auto distortion = [](const auto& p) {
+    Vector<double, 2> q(p);
+    const auto r2 = (q[0] - 8) * (q[0] - 8) + (q[1] - 6) * (q[1] - 6);
+    q *= 1. + 1.e-3 * r2;
+    return q;
+  };
+  const auto domain = Box<2>({-2, 1}, {17, 10});
+  check_remap<Nearest>(in, domain, distortion);
+  check_remap<Linear>(in, domain, distortion);
+  check_remap<Cubic>(in, domain, distortion);
+  check_remap<Lanczos<3>>(in, domain, distortion);
+}
+
+BOOST_AUTO_TEST_CASE(affinity_test)
+{
+  const auto in = Raster<double, 3>({7, 6, 5}).range();
+  const auto affinity = Affinity<3>::rotation_deg(20, 0, 2, center(in));
+  const auto inv = inverse(affinity);
+  const auto r = remap<Linear>(in.domain(), inv);
+  const auto extrapolator = extrapolation<Nearest>(in);
+  const auto interpolator = interpolation<Linear>(extrapolator);
+  Raster<double, 3> expected(in.shape());
+  affinity.transform(interpolator, expected);
+  Raster<double, 3> out(in.shape());
+  r.transform(interpolator, out);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(patch_output_test)
+{
+  const auto in = Raster<int>({5, 4}).range();
+  const auto box = Box<2>({1, 1}, {3, 2});
+  const auto r = remap<Nearest>(box, [](const auto& p) {
+    return Vector<double, 2>(p);
+  });
+  auto out = Raster<int>(in.shape()).fill(-1);
+  auto patch = out(box);
+  r.transform(in, patch);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == (box.contains(p) ? in[p] : -1));
+  }
+  Raster<int> wrong({2, 2});
+  BOOST_CHECK_THROW(r.transform(in, wrong), SizeError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
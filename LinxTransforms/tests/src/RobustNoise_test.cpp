@@ -0,0 +1,77 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Transforms/RobustNoise.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RobustNoise_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(full_sample_test)
+{
+  auto in = Raster<double>({5, 3}).range();
+  const auto noise = robust_noise(in, 1);
+  BOOST_TEST(noise.count == in.size());
+  BOOST_TEST(noise.median == 7);
+  BOOST_TEST(noise.mad == 4);
+}
+
+BOOST_AUTO_TEST_CASE(subsample_test)
+{
+  auto in = Raster<float>({512, 512});
+  in.generate(GaussianNoise<float>(10, 2, 42));
+  const auto noise = robust_noise(in, 4);
+  BOOST_TEST(noise.count == in.size() / 16);
+  BOOST_TEST(std::abs(noise.median - 10) < 0.05);
+  BOOST_TEST(std::abs(noise.sigma() - 2) < 0.05);
+}
+
+BOOST_AUTO_TEST_CASE(outliers_and_nans_test)
+{
+  auto in = Raster<float>({300, 200});
+  in.generate(GaussianNoise<float>(0, 1, 42));
+  for (std::size_t i = 0; i < in.size(); i += 10) {
+    in[i] = 1000;
+  }
+  for (std::size_t i = 5; i < in.size(); i += 10) {
+    in[i] = std::numeric_limits<float>::quiet_NaN();
+  }
+  const auto noise = robust_noise(in, 1);
+  BOOST_TEST(noise.count == in.size() - in.size() / 10);
+  BOOST_TEST(std::abs(noise.median) < 0.2);
+  BOOST_TEST(std::abs(noise.sigma() - 1) < 0.3);
+}
+
+BOOST_AUTO_TEST_CASE(threads_test)
+{
+  auto in = Raster<float, 3>({64, 32, 17});
+  in.generate(GaussianNoise<float>(0, 1, 42));
+  const auto serial = robust_noise(in, 3);
+  const auto parallel = robust_noise(in, 3, Threads(4));
+  BOOST_TEST(parallel.count == serial.count);
+  BOOST_TEST(parallel.median == serial.median);
+  BOOST_TEST(parallel.mad == serial.mad);
+  BOOST_TEST(serial.count == 22 * 11 * 6);
+}
+
+BOOST_AUTO_TEST_CASE(all_nan_test)
+{
+  auto in = Raster<float>({4, 4});
+  in.fill(std::numeric_limits<float>::quiet_NaN());
+  const auto noise = robust_noise(in);
+  BOOST_TEST(noise.count == 0);
+  BOOST_TEST(std::isnan(noise.median));
+  BOOST_TEST(std::isnan(noise.mad));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
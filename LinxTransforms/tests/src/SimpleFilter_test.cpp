@@ -2,11 +2,13 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/Mask.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Filters.h"
 #include "Linx/Transforms/SimpleFilter.h"
 
 #include <boost/test/unit_test.hpp>
+#include <set>
 
 using namespace Linx;
 
@@ -79,6 +81,180 @@ BOOST_AUTO_TEST_CASE(pixel_list_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(transform_at_test)
+{
+  const auto in = Raster<double>({7, 6}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto k = convolution(Raster<double>({3, 3}).range());
+  const auto expected = k * extra;
+  Raster<bool> selection(in.shape());
+  for (const auto& p : selection.domain()) {
+    selection[p] = (p[0] + p[1]) % 3 == 0;
+  }
+  Raster<double> out(in.shape());
+  out.fill(-1);
+  k.transform_at(extra, selection, out);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == (selection[p] ? expected[p] : -1.));
+  }
+  const auto ball = Mask<2>::ball<1>(1) + Position<2>({3, 2});
+  out.fill(-1);
+  k.transform_at(in, ball, out);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == (ball[p] ? expected[p] : -1.));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(transform_inplace_test)
+{
+  auto in = Raster<double>({7, 6}).range();
+  const auto k = convolution(Raster<double>({3, 3}).range());
+  const auto expected = k * extrapolation<Periodic>(in);
+  std::vector<double> pool(in.size());
+  PtrRaster<double> buffer(in.shape(), pool.data());
+  k.transform_inplace<Periodic>(in, buffer);
+  BOOST_TEST(in == expected);
+  const auto twice = k * extrapolation(in, 0.);
+  k.transform_inplace<Constant<double>>(in, buffer, 0.);
+  BOOST_TEST(in == twice);
+}
+
+struct ScratchSum : public KernelMixin<int, Box<2>> {
+  ScratchSum(Box<2> window, std::set<const int*>& buffers) : KernelMixin(window), m_buffers(buffers) {}
+  template <typename TIn>
+  int operator()(const TIn& neighbors, std::vector<int>& scratch) const
+  {
+    BOOST_TEST(scratch.size() == neighbors.size());
+    std::copy(neighbors.begin(), neighbors.end(), scratch.begin());
+    m_buffers.insert(scratch.data());
+    return std::accumulate(scratch.begin(), scratch.end(), 0);
+  }
+  std::set<const int*>& m_buffers;
+};
+
+BOOST_AUTO_TEST_CASE(scratch_test)
+{
+  const auto in = Raster<int>({6, 5}).range();
+  const auto box = Box<2>::from_center(1);
+  std::set<const int*> buffers;
+  const auto out = SimpleFilter<ScratchSum>(box, buffers) * in;
+  const auto expected = convolution(Raster<int>({3, 3}).fill(1)) * in;
+  BOOST_TEST(out == expected);
+  BOOST_TEST(buffers.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(mask_window_test)
+{
+  const auto in = Raster<double>({9, 8}).range();
+  const auto extra = extrapolation<Periodic>(in);
+  const auto ball = Mask<2>::ball<1>(2);
+  const auto k = mean_filter<double>(ball);
+  const auto out = k * extra;
+  for (const auto& p : in.domain()) {
+    double sum = 0;
+    for (const auto& q : ball + p) {
+      sum += extra[q];
+    }
+    BOOST_TEST(out[p] == sum / ball.size(), boost::test_tools::tolerance(1e-9));
+  }
+  const auto cropped = k * in;
+  const auto inner = in.domain() - box(ball);
+  BOOST_TEST(cropped.shape() == inner.shape());
+  auto it = cropped.begin();
+  for (const auto& p : inner) {
+    BOOST_TEST(*it == out[p], boost::test_tools::tolerance(1e-9));
+    ++it;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(halo_test)
+{
+  const auto in = Raster<double>({7, 5}).range();
+  const auto extra = extrapolation<Periodic>(in);
+  const auto padded = extra.copy(Box<2>({-9, -2}, {10, 12}));
+  for (const auto& p : padded.domain()) {
+    BOOST_TEST(padded[p] == extra[p + Position<2>({-9, -2})]);
+  }
+  const auto ball = Mask<2>::ball<2>(4);
+  const auto k = mean_filter<double>(ball);
+  const auto out = k * extra;
+  Raster<double> threaded(in.shape());
+  k.transform(extra, threaded, Threads(3));
+  for (const auto& p : in.domain()) {
+    double sum = 0;
+    for (const auto& q : ball + p) {
+      sum += extra[q];
+    }
+    BOOST_TEST(out[p] == sum / ball.size(), boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(threaded[p] == out[p], boost::test_tools::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_test)
+{
+  const auto stack = Raster<double, 3>({8, 6, 5}).range();
+  const auto k = convolution(Raster<double>({3, 3}).range());
+  const auto stacked = k * extrapolation<Nearest>(stack);
+  std::vector<Raster<double>> stamps;
+  for (Index i = 0; i < stack.length(2); ++i) {
+    const auto section = stack.section(i);
+    stamps.emplace_back(section.shape(), section.data());
+  }
+  std::vector<Extrapolation<Raster<double>, Nearest>> ins;
+  std::vector<Raster<double>> outs;
+  for (const auto& s : stamps) {
+    ins.push_back(extrapolation<Nearest>(s));
+    outs.emplace_back(s.shape());
+  }
+  k.transform_each(ins, outs, Threads(2));
+  for (Index i = 0; i < stack.length(2); ++i) {
+    BOOST_TEST(outs[i] == k * ins[i]);
+    BOOST_TEST(stacked.section(i) == outs[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(decimation_test)
+{
+  const auto in = Raster<double>({17, 12}).range();
+  const auto extra = extrapolation<Periodic>(in);
+  const auto k = mean_filter<double>(Mask<2>::ball<2>(2));
+  const auto expected = k * extra;
+  const auto grid = Grid<2>(Box<2>({1, 0}, {16, 11}), {2, 3});
+  const auto out = k * extra(grid);
+  Raster<double> threaded(grid.shape());
+  k.transform(extra(grid), threaded, Threads(3));
+  BOOST_TEST(out.shape() == grid.shape());
+  auto it = out.begin();
+  auto threaded_it = threaded.begin();
+  for (const auto& p : grid) {
+    BOOST_TEST(*it == expected[p], boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(*threaded_it == *it);
+    ++it;
+    ++threaded_it;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(threads_crop_test)
+{
+  const auto in = Raster<int, 3>({9, 8, 7}).range();
+  const auto k = median_filter<int>(Box<3>::from_center(1));
+  const auto expected = k * in;
+  Raster<int, 3> out(expected.shape());
+  k.transform(in, out, Threads(3));
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(threads_extrapolation_test)
+{
+  const auto in = Raster<double>({16, 9}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto k = convolution(Raster<double>({3, 5}).range());
+  const auto expected = k * extra;
+  Raster<double> out(in.shape());
+  k.transform(extra, out, Threads(4));
+  BOOST_TEST(out == expected);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
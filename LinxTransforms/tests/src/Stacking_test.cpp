@@ -0,0 +1,65 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Transforms/Stacking.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Stacking_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(mean_median_test)
+{
+  Raster<int, 3> stack({7, 5, 4});
+  for (const auto& p : stack.domain()) {
+    stack[p] = p[0] + 10 * p[1] + (p[2] == 3 ? 1000 : p[2]);
+  }
+  const auto mean = stack_mean(stack, Threads(2), 8);
+  const auto median = stack_median(stack, Threads(2), 8);
+  BOOST_TEST(mean.shape() == (Position<2> {7, 5}));
+  for (const auto& p : mean.domain()) {
+    const double base = p[0] + 10 * p[1];
+    BOOST_TEST(mean[p] == base + (0. + 1. + 2. + 1000.) / 4.);
+    BOOST_TEST(median[p] == base + 1.5);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(clipped_mean_test)
+{
+  Raster<float, 3> stack({50, 40, 21});
+  stack.generate(GaussianNoise<float>(100, 1, 42));
+  for (Index f = 0; f < 21; f += 5) {
+    stack[{f, f, f}] = 1.e6; // Cosmic rays
+  }
+  stack[{3, 4, 0}] = std::numeric_limits<float>::quiet_NaN();
+  const auto master = stack_clipped_mean(stack, 3, 5, Threads(3), 100);
+  for (const auto& e : master) {
+    BOOST_TEST(std::abs(e - 100) < 1);
+  }
+  const auto mean = stack_mean(stack);
+  BOOST_TEST((mean[{5, 5}] > 1000));
+  BOOST_TEST((not std::isnan(mean[{3, 4}])));
+}
+
+BOOST_AUTO_TEST_CASE(all_nan_test)
+{
+  Raster<double, 2> stack({3, 2});
+  stack.fill(std::numeric_limits<double>::quiet_NaN());
+  stack[{1, 0}] = 4;
+  const auto median = stack_median(stack);
+  BOOST_TEST(std::isnan(median[{0}]));
+  BOOST_TEST(median[{1}] == 4);
+  BOOST_TEST(std::isnan(median[{2}]));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
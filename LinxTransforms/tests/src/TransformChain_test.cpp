@@ -0,0 +1,91 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/LazyRaster.h"
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/TransformChain.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(TransformChain_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(pixelwise_fusion_test)
+{
+  auto in = Raster<int>({7, 5}).range();
+  const auto c = chain(extrapolation(in)) * 2 + 1 - 3;
+  using Node = std::decay_t<decltype(c.node())>;
+  BOOST_TEST(Internal::IsChainPixelwise<Node>::value);
+  BOOST_TEST(not Internal::IsChainPixelwise<std::decay_t<decltype(c.node().parent())>>::value);
+  const auto out = c.raster();
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(out[i] == in[i] * 2 - 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(filter_halo_test)
+{
+  const auto in = Raster<float>({16, 12});
+  const auto mean = mean_filter<float>(Box<2>({-1, -1}, {1, 1}));
+  const auto c = mean * (mean * chain(extrapolation(in)));
+  const auto region = Box<2>({2, 3}, {5, 7});
+  BOOST_TEST(c.source_region(region) == Box<2>({0, 1}, {7, 9}));
+}
+
+BOOST_AUTO_TEST_CASE(filter_sequence_test)
+{
+  auto in = Raster<float, 3>({23, 19, 3});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto mean = mean_filter<float>(Box<2>({-1, -1}, {1, 1}));
+  const auto dilate = dilation<float>(Box<2>({-2, 0}, {2, 0}));
+  const auto expected = mean * extrapolation<Nearest>(dilate * extrapolation<Nearest>(in)) * 2;
+  const auto out = (mean * (dilate * chain(extrapolation<Nearest>(in))) * 2).raster(Threads(3));
+  BOOST_TEST(out.shape() == in.shape());
+  const auto inner = in.domain() - Box<3>({-3, -1, 0}, {3, 1, 0});
+  for (const auto& p : inner) {
+    BOOST_TEST(out[p] == expected[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(warp_test)
+{
+  auto in = Raster<float>({32, 24});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  auto affinity = Affinity<2>::translation({1.5, -2.25});
+  affinity *= 0.75;
+  affinity.rotate_deg(10);
+  const Position<2> shape {20, 30};
+  Raster<float> expected(shape);
+  affinity.transform(interpolation<Linear>(extrapolation<Nearest>(in)), expected);
+  const auto out = chain(extrapolation<Nearest>(in)).warp<Linear>(affinity, shape).raster(Threads(2));
+  BOOST_TEST(out.shape() == shape);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    BOOST_TEST(out[i] == expected[i], boost::test_tools::tolerance(1e-3F));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_source_test)
+{
+  const auto ramp = lazy_raster<2>({9, 8}, [](const auto& p) {
+    return double(p[0] + 10 * p[1]);
+  });
+  const auto mean = mean_filter<double>(Box<2>({-1, -1}, {1, 1}));
+  const auto out = (mean * chain(ramp)).raster();
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == ramp[p], boost::test_tools::tolerance(1e-9));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()